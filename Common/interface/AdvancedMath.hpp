@@ -425,6 +425,224 @@ inline BoxVisibility GetBoxVisibility(const ViewFrustumExt& ViewFrustumExt,
     return BoxVisibility::Intersecting;
 }
 
+/// Bounding boxes in structure-of-arrays layout
+struct BoundBoxesSoA
+{
+    const float* MinX = nullptr;
+    const float* MinY = nullptr;
+    const float* MinZ = nullptr;
+    const float* MaxX = nullptr;
+    const float* MaxY = nullptr;
+    const float* MaxZ = nullptr;
+
+    /// The number of boxes
+    size_t Count = 0;
+};
+
+/// Bounding spheres in structure-of-arrays layout
+struct BoundSpheresSoA
+{
+    const float* CenterX = nullptr;
+    const float* CenterY = nullptr;
+    const float* CenterZ = nullptr;
+    const float* Radius  = nullptr;
+
+    /// The number of spheres
+    size_t Count = 0;
+};
+
+/// View frustum and output visibility masks for batched culling functions
+struct FrustumCullingTarget
+{
+    /// View frustum. Either pFrustum or pFrustumExt must not be null.
+    const ViewFrustum* pFrustum = nullptr;
+
+    /// Extended view frustum. If not null, objects that intersect the frustum are additionally
+    /// tested against the frustum corners, same as GetBoxVisibility(const ViewFrustumExt&, ...) does.
+    const ViewFrustumExt* pFrustumExt = nullptr;
+
+    /// Planes to test against.
+    FRUSTUM_PLANE_FLAGS PlaneFlags = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM;
+
+    /// Visibility bitmask: bit i % 64 of word i / 64 is set if object i is not invisible.
+    /// The mask must contain (Count + 63) / 64 words.
+    Uint64* pVisibleMask = nullptr;
+
+    /// Optional mask of objects that are fully inside the frustum, same layout as pVisibleMask.
+    Uint64* pFullyVisibleMask = nullptr;
+};
+
+/// Tests bounding boxes against one or more view frustums and writes visibility bitmasks.
+
+/// \param [in] Boxes      - Bounding boxes.
+/// \param [in] pTargets   - An array of NumTargets frustums to test the boxes against.
+/// \param [in] NumTargets - The number of elements in pTargets array.
+/// \param [in] FirstBox   - The first box to test. Must be a multiple of 64.
+/// \param [in] NumBoxes   - The number of boxes to test. Bits of the mask words that
+///                          correspond to boxes after FirstBox + NumBoxes are cleared.
+///
+/// \remarks   The results are the same as if GetBoxVisibility() was called for every box.
+///             The function uses SSE, AVX or NEON when they are enabled at compile time.
+///             Box data is loaded once for all frustums, so testing several frustums
+///             (e.g. shadow cascades) in one call is faster than several separate calls.
+void GetBoxesVisibility(const BoundBoxesSoA&        Boxes,
+                        const FrustumCullingTarget* pTargets,
+                        Uint32                      NumTargets,
+                        size_t                      FirstBox = 0,
+                        size_t                      NumBoxes = ~size_t{0});
+
+/// Tests bounding spheres against one or more view frustums and writes visibility bitmasks.
+
+/// \remarks   See GetBoxesVisibility() for the parameter description.
+///             Frustum planes do not need to be normalized. With pFrustumExt, the frustum
+///             corners are tested against the bounding boxes of the spheres.
+void GetSpheresVisibility(const BoundSpheresSoA&      Spheres,
+                          const FrustumCullingTarget* pTargets,
+                          Uint32                      NumTargets,
+                          size_t                      FirstSphere = 0,
+                          size_t                      NumSpheres  = ~size_t{0});
+
+/// Parallel front end of GetBoxesVisibility().
+
+/// \param [in] ParallelFor - A function that executes Func(i) for i in [0, NumTasks):
+///                           ParallelFor(size_t NumTasks, const std::function<void(size_t)>& Func),
+///                           typically a thread pool dispatcher.
+/// \param [in] BatchSize   - The number of boxes processed by one task. Rounded up to a multiple of 64.
+template <typename ParallelForType>
+void GetBoxesVisibilityParallel(const BoundBoxesSoA&        Boxes,
+                                const FrustumCullingTarget* pTargets,
+                                Uint32                      NumTargets,
+                                ParallelForType&&           ParallelFor,
+                                size_t                      BatchSize = 16384)
+{
+    BatchSize = (std::max(BatchSize, size_t{1}) + 63) & ~size_t{63};
+
+    const size_t NumBatches = (Boxes.Count + BatchSize - 1) / BatchSize;
+    ParallelFor(NumBatches, [&](size_t Batch) {
+        const size_t FirstBox = Batch * BatchSize;
+        GetBoxesVisibility(Boxes, pTargets, NumTargets, FirstBox, std::min(BatchSize, Boxes.Count - FirstBox));
+    });
+}
+
+/// Parallel front end of GetSpheresVisibility(), see GetBoxesVisibilityParallel().
+template <typename ParallelForType>
+void GetSpheresVisibilityParallel(const BoundSpheresSoA&      Spheres,
+                                  const FrustumCullingTarget* pTargets,
+                                  Uint32                      NumTargets,
+                                  ParallelForType&&           ParallelFor,
+                                  size_t                      BatchSize = 16384)
+{
+    BatchSize = (std::max(BatchSize, size_t{1}) + 63) & ~size_t{63};
+
+    const size_t NumBatches = (Spheres.Count + BatchSize - 1) / BatchSize;
+    ParallelFor(NumBatches, [&](size_t Batch) {
+        const size_t FirstSphere = Batch * BatchSize;
+        GetSpheresVisibility(Spheres, pTargets, NumTargets, FirstSphere, std::min(BatchSize, Spheres.Count - FirstSphere));
+    });
+}
+
+struct BoundSphere
+{
+    float3 Center;
+    float  Radius = 0;
+};
+
+/// Transforms an array of points by the matrix.
+
+/// \param [in]  Matrix    - Transform matrix.
+/// \param [in]  pSrc      - Source points.
+/// \param [out] pDst      - Destination points. May be the same as pSrc if the strides are equal.
+/// \param [in]  Count     - The number of points to transform.
+/// \param [in]  SrcStride - Source stride in bytes, e.g. the vertex size when pSrc points to
+///                          the position attribute of the first vertex in the vertex buffer.
+/// \param [in]  DstStride - Destination stride in bytes.
+///
+/// \remarks    Every point is transformed as float4{p, 1} * Matrix without the perspective
+///             divide, so the matrix is expected to be affine.
+void TransformPoints(const float4x4& Matrix,
+                     const float3*   pSrc,
+                     float3*         pDst,
+                     size_t          Count,
+                     size_t          SrcStride = sizeof(float3),
+                     size_t          DstStride = sizeof(float3));
+
+/// Transforms an array of direction vectors by the matrix, see TransformPoints().
+
+/// \remarks    Every vector is transformed as float4{v, 0} * Matrix. The results are not normalized.
+///             To transform normals, use the inverse transpose of the point transform matrix.
+void TransformVectors(const float4x4& Matrix,
+                      const float3*   pSrc,
+                      float3*         pDst,
+                      size_t          Count,
+                      size_t          SrcStride = sizeof(float3),
+                      size_t          DstStride = sizeof(float3));
+
+/// Computes the axis-aligned bounding box of the points.
+
+/// \param [in] pPoints - Points, e.g. the position attribute of the first vertex in the vertex buffer.
+/// \param [in] Count   - The number of points. Must not be zero.
+/// \param [in] Stride  - Point stride in bytes.
+BoundBox ComputeBoundBox(const float3* pPoints, size_t Count, size_t Stride = sizeof(float3));
+
+/// Computes the bounding sphere of the points, see ComputeBoundBox().
+
+/// \remarks    The sphere is centered at the center of the bounding box, so it
+///             is not the minimal bounding sphere in general.
+BoundSphere ComputeBoundSphere(const float3* pPoints, size_t Count, size_t Stride = sizeof(float3));
+
+/// Computes the bounding box that encloses all boxes in the array. Count must not be zero.
+BoundBox MergeBoundBoxes(const BoundBox* pBoxes, size_t Count);
+
+/// Transforms the boxes by their matrices, same as pDst[i] = pSrc[i].Transform(pMatrices[i]).
+
+/// \remarks    pDst may be the same as pSrc.
+void TransformBoundBoxes(const BoundBox* pSrc,
+                         const float4x4* pMatrices,
+                         BoundBox*       pDst,
+                         size_t          Count);
+
+/// Intersects a ray with the bounding boxes.
+
+/// \param [in]  RayOrigin    - Ray origin.
+/// \param [in]  RayDirection - Ray direction.
+/// \param [in]  Boxes        - Bounding boxes.
+/// \param [out] pHitMask     - Hit bitmask: bit i % 64 of word i / 64 is set if IntersectRayBox3D()
+///                             returns true for box i. The mask must contain (Boxes.Count + 63) / 64 words.
+/// \param [out] pEnterDist   - Optional array of Boxes.Count entry distances.
+/// \param [out] pExitDist    - Optional array of Boxes.Count exit distances.
+///
+/// \return     The number of boxes the ray intersects.
+size_t IntersectRayBoxes(const float3&        RayOrigin,
+                         const float3&        RayDirection,
+                         const BoundBoxesSoA& Boxes,
+                         Uint64*              pHitMask,
+                         float*               pEnterDist = nullptr,
+                         float*               pExitDist  = nullptr);
+
+/// Intersects a ray with the triangles.
+
+/// \param [in]  RayOrigin    - Ray origin.
+/// \param [in]  RayDirection - Ray direction.
+/// \param [in]  pVertices    - Triangle vertices.
+/// \param [in]  pIndices     - Optional triangle list indices. If null, triangle i uses
+///                             vertices 3*i, 3*i+1 and 3*i+2.
+/// \param [in]  NumTriangles - The number of triangles.
+/// \param [in]  CullBackFace - Whether to ignore back-facing triangles.
+/// \param [out] pDistances   - Optional array of NumTriangles distances as returned by IntersectRayTriangle().
+/// \param [out] pClosestHit  - Optional index of the closest triangle that the ray hits in front
+///                             of its origin. Set to NumTriangles if there is no such triangle.
+///
+/// \return     The distance to the closest intersection in front of the ray origin,
+///             or +FLT_MAX if there is no intersection.
+float IntersectRayTriangles(const float3& RayOrigin,
+                            const float3& RayDirection,
+                            const float3* pVertices,
+                            const Uint32* pIndices,
+                            size_t        NumTriangles,
+                            bool          CullBackFace = false,
+                            float*        pDistances   = nullptr,
+                            size_t*       pClosestHit  = nullptr);
+
 inline float GetPointToBoxDistance(const BoundBox& BndBox, const float3& Pos)
 {
     VERIFY_EXPR(BndBox.Max.x >= BndBox.Min.x &&
@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::AsyncInitializer class
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "ThreadPool.hpp"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+/// Runs the object initialization task in a thread pool and tracks its status.
+
+/// The initializer must be destroyed before any state that the task accesses,
+/// which is normally achieved by resetting it at the beginning of the owner's destructor.
+class AsyncInitializer
+{
+public:
+    enum class Status : Uint32
+    {
+        Running,
+        Completed,
+        Failed
+    };
+
+    /// Enqueues the initialization task into the pool. An exception thrown by the task
+    /// marks the initialization as failed.
+    template <typename TaskType>
+    AsyncInitializer(ThreadPool& Pool, TaskType&& Task)
+    {
+        Pool.EnqueueTask(
+            [this, Task = std::forward<TaskType>(Task)]() mutable //
+            {
+                auto FinalStatus = Status::Completed;
+                try
+                {
+                    Task();
+                }
+                catch (...)
+                {
+                    FinalStatus = Status::Failed;
+                }
+                // Notify while holding the lock: as soon as the waiting thread observes
+                // the new status, it may destroy the initializer.
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                m_Status.store(FinalStatus);
+                m_CompletedCondVar.notify_all();
+            });
+    }
+
+    // clang-format off
+    AsyncInitializer           (const AsyncInitializer&)  = delete;
+    AsyncInitializer           (      AsyncInitializer&&) = delete;
+    AsyncInitializer& operator=(const AsyncInitializer&)  = delete;
+    AsyncInitializer& operator=(      AsyncInitializer&&) = delete;
+    // clang-format on
+
+    ~AsyncInitializer()
+    {
+        Wait();
+    }
+
+    /// Returns the initialization status. If WaitForCompletion is true, blocks until
+    /// the task is finished.
+    Status GetStatus(bool WaitForCompletion = false)
+    {
+        if (WaitForCompletion)
+            Wait();
+        return m_Status.load();
+    }
+
+    void Wait()
+    {
+        // Always acquire the mutex, even if the task has already finished, to make
+        // sure that the worker thread is no longer accessing the initializer.
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+        m_CompletedCondVar.wait(Lock, [this] { return m_Status.load() != Status::Running; });
+    }
+
+private:
+    std::atomic<Status>     m_Status{Status::Running};
+    std::mutex              m_Mtx;
+    std::condition_variable m_CompletedCondVar;
+};
+
+} // namespace Diligent
@@ -54,6 +54,21 @@
 
 #include "HashUtils.hpp"
 
+// Define DILIGENT_ENABLE_SIMD_MATH to use SSE/NEON implementation of the most frequently
+// used float4x4 operations (matrix multiplication, vector transformation, transposition
+// and inversion). Storage layout and alignment of all types are not affected.
+// The macro must be defined consistently in all translation units (CMake option
+// DILIGENT_SIMD_MATH adds it to the public build settings).
+#ifdef DILIGENT_ENABLE_SIMD_MATH
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        include <emmintrin.h>
+#        define DILIGENT_SIMD_MATH_SSE 1
+#    elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#        include <arm_neon.h>
+#        define DILIGENT_SIMD_MATH_NEON 1
+#    endif
+#endif
+
 #ifdef _MSC_VER
 #    pragma warning(push)
 #    pragma warning(disable : 4201) // nonstandard extension used: nameless struct/union
@@ -1671,6 +1686,229 @@ template <class T> struct Matrix4x4
     }
 };
 
+#if DILIGENT_SIMD_MATH_SSE || DILIGENT_SIMD_MATH_NEON
+
+namespace BasicMathSIMD
+{
+
+// Thin wrappers over the SSE/NEON intrinsics that let the float4x4 specializations below
+// be written once. All loads and stores are unaligned since the math types only have
+// the natural alignment of float.
+
+#    if DILIGENT_SIMD_MATH_SSE
+
+using Float4 = __m128;
+
+// clang-format off
+inline Float4 LoadF4   (const float* p)      { return _mm_loadu_ps(p); }
+inline void   StoreF4  (float* p, Float4 v)  { _mm_storeu_ps(p, v); }
+inline Float4 SplatF4  (float f)             { return _mm_set1_ps(f); }
+inline Float4 ZeroF4   ()                    { return _mm_setzero_ps(); }
+inline Float4 AddF4    (Float4 a, Float4 b)  { return _mm_add_ps(a, b); }
+inline Float4 SubF4    (Float4 a, Float4 b)  { return _mm_sub_ps(a, b); }
+inline Float4 MulF4    (Float4 a, Float4 b)  { return _mm_mul_ps(a, b); }
+inline float  GetXF4   (Float4 v)            { return _mm_cvtss_f32(v); }
+// (x, y, z, w) -> (y, x, w, z)
+inline Float4 SwapPairs (Float4 v)           { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+// (x, y, z, w) -> (z, w, x, y)
+inline Float4 SwapHalves(Float4 v)           { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+// clang-format on
+
+// Loads the 4x4 row-major matrix and returns its columns
+inline void LoadColumns(const float* pMatrix, Float4 Cols[4])
+{
+    Cols[0] = LoadF4(pMatrix + 0);
+    Cols[1] = LoadF4(pMatrix + 4);
+    Cols[2] = LoadF4(pMatrix + 8);
+    Cols[3] = LoadF4(pMatrix + 12);
+    _MM_TRANSPOSE4_PS(Cols[0], Cols[1], Cols[2], Cols[3]);
+}
+
+#    elif DILIGENT_SIMD_MATH_NEON
+
+using Float4 = float32x4_t;
+
+// clang-format off
+inline Float4 LoadF4   (const float* p)      { return vld1q_f32(p); }
+inline void   StoreF4  (float* p, Float4 v)  { vst1q_f32(p, v); }
+inline Float4 SplatF4  (float f)             { return vdupq_n_f32(f); }
+inline Float4 ZeroF4   ()                    { return vdupq_n_f32(0); }
+inline Float4 AddF4    (Float4 a, Float4 b)  { return vaddq_f32(a, b); }
+inline Float4 SubF4    (Float4 a, Float4 b)  { return vsubq_f32(a, b); }
+inline Float4 MulF4    (Float4 a, Float4 b)  { return vmulq_f32(a, b); }
+inline float  GetXF4   (Float4 v)            { return vgetq_lane_f32(v, 0); }
+// (x, y, z, w) -> (y, x, w, z)
+inline Float4 SwapPairs (Float4 v)           { return vrev64q_f32(v); }
+// (x, y, z, w) -> (z, w, x, y)
+inline Float4 SwapHalves(Float4 v)           { return vextq_f32(v, v, 2); }
+// clang-format on
+
+// Loads the 4x4 row-major matrix and returns its columns
+inline void LoadColumns(const float* pMatrix, Float4 Cols[4])
+{
+    const float32x4x4_t Deinterleaved = vld4q_f32(pMatrix);
+
+    Cols[0] = Deinterleaved.val[0];
+    Cols[1] = Deinterleaved.val[1];
+    Cols[2] = Deinterleaved.val[2];
+    Cols[3] = Deinterleaved.val[3];
+}
+
+#    endif
+
+// Computes v * m. The operations are performed in the same order as in the scalar code,
+// so that both versions produce identical results.
+inline Float4 MulVectorMatrix(float x, float y, float z, float w, const float* pMatrix)
+{
+    Float4 r = MulF4(SplatF4(x), LoadF4(pMatrix + 0));
+    r        = AddF4(r, MulF4(SplatF4(y), LoadF4(pMatrix + 4)));
+    r        = AddF4(r, MulF4(SplatF4(z), LoadF4(pMatrix + 8)));
+    r        = AddF4(r, MulF4(SplatF4(w), LoadF4(pMatrix + 12)));
+    return r;
+}
+
+} // namespace BasicMathSIMD
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Mul(const Matrix4x4<float>& m1, const Matrix4x4<float>& m2)
+{
+    using namespace BasicMathSIMD;
+
+    Matrix4x4<float> mOut;
+    for (int i = 0; i < 4; ++i)
+    {
+        // The scalar version accumulates the products starting from zero, which
+        // matters for negative zeroes.
+        Float4 r = AddF4(ZeroF4(), MulF4(SplatF4(m1.m[i][0]), LoadF4(m2.m[0])));
+        r        = AddF4(r, MulF4(SplatF4(m1.m[i][1]), LoadF4(m2.m[1])));
+        r        = AddF4(r, MulF4(SplatF4(m1.m[i][2]), LoadF4(m2.m[2])));
+        r        = AddF4(r, MulF4(SplatF4(m1.m[i][3]), LoadF4(m2.m[3])));
+        StoreF4(mOut.m[i], r);
+    }
+    return mOut;
+}
+
+template <>
+inline Vector4<float> Vector4<float>::operator*(const Matrix4x4<float>& m) const
+{
+    Vector4<float> out;
+    BasicMathSIMD::StoreF4(out.Data(), BasicMathSIMD::MulVectorMatrix(x, y, z, w, m.m[0]));
+    return out;
+}
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Transpose() const
+{
+    using namespace BasicMathSIMD;
+
+    Float4 Cols[4];
+    LoadColumns(m[0], Cols);
+
+    Matrix4x4<float> Tr;
+    StoreF4(Tr.m[0], Cols[0]);
+    StoreF4(Tr.m[1], Cols[1]);
+    StoreF4(Tr.m[2], Cols[2]);
+    StoreF4(Tr.m[3], Cols[3]);
+    return Tr;
+}
+
+// Inverts the matrix using Cramer's rule. The cofactors are computed from the 2x2
+// sub-determinants of the transposed matrix, which only requires pair and half swaps.
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Inverse() const
+{
+    using namespace BasicMathSIMD;
+
+    Float4 Cols[4];
+    LoadColumns(m[0], Cols);
+
+    const Float4 r0 = Cols[0];
+    const Float4 r1 = SwapHalves(Cols[1]);
+    const Float4 r2 = Cols[2];
+    const Float4 r3 = SwapHalves(Cols[3]);
+
+    Float4 minor0, minor1, minor2, minor3, tmp;
+
+    tmp    = SwapPairs(MulF4(r2, r3));
+    minor0 = MulF4(r1, tmp);
+    minor1 = MulF4(r0, tmp);
+    tmp    = SwapHalves(tmp);
+    minor0 = SubF4(MulF4(r1, tmp), minor0);
+    minor1 = SubF4(MulF4(r0, tmp), minor1);
+    minor1 = SwapHalves(minor1);
+
+    tmp    = SwapPairs(MulF4(r1, r2));
+    minor0 = AddF4(MulF4(r3, tmp), minor0);
+    minor3 = MulF4(r0, tmp);
+    tmp    = SwapHalves(tmp);
+    minor0 = SubF4(minor0, MulF4(r3, tmp));
+    minor3 = SubF4(MulF4(r0, tmp), minor3);
+    minor3 = SwapHalves(minor3);
+
+    tmp              = SwapPairs(MulF4(SwapHalves(r1), r3));
+    const Float4 r2s = SwapHalves(r2);
+    minor0           = AddF4(MulF4(r2s, tmp), minor0);
+    minor2           = MulF4(r0, tmp);
+    tmp              = SwapHalves(tmp);
+    minor0           = SubF4(minor0, MulF4(r2s, tmp));
+    minor2           = SubF4(MulF4(r0, tmp), minor2);
+    minor2           = SwapHalves(minor2);
+
+    tmp    = SwapPairs(MulF4(r0, r1));
+    minor2 = AddF4(MulF4(r3, tmp), minor2);
+    minor3 = SubF4(MulF4(r2s, tmp), minor3);
+    tmp    = SwapHalves(tmp);
+    minor2 = SubF4(MulF4(r3, tmp), minor2);
+    minor3 = SubF4(minor3, MulF4(r2s, tmp));
+
+    tmp    = SwapPairs(MulF4(r0, r3));
+    minor1 = SubF4(minor1, MulF4(r2s, tmp));
+    minor2 = AddF4(MulF4(r1, tmp), minor2);
+    tmp    = SwapHalves(tmp);
+    minor1 = AddF4(MulF4(r2s, tmp), minor1);
+    minor2 = SubF4(minor2, MulF4(r1, tmp));
+
+    tmp    = SwapPairs(MulF4(r0, r2s));
+    minor1 = AddF4(MulF4(r3, tmp), minor1);
+    minor3 = SubF4(minor3, MulF4(r1, tmp));
+    tmp    = SwapHalves(tmp);
+    minor1 = SubF4(minor1, MulF4(r3, tmp));
+    minor3 = AddF4(MulF4(r1, tmp), minor3);
+
+    Float4 det = MulF4(r0, minor0);
+    det        = AddF4(SwapHalves(det), det);
+    det        = AddF4(SwapPairs(det), det);
+
+    const Float4 rcp = SplatF4(1.f / GetXF4(det));
+
+    Matrix4x4<float> inv;
+    StoreF4(inv.m[0], MulF4(minor0, rcp));
+    StoreF4(inv.m[1], MulF4(minor1, rcp));
+    StoreF4(inv.m[2], MulF4(minor2, rcp));
+    StoreF4(inv.m[3], MulF4(minor3, rcp));
+    return inv;
+}
+
+// Computes m * v, where v is a column vector, in the same order as the template version
+inline Vector4<float> operator*(const Matrix4x4<float>& m, const Vector4<float>& v)
+{
+    using namespace BasicMathSIMD;
+
+    Float4 Cols[4];
+    LoadColumns(m.m[0], Cols);
+
+    Float4 r = MulF4(Cols[0], SplatF4(v.x));
+    r        = AddF4(r, MulF4(Cols[1], SplatF4(v.y)));
+    r        = AddF4(r, MulF4(Cols[2], SplatF4(v.z)));
+    r        = AddF4(r, MulF4(Cols[3], SplatF4(v.w)));
+
+    Vector4<float> out;
+    StoreF4(out.Data(), r);
+    return out;
+}
+
+#endif
+
 // Template Vector Operations
 
 
@@ -0,0 +1,442 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::ConcurrentLinearAllocator class
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Primitives/interface/MemoryAllocator.h"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "CompilerDefinitions.h"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+/// Thread-safe linear allocator that allocates memory from chunks of fixed size.
+
+/// Memory can be allocated directly from the allocator by any thread: the allocations are
+/// performed from the shared current chunk using atomic operations. For the best performance,
+/// every thread should create its own ConcurrentLinearAllocator::ThreadContext, which acquires
+/// whole chunks from the allocator and then allocates from them without any synchronization.
+/// Chunks are acquired lock-free.
+///
+/// Individual allocations can't be released. All memory is reclaimed at once by Reset(), which
+/// keeps the chunks for reuse, or by Release(), which returns the chunks to the raw allocator.
+///
+/// The allocator implements IMemoryAllocator, so that it can be used as the backing store for other
+/// allocators (e.g. FixedLinearAllocator or StringPool). IMemoryAllocator::Free() does nothing.
+///
+/// \remarks   The arena is meant for objects that are released together, e.g. temporary data of a batch
+///            of pipeline states that are created in parallel by a job system. It is not used for the
+///            description copies owned by pipeline state and resource signature objects: these objects
+///            are destroyed individually and must return their memory to the raw allocator.
+///
+/// \note   Raw memory allocator must be thread-safe.
+class ConcurrentLinearAllocator final : public IMemoryAllocator
+{
+public:
+    // clang-format off
+    ConcurrentLinearAllocator           (const ConcurrentLinearAllocator&) = delete;
+    ConcurrentLinearAllocator           (ConcurrentLinearAllocator&&)      = delete;
+    ConcurrentLinearAllocator& operator=(const ConcurrentLinearAllocator&) = delete;
+    ConcurrentLinearAllocator& operator=(ConcurrentLinearAllocator&&)      = delete;
+    // clang-format on
+
+    explicit ConcurrentLinearAllocator(IMemoryAllocator& RawAllocator, size_t ChunkSize = 64 << 10) :
+        m_ChunkSize{ChunkSize},
+        m_pRawAllocator{&RawAllocator}
+    {
+        VERIFY(IsPowerOfTwo(ChunkSize), "Chunk size (", ChunkSize, ") is not power of two");
+    }
+
+    ~ConcurrentLinearAllocator()
+    {
+        Release();
+    }
+
+    /// Allocates memory from the shared chunk. This method is thread-safe.
+    NODISCARD void* Allocate(size_t Size, size_t Alignment)
+    {
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") is not a power of two");
+        if (Size == 0)
+            return nullptr;
+
+        auto* pChunk = m_pCurrChunk.load(std::memory_order_acquire);
+        if (pChunk != nullptr)
+        {
+            size_t Offset = pChunk->Offset.load(std::memory_order_relaxed);
+            while (true)
+            {
+                auto* const pData = pChunk->GetData();
+                auto* const Ptr   = AlignUp(pData + Offset, Alignment);
+                const auto  End   = static_cast<size_t>(Ptr - pData) + Size;
+                if (End > pChunk->Size)
+                    break; // The chunk is full
+
+                // On failure, Offset is updated with the current value
+                if (pChunk->Offset.compare_exchange_weak(Offset, End, std::memory_order_relaxed))
+                    return Ptr;
+            }
+        }
+
+        // Acquire a new chunk and try to make it current
+        auto* pNewChunk = AcquireChunk(Size + Alignment - 1);
+        auto* pData     = pNewChunk->GetData();
+        auto* Ptr       = AlignUp(pData, Alignment);
+        pNewChunk->Offset.store(static_cast<size_t>(Ptr - pData) + Size, std::memory_order_relaxed);
+        // If another thread has already replaced the current chunk, the remaining space in
+        // the new chunk will not be used until the allocator is reset.
+        m_pCurrChunk.compare_exchange_strong(pChunk, pNewChunk, std::memory_order_acq_rel);
+        return Ptr;
+    }
+
+    template <typename T>
+    NODISCARD T* Allocate(size_t Count = 1)
+    {
+        return reinterpret_cast<T*>(Allocate(sizeof(T) * Count, alignof(T)));
+    }
+
+    NODISCARD Char* CopyString(const Char* Str, size_t Len = 0)
+    {
+        if (Str == nullptr)
+            return nullptr;
+
+        Len = GetStringLength(Str, Len);
+        return CopyStringData(Allocate<Char>(Len + 1), Str, Len);
+    }
+
+    /// Implementation of IMemoryAllocator::Allocate(). The memory is aligned by the fundamental alignment.
+    virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final
+    {
+        return Allocate(Size, alignof(std::max_align_t));
+    }
+
+    /// Implementation of IMemoryAllocator::Free(). Does nothing as memory is released by Reset() or Release().
+    virtual void Free(void* Ptr) override final
+    {
+    }
+
+    /// Makes all chunks available for new allocations. Memory of chunks that are larger than
+    /// the default chunk size is released.
+    ///
+    /// \warning    The method is not thread-safe. All memory previously allocated from the allocator
+    ///             and its thread contexts is invalidated, and the thread contexts must not be used.
+    void Reset()
+    {
+        Chunk* pKeptChunks = nullptr;
+        Chunk* pFreeChunks = nullptr;
+        for (auto* pChunk = m_pAllChunks.load(std::memory_order_acquire); pChunk != nullptr;)
+        {
+            auto* pNextChunk = pChunk->pNextAllocated;
+            if (pChunk->Size == m_ChunkSize)
+            {
+                pChunk->Offset.store(0, std::memory_order_relaxed);
+                pChunk->pNextAllocated = pKeptChunks;
+                pChunk->pNextFree      = pFreeChunks;
+                pKeptChunks            = pChunk;
+                pFreeChunks            = pChunk;
+            }
+            else
+            {
+                DestroyChunk(pChunk);
+            }
+            pChunk = pNextChunk;
+        }
+        m_pAllChunks.store(pKeptChunks, std::memory_order_release);
+        m_pFreeChunks.store(pFreeChunks, std::memory_order_release);
+        m_pCurrChunk.store(nullptr, std::memory_order_release);
+#ifdef DILIGENT_DEBUG
+        m_DbgGeneration.fetch_add(1);
+#endif
+    }
+
+    /// Returns all chunks to the raw memory allocator.
+    ///
+    /// \warning    The method is not thread-safe.
+    void Release()
+    {
+        for (auto* pChunk = m_pAllChunks.load(std::memory_order_acquire); pChunk != nullptr;)
+        {
+            auto* pNextChunk = pChunk->pNextAllocated;
+            DestroyChunk(pChunk);
+            pChunk = pNextChunk;
+        }
+        m_pAllChunks.store(nullptr, std::memory_order_release);
+        m_pFreeChunks.store(nullptr, std::memory_order_release);
+        m_pCurrChunk.store(nullptr, std::memory_order_release);
+#ifdef DILIGENT_DEBUG
+        m_DbgGeneration.fetch_add(1);
+#endif
+    }
+
+    /// Returns the total size of all chunks. The method is not thread-safe.
+    size_t GetReservedSize() const
+    {
+        size_t Size = 0;
+        for (auto* pChunk = m_pAllChunks.load(std::memory_order_acquire); pChunk != nullptr; pChunk = pChunk->pNextAllocated)
+            Size += pChunk->Size;
+        return Size;
+    }
+
+    size_t GetChunkSize() const
+    {
+        return m_ChunkSize;
+    }
+
+    /// Per-thread allocation context.
+
+    /// The context acquires whole chunks from the parent allocator and allocates memory from them without
+    /// synchronization. A context must only be used by one thread at a time, while any number of contexts
+    /// may be used concurrently. The memory is owned by the parent allocator and stays valid after the
+    /// context is destroyed, until the parent allocator is reset.
+    class ThreadContext final : public IMemoryAllocator
+    {
+    public:
+        explicit ThreadContext(ConcurrentLinearAllocator& Parent) noexcept :
+            // clang-format off
+            m_pParent{&Parent}
+#ifdef DILIGENT_DEBUG
+          , m_DbgGeneration{Parent.m_DbgGeneration.load()}
+#endif
+        // clang-format on
+        {
+        }
+
+        // clang-format off
+        ThreadContext           (const ThreadContext&) = delete;
+        ThreadContext& operator=(const ThreadContext&) = delete;
+        ThreadContext& operator=(ThreadContext&&)      = delete;
+        // clang-format on
+
+        NODISCARD void* Allocate(size_t Size, size_t Alignment)
+        {
+            VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") is not a power of two");
+            VERIFY(m_DbgGeneration == m_pParent->m_DbgGeneration.load(), "The parent allocator has been reset. The context must not be used.");
+            if (Size == 0)
+                return nullptr;
+
+            if (m_pCurrPtr != nullptr)
+            {
+                auto* Ptr = AlignUp(m_pCurrPtr, Alignment);
+                if (Ptr + Size <= m_pEndPtr)
+                {
+                    m_pCurrPtr = Ptr + Size;
+                    return Ptr;
+                }
+            }
+
+            const auto RequiredSize = Size + Alignment - 1;
+            auto*      pChunk       = m_pParent->AcquireChunk(RequiredSize);
+            auto*      Ptr          = AlignUp(pChunk->GetData(), Alignment);
+            // The chunk is owned by this context, so the offset in the chunk is not used
+            pChunk->Offset.store(pChunk->Size, std::memory_order_relaxed);
+            if (RequiredSize <= m_pParent->m_ChunkSize / 4)
+            {
+                // Continue allocating from the new chunk
+                m_pCurrPtr = Ptr + Size;
+                m_pEndPtr  = pChunk->GetData() + pChunk->Size;
+            }
+            else
+            {
+                // Large allocations use the chunk exclusively, so that the remaining
+                // space in the current chunk is not wasted.
+            }
+            return Ptr;
+        }
+
+        template <typename T>
+        NODISCARD T* Allocate(size_t Count = 1)
+        {
+            return reinterpret_cast<T*>(Allocate(sizeof(T) * Count, alignof(T)));
+        }
+
+        template <typename T, typename... Args>
+        NODISCARD T* Construct(Args&&... args)
+        {
+            T* Ptr = Allocate<T>(1);
+            new (Ptr) T{std::forward<Args>(args)...};
+            return Ptr;
+        }
+
+        template <typename T, typename... Args>
+        NODISCARD T* ConstructArray(size_t Count, const Args&... args)
+        {
+            T* Ptr = Allocate<T>(Count);
+            for (size_t i = 0; i < Count; ++i)
+            {
+                new (Ptr + i) T{args...};
+            }
+            return Ptr;
+        }
+
+        template <typename T>
+        NODISCARD T* CopyArray(const T* Src, size_t Count)
+        {
+            T* Dst = Allocate<T>(Count);
+            for (size_t i = 0; i < Count; ++i)
+            {
+                new (Dst + i) T{Src[i]};
+            }
+            return Dst;
+        }
+
+        NODISCARD Char* CopyString(const Char* Str, size_t Len = 0)
+        {
+            if (Str == nullptr)
+                return nullptr;
+
+            Len = GetStringLength(Str, Len);
+            return CopyStringData(Allocate<Char>(Len + 1), Str, Len);
+        }
+
+        NODISCARD Char* CopyString(const String& Str)
+        {
+            return CopyString(Str.c_str(), Str.length());
+        }
+
+        /// Implementation of IMemoryAllocator::Allocate(). The memory is aligned by the fundamental alignment.
+        virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final
+        {
+            return Allocate(Size, alignof(std::max_align_t));
+        }
+
+        /// Implementation of IMemoryAllocator::Free(). Does nothing as the memory is owned by the parent allocator.
+        virtual void Free(void* Ptr) override final
+        {
+        }
+
+    private:
+        ConcurrentLinearAllocator* const m_pParent;
+
+        Uint8* m_pCurrPtr = nullptr;
+        Uint8* m_pEndPtr  = nullptr;
+
+#ifdef DILIGENT_DEBUG
+        const Uint32 m_DbgGeneration;
+#endif
+    };
+
+private:
+    struct Chunk
+    {
+        // The list of all chunks. The field is not modified after the chunk has been added to the list.
+        Chunk* pNextAllocated = nullptr;
+        // The list of free chunks that can be reused after the allocator has been reset.
+        Chunk* pNextFree = nullptr;
+
+        std::atomic<size_t> Offset{0};
+
+        const size_t Size;
+
+        explicit Chunk(size_t _Size) noexcept :
+            Size{_Size}
+        {}
+
+        Uint8* GetData()
+        {
+            return reinterpret_cast<Uint8*>(this) + HeaderSize;
+        }
+
+        // Size of the chunk header padded to the fundamental alignment
+        static constexpr size_t HeaderSize = (sizeof(Chunk*) * 2 + sizeof(size_t) * 2 + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    };
+    static_assert(sizeof(Chunk) <= Chunk::HeaderSize, "Chunk header size is too small");
+
+    // Acquires a chunk that can hold at least MinSize bytes. This method is lock-free except for
+    // the raw memory allocation when there are no free chunks.
+    Chunk* AcquireChunk(size_t MinSize)
+    {
+        if (MinSize <= m_ChunkSize)
+        {
+            // Chunks are only pushed to the free list by Reset(), which can't run concurrently
+            // with this method. Since chunks are never returned to the list while it is being
+            // popped, there is no ABA problem.
+            auto* pChunk = m_pFreeChunks.load(std::memory_order_acquire);
+            while (pChunk != nullptr && !m_pFreeChunks.compare_exchange_weak(pChunk, pChunk->pNextFree, std::memory_order_acq_rel))
+            {
+            }
+            if (pChunk != nullptr)
+                return pChunk;
+        }
+
+        const auto ChunkSize = MinSize <= m_ChunkSize ? m_ChunkSize : AlignUp(MinSize, alignof(std::max_align_t));
+        auto*      pRawMem   = m_pRawAllocator->Allocate(Chunk::HeaderSize + ChunkSize, "Concurrent linear allocator chunk", __FILE__, __LINE__);
+        VERIFY(AlignUp(pRawMem, alignof(std::max_align_t)) == pRawMem, "Raw memory is not properly aligned");
+        auto* pChunk = new (pRawMem) Chunk{ChunkSize};
+
+        // Add the chunk to the list of all chunks
+        pChunk->pNextAllocated = m_pAllChunks.load(std::memory_order_relaxed);
+        while (!m_pAllChunks.compare_exchange_weak(pChunk->pNextAllocated, pChunk, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+
+        return pChunk;
+    }
+
+    void DestroyChunk(Chunk* pChunk)
+    {
+        pChunk->~Chunk();
+        m_pRawAllocator->Free(pChunk);
+    }
+
+    static size_t GetStringLength(const Char* Str, size_t Len)
+    {
+        if (Len == 0)
+            Len = strlen(Str);
+        else
+            VERIFY_EXPR(Len <= strlen(Str));
+        return Len;
+    }
+
+    static Char* CopyStringData(Char* Dst, const Char* Str, size_t Len)
+    {
+        std::memcpy(Dst, Str, sizeof(Char) * Len);
+        Dst[Len] = 0;
+        return Dst;
+    }
+
+    const size_t            m_ChunkSize;
+    IMemoryAllocator* const m_pRawAllocator;
+
+    std::atomic<Chunk*> m_pCurrChunk{nullptr};
+    std::atomic<Chunk*> m_pFreeChunks{nullptr};
+    std::atomic<Chunk*> m_pAllChunks{nullptr};
+
+#ifdef DILIGENT_DEBUG
+    std::atomic<Uint32> m_DbgGeneration{0};
+#endif
+};
+
+} // namespace Diligent
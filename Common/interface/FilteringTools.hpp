@@ -99,6 +99,9 @@ struct LinearTexFilterSampleInfo
 template <TEXTURE_ADDRESS_MODE AddressMode, bool IsNormalizedCoord>
 LinearTexFilterSampleInfo GetLinearTexFilterSampleInfo(Uint32 Width, float u)
 {
+    static_assert(AddressMode != TEXTURE_ADDRESS_BORDER,
+                  "Border address mode is not supported. Use TEXTURE_ADDRESS_UNKNOWN and handle indices outside of the texture.");
+
     float x  = IsNormalizedCoord ? u * static_cast<float>(Width) : u;
     float x0 = FastFloor(x - 0.5f);
 
@@ -150,6 +153,11 @@ LinearTexFilterSampleInfo GetLinearTexFilterSampleInfo(Uint32 Width, float u)
             SampleInfo.i1 = clamp(SampleInfo.i1, 0, static_cast<Int32>(Width - 1));
             break;
 
+        case TEXTURE_ADDRESS_MIRROR_ONCE:
+            SampleInfo.i0 = clamp(SampleInfo.i0 < 0 ? -SampleInfo.i0 - 1 : SampleInfo.i0, 0, static_cast<Int32>(Width - 1));
+            SampleInfo.i1 = clamp(SampleInfo.i1 < 0 ? -SampleInfo.i1 - 1 : SampleInfo.i1, 0, static_cast<Int32>(Width - 1));
+            break;
+
         default:
             UNEXPECTED("Unexpected texture address mode");
     }
@@ -245,4 +253,96 @@ DstType FilterTexture2DBilinearClampUC(Uint32         Width,
     return FilterTexture2DBilinear<SrcType, DstType, TEXTURE_ADDRESS_CLAMP, TEXTURE_ADDRESS_CLAMP, false>(Width, Height, pData, Stride, u, v);
 }
 
+/// Computes linear filter sample info for every pixel of a row (or a column) of the image that
+/// is resampled from SrcWidth to DstWidth pixels, see Diligent::GetLinearTexFilterSampleInfo.
+///
+/// \param [in]  AddressMode - Texture address mode. TEXTURE_ADDRESS_UNKNOWN leaves the indices
+///                            unmodified, so they may be outside of [0, SrcWidth-1] range.
+/// \param [in]  SrcWidth    - Source image width.
+/// \param [in]  DstWidth    - Destination image width.
+/// \param [out] pSampleInfo - An array of DstWidth elements that receives sample info for every
+///                            destination pixel. Pixel x is sampled at u = (x + 0.5) / DstWidth.
+inline void GetLinearTexFilterSampleInfoTable(TEXTURE_ADDRESS_MODE       AddressMode,
+                                              Uint32                     SrcWidth,
+                                              Uint32                     DstWidth,
+                                              LinearTexFilterSampleInfo* pSampleInfo)
+{
+    auto Fill = [&](auto GetSampleInfo) {
+        for (Uint32 x = 0; x < DstWidth; ++x)
+            pSampleInfo[x] = GetSampleInfo(SrcWidth, (static_cast<float>(x) + 0.5f) / static_cast<float>(DstWidth));
+    };
+
+    switch (AddressMode)
+    {
+        // clang-format off
+        case TEXTURE_ADDRESS_WRAP:        Fill(GetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_WRAP,        true>); break;
+        case TEXTURE_ADDRESS_MIRROR:      Fill(GetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR,      true>); break;
+        case TEXTURE_ADDRESS_CLAMP:       Fill(GetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_CLAMP,       true>); break;
+        case TEXTURE_ADDRESS_UNKNOWN:     Fill(GetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_UNKNOWN,     true>); break;
+        case TEXTURE_ADDRESS_MIRROR_ONCE: Fill(GetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE, true>); break;
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected texture address mode");
+            Fill(GetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_CLAMP, true>);
+    }
+}
+
+/// Attributes of the ResampleImageBilinear function
+struct ResampleImageAttribs
+{
+    /// Source image width
+    Uint32 SrcWidth = 0;
+
+    /// Source image height
+    Uint32 SrcHeight = 0;
+
+    /// Pointer to the source image data
+    const void* pSrcData = nullptr;
+
+    /// Source image row stride, in bytes
+    size_t SrcStride = 0;
+
+    /// Destination image width
+    Uint32 DstWidth = 0;
+
+    /// Destination image height
+    Uint32 DstHeight = 0;
+
+    /// Pointer to the destination image data
+    void* pDstData = nullptr;
+
+    /// Destination image row stride, in bytes
+    size_t DstStride = 0;
+
+    /// Component type of both images: VT_UINT8, VT_UINT16 or VT_FLOAT32.
+    /// Integer values are not normalized.
+    VALUE_TYPE ComponentType = VT_FLOAT32;
+
+    /// The number of components per pixel, from 1 to 4
+    Uint32 NumComponents = 4;
+
+    /// Horizontal address mode
+    TEXTURE_ADDRESS_MODE AddressModeU = TEXTURE_ADDRESS_CLAMP;
+
+    /// Vertical address mode
+    TEXTURE_ADDRESS_MODE AddressModeV = TEXTURE_ADDRESS_CLAMP;
+
+    /// Border color for TEXTURE_ADDRESS_BORDER mode, in the same units as the image components
+    float BorderColor[4] = {};
+
+    /// The number of threads to use. 0 uses all hardware threads.
+    Uint32 NumThreads = 0;
+};
+
+/// Resamples the entire image using bilinear filter.
+
+/// \remarks   Destination pixel (x, y) is computed the same way as
+///             FilterTexture2DBilinear() at u = (x + 0.5) / DstWidth, v = (y + 0.5) / DstHeight
+///             with normalized coordinates. Integer results are rounded to the nearest value.
+///
+///             The function filters every source row once horizontally and then blends pairs of
+///             the filtered rows. Destination rows are split between the threads.
+///             Source and destination images must not overlap.
+void ResampleImageBilinear(const ResampleImageAttribs& Attribs);
+
 } // namespace Diligent
@@ -35,10 +35,12 @@
 #include <unordered_set>
 #include <vector>
 #include <cstring>
+#include <cstddef>
 #include <memory>
 #include "../../Primitives/interface/Errors.hpp"
 #include "../../Primitives/interface/MemoryAllocator.h"
 #include "STDAllocator.hpp"
+#include "LockHelper.hpp"
 
 namespace Diligent
 {
@@ -53,10 +55,18 @@ inline void FillWithDebugPattern(void* ptr, Uint8 Pattern, size_t NumBytes)
 #endif
 
 /// Memory allocator that allocates memory in a fixed-size chunks
+
+/// Every block is prefixed with a small header that stores the index of the page the
+/// block belongs to, so that the page can be found by address arithmetic when the block is released.
+///
+/// When thread caches are enabled, the allocator keeps a set of small free-block caches (magazines).
+/// Every thread is assigned its own cache, so that the common allocate/free path only locks
+/// an uncontended spin lock flag. The global mutex is only taken when a cache needs
+/// to be refilled from or flushed back to the memory pages.
 class FixedBlockMemoryAllocator final : public IMemoryAllocator
 {
 public:
-    FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator, size_t BlockSize, Uint32 NumBlocksInPage);
+    FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator, size_t BlockSize, Uint32 NumBlocksInPage, bool EnableThreadCaches = false);
     ~FixedBlockMemoryAllocator();
 
     /// Allocates block of memory
@@ -73,7 +83,25 @@ private:
     FixedBlockMemoryAllocator& operator = (FixedBlockMemoryAllocator&&)      = delete;
     // clang-format on
 
-    void CreateNewPage();
+    void  CreateNewPage();
+    void* AllocateFromPages();
+    void  FreeToPage(void* Ptr);
+
+    struct ThreadCache;
+    void RefillThreadCache(ThreadCache& Cache);
+    void FlushThreadCache(ThreadCache& Cache, Uint32 NumBlocksToKeep);
+
+    // Every block starts with the header that contains the index of the page the block belongs to.
+    // The header is followed by the block data that is returned to the user.
+    // The header is padded to the maximum fundamental alignment (but at least 16 bytes),
+    // and the block stride is a multiple of the header size, so that the data of every block
+    // is suitably aligned for SIMD types (float4x4 etc.).
+    static constexpr size_t BlockHeaderSize = alignof(std::max_align_t) > 16 ? alignof(std::max_align_t) : 16;
+
+    static size_t GetBlockPageId(const void* Ptr)
+    {
+        return *reinterpret_cast<const size_t*>(reinterpret_cast<const Uint8*>(Ptr) - BlockHeaderSize);
+    }
 
     // Memory page class is based on the fixed-size memory pool described in "Fast Efficient Fixed-Size Memory Pool"
     // by Ben Kenwright
@@ -85,16 +113,18 @@ private:
         static constexpr Uint8 DeallocatedBlockMemPattern = 0xDE;
         static constexpr Uint8 InitializedBlockMemPattern = 0xCF;
 
-        MemoryPage(FixedBlockMemoryAllocator& OwnerAllocator) :
+        MemoryPage(FixedBlockMemoryAllocator& OwnerAllocator, size_t PageId) :
             // clang-format off
             m_NumFreeBlocks       {OwnerAllocator.m_NumBlocksInPage},
             m_NumInitializedBlocks{0},
+            m_PageId              {PageId},
             m_pOwnerAllocator     {&OwnerAllocator}
         // clang-format on
         {
-            auto PageSize = OwnerAllocator.m_BlockSize * OwnerAllocator.m_NumBlocksInPage;
+            auto PageSize = OwnerAllocator.m_BlockStride * OwnerAllocator.m_NumBlocksInPage;
             m_pPageStart  = reinterpret_cast<Uint8*>(
                 OwnerAllocator.m_RawMemoryAllocator.Allocate(PageSize, "FixedBlockMemoryAllocator page", __FILE__, __LINE__));
+            VERIFY(reinterpret_cast<size_t>(m_pPageStart) % alignof(std::max_align_t) == 0, "Raw memory allocator returned misaligned page memory");
             m_pNextFreeBlock = m_pPageStart;
             FillWithDebugPattern(m_pPageStart, NewPageMemPattern, PageSize);
         }
@@ -103,6 +133,7 @@ private:
             // clang-format off
             m_NumFreeBlocks       {Page.m_NumFreeBlocks       },
             m_NumInitializedBlocks{Page.m_NumInitializedBlocks},
+            m_PageId              {Page.m_PageId              },
             m_pPageStart          {Page.m_pPageStart          },
             m_pNextFreeBlock      {Page.m_pNextFreeBlock      },
             m_pOwnerAllocator     {Page.m_pOwnerAllocator     }
@@ -125,15 +156,16 @@ private:
         {
             VERIFY_EXPR(m_pOwnerAllocator != nullptr);
             VERIFY(BlockIndex >= 0 && BlockIndex < m_pOwnerAllocator->m_NumBlocksInPage, "Invalid block index");
-            return reinterpret_cast<Uint8*>(m_pPageStart) + BlockIndex * m_pOwnerAllocator->m_BlockSize;
+            return reinterpret_cast<Uint8*>(m_pPageStart) + BlockIndex * m_pOwnerAllocator->m_BlockStride;
         }
 
 #ifdef DILIGENT_DEBUG
         void dbgVerifyAddress(const void* pBlockAddr) const
         {
+            VERIFY(pBlockAddr >= m_pPageStart, "Address does not belong to this page");
             size_t Delta = reinterpret_cast<const Uint8*>(pBlockAddr) - reinterpret_cast<Uint8*>(m_pPageStart);
-            VERIFY(Delta % m_pOwnerAllocator->m_BlockSize == 0, "Invalid address");
-            Uint32 BlockIndex = static_cast<Uint32>(Delta / m_pOwnerAllocator->m_BlockSize);
+            VERIFY(Delta % m_pOwnerAllocator->m_BlockStride == 0, "Invalid address");
+            Uint32 BlockIndex = static_cast<Uint32>(Delta / m_pOwnerAllocator->m_BlockStride);
             VERIFY(BlockIndex >= 0 && BlockIndex < m_pOwnerAllocator->m_NumBlocksInPage, "Invalid block index");
         }
 #else
@@ -170,7 +202,7 @@ private:
                 //                            -----------                      -----------
                 //
                 auto* pUninitializedBlock = GetBlockStartAddress(m_NumInitializedBlocks);
-                FillWithDebugPattern(pUninitializedBlock, InitializedBlockMemPattern, m_pOwnerAllocator->m_BlockSize);
+                FillWithDebugPattern(pUninitializedBlock, InitializedBlockMemPattern, m_pOwnerAllocator->m_BlockStride);
                 void** ppNextBlock = reinterpret_cast<void**>(pUninitializedBlock);
                 ++m_NumInitializedBlocks;
                 if (m_NumInitializedBlocks < m_pOwnerAllocator->m_NumBlocksInPage)
@@ -179,8 +211,8 @@ private:
                     *ppNextBlock = nullptr;
             }
 
-            void* res = m_pNextFreeBlock;
-            dbgVerifyAddress(res);
+            void* pBlock = m_pNextFreeBlock;
+            dbgVerifyAddress(pBlock);
             // Move pointer to the next free block
             m_pNextFreeBlock = *reinterpret_cast<void**>(m_pNextFreeBlock);
             --m_NumFreeBlocks;
@@ -189,6 +221,10 @@ private:
             else
                 VERIFY_EXPR(m_pNextFreeBlock == nullptr);
 
+            // Write the page id into the block header. It is used to find the page when the block is released.
+            *reinterpret_cast<size_t*>(pBlock) = m_PageId;
+
+            auto* res = reinterpret_cast<Uint8*>(pBlock) + BlockHeaderSize;
             FillWithDebugPattern(res, AllocatedBlockMemPattern, m_pOwnerAllocator->m_BlockSize);
             return res;
         }
@@ -197,11 +233,14 @@ private:
         {
             VERIFY_EXPR(m_pOwnerAllocator != nullptr);
 
-            dbgVerifyAddress(p);
-            FillWithDebugPattern(p, DeallocatedBlockMemPattern, m_pOwnerAllocator->m_BlockSize);
+            void* pBlock = reinterpret_cast<Uint8*>(p) - BlockHeaderSize;
+            dbgVerifyAddress(pBlock);
+            VERIFY(GetBlockPageId(p) == m_PageId, "The block does not belong to this page");
+            VERIFY(m_NumFreeBlocks < m_pOwnerAllocator->m_NumBlocksInPage, "All blocks in the page are free - double freeing memory?");
+            FillWithDebugPattern(pBlock, DeallocatedBlockMemPattern, m_pOwnerAllocator->m_BlockStride);
             // Add block to the beginning of the linked list
-            *reinterpret_cast<void**>(p) = m_pNextFreeBlock;
-            m_pNextFreeBlock             = p;
+            *reinterpret_cast<void**>(pBlock) = m_pNextFreeBlock;
+            m_pNextFreeBlock                  = pBlock;
             ++m_NumFreeBlocks;
         }
 
@@ -215,21 +254,41 @@ private:
 
         Uint32                     m_NumFreeBlocks        = 0;       // Num of remaining blocks
         Uint32                     m_NumInitializedBlocks = 0;       // Num of initialized blocks
+        size_t                     m_PageId               = 0;       // Index of this page in the page pool
         void*                      m_pPageStart           = nullptr; // Beginning of memory pool
         void*                      m_pNextFreeBlock       = nullptr; // Num of next free block
         FixedBlockMemoryAllocator* m_pOwnerAllocator      = nullptr;
     };
 
+    // Per-thread cache of free blocks. Free blocks in the cache are linked through
+    // their data (the block header is left intact so that the block can be returned to its page).
+    struct ThreadCache
+    {
+        ThreadingTools::LockFlag Lock;
+
+        void*  pFirstBlock = nullptr;
+        Uint32 NumBlocks   = 0;
+
+        // Keep caches on separate cache lines to avoid false sharing
+        Uint8 Padding[64 - sizeof(ThreadingTools::LockFlag) - sizeof(void*) - sizeof(Uint32)];
+    };
+
+    // Maximum number of free blocks that a single thread cache may hold.
+    // When the limit is exceeded, half of the blocks are returned to the pages.
+    static constexpr Uint32 MaxThreadCacheBlocks = 32;
+    // Number of blocks that are moved from the pages into an empty thread cache
+    static constexpr Uint32 ThreadCacheRefillSize = MaxThreadCacheBlocks / 2;
+
     std::vector<MemoryPage, STDAllocatorRawMem<MemoryPage>>                                          m_PagePool;
     std::unordered_set<size_t, std::hash<size_t>, std::equal_to<size_t>, STDAllocatorRawMem<size_t>> m_AvailablePages;
 
-    using AddrToPageIdMapElem = std::pair<void* const, size_t>;
-    std::unordered_map<void*, size_t, std::hash<void*>, std::equal_to<void*>, STDAllocatorRawMem<AddrToPageIdMapElem>> m_AddrToPageId;
+    std::vector<ThreadCache, STDAllocatorRawMem<ThreadCache>> m_ThreadCaches;
 
     std::mutex m_Mutex;
 
     IMemoryAllocator& m_RawMemoryAllocator;
     const size_t      m_BlockSize;
+    const size_t      m_BlockStride;
     const Uint32      m_NumBlocksInPage;
 };
 
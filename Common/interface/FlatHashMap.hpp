@@ -0,0 +1,793 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::FlatHashMap class template
+
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <iterator>
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DILIGENT_FLAT_HASH_MAP_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define DILIGENT_FLAT_HASH_MAP_SSE2 0
+#endif
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Platforms/interface/PlatformMisc.hpp"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "HashUtils.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+namespace FlatHashMapInternal
+{
+
+// Every slot of the table has a control byte:
+// - Empty slots are marked with CtrlEmpty
+// - Erased slots are marked with CtrlDeleted (tombstone)
+// - Full slots store 7 lowest bits of the element hash (the top bit is always clear)
+using CtrlType = Int8;
+
+static constexpr CtrlType CtrlEmpty   = -128; // 0b10000000
+static constexpr CtrlType CtrlDeleted = -2;   // 0b11111110
+
+inline bool IsFull(CtrlType Ctrl)
+{
+    return Ctrl >= 0;
+}
+
+#if DILIGENT_FLAT_HASH_MAP_SSE2
+
+// A group of 16 control bytes that are tested in parallel using SSE2
+struct Group
+{
+    static constexpr size_t Width = 16;
+    using BitMaskType             = Uint32;
+
+    explicit Group(const CtrlType* pCtrl) :
+        m_Ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCtrl))}
+    {}
+
+    // Returns the bit mask of the slots whose control byte matches H2
+    BitMaskType Match(CtrlType H2) const
+    {
+        return static_cast<BitMaskType>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), m_Ctrl)));
+    }
+
+    BitMaskType MatchEmpty() const
+    {
+        return Match(CtrlEmpty);
+    }
+
+    // Empty and deleted slots are the only ones with the top bit set
+    BitMaskType MatchEmptyOrDeleted() const
+    {
+        return static_cast<BitMaskType>(_mm_movemask_epi8(m_Ctrl));
+    }
+
+    // Returns the index of the lowest set bit and clears it
+    static size_t ExtractLowestBit(BitMaskType& Mask)
+    {
+        VERIFY_EXPR(Mask != 0);
+        const auto Idx = PlatformMisc::GetLSB(Mask);
+        Mask &= Mask - 1;
+        return Idx;
+    }
+
+private:
+    const __m128i m_Ctrl;
+};
+
+#else
+
+// A group of 8 control bytes that are tested in parallel using 64-bit integer arithmetic.
+// The implementation assumes little-endian byte order.
+struct Group
+{
+    static constexpr size_t Width = 8;
+    using BitMaskType             = Uint64;
+
+    explicit Group(const CtrlType* pCtrl)
+    {
+        memcpy(&m_Ctrl, pCtrl, sizeof(m_Ctrl));
+    }
+
+    // Returns the mask that has the top bit set in every byte that matches H2.
+    // The mask may contain false positives, but only for full slots, so they are
+    // filtered out by the key comparison.
+    BitMaskType Match(CtrlType H2) const
+    {
+        const auto x = m_Ctrl ^ (LSBs * static_cast<Uint8>(H2));
+        return (x - LSBs) & ~x & MSBs;
+    }
+
+    // Only empty bytes have the top bit set and the bit 1 clear
+    BitMaskType MatchEmpty() const
+    {
+        return (m_Ctrl & (~m_Ctrl << 6)) & MSBs;
+    }
+
+    BitMaskType MatchEmptyOrDeleted() const
+    {
+        return m_Ctrl & MSBs;
+    }
+
+    static size_t ExtractLowestBit(BitMaskType& Mask)
+    {
+        VERIFY_EXPR(Mask != 0);
+        const auto Idx = PlatformMisc::GetLSB(Mask) >> 3;
+        Mask &= Mask - 1;
+        return Idx;
+    }
+
+private:
+    static constexpr Uint64 LSBs = 0x0101010101010101ull;
+    static constexpr Uint64 MSBs = 0x8080808080808080ull;
+
+    Uint64 m_Ctrl;
+};
+
+#endif
+
+template <typename...>
+struct MakeVoid
+{
+    using type = void;
+};
+
+// Heterogeneous lookup is enabled when both the hasher and the key comparison functor define is_transparent
+template <typename HasherType, typename KeyEqualType, typename = void>
+struct IsTransparent : std::false_type
+{};
+
+template <typename HasherType, typename KeyEqualType>
+struct IsTransparent<HasherType, KeyEqualType, typename MakeVoid<typename HasherType::is_transparent, typename KeyEqualType::is_transparent>::type> : std::true_type
+{};
+
+} // namespace FlatHashMapInternal
+
+
+/// Open-addressing hash map with SwissTable-style control bytes.
+
+/// Elements are stored in a single flat array, and every element has a one-byte
+/// control code that contains 7 bits of the element hash. A lookup compares
+/// a group of control bytes at once (16 with SSE2, 8 otherwise) and only compares
+/// keys of the elements whose control bytes match, so most lookups touch a single
+/// cache line of control bytes and a single element.
+///
+/// The interface follows std::unordered_map with the following differences:
+/// - Inserting an element may move other elements, so all iterators, pointers and references
+///   are invalidated by insertion. Erasing an element does not move other elements.
+/// - If both Hasher and KeyEqual define is_transparent, find() and count() accept any key
+///   type the functors can handle (e.g. const Char* for HashMapStringKey).
+///
+/// \tparam KeyType       - Key type.
+/// \tparam ValueType     - Mapped value type.
+/// \tparam Hasher        - Hash function.
+/// \tparam KeyEqual      - Key comparison function. KeyEqual(StoredKey, LookupKey) is called.
+/// \tparam AllocatorType - Allocator, e.g. STDAllocatorRawMem. All memory is allocated as a single
+///                         block through the allocator rebound to Uint8.
+template <typename KeyType,
+          typename ValueType,
+          typename Hasher        = std::hash<KeyType>,
+          typename KeyEqual      = std::equal_to<KeyType>,
+          typename AllocatorType = std::allocator<std::pair<const KeyType, ValueType>>>
+class FlatHashMap
+{
+public:
+    using key_type        = KeyType;
+    using mapped_type     = ValueType;
+    using value_type      = std::pair<const KeyType, ValueType>;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher          = Hasher;
+    using key_equal       = KeyEqual;
+    using allocator_type  = AllocatorType;
+
+private:
+    template <bool IsConst>
+    class IteratorBase
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename FlatHashMap::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+        using reference         = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+        using MapPtrType        = typename std::conditional<IsConst, const FlatHashMap*, FlatHashMap*>::type;
+
+        IteratorBase() noexcept {}
+
+        IteratorBase(MapPtrType pMap, size_t Index) noexcept :
+            m_pMap{pMap},
+            m_Index{Index}
+        {}
+
+        // Conversion from iterator to const_iterator
+        template <bool OtherIsConst, typename = typename std::enable_if<IsConst && !OtherIsConst>::type>
+        IteratorBase(const IteratorBase<OtherIsConst>& Other) noexcept :
+            m_pMap{Other.m_pMap},
+            m_Index{Other.m_Index}
+        {}
+
+        reference operator*() const
+        {
+            VERIFY_EXPR(m_pMap != nullptr && m_Index < m_pMap->m_Capacity && FlatHashMapInternal::IsFull(m_pMap->m_Ctrl[m_Index]));
+            return m_pMap->m_Slots[m_Index];
+        }
+
+        pointer operator->() const
+        {
+            return &operator*();
+        }
+
+        IteratorBase& operator++()
+        {
+            VERIFY_EXPR(m_pMap != nullptr && m_Index < m_pMap->m_Capacity);
+            m_Index = m_pMap->FindNextFull(m_Index + 1);
+            return *this;
+        }
+
+        IteratorBase operator++(int)
+        {
+            auto Tmp = *this;
+            ++(*this);
+            return Tmp;
+        }
+
+        bool operator==(const IteratorBase& rhs) const
+        {
+            VERIFY(m_pMap == rhs.m_pMap, "Comparing iterators of different maps");
+            return m_Index == rhs.m_Index;
+        }
+
+        bool operator!=(const IteratorBase& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        friend class FlatHashMap;
+        template <bool>
+        friend class IteratorBase;
+
+        MapPtrType m_pMap  = nullptr;
+        size_t     m_Index = 0;
+    };
+
+public:
+    using iterator       = IteratorBase<false>;
+    using const_iterator = IteratorBase<true>;
+
+    FlatHashMap() :
+        FlatHashMap{AllocatorType{}}
+    {}
+
+    explicit FlatHashMap(const AllocatorType& Allocator, const Hasher& Hash = Hasher{}, const KeyEqual& Equal = KeyEqual{}) :
+        m_Allocator{Allocator},
+        m_Hasher{Hash},
+        m_KeyEqual{Equal}
+    {}
+
+    FlatHashMap(FlatHashMap&& Other) noexcept :
+        // clang-format off
+        m_Allocator {std::move(Other.m_Allocator)},
+        m_Hasher    {std::move(Other.m_Hasher)   },
+        m_KeyEqual  {std::move(Other.m_KeyEqual) },
+        m_Slots     {Other.m_Slots               },
+        m_Ctrl      {Other.m_Ctrl                },
+        m_Capacity  {Other.m_Capacity            },
+        m_Size      {Other.m_Size                },
+        m_GrowthLeft{Other.m_GrowthLeft          },
+        m_MaxLoadFactor{Other.m_MaxLoadFactor    }
+    // clang-format on
+    {
+        Other.m_Slots      = nullptr;
+        Other.m_Ctrl       = nullptr;
+        Other.m_Capacity   = 0;
+        Other.m_Size       = 0;
+        Other.m_GrowthLeft = 0;
+    }
+
+    // clang-format off
+    FlatHashMap           (const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(FlatHashMap&&)      = delete;
+    // clang-format on
+
+    ~FlatHashMap()
+    {
+        DestroyElements();
+        FreeTable();
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator{this, FindNextFull(0)};
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator{this, FindNextFull(0)};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    iterator end() noexcept
+    {
+        return iterator{this, m_Capacity};
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator{this, m_Capacity};
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_Size == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_Size;
+    }
+
+    /// Returns the number of slots in the table.
+    size_t capacity() const noexcept
+    {
+        return m_Capacity;
+    }
+
+    /// Destroys all elements, but keeps the table memory.
+    void clear()
+    {
+        DestroyElements();
+        if (m_Capacity > 0)
+        {
+            memset(m_Ctrl, FlatHashMapInternal::CtrlEmpty, GetNumCtrlBytes(m_Capacity));
+            m_GrowthLeft = GetMaxLoad(m_Capacity);
+        }
+        m_Size = 0;
+    }
+
+    float max_load_factor() const noexcept
+    {
+        return m_MaxLoadFactor;
+    }
+
+    /// Sets the maximum load factor. The value is clamped to [MinMaxLoadFactor, DefaultMaxLoadFactor]:
+    /// the table must always have empty slots to terminate the probe sequence.
+    void max_load_factor(float MaxLoadFactor)
+    {
+        DEV_CHECK_ERR(MaxLoadFactor > 0, "Max load factor must be positive");
+        m_MaxLoadFactor = std::min(std::max(MaxLoadFactor, float{MinMaxLoadFactor}), float{DefaultMaxLoadFactor});
+        if (m_Capacity > 0)
+        {
+            size_t NewCapacity = size_t{Group::Width};
+            while (GetMaxLoad(NewCapacity) < m_Size)
+                NewCapacity *= 2;
+            Resize(std::max(NewCapacity, m_Capacity));
+        }
+    }
+
+    /// Makes sure that Count elements can be stored without rehashing.
+    void reserve(size_t Count)
+    {
+        if (Count <= m_Size + m_GrowthLeft)
+            return;
+
+        size_t NewCapacity = std::max(m_Capacity, size_t{Group::Width});
+        while (GetMaxLoad(NewCapacity) < Count)
+            NewCapacity *= 2;
+        Resize(NewCapacity);
+    }
+
+    iterator find(const KeyType& Key)
+    {
+        return iterator{this, FindIndex(Key)};
+    }
+    const_iterator find(const KeyType& Key) const
+    {
+        return const_iterator{this, FindIndex(Key)};
+    }
+
+    /// Heterogeneous lookup that does not construct KeyType
+    template <typename K, typename = typename std::enable_if<FlatHashMapInternal::IsTransparent<Hasher, KeyEqual>::value, K>::type>
+    iterator find(const K& Key)
+    {
+        return iterator{this, FindIndex(Key)};
+    }
+    template <typename K, typename = typename std::enable_if<FlatHashMapInternal::IsTransparent<Hasher, KeyEqual>::value, K>::type>
+    const_iterator find(const K& Key) const
+    {
+        return const_iterator{this, FindIndex(Key)};
+    }
+
+    size_t count(const KeyType& Key) const
+    {
+        return FindIndex(Key) != m_Capacity ? 1 : 0;
+    }
+    template <typename K, typename = typename std::enable_if<FlatHashMapInternal::IsTransparent<Hasher, KeyEqual>::value, K>::type>
+    size_t count(const K& Key) const
+    {
+        return FindIndex(Key) != m_Capacity ? 1 : 0;
+    }
+
+    /// Inserts the element if there is no element with the same key.
+    /// Unlike std::unordered_map::try_emplace, the value is constructed only if the key is not found.
+    template <typename... ArgsType>
+    std::pair<iterator, bool> try_emplace(const KeyType& Key, ArgsType&&... Args)
+    {
+        return TryEmplaceImpl(Key, std::forward<ArgsType>(Args)...);
+    }
+    template <typename... ArgsType>
+    std::pair<iterator, bool> try_emplace(KeyType&& Key, ArgsType&&... Args)
+    {
+        return TryEmplaceImpl(std::move(Key), std::forward<ArgsType>(Args)...);
+    }
+
+    /// Constructs the element from the arguments and inserts it if there is no element with the same key.
+    template <typename... ArgsType>
+    std::pair<iterator, bool> emplace(ArgsType&&... Args)
+    {
+        // The key is not known until the element is constructed, so construct it in
+        // temporary storage first and move to the table if the key is not found.
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type Storage;
+
+        auto* pTmpElem = new (&Storage) value_type(std::forward<ArgsType>(Args)...);
+
+        const auto Res = FindOrPrepareInsert(pTmpElem->first);
+        if (Res.second)
+            MoveConstructElement(&m_Slots[Res.first], *pTmpElem);
+        pTmpElem->~value_type();
+
+        return {iterator{this, Res.first}, Res.second};
+    }
+
+    template <typename PairType>
+    std::pair<iterator, bool> insert(PairType&& Elem)
+    {
+        return emplace(std::forward<PairType>(Elem));
+    }
+
+    ValueType& operator[](const KeyType& Key)
+    {
+        return try_emplace(Key).first->second;
+    }
+    ValueType& operator[](KeyType&& Key)
+    {
+        return try_emplace(std::move(Key)).first->second;
+    }
+
+    /// Erases the element and returns the iterator to the next element.
+    /// Other elements are not moved, so all other iterators remain valid.
+    iterator erase(const_iterator Pos)
+    {
+        VERIFY(Pos.m_pMap == this, "The iterator does not belong to this map");
+        EraseAt(Pos.m_Index);
+        return iterator{this, FindNextFull(Pos.m_Index + 1)};
+    }
+    iterator erase(iterator Pos)
+    {
+        return erase(const_iterator{Pos});
+    }
+
+    size_t erase(const KeyType& Key)
+    {
+        const auto Idx = FindIndex(Key);
+        if (Idx == m_Capacity)
+            return 0;
+
+        EraseAt(Idx);
+        return 1;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type{m_Allocator};
+    }
+
+private:
+    using Group         = FlatHashMapInternal::Group;
+    using CtrlType      = FlatHashMapInternal::CtrlType;
+    using ByteAllocator = typename std::allocator_traits<AllocatorType>::template rebind_alloc<Uint8>;
+
+    static_assert(alignof(value_type) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    static constexpr float DefaultMaxLoadFactor = 0.875f;
+    static constexpr float MinMaxLoadFactor     = 0.25f;
+
+    // Maximum number of elements in a table with the given capacity
+    size_t GetMaxLoad(size_t Capacity) const
+    {
+        return std::min(static_cast<size_t>(static_cast<double>(Capacity) * m_MaxLoadFactor), Capacity - Capacity / 8);
+    }
+
+    // Control bytes of the first group are duplicated after the last slot,
+    // so that a group can be loaded starting at any slot.
+    static size_t GetNumCtrlBytes(size_t Capacity)
+    {
+        return Capacity + Group::Width - 1;
+    }
+
+    static size_t GetTableSize(size_t Capacity)
+    {
+        return Capacity * sizeof(value_type) + GetNumCtrlBytes(Capacity);
+    }
+
+    template <typename K>
+    Uint64 ComputeHash(const K& Key) const
+    {
+        // Many std::hash implementations are identity functions for integers, so mix
+        // the bits: lower 7 bits are stored in the control byte, and the upper bits
+        // select the first probed group.
+        return WyHash::Mix(static_cast<Uint64>(m_Hasher(Key)), WyHash::Secret0);
+    }
+
+    static CtrlType GetH2(Uint64 Hash)
+    {
+        return static_cast<CtrlType>(Hash & 0x7F);
+    }
+
+    static size_t GetH1(Uint64 Hash)
+    {
+        return static_cast<size_t>(Hash >> 7);
+    }
+
+    void SetCtrl(size_t Idx, CtrlType Ctrl)
+    {
+        VERIFY_EXPR(Idx < m_Capacity);
+        m_Ctrl[Idx] = Ctrl;
+        if (Idx < Group::Width - 1)
+            m_Ctrl[m_Capacity + Idx] = Ctrl;
+    }
+
+    // Returns m_Capacity if the key is not found
+    template <typename K>
+    size_t FindIndex(const K& Key) const
+    {
+        return FindIndex(Key, ComputeHash(Key));
+    }
+
+    template <typename K>
+    size_t FindIndex(const K& Key, Uint64 Hash) const
+    {
+        if (m_Capacity == 0)
+            return 0;
+
+        const auto Mask = m_Capacity - 1;
+        const auto H2   = GetH2(Hash);
+
+        // Triangular probing visits every group exactly once when the capacity is a power of two
+        size_t Pos = GetH1(Hash) & Mask;
+        for (size_t Step = Group::Width;; Step += Group::Width)
+        {
+            const Group G{m_Ctrl + Pos};
+            for (auto Match = G.Match(H2); Match != 0;)
+            {
+                const auto Idx = (Pos + Group::ExtractLowestBit(Match)) & Mask;
+                if (m_KeyEqual(m_Slots[Idx].first, Key))
+                    return Idx;
+            }
+
+            // The table always has empty slots, so the loop terminates
+            if (G.MatchEmpty() != 0)
+                return m_Capacity;
+
+            VERIFY(Step <= m_Capacity, "All groups have been probed. This is a bug.");
+            Pos = (Pos + Step) & Mask;
+        }
+    }
+
+    // Returns the first empty or deleted slot in the probe sequence
+    size_t FindInsertIndex(Uint64 Hash) const
+    {
+        VERIFY_EXPR(m_Capacity > 0);
+        const auto Mask = m_Capacity - 1;
+
+        size_t Pos = GetH1(Hash) & Mask;
+        for (size_t Step = Group::Width;; Step += Group::Width)
+        {
+            auto Mask2 = Group{m_Ctrl + Pos}.MatchEmptyOrDeleted();
+            if (Mask2 != 0)
+                return (Pos + Group::ExtractLowestBit(Mask2)) & Mask;
+
+            VERIFY(Step <= m_Capacity, "All groups have been probed. This is a bug.");
+            Pos = (Pos + Step) & Mask;
+        }
+    }
+
+    // Finds the key or reserves a slot for it. The second member of the returned pair
+    // is true if the slot has been reserved and the element must be constructed in it.
+    template <typename K>
+    std::pair<size_t, bool> FindOrPrepareInsert(const K& Key)
+    {
+        const auto Hash = ComputeHash(Key);
+
+        const auto Idx = FindIndex(Key, Hash);
+        if (Idx != m_Capacity)
+            return {Idx, false};
+
+        auto InsertIdx = m_Capacity > 0 ? FindInsertIndex(Hash) : 0;
+        if (m_GrowthLeft == 0 && (m_Capacity == 0 || m_Ctrl[InsertIdx] != FlatHashMapInternal::CtrlDeleted))
+        {
+            Grow();
+            InsertIdx = FindInsertIndex(Hash);
+        }
+
+        // Reusing a tombstone does not reduce the number of empty slots
+        if (m_Ctrl[InsertIdx] == FlatHashMapInternal::CtrlEmpty)
+        {
+            VERIFY_EXPR(m_GrowthLeft > 0);
+            --m_GrowthLeft;
+        }
+        SetCtrl(InsertIdx, GetH2(Hash));
+        ++m_Size;
+
+        return {InsertIdx, true};
+    }
+
+    template <typename K, typename... ArgsType>
+    std::pair<iterator, bool> TryEmplaceImpl(K&& Key, ArgsType&&... Args)
+    {
+        const auto Res = FindOrPrepareInsert(Key);
+        if (Res.second)
+        {
+            new (&m_Slots[Res.first]) value_type(std::piecewise_construct,
+                                                 std::forward_as_tuple(std::forward<K>(Key)),
+                                                 std::forward_as_tuple(std::forward<ArgsType>(Args)...));
+        }
+        return {iterator{this, Res.first}, Res.second};
+    }
+
+    // Elements are relocated by moving the key too. The key is never modified while the element
+    // is in the table, and the source element is destroyed immediately after the move.
+    static void MoveConstructElement(value_type* pDst, value_type& Src)
+    {
+        new (pDst) value_type(std::move(const_cast<KeyType&>(Src.first)), std::move(Src.second));
+    }
+
+    void EraseAt(size_t Idx)
+    {
+        VERIFY_EXPR(Idx < m_Capacity && FlatHashMapInternal::IsFull(m_Ctrl[Idx]));
+        m_Slots[Idx].~value_type();
+        // Mark the slot as deleted rather than empty so that probe sequences passing
+        // through it are not broken. Tombstones are removed when the table is rehashed.
+        SetCtrl(Idx, FlatHashMapInternal::CtrlDeleted);
+        --m_Size;
+    }
+
+    size_t FindNextFull(size_t Idx) const
+    {
+        while (Idx < m_Capacity && !FlatHashMapInternal::IsFull(m_Ctrl[Idx]))
+            ++Idx;
+        return Idx;
+    }
+
+    void Grow()
+    {
+        if (m_Capacity == 0)
+            Resize(Group::Width);
+        else if (m_Size <= GetMaxLoad(m_Capacity) / 2)
+            Resize(m_Capacity); // The table is full of tombstones - rehash in place
+        else
+            Resize(m_Capacity * 2);
+    }
+
+    void Resize(size_t NewCapacity)
+    {
+        VERIFY(IsPowerOfTwo(NewCapacity) && NewCapacity >= Group::Width, "Capacity (", NewCapacity, ") must be a power of two not less than ", size_t{Group::Width});
+        VERIFY_EXPR(GetMaxLoad(NewCapacity) >= m_Size);
+
+        auto* const  pOldSlots    = m_Slots;
+        auto* const  pOldCtrl     = m_Ctrl;
+        const size_t OldCapacity  = m_Capacity;
+        Uint8* const pOldTableMem = reinterpret_cast<Uint8*>(pOldSlots);
+
+        auto* pTableMem = std::allocator_traits<ByteAllocator>::allocate(m_Allocator, GetTableSize(NewCapacity));
+
+        m_Slots    = reinterpret_cast<value_type*>(pTableMem);
+        m_Ctrl     = reinterpret_cast<CtrlType*>(pTableMem + NewCapacity * sizeof(value_type));
+        m_Capacity = NewCapacity;
+        memset(m_Ctrl, FlatHashMapInternal::CtrlEmpty, GetNumCtrlBytes(NewCapacity));
+
+        for (size_t i = 0; i < OldCapacity; ++i)
+        {
+            if (!FlatHashMapInternal::IsFull(pOldCtrl[i]))
+                continue;
+
+            auto&      Elem   = pOldSlots[i];
+            const auto Hash   = ComputeHash(Elem.first);
+            const auto NewIdx = FindInsertIndex(Hash);
+            SetCtrl(NewIdx, GetH2(Hash));
+            MoveConstructElement(&m_Slots[NewIdx], Elem);
+            Elem.~value_type();
+        }
+        m_GrowthLeft = GetMaxLoad(NewCapacity) - m_Size;
+
+        if (pOldTableMem != nullptr)
+            std::allocator_traits<ByteAllocator>::deallocate(m_Allocator, pOldTableMem, GetTableSize(OldCapacity));
+    }
+
+    void DestroyElements()
+    {
+        if (!std::is_trivially_destructible<value_type>::value)
+        {
+            for (size_t i = 0; i < m_Capacity; ++i)
+            {
+                if (FlatHashMapInternal::IsFull(m_Ctrl[i]))
+                    m_Slots[i].~value_type();
+            }
+        }
+    }
+
+    void FreeTable()
+    {
+        if (m_Slots != nullptr)
+        {
+            std::allocator_traits<ByteAllocator>::deallocate(m_Allocator, reinterpret_cast<Uint8*>(m_Slots), GetTableSize(m_Capacity));
+            m_Slots    = nullptr;
+            m_Ctrl     = nullptr;
+            m_Capacity = 0;
+        }
+    }
+
+    ByteAllocator m_Allocator;
+    Hasher        m_Hasher;
+    KeyEqual      m_KeyEqual;
+
+    value_type* m_Slots = nullptr;
+    CtrlType*   m_Ctrl  = nullptr;
+
+    size_t m_Capacity = 0;
+    size_t m_Size     = 0;
+    // The number of elements that can be inserted into empty slots before the table must be rehashed
+    size_t m_GrowthLeft = 0;
+
+    float m_MaxLoadFactor = DefaultMaxLoadFactor;
+};
+
+} // namespace Diligent
@@ -30,7 +30,14 @@
 #include <functional>
 #include <memory>
 #include <cstring>
+#include <string>
+#include <type_traits>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#    include <intrin.h>
+#endif
+
+#include "../../Primitives/interface/BasicTypes.h"
 #include "../../Primitives/interface/Errors.hpp"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
 
@@ -39,11 +46,320 @@
 namespace Diligent
 {
 
-// http://www.boost.org/doc/libs/1_35_0/doc/html/hash/combine.html
+// 64-bit hashing functions are based on wyhash by Wang Yi (final version 4),
+// which is released into the public domain: https://github.com/wangyi-fudan/wyhash
+namespace WyHash
+{
+
+// clang-format off
+static constexpr Uint64 Secret0 = 0x2d358dccaa6c78a5ull;
+static constexpr Uint64 Secret1 = 0x8bb84b93962eacc9ull;
+static constexpr Uint64 Secret2 = 0x4b33a62ed433d4a3ull;
+static constexpr Uint64 Secret3 = 0x4d5a2da51de1aa47ull;
+// clang-format on
+
+// Computes 128-bit product of A and B and returns low and high parts in A and B
+inline void Mum(Uint64& A, Uint64& B)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t R = A;
+    R *= B;
+    A = static_cast<Uint64>(R);
+    B = static_cast<Uint64>(R >> 64u);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    A = _umul128(A, B, &B);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    const Uint64 Lo = A * B;
+    B               = __umulh(A, B);
+    A               = Lo;
+#else
+    const Uint64 HA = A >> 32u, HB = B >> 32u, LA = static_cast<Uint32>(A), LB = static_cast<Uint32>(B);
+    const Uint64 RH = HA * HB, RM0 = HA * LB, RM1 = HB * LA, RL = LA * LB, T = RL + (RM0 << 32u);
+    Uint64       C = T < RL;
+
+    const Uint64 Lo = T + (RM1 << 32u);
+    C += Lo < T;
+    const Uint64 Hi = RH + (RM0 >> 32u) + (RM1 >> 32u) + C;
+
+    A = Lo;
+    B = Hi;
+#endif
+}
+
+inline Uint64 Mix(Uint64 A, Uint64 B)
+{
+    Mum(A, B);
+    return A ^ B;
+}
+
+// Reads unaligned little-endian values
+inline Uint64 Read8(const Uint8* p)
+{
+    Uint64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+inline Uint64 Read4(const Uint8* p)
+{
+    Uint32 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+inline Uint64 Read3(const Uint8* p, size_t k)
+{
+    return (Uint64{p[0]} << 16u) | (Uint64{p[k >> 1u]} << 8u) | p[k - 1];
+}
+
+// Processes 48-byte stripe
+inline void ProcessStripe(const Uint8* p, Uint64& Seed, Uint64& See1, Uint64& See2)
+{
+    Seed = Mix(Read8(p) ^ Secret1, Read8(p + 8) ^ Seed);
+    See1 = Mix(Read8(p + 16) ^ Secret2, Read8(p + 24) ^ See1);
+    See2 = Mix(Read8(p + 32) ^ Secret3, Read8(p + 40) ^ See2);
+}
+
+inline Uint64 Hash(const void* pData, size_t Len, Uint64 Seed)
+{
+    const Uint8* p = static_cast<const Uint8*>(pData);
+
+    Seed ^= Mix(Seed ^ Secret0, Secret1);
+
+    Uint64 a = 0, b = 0;
+    if (Len <= 16)
+    {
+        if (Len >= 4)
+        {
+            a = (Read4(p) << 32u) | Read4(p + ((Len >> 3u) << 2u));
+            b = (Read4(p + Len - 4) << 32u) | Read4(p + Len - 4 - ((Len >> 3u) << 2u));
+        }
+        else if (Len > 0)
+        {
+            a = Read3(p, Len);
+        }
+    }
+    else
+    {
+        size_t i = Len;
+        if (i > 48)
+        {
+            Uint64 See1 = Seed, See2 = Seed;
+            do
+            {
+                ProcessStripe(p, Seed, See1, See2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            Seed ^= See1 ^ See2;
+        }
+        while (i > 16)
+        {
+            Seed = Mix(Read8(p) ^ Secret1, Read8(p + 8) ^ Seed);
+            i -= 16;
+            p += 16;
+        }
+        a = Read8(p + i - 16);
+        b = Read8(p + i - 8);
+    }
+
+    a ^= Secret1;
+    b ^= Seed;
+    Mum(a, b);
+    return Mix(a ^ Secret0 ^ Len, b ^ Secret1);
+}
+
+} // namespace WyHash
+
+
+/// Computes 64-bit hash of the raw bytes of the data.
+inline Uint64 ComputeHashRaw(const void* pData, size_t Size, Uint64 Seed = 0)
+{
+    return WyHash::Hash(pData, Size, Seed);
+}
+
+
+/// 64-bit streaming hasher.
+
+/// The hasher processes the data in 48-byte stripes, so it may be used to hash large
+/// amounts of data that arrive in chunks. The result does not depend on how the data
+/// is split into chunks, but is in general different from ComputeHashRaw().
+///
+/// \code
+///     Hasher64 Hasher;
+///     Hasher.Update(Desc.Width, Desc.Height, Desc.Format);
+///     Hasher.UpdateRaw(pData, DataSize);
+///     auto Hash = Hasher.Digest();
+/// \endcode
+class Hasher64
+{
+public:
+    explicit Hasher64(Uint64 Seed = 0) :
+        // clang-format off
+        m_InitialSeed{Seed},
+        m_Seed       {Seed ^ WyHash::Mix(Seed ^ WyHash::Secret0, WyHash::Secret1)},
+        m_See1       {m_Seed},
+        m_See2       {m_Seed}
+    // clang-format on
+    {}
+
+    /// Hashes raw bytes of the data.
+    void UpdateRaw(const void* pData, size_t Size)
+    {
+        const Uint8* p = static_cast<const Uint8*>(pData);
+        m_TotalSize += Size;
+
+        // Always keep the last bytes in the buffer: they are processed by Digest()
+        if (m_BufferSize + Size <= StripeSize)
+        {
+            memcpy(m_Buffer + m_BufferSize, p, Size);
+            m_BufferSize += Size;
+            return;
+        }
+
+        if (m_BufferSize > 0)
+        {
+            const auto NumBytesToCopy = StripeSize - m_BufferSize;
+            memcpy(m_Buffer + m_BufferSize, p, NumBytesToCopy);
+            p += NumBytesToCopy;
+            Size -= NumBytesToCopy;
+            WyHash::ProcessStripe(m_Buffer, m_Seed, m_See1, m_See2);
+            m_BufferSize = 0;
+        }
+
+        while (Size > StripeSize)
+        {
+            WyHash::ProcessStripe(p, m_Seed, m_See1, m_See2);
+            p += StripeSize;
+            Size -= StripeSize;
+        }
+
+        memcpy(m_Buffer, p, Size);
+        m_BufferSize = Size;
+    }
+
+    /// Hashes raw bytes of a trivially copyable object, e.g. a POD struct.
+
+    /// \note   Padding bytes are hashed as well, so they must be initialized
+    ///         consistently (e.g. zeroed) for equal objects to produce equal hashes.
+    template <typename T>
+    void UpdateRaw(const T& Val)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be hashed as raw bytes");
+        UpdateRaw(&Val, sizeof(Val));
+    }
+
+    /// Hashes the string contents (but not the terminating null character).
+    void Update(const Char* Str)
+    {
+        VERIFY_EXPR(Str != nullptr);
+        const auto Len = strlen(Str);
+        Update(Len);
+        UpdateRaw(Str, Len);
+    }
+
+    void Update(const String& Str)
+    {
+        Update(Str.length());
+        UpdateRaw(Str.data(), Str.length());
+    }
+
+    /// Hashes arithmetic and enum values.
+
+    /// \note   Floating-point values are hashed so that values that compare equal
+    ///         (e.g. +0.0 and -0.0) produce the same hash.
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type Update(T Val)
+    {
+        NormalizeValue(Val);
+        UpdateRaw(&Val, sizeof(Val));
+    }
+
+    template <typename FirstArgType, typename SecondArgType, typename... RestArgsType>
+    void Update(const FirstArgType& FirstArg, const SecondArgType& SecondArg, const RestArgsType&... RestArgs)
+    {
+        Update(FirstArg);
+        Update(SecondArg, RestArgs...);
+    }
+
+    /// Returns the hash of all data processed so far.
+    Uint64 Digest() const
+    {
+        if (m_TotalSize <= StripeSize)
+        {
+            // No stripes have been processed - the hash is the same as ComputeHashRaw()
+            return WyHash::Hash(m_Buffer, m_BufferSize, m_InitialSeed);
+        }
+
+        // The buffer always contains 1 to 48 bytes
+        VERIFY_EXPR(m_BufferSize > 0 && m_BufferSize <= StripeSize);
+        return WyHash::Hash(m_Buffer, m_BufferSize, m_Seed ^ m_See1 ^ m_See2 ^ m_TotalSize);
+    }
+
+private:
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type NormalizeValue(T& Val)
+    {
+        if (Val == 0)
+            Val = 0;
+    }
+    template <typename T>
+    static typename std::enable_if<!std::is_floating_point<T>::value>::type NormalizeValue(T&)
+    {
+    }
+
+    static constexpr size_t StripeSize = 48;
+
+    const Uint64 m_InitialSeed;
+
+    Uint64 m_Seed;
+    Uint64 m_See1;
+    Uint64 m_See2;
+
+    Uint64 m_TotalSize  = 0;
+    size_t m_BufferSize = 0;
+    Uint8  m_Buffer[StripeSize];
+};
+
+
+/// Returns 64-bit hash of the value that is used by HashCombine().
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, Uint64>::type GetValueHash64(const T& Val)
+{
+    return static_cast<Uint64>(Val);
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, Uint64>::type GetValueHash64(const T& Val)
+{
+    // Make sure that +0.0 and -0.0 produce the same hash as they compare equal
+    if (Val == 0)
+        return 0;
+
+    typename std::conditional<sizeof(T) == sizeof(Uint64), Uint64, Uint32>::type Bits;
+    static_assert(sizeof(Bits) == sizeof(T), "Unexpected floating-point type size");
+    memcpy(&Bits, &Val, sizeof(Bits));
+    return Bits;
+}
+
+template <typename T>
+Uint64 GetValueHash64(T* const& Ptr)
+{
+    return static_cast<Uint64>(reinterpret_cast<size_t>(Ptr));
+}
+
+template <typename T>
+typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value, Uint64>::type GetValueHash64(const T& Val)
+{
+    return static_cast<Uint64>(std::hash<T>{}(Val));
+}
+
+
+/// Combines the seed with the hash of the value.
 template <typename T>
 void HashCombine(std::size_t& Seed, const T& Val)
 {
-    Seed ^= std::hash<T>{}(Val) + 0x9e3779b9 + (Seed << 6) + (Seed >> 2);
+    // Unlike std::hash, which is identity for integer types in most implementations,
+    // the 128-bit multiplication mixes all bits of the seed and the value.
+    Seed = static_cast<std::size_t>(WyHash::Mix(Uint64{Seed} ^ WyHash::Secret0, GetValueHash64(Val) ^ WyHash::Secret1));
 }
 
 template <typename FirstArgType, typename... RestArgsType>
@@ -66,11 +382,10 @@ struct CStringHash
 {
     size_t operator()(const CharType* str) const
     {
-        // http://www.cse.yorku.ca/~oz/hash.html
-        std::size_t Seed = 0;
-        while (std::size_t Ch = *(str++))
-            Seed = Seed * 65599 + Ch;
-        return Seed;
+        // The length is computed by the vectorized std::char_traits::length (strlen),
+        // after which the string is hashed eight bytes at a time.
+        const auto Len = std::char_traits<CharType>::length(str);
+        return static_cast<size_t>(ComputeHashRaw(str, Len * sizeof(CharType)));
     }
 };
 
@@ -202,10 +517,34 @@ public:
 
     struct Hasher
     {
+        // Enables lookup by raw const Char* pointers in hash maps that support it (e.g. FlatHashMap)
+        using is_transparent = void;
+
         size_t operator()(const HashMapStringKey& Key) const
         {
             return Key.GetHash();
         }
+
+        size_t operator()(const Char* Str) const
+        {
+            return CStringHash<Char>{}(Str)&HashMask;
+        }
+    };
+
+    struct Equal
+    {
+        using is_transparent = void;
+
+        bool operator()(const HashMapStringKey& Key1, const HashMapStringKey& Key2) const
+        {
+            return Key1 == Key2;
+        }
+
+        bool operator()(const HashMapStringKey& Key, const Char* Str) const
+        {
+            VERIFY_EXPR(Key.Str != nullptr && Str != nullptr);
+            return strcmp(Key.Str, Str) == 0;
+        }
     };
 
 protected:
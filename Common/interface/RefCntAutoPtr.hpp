@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "../../Primitives/interface/Object.h"
 #include "../../Platforms/interface/Atomics.hpp"
 #include "ValidatedCast.hpp"
@@ -39,6 +41,9 @@ namespace Diligent
 template <typename T>
 class RefCntWeakPtr;
 
+template <typename T>
+class RefCntBorrowedPtr;
+
 // The main advantage of RefCntAutoPtr over the std::shared_ptr is that you can
 // attach the same raw pointer to different smart pointers.
 //
@@ -68,6 +73,11 @@ class RefCntWeakPtr;
 // RefCntWeakPtr<ObjectBase> pWeakPtr(pRawPtr);
 //
 
+// Reference counters are always updated atomically, since weak pointers may be locked from any
+// thread. Code that accesses an object while a strong reference is held elsewhere (e.g. by the
+// device context or the resource cache) should use RefCntBorrowedPtr, which never touches the
+// counters. Assigning the object that is already referenced does not touch the counters either.
+
 /// Template class that implements reference counting
 template <typename T>
 class RefCntAutoPtr
@@ -301,6 +311,9 @@ private:
     template <typename OtherType>
     friend class RefCntAutoPtr;
 
+    template <typename OtherType>
+    friend class RefCntBorrowedPtr;
+
     T* m_pObject = nullptr;
 };
 
@@ -364,7 +377,20 @@ public:
 
     RefCntWeakPtr& operator=(T* pObj) noexcept
     {
-        return operator=(RefCntWeakPtr(pObj));
+        auto* const pRefCounters = pObj ? ValidatedCast<RefCountersImpl>(pObj->GetReferenceCounters()) : nullptr;
+        // Both pointers must be compared:
+        // - Objects that share the same reference counters (e.g. an object and its owner) have equal counters.
+        // - A new object may be created at the address of the destroyed object this pointer references.
+        //   The reference counters of the destroyed object can't be reused as we hold a weak reference.
+        if (m_pObject == pObj && m_pRefCounters == pRefCounters)
+            return *this;
+
+        Release();
+        m_pObject      = pObj;
+        m_pRefCounters = pRefCounters;
+        if (m_pRefCounters)
+            m_pRefCounters->AddWeakRef();
+        return *this;
     }
 
     RefCntWeakPtr& operator=(RefCntWeakPtr&& WeakPtr) noexcept
@@ -382,12 +408,7 @@ public:
 
     RefCntWeakPtr& operator=(RefCntAutoPtr<T>& AutoPtr) noexcept
     {
-        Release();
-        m_pObject      = static_cast<T*>(AutoPtr);
-        m_pRefCounters = m_pObject ? ValidatedCast<RefCountersImpl>(m_pObject->GetReferenceCounters()) : nullptr;
-        if (m_pRefCounters)
-            m_pRefCounters->AddWeakRef();
-        return *this;
+        return operator=(static_cast<T*>(AutoPtr));
     }
 
     void Release() noexcept
@@ -412,21 +433,17 @@ public:
         RefCntAutoPtr<T> spObj;
         if (m_pRefCounters)
         {
-            // Try to obtain pointer to the owner object.
-            // spOwner is only used to keep the object
-            // alive while obtaining strong reference from
-            // the raw pointer m_pObject
-            RefCntAutoPtr<IObject> spOwner;
-            m_pRefCounters->GetObject(&spOwner);
-            if (spOwner)
+            // The object and its owner (if any) share the same reference counters, so
+            // if the counters are successfully incremented, the new strong reference
+            // can be directly transferred to the RAW pointer m_pObject.
+            // This does not acquire any locks and does not call QueryInterface().
+            if (m_pRefCounters->TryAddStrongRef())
             {
-                // If owner is alive, we can use our RAW pointer to
-                // create strong reference
-                spObj = m_pObject;
+                spObj.Attach(m_pObject);
             }
             else
             {
-                // Owner object has been destroyed. There is no reason
+                // The object has been destroyed. There is no reason
                 // to keep this weak reference anymore
                 Release();
             }
@@ -446,4 +463,55 @@ protected:
     T* m_pObject;
 };
 
+/// Non-owning pointer to a reference-counted object.
+
+/// Borrowed pointer neither adds strong nor weak references, so copying and destroying it
+/// never touches the atomic reference counters. The object must be kept alive by a strong
+/// reference held elsewhere (e.g. by the caller or by the resource cache) for as long as
+/// the borrowed pointer is used. Use RefCntAutoPtr to take ownership.
+template <typename T>
+class RefCntBorrowedPtr
+{
+public:
+    RefCntBorrowedPtr() noexcept {}
+
+    RefCntBorrowedPtr(std::nullptr_t) noexcept {}
+
+    explicit RefCntBorrowedPtr(T* pObj) noexcept :
+        m_pObject{pObj}
+    {}
+
+    template <typename DerivedType, typename = typename std::enable_if<std::is_base_of<T, DerivedType>::value>::type>
+    RefCntBorrowedPtr(const RefCntAutoPtr<DerivedType>& AutoPtr) noexcept :
+        m_pObject{AutoPtr.m_pObject}
+    {}
+
+    template <typename DerivedType, typename = typename std::enable_if<std::is_base_of<T, DerivedType>::value>::type>
+    RefCntBorrowedPtr(const RefCntBorrowedPtr<DerivedType>& BorrowedPtr) noexcept :
+        m_pObject{BorrowedPtr.RawPtr()}
+    {}
+
+    // Borrowing from a temporary strong pointer would leave the borrowed pointer dangling
+    template <typename DerivedType>
+    RefCntBorrowedPtr(RefCntAutoPtr<DerivedType>&&) = delete;
+
+    bool     operator!() const noexcept { return m_pObject == nullptr; }
+    explicit operator bool() const noexcept { return m_pObject != nullptr; }
+    bool     operator==(const RefCntBorrowedPtr& Ptr) const noexcept { return m_pObject == Ptr.m_pObject; }
+    bool     operator!=(const RefCntBorrowedPtr& Ptr) const noexcept { return m_pObject != Ptr.m_pObject; }
+
+    T* RawPtr() const noexcept { return m_pObject; }
+
+    template <typename DstType>
+    DstType* RawPtr() const noexcept { return ValidatedCast<DstType>(m_pObject); }
+
+    operator T*() const noexcept { return m_pObject; }
+
+    T& operator*() const noexcept { return *m_pObject; }
+    T* operator->() const noexcept { return m_pObject; }
+
+private:
+    T* m_pObject = nullptr;
+};
+
 } // namespace Diligent
@@ -30,6 +30,8 @@
 /// \file
 /// Implementation of the template base class for reference counting objects
 
+#include <atomic>
+
 #include "../../Primitives/interface/Object.h"
 #include "../../Primitives/interface/MemoryAllocator.h"
 #include "../../Platforms/interface/Atomics.hpp"
@@ -41,23 +43,55 @@ namespace Diligent
 {
 
 // This class controls the lifetime of a refcounted object
+//
+// None of the methods acquire a lock:
+// - The strong reference counter never goes up once it reaches zero: AddStrongRef() may only be
+//   called by the holder of a strong reference, and TryAddStrongRef() increments the counter in a
+//   CAS loop only if it is not zero. So the thread that decrements the counter to zero is the only
+//   one that may destroy the object, and no other thread can obtain a new reference to it.
+// - While the object is alive, all strong references collectively hold one extra weak reference.
+//   It is released after the object has been destroyed, and the thread that decrements the weak
+//   reference counter to zero destroys the reference counters object.
 class RefCountersImpl final : public IReferenceCounters
 {
 public:
     inline virtual ReferenceCounterValueType AddStrongRef() override final
     {
-        VERIFY(m_ObjectState == ObjectState::Alive, "Attempting to increment strong reference counter for a destroyed or not initialized object!");
+        VERIFY(m_ObjectState.load(std::memory_order_relaxed) == ObjectState::Alive, "Attempting to increment strong reference counter for a destroyed or not initialized object!");
         VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
         return Atomics::AtomicIncrement(m_lNumStrongReferences);
     }
 
+    /// Atomically increments the strong reference counter if it is not zero, i.e. if the
+    /// object is alive. Returns true if the reference has been added.
+    inline bool TryAddStrongRef()
+    {
+        if (m_ObjectState.load(std::memory_order_acquire) != ObjectState::Alive)
+            return false; // Early exit
+
+        Atomics::Long NumStrongRefs = m_lNumStrongReferences;
+        while (NumStrongRefs > 0)
+        {
+            const auto OrigNumStrongRefs = Atomics::AtomicCompareExchange(m_lNumStrongReferences, NumStrongRefs + 1, NumStrongRefs);
+            if (OrigNumStrongRefs == NumStrongRefs)
+            {
+                VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
+                return true;
+            }
+            // Other thread has modified the counter - try again with the new value
+            NumStrongRefs = OrigNumStrongRefs;
+        }
+
+        // The counter is zero: the object is being destroyed or has been destroyed
+        return false;
+    }
+
     template <class TPreObjectDestroy>
     inline ReferenceCounterValueType ReleaseStrongRef(TPreObjectDestroy PreObjectDestroy)
     {
-        VERIFY(m_ObjectState == ObjectState::Alive, "Attempting to decrement strong reference counter for an object that is not alive");
+        VERIFY(m_ObjectState.load(std::memory_order_relaxed) == ObjectState::Alive, "Attempting to decrement strong reference counter for an object that is not alive");
         VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
 
-        // Decrement strong reference counter without acquiring the lock.
         auto RefCount = Atomics::AtomicDecrement(m_lNumStrongReferences);
         VERIFY(RefCount >= 0, "Inconsistent call to ReleaseStrongRef()");
         if (RefCount == 0)
@@ -76,130 +110,35 @@ public:
 
     inline virtual ReferenceCounterValueType AddWeakRef() override final
     {
-        return Atomics::AtomicIncrement(m_lNumWeakReferences);
+        auto NumWeakReferences = Atomics::AtomicIncrement(m_lNumWeakReferences);
+        // Since we now hold a weak reference, the reference counters object can't be destroyed
+        return NumWeakReferences - GetNumCollectiveWeakRefs();
     }
 
     inline virtual ReferenceCounterValueType ReleaseWeakRef() override final
     {
-        // The method must be serialized!
-        ThreadingTools::LockHelper Lock(m_LockFlag);
-        // It is essentially important to check the number of weak references
-        // while holding the lock. Otherwise reference counters object
-        // may be destroyed twice if ReleaseStrongRef() is executed by other
-        // thread.
-        auto NumWeakReferences = Atomics::AtomicDecrement(m_lNumWeakReferences);
-        VERIFY(NumWeakReferences >= 0, "Inconsistent call to ReleaseWeakRef()");
-
-        // There are two special case when we must not destroy the ref counters object even
-        // when NumWeakReferences == 0 && m_lNumStrongReferences == 0 :
-        //
-        //             This thread             |    Another thread - ReleaseStrongRef()
-        //                                     |
-        // 1. Lock the object                  |
-        //                                     |
-        // 2. Decrement m_lNumWeakReferences,  |   1. Decrement m_lNumStrongReferences,
-        //    m_lNumWeakReferences==0          |      RefCount == 0
-        //                                     |
-        //                                     |   2. Start waiting for the lock to destroy
-        //                                     |      the object, m_ObjectState != ObjectState::Destroyed
-        // 3. Do not destroy reference         |
-        //    counters, unlock                 |
-        //                                     |   3. Acquire the lock,
-        //                                     |      destroy the object,
-        //                                     |      read m_lNumWeakReferences==0
-        //                                     |      destroy the reference counters
-        //
+        // The object state must be read before the counter is decremented, as
+        // this may be destroyed by another thread right after that.
+        const auto NumCollectiveWeakRefs = GetNumCollectiveWeakRefs();
 
-        // If an exception is thrown during the object construction and there is a weak pointer to the object itself,
-        // we may get to this point, but should not destroy the reference counters, because it will be destroyed by MakeNewRCObj
-        // Consider this example:
-        //
-        //   A ==sp==> B ---wp---> A
-        //
-        //   MakeNewRCObj::operator()
-        //    try
-        //    {
-        //     A.ctor()
-        //       B.ctor()
-        //        wp.ctor m_lNumWeakReferences==1
-        //        throw
-        //        wp.dtor m_lNumWeakReferences==0, destroy this
-        //    }
-        //    catch(...)
-        //    {
-        //       Destroy ref counters second time
-        //    }
-        //
-        if (NumWeakReferences == 0 && /*m_lNumStrongReferences == 0 &&*/ m_ObjectState == ObjectState::Destroyed)
-        {
-            VERIFY_EXPR(m_lNumStrongReferences == 0);
-            VERIFY(m_ObjectWrapperBuffer[0] == 0 && m_ObjectWrapperBuffer[1] == 0, "Object wrapper must be null");
-            // m_ObjectState is set to ObjectState::Destroyed under the lock. If the state is not Destroyed,
-            // ReleaseStrongRef() will take care of it.
-            // Access to Object wrapper and decrementing m_lNumWeakReferences is atomic. Since we acquired the lock,
-            // no other thread can access either of them.
-            // Access to m_lNumStrongReferences is NOT PROTECTED by lock.
-
-            // There are no more references to the ref counters object and the object itself
-            // is already destroyed.
-            // We can safely unlock it and destroy.
-            // If we do not unlock it, this->m_LockFlag will expire,
-            // which will cause Lock.~LockHelper() to crash.
-            Lock.Unlock();
-            SelfDestroy();
-        }
-        return NumWeakReferences;
+        auto NumWeakReferences = ReleaseWeakRefInternal();
+        return NumWeakReferences > NumCollectiveWeakRefs ? NumWeakReferences - NumCollectiveWeakRefs : 0;
     }
 
     inline virtual void GetObject(struct IObject** ppObject) override final
     {
-        if (m_ObjectState != ObjectState::Alive)
-            return; // Early exit
-
-        // It is essential to INCREMENT REF COUNTER while HOLDING THE LOCK to make sure that
-        // StrongRefCnt > 1 guarantees that the object is alive.
-
-        // If other thread started deleting the object in ReleaseStrongRef(), then m_lNumStrongReferences==0
-        // We must make sure only one thread is allowed to increment the counter to guarantee that if StrongRefCnt > 1,
-        // there is at least one real strong reference left. Otherwise the following scenario may occur:
-        //
-        //                                      m_lNumStrongReferences == 1
-        //
-        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()        |     Thread 3 - GetObject()
-        //                                     |                                   |
-        //  - Decrement m_lNumStrongReferences | -Increment m_lNumStrongReferences | -Increment m_lNumStrongReferences
-        //  - Read RefCount == 0               | -Read StrongRefCnt==1             | -Read StrongRefCnt==2
-        //    Destroy the object               |                                   | -Return reference to the soon
-        //                                     |                                   |  to expire object
-        //
-        ThreadingTools::LockHelper Lock(m_LockFlag);
-
-        auto StrongRefCnt = Atomics::AtomicIncrement(m_lNumStrongReferences);
-
-        // Checking if m_ObjectState == ObjectState::Alive only is not reliable:
-        //
-        //           This thread                    |          Another thread
-        //                                          |
-        //   1. Acquire the lock                    |
-        //                                          |    1. Decrement m_lNumStrongReferences
-        //   2. Increment m_lNumStrongReferences    |    2. Test RefCount==0
-        //   3. Read StrongRefCnt == 1              |    3. Start destroying the object
-        //      m_ObjectState == ObjectState::Alive |
-        //   4. DO NOT return the reference to      |    4. Wait for the lock, m_ObjectState == ObjectState::Alive
-        //      the object                          |
-        //   5. Decrement m_lNumStrongReferences    |
-        //                                          |    5. Destroy the object
-
-        if (m_ObjectState == ObjectState::Alive && StrongRefCnt > 1)
-        {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // QueryInterface() must not lock the object, or a deadlock happens.
-            // The only other two methods that lock the object are ReleaseStrongRef()
-            // and ReleaseWeakRef(), which are never called by QueryInterface()
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
-            pWrapper->QueryInterface(IID_Unknown, ppObject);
-        }
-        Atomics::AtomicDecrement(m_lNumStrongReferences);
+        // Increment the strong reference counter only if it is not zero. If it is zero,
+        // another thread has started destroying the object. Otherwise the object is guaranteed
+        // to stay alive until the reference is released.
+        if (!TryAddStrongRef())
+            return;
+
+        // QueryInterface() must not destroy the object or release the reference counters.
+        auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
+        pWrapper->QueryInterface(IID_Unknown, ppObject);
+
+        // If QueryInterface() has added a reference, this will not destroy the object.
+        ReleaseStrongRef();
     }
 
     inline virtual ReferenceCounterValueType GetNumStrongRefs() const override final
@@ -207,9 +146,10 @@ public:
         return m_lNumStrongReferences;
     }
 
+    /// \note The value may be inaccurate while the object is being destroyed by another thread.
     inline virtual ReferenceCounterValueType GetNumWeakRefs() const override final
     {
-        return m_lNumWeakReferences;
+        return m_lNumWeakReferences - GetNumCollectiveWeakRefs();
     }
 
 private:
@@ -263,186 +203,75 @@ private:
     template <typename ObjectType, typename AllocatorType>
     void Attach(ObjectType* pObject, AllocatorType* pAllocator)
     {
-        VERIFY(m_ObjectState == ObjectState::NotInitialized, "Object has already been attached");
+        VERIFY(m_ObjectState.load(std::memory_order_relaxed) == ObjectState::NotInitialized, "Object has already been attached");
         static_assert(sizeof(ObjectWrapper<ObjectType, AllocatorType>) == sizeof(m_ObjectWrapperBuffer), "Unexpected object wrapper size");
         new (m_ObjectWrapperBuffer) ObjectWrapper<ObjectType, AllocatorType>(pObject, pAllocator);
-        m_ObjectState = ObjectState::Alive;
+        // Publish the object wrapper to the threads that observe the Alive state
+        m_ObjectState.store(ObjectState::Alive, std::memory_order_release);
+    }
+
+    // Returns the number of weak references that are collectively held by the strong references
+    Atomics::Long GetNumCollectiveWeakRefs() const
+    {
+        return m_ObjectState.load(std::memory_order_acquire) != ObjectState::Destroyed ? 1 : 0;
+    }
+
+    // Decrements the weak reference counter and destroys the reference counters
+    // object if the counter has reached zero. Returns the new counter value.
+    Atomics::Long ReleaseWeakRefInternal()
+    {
+        auto NumWeakReferences = Atomics::AtomicDecrement(m_lNumWeakReferences);
+        VERIFY(NumWeakReferences >= 0, "Inconsistent call to ReleaseWeakRef()");
+        if (NumWeakReferences == 0)
+        {
+            // The collective weak reference has been released, so the object has been destroyed
+            // (or has never been attached, see MakeNewRCObj), and there are no references left.
+            // No other thread can access the reference counters.
+            VERIFY_EXPR(m_lNumStrongReferences == 0);
+            VERIFY(m_ObjectWrapperBuffer[0] == 0 && m_ObjectWrapperBuffer[1] == 0, "Object wrapper must be null");
+            SelfDestroy();
+        }
+        return NumWeakReferences;
     }
 
     void TryDestroyObject()
     {
-        // Since RefCount==0, there are no more strong references and the only place
-        // where strong ref counter can be incremented is from GetObject().
-
-        // If several threads were allowed to get to this point, there would
-        // be serious risk that <this> had already been destroyed and m_LockFlag expired.
-        // Consider the following scenario:
-        //                                      |
-        //             This thread              |             Another thread
-        //                                      |
-        //                      m_lNumStrongReferences == 1
-        //                      m_lNumWeakReferences == 1
-        //                                      |
-        // 1. Decrement m_lNumStrongReferences  |
-        //    Read RefCount==0, no lock acquired|
-        //                                      |   1. Run GetObject()
-        //                                      |      - acquire the lock
-        //                                      |      - increment m_lNumStrongReferences
-        //                                      |      - release the lock
-        //                                      |
-        //                                      |   2. Run ReleaseWeakRef()
-        //                                      |      - decrement m_lNumWeakReferences
-        //                                      |
-        //                                      |   3. Run ReleaseStrongRef()
-        //                                      |      - decrement m_lNumStrongReferences
-        //                                      |      - read RefCount==0
-        //
-        //         Both threads will get to this point. The first one will destroy <this>
-        //         The second one will read expired m_LockFlag
+        // Since the strong reference counter is zero, no other thread can obtain a new strong reference
+        // to the object (TryAddStrongRef() never increments zero counter), so only one thread can get here.
+        VERIFY_EXPR(m_lNumStrongReferences == 0);
 
-        //  IT IS CRUCIALLY IMPORTANT TO ASSURE THAT ONLY ONE THREAD WILL EVER
-        //  EXECUTE THIS CODE
+        // The object may temporarily add and release a reference to itself while being destroyed, which
+        // will bring us here again. Make sure the object is not destroyed twice.
+        if (m_ObjectState.load(std::memory_order_acquire) != ObjectState::Alive)
+            return;
 
-        // The sloution is to atomically increment strong ref counter in GetObject().
-        // There are two possible scenarios depending on who first increments the counter:
+        VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
 
+        size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
+        memcpy(ObjectWrapperBufferCopy, m_ObjectWrapperBuffer, sizeof(m_ObjectWrapperBuffer));
+        memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
 
-        //                                                     Scenario I
-        //
-        //             This thread              |      Another thread - GetObject()         |   One more thread - GetObject()
-        //                                      |                                           |
-        //                       m_lNumStrongReferences == 1                                |
-        //                                      |                                           |
-        //                                      |   1. Acquire the lock                     |
-        // 1. Decrement m_lNumStrongReferences  |                                           |   1. Wait for the lock
-        // 2. Read RefCount==0                  |   2. Increment m_lNumStrongReferences     |
-        // 3. Start destroying the object       |   3. Read StrongRefCnt == 1               |
-        // 4. Wait for the lock                 |   4. DO NOT return the reference          |
-        //                                      |      to the object                        |
-        //                                      |   5. Decrement m_lNumStrongReferences     |
-        // _  _  _  _  _  _  _  _  _  _  _  _  _|   6. Release the lock _  _  _  _  _  _  _ |_  _  _  _  _  _  _  _  _  _  _  _  _  _
-        //                                      |                                           |   2. Acquire the lock
-        //                                      |                                           |   3. Increment m_lNumStrongReferences
-        //                                      |                                           |   4. Read StrongRefCnt == 1
-        //                                      |                                           |   5. DO NOT return the reference
-        //                                      |                                           |      to the object
-        //                                      |                                           |   6. Decrement m_lNumStrongReferences
-        //  _  _  _  _  _  _  _  _  _  _  _  _  | _  _  _  _  _  _  _  _  _  _  _  _  _  _  | _ 7. Release the lock _  _  _  _  _  _
-        // 5. Acquire the lock                  |                                           |
-        //   - m_lNumStrongReferences==0        |                                           |
-        // 6. DESTROY the object                |                                           |
-        //                                      |                                           |
-
-        //  GetObject() MUST BE SERIALIZED for this to work properly!
-
-
-        //                                   Scenario II
-        //
-        //             This thread              |      Another thread - GetObject()
-        //                                      |
-        //                       m_lNumStrongReferences == 1
-        //                                      |
-        //                                      |   1. Acquire the lock
-        //                                      |   2. Increment m_lNumStrongReferences
-        // 1. Decrement m_lNumStrongReferences  |
-        // 2. Read RefCount>0                   |
-        // 3. DO NOT destroy the object         |   3. Read StrongRefCnt > 1 (while m_lNumStrongReferences == 1)
-        //                                      |   4. Return the reference to the object
-        //                                      |       - Increment m_lNumStrongReferences
-        //                                      |   5. Decrement m_lNumStrongReferences
-
-#ifdef DILIGENT_DEBUG
-        {
-            Atomics::Long NumStrongRefs = m_lNumStrongReferences;
-            VERIFY(NumStrongRefs == 0 || NumStrongRefs == 1, "Num strong references (", NumStrongRefs, ") is expected to be 0 or 1");
-        }
-#endif
+        auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
 
-        // Acquire the lock.
-        ThreadingTools::LockHelper Lock(m_LockFlag);
+        // Note that this is the only place where m_ObjectState is
+        // modified after the ref counters object has been created
+        m_ObjectState.store(ObjectState::Destroyed, std::memory_order_release);
 
-        // GetObject() first acquires the lock, and only then increments and
-        // decrements the ref counter. If it reads 1 after incremeting the counter,
-        // it does not return the reference to the object and decrements the counter.
-        // If we acquired the lock, GetObject() will not start until we are done
-        VERIFY_EXPR(m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive);
+        // Destroy referenced object. The reference counters stay alive while the object
+        // is being destroyed as strong references still hold the collective weak reference:
+        //
+        //    A ==sp==> B ---wp---> A
+        //
+        //    delete A{
+        //      A.~dtor(){
+        //          B.~dtor(){
+        //              wpA.ReleaseWeakRef() // NumWeakRefs > 0, RefCounters_A are not destroyed
+        //
+        pWrapper->DestroyObject();
 
-        // Extra caution
-        if (m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive)
-        {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // We cannot destroy the object while reference counters are locked as this will
-            // cause a deadlock in cases like this:
-            //
-            //    A ==sp==> B ---wp---> A
-            //
-            //    RefCounters_A.Lock();
-            //    delete A{
-            //      A.~dtor(){
-            //          B.~dtor(){
-            //              wpA.ReleaseWeakRef(){
-            //                  RefCounters_A.Lock(); // Deadlock
-            //
-
-            // So we copy the object wrapper and destroy the object after unlocking the
-            // reference counters
-            size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
-            memcpy(ObjectWrapperBufferCopy, m_ObjectWrapperBuffer, sizeof(m_ObjectWrapperBuffer));
-            memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
-
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
-
-            // In a multithreaded environment, reference counters object may
-            // be destroyed at any time while m_pObject->~dtor() is running.
-            // NOTE: m_pObject may not be the only object referencing m_pRefCounters.
-            //       All objects that are owned by m_pObject will point to the same
-            //       reference counters object.
-
-            // Note that this is the only place where m_ObjectState is
-            // modified after the ref counters object has been created
-            m_ObjectState = ObjectState::Destroyed;
-            // The object is now detached from the reference counters and it is if
-            // it was destroyed since no one can obtain access to it.
-
-
-            // It is essentially important to check the number of weak references
-            // while the object is locked. Otherwise reference counters object
-            // may be destroyed twice if ReleaseWeakRef() is executed by other thread:
-            //
-            //             This thread             |    Another thread - ReleaseWeakRef()
-            //                                     |
-            // 1. Decrement m_lNumStrongReferences,|
-            //    m_lNumStrongReferences==0,       |
-            //    acquire the lock, destroy        |
-            //    the obj, release the lock        |
-            //    m_lNumWeakReferences == 1        |
-            //                                     |   1. Aacquire the lock,
-            //                                     |      decrement m_lNumWeakReferences,
-            //                                     |      m_lNumWeakReferences == 0,
-            //                                     |      m_ObjectState == ObjectState::Destroyed
-            //                                     |
-            // 2. Read m_lNumWeakReferences == 0   |
-            // 3. Destroy the ref counters obj     |   2. Destroy the ref counters obj
-            //
-            bool bDestroyThis = m_lNumWeakReferences == 0;
-            // ReleaseWeakRef() decrements m_lNumWeakReferences, and checks it for
-            // zero only after acquiring the lock. So if m_lNumWeakReferences==0, no
-            // weak reference-related code may be running
-
-
-            // We must explicitly unlock the object now to avoid deadlocks. Also,
-            // if this is deleted, this->m_LockFlag will expire, which will cause
-            // Lock.~LockHelper() to crash
-            Lock.Unlock();
-
-            // Destroy referenced object
-            pWrapper->DestroyObject();
-
-            // Note that <this> may be destroyed here already,
-            // see comments in ~ControlledObjectType()
-            if (bDestroyThis)
-                SelfDestroy();
-        }
+        // Release the collective weak reference. If there are no other weak references,
+        // the reference counters object is destroyed.
+        ReleaseWeakRefInternal();
     }
 
     void SelfDestroy()
@@ -476,9 +305,9 @@ private:
     size_t m_ObjectWrapperBuffer[ObjectWrapperBufferSize]{};
 
     Atomics::AtomicLong m_lNumStrongReferences{0};
-    Atomics::AtomicLong m_lNumWeakReferences{0};
-
-    ThreadingTools::LockFlag m_LockFlag;
+    // The counter includes the collective weak reference held by the strong references
+    // until the object is destroyed.
+    Atomics::AtomicLong m_lNumWeakReferences{1};
 
     enum class ObjectState : Int32
     {
@@ -486,7 +315,9 @@ private:
         Alive,
         Destroyed
     };
-    volatile ObjectState m_ObjectState = ObjectState::NotInitialized;
+    // The state is read without synchronization by TryAddStrongRef() and GetNumCollectiveWeakRefs()
+    // while it may be modified by another thread in TryDestroyObject().
+    std::atomic<ObjectState> m_ObjectState{ObjectState::NotInitialized};
 };
 
 
@@ -510,22 +341,9 @@ public:
     // through the pointer to the base class
     virtual ~RefCountedObject()
     {
-        // WARNING! m_pRefCounters may be expired in scenarios like this:
-        //
-        //    A ==sp==> B ---wp---> A
-        //
-        //    RefCounters_A.ReleaseStrongRef(){ // NumStrongRef == 0, NumWeakRef == 1
-        //      bDestroyThis = (m_lNumWeakReferences == 0) == false;
-        //      delete A{
-        //        A.~dtor(){
-        //            B.~dtor(){
-        //                wpA.ReleaseWeakRef(){ // NumStrongRef == 0, NumWeakRef == 0, m_pObject==nullptr
-        //                    delete RefCounters_A;
-        //        ...
-        //        VERIFY( m_pRefCounters->GetNumStrongRefs() == 0 // Access violation!
-
-        // This also may happen if one thread is executing ReleaseStrongRef(), while
-        // another one is simultaneously running ReleaseWeakRef().
+        // Reference counters are kept alive while the object is being destroyed (see
+        // RefCountersImpl::TryDestroyObject), but m_pRefCounters is null for objects
+        // allocated on the stack.
 
         //VERIFY( m_pRefCounters->GetNumStrongRefs() == 0,
         //        "There remain strong references to the object being destroyed" );
@@ -673,8 +491,11 @@ public:
         }
         catch (...)
         {
+            // The object has not been attached, so release the collective weak reference. The reference
+            // counters will be destroyed now or, if the object has created weak references to itself
+            // that are still alive, when the last of them is released.
             if (pNewRefCounters != nullptr)
-                pNewRefCounters->SelfDestroy();
+                pNewRefCounters->ReleaseWeakRefInternal();
             throw;
         }
         return pObj;
@@ -0,0 +1,247 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::ScratchMemoryAllocator class
+
+#include <cstddef>
+#include <vector>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Primitives/interface/MemoryAllocator.h"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+/// Linear allocator for short-lived temporary data, e.g. data that lives for the duration of a frame.
+
+/// The allocator implements IMemoryAllocator and can be used with STDAllocator. Allocations form a stack:
+/// Free() reclaims the memory of the most recent allocation together with all allocations below it that
+/// have already been released. Nested temporaries (e.g. several scratch vectors in one scope, or a growing
+/// vector that frees its old storage after allocating the new one) are thus reclaimed as soon as the
+/// outermost of them is released. Memory of an allocation that is released while a more recent one is
+/// still alive is reclaimed when that allocation is released, or by Reset(). If the memory used between
+/// two resets does not fit into a single page, the pages are merged into one large page, so that the
+/// allocator quickly converges to a single page.
+///
+/// The allocator is not thread-safe.
+class ScratchMemoryAllocator final : public IMemoryAllocator
+{
+public:
+    // clang-format off
+    ScratchMemoryAllocator           (const ScratchMemoryAllocator&) = delete;
+    ScratchMemoryAllocator           (ScratchMemoryAllocator&&)      = delete;
+    ScratchMemoryAllocator& operator=(const ScratchMemoryAllocator&) = delete;
+    ScratchMemoryAllocator& operator=(ScratchMemoryAllocator&&)      = delete;
+    // clang-format on
+
+    explicit ScratchMemoryAllocator(IMemoryAllocator& RawAllocator, size_t PageSize = 16 << 10) noexcept :
+        m_RawAllocator{RawAllocator},
+        m_PageSize{PageSize}
+    {
+    }
+
+    ~ScratchMemoryAllocator()
+    {
+        VERIFY(m_FrameStats.NumAllocations == m_FrameStats.NumFrees, "Not all scratch allocations have been released");
+        ReleasePages();
+    }
+
+    struct Statistics
+    {
+        /// The number of allocations, i.e. the number of raw memory allocations that were avoided
+        Uint32 NumAllocations = 0;
+
+        /// The number of Free() calls
+        Uint32 NumFrees = 0;
+
+        /// The total size of all allocations, in bytes
+        size_t AllocatedSize = 0;
+    };
+
+    /// Allocates memory aligned by the fundamental alignment.
+    virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final
+    {
+        if (Size == 0)
+            return nullptr;
+
+        Size = AlignUp(Size, size_t{Alignment});
+
+        if (m_pCurrPtr == nullptr || m_pCurrPtr + Size > m_Pages[m_CurrPage].pEnd)
+        {
+            // Move to the next page that has enough space
+            if (m_pCurrPtr != nullptr)
+                ++m_CurrPage;
+            while (m_CurrPage < m_Pages.size() && m_Pages[m_CurrPage].pData + Size > m_Pages[m_CurrPage].pEnd)
+                ++m_CurrPage;
+
+            if (m_CurrPage == m_Pages.size())
+                AddPage(Size);
+
+            m_pCurrPtr = m_Pages[m_CurrPage].pData;
+        }
+
+        auto* Ptr = m_pCurrPtr;
+        m_pCurrPtr += Size;
+        m_Allocations.push_back({Ptr, m_CurrPage, false});
+
+        ++m_FrameStats.NumAllocations;
+        m_FrameStats.AllocatedSize += Size;
+
+        return Ptr;
+    }
+
+    /// Marks the allocation as released and reclaims the memory of all released allocations
+    /// at the top of the allocation stack.
+    virtual void Free(void* Ptr) override final
+    {
+        if (Ptr == nullptr)
+            return;
+
+        VERIFY(m_FrameStats.NumFrees < m_FrameStats.NumAllocations, "Inconsistent call to Free()");
+        ++m_FrameStats.NumFrees;
+
+        // Temporaries are typically released in reverse order, so search from the top of the stack
+        auto it = m_Allocations.rbegin();
+        while (it != m_Allocations.rend() && it->Ptr != Ptr)
+            ++it;
+        if (it == m_Allocations.rend())
+        {
+            UNEXPECTED("Pointer ", Ptr, " was not allocated by this allocator or has already been reclaimed");
+            return;
+        }
+        VERIFY(!it->IsReleased, "Pointer ", Ptr, " has already been released");
+        it->IsReleased = true;
+
+        while (!m_Allocations.empty() && m_Allocations.back().IsReleased)
+        {
+            const auto& Top = m_Allocations.back();
+            m_CurrPage      = Top.Page;
+            m_pCurrPtr      = Top.Ptr;
+            m_Allocations.pop_back();
+        }
+    }
+
+    /// Makes all memory available for new allocations.
+    /// All allocations must be released before the allocator is reset.
+    void Reset()
+    {
+        DEV_CHECK_ERR(m_FrameStats.NumAllocations == m_FrameStats.NumFrees, "Not all scratch allocations have been released. ",
+                      m_FrameStats.NumAllocations - m_FrameStats.NumFrees, " allocation(s) will be invalidated.");
+
+        if (m_CurrPage > 0)
+        {
+            // Memory used in the frame did not fit into a single page - merge all pages into one
+            size_t TotalSize = 0;
+            for (const auto& Page : m_Pages)
+                TotalSize += static_cast<size_t>(Page.pEnd - Page.pData);
+            ReleasePages();
+            AddPage(TotalSize);
+        }
+
+        m_CurrPage = 0;
+        m_pCurrPtr = !m_Pages.empty() ? m_Pages[0].pData : nullptr;
+        m_Allocations.clear();
+
+        m_LastFrameStats = m_FrameStats;
+        m_FrameStats     = {};
+    }
+
+    /// Returns the statistics since the last reset.
+    const Statistics& GetFrameStats() const
+    {
+        return m_FrameStats;
+    }
+
+    /// Returns the statistics between the last two resets.
+    const Statistics& GetLastFrameStats() const
+    {
+        return m_LastFrameStats;
+    }
+
+    /// Returns the total size of all pages.
+    size_t GetReservedSize() const
+    {
+        size_t Size = 0;
+        for (const auto& Page : m_Pages)
+            Size += static_cast<size_t>(Page.pEnd - Page.pData);
+        return Size;
+    }
+
+private:
+    void AddPage(size_t MinSize)
+    {
+        size_t PageSize = m_PageSize;
+        while (PageSize < MinSize)
+            PageSize *= 2;
+
+        auto* pData = static_cast<Uint8*>(m_RawAllocator.Allocate(PageSize, "Scratch memory page", __FILE__, __LINE__));
+        VERIFY(AlignUp(pData, size_t{Alignment}) == pData, "Raw memory is not properly aligned");
+        m_Pages.push_back({pData, pData + PageSize});
+    }
+
+    void ReleasePages()
+    {
+        for (auto& Page : m_Pages)
+            m_RawAllocator.Free(Page.pData);
+        m_Pages.clear();
+    }
+
+    static constexpr size_t Alignment = alignof(std::max_align_t);
+
+    struct Page
+    {
+        Uint8* pData;
+        Uint8* pEnd;
+    };
+
+    IMemoryAllocator& m_RawAllocator;
+    const size_t      m_PageSize;
+
+    std::vector<Page> m_Pages;
+
+    struct AllocationInfo
+    {
+        Uint8* Ptr;
+        size_t Page;
+        bool   IsReleased;
+    };
+    // Allocations that have not been reclaimed yet, in allocation order
+    std::vector<AllocationInfo> m_Allocations;
+
+    size_t m_CurrPage = 0;
+    Uint8* m_pCurrPtr = nullptr;
+
+    Statistics m_FrameStats;
+    Statistics m_LastFrameStats;
+};
+
+} // namespace Diligent
@@ -0,0 +1,209 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::ThreadPool class
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+#include "../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Simple fixed-size thread pool that executes tasks in FIFO order.
+
+/// Tasks are started in the order they are enqueued. A task may wait for
+/// completion of another task that was enqueued before it: by the time the worker
+/// starts the waiting task, the dependency has already been picked up by some
+/// other worker, so the pool can never deadlock in this scenario.
+///
+/// A task must not wait for tasks that are enqueued into the same pool after it
+/// (including WaitForAllTasks()): they are queued behind the waiting task and may
+/// never start. ParallelFor() that is called from a worker thread of the pool
+/// processes all items on the calling thread for this reason.
+class ThreadPool
+{
+public:
+    using TaskType = std::function<void()>;
+
+    /// \param [in] NumThreads - The number of worker threads. If zero, the number
+    ///                          of hardware threads minus one (but at least one) is used.
+    explicit ThreadPool(Uint32 NumThreads = 0);
+
+    // clang-format off
+    ThreadPool           (const ThreadPool&)  = delete;
+    ThreadPool           (      ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&)  = delete;
+    ThreadPool& operator=(      ThreadPool&&) = delete;
+    // clang-format on
+
+    /// Waits for all enqueued tasks to finish and stops the worker threads.
+    ~ThreadPool();
+
+    /// Adds the task to the end of the queue.
+    void EnqueueTask(TaskType Task);
+
+    /// Blocks until the queue is empty and no task is running.
+    void WaitForAllTasks();
+
+    Uint32 GetNumThreads() const { return static_cast<Uint32>(m_WorkerThreads.size()); }
+
+    /// Returns true if the calling thread is one of the worker threads of this pool.
+    bool IsWorkerThread() const;
+
+private:
+    void WorkerThreadProc();
+    void StopWorkerThreads();
+
+    std::vector<std::thread> m_WorkerThreads;
+
+    std::mutex              m_TasksMtx;
+    std::condition_variable m_NextTaskCondVar;
+    std::condition_variable m_TasksFinishedCondVar;
+    std::deque<TaskType>    m_Tasks;
+    Uint32                  m_NumRunningTasks = 0;
+    bool                    m_Stop            = false;
+};
+
+
+/// Returns the thread pool that is shared by parallel loops that do not provide their own pool.
+
+/// The pool is created on first use with the default number of threads.
+ThreadPool& GetSharedThreadPool();
+
+
+/// Calls Handler(i) for every i in [0, NumItems) on the worker threads of the pool and
+/// the calling thread, and waits until all items are processed.
+
+/// Items are distributed dynamically, so the handler may take different time for different items.
+/// If the handler throws an exception, the items that have not been started are skipped, and
+/// the first exception is rethrown on the calling thread after all threads have stopped.
+/// MaxThreads limits the number of threads, including the calling thread, that process the items
+/// (zero means no limit). When called from a worker thread of the pool (e.g. from a nested loop),
+/// all items are processed on the calling thread, see ThreadPool.
+template <typename HandlerType>
+void ParallelFor(ThreadPool& Pool, Uint32 NumItems, const HandlerType& Handler, Uint32 MaxThreads = 0)
+{
+    Uint32 NumTasks = std::min(Pool.GetNumThreads(), NumItems > 0 ? NumItems - 1 : 0u);
+    if (MaxThreads != 0)
+        NumTasks = std::min(NumTasks, MaxThreads - 1);
+    if (NumTasks == 0 || Pool.IsWorkerThread())
+    {
+        for (Uint32 i = 0; i < NumItems; ++i)
+            Handler(i);
+        return;
+    }
+
+    std::atomic<Uint32> NextItem{0};
+
+    std::mutex              Mtx;
+    std::condition_variable TasksFinishedCondVar;
+    Uint32                  NumRunningTasks = NumTasks; // Protected by Mtx
+    std::exception_ptr      pException;                 // Protected by Mtx
+
+    auto ProcessItems = [&]() {
+        try
+        {
+            for (auto i = NextItem.fetch_add(1); i < NumItems; i = NextItem.fetch_add(1))
+                Handler(i);
+        }
+        catch (...)
+        {
+            NextItem.store(NumItems);
+
+            std::lock_guard<std::mutex> Lock{Mtx};
+            if (!pException)
+                pException = std::current_exception();
+        }
+    };
+
+    for (Uint32 t = 0; t < NumTasks; ++t)
+    {
+        try
+        {
+            Pool.EnqueueTask([&]() {
+                ProcessItems();
+
+                std::lock_guard<std::mutex> Lock{Mtx};
+                if (--NumRunningTasks == 0)
+                    TasksFinishedCondVar.notify_one();
+            });
+        }
+        catch (...)
+        {
+            // The remaining items will be processed by the tasks that have been enqueued and this thread
+            std::lock_guard<std::mutex> Lock{Mtx};
+            NumRunningTasks -= NumTasks - t;
+            break;
+        }
+    }
+
+    ProcessItems();
+
+    // The tasks reference local variables, so we must wait for all of them to finish
+    {
+        std::unique_lock<std::mutex> Lock{Mtx};
+        TasksFinishedCondVar.wait(Lock, [&]() { return NumRunningTasks == 0; });
+    }
+
+    if (pException)
+        std::rethrow_exception(pException);
+}
+
+/// Calls Handler(i) for every i in [0, NumItems) on up to NumThreads threads including the calling thread.
+
+/// If NumThreads is zero, the number of hardware threads is used. The items are processed by
+/// the shared thread pool (see GetSharedThreadPool()), so no threads are created by the call.
+/// See ParallelFor(ThreadPool&, Uint32, const HandlerType&, Uint32) for details.
+template <typename HandlerType>
+void ParallelFor(Uint32 NumThreads, Uint32 NumItems, const HandlerType& Handler)
+{
+    if (NumThreads == 0)
+        NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (NumThreads <= 1 || NumItems <= 1)
+    {
+        for (Uint32 i = 0; i < NumItems; ++i)
+            Handler(i);
+        return;
+    }
+
+    ParallelFor(GetSharedThreadPool(), NumItems, Handler, NumThreads);
+}
+
+} // namespace Diligent
@@ -0,0 +1,1033 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "AdvancedMath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+
+#include "PlatformMisc.hpp"
+
+#if defined(__AVX__)
+#    define ADVANCED_MATH_AVX 1
+#    include <immintrin.h>
+#else
+#    define ADVANCED_MATH_AVX 0
+#endif
+
+#if !ADVANCED_MATH_AVX && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#    define ADVANCED_MATH_SSE 1
+#    include <emmintrin.h>
+#else
+#    define ADVANCED_MATH_SSE 0
+#endif
+
+#if !ADVANCED_MATH_AVX && !ADVANCED_MATH_SSE && (defined(__aarch64__) || defined(_M_ARM64))
+#    define ADVANCED_MATH_NEON 1
+#    include <arm_neon.h>
+#else
+#    define ADVANCED_MATH_NEON 0
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Minimal wrappers over the SIMD registers that are used by the SoA kernels.
+// Width is the number of objects processed at once.
+#if ADVANCED_MATH_AVX
+
+struct MaskV
+{
+    __m256 v;
+
+    friend MaskV operator|(MaskV a, MaskV b) { return {_mm256_or_ps(a.v, b.v)}; }
+    friend MaskV operator&(MaskV a, MaskV b) { return {_mm256_and_ps(a.v, b.v)}; }
+
+    static MaskV False() { return {_mm256_setzero_ps()}; }
+    static MaskV True() { return {_mm256_castsi256_ps(_mm256_set1_epi32(-1))}; }
+
+    Uint32 Bits() const { return static_cast<Uint32>(_mm256_movemask_ps(v)); }
+};
+
+struct FloatV
+{
+    static constexpr size_t Width = 8;
+
+    __m256 v;
+
+    static FloatV Load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static FloatV Set(float f) { return {_mm256_set1_ps(f)}; }
+    void          Store(float* p) const { _mm256_storeu_ps(p, v); }
+    // Returns {f(0), f(1), ..., f(Width - 1)}
+    template <typename F> static FloatV Generate(F f) { return {_mm256_setr_ps(f(0), f(1), f(2), f(3), f(4), f(5), f(6), f(7))}; }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend FloatV operator-(FloatV a, FloatV b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend FloatV operator*(FloatV a, FloatV b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend FloatV operator-(FloatV a) { return {_mm256_xor_ps(a.v, _mm256_set1_ps(-0.f))}; }
+    friend FloatV operator/(FloatV a, FloatV b) { return {_mm256_div_ps(a.v, b.v)}; }
+    friend FloatV Min(FloatV a, FloatV b) { return {_mm256_min_ps(a.v, b.v)}; }
+    friend FloatV Max(FloatV a, FloatV b) { return {_mm256_max_ps(a.v, b.v)}; }
+    // Returns a where the mask is set and b elsewhere
+    friend FloatV Select(MaskV m, FloatV a, FloatV b) { return {_mm256_blendv_ps(b.v, a.v, m.v)}; }
+
+    friend MaskV operator<(FloatV a, FloatV b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+    friend MaskV operator>(FloatV a, FloatV b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+    friend MaskV operator<=(FloatV a, FloatV b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+    friend MaskV operator>=(FloatV a, FloatV b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+};
+
+#elif ADVANCED_MATH_SSE
+
+struct MaskV
+{
+    __m128 v;
+
+    friend MaskV operator|(MaskV a, MaskV b) { return {_mm_or_ps(a.v, b.v)}; }
+    friend MaskV operator&(MaskV a, MaskV b) { return {_mm_and_ps(a.v, b.v)}; }
+
+    static MaskV False() { return {_mm_setzero_ps()}; }
+    static MaskV True() { return {_mm_castsi128_ps(_mm_set1_epi32(-1))}; }
+
+    Uint32 Bits() const { return static_cast<Uint32>(_mm_movemask_ps(v)); }
+};
+
+struct FloatV
+{
+    static constexpr size_t Width = 4;
+
+    __m128 v;
+
+    static FloatV Load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static FloatV Set(float f) { return {_mm_set1_ps(f)}; }
+    void          Store(float* p) const { _mm_storeu_ps(p, v); }
+    // Returns {f(0), f(1), ..., f(Width - 1)}
+    template <typename F> static FloatV Generate(F f) { return {_mm_setr_ps(f(0), f(1), f(2), f(3))}; }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend FloatV operator-(FloatV a, FloatV b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend FloatV operator*(FloatV a, FloatV b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend FloatV operator-(FloatV a) { return {_mm_xor_ps(a.v, _mm_set1_ps(-0.f))}; }
+    friend FloatV operator/(FloatV a, FloatV b) { return {_mm_div_ps(a.v, b.v)}; }
+    friend FloatV Min(FloatV a, FloatV b) { return {_mm_min_ps(a.v, b.v)}; }
+    friend FloatV Max(FloatV a, FloatV b) { return {_mm_max_ps(a.v, b.v)}; }
+    // Returns a where the mask is set and b elsewhere
+    friend FloatV Select(MaskV m, FloatV a, FloatV b) { return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))}; }
+
+    friend MaskV operator<(FloatV a, FloatV b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    friend MaskV operator>(FloatV a, FloatV b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+    friend MaskV operator<=(FloatV a, FloatV b) { return {_mm_cmple_ps(a.v, b.v)}; }
+    friend MaskV operator>=(FloatV a, FloatV b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+};
+
+#elif ADVANCED_MATH_NEON
+
+struct MaskV
+{
+    uint32x4_t v;
+
+    friend MaskV operator|(MaskV a, MaskV b) { return {vorrq_u32(a.v, b.v)}; }
+    friend MaskV operator&(MaskV a, MaskV b) { return {vandq_u32(a.v, b.v)}; }
+
+    static MaskV False() { return {vdupq_n_u32(0)}; }
+    static MaskV True() { return {vdupq_n_u32(~0u)}; }
+
+    Uint32 Bits() const
+    {
+        static const uint32_t LaneBits[4] = {1, 2, 4, 8};
+        return vaddvq_u32(vandq_u32(v, vld1q_u32(LaneBits)));
+    }
+};
+
+struct FloatV
+{
+    static constexpr size_t Width = 4;
+
+    float32x4_t v;
+
+    static FloatV Load(const float* p) { return {vld1q_f32(p)}; }
+    static FloatV Set(float f) { return {vdupq_n_f32(f)}; }
+    void          Store(float* p) const { vst1q_f32(p, v); }
+    // Returns {f(0), f(1), ..., f(Width - 1)}
+    template <typename F> static FloatV Generate(F f)
+    {
+        const float Values[] = {f(0), f(1), f(2), f(3)};
+        return {vld1q_f32(Values)};
+    }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return {vaddq_f32(a.v, b.v)}; }
+    friend FloatV operator-(FloatV a, FloatV b) { return {vsubq_f32(a.v, b.v)}; }
+    friend FloatV operator*(FloatV a, FloatV b) { return {vmulq_f32(a.v, b.v)}; }
+    friend FloatV operator-(FloatV a) { return {vnegq_f32(a.v)}; }
+    friend FloatV operator/(FloatV a, FloatV b) { return {vdivq_f32(a.v, b.v)}; }
+    friend FloatV Min(FloatV a, FloatV b) { return {vminq_f32(a.v, b.v)}; }
+    friend FloatV Max(FloatV a, FloatV b) { return {vmaxq_f32(a.v, b.v)}; }
+    // Returns a where the mask is set and b elsewhere
+    friend FloatV Select(MaskV m, FloatV a, FloatV b) { return {vbslq_f32(m.v, a.v, b.v)}; }
+
+    friend MaskV operator<(FloatV a, FloatV b) { return {vcltq_f32(a.v, b.v)}; }
+    friend MaskV operator>(FloatV a, FloatV b) { return {vcgtq_f32(a.v, b.v)}; }
+    friend MaskV operator<=(FloatV a, FloatV b) { return {vcleq_f32(a.v, b.v)}; }
+    friend MaskV operator>=(FloatV a, FloatV b) { return {vcgeq_f32(a.v, b.v)}; }
+};
+
+#else
+
+struct MaskV
+{
+    bool v;
+
+    friend MaskV operator|(MaskV a, MaskV b) { return {a.v || b.v}; }
+    friend MaskV operator&(MaskV a, MaskV b) { return {a.v && b.v}; }
+
+    static MaskV False() { return {false}; }
+    static MaskV True() { return {true}; }
+
+    Uint32 Bits() const { return v ? 1u : 0u; }
+};
+
+struct FloatV
+{
+    static constexpr size_t Width = 1;
+
+    float v;
+
+    static FloatV Load(const float* p) { return {*p}; }
+    static FloatV Set(float f) { return {f}; }
+    void          Store(float* p) const { *p = v; }
+    // Returns {f(0), f(1), ..., f(Width - 1)}
+    template <typename F> static FloatV Generate(F f) { return {f(0)}; }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return {a.v + b.v}; }
+    friend FloatV operator-(FloatV a, FloatV b) { return {a.v - b.v}; }
+    friend FloatV operator*(FloatV a, FloatV b) { return {a.v * b.v}; }
+    friend FloatV operator-(FloatV a) { return {-a.v}; }
+    friend FloatV operator/(FloatV a, FloatV b) { return {a.v / b.v}; }
+    friend FloatV Min(FloatV a, FloatV b) { return {std::min(a.v, b.v)}; }
+    friend FloatV Max(FloatV a, FloatV b) { return {std::max(a.v, b.v)}; }
+    // Returns a where the mask is set and b elsewhere
+    friend FloatV Select(MaskV m, FloatV a, FloatV b) { return m.v ? a : b; }
+
+    friend MaskV operator<(FloatV a, FloatV b) { return {a.v < b.v}; }
+    friend MaskV operator>(FloatV a, FloatV b) { return {a.v > b.v}; }
+    friend MaskV operator<=(FloatV a, FloatV b) { return {a.v <= b.v}; }
+    friend MaskV operator>=(FloatV a, FloatV b) { return {a.v >= b.v}; }
+};
+
+#endif
+
+// Loads Count values starting from Idx; the remaining lanes are set to zero
+inline FloatV LoadPartial(const float* p, size_t Idx, size_t Count)
+{
+    float Values[FloatV::Width] = {};
+    memcpy(Values, p + Idx, sizeof(float) * Count);
+    return FloatV::Load(Values);
+}
+
+// Stores the first Count values of v starting from Idx
+inline void StorePartial(FloatV v, float* p, size_t Idx, size_t Count)
+{
+    float Values[FloatV::Width];
+    v.Store(Values);
+    memcpy(p + Idx, Values, sizeof(float) * Count);
+}
+
+// 4-component vector that is used by the kernels that process xyz data in AoS layout.
+// Load() reads four floats, so the kernels use Load3() for the last element of an array.
+#if ADVANCED_MATH_AVX || ADVANCED_MATH_SSE
+
+struct Float4
+{
+    __m128 v;
+
+    static Float4 Load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static Float4 Load3(const float* p)
+    {
+        const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+        return {_mm_movelh_ps(xy, _mm_load_ss(p + 2))};
+    }
+    static Float4 Set(float f) { return {_mm_set1_ps(f)}; }
+    void          Store(float* p) const { _mm_storeu_ps(p, v); }
+    void          Store3(float* p) const
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend Float4 Min(Float4 a, Float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+    friend Float4 Max(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+
+    friend void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        _MM_TRANSPOSE4_PS(r0.v, r1.v, r2.v, r3.v);
+    }
+};
+
+#elif ADVANCED_MATH_NEON
+
+struct Float4
+{
+    float32x4_t v;
+
+    static Float4 Load(const float* p) { return {vld1q_f32(p)}; }
+    static Float4 Load3(const float* p) { return {vcombine_f32(vld1_f32(p), vset_lane_f32(p[2], vdup_n_f32(0), 0))}; }
+    static Float4 Set(float f) { return {vdupq_n_f32(f)}; }
+    void          Store(float* p) const { vst1q_f32(p, v); }
+    void          Store3(float* p) const
+    {
+        vst1_f32(p, vget_low_f32(v));
+        vst1q_lane_f32(p + 2, v, 2);
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+    friend Float4 Min(Float4 a, Float4 b) { return {vminq_f32(a.v, b.v)}; }
+    friend Float4 Max(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+
+    friend void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        const float32x4x2_t t01 = vtrnq_f32(r0.v, r1.v);
+        const float32x4x2_t t23 = vtrnq_f32(r2.v, r3.v);
+
+        r0.v = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1.v = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2.v = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3.v = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+};
+
+#else
+
+struct Float4
+{
+    float v[4];
+
+    static Float4 Load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static Float4 Load3(const float* p) { return {{p[0], p[1], p[2], 0}}; }
+    static Float4 Set(float f) { return {{f, f, f, f}}; }
+    void          Store(float* p) const { memcpy(p, v, sizeof(v)); }
+    void          Store3(float* p) const { memcpy(p, v, sizeof(float) * 3); }
+
+    template <typename OpType>
+    static Float4 Apply(const Float4& a, const Float4& b, OpType Op)
+    {
+        return {{Op(a.v[0], b.v[0]), Op(a.v[1], b.v[1]), Op(a.v[2], b.v[2]), Op(a.v[3], b.v[3])}};
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b)
+    {
+        return Apply(a, b, [](float x, float y) { return x + y; });
+    }
+    friend Float4 operator-(Float4 a, Float4 b)
+    {
+        return Apply(a, b, [](float x, float y) { return x - y; });
+    }
+    friend Float4 operator*(Float4 a, Float4 b)
+    {
+        return Apply(a, b, [](float x, float y) { return x * y; });
+    }
+    friend Float4 Min(Float4 a, Float4 b)
+    {
+        return Apply(a, b, [](float x, float y) { return std::min(x, y); });
+    }
+    friend Float4 Max(Float4 a, Float4 b)
+    {
+        return Apply(a, b, [](float x, float y) { return std::max(x, y); });
+    }
+
+    friend void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        Float4* Rows[] = {&r0, &r1, &r2, &r3};
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = i + 1; j < 4; ++j)
+                std::swap(Rows[i]->v[j], Rows[j]->v[i]);
+        }
+    }
+};
+
+#endif
+
+inline const float* GetElement(const float3* pData, size_t Idx, size_t Stride)
+{
+    return reinterpret_cast<const float*>(reinterpret_cast<const Uint8*>(pData) + Idx * Stride);
+}
+
+inline float* GetElement(float3* pData, size_t Idx, size_t Stride)
+{
+    return reinterpret_cast<float*>(reinterpret_cast<Uint8*>(pData) + Idx * Stride);
+}
+
+// Loads the element using four-component load unless it is the last one
+inline Float4 LoadElement(const float* p, bool IsLast)
+{
+    return IsLast ? Float4::Load3(p) : Float4::Load(p);
+}
+
+struct PreparedPlane
+{
+    FloatV Nx;
+    FloatV Ny;
+    FloatV Nz;
+    FloatV D;
+
+    bool PositiveX;
+    bool PositiveY;
+    bool PositiveZ;
+};
+
+// View frustum prepared for testing. Planes of the frustum are broadcast to SIMD registers.
+struct PreparedFrustum
+{
+    void Init(const FrustumCullingTarget& Target, bool NormalizePlanes)
+    {
+        NumPlanes = 0;
+        VERIFY(Target.pFrustum != nullptr || Target.pFrustumExt != nullptr, "Either pFrustum or pFrustumExt must not be null");
+        VERIFY(Target.pVisibleMask != nullptr, "Visible mask must not be null");
+        const ViewFrustum& Frustum = Target.pFrustumExt != nullptr ? *Target.pFrustumExt : *Target.pFrustum;
+
+        for (Uint32 plane_idx = 0; plane_idx < ViewFrustum::NUM_PLANES; ++plane_idx)
+        {
+            if ((Target.PlaneFlags & (1 << plane_idx)) == 0)
+                continue;
+
+            const Plane3D& Plane = Frustum.GetPlane(static_cast<ViewFrustum::PLANE_IDX>(plane_idx));
+
+            float3 Normal   = Plane.Normal;
+            float  Distance = Plane.Distance;
+            if (NormalizePlanes)
+            {
+                const auto Len = length(Normal);
+                VERIFY_EXPR(Len > 0);
+                Normal /= Len;
+                Distance /= Len;
+            }
+
+            auto& DstPlane     = Planes[NumPlanes++];
+            DstPlane.Nx        = FloatV::Set(Normal.x);
+            DstPlane.Ny        = FloatV::Set(Normal.y);
+            DstPlane.Nz        = FloatV::Set(Normal.z);
+            DstPlane.D         = FloatV::Set(Distance);
+            DstPlane.PositiveX = Normal.x > 0;
+            DstPlane.PositiveY = Normal.y > 0;
+            DstPlane.PositiveZ = Normal.z > 0;
+        }
+
+        // Frustum corners are only tested when all planes are enabled, see GetBoxVisibility()
+        TestCorners = Target.pFrustumExt != nullptr && (Target.PlaneFlags & FRUSTUM_PLANE_FLAG_FULL_FRUSTUM) == FRUSTUM_PLANE_FLAG_FULL_FRUSTUM;
+        if (TestCorners)
+        {
+            // All corners are outside of a bounding box plane if they are all on one side of it,
+            // which is equivalent to testing the bounding box of the corners.
+            float3 CornersMin = Target.pFrustumExt->FrustumCorners[0];
+            float3 CornersMax = CornersMin;
+            for (const auto& Corner : Target.pFrustumExt->FrustumCorners)
+            {
+                CornersMin = std::min(CornersMin, Corner);
+                CornersMax = std::max(CornersMax, Corner);
+            }
+            CornersMinX = FloatV::Set(CornersMin.x);
+            CornersMinY = FloatV::Set(CornersMin.y);
+            CornersMinZ = FloatV::Set(CornersMin.z);
+            CornersMaxX = FloatV::Set(CornersMax.x);
+            CornersMaxY = FloatV::Set(CornersMax.y);
+            CornersMaxZ = FloatV::Set(CornersMax.z);
+        }
+    }
+
+    // Returns the mask of boxes that are outside of the box containing all frustum corners
+    MaskV AreCornersOutside(const FloatV& MinX, const FloatV& MinY, const FloatV& MinZ, const FloatV& MaxX, const FloatV& MaxY, const FloatV& MaxZ) const
+    {
+        return (CornersMaxX <= MinX) | (CornersMaxY <= MinY) | (CornersMaxZ <= MinZ) |
+            (CornersMinX >= MaxX) | (CornersMinY >= MaxY) | (CornersMinZ >= MaxZ);
+    }
+
+    PreparedPlane Planes[ViewFrustum::NUM_PLANES];
+    Uint32        NumPlanes = 0;
+
+    bool   TestCorners = false;
+    FloatV CornersMinX;
+    FloatV CornersMinY;
+    FloatV CornersMinZ;
+    FloatV CornersMaxX;
+    FloatV CornersMaxY;
+    FloatV CornersMaxZ;
+};
+
+struct BoxBatch
+{
+    using ArraysType = BoundBoxesSoA;
+
+    static constexpr bool NormalizePlanes = false;
+
+    FloatV MinX, MinY, MinZ;
+    FloatV MaxX, MaxY, MaxZ;
+
+    void Load(const BoundBoxesSoA& Boxes, size_t Idx)
+    {
+        MinX = FloatV::Load(Boxes.MinX + Idx);
+        MinY = FloatV::Load(Boxes.MinY + Idx);
+        MinZ = FloatV::Load(Boxes.MinZ + Idx);
+        MaxX = FloatV::Load(Boxes.MaxX + Idx);
+        MaxY = FloatV::Load(Boxes.MaxY + Idx);
+        MaxZ = FloatV::Load(Boxes.MaxZ + Idx);
+    }
+
+    void LoadPartial(const BoundBoxesSoA& Boxes, size_t Idx, size_t Count)
+    {
+        MinX = Diligent::LoadPartial(Boxes.MinX, Idx, Count);
+        MinY = Diligent::LoadPartial(Boxes.MinY, Idx, Count);
+        MinZ = Diligent::LoadPartial(Boxes.MinZ, Idx, Count);
+        MaxX = Diligent::LoadPartial(Boxes.MaxX, Idx, Count);
+        MaxY = Diligent::LoadPartial(Boxes.MaxY, Idx, Count);
+        MaxZ = Diligent::LoadPartial(Boxes.MaxZ, Idx, Count);
+    }
+
+    // Same as GetBoxVisibilityAgainstPlane() for every plane of the frustum
+    void Test(const PreparedFrustum& Frustum, MaskV& Invisible, MaskV& Inside) const
+    {
+        Invisible = MaskV::False();
+        Inside    = MaskV::True();
+        for (Uint32 i = 0; i < Frustum.NumPlanes; ++i)
+        {
+            const auto& Plane = Frustum.Planes[i];
+
+            const auto DMax = (Plane.PositiveX ? MaxX : MinX) * Plane.Nx + (Plane.PositiveY ? MaxY : MinY) * Plane.Ny + (Plane.PositiveZ ? MaxZ : MinZ) * Plane.Nz + Plane.D;
+            const auto DMin = (Plane.PositiveX ? MinX : MaxX) * Plane.Nx + (Plane.PositiveY ? MinY : MaxY) * Plane.Ny + (Plane.PositiveZ ? MinZ : MaxZ) * Plane.Nz + Plane.D;
+
+            Invisible = Invisible | (DMax < FloatV::Set(0));
+            Inside    = Inside & (DMin > FloatV::Set(0));
+        }
+
+        if (Frustum.TestCorners)
+            Invisible = Invisible | Frustum.AreCornersOutside(MinX, MinY, MinZ, MaxX, MaxY, MaxZ);
+    }
+};
+
+struct SphereBatch
+{
+    using ArraysType = BoundSpheresSoA;
+
+    static constexpr bool NormalizePlanes = true;
+
+    FloatV CenterX, CenterY, CenterZ;
+    FloatV Radius;
+
+    void Load(const BoundSpheresSoA& Spheres, size_t Idx)
+    {
+        CenterX = FloatV::Load(Spheres.CenterX + Idx);
+        CenterY = FloatV::Load(Spheres.CenterY + Idx);
+        CenterZ = FloatV::Load(Spheres.CenterZ + Idx);
+        Radius  = FloatV::Load(Spheres.Radius + Idx);
+    }
+
+    void LoadPartial(const BoundSpheresSoA& Spheres, size_t Idx, size_t Count)
+    {
+        CenterX = Diligent::LoadPartial(Spheres.CenterX, Idx, Count);
+        CenterY = Diligent::LoadPartial(Spheres.CenterY, Idx, Count);
+        CenterZ = Diligent::LoadPartial(Spheres.CenterZ, Idx, Count);
+        Radius  = Diligent::LoadPartial(Spheres.Radius, Idx, Count);
+    }
+
+    void Test(const PreparedFrustum& Frustum, MaskV& Invisible, MaskV& Inside) const
+    {
+        Invisible = MaskV::False();
+        Inside    = MaskV::True();
+
+        const auto NegRadius = -Radius;
+        for (Uint32 i = 0; i < Frustum.NumPlanes; ++i)
+        {
+            const auto& Plane = Frustum.Planes[i];
+
+            // Planes are normalized
+            const auto Dist = CenterX * Plane.Nx + CenterY * Plane.Ny + CenterZ * Plane.Nz + Plane.D;
+
+            Invisible = Invisible | (Dist < NegRadius);
+            Inside    = Inside & (Dist > Radius);
+        }
+
+        if (Frustum.TestCorners)
+        {
+            Invisible = Invisible |
+                Frustum.AreCornersOutside(CenterX - Radius, CenterY - Radius, CenterZ - Radius,
+                                          CenterX + Radius, CenterY + Radius, CenterZ + Radius);
+        }
+    }
+};
+
+template <typename BatchType>
+void ComputeVisibility(const typename BatchType::ArraysType& Objects,
+                       const FrustumCullingTarget*           pTargets,
+                       Uint32                                NumTargets,
+                       size_t                                First,
+                       size_t                                Num)
+{
+    VERIFY((First % 64) == 0, "The first object index (", First, ") must be a multiple of 64");
+    if (First >= Objects.Count || NumTargets == 0)
+        return;
+
+    const size_t End = First + std::min(Num, Objects.Count - First);
+
+    // Object data is loaded once for a group of frustums
+    static constexpr Uint32 MaxFrustumsPerPass = 8;
+    for (Uint32 FirstTarget = 0; FirstTarget < NumTargets; FirstTarget += MaxFrustumsPerPass)
+    {
+        const auto NumPassTargets = std::min(NumTargets - FirstTarget, MaxFrustumsPerPass);
+
+        PreparedFrustum Frustums[MaxFrustumsPerPass];
+        for (Uint32 t = 0; t < NumPassTargets; ++t)
+            Frustums[t].Init(pTargets[FirstTarget + t], BatchType::NormalizePlanes);
+
+        for (size_t WordStart = First; WordStart < End; WordStart += 64)
+        {
+            const size_t WordEnd = std::min(WordStart + 64, End);
+
+            Uint64 Visible[MaxFrustumsPerPass]      = {};
+            Uint64 FullyVisible[MaxFrustumsPerPass] = {};
+            for (size_t Idx = WordStart; Idx < WordEnd; Idx += FloatV::Width)
+            {
+                const auto Count = std::min(size_t{FloatV::Width}, WordEnd - Idx);
+
+                BatchType Batch;
+                if (Count == FloatV::Width)
+                    Batch.Load(Objects, Idx);
+                else
+                    Batch.LoadPartial(Objects, Idx, Count);
+
+                const Uint64 LaneMask = (Uint64{1} << Count) - 1;
+                const auto   Shift    = Idx - WordStart;
+                for (Uint32 t = 0; t < NumPassTargets; ++t)
+                {
+                    MaskV Invisible, Inside;
+                    Batch.Test(Frustums[t], Invisible, Inside);
+
+                    const Uint64 VisibleBits = ~Uint64{Invisible.Bits()} & LaneMask;
+                    Visible[t] |= VisibleBits << Shift;
+                    FullyVisible[t] |= (Uint64{Inside.Bits()} & VisibleBits) << Shift;
+                }
+            }
+
+            const auto WordIdx = WordStart / 64;
+            for (Uint32 t = 0; t < NumPassTargets; ++t)
+            {
+                const auto& Target = pTargets[FirstTarget + t];
+
+                Target.pVisibleMask[WordIdx] = Visible[t];
+                if (Target.pFullyVisibleMask != nullptr)
+                    Target.pFullyVisibleMask[WordIdx] = FullyVisible[t];
+            }
+        }
+    }
+}
+
+template <bool IsPoint>
+void TransformArray(const float4x4& Matrix,
+                    const float3*   pSrc,
+                    float3*         pDst,
+                    size_t          Count,
+                    size_t          SrcStride,
+                    size_t          DstStride)
+{
+    const auto Row0 = Float4::Load(Matrix.m[0]);
+    const auto Row1 = Float4::Load(Matrix.m[1]);
+    const auto Row2 = Float4::Load(Matrix.m[2]);
+    const auto Row3 = Float4::Load(Matrix.m[3]);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const auto* pSrcElem = GetElement(pSrc, i, SrcStride);
+
+        // Same order of operations as in float4{x, y, z, w} * Matrix
+        auto r = Float4::Set(pSrcElem[0]) * Row0 + Float4::Set(pSrcElem[1]) * Row1 + Float4::Set(pSrcElem[2]) * Row2;
+        if (IsPoint)
+            r = r + Row3;
+        r.Store3(GetElement(pDst, i, DstStride));
+    }
+}
+
+} // namespace
+
+void GetBoxesVisibility(const BoundBoxesSoA&        Boxes,
+                        const FrustumCullingTarget* pTargets,
+                        Uint32                      NumTargets,
+                        size_t                      FirstBox,
+                        size_t                      NumBoxes)
+{
+    ComputeVisibility<BoxBatch>(Boxes, pTargets, NumTargets, FirstBox, NumBoxes);
+}
+
+void GetSpheresVisibility(const BoundSpheresSoA&      Spheres,
+                          const FrustumCullingTarget* pTargets,
+                          Uint32                      NumTargets,
+                          size_t                      FirstSphere,
+                          size_t                      NumSpheres)
+{
+    ComputeVisibility<SphereBatch>(Spheres, pTargets, NumTargets, FirstSphere, NumSpheres);
+}
+
+void TransformPoints(const float4x4& Matrix,
+                     const float3*   pSrc,
+                     float3*         pDst,
+                     size_t          Count,
+                     size_t          SrcStride,
+                     size_t          DstStride)
+{
+    TransformArray<true>(Matrix, pSrc, pDst, Count, SrcStride, DstStride);
+}
+
+void TransformVectors(const float4x4& Matrix,
+                      const float3*   pSrc,
+                      float3*         pDst,
+                      size_t          Count,
+                      size_t          SrcStride,
+                      size_t          DstStride)
+{
+    TransformArray<false>(Matrix, pSrc, pDst, Count, SrcStride, DstStride);
+}
+
+BoundBox ComputeBoundBox(const float3* pPoints, size_t Count, size_t Stride)
+{
+    VERIFY(Count > 0, "The number of points must not be zero");
+    if (Count == 0)
+        return BoundBox{};
+
+    auto BoxMin = Float4::Load3(GetElement(pPoints, 0, Stride));
+    auto BoxMax = BoxMin;
+    for (size_t i = 1; i < Count; ++i)
+    {
+        const auto p = LoadElement(GetElement(pPoints, i, Stride), i + 1 == Count);
+
+        BoxMin = Min(BoxMin, p);
+        BoxMax = Max(BoxMax, p);
+    }
+
+    BoundBox Box;
+    BoxMin.Store3(&Box.Min.x);
+    BoxMax.Store3(&Box.Max.x);
+    return Box;
+}
+
+BoundSphere ComputeBoundSphere(const float3* pPoints, size_t Count, size_t Stride)
+{
+    const auto Box = ComputeBoundBox(pPoints, Count, Stride);
+
+    BoundSphere Sphere;
+    Sphere.Center = (Box.Min + Box.Max) * 0.5f;
+
+    // Points are processed in groups of four that are transposed to SoA layout
+    const auto CenterX  = Float4::Set(Sphere.Center.x);
+    const auto CenterY  = Float4::Set(Sphere.Center.y);
+    const auto CenterZ  = Float4::Set(Sphere.Center.z);
+    auto       MaxDist2 = Float4::Set(0);
+
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        auto x = Float4::Load(GetElement(pPoints, i + 0, Stride));
+        auto y = Float4::Load(GetElement(pPoints, i + 1, Stride));
+        auto z = Float4::Load(GetElement(pPoints, i + 2, Stride));
+        auto w = LoadElement(GetElement(pPoints, i + 3, Stride), i + 4 == Count);
+        Transpose(x, y, z, w);
+
+        const auto dx = x - CenterX;
+        const auto dy = y - CenterY;
+        const auto dz = z - CenterZ;
+        MaxDist2      = Max(MaxDist2, dx * dx + dy * dy + dz * dz);
+    }
+
+    float Dist2[4];
+    MaxDist2.Store(Dist2);
+    float MaxDist2Scalar = std::max(std::max(Dist2[0], Dist2[1]), std::max(Dist2[2], Dist2[3]));
+    for (; i < Count; ++i)
+    {
+        const auto* p = GetElement(pPoints, i, Stride);
+
+        const auto Offset = float3{p[0], p[1], p[2]} - Sphere.Center;
+        MaxDist2Scalar    = std::max(MaxDist2Scalar, dot(Offset, Offset));
+    }
+    Sphere.Radius = std::sqrt(MaxDist2Scalar);
+
+    return Sphere;
+}
+
+BoundBox MergeBoundBoxes(const BoundBox* pBoxes, size_t Count)
+{
+    VERIFY(Count > 0, "The number of boxes must not be zero");
+    if (Count == 0)
+        return BoundBox{};
+
+    // Min is followed by Max, so it is always safe to load four floats
+    auto BoxMin = Float4::Load(&pBoxes[0].Min.x);
+    auto BoxMax = LoadElement(&pBoxes[0].Max.x, Count == 1);
+    for (size_t i = 1; i < Count; ++i)
+    {
+        BoxMin = Min(BoxMin, Float4::Load(&pBoxes[i].Min.x));
+        BoxMax = Max(BoxMax, LoadElement(&pBoxes[i].Max.x, i + 1 == Count));
+    }
+
+    BoundBox Box;
+    BoxMin.Store3(&Box.Min.x);
+    BoxMax.Store3(&Box.Max.x);
+    return Box;
+}
+
+void TransformBoundBoxes(const BoundBox* pSrc,
+                         const float4x4* pMatrices,
+                         BoundBox*       pDst,
+                         size_t          Count)
+{
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const auto& m   = pMatrices[i];
+        const auto  Src = pSrc[i];
+
+        // Arvo's method, same order of operations as in BoundBox::Transform()
+        const auto Row3   = Float4::Load(m.m[3]);
+        auto       BoxMin = Row3;
+        auto       BoxMax = Row3;
+
+        const auto Row0 = Float4::Load(m.m[0]);
+        auto       v0   = Row0 * Float4::Set(Src.Min.x);
+        auto       v1   = Row0 * Float4::Set(Src.Max.x);
+        BoxMin          = BoxMin + Min(v0, v1);
+        BoxMax          = BoxMax + Max(v0, v1);
+
+        const auto Row1 = Float4::Load(m.m[1]);
+        v0              = Row1 * Float4::Set(Src.Min.y);
+        v1              = Row1 * Float4::Set(Src.Max.y);
+        BoxMin          = BoxMin + Min(v0, v1);
+        BoxMax          = BoxMax + Max(v0, v1);
+
+        const auto Row2 = Float4::Load(m.m[2]);
+        v0              = Row2 * Float4::Set(Src.Min.z);
+        v1              = Row2 * Float4::Set(Src.Max.z);
+        BoxMin          = BoxMin + Min(v0, v1);
+        BoxMax          = BoxMax + Max(v0, v1);
+
+        BoxMin.Store3(&pDst[i].Min.x);
+        BoxMax.Store3(&pDst[i].Max.x);
+    }
+}
+
+size_t IntersectRayBoxes(const float3&        RayOrigin,
+                         const float3&        RayDirection,
+                         const BoundBoxesSoA& Boxes,
+                         Uint64*              pHitMask,
+                         float*               pEnterDist,
+                         float*               pExitDist)
+{
+    VERIFY_EXPR(RayDirection != float3(0, 0, 0));
+    VERIFY_EXPR(pHitMask != nullptr);
+
+    // Same as IntersectRayBox3D(). The direction is the same for all boxes, so the
+    // axes parallel to the ray are handled outside of the loop.
+    static constexpr float Epsilon = 1e-20f;
+
+    struct AxisData
+    {
+        bool   IsValid;
+        FloatV Origin;
+        FloatV Direction;
+
+        void GetRange(FloatV BoxMin, FloatV BoxMax, FloatV& Near, FloatV& Far) const
+        {
+            if (IsValid)
+            {
+                const auto t_min = (BoxMin - Origin) / Direction;
+                const auto t_max = (BoxMax - Origin) / Direction;
+
+                Near = Min(t_min, t_max);
+                Far  = Max(t_min, t_max);
+            }
+            else
+            {
+                Near = FloatV::Set(-FLT_MAX);
+                Far  = FloatV::Set(+FLT_MAX);
+            }
+        }
+    };
+    const AxisData Axes[] = {
+        {std::abs(RayDirection.x) > Epsilon, FloatV::Set(RayOrigin.x), FloatV::Set(RayDirection.x)},
+        {std::abs(RayDirection.y) > Epsilon, FloatV::Set(RayOrigin.y), FloatV::Set(RayDirection.y)},
+        {std::abs(RayDirection.z) > Epsilon, FloatV::Set(RayOrigin.z), FloatV::Set(RayDirection.z)},
+    };
+
+    size_t NumHits = 0;
+    for (size_t WordStart = 0; WordStart < Boxes.Count; WordStart += 64)
+    {
+        const size_t WordEnd = std::min(WordStart + 64, Boxes.Count);
+
+        Uint64 Hits = 0;
+        for (size_t Idx = WordStart; Idx < WordEnd; Idx += FloatV::Width)
+        {
+            const auto Count = std::min(size_t{FloatV::Width}, WordEnd - Idx);
+
+            BoxBatch Batch;
+            if (Count == FloatV::Width)
+                Batch.Load(Boxes, Idx);
+            else
+                Batch.LoadPartial(Boxes, Idx, Count);
+
+            FloatV NearX, FarX, NearY, FarY, NearZ, FarZ;
+            Axes[0].GetRange(Batch.MinX, Batch.MaxX, NearX, FarX);
+            Axes[1].GetRange(Batch.MinY, Batch.MaxY, NearY, FarY);
+            Axes[2].GetRange(Batch.MinZ, Batch.MaxZ, NearZ, FarZ);
+
+            const auto EnterDist = Max(Max(NearX, NearY), NearZ);
+            const auto ExitDist  = Min(Min(FarX, FarY), FarZ);
+
+            const auto   Hit      = (ExitDist >= FloatV::Set(0)) & (EnterDist <= ExitDist);
+            const Uint64 LaneMask = (Uint64{1} << Count) - 1;
+            Hits |= (Uint64{Hit.Bits()} & LaneMask) << (Idx - WordStart);
+
+            if (pEnterDist != nullptr)
+                StorePartial(EnterDist, pEnterDist, Idx, Count);
+            if (pExitDist != nullptr)
+                StorePartial(ExitDist, pExitDist, Idx, Count);
+        }
+
+        pHitMask[WordStart / 64] = Hits;
+        NumHits += PlatformMisc::CountOneBits(Hits);
+    }
+
+    return NumHits;
+}
+
+float IntersectRayTriangles(const float3& RayOrigin,
+                            const float3& RayDirection,
+                            const float3* pVertices,
+                            const Uint32* pIndices,
+                            size_t        NumTriangles,
+                            bool          CullBackFace,
+                            float*        pDistances,
+                            size_t*       pClosestHit)
+{
+    // Same as IntersectRayTriangle() (Moller-Trumbore algorithm) for FloatV::Width triangles at a time
+    static constexpr float Epsilon = 1e-10f;
+
+    const auto OriginX = FloatV::Set(RayOrigin.x);
+    const auto OriginY = FloatV::Set(RayOrigin.y);
+    const auto OriginZ = FloatV::Set(RayOrigin.z);
+    const auto DirX    = FloatV::Set(RayDirection.x);
+    const auto DirY    = FloatV::Set(RayDirection.y);
+    const auto DirZ    = FloatV::Set(RayDirection.z);
+    const auto Zero    = FloatV::Set(0);
+    const auto One     = FloatV::Set(1);
+
+    float  ClosestDist = +FLT_MAX;
+    size_t ClosestHit  = NumTriangles;
+    for (size_t First = 0; First < NumTriangles; First += FloatV::Width)
+    {
+        const auto Count = std::min(size_t{FloatV::Width}, NumTriangles - First);
+
+        // Gather the vertices in SoA layout. Unused lanes duplicate the last triangle.
+        size_t VertIdx[3][FloatV::Width];
+        for (size_t i = 0; i < FloatV::Width; ++i)
+        {
+            const auto Tri = First + std::min(i, Count - 1);
+            for (size_t v = 0; v < 3; ++v)
+                VertIdx[v][i] = pIndices != nullptr ? pIndices[Tri * 3 + v] : Tri * 3 + v;
+        }
+        auto Gather = [&](size_t v, size_t Comp) {
+            return FloatV::Generate([&](size_t i) { return pVertices[VertIdx[v][i]][Comp]; });
+        };
+
+        const auto V0X = Gather(0, 0);
+        const auto V0Y = Gather(0, 1);
+        const auto V0Z = Gather(0, 2);
+
+        const auto V0_V1X = Gather(1, 0) - V0X;
+        const auto V0_V1Y = Gather(1, 1) - V0Y;
+        const auto V0_V1Z = Gather(1, 2) - V0Z;
+        const auto V0_V2X = Gather(2, 0) - V0X;
+        const auto V0_V2Y = Gather(2, 1) - V0Y;
+        const auto V0_V2Z = Gather(2, 2) - V0Z;
+
+        // PVec = cross(RayDirection, V0_V2)
+        const auto PVecX = DirY * V0_V2Z - DirZ * V0_V2Y;
+        const auto PVecY = DirZ * V0_V2X - DirX * V0_V2Z;
+        const auto PVecZ = DirX * V0_V2Y - DirY * V0_V2X;
+
+        const auto Det = V0_V1X * PVecX + V0_V1Y * PVecY + V0_V1Z * PVecZ;
+
+        auto Valid = Det > FloatV::Set(Epsilon);
+        if (!CullBackFace)
+            Valid = Valid | (Det < FloatV::Set(-Epsilon));
+
+        const auto V0_ROX = OriginX - V0X;
+        const auto V0_ROY = OriginY - V0Y;
+        const auto V0_ROZ = OriginZ - V0Z;
+
+        const auto u = (V0_ROX * PVecX + V0_ROY * PVecY + V0_ROZ * PVecZ) / Det;
+        Valid        = Valid & (u >= Zero) & (u <= One);
+
+        float Dist[FloatV::Width];
+        // Most triangles are typically rejected by the u test
+        if (Valid.Bits() != 0)
+        {
+            // QVec = cross(V0_RO, V0_V1)
+            const auto QVecX = V0_ROY * V0_V1Z - V0_ROZ * V0_V1Y;
+            const auto QVecY = V0_ROZ * V0_V1X - V0_ROX * V0_V1Z;
+            const auto QVecZ = V0_ROX * V0_V1Y - V0_ROY * V0_V1X;
+
+            const auto v = (DirX * QVecX + DirY * QVecY + DirZ * QVecZ) / Det;
+            Valid        = Valid & (v >= Zero) & (u + v <= One);
+
+            const auto t = Select(Valid, (V0_V2X * QVecX + V0_V2Y * QVecY + V0_V2Z * QVecZ) / Det, FloatV::Set(+FLT_MAX));
+            t.Store(Dist);
+        }
+        else
+        {
+            FloatV::Set(+FLT_MAX).Store(Dist);
+        }
+        for (size_t i = 0; i < Count; ++i)
+        {
+            if (Dist[i] >= 0 && Dist[i] < ClosestDist)
+            {
+                ClosestDist = Dist[i];
+                ClosestHit  = First + i;
+            }
+        }
+        if (pDistances != nullptr)
+            memcpy(pDistances + First, Dist, sizeof(float) * Count);
+    }
+
+    if (pClosestHit != nullptr)
+        *pClosestHit = ClosestHit;
+
+    return ClosestDist;
+}
+
+} // namespace Diligent
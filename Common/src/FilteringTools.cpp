@@ -0,0 +1,405 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "FilteringTools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define FILTERING_TOOLS_SSE 1
+#    include <emmintrin.h>
+#else
+#    define FILTERING_TOOLS_SSE 0
+#endif
+
+#if !FILTERING_TOOLS_SSE && (defined(__aarch64__) || defined(_M_ARM64))
+#    define FILTERING_TOOLS_NEON 1
+#    include <arm_neon.h>
+#else
+#    define FILTERING_TOOLS_NEON 0
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+template <typename DstType>
+DstType ConvertFilteredValue(float Val);
+
+template <>
+float ConvertFilteredValue<float>(float Val)
+{
+    return Val;
+}
+
+template <>
+Uint8 ConvertFilteredValue<Uint8>(float Val)
+{
+    // lrint rounds to the nearest even value, same as SIMD conversions do
+    return static_cast<Uint8>(clamp(std::lrint(Val), 0l, 255l));
+}
+
+template <>
+Uint16 ConvertFilteredValue<Uint16>(float Val)
+{
+    return static_cast<Uint16>(clamp(std::lrint(Val), 0l, 65535l));
+}
+
+// Blends two filtered rows, Dst[i] = lerp(Row0[i], Row1[i], w), and converts the result to DstType.
+// Returns the number of processed elements; the remaining ones are processed by the scalar code.
+template <typename DstType>
+size_t BlendRowsSIMD(const float* Row0, const float* Row1, float w, DstType* pDst, size_t Count);
+
+#if FILTERING_TOOLS_SSE
+
+template <>
+size_t BlendRowsSIMD<float>(const float* Row0, const float* Row1, float w, float* pDst, size_t Count)
+{
+    const __m128 w0 = _mm_set1_ps(1.f - w);
+    const __m128 w1 = _mm_set1_ps(w);
+
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+        _mm_storeu_ps(pDst + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Row0 + i), w0), _mm_mul_ps(_mm_loadu_ps(Row1 + i), w1)));
+    return i;
+}
+
+template <>
+size_t BlendRowsSIMD<Uint8>(const float* Row0, const float* Row1, float w, Uint8* pDst, size_t Count)
+{
+    const __m128 w0 = _mm_set1_ps(1.f - w);
+    const __m128 w1 = _mm_set1_ps(w);
+
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        const __m128  Val = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Row0 + i), w0), _mm_mul_ps(_mm_loadu_ps(Row1 + i), w1));
+        const __m128i i32 = _mm_cvtps_epi32(Val);
+        // Saturating packs clamp the values to [0, 255]
+        const __m128i u8 = _mm_packus_epi16(_mm_packs_epi32(i32, i32), _mm_setzero_si128());
+
+        const int Packed = _mm_cvtsi128_si32(u8);
+        memcpy(pDst + i, &Packed, 4);
+    }
+    return i;
+}
+
+template <>
+size_t BlendRowsSIMD<Uint16>(const float* Row0, const float* Row1, float w, Uint16* pDst, size_t Count)
+{
+    const __m128 w0 = _mm_set1_ps(1.f - w);
+    const __m128 w1 = _mm_set1_ps(w);
+
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 Val = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Row0 + i), w0), _mm_mul_ps(_mm_loadu_ps(Row1 + i), w1));
+        Val        = _mm_min_ps(_mm_max_ps(Val, _mm_setzero_ps()), _mm_set1_ps(65535.f));
+
+        // SSE2 does not have unsigned saturating 32->16 pack, so shift the values
+        // to the signed range and back.
+        const __m128i i32 = _mm_sub_epi32(_mm_cvtps_epi32(Val), _mm_set1_epi32(32768));
+        const __m128i u16 = _mm_xor_si128(_mm_packs_epi32(i32, i32), _mm_set1_epi16(-32768));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst + i), u16);
+    }
+    return i;
+}
+
+// Dst[i] = lerp(Src[Idx0[i]], Src[Idx1[i]], W[i])
+size_t FilterRowSIMD(const float* Src, const Int32* Idx0, const Int32* Idx1, const float* W0, const float* W1, float* Dst, size_t Count)
+{
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        const __m128 S0 = _mm_setr_ps(Src[Idx0[i]], Src[Idx0[i + 1]], Src[Idx0[i + 2]], Src[Idx0[i + 3]]);
+        const __m128 S1 = _mm_setr_ps(Src[Idx1[i]], Src[Idx1[i + 1]], Src[Idx1[i + 2]], Src[Idx1[i + 3]]);
+        _mm_storeu_ps(Dst + i, _mm_add_ps(_mm_mul_ps(S0, _mm_loadu_ps(W0 + i)), _mm_mul_ps(S1, _mm_loadu_ps(W1 + i))));
+    }
+    return i;
+}
+
+#elif FILTERING_TOOLS_NEON
+
+template <>
+size_t BlendRowsSIMD<float>(const float* Row0, const float* Row1, float w, float* pDst, size_t Count)
+{
+    const float32x4_t w0 = vdupq_n_f32(1.f - w);
+    const float32x4_t w1 = vdupq_n_f32(w);
+
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+        vst1q_f32(pDst + i, vaddq_f32(vmulq_f32(vld1q_f32(Row0 + i), w0), vmulq_f32(vld1q_f32(Row1 + i), w1)));
+    return i;
+}
+
+template <>
+size_t BlendRowsSIMD<Uint8>(const float* Row0, const float* Row1, float w, Uint8* pDst, size_t Count)
+{
+    const float32x4_t w0 = vdupq_n_f32(1.f - w);
+    const float32x4_t w1 = vdupq_n_f32(w);
+
+    size_t i = 0;
+    for (; i + 8 <= Count; i += 8)
+    {
+        const float32x4_t Val0 = vaddq_f32(vmulq_f32(vld1q_f32(Row0 + i), w0), vmulq_f32(vld1q_f32(Row1 + i), w1));
+        const float32x4_t Val1 = vaddq_f32(vmulq_f32(vld1q_f32(Row0 + i + 4), w0), vmulq_f32(vld1q_f32(Row1 + i + 4), w1));
+        // Saturating narrowing clamps the values to [0, 255]
+        const uint16x8_t u16 = vcombine_u16(vqmovun_s32(vcvtnq_s32_f32(Val0)), vqmovun_s32(vcvtnq_s32_f32(Val1)));
+        vst1_u8(pDst + i, vqmovn_u16(u16));
+    }
+    return i;
+}
+
+template <>
+size_t BlendRowsSIMD<Uint16>(const float* Row0, const float* Row1, float w, Uint16* pDst, size_t Count)
+{
+    const float32x4_t w0 = vdupq_n_f32(1.f - w);
+    const float32x4_t w1 = vdupq_n_f32(w);
+
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        const float32x4_t Val = vaddq_f32(vmulq_f32(vld1q_f32(Row0 + i), w0), vmulq_f32(vld1q_f32(Row1 + i), w1));
+        vst1_u16(pDst + i, vqmovun_s32(vcvtnq_s32_f32(Val)));
+    }
+    return i;
+}
+
+size_t FilterRowSIMD(const float* Src, const Int32* Idx0, const Int32* Idx1, const float* W0, const float* W1, float* Dst, size_t Count)
+{
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        const float S0[] = {Src[Idx0[i]], Src[Idx0[i + 1]], Src[Idx0[i + 2]], Src[Idx0[i + 3]]};
+        const float S1[] = {Src[Idx1[i]], Src[Idx1[i + 1]], Src[Idx1[i + 2]], Src[Idx1[i + 3]]};
+        vst1q_f32(Dst + i, vaddq_f32(vmulq_f32(vld1q_f32(S0), vld1q_f32(W0 + i)), vmulq_f32(vld1q_f32(S1), vld1q_f32(W1 + i))));
+    }
+    return i;
+}
+
+#else
+
+template <typename DstType>
+size_t BlendRowsSIMD(const float*, const float*, float, DstType*, size_t)
+{
+    return 0;
+}
+
+size_t FilterRowSIMD(const float*, const Int32*, const Int32*, const float*, const float*, float*, size_t)
+{
+    return 0;
+}
+
+#endif
+
+// Resamples the image in two passes: every source row is first filtered horizontally,
+// then destination rows are computed by blending two filtered rows.
+// Filtered rows are cached, so every source row is filtered once per band of destination rows.
+template <typename ComponentType>
+class BilinearImageResampler
+{
+public:
+    explicit BilinearImageResampler(const ResampleImageAttribs& Attribs) :
+        m_Attribs{Attribs},
+        m_SrcRowSize{size_t{Attribs.SrcWidth} * Attribs.NumComponents},
+        m_DstRowSize{size_t{Attribs.DstWidth} * Attribs.NumComponents}
+    {
+        const auto NumComps = Attribs.NumComponents;
+
+        std::vector<LinearTexFilterSampleInfo> USampleInfo(Attribs.DstWidth);
+        GetLinearTexFilterSampleInfoTable(GetSampleInfoAddressMode(Attribs.AddressModeU), Attribs.SrcWidth, Attribs.DstWidth, USampleInfo.data());
+
+        // Per-component horizontal tables. Out-of-range indices in border mode refer to
+        // the border color that is stored after the last source pixel.
+        m_Idx0.resize(m_DstRowSize);
+        m_Idx1.resize(m_DstRowSize);
+        m_W0.resize(m_DstRowSize);
+        m_W1.resize(m_DstRowSize);
+        auto GetElementIdx = [&](Int32 x, Uint32 c) {
+            return (x >= 0 && x < static_cast<Int32>(Attribs.SrcWidth)) ?
+                static_cast<Int32>(x * NumComps + c) :
+                static_cast<Int32>(m_SrcRowSize + c);
+        };
+        for (Uint32 x = 0; x < Attribs.DstWidth; ++x)
+        {
+            const auto& Info = USampleInfo[x];
+            for (Uint32 c = 0; c < NumComps; ++c)
+            {
+                const auto i = x * NumComps + c;
+
+                m_Idx0[i] = GetElementIdx(Info.i0, c);
+                m_Idx1[i] = GetElementIdx(Info.i1, c);
+                m_W0[i]   = 1.f - Info.w;
+                m_W1[i]   = Info.w;
+            }
+        }
+
+        m_VSampleInfo.resize(Attribs.DstHeight);
+        GetLinearTexFilterSampleInfoTable(GetSampleInfoAddressMode(Attribs.AddressModeV), Attribs.SrcHeight, Attribs.DstHeight, m_VSampleInfo.data());
+
+        m_BorderRow.resize(m_DstRowSize);
+        for (size_t i = 0; i < m_DstRowSize; ++i)
+            m_BorderRow[i] = Attribs.BorderColor[i % NumComps];
+    }
+
+    void ProcessRows(Uint32 StartRow, Uint32 EndRow) const
+    {
+        const auto NumComps = m_Attribs.NumComponents;
+
+        std::vector<float> SrcRow(m_SrcRowSize + NumComps);
+        for (Uint32 c = 0; c < NumComps; ++c)
+            SrcRow[m_SrcRowSize + c] = m_Attribs.BorderColor[c];
+
+        std::vector<float> FilteredRows[2] = {std::vector<float>(m_DstRowSize), std::vector<float>(m_DstRowSize)};
+
+        Int32 CachedRows[2] = {-1, -1};
+        Int32 LastUsedSlot  = 0;
+
+        // Returns the horizontally filtered source row
+        auto GetFilteredRow = [&](Int32 Row, Int32 KeepRow) -> const float* {
+            if (Row < 0 || Row >= static_cast<Int32>(m_Attribs.SrcHeight))
+                return m_BorderRow.data();
+
+            for (Int32 Slot = 0; Slot < 2; ++Slot)
+            {
+                if (CachedRows[Slot] == Row)
+                {
+                    LastUsedSlot = Slot;
+                    return FilteredRows[Slot].data();
+                }
+            }
+
+            // Do not evict the row that is needed for the current destination row
+            const Int32 Slot = CachedRows[0] == KeepRow ? 1 : (CachedRows[1] == KeepRow ? 0 : 1 - LastUsedSlot);
+            FilterSourceRow(static_cast<Uint32>(Row), SrcRow.data(), FilteredRows[Slot].data());
+            CachedRows[Slot] = Row;
+            LastUsedSlot     = Slot;
+            return FilteredRows[Slot].data();
+        };
+
+        for (Uint32 y = StartRow; y < EndRow; ++y)
+        {
+            const auto& Info = m_VSampleInfo[y];
+
+            const float* Row0 = GetFilteredRow(Info.i0, Info.i1);
+            const float* Row1 = GetFilteredRow(Info.i1, Info.i0);
+
+            auto* pDst = reinterpret_cast<ComponentType*>(static_cast<Uint8*>(m_Attribs.pDstData) + y * m_Attribs.DstStride);
+
+            // Same as lerp(Row0[i], Row1[i], Info.w)
+            size_t i = BlendRowsSIMD(Row0, Row1, Info.w, pDst, m_DstRowSize);
+            for (; i < m_DstRowSize; ++i)
+                pDst[i] = ConvertFilteredValue<ComponentType>(Row0[i] * (1.f - Info.w) + Row1[i] * Info.w);
+        }
+    }
+
+private:
+    // In border mode, indices are not adjusted, and the ones that are outside of the image
+    // refer to the border color.
+    static TEXTURE_ADDRESS_MODE GetSampleInfoAddressMode(TEXTURE_ADDRESS_MODE AddressMode)
+    {
+        return AddressMode == TEXTURE_ADDRESS_BORDER ? TEXTURE_ADDRESS_UNKNOWN : AddressMode;
+    }
+
+    void FilterSourceRow(Uint32 Row, float* SrcRow, float* FilteredRow) const
+    {
+        const auto* pSrc = reinterpret_cast<const ComponentType*>(static_cast<const Uint8*>(m_Attribs.pSrcData) + Row * m_Attribs.SrcStride);
+        for (size_t i = 0; i < m_SrcRowSize; ++i)
+            SrcRow[i] = static_cast<float>(pSrc[i]);
+
+        size_t i = FilterRowSIMD(SrcRow, m_Idx0.data(), m_Idx1.data(), m_W0.data(), m_W1.data(), FilteredRow, m_DstRowSize);
+        for (; i < m_DstRowSize; ++i)
+            FilteredRow[i] = SrcRow[m_Idx0[i]] * m_W0[i] + SrcRow[m_Idx1[i]] * m_W1[i];
+    }
+
+    const ResampleImageAttribs& m_Attribs;
+
+    const size_t m_SrcRowSize;
+    const size_t m_DstRowSize;
+
+    std::vector<Int32> m_Idx0;
+    std::vector<Int32> m_Idx1;
+    std::vector<float> m_W0;
+    std::vector<float> m_W1;
+
+    std::vector<LinearTexFilterSampleInfo> m_VSampleInfo;
+
+    std::vector<float> m_BorderRow;
+};
+
+template <typename ComponentType>
+void ResampleImage(const ResampleImageAttribs& Attribs)
+{
+    const BilinearImageResampler<ComponentType> Resampler{Attribs};
+
+    const Uint32 NumThreads = Attribs.NumThreads != 0 ? Attribs.NumThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    // Do not create threads for small images
+    const Uint32 NumBands = std::min(NumThreads, std::max(Attribs.DstHeight / 16u, 1u));
+
+    ParallelFor(NumBands, NumBands, [&](Uint32 Band) {
+        Resampler.ProcessRows(Attribs.DstHeight * Band / NumBands, Attribs.DstHeight * (Band + 1) / NumBands);
+    });
+}
+
+} // namespace
+
+void ResampleImageBilinear(const ResampleImageAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.pSrcData != nullptr && Attribs.pDstData != nullptr, "Source and destination data must not be null");
+    DEV_CHECK_ERR(Attribs.SrcWidth > 0 && Attribs.SrcHeight > 0, "Source image must not be empty");
+    DEV_CHECK_ERR(Attribs.NumComponents >= 1 && Attribs.NumComponents <= 4, "The number of components (", Attribs.NumComponents, ") must be between 1 and 4");
+    if (Attribs.DstWidth == 0 || Attribs.DstHeight == 0)
+        return;
+
+    switch (Attribs.ComponentType)
+    {
+        case VT_UINT8:
+            ResampleImage<Uint8>(Attribs);
+            break;
+
+        case VT_UINT16:
+            ResampleImage<Uint16>(Attribs);
+            break;
+
+        case VT_FLOAT32:
+            ResampleImage<float>(Attribs);
+            break;
+
+        default:
+            UNSUPPORTED("Unsupported component type (", Uint32{Attribs.ComponentType}, "). Only VT_UINT8, VT_UINT16 and VT_FLOAT32 are supported.");
+    }
+}
+
+} // namespace Diligent
@@ -27,6 +27,8 @@
 
 #include "pch.h"
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include "FixedBlockMemoryAllocator.hpp"
 #include "Align.hpp"
 
@@ -38,24 +40,50 @@ static size_t AdjustBlockSize(size_t BlockSize)
     return AlignUp(std::max(BlockSize, size_t{1}), sizeof(void*));
 }
 
+static Uint32 GetNumThreadCaches()
+{
+    // Use at least as many caches as there are hardware threads, so that
+    // most of the time every thread works with its own cache.
+    Uint32 NumCaches = 1;
+    while (NumCaches < std::thread::hardware_concurrency() && NumCaches < 64)
+        NumCaches *= 2;
+    return NumCaches;
+}
+
+static Uint32 GetThreadCacheIndex()
+{
+    static std::atomic<Uint32> NextThreadIndex{0};
+    static thread_local Uint32 ThreadIndex = NextThreadIndex.fetch_add(1);
+    return ThreadIndex;
+}
+
 FixedBlockMemoryAllocator::FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator,
                                                      size_t            BlockSize,
-                                                     Uint32            NumBlocksInPage) :
+                                                     Uint32            NumBlocksInPage,
+                                                     bool              EnableThreadCaches) :
     // clang-format off
     m_PagePool          (STD_ALLOCATOR_RAW_MEM(MemoryPage, RawMemoryAllocator, "Allocator for vector<MemoryPage>")),
     m_AvailablePages    (STD_ALLOCATOR_RAW_MEM(size_t, RawMemoryAllocator, "Allocator for unordered_set<size_t>") ),
-    m_AddrToPageId      (STD_ALLOCATOR_RAW_MEM(AddrToPageIdMapElem, RawMemoryAllocator, "Allocator for unordered_map<void*, size_t>")),
-    m_RawMemoryAllocator{RawMemoryAllocator        },
-    m_BlockSize         {AdjustBlockSize(BlockSize)},
-    m_NumBlocksInPage   {NumBlocksInPage           }
+    m_ThreadCaches      (EnableThreadCaches ? GetNumThreadCaches() : 0, STD_ALLOCATOR_RAW_MEM(ThreadCache, RawMemoryAllocator, "Allocator for vector<ThreadCache>")),
+    m_RawMemoryAllocator{RawMemoryAllocator                           },
+    m_BlockSize         {AdjustBlockSize(BlockSize)                                      },
+    m_BlockStride       {AlignUp(AdjustBlockSize(BlockSize), BlockHeaderSize) + BlockHeaderSize},
+    m_NumBlocksInPage   {NumBlocksInPage                                                 }
 // clang-format on
 {
+    static_assert(sizeof(ThreadCache) == 64, "Thread cache is expected to occupy one cache line");
+    VERIFY_EXPR(m_ThreadCaches.empty() || IsPowerOfTwo(m_ThreadCaches.size()));
+
     // Allocate one page
     CreateNewPage();
 }
 
 FixedBlockMemoryAllocator::~FixedBlockMemoryAllocator()
 {
+    // Return all cached blocks to their pages
+    for (auto& Cache : m_ThreadCaches)
+        FlushThreadCache(Cache, 0);
+
 #ifdef DILIGENT_DEBUG
     for (size_t p = 0; p < m_PagePool.size(); ++p)
     {
@@ -67,20 +95,13 @@ FixedBlockMemoryAllocator::~FixedBlockMemoryAllocator()
 
 void FixedBlockMemoryAllocator::CreateNewPage()
 {
-    m_PagePool.emplace_back(*this);
+    m_PagePool.emplace_back(*this, m_PagePool.size());
     m_AvailablePages.insert(m_PagePool.size() - 1);
-    m_AddrToPageId.reserve(m_PagePool.size() * m_NumBlocksInPage);
 }
 
-void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
+void* FixedBlockMemoryAllocator::AllocateFromPages()
 {
-    VERIFY_EXPR(Size > 0);
-
-    Size = AdjustBlockSize(Size);
-    VERIFY(m_BlockSize == Size, "Requested size (", Size, ") does not match the block size (", m_BlockSize, ")");
-
-    std::lock_guard<std::mutex> LockGuard(m_Mutex);
-
+    // The mutex must be locked by the caller
     if (m_AvailablePages.empty())
     {
         CreateNewPage();
@@ -89,7 +110,6 @@ void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescriptio
     auto  PageId = *m_AvailablePages.begin();
     auto& Page   = m_PagePool[PageId];
     auto* Ptr    = Page.Allocate();
-    m_AddrToPageId.insert(std::make_pair(Ptr, PageId));
     if (!Page.HasSpace())
     {
         m_AvailablePages.erase(m_AvailablePages.begin());
@@ -98,30 +118,100 @@ void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescriptio
     return Ptr;
 }
 
-void FixedBlockMemoryAllocator::Free(void* Ptr)
+void FixedBlockMemoryAllocator::FreeToPage(void* Ptr)
 {
-    std::lock_guard<std::mutex> LockGuard(m_Mutex);
-    auto                        PageIdIt = m_AddrToPageId.find(Ptr);
-    if (PageIdIt != m_AddrToPageId.end())
+    // The mutex must be locked by the caller
+    auto PageId = GetBlockPageId(Ptr);
+    if (PageId < m_PagePool.size())
     {
-        auto PageId = PageIdIt->second;
-        VERIFY_EXPR(PageId >= 0 && PageId < m_PagePool.size());
-        m_PagePool[PageId].DeAllocate(Ptr);
-        m_AvailablePages.insert(PageId);
-        m_AddrToPageId.erase(PageIdIt);
-        if (m_AvailablePages.size() > 1 && !m_PagePool[PageId].HasAllocations())
-        {
-            // In current implementation pages are never released!
-            // Note that if we delete a page, all indices past it will be invalid
-
-            //m_PagePool.erase(m_PagePool.begin() + PageId);
-            //m_AvailablePages.erase(PageId);
-        }
+        auto& Page = m_PagePool[PageId];
+        // Only full pages are not in the available page pool
+        const auto WasFull = !Page.HasSpace();
+        Page.DeAllocate(Ptr);
+        if (WasFull)
+            m_AvailablePages.insert(PageId);
     }
     else
     {
-        UNEXPECTED("Address not found in the allocations list - double freeing memory?");
+        UNEXPECTED("Invalid page id in the block header - the address was not allocated by this allocator or the memory is corrupted");
+    }
+}
+
+void FixedBlockMemoryAllocator::RefillThreadCache(ThreadCache& Cache)
+{
+    // The cache must be locked by the caller
+    VERIFY_EXPR(Cache.NumBlocks == 0);
+
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    for (Uint32 i = 0; i < ThreadCacheRefillSize; ++i)
+    {
+        auto* pBlock                      = AllocateFromPages();
+        *reinterpret_cast<void**>(pBlock) = Cache.pFirstBlock;
+        Cache.pFirstBlock                 = pBlock;
+        ++Cache.NumBlocks;
+    }
+}
+
+void FixedBlockMemoryAllocator::FlushThreadCache(ThreadCache& Cache, Uint32 NumBlocksToKeep)
+{
+    // The cache must be locked by the caller
+    if (Cache.NumBlocks <= NumBlocksToKeep)
+        return;
+
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    while (Cache.NumBlocks > NumBlocksToKeep)
+    {
+        auto* pBlock      = Cache.pFirstBlock;
+        Cache.pFirstBlock = *reinterpret_cast<void**>(pBlock);
+        --Cache.NumBlocks;
+        FreeToPage(pBlock);
+    }
+}
+
+void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
+{
+    VERIFY_EXPR(Size > 0);
+
+    Size = AdjustBlockSize(Size);
+    VERIFY(m_BlockSize == Size, "Requested size (", Size, ") does not match the block size (", m_BlockSize, ")");
+
+    if (!m_ThreadCaches.empty())
+    {
+        auto& Cache = m_ThreadCaches[GetThreadCacheIndex() & (m_ThreadCaches.size() - 1)];
+
+        ThreadingTools::LockHelper CacheLock{Cache.Lock};
+        if (Cache.NumBlocks == 0)
+            RefillThreadCache(Cache);
+
+        auto* Ptr         = Cache.pFirstBlock;
+        Cache.pFirstBlock = *reinterpret_cast<void**>(Ptr);
+        --Cache.NumBlocks;
+        FillWithDebugPattern(Ptr, MemoryPage::AllocatedBlockMemPattern, m_BlockSize);
+        return Ptr;
+    }
+
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    return AllocateFromPages();
+}
+
+void FixedBlockMemoryAllocator::Free(void* Ptr)
+{
+    if (!m_ThreadCaches.empty())
+    {
+        auto& Cache = m_ThreadCaches[GetThreadCacheIndex() & (m_ThreadCaches.size() - 1)];
+
+        ThreadingTools::LockHelper CacheLock{Cache.Lock};
+        FillWithDebugPattern(Ptr, MemoryPage::DeallocatedBlockMemPattern, m_BlockSize);
+        *reinterpret_cast<void**>(Ptr) = Cache.pFirstBlock;
+        Cache.pFirstBlock              = Ptr;
+        ++Cache.NumBlocks;
+        if (Cache.NumBlocks > MaxThreadCacheBlocks)
+            FlushThreadCache(Cache, MaxThreadCacheBlocks / 2);
+        return;
     }
+
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    FreeToPage(Ptr);
 }
 
 } // namespace Diligent
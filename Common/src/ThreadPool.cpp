@@ -0,0 +1,134 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+// The pool whose worker thread is the current thread
+static thread_local const ThreadPool* CurrentThreadPool = nullptr;
+
+ThreadPool::ThreadPool(Uint32 NumThreads)
+{
+    if (NumThreads == 0)
+        NumThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+
+    try
+    {
+        m_WorkerThreads.reserve(NumThreads);
+        for (Uint32 i = 0; i < NumThreads; ++i)
+            m_WorkerThreads.emplace_back(&ThreadPool::WorkerThreadProc, this);
+    }
+    catch (...)
+    {
+        // The destructor is not called if the constructor throws
+        StopWorkerThreads();
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    StopWorkerThreads();
+    VERIFY(m_Tasks.empty() && m_NumRunningTasks == 0, "All tasks must be finished when worker threads exit");
+}
+
+void ThreadPool::StopWorkerThreads()
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_TasksMtx};
+        m_Stop = true;
+    }
+    m_NextTaskCondVar.notify_all();
+
+    for (auto& Thread : m_WorkerThreads)
+        Thread.join();
+}
+
+void ThreadPool::EnqueueTask(TaskType Task)
+{
+    VERIFY_EXPR(Task);
+    {
+        std::lock_guard<std::mutex> Lock{m_TasksMtx};
+        VERIFY(!m_Stop, "Enqueueing a task into a thread pool that is being destroyed");
+        m_Tasks.emplace_back(std::move(Task));
+    }
+    m_NextTaskCondVar.notify_one();
+}
+
+void ThreadPool::WaitForAllTasks()
+{
+    std::unique_lock<std::mutex> Lock{m_TasksMtx};
+    m_TasksFinishedCondVar.wait(Lock, [this] { return m_Tasks.empty() && m_NumRunningTasks == 0; });
+}
+
+bool ThreadPool::IsWorkerThread() const
+{
+    return CurrentThreadPool == this;
+}
+
+void ThreadPool::WorkerThreadProc()
+{
+    CurrentThreadPool = this;
+
+    std::unique_lock<std::mutex> Lock{m_TasksMtx};
+    while (true)
+    {
+        // Remaining tasks are executed even when the pool is being stopped
+        m_NextTaskCondVar.wait(Lock, [this] { return m_Stop || !m_Tasks.empty(); });
+        if (m_Tasks.empty())
+            break;
+
+        auto Task = std::move(m_Tasks.front());
+        m_Tasks.pop_front();
+        ++m_NumRunningTasks;
+
+        Lock.unlock();
+        Task();
+        // Destroy captured state before the task is reported as finished
+        Task = nullptr;
+        Lock.lock();
+
+        --m_NumRunningTasks;
+        if (m_Tasks.empty() && m_NumRunningTasks == 0)
+            m_TasksFinishedCondVar.notify_all();
+    }
+}
+
+ThreadPool& GetSharedThreadPool()
+{
+    static ThreadPool SharedPool;
+    return SharedPool;
+}
+
+} // namespace Diligent
@@ -29,6 +29,7 @@
 
 #include <cmath>
 #include "../../../Primitives/interface/BasicTypes.h"
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
@@ -57,4 +58,60 @@ inline float FastSRGBToLinear(float x)
     return x * (x * (x * 0.305306011f + 0.682171111f) + 0.012522878f);
 }
 
+/// Texture data conversion attributes, see Diligent::ConvertTextureData().
+struct TextureDataConversionAttribs
+{
+    /// Width of the region to convert, in texels.
+    Uint32 Width = 0;
+
+    /// Height of the region to convert, in texels.
+    Uint32 Height = 0;
+
+    /// Source texture format.
+    TEXTURE_FORMAT SrcFormat = TEX_FORMAT_UNKNOWN;
+
+    /// Pointer to the first texel of the source region.
+    const void* pSrcData = nullptr;
+
+    /// Source row stride, in bytes.
+    size_t SrcStride = 0;
+
+    /// Destination texture format.
+    TEXTURE_FORMAT DstFormat = TEX_FORMAT_UNKNOWN;
+
+    /// Pointer to the first texel of the destination region.
+    void* pDstData = nullptr;
+
+    /// Destination row stride, in bytes.
+    size_t DstStride = 0;
+
+    /// Index of the source component (0 - R, 1 - G, 2 - B, 3 - A) that is
+    /// written to each destination component.
+    Uint8 Swizzle[4] = {0, 1, 2, 3};
+
+    /// Whether to multiply color components by alpha.
+    bool PremultiplyAlpha = false;
+
+    /// Whether to use SIMD kernels when they are available.
+    /// If false, the scalar reference implementation is used.
+    bool UseSIMD = true;
+};
+
+/// Returns true if texture data can be converted from SrcFormat to DstFormat by ConvertTextureData().
+
+/// Conversion is supported between all uncompressed color formats with UNORM, UNORM_SRGB,
+/// SNORM and FLOAT components as well as TEX_FORMAT_RGB10A2_UNORM, TEX_FORMAT_R11G11B10_FLOAT
+/// and TEX_FORMAT_RGB9E5_SHAREDEXP. Data in any other non-compressed format can only be copied
+/// without conversion.
+bool IsTextureFormatConversionSupported(TEXTURE_FORMAT SrcFormat, TEXTURE_FORMAT DstFormat);
+
+/// Converts a region of texture data from one format to another.
+
+/// Texels are decoded to linear floating-point RGBA values: sRGB components are converted
+/// to linear space, missing color components are set to 0 and missing alpha is set to 1.
+/// The values are then swizzled, optionally premultiplied by alpha, and encoded in the
+/// destination format. Values that do not fit into the destination format are clamped,
+/// integer components are rounded to nearest.
+void ConvertTextureData(const TextureDataConversionAttribs& Attribs);
+
 DILIGENT_END_NAMESPACE // namespace Diligent
@@ -0,0 +1,263 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Implementation of Diligent::ConcurrentRingBuffer class
+
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <map>
+
+#include "../../../Primitives/interface/BasicTypes.h"
+#include "../../../Primitives/interface/MemoryAllocator.h"
+#include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../Common/interface/Align.hpp"
+#include "../../../Common/interface/STDAllocator.hpp"
+
+namespace Diligent
+{
+
+/// Thread-safe version of the RingBuffer.
+
+/// Allocate() may be called by any number of threads simultaneously and is lock-free:
+/// the head of the buffer is an ever-increasing virtual offset that is advanced with
+/// a compare-and-swap. The physical offset is the virtual offset modulo the buffer size.
+/// FinishCurrentFrame() and ReleaseCompletedFrames() have the same semantics as in RingBuffer:
+/// every finished frame records the head position together with the fence value, and
+/// releasing the frame moves the tail to that position. These methods use a mutex that
+/// allocations never take.
+///
+/// Alternatively, space allocated by AllocateRange() may be released by Free() in any order
+/// without frames. The two ways of releasing the space must not be mixed.
+///
+/// Unlike RingBuffer, the head and the tail are not moved to the beginning of the buffer
+/// when the buffer becomes empty.
+class ConcurrentRingBuffer
+{
+public:
+    using OffsetType                                = size_t;
+    static constexpr const OffsetType InvalidOffset = static_cast<OffsetType>(-1);
+
+    /// Range allocated by AllocateRange()
+    struct Range
+    {
+        /// Offset of the allocation in the buffer, or InvalidOffset
+        OffsetType Offset = InvalidOffset;
+
+        /// Aligned size of the allocation
+        OffsetType Size = 0;
+
+        /// Virtual range occupied by the allocation, including the alignment and
+        /// the space skipped at the end of the buffer
+        Uint64 VirtualBegin = 0;
+        Uint64 VirtualEnd   = 0;
+
+        bool IsValid() const { return Offset != InvalidOffset; }
+    };
+
+    ConcurrentRingBuffer(OffsetType MaxSize, IMemoryAllocator& Allocator) noexcept :
+        m_CompletedFrameHeads(STD_ALLOCATOR_RAW_MEM(FrameHeadAttribs, Allocator, "Allocator for deque<FrameHeadAttribs>")),
+        m_ReleasedRanges(STD_ALLOCATOR_RAW_MEM(TReleasedRangesMap::value_type, Allocator, "Allocator for map<Uint64, Uint64>")),
+        m_MaxSize{MaxSize}
+    {
+        DEV_CHECK_ERR(m_MaxSize > 0, "Ring buffer size must not be zero");
+    }
+
+    // clang-format off
+    ConcurrentRingBuffer             (const ConcurrentRingBuffer&) = delete;
+    ConcurrentRingBuffer             (ConcurrentRingBuffer&&)      = delete;
+    ConcurrentRingBuffer& operator = (const ConcurrentRingBuffer&) = delete;
+    ConcurrentRingBuffer& operator = (ConcurrentRingBuffer&&)      = delete;
+    // clang-format on
+
+    ~ConcurrentRingBuffer()
+    {
+        VERIFY(GetUsedSize() == 0, "All space in the ring buffer must be released");
+    }
+
+    /// Allocates space in the ring buffer. This method is thread-safe and lock-free.
+
+    /// \return Offset of the allocation, or InvalidOffset if there is not enough space.
+    OffsetType Allocate(OffsetType Size, OffsetType Alignment)
+    {
+        return AllocateRange(Size, Alignment).Offset;
+    }
+
+    /// Same as Allocate(), but also returns the virtual range that must be passed to Free().
+    Range AllocateRange(OffsetType Size, OffsetType Alignment)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Range Allocation;
+        Size = AlignUp(Size, Alignment);
+        if (Size > m_MaxSize || m_MaxSize == 0)
+            return Allocation;
+
+        auto Head = m_Head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const auto HeadOffset    = static_cast<OffsetType>(Head % m_MaxSize);
+            auto       Offset        = AlignUp(HeadOffset, Alignment);
+            auto       AllocationEnd = Head + (Offset - HeadOffset) + Size;
+            if (Offset + Size > m_MaxSize)
+            {
+                // Skip the end of the buffer and allocate from the beginning
+                //
+                // Offset              Tail          Head               MaxSize
+                //  |                  |                |<---skipped--->|
+                //  [                  xxxxxxxxxxxxxxxxx++++++++++++++++]
+                //
+                Offset        = 0;
+                AllocationEnd = Head + (m_MaxSize - HeadOffset) + Size;
+            }
+
+            // The tail only moves forward, so a stale tail can only make the check more conservative.
+            // The head, however, may be stale too: other threads may have allocated and released the
+            // space after it was loaded, so the tail may have moved past the end of the allocation.
+            const auto Tail = m_Tail.load(std::memory_order_acquire);
+            if (Tail > AllocationEnd)
+            {
+                Head = m_Head.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (AllocationEnd - Tail > m_MaxSize)
+                return Allocation;
+
+            // On failure, Head is updated with the current value
+            if (m_Head.compare_exchange_weak(Head, AllocationEnd, std::memory_order_relaxed))
+            {
+                Allocation.Offset       = Offset;
+                Allocation.Size         = Size;
+                Allocation.VirtualBegin = Head;
+                Allocation.VirtualEnd   = AllocationEnd;
+                return Allocation;
+            }
+        }
+    }
+
+    /// Releases the range allocated by AllocateRange(). Ranges may be released in any order:
+    /// the tail moves past the range once all ranges allocated before it are released.
+    void Free(const Range& Allocation)
+    {
+        VERIFY_EXPR(Allocation.IsValid());
+        std::lock_guard<std::mutex> Lock{m_TailMtx};
+        VERIFY_EXPR(m_CompletedFrameHeads.empty());
+        m_ReleasedRanges.emplace(Allocation.VirtualBegin, Allocation.VirtualEnd);
+
+        auto Tail = m_Tail.load(std::memory_order_relaxed);
+        for (auto It = m_ReleasedRanges.begin(); It != m_ReleasedRanges.end() && It->first == Tail; It = m_ReleasedRanges.erase(It))
+            Tail = It->second;
+        m_Tail.store(Tail, std::memory_order_release);
+    }
+
+    /// FenceValue is the fence value associated with the command list in which the head
+    /// could have been referenced last time.
+    /// All allocations that completed before this call belong to the finished frame.
+    void FinishCurrentFrame(Uint64 FenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_TailMtx};
+        VERIFY_EXPR(m_ReleasedRanges.empty());
+#ifdef DILIGENT_DEBUG
+        if (!m_CompletedFrameHeads.empty())
+            VERIFY(FenceValue >= m_CompletedFrameHeads.back().FenceValue, "Current frame fence value (", FenceValue, ") is lower than the fence value of the previous frame (", m_CompletedFrameHeads.back().FenceValue, ")");
+#endif
+        const auto Head = m_Head.load(std::memory_order_relaxed);
+        // Ignore zero-size frames
+        if (Head != m_LastFrameHead)
+        {
+            m_CompletedFrameHeads.emplace_back(FenceValue, Head);
+            m_LastFrameHead = Head;
+        }
+    }
+
+    /// CompletedFenceValue indicates GPU progress.
+    void ReleaseCompletedFrames(Uint64 CompletedFenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_TailMtx};
+        // We can release all heads whose associated fence value is less than or equal to CompletedFenceValue
+        while (!m_CompletedFrameHeads.empty() && m_CompletedFrameHeads.front().FenceValue <= CompletedFenceValue)
+        {
+            VERIFY_EXPR(m_CompletedFrameHeads.front().Head >= m_Tail.load(std::memory_order_relaxed));
+            m_Tail.store(m_CompletedFrameHeads.front().Head, std::memory_order_release);
+            m_CompletedFrameHeads.pop_front();
+        }
+    }
+
+    // clang-format off
+    OffsetType GetMaxSize()  const { return m_MaxSize; }
+    bool       IsFull()      const { return GetUsedSize() == m_MaxSize; }
+    bool       IsEmpty()     const { return GetUsedSize() == 0; }
+    // clang-format on
+
+    OffsetType GetUsedSize() const
+    {
+        // Load the tail first: the tail never passes the head, and the head only grows
+        const auto Tail = m_Tail.load(std::memory_order_acquire);
+        const auto Head = m_Head.load(std::memory_order_relaxed);
+        return static_cast<OffsetType>(Head - Tail);
+    }
+
+private:
+    struct FrameHeadAttribs
+    {
+        // clang-format off
+        FrameHeadAttribs(Uint64 fv, Uint64 h) noexcept :
+            FenceValue{fv},
+            Head      {h }
+        {}
+        // clang-format on
+
+        Uint64 FenceValue;
+        // Virtual offset of the head at the end of the frame
+        Uint64 Head;
+    };
+
+    // Virtual offsets that are never wrapped around
+    std::atomic<Uint64> m_Head{0};
+    std::atomic<Uint64> m_Tail{0};
+
+    // Protects the frame heads and the released ranges, and serializes tail updates
+    std::mutex m_TailMtx;
+
+    std::deque<FrameHeadAttribs, STDAllocatorRawMem<FrameHeadAttribs>> m_CompletedFrameHeads;
+    Uint64                                                             m_LastFrameHead = 0;
+
+    // Ranges released by Free() that are not adjacent to the tail: virtual begin -> virtual end
+    using TReleasedRangesMap =
+        std::map<Uint64,
+                 Uint64,
+                 std::less<Uint64>,
+                 STDAllocatorRawMem<std::pair<const Uint64, Uint64>>>;
+    TReleasedRangesMap m_ReleasedRanges;
+
+    const OffsetType m_MaxSize;
+};
+
+} // namespace Diligent
@@ -628,6 +628,64 @@ void CopyTextureSubresource(const TextureSubResData& SrcSubres,
                             Uint32                   DstRowStride,
                             Uint32                   DstDepthStride);
 
+/// Attributes of the CopyTextureSubresource() overload that supports multithreading and format conversion.
+struct CopyTextureSubresourceAttribs
+{
+    /// Source subresource data. Only pData, Stride and DepthStride members are used.
+    TextureSubResData Src;
+
+    /// The number of rows in the subresource.
+    Uint32 NumRows = 0;
+
+    /// The number of depth slices in the subresource.
+    Uint32 NumDepthSlices = 1;
+
+    /// Source data row size, in bytes.
+    Uint32 RowSize = 0;
+
+    /// Pointer to the destination subresource data.
+    void* pDstData = nullptr;
+
+    /// Destination subresource row stride, in bytes.
+    Uint32 DstRowStride = 0;
+
+    /// Destination subresource depth stride, in bytes.
+    Uint32 DstDepthStride = 0;
+
+    /// Source and destination texel formats.
+
+    /// \remarks   If the formats are different or Swizzle is not the identity, texels are converted
+    ///             by ConvertTextureData() while copying, and RowSize must be a multiple of the source
+    ///             texel size. If either format is TEX_FORMAT_UNKNOWN, the data is copied as is.
+    TEXTURE_FORMAT SrcFormat = TEX_FORMAT_UNKNOWN;
+
+    /// Destination texel format, see SrcFormat.
+    TEXTURE_FORMAT DstFormat = TEX_FORMAT_UNKNOWN;
+
+    /// Index of the source component that is written to each destination component,
+    /// see TextureDataConversionAttribs::Swizzle.
+    Uint8 Swizzle[4] = {0, 1, 2, 3};
+
+    /// The number of threads to use. 0 uses all hardware threads.
+    Uint32 NumThreads = 0;
+
+    /// The minimum number of bytes copied by one thread. Smaller copies use fewer threads.
+    Uint32 MinBytesPerThread = 1u << 20u;
+
+    /// Whether to use non-temporal stores that bypass the CPU cache.
+
+    /// \remarks   Non-temporal stores are faster for large copies to write-combined memory, e.g.
+    ///             mapped upload buffers, that is not read by the CPU afterwards. They are ignored
+    ///             when the data is converted and on platforms that do not support them.
+    bool NonTemporalStores = false;
+};
+
+/// Copies texture subresource data on the CPU, see Diligent::CopyTextureSubresourceAttribs.
+
+/// \remarks   When source and destination rows are tightly packed, the subresource is copied
+///             as a single memory block.
+void CopyTextureSubresource(const CopyTextureSubresourceAttribs& Attribs);
+
 
 inline String GetShaderResourcePrintName(const char* Name, Uint32 ArraySize, Uint32 ArrayIndex)
 {
@@ -35,9 +35,13 @@
 
 #include <mutex>
 #include <deque>
+#include <vector>
+#include <atomic>
+#include <thread>
 
 #include "../../../Primitives/interface/MemoryAllocator.h"
 #include "../../../Common/interface/STDAllocator.hpp"
+#include "../../../Common/interface/LockHelper.hpp"
 #include "../../../Platforms/interface/Atomics.hpp"
 #include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
 
@@ -216,6 +220,12 @@ private:
 ///   the command list
 /// * Resources are removed and actually destroyed from the queue when fence is signaled and the queue is Purged
 ///
+/// Stale resources are staged in a set of lists, and every releasing thread is assigned its own list,
+/// so that releasing a resource only locks an uncontended spin lock flag. The owner of the queue takes
+/// over the contents of every list by swapping it with an empty one when stale resources are discarded.
+/// Resources in the release queue are grouped into batches that share the same fence value,
+/// and Purge() releases a whole batch at once. The storage of staging lists and batches is reused.
+///
 /// \tparam ResourceWrapperType -  Type of the resource wrapper used by the release queue.
 template <typename ResourceWrapperType>
 class ResourceReleaseQueue
@@ -223,17 +233,37 @@ class ResourceReleaseQueue
 public:
     // clang-format off
     ResourceReleaseQueue(IMemoryAllocator& Allocator) :
-        m_ReleaseQueue  (STD_ALLOCATOR_RAW_MEM(ReleaseQueueElemType, Allocator, "Allocator for deque<ReleaseQueueElemType>")),
-        m_StaleResources(STD_ALLOCATOR_RAW_MEM(ReleaseQueueElemType, Allocator, "Allocator for deque<ReleaseQueueElemType>"))
-    {}
+        m_Allocator       {Allocator},
+        m_StagingLists    (STD_ALLOCATOR_RAW_MEM(StagingList,    Allocator, "Allocator for deque<StagingList>")),
+        m_StaleResources  {CreateStaleResourceVector()},
+        m_TakenResources  {CreateStaleResourceVector()},
+        m_RemainingResources{CreateStaleResourceVector()},
+        m_ReleaseQueue    (STD_ALLOCATOR_RAW_MEM(ReleaseBatch,   Allocator, "Allocator for deque<ReleaseBatch>")),
+        m_FreeBatches     (STD_ALLOCATOR_RAW_MEM(ResourceVector, Allocator, "Allocator for vector<ResourceVector>"))
+    {
+        // Use at least as many lists as there are hardware threads, so that
+        // most of the time every thread works with its own list.
+        size_t NumLists = 1;
+        while (NumLists < std::thread::hardware_concurrency() && NumLists < 64)
+            NumLists *= 2;
+        for (size_t i = 0; i < NumLists; ++i)
+            m_StagingLists.emplace_back(*this);
+    }
     // clang-format on
 
     ~ResourceReleaseQueue()
     {
-        DEV_CHECK_ERR(m_StaleResources.empty(), "Not all stale objects were destroyed");
-        DEV_CHECK_ERR(m_ReleaseQueue.empty(), "Release queue is not empty");
+        DEV_CHECK_ERR(GetStaleResourceCount() == 0, "Not all stale objects were destroyed");
+        DEV_CHECK_ERR(GetPendingReleaseResourceCount() == 0, "Release queue is not empty");
     }
 
+    // clang-format off
+    ResourceReleaseQueue             (const ResourceReleaseQueue&) = delete;
+    ResourceReleaseQueue             (ResourceReleaseQueue&&)      = delete;
+    ResourceReleaseQueue& operator = (const ResourceReleaseQueue&) = delete;
+    ResourceReleaseQueue& operator = (ResourceReleaseQueue&&)      = delete;
+    // clang-format on
+
     /// Creates a resource wrapper for the specific resource type
     /// \param [in] Resource      - Resource to be released
     /// \param [in] NumReferences - Number of references to the resource
@@ -257,8 +287,9 @@ public:
     /// \param [in] NextCommandListNumber - Number of the command list that will be submitted to the queue next
     void SafeReleaseResource(ResourceWrapperType&& Wrapper, Uint64 NextCommandListNumber)
     {
-        std::lock_guard<std::mutex> LockGuard(m_StaleObjectsMutex);
-        m_StaleResources.emplace_back(NextCommandListNumber, std::move(Wrapper));
+        auto&                      List = GetThreadStagingList();
+        ThreadingTools::LockHelper ListLock{List.Lock};
+        List.Resources.emplace_back(NextCommandListNumber, std::move(Wrapper));
     }
 
     /// Moves a copy of the resource wrapper to the stale resources queue
@@ -266,8 +297,9 @@ public:
     /// \param [in] NextCommandListNumber - Number of the command list that will be submitted to the queue next
     void SafeReleaseResource(const ResourceWrapperType& Wrapper, Uint64 NextCommandListNumber)
     {
-        std::lock_guard<std::mutex> LockGuard(m_StaleObjectsMutex);
-        m_StaleResources.emplace_back(NextCommandListNumber, Wrapper);
+        auto&                      List = GetThreadStagingList();
+        ThreadingTools::LockHelper ListLock{List.Lock};
+        List.Resources.emplace_back(NextCommandListNumber, Wrapper);
     }
 
     /// Adds a resource directly to the release queue
@@ -285,7 +317,8 @@ public:
     void DiscardResource(ResourceWrapperType&& Wrapper, Uint64 FenceValue)
     {
         std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        m_ReleaseQueue.emplace_back(FenceValue, std::move(Wrapper));
+        GetReleaseBatch(FenceValue).emplace_back(std::move(Wrapper));
+        m_NumPendingResources.fetch_add(1, std::memory_order_relaxed);
     }
 
     /// Adds a copy of the resource wrapper directly to the release queue
@@ -294,7 +327,8 @@ public:
     void DiscardResource(const ResourceWrapperType& Wrapper, Uint64 FenceValue)
     {
         std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        m_ReleaseQueue.emplace_back(FenceValue, Wrapper);
+        GetReleaseBatch(FenceValue).emplace_back(Wrapper);
+        m_NumPendingResources.fetch_add(1, std::memory_order_relaxed);
     }
 
     /// Adds multiple resources directly to the release queue
@@ -304,10 +338,14 @@ public:
     void DiscardResources(Uint64 FenceValue, IteratorType Iterator)
     {
         std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
+        ResourceVector*             pBatch = nullptr;
         ResourceType                Resource;
         while (Iterator(Resource))
         {
-            m_ReleaseQueue.emplace_back(FenceValue, CreateWrapper(std::move(Resource), 1));
+            if (pBatch == nullptr)
+                pBatch = &GetReleaseBatch(FenceValue);
+            pBatch->emplace_back(CreateWrapper(std::move(Resource), 1));
+            m_NumPendingResources.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -320,21 +358,50 @@ public:
     ///                                      is greater or equal to the fence value associated with the resource
     void DiscardStaleResources(Uint64 SubmittedCmdBuffNumber, Uint64 FenceValue)
     {
-        // Only discard these stale objects that were released before CmdBuffNumber
-        // was executed
-        std::lock_guard<std::mutex> StaleObjectsLock(m_StaleObjectsMutex);
         std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        while (!m_StaleResources.empty())
+
+        // Only discard these stale objects that were released before CmdBuffNumber
+        // was executed. Resources released by different threads are not ordered by
+        // the command list number, so every resource is checked.
+        ResourceVector* pBatch       = nullptr;
+        size_t          NumDiscarded = 0;
+
+        auto DiscardEligibleResources = [&](StaleResourceVector& Resources, StaleResourceVector& Remaining) {
+            for (auto& StaleRes : Resources)
+            {
+                if (StaleRes.first <= SubmittedCmdBuffNumber)
+                {
+                    if (pBatch == nullptr)
+                        pBatch = &GetReleaseBatch(FenceValue);
+                    pBatch->emplace_back(std::move(StaleRes.second));
+                    ++NumDiscarded;
+                }
+                else
+                {
+                    Remaining.emplace_back(std::move(StaleRes));
+                }
+            }
+            Resources.clear();
+        };
+
+        // Resources left from previous calls go first
+        DiscardEligibleResources(m_StaleResources, m_RemainingResources);
+
+        for (auto& List : m_StagingLists)
         {
-            auto& FirstStaleObj = m_StaleResources.front();
-            if (FirstStaleObj.first <= SubmittedCmdBuffNumber)
             {
-                m_ReleaseQueue.emplace_back(FenceValue, std::move(FirstStaleObj.second));
-                m_StaleResources.pop_front();
+                ThreadingTools::LockHelper ListLock{List.Lock};
+                if (List.Resources.empty())
+                    continue;
+                // m_TakenResources is empty, but retains its capacity, so the
+                // staging list does not need to grow again.
+                List.Resources.swap(m_TakenResources);
             }
-            else
-                break;
+            DiscardEligibleResources(m_TakenResources, m_RemainingResources);
         }
+        m_StaleResources.swap(m_RemainingResources);
+
+        m_NumPendingResources.fetch_add(NumDiscarded, std::memory_order_relaxed);
     }
 
 
@@ -349,33 +416,115 @@ public:
         // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
         while (!m_ReleaseQueue.empty())
         {
-            auto& FirstObj = m_ReleaseQueue.front();
-            if (FirstObj.first <= CompletedFenceValue)
-                m_ReleaseQueue.pop_front();
-            else
+            auto& FirstBatch = m_ReleaseQueue.front();
+            if (FirstBatch.FenceValue > CompletedFenceValue)
                 break;
+
+            m_NumPendingResources.fetch_sub(FirstBatch.Resources.size(), std::memory_order_relaxed);
+            FirstBatch.Resources.clear();
+            m_FreeBatches.emplace_back(std::move(FirstBatch.Resources));
+            m_ReleaseQueue.pop_front();
         }
     }
 
     /// Returns the number of stale resources
     size_t GetStaleResourceCount() const
     {
-        return m_StaleResources.size();
+        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
+
+        size_t Count = m_StaleResources.size();
+        for (auto& List : m_StagingLists)
+        {
+            ThreadingTools::LockHelper ListLock{List.Lock};
+            Count += List.Resources.size();
+        }
+        return Count;
     }
 
     /// Returns the number of resources pending release
     size_t GetPendingReleaseResourceCount() const
     {
-        return m_ReleaseQueue.size();
+        return m_NumPendingResources.load(std::memory_order_relaxed);
     }
 
 private:
-    std::mutex m_ReleaseQueueMutex;
-    using ReleaseQueueElemType = std::pair<Uint64, ResourceWrapperType>;
-    std::deque<ReleaseQueueElemType, STDAllocatorRawMem<ReleaseQueueElemType>> m_ReleaseQueue;
+    using StaleResource       = std::pair<Uint64, ResourceWrapperType>;
+    using StaleResourceVector = std::vector<StaleResource, STDAllocatorRawMem<StaleResource>>;
+    using ResourceVector      = std::vector<ResourceWrapperType, STDAllocatorRawMem<ResourceWrapperType>>;
+
+    StaleResourceVector CreateStaleResourceVector()
+    {
+        return StaleResourceVector{STD_ALLOCATOR_RAW_MEM(StaleResource, m_Allocator, "Allocator for vector<StaleResource>")};
+    }
+
+    struct StagingList
+    {
+        explicit StagingList(ResourceReleaseQueue& Queue) :
+            Resources{Queue.CreateStaleResourceVector()}
+        {}
+
+        mutable ThreadingTools::LockFlag Lock;
+
+        StaleResourceVector Resources;
+    };
+
+    StagingList& GetThreadStagingList()
+    {
+        static std::atomic<Uint32> NextThreadIndex{0};
+        // Constant-initialized thread-local variable does not require a guard check on every access
+        static thread_local Uint32 ThreadIndex = ~0u;
+        if (ThreadIndex == ~0u)
+            ThreadIndex = NextThreadIndex.fetch_add(1);
+        return m_StagingLists[ThreadIndex & (m_StagingLists.size() - 1)];
+    }
+
+    struct ReleaseBatch
+    {
+        ReleaseBatch(Uint64 _FenceValue, ResourceVector&& _Resources) :
+            FenceValue{_FenceValue},
+            Resources{std::move(_Resources)}
+        {}
+
+        Uint64         FenceValue;
+        ResourceVector Resources;
+    };
+
+    // Returns the batch that resources with the given fence value should be added to.
+    // Must be called with the release queue mutex locked.
+    ResourceVector& GetReleaseBatch(Uint64 FenceValue)
+    {
+        if (!m_ReleaseQueue.empty() && m_ReleaseQueue.back().FenceValue == FenceValue)
+            return m_ReleaseQueue.back().Resources;
+
+        if (!m_FreeBatches.empty())
+        {
+            m_ReleaseQueue.emplace_back(FenceValue, std::move(m_FreeBatches.back()));
+            m_FreeBatches.pop_back();
+        }
+        else
+        {
+            m_ReleaseQueue.emplace_back(FenceValue, ResourceVector{STD_ALLOCATOR_RAW_MEM(ResourceWrapperType, m_Allocator, "Allocator for vector<ResourceWrapperType>")});
+        }
+        return m_ReleaseQueue.back().Resources;
+    }
+
+    IMemoryAllocator& m_Allocator;
+
+    std::deque<StagingList, STDAllocatorRawMem<StagingList>> m_StagingLists;
+
+    // Everything below is protected by m_ReleaseQueueMutex
+    mutable std::mutex m_ReleaseQueueMutex;
+
+    // Stale resources taken from the staging lists that are not yet ready to be discarded
+    StaleResourceVector m_StaleResources;
+    // Temporary storage for the resources taken from a staging list
+    StaleResourceVector m_TakenResources;
+    // Temporary storage for the resources that remain stale after DiscardStaleResources()
+    StaleResourceVector m_RemainingResources;
 
-    std::mutex                                                                 m_StaleObjectsMutex;
-    std::deque<ReleaseQueueElemType, STDAllocatorRawMem<ReleaseQueueElemType>> m_StaleResources;
+    std::deque<ReleaseBatch, STDAllocatorRawMem<ReleaseBatch>>      m_ReleaseQueue;
+    std::vector<ResourceVector, STDAllocatorRawMem<ResourceVector>> m_FreeBatches;
+    std::atomic<size_t>                                             m_NumPendingResources{0};
 };
 
 } // namespace Diligent
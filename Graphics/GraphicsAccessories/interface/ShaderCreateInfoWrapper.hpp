@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::ShaderCreateInfoWrapper class
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../../GraphicsEngine/interface/Shader.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Deep copy of the shader create info that can outlive the original structure.
+
+/// The wrapper copies all strings, macros and byte code, and keeps a strong reference
+/// to the shader source stream factory. It is used to compile the shader after the
+/// CreateShader() call has returned.
+///
+/// \note   ppConversionStream and ppCompilerOutput point to the memory owned by the caller
+///         and are always null in the copy.
+class ShaderCreateInfoWrapper
+{
+public:
+    explicit ShaderCreateInfoWrapper(const ShaderCreateInfo& ShaderCI);
+
+    // clang-format off
+    ShaderCreateInfoWrapper           (const ShaderCreateInfoWrapper&)  = delete;
+    ShaderCreateInfoWrapper           (      ShaderCreateInfoWrapper&&) = delete;
+    ShaderCreateInfoWrapper& operator=(const ShaderCreateInfoWrapper&)  = delete;
+    ShaderCreateInfoWrapper& operator=(      ShaderCreateInfoWrapper&&) = delete;
+    // clang-format on
+
+    const ShaderCreateInfo& Get() const { return m_CreateInfo; }
+
+    operator const ShaderCreateInfo&() const { return m_CreateInfo; }
+
+private:
+    const Char* CopyString(const Char* Str);
+
+    ShaderCreateInfo m_CreateInfo;
+
+    // Deque never relocates its elements, so pointers to the strings remain valid
+    std::deque<std::string>  m_Strings;
+    std::vector<ShaderMacro> m_Macros;
+    std::vector<Uint8>       m_ByteCode;
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> m_pSourceStreamFactory;
+};
+
+} // namespace Diligent
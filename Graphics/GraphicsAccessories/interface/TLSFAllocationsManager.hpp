@@ -0,0 +1,726 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+// Helper class that handles free memory block management to accommodate variable-size allocation requests
+// using two-level segregated fit (TLSF) free lists.
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "../../../Primitives/interface/MemoryAllocator.h"
+#include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../Platforms/interface/PlatformMisc.hpp"
+#include "../../../Common/interface/Align.hpp"
+#include "../../../Common/interface/STDAllocator.hpp"
+#include "VariableSizeAllocationsManager.hpp"
+
+namespace Diligent
+{
+
+// The class is a drop-in replacement for VariableSizeAllocationsManager that implements
+// allocation and deallocation in constant time.
+//
+// All blocks (free and allocated) are kept in an intrusive doubly-linked list sorted by offset (boundary tags),
+// which allows merging a released block with its neighbors without searching.
+// Free blocks are additionally linked into segregated lists, one per size class. The size class is defined by
+// the first level index (the position of the most significant bit of the size) and the second level index
+// (the next SLIndexCountLog2 bits of the size). Two levels of bitmaps indicate which lists are not empty,
+// so that a suitable list is found with two bit scans:
+//
+//      m_FLBitmap     0 0 1 0 1 ...
+//                         |   |
+//   m_SLBitmaps[fl]       |   '--> 0 1 0 0 ... 0
+//                         |          |
+//                         '--> 1 0 0 0 ... 1   '--> m_FreeLists[fl][sl] --> Block --> Block
+//
+// Block descriptions are kept in a single array and reference each other by index. Allocated blocks are
+// found by their offset through an open-addressing hash table. Neither the array nor the table allocate
+// memory unless the number of blocks exceeds the capacity reserved at construction.
+//
+// Like VariableSizeAllocationsManager, the class keeps all free block offsets aligned by the current alignment,
+// which allows reserving the minimal amount of extra space for aligned allocations.
+class TLSFAllocationsManager
+{
+public:
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+    using Allocation = VariableSizeAllocationsManager::Allocation;
+
+private:
+    using IndexType = Uint32;
+
+    static constexpr IndexType InvalidIndex = ~IndexType{0};
+
+    static constexpr Uint32 SLIndexCountLog2 = 4;
+    static constexpr Uint32 SLIndexCount     = 1u << SLIndexCountLog2;
+    static constexpr Uint32 FLIndexCount     = sizeof(OffsetType) * 8 - SLIndexCountLog2 + 1;
+
+    struct BlockInfo
+    {
+        OffsetType Offset = 0;
+        OffsetType Size   = 0;
+
+        // Neighbors in the list of all blocks sorted by offset
+        IndexType PrevPhysical = InvalidIndex;
+        IndexType NextPhysical = InvalidIndex;
+
+        // Neighbors in the segregated free list. For unused block descriptions,
+        // NextFree references the next unused description.
+        IndexType PrevFree = InvalidIndex;
+        IndexType NextFree = InvalidIndex;
+
+        bool IsFree = false;
+    };
+
+    struct AllocatedBlockSlot
+    {
+        OffsetType Offset = 0;
+        IndexType  Block  = InvalidIndex;
+    };
+
+public:
+    // ExpectedMaxAllocations is the number of allocations the manager reserves space for.
+    // As long as the number of allocations does not exceed this value, the manager does not allocate memory.
+    TLSFAllocationsManager(OffsetType MaxSize, IMemoryAllocator& Allocator, size_t ExpectedMaxAllocations = 0) :
+        m_Blocks(STD_ALLOCATOR_RAW_MEM(BlockInfo, Allocator, "Allocator for vector<BlockInfo>")),
+        m_AllocatedBlocks(STD_ALLOCATOR_RAW_MEM(AllocatedBlockSlot, Allocator, "Allocator for vector<AllocatedBlockSlot>")),
+        m_MaxSize(MaxSize),
+        m_FreeSize(MaxSize)
+    {
+        for (auto& FreeLists : m_FreeLists)
+        {
+            for (auto& FirstBlock : FreeLists)
+                FirstBlock = InvalidIndex;
+        }
+
+        // Every allocation may split a free block in two
+        m_Blocks.reserve(ExpectedMaxAllocations * 2 + 1);
+        if (ExpectedMaxAllocations > 0)
+            m_AllocatedBlocks.resize(GetAllocatedBlockTableSize(ExpectedMaxAllocations));
+
+        if (m_MaxSize > 0)
+        {
+            // Insert single maximum-size block
+            auto BlockIdx        = CreateBlock(0, m_MaxSize);
+            m_FirstPhysicalBlock = BlockIdx;
+            m_LastPhysicalBlock  = BlockIdx;
+            InsertFreeBlock(BlockIdx);
+        }
+        ResetCurrAlignment();
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBlocks();
+#endif
+    }
+
+    ~TLSFAllocationsManager()
+    {
+#ifdef DILIGENT_DEBUG
+        if (m_FirstPhysicalBlock != InvalidIndex)
+        {
+            VERIFY(m_NumAllocatedBlocks == 0, "Not all allocations have been released");
+            VERIFY(m_NumFreeBlocks == 1, "Single free block is expected");
+            const auto& Block = m_Blocks[m_FirstPhysicalBlock];
+            VERIFY(Block.Offset == 0, "Head chunk offset is expected to be 0");
+            VERIFY(Block.Size == m_MaxSize, "Head chunk size is expected to be ", m_MaxSize);
+            VERIFY(Block.IsFree, "Head chunk is expected to be free");
+        }
+#endif
+    }
+
+    // clang-format off
+    TLSFAllocationsManager(TLSFAllocationsManager&& rhs) noexcept :
+        m_Blocks            {std::move(rhs.m_Blocks)         },
+        m_AllocatedBlocks   {std::move(rhs.m_AllocatedBlocks)},
+        m_FirstUnusedBlock  {rhs.m_FirstUnusedBlock  },
+        m_FirstPhysicalBlock{rhs.m_FirstPhysicalBlock},
+        m_LastPhysicalBlock {rhs.m_LastPhysicalBlock },
+        m_FLBitmap          {rhs.m_FLBitmap          },
+        m_NumFreeBlocks     {rhs.m_NumFreeBlocks     },
+        m_NumAllocatedBlocks{rhs.m_NumAllocatedBlocks},
+        m_MaxSize           {rhs.m_MaxSize           },
+        m_FreeSize          {rhs.m_FreeSize          },
+        m_CurrAlignment     {rhs.m_CurrAlignment     }
+    {
+        // clang-format on
+        memcpy(m_SLBitmaps, rhs.m_SLBitmaps, sizeof(m_SLBitmaps));
+        memcpy(m_FreeLists, rhs.m_FreeLists, sizeof(m_FreeLists));
+
+        rhs.m_FirstUnusedBlock   = InvalidIndex;
+        rhs.m_FirstPhysicalBlock = InvalidIndex;
+        rhs.m_LastPhysicalBlock  = InvalidIndex;
+        rhs.m_FLBitmap           = 0;
+        rhs.m_NumFreeBlocks      = 0;
+        rhs.m_NumAllocatedBlocks = 0;
+        rhs.m_MaxSize            = 0;
+        rhs.m_FreeSize           = 0;
+        rhs.m_CurrAlignment      = 0;
+    }
+
+    TLSFAllocationsManager& operator=(TLSFAllocationsManager&& rhs) noexcept
+    {
+        if (this == &rhs)
+            return *this;
+
+        m_Blocks             = std::move(rhs.m_Blocks);
+        m_AllocatedBlocks    = std::move(rhs.m_AllocatedBlocks);
+        m_FirstUnusedBlock   = rhs.m_FirstUnusedBlock;
+        m_FirstPhysicalBlock = rhs.m_FirstPhysicalBlock;
+        m_LastPhysicalBlock  = rhs.m_LastPhysicalBlock;
+        m_FLBitmap           = rhs.m_FLBitmap;
+        m_NumFreeBlocks      = rhs.m_NumFreeBlocks;
+        m_NumAllocatedBlocks = rhs.m_NumAllocatedBlocks;
+        m_MaxSize            = rhs.m_MaxSize;
+        m_FreeSize           = rhs.m_FreeSize;
+        m_CurrAlignment      = rhs.m_CurrAlignment;
+        memcpy(m_SLBitmaps, rhs.m_SLBitmaps, sizeof(m_SLBitmaps));
+        memcpy(m_FreeLists, rhs.m_FreeLists, sizeof(m_FreeLists));
+
+        rhs.m_FirstUnusedBlock   = InvalidIndex;
+        rhs.m_FirstPhysicalBlock = InvalidIndex;
+        rhs.m_LastPhysicalBlock  = InvalidIndex;
+        rhs.m_FLBitmap           = 0;
+        rhs.m_NumFreeBlocks      = 0;
+        rhs.m_NumAllocatedBlocks = 0;
+        rhs.m_MaxSize            = 0;
+        rhs.m_FreeSize           = 0;
+        rhs.m_CurrAlignment      = 0;
+
+        return *this;
+    }
+
+    // clang-format off
+    TLSFAllocationsManager             (const TLSFAllocationsManager&) = delete;
+    TLSFAllocationsManager& operator = (const TLSFAllocationsManager&) = delete;
+    // clang-format on
+
+    Allocation Allocate(OffsetType Size, OffsetType Alignment)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size = AlignUp(Size, Alignment);
+        if (m_FreeSize < Size)
+            return Allocation::InvalidAllocation();
+
+        auto AlignmentReserve = (Alignment > m_CurrAlignment) ? Alignment - m_CurrAlignment : 0;
+
+        auto BlockIdx = FindFreeBlock(Size + AlignmentReserve);
+        if (BlockIdx == InvalidIndex)
+            return Allocation::InvalidAllocation();
+
+        RemoveFreeBlock(BlockIdx);
+
+        //     Block.Offset
+        //        |                                  |
+        //        |<-----------Block.Size----------->|
+        //        |<------Size------>|<---NewSize--->|
+        //        |                  |
+        //      Offset              NewOffset
+        //
+        const auto Offset = m_Blocks[BlockIdx].Offset;
+        VERIFY_EXPR(Offset % m_CurrAlignment == 0);
+        auto AlignedOffset = AlignUp(Offset, Alignment);
+        auto AdjustedSize  = Size + (AlignedOffset - Offset);
+        VERIFY_EXPR(AdjustedSize <= Size + AlignmentReserve && AdjustedSize <= m_Blocks[BlockIdx].Size);
+        auto NewSize = m_Blocks[BlockIdx].Size - AdjustedSize;
+        if (NewSize > 0)
+        {
+            // Note that creating the block may invalidate references to the elements of m_Blocks
+            auto NewBlockIdx = CreateBlock(Offset + AdjustedSize, NewSize);
+
+            auto& Block    = m_Blocks[BlockIdx];
+            auto& NewBlock = m_Blocks[NewBlockIdx];
+            Block.Size     = AdjustedSize;
+
+            NewBlock.PrevPhysical = BlockIdx;
+            NewBlock.NextPhysical = Block.NextPhysical;
+            if (Block.NextPhysical != InvalidIndex)
+                m_Blocks[Block.NextPhysical].PrevPhysical = NewBlockIdx;
+            else
+                m_LastPhysicalBlock = NewBlockIdx;
+            Block.NextPhysical = NewBlockIdx;
+
+            InsertFreeBlock(NewBlockIdx);
+        }
+
+        InsertAllocatedBlock(BlockIdx);
+
+        m_FreeSize -= AdjustedSize;
+
+        if ((Size & (m_CurrAlignment - 1)) != 0)
+        {
+            if (IsPowerOfTwo(Size))
+            {
+                VERIFY_EXPR(Size >= Alignment && Size < m_CurrAlignment);
+                m_CurrAlignment = Size;
+            }
+            else
+            {
+                m_CurrAlignment = std::min(m_CurrAlignment, Alignment);
+            }
+        }
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBlocks();
+#endif
+        return Allocation{Offset, AdjustedSize};
+    }
+
+    void Free(Allocation&& allocation)
+    {
+        VERIFY_EXPR(allocation.IsValid());
+        Free(allocation.UnalignedOffset, allocation.Size);
+        allocation = Allocation{};
+    }
+
+    void Free(OffsetType Offset, OffsetType Size)
+    {
+        VERIFY_EXPR(Offset != Allocation::InvalidOffset && Offset + Size <= m_MaxSize);
+
+        auto BlockIdx = RemoveAllocatedBlock(Offset);
+        if (BlockIdx == InvalidIndex)
+        {
+            UNEXPECTED("Block at offset ", Offset, " is not allocated - double freeing memory?");
+            return;
+        }
+        VERIFY(m_Blocks[BlockIdx].Size == Size, "The size of the block being released (", Size,
+               ") does not match the allocation size (", m_Blocks[BlockIdx].Size, ")");
+
+        auto PrevBlockIdx = m_Blocks[BlockIdx].PrevPhysical;
+        if (PrevBlockIdx != InvalidIndex && m_Blocks[PrevBlockIdx].IsFree)
+        {
+            //  PrevBlock.Offset             Offset
+            //       |                          |
+            //       |<-----PrevBlock.Size----->|<------Size-------->|
+            //
+            RemoveFreeBlock(PrevBlockIdx);
+            MergeWithNextBlock(PrevBlockIdx);
+            BlockIdx = PrevBlockIdx;
+        }
+
+        auto NextBlockIdx = m_Blocks[BlockIdx].NextPhysical;
+        if (NextBlockIdx != InvalidIndex && m_Blocks[NextBlockIdx].IsFree)
+        {
+            //   Offset            NextBlock.Offset
+            //     |                    |
+            //     |<------Size-------->|<-----NextBlock.Size----->|
+            //
+            RemoveFreeBlock(NextBlockIdx);
+            MergeWithNextBlock(BlockIdx);
+        }
+
+        InsertFreeBlock(BlockIdx);
+
+        m_FreeSize += Size;
+        if (IsEmpty())
+        {
+            // Reset current alignment
+            VERIFY_EXPR(GetNumFreeBlocks() == 1);
+            ResetCurrAlignment();
+        }
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBlocks();
+#endif
+    }
+
+    // clang-format off
+    bool IsFull() const{ return m_FreeSize==0; };
+    bool IsEmpty()const{ return m_FreeSize==m_MaxSize; };
+    OffsetType GetMaxSize() const{return m_MaxSize;}
+    OffsetType GetFreeSize()const{return m_FreeSize;}
+    OffsetType GetUsedSize()const{return m_MaxSize - m_FreeSize;}
+    // clang-format on
+
+    size_t GetNumFreeBlocks() const
+    {
+        return m_NumFreeBlocks;
+    }
+
+    void Extend(size_t ExtraSize)
+    {
+        if (m_LastPhysicalBlock != InvalidIndex && m_Blocks[m_LastPhysicalBlock].IsFree)
+        {
+            // Extend the last block
+            RemoveFreeBlock(m_LastPhysicalBlock);
+            m_Blocks[m_LastPhysicalBlock].Size += ExtraSize;
+            InsertFreeBlock(m_LastPhysicalBlock);
+        }
+        else
+        {
+            auto NewBlockIdx = CreateBlock(m_MaxSize, ExtraSize);
+
+            m_Blocks[NewBlockIdx].PrevPhysical = m_LastPhysicalBlock;
+            if (m_LastPhysicalBlock != InvalidIndex)
+                m_Blocks[m_LastPhysicalBlock].NextPhysical = NewBlockIdx;
+            else
+                m_FirstPhysicalBlock = NewBlockIdx;
+            m_LastPhysicalBlock = NewBlockIdx;
+
+            InsertFreeBlock(NewBlockIdx);
+        }
+
+        m_MaxSize += ExtraSize;
+        m_FreeSize += ExtraSize;
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBlocks();
+#endif
+    }
+
+private:
+    // Returns the size class of the block of the given size
+    static void GetSizeClass(OffsetType Size, Uint32& FLIndex, Uint32& SLIndex)
+    {
+        if (Size < SLIndexCount)
+        {
+            // Small blocks are stored in the first-level list, one second-level list per size
+            FLIndex = 0;
+            SLIndex = static_cast<Uint32>(Size);
+        }
+        else
+        {
+            const auto MSB = PlatformMisc::GetMSB(Uint64{Size});
+            FLIndex        = MSB - SLIndexCountLog2 + 1;
+            SLIndex        = static_cast<Uint32>(Size >> (MSB - SLIndexCountLog2)) ^ SLIndexCount;
+        }
+        VERIFY_EXPR(FLIndex < FLIndexCount && SLIndex < SLIndexCount);
+    }
+
+    // Finds the free block that is at least Size bytes large
+    IndexType FindFreeBlock(OffsetType Size) const
+    {
+        Uint32 FLIndex = 0, SLIndex = 0;
+        {
+            // Round the size up to the next size class so that any block in the first
+            // non-empty list is large enough (good fit).
+            auto RoundedSize = Size;
+            if (Size >= SLIndexCount)
+            {
+                const auto MSB = PlatformMisc::GetMSB(Uint64{Size});
+                RoundedSize += (OffsetType{1} << (MSB - SLIndexCountLog2)) - 1;
+            }
+
+            if (RoundedSize >= Size)
+            {
+                GetSizeClass(RoundedSize, FLIndex, SLIndex);
+
+                auto SLBitmap = m_SLBitmaps[FLIndex] & (~Uint32{0} << SLIndex);
+                if (SLBitmap == 0)
+                {
+                    const auto FLBitmap = FLIndex + 1 < 64 ? m_FLBitmap & (~Uint64{0} << (FLIndex + 1)) : 0;
+                    if (FLBitmap != 0)
+                    {
+                        FLIndex  = PlatformMisc::GetLSB(FLBitmap);
+                        SLBitmap = m_SLBitmaps[FLIndex];
+                        VERIFY_EXPR(SLBitmap != 0);
+                    }
+                }
+
+                if (SLBitmap != 0)
+                {
+                    SLIndex = PlatformMisc::GetLSB(SLBitmap);
+                    VERIFY_EXPR(m_FreeLists[FLIndex][SLIndex] != InvalidIndex);
+                    VERIFY_EXPR(m_Blocks[m_FreeLists[FLIndex][SLIndex]].Size >= Size);
+                    return m_FreeLists[FLIndex][SLIndex];
+                }
+            }
+        }
+
+        // All larger size classes are empty, but blocks in the size class of the
+        // requested size may still be large enough.
+        GetSizeClass(Size, FLIndex, SLIndex);
+        for (auto BlockIdx = m_FreeLists[FLIndex][SLIndex]; BlockIdx != InvalidIndex; BlockIdx = m_Blocks[BlockIdx].NextFree)
+        {
+            if (m_Blocks[BlockIdx].Size >= Size)
+                return BlockIdx;
+        }
+
+        return InvalidIndex;
+    }
+
+    void InsertFreeBlock(IndexType BlockIdx)
+    {
+        auto& Block = m_Blocks[BlockIdx];
+        VERIFY_EXPR(!Block.IsFree && Block.Size > 0);
+
+        Uint32 FLIndex = 0, SLIndex = 0;
+        GetSizeClass(Block.Size, FLIndex, SLIndex);
+
+        auto& FirstBlockIdx = m_FreeLists[FLIndex][SLIndex];
+        Block.IsFree        = true;
+        Block.PrevFree      = InvalidIndex;
+        Block.NextFree      = FirstBlockIdx;
+        if (FirstBlockIdx != InvalidIndex)
+            m_Blocks[FirstBlockIdx].PrevFree = BlockIdx;
+        FirstBlockIdx = BlockIdx;
+
+        m_FLBitmap |= Uint64{1} << FLIndex;
+        m_SLBitmaps[FLIndex] |= 1u << SLIndex;
+        ++m_NumFreeBlocks;
+    }
+
+    void RemoveFreeBlock(IndexType BlockIdx)
+    {
+        auto& Block = m_Blocks[BlockIdx];
+        VERIFY_EXPR(Block.IsFree);
+
+        Uint32 FLIndex = 0, SLIndex = 0;
+        GetSizeClass(Block.Size, FLIndex, SLIndex);
+
+        if (Block.PrevFree != InvalidIndex)
+            m_Blocks[Block.PrevFree].NextFree = Block.NextFree;
+        if (Block.NextFree != InvalidIndex)
+            m_Blocks[Block.NextFree].PrevFree = Block.PrevFree;
+
+        auto& FirstBlockIdx = m_FreeLists[FLIndex][SLIndex];
+        if (FirstBlockIdx == BlockIdx)
+        {
+            VERIFY_EXPR(Block.PrevFree == InvalidIndex);
+            FirstBlockIdx = Block.NextFree;
+            if (FirstBlockIdx == InvalidIndex)
+            {
+                m_SLBitmaps[FLIndex] &= ~(1u << SLIndex);
+                if (m_SLBitmaps[FLIndex] == 0)
+                    m_FLBitmap &= ~(Uint64{1} << FLIndex);
+            }
+        }
+
+        Block.IsFree   = false;
+        Block.PrevFree = InvalidIndex;
+        Block.NextFree = InvalidIndex;
+        VERIFY_EXPR(m_NumFreeBlocks > 0);
+        --m_NumFreeBlocks;
+    }
+
+    // Merges the block with its physical successor and releases the successor's description
+    void MergeWithNextBlock(IndexType BlockIdx)
+    {
+        auto& Block        = m_Blocks[BlockIdx];
+        auto  NextBlockIdx = Block.NextPhysical;
+        VERIFY_EXPR(NextBlockIdx != InvalidIndex);
+        auto& NextBlock = m_Blocks[NextBlockIdx];
+        VERIFY_EXPR(!Block.IsFree && !NextBlock.IsFree);
+        VERIFY_EXPR(Block.Offset + Block.Size == NextBlock.Offset);
+
+        Block.Size += NextBlock.Size;
+        Block.NextPhysical = NextBlock.NextPhysical;
+        if (NextBlock.NextPhysical != InvalidIndex)
+            m_Blocks[NextBlock.NextPhysical].PrevPhysical = BlockIdx;
+        else
+            m_LastPhysicalBlock = BlockIdx;
+
+        ReleaseBlock(NextBlockIdx);
+    }
+
+    IndexType CreateBlock(OffsetType Offset, OffsetType Size)
+    {
+        IndexType BlockIdx = m_FirstUnusedBlock;
+        if (BlockIdx != InvalidIndex)
+        {
+            m_FirstUnusedBlock = m_Blocks[BlockIdx].NextFree;
+            m_Blocks[BlockIdx] = BlockInfo{};
+        }
+        else
+        {
+            VERIFY(m_Blocks.size() < InvalidIndex, "Too many blocks");
+            BlockIdx = static_cast<IndexType>(m_Blocks.size());
+            m_Blocks.emplace_back();
+        }
+
+        auto& Block  = m_Blocks[BlockIdx];
+        Block.Offset = Offset;
+        Block.Size   = Size;
+        return BlockIdx;
+    }
+
+    void ReleaseBlock(IndexType BlockIdx)
+    {
+        auto& Block        = m_Blocks[BlockIdx];
+        Block              = BlockInfo{};
+        Block.NextFree     = m_FirstUnusedBlock;
+        m_FirstUnusedBlock = BlockIdx;
+    }
+
+    static size_t GetAllocatedBlockTableSize(size_t NumAllocations)
+    {
+        // Keep the load factor below 1/2
+        size_t TableSize = 16;
+        while (TableSize < NumAllocations * 2)
+            TableSize *= 2;
+        return TableSize;
+    }
+
+    static size_t HashOffset(OffsetType Offset)
+    {
+        // Fibonacci hashing
+        const auto Hash = static_cast<Uint64>(Offset) * Uint64{0x9E3779B97F4A7C15};
+        return static_cast<size_t>(Hash ^ (Hash >> 32));
+    }
+
+    void InsertAllocatedBlock(IndexType BlockIdx)
+    {
+        if (m_AllocatedBlocks.size() < GetAllocatedBlockTableSize(m_NumAllocatedBlocks + 1))
+        {
+            // Rehash the table
+            auto Slots = std::move(m_AllocatedBlocks);
+            m_AllocatedBlocks.clear();
+            m_AllocatedBlocks.resize(GetAllocatedBlockTableSize(m_NumAllocatedBlocks + 1) * 2);
+            m_NumAllocatedBlocks = 0;
+            for (const auto& Slot : Slots)
+            {
+                if (Slot.Block != InvalidIndex)
+                    InsertAllocatedBlock(Slot.Block);
+            }
+        }
+
+        const auto Mask   = m_AllocatedBlocks.size() - 1;
+        const auto Offset = m_Blocks[BlockIdx].Offset;
+
+        auto Pos = HashOffset(Offset) & Mask;
+        while (m_AllocatedBlocks[Pos].Block != InvalidIndex)
+        {
+            VERIFY(m_AllocatedBlocks[Pos].Offset != Offset, "Offset ", Offset, " is already allocated");
+            Pos = (Pos + 1) & Mask;
+        }
+        m_AllocatedBlocks[Pos].Offset = Offset;
+        m_AllocatedBlocks[Pos].Block  = BlockIdx;
+        ++m_NumAllocatedBlocks;
+    }
+
+    IndexType RemoveAllocatedBlock(OffsetType Offset)
+    {
+        if (m_AllocatedBlocks.empty())
+            return InvalidIndex;
+
+        const auto Mask = m_AllocatedBlocks.size() - 1;
+
+        auto Pos = HashOffset(Offset) & Mask;
+        while (m_AllocatedBlocks[Pos].Block != InvalidIndex && m_AllocatedBlocks[Pos].Offset != Offset)
+            Pos = (Pos + 1) & Mask;
+
+        const auto BlockIdx = m_AllocatedBlocks[Pos].Block;
+        if (BlockIdx == InvalidIndex)
+            return InvalidIndex;
+
+        // Backward-shift deletion: move subsequent entries of the probe sequence
+        // into the vacated slot so that no tombstones are needed.
+        m_AllocatedBlocks[Pos] = AllocatedBlockSlot{};
+        for (auto NextPos = (Pos + 1) & Mask; m_AllocatedBlocks[NextPos].Block != InvalidIndex; NextPos = (NextPos + 1) & Mask)
+        {
+            const auto HomePos = HashOffset(m_AllocatedBlocks[NextPos].Offset) & Mask;
+            // Check if the home position of the entry lies cyclically in (Pos, NextPos]
+            const auto IsInRange = (Pos <= NextPos) ?
+                (Pos < HomePos && HomePos <= NextPos) :
+                (Pos < HomePos || HomePos <= NextPos);
+            if (!IsInRange)
+            {
+                m_AllocatedBlocks[Pos]     = m_AllocatedBlocks[NextPos];
+                m_AllocatedBlocks[NextPos] = AllocatedBlockSlot{};
+                Pos                        = NextPos;
+            }
+        }
+
+        VERIFY_EXPR(m_NumAllocatedBlocks > 0);
+        --m_NumAllocatedBlocks;
+        return BlockIdx;
+    }
+
+    void ResetCurrAlignment()
+    {
+        for (m_CurrAlignment = 1; m_CurrAlignment * 2 <= m_MaxSize; m_CurrAlignment *= 2)
+        {}
+    }
+
+#ifdef DILIGENT_DEBUG
+    void DbgVerifyBlocks()
+    {
+        VERIFY_EXPR(IsPowerOfTwo(m_CurrAlignment));
+
+        OffsetType TotalFreeSize     = 0;
+        size_t     NumFreeBlocks     = 0;
+        size_t     NumAllocatedBlock = 0;
+        OffsetType ExpectedOffset    = 0;
+
+        auto PrevBlockIdx = InvalidIndex;
+        for (auto BlockIdx = m_FirstPhysicalBlock; BlockIdx != InvalidIndex; BlockIdx = m_Blocks[BlockIdx].NextPhysical)
+        {
+            const auto& Block = m_Blocks[BlockIdx];
+            VERIFY(Block.Offset == ExpectedOffset, "Gaps or overlaps between blocks detected");
+            VERIFY_EXPR(Block.PrevPhysical == PrevBlockIdx);
+            VERIFY_EXPR(Block.Size > 0);
+            if (Block.IsFree)
+            {
+                VERIFY((Block.Offset & (m_CurrAlignment - 1)) == 0, "Block offset (", Block.Offset, ") is not ", m_CurrAlignment, "-aligned");
+                VERIFY(PrevBlockIdx == InvalidIndex || !m_Blocks[PrevBlockIdx].IsFree, "Unmerged adjacent free blocks detected");
+                TotalFreeSize += Block.Size;
+                ++NumFreeBlocks;
+
+                Uint32 FLIndex = 0, SLIndex = 0;
+                GetSizeClass(Block.Size, FLIndex, SLIndex);
+                VERIFY_EXPR((m_FLBitmap & (Uint64{1} << FLIndex)) != 0);
+                VERIFY_EXPR((m_SLBitmaps[FLIndex] & (1u << SLIndex)) != 0);
+            }
+            else
+            {
+                ++NumAllocatedBlock;
+            }
+
+            ExpectedOffset += Block.Size;
+            PrevBlockIdx = BlockIdx;
+        }
+        VERIFY_EXPR(PrevBlockIdx == m_LastPhysicalBlock);
+        VERIFY_EXPR(ExpectedOffset == m_MaxSize);
+        VERIFY_EXPR(TotalFreeSize == m_FreeSize);
+        VERIFY_EXPR(NumFreeBlocks == m_NumFreeBlocks);
+        VERIFY_EXPR(NumAllocatedBlock == m_NumAllocatedBlocks);
+    }
+#endif
+
+    std::vector<BlockInfo, STDAllocatorRawMem<BlockInfo>>                   m_Blocks;
+    std::vector<AllocatedBlockSlot, STDAllocatorRawMem<AllocatedBlockSlot>> m_AllocatedBlocks;
+
+    IndexType m_FirstUnusedBlock   = InvalidIndex;
+    IndexType m_FirstPhysicalBlock = InvalidIndex;
+    IndexType m_LastPhysicalBlock  = InvalidIndex;
+
+    Uint64    m_FLBitmap                = 0;
+    Uint32    m_SLBitmaps[FLIndexCount] = {};
+    IndexType m_FreeLists[FLIndexCount][SLIndexCount];
+
+    size_t m_NumFreeBlocks      = 0;
+    size_t m_NumAllocatedBlocks = 0;
+
+    OffsetType m_MaxSize       = 0;
+    OffsetType m_FreeSize      = 0;
+    OffsetType m_CurrAlignment = 0;
+    // When adding new members, do not forget to update move ctor
+};
+
+} // namespace Diligent
@@ -204,48 +204,39 @@ public:
         auto SmallestBlockIt = SmallestBlockItIt->second;
         VERIFY_EXPR(Size + AlignmentReserve <= SmallestBlockIt->second.Size);
         VERIFY_EXPR(SmallestBlockIt->second.Size == SmallestBlockItIt->first);
-
-        //     SmallestBlockIt.Offset
-        //        |                                  |
-        //        |<------SmallestBlockIt.Size------>|
-        //        |<------Size------>|<---NewSize--->|
-        //        |                  |
-        //      Offset              NewOffset
-        //
-        auto Offset = SmallestBlockIt->first;
-        VERIFY_EXPR(Offset % m_CurrAlignment == 0);
-        auto AlignedOffset = AlignUp(Offset, Alignment);
-        auto AdjustedSize  = Size + (AlignedOffset - Offset);
-        VERIFY_EXPR(AdjustedSize <= Size + AlignmentReserve);
-        auto NewOffset = Offset + AdjustedSize;
-        auto NewSize   = SmallestBlockIt->second.Size - AdjustedSize;
         VERIFY_EXPR(SmallestBlockItIt == SmallestBlockIt->second.OrderBySizeIt);
-        m_FreeBlocksBySize.erase(SmallestBlockItIt);
-        m_FreeBlocksByOffset.erase(SmallestBlockIt);
-        if (NewSize > 0)
-        {
-            AddNewBlock(NewOffset, NewSize);
-        }
 
-        m_FreeSize -= AdjustedSize;
+        return AllocateFromBlock(SmallestBlockIt, Size, Alignment);
+    }
 
-        if ((Size & (m_CurrAlignment - 1)) != 0)
+    // Allocates the block at the lowest possible offset such that the aligned allocation ends
+    // no further than EndOffset. Only free blocks that are large enough to hold the allocation
+    // are examined; they are found through the size-ordered map. The method is intended for
+    // defragmentation, where an existing allocation is relocated to the free space below it
+    // (EndOffset being the offset of the allocation).
+    Allocation AllocateBelow(OffsetType Size, OffsetType Alignment, OffsetType EndOffset)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size = AlignUp(Size, Alignment);
+        if (m_FreeSize < Size || GetFirstFreeOffset() >= EndOffset)
+            return Allocation::InvalidAllocation();
+
+        auto BestBlockIt = m_FreeBlocksByOffset.end();
+        for (auto SizeIt = m_FreeBlocksBySize.lower_bound(Size); SizeIt != m_FreeBlocksBySize.end(); ++SizeIt)
         {
-            if (IsPowerOfTwo(Size))
-            {
-                VERIFY_EXPR(Size >= Alignment && Size < m_CurrAlignment);
-                m_CurrAlignment = Size;
-            }
-            else
-            {
-                m_CurrAlignment = std::min(m_CurrAlignment, Alignment);
-            }
+            const auto BlockIt = SizeIt->second;
+            if (BlockIt->first >= EndOffset || (BestBlockIt != m_FreeBlocksByOffset.end() && BlockIt->first >= BestBlockIt->first))
+                continue;
+
+            const auto AlignedOffset = AlignUp(BlockIt->first, Alignment);
+            if (AlignedOffset + Size <= std::min(BlockIt->first + BlockIt->second.Size, EndOffset))
+                BestBlockIt = BlockIt;
         }
 
-#ifdef DILIGENT_DEBUG
-        DbgVerifyList();
-#endif
-        return Allocation{Offset, AdjustedSize};
+        return BestBlockIt != m_FreeBlocksByOffset.end() ?
+            AllocateFromBlock(BestBlockIt, Size, Alignment) :
+            Allocation::InvalidAllocation();
     }
 
     void Free(Allocation&& allocation)
@@ -364,6 +355,12 @@ public:
         return m_FreeBlocksByOffset.size();
     }
 
+    // Returns the offset of the first free block, or Allocation::InvalidOffset if there are no free blocks
+    OffsetType GetFirstFreeOffset() const
+    {
+        return !m_FreeBlocksByOffset.empty() ? m_FreeBlocksByOffset.begin()->first : Allocation::InvalidOffset;
+    }
+
     void Extend(size_t ExtraSize)
     {
         size_t NewBlockOffset = m_MaxSize;
@@ -400,6 +397,49 @@ public:
     }
 
 private:
+    // Allocates Size bytes (which must be aligned by Alignment) from the start of the free block
+    Allocation AllocateFromBlock(TFreeBlocksByOffsetMap::iterator BlockIt, OffsetType Size, OffsetType Alignment)
+    {
+        //     BlockIt.Offset
+        //        |                                  |
+        //        |<----------BlockIt.Size---------->|
+        //        |<------Size------>|<---NewSize--->|
+        //        |                  |
+        //      Offset              NewOffset
+        //
+        auto Offset = BlockIt->first;
+        VERIFY_EXPR(Offset % m_CurrAlignment == 0);
+        auto AlignedOffset = AlignUp(Offset, Alignment);
+        auto AdjustedSize  = Size + (AlignedOffset - Offset);
+        auto NewOffset     = Offset + AdjustedSize;
+        auto NewSize       = BlockIt->second.Size - AdjustedSize;
+        m_FreeBlocksBySize.erase(BlockIt->second.OrderBySizeIt);
+        m_FreeBlocksByOffset.erase(BlockIt);
+        if (NewSize > 0)
+        {
+            AddNewBlock(NewOffset, NewSize);
+        }
+        m_FreeSize -= AdjustedSize;
+
+        if ((Size & (m_CurrAlignment - 1)) != 0)
+        {
+            if (IsPowerOfTwo(Size))
+            {
+                VERIFY_EXPR(Size >= Alignment && Size < m_CurrAlignment);
+                m_CurrAlignment = Size;
+            }
+            else
+            {
+                m_CurrAlignment = std::min(m_CurrAlignment, Alignment);
+            }
+        }
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyList();
+#endif
+        return Allocation{Offset, AdjustedSize};
+    }
+
     void AddNewBlock(OffsetType Offset, OffsetType Size)
     {
         auto NewBlockIt = m_FreeBlocksByOffset.emplace(Offset, Size);
@@ -27,7 +27,30 @@
 
 #include <array>
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
 #include "ColorConversion.h"
+#include "GraphicsAccessories.hpp"
+#include "BasicMath.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define COLOR_CONVERSION_SSE2 1
+#    include <emmintrin.h>
+#    if defined(__F16C__)
+#        include <immintrin.h>
+#    endif
+#else
+#    define COLOR_CONVERSION_SSE2 0
+#endif
+
+#if !COLOR_CONVERSION_SSE2 && (defined(__aarch64__) || defined(_M_ARM64))
+#    define COLOR_CONVERSION_NEON 1
+#    include <arm_neon.h>
+#else
+#    define COLOR_CONVERSION_NEON 0
+#endif
 
 namespace Diligent
 {
@@ -75,6 +98,988 @@ private:
     std::array<float, 256> m_ToLinear;
 };
 
+const SRGBToLinearMap& GetSRGBToLinearMap()
+{
+    static const SRGBToLinearMap map;
+    return map;
+}
+
+inline Uint32 FloatAsUint(float f)
+{
+    Uint32 u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+inline float UintAsFloat(Uint32 u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// Converts linear values to 8-bit sRGB values, rounding in sRGB space.
+class LinearToSRGB8Table
+{
+public:
+    static const LinearToSRGB8Table& Get()
+    {
+        static const LinearToSRGB8Table Table;
+        return Table;
+    }
+
+    Uint8 operator()(float x) const
+    {
+        // Note that NaN is mapped to 0
+        x = x > 0 ? std::min(x, 1.f) : 0.f;
+
+        // Buckets are indexed by the exponent and the top mantissa bits, and are small
+        // enough to contain at most one threshold, so a single correction step is sufficient.
+        const auto   Bits = FloatAsUint(x);
+        const Uint32 c    = m_Buckets[Bits > MinBucketBits ? (Bits - MinBucketBits) >> BucketShift : 0];
+        return static_cast<Uint8>(c + (x >= m_Thresholds[c] ? 1 : 0));
+    }
+
+private:
+    // The first bucket starts at 2^-13. All smaller values are converted to 0.
+    static constexpr Uint32 MinBucketBits = (127 - 13) << 23;
+    // Use 7 mantissa bits
+    static constexpr Uint32 BucketShift = 23 - 7;
+    static constexpr Uint32 NumBuckets  = (((127u << 23) - MinBucketBits) >> BucketShift) + 1;
+
+    LinearToSRGB8Table() noexcept
+    {
+        for (Uint32 c = 0; c < 256; ++c)
+        {
+            // Linear values greater than or equal to the threshold are closer to c + 1 in sRGB space
+            const double s  = (c + 0.5) / 255.0;
+            m_Thresholds[c] = c < 255 ?
+                static_cast<float>(s <= 0.04045 ? s / 12.92 : std::pow((s + 0.055) / 1.055, 2.4)) :
+                FLT_MAX;
+        }
+
+        Uint32 c = 0;
+        for (Uint32 i = 0; i < NumBuckets; ++i)
+        {
+            const float x = i > 0 ? UintAsFloat(MinBucketBits + (i << BucketShift)) : 0.f;
+            while (x >= m_Thresholds[c])
+                ++c;
+            m_Buckets[i] = static_cast<Uint8>(c);
+        }
+
+#ifdef DILIGENT_DEBUG
+        for (Uint32 i = 0; i + 1 < NumBuckets; ++i)
+            VERIFY(m_Buckets[i + 1] <= m_Buckets[i] + 1, "Bucket ", i, " contains more than one threshold");
+#endif
+    }
+
+    std::array<float, 256>        m_Thresholds;
+    std::array<Uint8, NumBuckets> m_Buckets;
+};
+
+// Exact half-to-float conversion that also handles denormals, infinities and NaNs
+inline float HalfToFloat(Uint16 Half)
+{
+    const Uint32 ExpMant = Half & 0x7FFFu;
+    // Rebias the exponent by multiplying with 2^112. This also normalizes denormals.
+    Uint32 Bits = FloatAsUint(UintAsFloat(ExpMant << 13) * UintAsFloat((127 + 112) << 23));
+    if (ExpMant > 0x7BFFu)
+        Bits |= 0xFFu << 23; // Inf or NaN
+    Bits |= static_cast<Uint32>(Half & 0x8000u) << 16;
+    return UintAsFloat(Bits);
+}
+
+// Float-to-half conversion with round-to-nearest-even. Values that are too large are
+// converted to infinity, all NaNs are converted to 0x7E00.
+inline Uint16 FloatToHalf(float f)
+{
+    Uint32       Bits = FloatAsUint(f);
+    const Uint32 Sign = Bits & 0x80000000u;
+    Bits ^= Sign;
+
+    Uint32 Half = 0;
+    if (Bits >= (127u + 16u) << 23)
+    {
+        Half = Bits > 0xFFu << 23 ? 0x7E00u : 0x7C00u;
+    }
+    else if (Bits < (127u - 14u) << 23)
+    {
+        // The result is a denormal: let the FPU do the rounding
+        const Uint32 MagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+        Half                   = FloatAsUint(UintAsFloat(Bits) + UintAsFloat(MagicBits)) - MagicBits;
+    }
+    else
+    {
+        const Uint32 MantOdd = (Bits >> 13) & 1u;
+        // Rebias the exponent and round the mantissa
+        Bits += ((15u - 127u) << 23) + 0xFFFu + MantOdd;
+        Half = Bits >> 13;
+    }
+    return static_cast<Uint16>(Half | (Sign >> 16));
+}
+
+// Decodes an unsigned float with 5-bit exponent used by TEX_FORMAT_R11G11B10_FLOAT
+inline float DecodeUFloat(Uint32 Bits, Uint32 MantBits)
+{
+    const Uint32 Exp  = Bits >> MantBits;
+    const Uint32 Mant = Bits & ((1u << MantBits) - 1u);
+    if (Exp == 31)
+        return Mant == 0 ? +INFINITY : NAN;
+    else if (Exp == 0)
+        return std::ldexp(static_cast<float>(Mant), -14 - static_cast<int>(MantBits));
+    else
+        return UintAsFloat(((Exp + 112u) << 23) | (Mant << (23 - MantBits)));
+}
+
+// Encodes an unsigned float with 5-bit exponent used by TEX_FORMAT_R11G11B10_FLOAT.
+// Negative values are converted to 0, values that are too large are clamped.
+inline Uint32 EncodeUFloat(float f, Uint32 MantBits)
+{
+    if (std::isnan(f))
+        return (31u << MantBits) | 1u;
+    if (!(f > 0))
+        return 0;
+    if (std::isinf(f))
+        return 31u << MantBits;
+
+    Uint32 Bits = FloatAsUint(f);
+    if (Bits < (127u - 14u) << 23)
+    {
+        // The result is a denormal: let the FPU do the rounding
+        const Uint32 MagicBits = ((127 - 15) + (23 - MantBits) + 1) << 23;
+        return FloatAsUint(f + UintAsFloat(MagicBits)) - MagicBits;
+    }
+
+    const Uint32 Shift   = 23 - MantBits;
+    const Uint32 MantOdd = (Bits >> Shift) & 1u;
+    Bits += ((15u - 127u) << 23) + (1u << (Shift - 1)) - 1u + MantOdd;
+    return std::min(Bits >> Shift, (30u << MantBits) | ((1u << MantBits) - 1u));
+}
+
+inline float4 DecodeR11G11B10(Uint32 Bits)
+{
+    return float4{
+        DecodeUFloat(Bits & 0x7FFu, 6),
+        DecodeUFloat((Bits >> 11) & 0x7FFu, 6),
+        DecodeUFloat(Bits >> 22, 5),
+        1.f,
+    };
+}
+
+inline Uint32 EncodeR11G11B10(const float4& f)
+{
+    return EncodeUFloat(f.x, 6) | (EncodeUFloat(f.y, 6) << 11) | (EncodeUFloat(f.z, 5) << 22);
+}
+
+inline float4 DecodeRGB9E5(Uint32 Bits)
+{
+    const int Exp = static_cast<int>(Bits >> 27) - 15 - 9;
+    return float4{
+        std::ldexp(static_cast<float>(Bits & 0x1FFu), Exp),
+        std::ldexp(static_cast<float>((Bits >> 9) & 0x1FFu), Exp),
+        std::ldexp(static_cast<float>((Bits >> 18) & 0x1FFu), Exp),
+        1.f,
+    };
+}
+
+inline Uint32 EncodeRGB9E5(const float4& f)
+{
+    // See the D3D11 functional specification, section 3.2.2
+    constexpr float MaxVal = static_cast<float>(0x1FF) / 512.f * 65536.f;
+
+    const float r = f.x > 0 ? std::min(f.x, MaxVal) : 0.f;
+    const float g = f.y > 0 ? std::min(f.y, MaxVal) : 0.f;
+    const float b = f.z > 0 ? std::min(f.z, MaxVal) : 0.f;
+
+    int MaxExp = 0;
+    std::frexp(std::max(std::max(r, g), b), &MaxExp);
+    // frexp returns the exponent that is greater than floor(log2(x)) by one
+    int Exp = std::max(-16, MaxExp - 1) + 1 + 15;
+
+    float Denom = std::ldexp(1.f, Exp - 15 - 9);
+    if (std::floor(std::max(std::max(r, g), b) / Denom + 0.5f) == 512.f)
+    {
+        Denom *= 2;
+        ++Exp;
+    }
+
+    const auto EncodeMant = [Denom](float x) {
+        return static_cast<Uint32>(std::floor(x / Denom + 0.5f));
+    };
+    return EncodeMant(r) | (EncodeMant(g) << 9) | (EncodeMant(b) << 18) | (static_cast<Uint32>(Exp) << 27);
+}
+
+inline float Saturate(float x)
+{
+    // Note that NaN is mapped to 0
+    return x > 0 ? std::min(x, 1.f) : 0.f;
+}
+
+inline float SignedSaturate(float x)
+{
+    return x > -1 ? std::min(x, 1.f) : -1.f;
+}
+
+inline int RoundToInt(float x)
+{
+    return static_cast<int>(std::lrint(x));
+}
+
+// Describes the memory layout of texels of a format supported by the conversion routines
+struct TexelLayout
+{
+    TEXTURE_FORMAT Format        = TEX_FORMAT_UNKNOWN;
+    COMPONENT_TYPE ComponentType = COMPONENT_TYPE_UNDEFINED;
+    Uint32         ComponentSize = 0;
+    Uint32         NumComponents = 0;
+    Uint32         TexelSize     = 0;
+
+    // RGBA channel stored in each component of the texel
+    Uint8 Channels[4] = {0, 1, 2, 3};
+
+    // The last component is not used (TEX_FORMAT_BGRX8_UNORM and TEX_FORMAT_BGRX8_UNORM_SRGB)
+    bool NoAlpha = false;
+
+    bool IsCompound() const
+    {
+        return ComponentType == COMPONENT_TYPE_COMPOUND;
+    }
+
+    bool IsRGBA8() const
+    {
+        return ComponentSize == 1 && NumComponents == 4 && (ComponentType == COMPONENT_TYPE_UNORM || ComponentType == COMPONENT_TYPE_UNORM_SRGB);
+    }
+};
+
+bool GetTexelLayout(TEXTURE_FORMAT Format, TexelLayout& Layout)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+
+    Layout.Format        = Format;
+    Layout.ComponentType = FmtAttribs.ComponentType;
+    Layout.ComponentSize = FmtAttribs.ComponentSize;
+    Layout.NumComponents = FmtAttribs.NumComponents;
+    Layout.TexelSize     = FmtAttribs.GetElementSize();
+
+    switch (Format)
+    {
+        case TEX_FORMAT_RGB10A2_UNORM:
+        case TEX_FORMAT_R11G11B10_FLOAT:
+        case TEX_FORMAT_RGB9E5_SHAREDEXP:
+            return true;
+
+        case TEX_FORMAT_BGRA8_UNORM:
+        case TEX_FORMAT_BGRA8_UNORM_SRGB:
+        case TEX_FORMAT_BGRX8_UNORM:
+        case TEX_FORMAT_BGRX8_UNORM_SRGB:
+            Layout.Channels[0] = 2;
+            Layout.Channels[2] = 0;
+            Layout.NoAlpha     = Format == TEX_FORMAT_BGRX8_UNORM || Format == TEX_FORMAT_BGRX8_UNORM_SRGB;
+            break;
+
+        case TEX_FORMAT_A8_UNORM:
+            Layout.Channels[0] = 3;
+            break;
+
+        case TEX_FORMAT_R1_UNORM:
+        case TEX_FORMAT_RG8_B8G8_UNORM:
+        case TEX_FORMAT_G8R8_G8B8_UNORM:
+            return false;
+
+        default:
+            break;
+    }
+
+    if (FmtAttribs.IsTypeless)
+        return false;
+
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_UNORM:
+        case COMPONENT_TYPE_SNORM:
+            return FmtAttribs.ComponentSize == 1 || FmtAttribs.ComponentSize == 2;
+
+        case COMPONENT_TYPE_UNORM_SRGB:
+            return FmtAttribs.ComponentSize == 1;
+
+        case COMPONENT_TYPE_FLOAT:
+            return FmtAttribs.ComponentSize == 2 || FmtAttribs.ComponentSize == 4;
+
+        default:
+            return false;
+    }
+}
+
+
+// Scalar reference implementation
+
+template <typename ComponentType, typename DecoderType>
+void DecodeComponent(const Uint8* pSrc, Uint32 TexelSize, float4* pDst, Uint32 NumTexels, Uint32 Channel, DecoderType Decoder)
+{
+    for (Uint32 t = 0; t < NumTexels; ++t)
+        pDst[t][Channel] = Decoder(*reinterpret_cast<const ComponentType*>(pSrc + t * TexelSize));
+}
+
+template <typename ComponentType, typename EncoderType>
+void EncodeComponent(const float4* pSrc, Uint8* pDst, Uint32 TexelSize, Uint32 NumTexels, Uint32 Channel, EncoderType Encoder)
+{
+    for (Uint32 t = 0; t < NumTexels; ++t)
+        *reinterpret_cast<ComponentType*>(pDst + t * TexelSize) = static_cast<ComponentType>(Encoder(pSrc[t][Channel]));
+}
+
+void DecodeTexels(const TexelLayout& Layout, const Uint8* pSrc, float4* pDst, Uint32 NumTexels)
+{
+    switch (Layout.Format)
+    {
+        case TEX_FORMAT_RGBA32_FLOAT:
+            memcpy(pDst, pSrc, size_t{NumTexels} * sizeof(float4));
+            return;
+
+        case TEX_FORMAT_RGB10A2_UNORM:
+            for (Uint32 t = 0; t < NumTexels; ++t)
+            {
+                const auto Bits = reinterpret_cast<const Uint32*>(pSrc)[t];
+                pDst[t]         = float4{
+                    static_cast<float>(Bits & 0x3FFu) * (1.f / 1023.f),
+                    static_cast<float>((Bits >> 10) & 0x3FFu) * (1.f / 1023.f),
+                    static_cast<float>((Bits >> 20) & 0x3FFu) * (1.f / 1023.f),
+                    static_cast<float>(Bits >> 30) * (1.f / 3.f),
+                };
+            }
+            return;
+
+        case TEX_FORMAT_R11G11B10_FLOAT:
+            for (Uint32 t = 0; t < NumTexels; ++t)
+                pDst[t] = DecodeR11G11B10(reinterpret_cast<const Uint32*>(pSrc)[t]);
+            return;
+
+        case TEX_FORMAT_RGB9E5_SHAREDEXP:
+            for (Uint32 t = 0; t < NumTexels; ++t)
+                pDst[t] = DecodeRGB9E5(reinterpret_cast<const Uint32*>(pSrc)[t]);
+            return;
+
+        default:
+            break;
+    }
+
+    for (Uint32 t = 0; t < NumTexels; ++t)
+        pDst[t] = float4{0, 0, 0, 1};
+
+    for (Uint32 c = 0; c < Layout.NumComponents; ++c)
+    {
+        const Uint32 Channel = Layout.Channels[c];
+        const auto*  pComp   = pSrc + c * Layout.ComponentSize;
+        // Alpha is always stored in linear space
+        const auto Type = Layout.ComponentType == COMPONENT_TYPE_UNORM_SRGB && Channel == 3 ? COMPONENT_TYPE_UNORM : Layout.ComponentType;
+        switch (Type)
+        {
+            case COMPONENT_TYPE_UNORM:
+                if (Layout.ComponentSize == 1)
+                    DecodeComponent<Uint8>(pComp, Layout.TexelSize, pDst, NumTexels, Channel, [](Uint8 x) { return static_cast<float>(x) * (1.f / 255.f); });
+                else
+                    DecodeComponent<Uint16>(pComp, Layout.TexelSize, pDst, NumTexels, Channel, [](Uint16 x) { return static_cast<float>(x) * (1.f / 65535.f); });
+                break;
+
+            case COMPONENT_TYPE_UNORM_SRGB:
+            {
+                const auto& ToLinear = GetSRGBToLinearMap();
+                DecodeComponent<Uint8>(pComp, Layout.TexelSize, pDst, NumTexels, Channel, [&ToLinear](Uint8 x) { return ToLinear[x]; });
+                break;
+            }
+
+            case COMPONENT_TYPE_SNORM:
+                // Both -128 and -127 map to -1.0
+                if (Layout.ComponentSize == 1)
+                    DecodeComponent<Int8>(pComp, Layout.TexelSize, pDst, NumTexels, Channel, [](Int8 x) { return std::max(static_cast<float>(x) * (1.f / 127.f), -1.f); });
+                else
+                    DecodeComponent<Int16>(pComp, Layout.TexelSize, pDst, NumTexels, Channel, [](Int16 x) { return std::max(static_cast<float>(x) * (1.f / 32767.f), -1.f); });
+                break;
+
+            case COMPONENT_TYPE_FLOAT:
+                if (Layout.ComponentSize == 2)
+                    DecodeComponent<Uint16>(pComp, Layout.TexelSize, pDst, NumTexels, Channel, HalfToFloat);
+                else
+                    DecodeComponent<float>(pComp, Layout.TexelSize, pDst, NumTexels, Channel, [](float x) { return x; });
+                break;
+
+            default:
+                UNEXPECTED("Unexpected component type");
+        }
+    }
+}
+
+void EncodeTexels(const TexelLayout& Layout, const float4* pSrc, Uint8* pDst, Uint32 NumTexels)
+{
+    switch (Layout.Format)
+    {
+        case TEX_FORMAT_RGBA32_FLOAT:
+            memcpy(pDst, pSrc, size_t{NumTexels} * sizeof(float4));
+            return;
+
+        case TEX_FORMAT_RGB10A2_UNORM:
+            for (Uint32 t = 0; t < NumTexels; ++t)
+            {
+                const auto& f = pSrc[t];
+
+                reinterpret_cast<Uint32*>(pDst)[t] =
+                    static_cast<Uint32>(RoundToInt(Saturate(f.x) * 1023.f)) |
+                    (static_cast<Uint32>(RoundToInt(Saturate(f.y) * 1023.f)) << 10) |
+                    (static_cast<Uint32>(RoundToInt(Saturate(f.z) * 1023.f)) << 20) |
+                    (static_cast<Uint32>(RoundToInt(Saturate(f.w) * 3.f)) << 30);
+            }
+            return;
+
+        case TEX_FORMAT_R11G11B10_FLOAT:
+            for (Uint32 t = 0; t < NumTexels; ++t)
+                reinterpret_cast<Uint32*>(pDst)[t] = EncodeR11G11B10(pSrc[t]);
+            return;
+
+        case TEX_FORMAT_RGB9E5_SHAREDEXP:
+            for (Uint32 t = 0; t < NumTexels; ++t)
+                reinterpret_cast<Uint32*>(pDst)[t] = EncodeRGB9E5(pSrc[t]);
+            return;
+
+        default:
+            break;
+    }
+
+    for (Uint32 c = 0; c < Layout.NumComponents; ++c)
+    {
+        const Uint32 Channel = Layout.Channels[c];
+        auto*        pComp   = pDst + c * Layout.ComponentSize;
+        const auto   Type    = Layout.ComponentType == COMPONENT_TYPE_UNORM_SRGB && Channel == 3 ? COMPONENT_TYPE_UNORM : Layout.ComponentType;
+        switch (Type)
+        {
+            case COMPONENT_TYPE_UNORM:
+                if (Layout.ComponentSize == 1)
+                    EncodeComponent<Uint8>(pSrc, pComp, Layout.TexelSize, NumTexels, Channel, [](float x) { return RoundToInt(Saturate(x) * 255.f); });
+                else
+                    EncodeComponent<Uint16>(pSrc, pComp, Layout.TexelSize, NumTexels, Channel, [](float x) { return RoundToInt(Saturate(x) * 65535.f); });
+                break;
+
+            case COMPONENT_TYPE_UNORM_SRGB:
+            {
+                const auto& ToSRGB = LinearToSRGB8Table::Get();
+                EncodeComponent<Uint8>(pSrc, pComp, Layout.TexelSize, NumTexels, Channel, ToSRGB);
+                break;
+            }
+
+            case COMPONENT_TYPE_SNORM:
+                if (Layout.ComponentSize == 1)
+                    EncodeComponent<Int8>(pSrc, pComp, Layout.TexelSize, NumTexels, Channel, [](float x) { return RoundToInt(SignedSaturate(x) * 127.f); });
+                else
+                    EncodeComponent<Int16>(pSrc, pComp, Layout.TexelSize, NumTexels, Channel, [](float x) { return RoundToInt(SignedSaturate(x) * 32767.f); });
+                break;
+
+            case COMPONENT_TYPE_FLOAT:
+                if (Layout.ComponentSize == 2)
+                    EncodeComponent<Uint16>(pSrc, pComp, Layout.TexelSize, NumTexels, Channel, FloatToHalf);
+                else
+                    EncodeComponent<float>(pSrc, pComp, Layout.TexelSize, NumTexels, Channel, [](float x) { return x; });
+                break;
+
+            default:
+                UNEXPECTED("Unexpected component type");
+        }
+    }
+}
+
+
+// SIMD kernels. Every kernel produces the same results as the scalar reference
+// implementation, returns the number of processed texels and leaves the remaining
+// texels to the scalar code.
+
+#if COLOR_CONVERSION_SSE2
+
+// Converts four half-precision values in the lower 64 bits of the argument
+inline __m128 HalfToFloatSSE2(__m128i Halfs)
+{
+#    if defined(__F16C__)
+    return _mm_cvtph_ps(Halfs);
+#    else
+    // Same as HalfToFloat()
+    const __m128i Half     = _mm_unpacklo_epi16(Halfs, _mm_setzero_si128());
+    const __m128i ExpMant  = _mm_and_si128(Half, _mm_set1_epi32(0x7FFF));
+    const __m128i Sign     = _mm_slli_epi32(_mm_xor_si128(Half, ExpMant), 16);
+    const __m128  Scaled   = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(ExpMant, 13)), _mm_castsi128_ps(_mm_set1_epi32((127 + 112) << 23)));
+    const __m128i IsInfNaN = _mm_cmpgt_epi32(ExpMant, _mm_set1_epi32(0x7BFF));
+    const __m128i InfNaN   = _mm_and_si128(IsInfNaN, _mm_set1_epi32(0xFF << 23));
+    return _mm_or_ps(Scaled, _mm_castsi128_ps(_mm_or_si128(Sign, InfNaN)));
+#    endif
+}
+
+// Returns four half-precision values in the lower 64 bits
+inline __m128i FloatToHalfSSE2(__m128 f)
+{
+#    if defined(__F16C__)
+    // Unlike FloatToHalf(), the instruction preserves the NaN payload
+    const __m128i Half  = _mm_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+    const __m128i IsNaN = _mm_castps_si128(_mm_cmpunord_ps(f, f));
+    const __m128i Mask  = _mm_packs_epi32(IsNaN, IsNaN);
+    return _mm_or_si128(_mm_andnot_si128(_mm_and_si128(Mask, _mm_set1_epi16(0x7FFF)), Half), _mm_and_si128(Mask, _mm_set1_epi16(0x7E00)));
+#    else
+    // Same as FloatToHalf()
+    const __m128i Sign       = _mm_and_si128(_mm_castps_si128(f), _mm_set1_epi32(0x80000000u));
+    const __m128i Bits       = _mm_xor_si128(_mm_castps_si128(f), Sign);
+    const __m128i IsRegular  = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), Bits);
+    const __m128i IsNaN      = _mm_cmpgt_epi32(Bits, _mm_set1_epi32(0xFF << 23));
+    const __m128i InfNaN     = _mm_or_si128(_mm_and_si128(IsNaN, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+    const __m128i IsDenormal = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), Bits);
+    const __m128i MagicBits  = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i Denormal   = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Bits), _mm_castsi128_ps(MagicBits))), MagicBits);
+    const __m128i MantOdd    = _mm_and_si128(_mm_srli_epi32(Bits, 13), _mm_set1_epi32(1));
+    const __m128i Normal     = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(Bits, _mm_set1_epi32(static_cast<int>(((15u - 127u) << 23) + 0xFFFu))), MantOdd), 13);
+    const __m128i Finite     = _mm_or_si128(_mm_and_si128(IsDenormal, Denormal), _mm_andnot_si128(IsDenormal, Normal));
+    const __m128i Half       = _mm_or_si128(_mm_and_si128(IsRegular, Finite), _mm_andnot_si128(IsRegular, InfNaN));
+    // Sign-extend the values so that they can be packed with signed saturation
+    const __m128i Result = _mm_or_si128(Half, _mm_srai_epi32(Sign, 16));
+    return _mm_packs_epi32(Result, Result);
+#    endif
+}
+
+inline __m128 Saturate(__m128 v)
+{
+    // _mm_max_ps returns the second operand if the first one is NaN
+    return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+}
+
+Uint32 DecodeRGBA8SIMD(const Uint8* pSrc, float4* pDst, Uint32 NumTexels, bool SwapRB)
+{
+    const __m128i Zero  = _mm_setzero_si128();
+    const __m128  Scale = _mm_set1_ps(1.f / 255.f);
+
+    Uint32 t = 0;
+    for (; t + 4 <= NumTexels; t += 4)
+    {
+        const __m128i Src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + t * 4));
+        const __m128i Lo  = _mm_unpacklo_epi8(Src, Zero);
+        const __m128i Hi  = _mm_unpackhi_epi8(Src, Zero);
+
+        const __m128i Texels[] = {
+            _mm_unpacklo_epi16(Lo, Zero),
+            _mm_unpackhi_epi16(Lo, Zero),
+            _mm_unpacklo_epi16(Hi, Zero),
+            _mm_unpackhi_epi16(Hi, Zero),
+        };
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            __m128 v = _mm_mul_ps(_mm_cvtepi32_ps(Texels[i]), Scale);
+            if (SwapRB)
+                v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+            _mm_storeu_ps(&pDst[t + i].x, v);
+        }
+    }
+    return t;
+}
+
+Uint32 EncodeRGBA8SIMD(const float4* pSrc, Uint8* pDst, Uint32 NumTexels, bool SwapRB)
+{
+    const __m128 Scale = _mm_set1_ps(255.f);
+
+    Uint32 t = 0;
+    for (; t + 4 <= NumTexels; t += 4)
+    {
+        __m128i Texels[4];
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            __m128 v = _mm_loadu_ps(&pSrc[t + i].x);
+            if (SwapRB)
+                v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+            Texels[i] = _mm_cvtps_epi32(_mm_mul_ps(Saturate(v), Scale));
+        }
+        const __m128i Packed = _mm_packus_epi16(_mm_packs_epi32(Texels[0], Texels[1]), _mm_packs_epi32(Texels[2], Texels[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + t * 4), Packed);
+    }
+    return t;
+}
+
+Uint32 DecodeRGBA16SIMD(const Uint8* pSrc, float4* pDst, Uint32 NumTexels)
+{
+    const __m128i Zero  = _mm_setzero_si128();
+    const __m128  Scale = _mm_set1_ps(1.f / 65535.f);
+
+    Uint32 t = 0;
+    for (; t + 2 <= NumTexels; t += 2)
+    {
+        const __m128i Src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + t * 8));
+        _mm_storeu_ps(&pDst[t].x, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(Src, Zero)), Scale));
+        _mm_storeu_ps(&pDst[t + 1].x, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(Src, Zero)), Scale));
+    }
+    return t;
+}
+
+Uint32 EncodeRGBA16SIMD(const float4* pSrc, Uint8* pDst, Uint32 NumTexels)
+{
+    const __m128  Scale = _mm_set1_ps(65535.f);
+    const __m128i Bias  = _mm_set1_epi32(0x8000);
+
+    Uint32 t = 0;
+    for (; t + 2 <= NumTexels; t += 2)
+    {
+        // SSE2 has no unsigned 32->16 pack, so bias the values into the signed range
+        const __m128i Texel0 = _mm_sub_epi32(_mm_cvtps_epi32(_mm_mul_ps(Saturate(_mm_loadu_ps(&pSrc[t].x)), Scale)), Bias);
+        const __m128i Texel1 = _mm_sub_epi32(_mm_cvtps_epi32(_mm_mul_ps(Saturate(_mm_loadu_ps(&pSrc[t + 1].x)), Scale)), Bias);
+        const __m128i Packed = _mm_xor_si128(_mm_packs_epi32(Texel0, Texel1), _mm_set1_epi16(-0x8000));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + t * 8), Packed);
+    }
+    return t;
+}
+
+Uint32 DecodeRGBA16FSIMD(const Uint8* pSrc, float4* pDst, Uint32 NumTexels)
+{
+    Uint32 t = 0;
+    for (; t + 2 <= NumTexels; t += 2)
+    {
+        const __m128i Src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + t * 8));
+        _mm_storeu_ps(&pDst[t].x, HalfToFloatSSE2(Src));
+        _mm_storeu_ps(&pDst[t + 1].x, HalfToFloatSSE2(_mm_unpackhi_epi64(Src, Src)));
+    }
+    return t;
+}
+
+Uint32 EncodeRGBA16FSIMD(const float4* pSrc, Uint8* pDst, Uint32 NumTexels)
+{
+    Uint32 t = 0;
+    for (; t + 2 <= NumTexels; t += 2)
+    {
+        const __m128i Texel0 = FloatToHalfSSE2(_mm_loadu_ps(&pSrc[t].x));
+        const __m128i Texel1 = FloatToHalfSSE2(_mm_loadu_ps(&pSrc[t + 1].x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + t * 8), _mm_unpacklo_epi64(Texel0, Texel1));
+    }
+    return t;
+}
+
+// Permutes bytes of 32-bit texels. Perm[i] is the index of the source byte written
+// to the i-th destination byte, or 4 to write 0xFF.
+Uint32 PermuteRGBA8SIMD(const Uint8* pSrc, Uint8* pDst, Uint32 NumTexels, const Uint8 Perm[])
+{
+    const __m128i ByteMask = _mm_set1_epi32(0xFF);
+
+    Uint32  ConstBits = 0;
+    __m128i SrcShift[4], DstShift[4];
+    for (Uint32 i = 0; i < 4; ++i)
+    {
+        if (Perm[i] > 3)
+            ConstBits |= 0xFFu << (i * 8);
+        SrcShift[i] = _mm_cvtsi32_si128(Perm[i] * 8);
+        DstShift[i] = _mm_cvtsi32_si128(i * 8);
+    }
+    const __m128i Const = _mm_set1_epi32(static_cast<int>(ConstBits));
+
+    Uint32 t = 0;
+    for (; t + 4 <= NumTexels; t += 4)
+    {
+        const __m128i Src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + t * 4));
+
+        __m128i Dst = Const;
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            if (Perm[i] <= 3)
+                Dst = _mm_or_si128(Dst, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(Src, SrcShift[i]), ByteMask), DstShift[i]));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + t * 4), Dst);
+    }
+    return t;
+}
+
+#elif COLOR_CONVERSION_NEON
+
+inline uint32x4_t EncodeUnorm(float32x4_t v, float32x4_t Scale)
+{
+    // vmaxnmq_f32 returns the second operand if the first one is NaN
+    v = vminq_f32(vmaxnmq_f32(v, vdupq_n_f32(0.f)), vdupq_n_f32(1.f));
+    return vcvtnq_u32_f32(vmulq_f32(v, Scale));
+}
+
+Uint32 DecodeRGBA8SIMD(const Uint8* pSrc, float4* pDst, Uint32 NumTexels, bool SwapRB)
+{
+    const float32x4_t Scale = vdupq_n_f32(1.f / 255.f);
+
+    Uint32 t = 0;
+    for (; t + 8 <= NumTexels; t += 8)
+    {
+        const uint8x8x4_t Src = vld4_u8(pSrc + t * 4);
+
+        float32x4x4_t Lo, Hi;
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            const Uint32     Channel = SwapRB && c != 1 && c != 3 ? 2 - c : c;
+            const uint16x8_t Comp16  = vmovl_u8(Src.val[c]);
+            Lo.val[Channel]          = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(Comp16))), Scale);
+            Hi.val[Channel]          = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(Comp16))), Scale);
+        }
+        vst4q_f32(&pDst[t].x, Lo);
+        vst4q_f32(&pDst[t + 4].x, Hi);
+    }
+    return t;
+}
+
+Uint32 EncodeRGBA8SIMD(const float4* pSrc, Uint8* pDst, Uint32 NumTexels, bool SwapRB)
+{
+    const float32x4_t Scale = vdupq_n_f32(255.f);
+
+    Uint32 t = 0;
+    for (; t + 8 <= NumTexels; t += 8)
+    {
+        const float32x4x4_t Lo = vld4q_f32(&pSrc[t].x);
+        const float32x4x4_t Hi = vld4q_f32(&pSrc[t + 4].x);
+
+        uint8x8x4_t Dst;
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            const Uint32 Channel = SwapRB && c != 1 && c != 3 ? 2 - c : c;
+            Dst.val[c]           = vmovn_u16(vcombine_u16(vmovn_u32(EncodeUnorm(Lo.val[Channel], Scale)), vmovn_u32(EncodeUnorm(Hi.val[Channel], Scale))));
+        }
+        vst4_u8(pDst + t * 4, Dst);
+    }
+    return t;
+}
+
+Uint32 DecodeRGBA16SIMD(const Uint8* pSrc, float4* pDst, Uint32 NumTexels)
+{
+    const float32x4_t Scale = vdupq_n_f32(1.f / 65535.f);
+
+    Uint32 t = 0;
+    for (; t + 2 <= NumTexels; t += 2)
+    {
+        const uint16x8_t Src = vld1q_u16(reinterpret_cast<const uint16_t*>(pSrc + t * 8));
+        vst1q_f32(&pDst[t].x, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(Src))), Scale));
+        vst1q_f32(&pDst[t + 1].x, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(Src))), Scale));
+    }
+    return t;
+}
+
+Uint32 EncodeRGBA16SIMD(const float4* pSrc, Uint8* pDst, Uint32 NumTexels)
+{
+    const float32x4_t Scale = vdupq_n_f32(65535.f);
+
+    Uint32 t = 0;
+    for (; t + 2 <= NumTexels; t += 2)
+    {
+        const uint16x4_t Texel0 = vmovn_u32(EncodeUnorm(vld1q_f32(&pSrc[t].x), Scale));
+        const uint16x4_t Texel1 = vmovn_u32(EncodeUnorm(vld1q_f32(&pSrc[t + 1].x), Scale));
+        vst1q_u16(reinterpret_cast<uint16_t*>(pDst + t * 8), vcombine_u16(Texel0, Texel1));
+    }
+    return t;
+}
+
+Uint32 DecodeRGBA16FSIMD(const Uint8* pSrc, float4* pDst, Uint32 NumTexels)
+{
+    for (Uint32 t = 0; t < NumTexels; ++t)
+        vst1q_f32(&pDst[t].x, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(pSrc + t * 8)))));
+    return NumTexels;
+}
+
+Uint32 EncodeRGBA16FSIMD(const float4* pSrc, Uint8* pDst, Uint32 NumTexels)
+{
+    for (Uint32 t = 0; t < NumTexels; ++t)
+    {
+        const float32x4_t Src  = vld1q_f32(&pSrc[t].x);
+        const uint16x4_t  Half = vreinterpret_u16_f16(vcvt_f16_f32(Src));
+        // Same as FloatToHalf(), convert all NaNs to 0x7E00 keeping the sign
+        const uint16x4_t IsNaN = vmovn_u32(vmvnq_u32(vceqq_f32(Src, Src)));
+        const uint16x4_t NaN   = vorr_u16(vand_u16(Half, vdup_n_u16(0x8000)), vdup_n_u16(0x7E00));
+        vst1_u16(reinterpret_cast<uint16_t*>(pDst + t * 8), vbsl_u16(IsNaN, NaN, Half));
+    }
+    return NumTexels;
+}
+
+Uint32 PermuteRGBA8SIMD(const Uint8* pSrc, Uint8* pDst, Uint32 NumTexels, const Uint8 Perm[])
+{
+    Uint32 t = 0;
+    for (; t + 16 <= NumTexels; t += 16)
+    {
+        const uint8x16x4_t Src = vld4q_u8(pSrc + t * 4);
+
+        uint8x16x4_t Dst;
+        for (Uint32 i = 0; i < 4; ++i)
+            Dst.val[i] = Perm[i] <= 3 ? Src.val[Perm[i]] : vdupq_n_u8(0xFF);
+        vst4q_u8(pDst + t * 4, Dst);
+    }
+    return t;
+}
+
+#else
+
+Uint32 DecodeRGBA8SIMD(const Uint8*, float4*, Uint32, bool)
+{
+    return 0;
+}
+
+Uint32 EncodeRGBA8SIMD(const float4*, Uint8*, Uint32, bool)
+{
+    return 0;
+}
+
+Uint32 DecodeRGBA16SIMD(const Uint8*, float4*, Uint32)
+{
+    return 0;
+}
+
+Uint32 EncodeRGBA16SIMD(const float4*, Uint8*, Uint32)
+{
+    return 0;
+}
+
+Uint32 DecodeRGBA16FSIMD(const Uint8*, float4*, Uint32)
+{
+    return 0;
+}
+
+Uint32 EncodeRGBA16FSIMD(const float4*, Uint8*, Uint32)
+{
+    return 0;
+}
+
+Uint32 PermuteRGBA8SIMD(const Uint8*, Uint8*, Uint32, const Uint8*)
+{
+    return 0;
+}
+
+#endif
+
+Uint32 DecodeTexelsSIMD(const TexelLayout& Layout, const Uint8* pSrc, float4* pDst, Uint32 NumTexels)
+{
+    if (Layout.NumComponents != 4)
+        return 0;
+
+    if (Layout.ComponentType == COMPONENT_TYPE_UNORM)
+    {
+        if (Layout.ComponentSize == 1)
+            return DecodeRGBA8SIMD(pSrc, pDst, NumTexels, Layout.Channels[0] == 2);
+        else if (Layout.ComponentSize == 2)
+            return DecodeRGBA16SIMD(pSrc, pDst, NumTexels);
+    }
+    else if (Layout.ComponentType == COMPONENT_TYPE_FLOAT && Layout.ComponentSize == 2)
+    {
+        return DecodeRGBA16FSIMD(pSrc, pDst, NumTexels);
+    }
+    return 0;
+}
+
+Uint32 EncodeTexelsSIMD(const TexelLayout& Layout, const float4* pSrc, Uint8* pDst, Uint32 NumTexels)
+{
+    if (Layout.NumComponents != 4)
+        return 0;
+
+    if (Layout.ComponentType == COMPONENT_TYPE_UNORM)
+    {
+        if (Layout.ComponentSize == 1)
+            return EncodeRGBA8SIMD(pSrc, pDst, NumTexels, Layout.Channels[0] == 2);
+        else if (Layout.ComponentSize == 2)
+            return EncodeRGBA16SIMD(pSrc, pDst, NumTexels);
+    }
+    else if (Layout.ComponentType == COMPONENT_TYPE_FLOAT && Layout.ComponentSize == 2)
+    {
+        return EncodeRGBA16FSIMD(pSrc, pDst, NumTexels);
+    }
+    return 0;
+}
+
+class TextureDataConverter
+{
+public:
+    TextureDataConverter(const TextureDataConversionAttribs& Attribs, const TexelLayout& SrcLayout, const TexelLayout& DstLayout) :
+        m_Attribs{Attribs},
+        m_SrcLayout{SrcLayout},
+        m_DstLayout{DstLayout}
+    {
+        for (Uint32 i = 0; i < 4; ++i)
+            m_IdentitySwizzle = m_IdentitySwizzle && Attribs.Swizzle[i] == i;
+
+        m_UseBytePermutation = SrcLayout.IsRGBA8() && DstLayout.IsRGBA8() && SrcLayout.ComponentType == DstLayout.ComponentType && !Attribs.PremultiplyAlpha;
+        for (Uint32 i = 0; i < 4 && m_UseBytePermutation; ++i)
+        {
+            const Uint32 DstChannel = DstLayout.Channels[i];
+            const Uint32 SrcChannel = Attribs.Swizzle[DstChannel];
+            if ((DstLayout.NoAlpha && DstChannel == 3) || (SrcLayout.NoAlpha && SrcChannel == 3))
+            {
+                m_BytePerm[i] = 4;
+            }
+            else
+            {
+                m_BytePerm[i] = static_cast<Uint8>(std::find(SrcLayout.Channels, SrcLayout.Channels + 4, SrcChannel) - SrcLayout.Channels);
+                // sRGB color components and linear alpha can't be exchanged without conversion
+                if (SrcLayout.ComponentType == COMPONENT_TYPE_UNORM_SRGB && (SrcChannel == 3) != (DstChannel == 3))
+                    m_UseBytePermutation = false;
+            }
+        }
+    }
+
+    void ConvertRow(const Uint8* pSrc, Uint8* pDst) const
+    {
+        const auto Width = m_Attribs.Width;
+
+        Uint32 t = 0;
+        if (m_UseBytePermutation && m_Attribs.UseSIMD)
+        {
+            t = PermuteRGBA8SIMD(pSrc, pDst, Width, m_BytePerm);
+        }
+
+        alignas(16) float4 Texels[ChunkSize];
+        while (t < Width)
+        {
+            const auto NumTexels = std::min(Width - t, Uint32{ChunkSize});
+
+            const auto* pSrcTexels = pSrc + size_t{t} * m_SrcLayout.TexelSize;
+            const auto  Decoded    = m_Attribs.UseSIMD ? DecodeTexelsSIMD(m_SrcLayout, pSrcTexels, Texels, NumTexels) : 0;
+            if (Decoded < NumTexels)
+                DecodeTexels(m_SrcLayout, pSrcTexels + size_t{Decoded} * m_SrcLayout.TexelSize, Texels + Decoded, NumTexels - Decoded);
+
+            if (m_SrcLayout.NoAlpha)
+            {
+                for (Uint32 i = 0; i < NumTexels; ++i)
+                    Texels[i].w = 1;
+            }
+
+            if (!m_IdentitySwizzle)
+            {
+                const auto* Swizzle = m_Attribs.Swizzle;
+                for (Uint32 i = 0; i < NumTexels; ++i)
+                {
+                    const float4 Texel = Texels[i];
+                    Texels[i]          = float4{Texel[Swizzle[0]], Texel[Swizzle[1]], Texel[Swizzle[2]], Texel[Swizzle[3]]};
+                }
+            }
+
+            if (m_Attribs.PremultiplyAlpha)
+            {
+                for (Uint32 i = 0; i < NumTexels; ++i)
+                {
+                    auto& Texel = Texels[i];
+                    Texel.x *= Texel.w;
+                    Texel.y *= Texel.w;
+                    Texel.z *= Texel.w;
+                }
+            }
+
+            if (m_DstLayout.NoAlpha)
+            {
+                for (Uint32 i = 0; i < NumTexels; ++i)
+                    Texels[i].w = 1;
+            }
+
+            auto*      pDstTexels = pDst + size_t{t} * m_DstLayout.TexelSize;
+            const auto Encoded    = m_Attribs.UseSIMD ? EncodeTexelsSIMD(m_DstLayout, Texels, pDstTexels, NumTexels) : 0;
+            if (Encoded < NumTexels)
+                EncodeTexels(m_DstLayout, Texels + Encoded, pDstTexels + size_t{Encoded} * m_DstLayout.TexelSize, NumTexels - Encoded);
+
+            t += NumTexels;
+        }
+    }
+
+private:
+    static constexpr Uint32 ChunkSize = 64;
+
+    const TextureDataConversionAttribs& m_Attribs;
+    const TexelLayout&                  m_SrcLayout;
+    const TexelLayout&                  m_DstLayout;
+
+    bool  m_IdentitySwizzle    = true;
+    bool  m_UseBytePermutation = false;
+    Uint8 m_BytePerm[4]        = {};
+};
+
 } // namespace
 
 float LinearToSRGB(Uint8 x)
@@ -85,8 +1090,62 @@ float LinearToSRGB(Uint8 x)
 
 float SRGBToLinear(Uint8 x)
 {
-    static const SRGBToLinearMap map;
-    return map[x];
+    return GetSRGBToLinearMap()[x];
+}
+
+bool IsTextureFormatConversionSupported(TEXTURE_FORMAT SrcFormat, TEXTURE_FORMAT DstFormat)
+{
+    if (SrcFormat == DstFormat)
+    {
+        // Data in the same format can always be copied
+        const auto& FmtAttribs = GetTextureFormatAttribs(SrcFormat);
+        return FmtAttribs.ComponentType != COMPONENT_TYPE_UNDEFINED && FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED;
+    }
+
+    TexelLayout SrcLayout, DstLayout;
+    return GetTexelLayout(SrcFormat, SrcLayout) && GetTexelLayout(DstFormat, DstLayout);
+}
+
+void ConvertTextureData(const TextureDataConversionAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.pSrcData != nullptr || Attribs.Width == 0 || Attribs.Height == 0, "Source data must not be null");
+    DEV_CHECK_ERR(Attribs.pDstData != nullptr || Attribs.Width == 0 || Attribs.Height == 0, "Destination data must not be null");
+    DEV_CHECK_ERR(Attribs.Swizzle[0] < 4 && Attribs.Swizzle[1] < 4 && Attribs.Swizzle[2] < 4 && Attribs.Swizzle[3] < 4, "Swizzle indices must be less than 4");
+
+    if (!IsTextureFormatConversionSupported(Attribs.SrcFormat, Attribs.DstFormat))
+    {
+        LOG_ERROR_MESSAGE("Conversion from ", GetTextureFormatAttribs(Attribs.SrcFormat).Name, " to ",
+                          GetTextureFormatAttribs(Attribs.DstFormat).Name, " is not supported");
+        return;
+    }
+
+    const auto* pSrc = static_cast<const Uint8*>(Attribs.pSrcData);
+    auto*       pDst = static_cast<Uint8*>(Attribs.pDstData);
+
+    const bool IdentitySwizzle = Attribs.Swizzle[0] == 0 && Attribs.Swizzle[1] == 1 && Attribs.Swizzle[2] == 2 && Attribs.Swizzle[3] == 3;
+    if (Attribs.SrcFormat == Attribs.DstFormat && IdentitySwizzle && !Attribs.PremultiplyAlpha)
+    {
+        const size_t RowSize = size_t{Attribs.Width} * GetTextureFormatAttribs(Attribs.SrcFormat).GetElementSize();
+        DEV_CHECK_ERR(Attribs.SrcStride >= RowSize || Attribs.Height <= 1, "Source stride is too small");
+        DEV_CHECK_ERR(Attribs.DstStride >= RowSize || Attribs.Height <= 1, "Destination stride is too small");
+        for (Uint32 row = 0; row < Attribs.Height; ++row)
+            memcpy(pDst + row * Attribs.DstStride, pSrc + row * Attribs.SrcStride, RowSize);
+        return;
+    }
+
+    TexelLayout SrcLayout, DstLayout;
+    if (!GetTexelLayout(Attribs.SrcFormat, SrcLayout) || !GetTexelLayout(Attribs.DstFormat, DstLayout))
+    {
+        LOG_ERROR_MESSAGE("Conversion from ", GetTextureFormatAttribs(Attribs.SrcFormat).Name, " to ",
+                          GetTextureFormatAttribs(Attribs.DstFormat).Name, " is not supported: only copy is allowed");
+        return;
+    }
+    DEV_CHECK_ERR(Attribs.SrcStride >= size_t{Attribs.Width} * SrcLayout.TexelSize || Attribs.Height <= 1, "Source stride is too small");
+    DEV_CHECK_ERR(Attribs.DstStride >= size_t{Attribs.Width} * DstLayout.TexelSize || Attribs.Height <= 1, "Destination stride is too small");
+
+    const TextureDataConverter Converter{Attribs, SrcLayout, DstLayout};
+    for (Uint32 row = 0; row < Attribs.Height; ++row)
+        Converter.ConvertRow(pSrc + row * Attribs.SrcStride, pDst + row * Attribs.DstStride);
 }
 
 } // namespace Diligent
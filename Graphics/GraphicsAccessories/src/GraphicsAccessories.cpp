@@ -26,11 +26,22 @@
  */
 
 #include <algorithm>
+#include <cstring>
+#include <thread>
 
 #include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
 #include "DebugUtilities.hpp"
 #include "Align.hpp"
 #include "BasicMath.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define GRAPHICS_ACCESSORIES_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define GRAPHICS_ACCESSORIES_SSE2 0
+#endif
 
 namespace Diligent
 {
@@ -1765,6 +1776,211 @@ BufferToTextureCopyInfo GetBufferToTextureCopyInfo(TEXTURE_FORMAT Format,
 }
 
 
+namespace
+{
+
+// Copies the memory using non-temporal stores. The caller must issue a store fence
+// before the data is consumed by another thread or device.
+void CopyMemoryNonTemporal(Uint8* pDst, const Uint8* pSrc, size_t Size)
+{
+#if GRAPHICS_ACCESSORIES_SSE2
+    // Stores require 16-byte aligned destination
+    const size_t HeadSize = std::min(static_cast<size_t>(AlignUp(pDst, 16) - pDst), Size);
+    memcpy(pDst, pSrc, HeadSize);
+    pDst += HeadSize;
+    pSrc += HeadSize;
+    Size -= HeadSize;
+
+    auto*       pDst16 = reinterpret_cast<__m128i*>(pDst);
+    const auto* pSrc16 = reinterpret_cast<const __m128i*>(pSrc);
+    for (; Size >= 64; Size -= 64, pDst16 += 4, pSrc16 += 4)
+    {
+        const __m128i v0 = _mm_loadu_si128(pSrc16 + 0);
+        const __m128i v1 = _mm_loadu_si128(pSrc16 + 1);
+        const __m128i v2 = _mm_loadu_si128(pSrc16 + 2);
+        const __m128i v3 = _mm_loadu_si128(pSrc16 + 3);
+        _mm_stream_si128(pDst16 + 0, v0);
+        _mm_stream_si128(pDst16 + 1, v1);
+        _mm_stream_si128(pDst16 + 2, v2);
+        _mm_stream_si128(pDst16 + 3, v3);
+    }
+    for (; Size >= 16; Size -= 16)
+        _mm_stream_si128(pDst16++, _mm_loadu_si128(pSrc16++));
+
+    memcpy(pDst16, pSrc16, Size);
+#else
+    memcpy(pDst, pSrc, Size);
+#endif
+}
+
+void StoreFence()
+{
+#if GRAPHICS_ACCESSORIES_SSE2
+    _mm_sfence();
+#endif
+}
+
+class TextureSubresourceCopier
+{
+public:
+    explicit TextureSubresourceCopier(const CopyTextureSubresourceAttribs& Attribs) :
+        m_Attribs{Attribs},
+        m_pSrc{static_cast<const Uint8*>(Attribs.Src.pData)},
+        m_pDst{static_cast<Uint8*>(Attribs.pDstData)},
+        m_Convert{
+            Attribs.SrcFormat != TEX_FORMAT_UNKNOWN && Attribs.DstFormat != TEX_FORMAT_UNKNOWN &&
+            (Attribs.SrcFormat != Attribs.DstFormat ||
+             Attribs.Swizzle[0] != 0 || Attribs.Swizzle[1] != 1 || Attribs.Swizzle[2] != 2 || Attribs.Swizzle[3] != 3)},
+        m_RowsArePacked{
+            !m_Convert &&
+            Attribs.Src.Stride == Attribs.RowSize &&
+            Attribs.DstRowStride == Attribs.RowSize},
+        m_IsContiguous{
+            m_RowsArePacked &&
+            (Attribs.NumDepthSlices == 1 ||
+             (Attribs.Src.DepthStride == size_t{Attribs.RowSize} * Attribs.NumRows &&
+              Attribs.DstDepthStride == size_t{Attribs.RowSize} * Attribs.NumRows))}
+    {
+        if (m_Convert)
+        {
+            const Uint32 SrcTexelSize = GetTextureFormatAttribs(Attribs.SrcFormat).GetElementSize();
+            VERIFY(Attribs.RowSize % SrcTexelSize == 0, "Row size (", Attribs.RowSize, ") is not a multiple of the source texel size (", SrcTexelSize, ")");
+            m_ConvAttribs.Width     = Attribs.RowSize / SrcTexelSize;
+            m_ConvAttribs.SrcFormat = Attribs.SrcFormat;
+            m_ConvAttribs.SrcStride = Attribs.Src.Stride;
+            m_ConvAttribs.DstFormat = Attribs.DstFormat;
+            m_ConvAttribs.DstStride = Attribs.DstRowStride;
+            memcpy(m_ConvAttribs.Swizzle, Attribs.Swizzle, sizeof(m_ConvAttribs.Swizzle));
+        }
+    }
+
+    bool IsContiguous() const { return m_IsContiguous; }
+
+    size_t GetDstRowSize() const
+    {
+        return m_Convert ?
+            size_t{m_ConvAttribs.Width} * GetTextureFormatAttribs(m_Attribs.DstFormat).GetElementSize() :
+            size_t{m_Attribs.RowSize};
+    }
+
+    size_t GetTotalSize() const
+    {
+        return size_t{m_Attribs.RowSize} * m_Attribs.NumRows * m_Attribs.NumDepthSlices;
+    }
+
+    size_t GetTotalRows() const
+    {
+        return size_t{m_Attribs.NumRows} * m_Attribs.NumDepthSlices;
+    }
+
+    // Copies bytes [Start, End) of the contiguous subresource
+    void CopyBytes(size_t Start, size_t End) const
+    {
+        VERIFY_EXPR(m_IsContiguous);
+        CopyMemory(m_pDst + Start, m_pSrc + Start, End - Start);
+    }
+
+    // Copies rows [Start, End) counting rows of all depth slices
+    void CopyRows(size_t Start, size_t End) const
+    {
+        const auto& Attribs = m_Attribs;
+        for (size_t Row = Start; Row < End;)
+        {
+            const Uint32 z       = static_cast<Uint32>(Row / Attribs.NumRows);
+            const Uint32 y       = static_cast<Uint32>(Row % Attribs.NumRows);
+            const Uint32 NumRows = static_cast<Uint32>(std::min(size_t{Attribs.NumRows - y}, End - Row));
+
+            const auto* pSrcRow = m_pSrc + size_t{Attribs.Src.DepthStride} * z + size_t{Attribs.Src.Stride} * y;
+            auto*       pDstRow = m_pDst + size_t{Attribs.DstDepthStride} * z + size_t{Attribs.DstRowStride} * y;
+            if (m_Convert)
+            {
+                auto ConvAttribs     = m_ConvAttribs;
+                ConvAttribs.Height   = NumRows;
+                ConvAttribs.pSrcData = pSrcRow;
+                ConvAttribs.pDstData = pDstRow;
+                ConvertTextureData(ConvAttribs);
+            }
+            else if (m_RowsArePacked)
+            {
+                CopyMemory(pDstRow, pSrcRow, size_t{Attribs.RowSize} * NumRows);
+            }
+            else
+            {
+                for (Uint32 r = 0; r < NumRows; ++r)
+                    CopyMemory(pDstRow + size_t{Attribs.DstRowStride} * r, pSrcRow + size_t{Attribs.Src.Stride} * r, Attribs.RowSize);
+            }
+
+            Row += NumRows;
+        }
+    }
+
+    void Finish() const
+    {
+        if (m_Attribs.NonTemporalStores && !m_Convert)
+            StoreFence();
+    }
+
+private:
+    void CopyMemory(Uint8* pDst, const Uint8* pSrc, size_t Size) const
+    {
+        if (m_Attribs.NonTemporalStores)
+            CopyMemoryNonTemporal(pDst, pSrc, Size);
+        else
+            memcpy(pDst, pSrc, Size);
+    }
+
+    const CopyTextureSubresourceAttribs& m_Attribs;
+
+    const Uint8* const m_pSrc;
+    Uint8* const       m_pDst;
+
+    const bool m_Convert;
+    const bool m_RowsArePacked;
+    const bool m_IsContiguous;
+
+    TextureDataConversionAttribs m_ConvAttribs;
+};
+
+} // namespace
+
+void CopyTextureSubresource(const CopyTextureSubresourceAttribs& Attribs)
+{
+    VERIFY_EXPR(Attribs.Src.pSrcBuffer == nullptr && Attribs.Src.pData != nullptr);
+    VERIFY_EXPR(Attribs.pDstData != nullptr);
+    VERIFY(Attribs.Src.Stride >= Attribs.RowSize || Attribs.NumRows <= 1, "Source data row stride (", Attribs.Src.Stride, ") is smaller than the row size (", Attribs.RowSize, ")");
+
+    const TextureSubresourceCopier Copier{Attribs};
+    VERIFY(Attribs.DstRowStride >= Copier.GetDstRowSize() || Attribs.NumRows <= 1, "Dst data row stride (", Attribs.DstRowStride, ") is smaller than the row size (", Copier.GetDstRowSize(), ")");
+
+    const size_t TotalSize = Copier.GetTotalSize();
+    if (TotalSize == 0)
+        return;
+
+    Uint32 NumThreads = Attribs.NumThreads != 0 ? Attribs.NumThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    // Do not create threads for small copies
+    NumThreads = static_cast<Uint32>(std::min(size_t{NumThreads}, std::max(TotalSize / std::max(Attribs.MinBytesPerThread, 1u), size_t{1})));
+    NumThreads = static_cast<Uint32>(std::min(size_t{NumThreads}, Copier.IsContiguous() ? TotalSize : Copier.GetTotalRows()));
+
+    auto ProcessRange = [&](Uint32 Range) {
+        if (Copier.IsContiguous())
+        {
+            // Split at cache line boundaries
+            const auto GetOffset = [&](Uint32 i) {
+                return i < NumThreads ? AlignDown(TotalSize * i / NumThreads, size_t{64}) : TotalSize;
+            };
+            Copier.CopyBytes(GetOffset(Range), GetOffset(Range + 1));
+        }
+        else
+        {
+            const size_t TotalRows = Copier.GetTotalRows();
+            Copier.CopyRows(TotalRows * Range / NumThreads, TotalRows * (Range + 1) / NumThreads);
+        }
+        Copier.Finish();
+    };
+
+    ParallelFor(NumThreads, NumThreads, ProcessRange);
+}
+
 void CopyTextureSubresource(const TextureSubResData& SrcSubres,
                             Uint32                   NumRows,
                             Uint32                   NumDepthSlices,
@@ -1773,22 +1989,17 @@ void CopyTextureSubresource(const TextureSubResData& SrcSubres,
                             Uint32                   DstRowStride,
                             Uint32                   DstDepthStride)
 {
-    VERIFY_EXPR(SrcSubres.pSrcBuffer == nullptr && SrcSubres.pData != nullptr);
-    VERIFY_EXPR(pDstData != nullptr);
-    VERIFY(SrcSubres.Stride >= RowSize, "Source data row stride (", SrcSubres.Stride, ") is smaller than the row size (", RowSize, ")");
-    VERIFY(DstRowStride >= RowSize, "Dst data row stride (", DstRowStride, ") is smaller than the row size (", RowSize, ")");
-    for (Uint32 z = 0; z < NumDepthSlices; ++z)
-    {
-        const auto* pSrcSlice = reinterpret_cast<const Uint8*>(SrcSubres.pData) + SrcSubres.DepthStride * z;
-        auto*       pDstSlice = reinterpret_cast<Uint8*>(pDstData) + DstDepthStride * z;
-
-        for (Uint32 y = 0; y < NumRows; ++y)
-        {
-            memcpy(pDstSlice + DstRowStride * y,
-                   pSrcSlice + SrcSubres.Stride * y,
-                   RowSize);
-        }
-    }
+    CopyTextureSubresourceAttribs Attribs;
+    Attribs.Src            = SrcSubres;
+    Attribs.NumRows        = NumRows;
+    Attribs.NumDepthSlices = NumDepthSlices;
+    Attribs.RowSize        = RowSize;
+    Attribs.pDstData       = pDstData;
+    Attribs.DstRowStride   = DstRowStride;
+    Attribs.DstDepthStride = DstDepthStride;
+    // This overload is used by the engine backends that copy the data on the calling thread
+    Attribs.NumThreads = 1;
+    CopyTextureSubresource(Attribs);
 }
 
 String GetCommandQueueTypeString(COMMAND_QUEUE_TYPE Type)
@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderCreateInfoWrapper.hpp"
+
+#include <cstring>
+
+namespace Diligent
+{
+
+ShaderCreateInfoWrapper::ShaderCreateInfoWrapper(const ShaderCreateInfo& ShaderCI) :
+    m_CreateInfo{ShaderCI},
+    m_pSourceStreamFactory{ShaderCI.pShaderSourceStreamFactory}
+{
+    m_CreateInfo.FilePath              = CopyString(ShaderCI.FilePath);
+    m_CreateInfo.Source                = CopyString(ShaderCI.Source);
+    m_CreateInfo.EntryPoint            = CopyString(ShaderCI.EntryPoint);
+    m_CreateInfo.CombinedSamplerSuffix = CopyString(ShaderCI.CombinedSamplerSuffix);
+    m_CreateInfo.Desc.Name             = CopyString(ShaderCI.Desc.Name);
+
+    if (ShaderCI.ByteCode != nullptr && ShaderCI.ByteCodeSize != 0)
+    {
+        const auto* pByteCode = static_cast<const Uint8*>(ShaderCI.ByteCode);
+        m_ByteCode.assign(pByteCode, pByteCode + ShaderCI.ByteCodeSize);
+        m_CreateInfo.ByteCode = m_ByteCode.data();
+    }
+
+    if (ShaderCI.Macros != nullptr)
+    {
+        for (const auto* pMacro = ShaderCI.Macros; pMacro->Name != nullptr && pMacro->Definition != nullptr; ++pMacro)
+            m_Macros.emplace_back(CopyString(pMacro->Name), CopyString(pMacro->Definition));
+        m_Macros.emplace_back(nullptr, nullptr);
+        m_CreateInfo.Macros = m_Macros.data();
+    }
+
+    m_CreateInfo.ppConversionStream = nullptr;
+    m_CreateInfo.ppCompilerOutput   = nullptr;
+}
+
+const Char* ShaderCreateInfoWrapper::CopyString(const Char* Str)
+{
+    if (Str == nullptr)
+        return nullptr;
+
+    m_Strings.emplace_back(Str);
+    return m_Strings.back().c_str();
+}
+
+} // namespace Diligent
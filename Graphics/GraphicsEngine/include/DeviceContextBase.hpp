@@ -444,7 +444,8 @@ protected:
 
     inline bool SetStencilRef(Uint32 StencilRef, int Dummy);
 
-    inline void SetPipelineState(PipelineStateImplType* pPipelineState, int /*Dummy*/);
+    /// Returns false if the pipeline state is not ready and must not be bound.
+    inline bool SetPipelineState(PipelineStateImplType* pPipelineState, int /*Dummy*/);
 
     /// Clears all cached resources
     inline void ClearStateCache();
@@ -740,7 +741,7 @@ inline void DeviceContextBase<ImplementationTraits>::SetVertexBuffers(
 }
 
 template <typename ImplementationTraits>
-inline void DeviceContextBase<ImplementationTraits>::SetPipelineState(
+inline bool DeviceContextBase<ImplementationTraits>::SetPipelineState(
     PipelineStateImplType* pPipelineState,
     int /*Dummy*/)
 {
@@ -748,7 +749,17 @@ inline void DeviceContextBase<ImplementationTraits>::SetPipelineState(
     DEV_CHECK_ERR((pPipelineState->GetDesc().ImmediateContextMask & (Uint64{1} << GetExecutionCtxId())) != 0,
                   "PSO '", pPipelineState->GetDesc().Name, "' can't be used in device context '", m_Desc.Name, "'.");
 
+    // Binding a pipeline that is still being compiled or failed to compile is an error in all builds:
+    // its backend objects are not initialized.
+    if (pPipelineState->GetStatus(false) != PIPELINE_STATE_STATUS_READY)
+    {
+        LOG_ERROR_MESSAGE("PSO '", pPipelineState->GetDesc().Name, "' is not ready and will not be bound. ",
+                          "Use GetStatus() to check the status of asynchronously created pipelines.");
+        return false;
+    }
+
     m_pPipelineState = pPipelineState;
+    return true;
 }
 
 template <typename ImplementationTraits>
@@ -35,6 +35,7 @@
 #include <unordered_set>
 #include <cstring>
 #include <vector>
+#include <memory>
 
 #include "PrivateConstants.h"
 #include "PipelineState.h"
@@ -45,6 +46,7 @@
 #include "FixedLinearAllocator.hpp"
 #include "HashUtils.hpp"
 #include "PipelineResourceSignatureBase.hpp"
+#include "AsyncInitializer.hpp"
 
 namespace Diligent
 {
@@ -221,6 +223,7 @@ public:
     void Destruct()
     {
         VERIFY(!m_IsDestructed, "This object has already been destructed");
+        VERIFY(!m_AsyncInitializer, "Async initializer must be reset before the object is destructed");
 
         if (this->m_Desc.IsAnyGraphicsPipeline() && m_pGraphicsPipelineData != nullptr)
         {
@@ -329,6 +332,13 @@ public:
     {
         *ppShaderResourceBinding = nullptr;
 
+        if (GetStatus(false) != PIPELINE_STATE_STATUS_READY)
+        {
+            LOG_ERROR_MESSAGE("Pipeline state '", this->m_Desc.Name, "' is not ready. ",
+                              "Shader resource bindings can't be created until the pipeline is successfully compiled.");
+            return;
+        }
+
         if (!m_UsingImplicitSignature)
         {
             LOG_ERROR_MESSAGE("IPipelineState::CreateShaderResourceBinding is not allowed for pipelines that use explicit "
@@ -437,6 +447,23 @@ public:
         return m_Signatures[Index];
     }
 
+    /// Implementation of IPipelineState::GetStatus().
+    virtual PIPELINE_STATE_STATUS DILIGENT_CALL_TYPE GetStatus(bool WaitForCompletion) override
+    {
+        if (!m_AsyncInitializer)
+            return PIPELINE_STATE_STATUS_READY;
+
+        switch (m_AsyncInitializer->GetStatus(WaitForCompletion))
+        {
+            case AsyncInitializer::Status::Running: return PIPELINE_STATE_STATUS_COMPILING;
+            case AsyncInitializer::Status::Completed: return PIPELINE_STATE_STATUS_READY;
+            case AsyncInitializer::Status::Failed: return PIPELINE_STATE_STATUS_FAILED;
+            default:
+                UNEXPECTED("Unexpected async initializer status");
+                return PIPELINE_STATE_STATUS_UNINITIALIZED;
+        }
+    }
+
     /// Implementation of IPipelineState::IsCompatibleWith().
     virtual bool DILIGENT_CALL_TYPE IsCompatibleWith(const IPipelineState* pPSO) const override // May be overridden
     {
@@ -536,6 +563,17 @@ protected:
         ReserveResourceSignatures(CreateInfo, MemPool);
     }
 
+    // Waits until the shader that may have been created with SHADER_COMPILE_FLAG_ASYNCHRONOUS
+    // flag is compiled and throws an exception if the compilation has failed.
+    void WaitForShaderCompilation(IShader* pShader) const
+    {
+        if (pShader->GetStatus(true) != SHADER_STATUS_READY)
+        {
+            LOG_ERROR_AND_THROW("Shader '", pShader->GetDesc().Name, "' used by pipeline state '", this->m_Desc.Name,
+                                "' failed to compile.");
+        }
+    }
+
     template <typename ShaderImplType, typename TShaderStages>
     void ExtractShaders(const GraphicsPipelineStateCreateInfo& CreateInfo,
                         TShaderStages&                         ShaderStages)
@@ -546,6 +584,7 @@ protected:
         auto AddShaderStage = [&](IShader* pShader) {
             if (pShader != nullptr)
             {
+                WaitForShaderCompilation(pShader);
                 ShaderStages.emplace_back(ValidatedCast<ShaderImplType>(pShader));
                 const auto ShaderType = pShader->GetDesc().ShaderType;
                 VERIFY((m_ActiveShaderStages & ShaderType) == 0,
@@ -599,6 +638,7 @@ protected:
         VERIFY_EXPR(CreateInfo.pCS != nullptr);
         VERIFY_EXPR(CreateInfo.pCS->GetDesc().ShaderType == SHADER_TYPE_COMPUTE);
 
+        WaitForShaderCompilation(CreateInfo.pCS);
         ShaderStages.emplace_back(ValidatedCast<ShaderImplType>(CreateInfo.pCS));
         m_ActiveShaderStages = SHADER_TYPE_COMPUTE;
 
@@ -616,6 +656,7 @@ protected:
         auto AddShader = [&ShaderStages, &UniqueShaders, this](IShader* pShader) {
             if (pShader != nullptr && UniqueShaders.insert(pShader).second)
             {
+                WaitForShaderCompilation(pShader);
                 const auto ShaderType = pShader->GetDesc().ShaderType;
                 const auto StageInd   = GetShaderTypePipelineIndex(ShaderType, PIPELINE_TYPE_RAY_TRACING);
                 auto&      Stage      = ShaderStages[StageInd];
@@ -673,6 +714,7 @@ protected:
         VERIFY_EXPR(CreateInfo.pTS != nullptr);
         VERIFY_EXPR(CreateInfo.pTS->GetDesc().ShaderType == SHADER_TYPE_TILE);
 
+        WaitForShaderCompilation(CreateInfo.pTS);
         ShaderStages.emplace_back(ValidatedCast<ShaderImplType>(CreateInfo.pTS));
         m_ActiveShaderStages = SHADER_TYPE_TILE;
 
@@ -1156,6 +1198,10 @@ protected:
         void*                   m_pPipelineDataRawMem = nullptr;
     };
 
+    /// Initializer that creates the pipeline with PSO_CREATE_FLAG_ASYNCHRONOUS flag.
+    /// The derived class must reset it before calling Destruct().
+    std::unique_ptr<AsyncInitializer> m_AsyncInitializer;
+
 #ifdef DILIGENT_DEBUG
     bool m_IsDestructed = false;
 #endif
@@ -30,6 +30,9 @@
 /// \file
 /// Implementation of the Diligent::RenderDeviceBase template class and related structures
 
+#include <memory>
+#include <mutex>
+
 #include "RenderDevice.h"
 #include "DeviceObjectBase.hpp"
 #include "Defines.h"
@@ -44,6 +47,7 @@
 #include "EngineMemory.h"
 #include "STDAllocator.hpp"
 #include "IndexWrapper.hpp"
+#include "ThreadPool.hpp"
 
 namespace std
 {
@@ -55,21 +59,22 @@ struct hash<Diligent::SamplerDesc>
     {
         // Sampler name is ignored in comparison operator
         // and should not be hashed
-        return Diligent::ComputeHash( // SamDesc.Name,
-            static_cast<int>(SamDesc.MinFilter),
-            static_cast<int>(SamDesc.MagFilter),
-            static_cast<int>(SamDesc.MipFilter),
-            static_cast<int>(SamDesc.AddressU),
-            static_cast<int>(SamDesc.AddressV),
-            static_cast<int>(SamDesc.AddressW),
-            SamDesc.MipLODBias,
-            SamDesc.MaxAnisotropy,
-            static_cast<int>(SamDesc.ComparisonFunc),
-            SamDesc.BorderColor[0],
-            SamDesc.BorderColor[1],
-            SamDesc.BorderColor[2],
-            SamDesc.BorderColor[3],
-            SamDesc.MinLOD, SamDesc.MaxLOD);
+        Diligent::Hasher64 Hasher;
+        Hasher.Update(SamDesc.MinFilter,
+                      SamDesc.MagFilter,
+                      SamDesc.MipFilter,
+                      SamDesc.AddressU,
+                      SamDesc.AddressV,
+                      SamDesc.AddressW,
+                      SamDesc.MipLODBias,
+                      SamDesc.MaxAnisotropy,
+                      SamDesc.ComparisonFunc,
+                      SamDesc.BorderColor[0],
+                      SamDesc.BorderColor[1],
+                      SamDesc.BorderColor[2],
+                      SamDesc.BorderColor[3],
+                      SamDesc.MinLOD, SamDesc.MaxLOD);
+        return static_cast<size_t>(Hasher.Digest());
     }
 };
 
@@ -77,12 +82,19 @@ struct hash<Diligent::SamplerDesc>
 template <>
 struct hash<Diligent::StencilOpDesc>
 {
+    static void Update(Diligent::Hasher64& Hasher, const Diligent::StencilOpDesc& StOpDesc)
+    {
+        Hasher.Update(StOpDesc.StencilFailOp,
+                      StOpDesc.StencilDepthFailOp,
+                      StOpDesc.StencilPassOp,
+                      StOpDesc.StencilFunc);
+    }
+
     size_t operator()(const Diligent::StencilOpDesc& StOpDesc) const
     {
-        return Diligent::ComputeHash(static_cast<int>(StOpDesc.StencilFailOp),
-                                     static_cast<int>(StOpDesc.StencilDepthFailOp),
-                                     static_cast<int>(StOpDesc.StencilPassOp),
-                                     static_cast<int>(StOpDesc.StencilFunc));
+        Diligent::Hasher64 Hasher;
+        Update(Hasher, StOpDesc);
+        return static_cast<size_t>(Hasher.Digest());
     }
 };
 
@@ -92,14 +104,16 @@ struct hash<Diligent::DepthStencilStateDesc>
 {
     size_t operator()(const Diligent::DepthStencilStateDesc& DepthStencilDesc) const
     {
-        return Diligent::ComputeHash(DepthStencilDesc.DepthEnable,
-                                     DepthStencilDesc.DepthWriteEnable,
-                                     static_cast<int>(DepthStencilDesc.DepthFunc),
-                                     DepthStencilDesc.StencilEnable,
-                                     DepthStencilDesc.StencilReadMask,
-                                     DepthStencilDesc.StencilWriteMask,
-                                     DepthStencilDesc.FrontFace,
-                                     DepthStencilDesc.BackFace);
+        Diligent::Hasher64 Hasher;
+        Hasher.Update(DepthStencilDesc.DepthEnable,
+                      DepthStencilDesc.DepthWriteEnable,
+                      DepthStencilDesc.DepthFunc,
+                      DepthStencilDesc.StencilEnable,
+                      DepthStencilDesc.StencilReadMask,
+                      DepthStencilDesc.StencilWriteMask);
+        hash<Diligent::StencilOpDesc>::Update(Hasher, DepthStencilDesc.FrontFace);
+        hash<Diligent::StencilOpDesc>::Update(Hasher, DepthStencilDesc.BackFace);
+        return static_cast<size_t>(Hasher.Digest());
     }
 };
 
@@ -109,15 +123,17 @@ struct hash<Diligent::RasterizerStateDesc>
 {
     size_t operator()(const Diligent::RasterizerStateDesc& RasterizerDesc) const
     {
-        return Diligent::ComputeHash(static_cast<int>(RasterizerDesc.FillMode),
-                                     static_cast<int>(RasterizerDesc.CullMode),
-                                     RasterizerDesc.FrontCounterClockwise,
-                                     RasterizerDesc.DepthBias,
-                                     RasterizerDesc.DepthBiasClamp,
-                                     RasterizerDesc.SlopeScaledDepthBias,
-                                     RasterizerDesc.DepthClipEnable,
-                                     RasterizerDesc.ScissorEnable,
-                                     RasterizerDesc.AntialiasedLineEnable);
+        Diligent::Hasher64 Hasher;
+        Hasher.Update(RasterizerDesc.FillMode,
+                      RasterizerDesc.CullMode,
+                      RasterizerDesc.FrontCounterClockwise,
+                      RasterizerDesc.DepthBias,
+                      RasterizerDesc.DepthBiasClamp,
+                      RasterizerDesc.SlopeScaledDepthBias,
+                      RasterizerDesc.DepthClipEnable,
+                      RasterizerDesc.ScissorEnable,
+                      RasterizerDesc.AntialiasedLineEnable);
+        return static_cast<size_t>(Hasher.Digest());
     }
 };
 
@@ -127,24 +143,22 @@ struct hash<Diligent::BlendStateDesc>
 {
     size_t operator()(const Diligent::BlendStateDesc& BSDesc) const
     {
-        std::size_t Seed = 0;
+        Diligent::Hasher64 Hasher;
         for (size_t i = 0; i < Diligent::MAX_RENDER_TARGETS; ++i)
         {
             const auto& rt = BSDesc.RenderTargets[i];
-            Diligent::HashCombine(Seed,
-                                  rt.BlendEnable,
-                                  static_cast<int>(rt.SrcBlend),
-                                  static_cast<int>(rt.DestBlend),
-                                  static_cast<int>(rt.BlendOp),
-                                  static_cast<int>(rt.SrcBlendAlpha),
-                                  static_cast<int>(rt.DestBlendAlpha),
-                                  static_cast<int>(rt.BlendOpAlpha),
-                                  rt.RenderTargetWriteMask);
+            Hasher.Update(rt.BlendEnable,
+                          rt.SrcBlend,
+                          rt.DestBlend,
+                          rt.BlendOp,
+                          rt.SrcBlendAlpha,
+                          rt.DestBlendAlpha,
+                          rt.BlendOpAlpha,
+                          rt.RenderTargetWriteMask);
         }
-        Diligent::HashCombine(Seed,
-                              BSDesc.AlphaToCoverageEnable,
-                              BSDesc.IndependentBlendEnable);
-        return Seed;
+        Hasher.Update(BSDesc.AlphaToCoverageEnable,
+                      BSDesc.IndependentBlendEnable);
+        return static_cast<size_t>(Hasher.Digest());
     }
 };
 
@@ -155,18 +169,17 @@ struct hash<Diligent::TextureViewDesc>
 {
     size_t operator()(const Diligent::TextureViewDesc& TexViewDesc) const
     {
-        std::size_t Seed = 0;
-        Diligent::HashCombine(Seed,
-                              static_cast<Diligent::Int32>(TexViewDesc.ViewType),
-                              static_cast<Diligent::Int32>(TexViewDesc.TextureDim),
-                              static_cast<Diligent::Int32>(TexViewDesc.Format),
-                              TexViewDesc.MostDetailedMip,
-                              TexViewDesc.NumMipLevels,
-                              TexViewDesc.FirstArraySlice,
-                              TexViewDesc.NumArraySlices,
-                              static_cast<Diligent::Uint32>(TexViewDesc.AccessFlags),
-                              static_cast<Diligent::Uint32>(TexViewDesc.Flags));
-        return Seed;
+        Diligent::Hasher64 Hasher;
+        Hasher.Update(TexViewDesc.ViewType,
+                      TexViewDesc.TextureDim,
+                      TexViewDesc.Format,
+                      TexViewDesc.MostDetailedMip,
+                      TexViewDesc.NumMipLevels,
+                      TexViewDesc.FirstArraySlice,
+                      TexViewDesc.NumArraySlices,
+                      TexViewDesc.AccessFlags,
+                      TexViewDesc.Flags);
+        return static_cast<size_t>(Hasher.Digest());
     }
 };
 
@@ -237,6 +250,8 @@ public:
     ///
     /// \remarks Render device uses fixed block allocators (see FixedBlockMemoryAllocator) to allocate memory for
     ///          device objects. The object sizes from EngineImplTraits are used to initialize the allocators.
+    ///          Allocators for objects that are frequently created and destroyed from multiple threads
+    ///          (textures, buffers, views, pipeline states and SRBs) use per-thread block caches.
     RenderDeviceBase(IReferenceCounters*        pRefCounters,
                      IMemoryAllocator&          RawMemAllocator,
                      IEngineFactory*            pEngineFactory,
@@ -253,14 +268,14 @@ public:
         m_wpImmediateContexts   (std::max(1u, EngineCI.NumImmediateContexts), RefCntWeakPtr<IDeviceContext>(), STD_ALLOCATOR_RAW_MEM(RefCntWeakPtr<IDeviceContext>, RawMemAllocator, "Allocator for vector< RefCntWeakPtr<IDeviceContext> >")),
         m_wpDeferredContexts    (EngineCI.NumDeferredContexts, RefCntWeakPtr<IDeviceContext>(), STD_ALLOCATOR_RAW_MEM(RefCntWeakPtr<IDeviceContext>, RawMemAllocator, "Allocator for vector< RefCntWeakPtr<IDeviceContext> >")),
         m_RawMemAllocator       {RawMemAllocator},
-        m_TexObjAllocator       {RawMemAllocator, sizeof(TextureImplType),                    64},
-        m_TexViewObjAllocator   {RawMemAllocator, sizeof(TextureViewImplType),                64},
-        m_BufObjAllocator       {RawMemAllocator, sizeof(BufferImplType),                    128},
-        m_BuffViewObjAllocator  {RawMemAllocator, sizeof(BufferViewImplType),                128},
+        m_TexObjAllocator       {RawMemAllocator, sizeof(TextureImplType),                    64, true},
+        m_TexViewObjAllocator   {RawMemAllocator, sizeof(TextureViewImplType),                64, true},
+        m_BufObjAllocator       {RawMemAllocator, sizeof(BufferImplType),                    128, true},
+        m_BuffViewObjAllocator  {RawMemAllocator, sizeof(BufferViewImplType),                128, true},
         m_ShaderObjAllocator    {RawMemAllocator, sizeof(ShaderImplType),                     32},
         m_SamplerObjAllocator   {RawMemAllocator, sizeof(SamplerImplType),                    32},
-        m_PSOAllocator          {RawMemAllocator, sizeof(PipelineStateImplType),             128},
-        m_SRBAllocator          {RawMemAllocator, sizeof(ShaderResourceBindingImplType),    1024},
+        m_PSOAllocator          {RawMemAllocator, sizeof(PipelineStateImplType),             128, true},
+        m_SRBAllocator          {RawMemAllocator, sizeof(ShaderResourceBindingImplType),    1024, true},
         m_ResMappingAllocator   {RawMemAllocator, sizeof(ResourceMappingImpl),                16},
         m_FenceAllocator        {RawMemAllocator, sizeof(FenceImplType),                      16},
         m_QueryAllocator        {RawMemAllocator, sizeof(QueryImplType),                      16},
@@ -269,7 +284,8 @@ public:
         m_BLASAllocator         {RawMemAllocator, sizeof(BottomLevelASImplType),              16},
         m_TLASAllocator         {RawMemAllocator, sizeof(TopLevelASImplType),                 16},
         m_SBTAllocator          {RawMemAllocator, sizeof(ShaderBindingTableImplType),         16},
-        m_PipeResSignAllocator  {RawMemAllocator, sizeof(PipelineResourceSignatureImplType), 128}
+        m_PipeResSignAllocator  {RawMemAllocator, sizeof(PipelineResourceSignatureImplType), 128},
+        m_NumAsyncShaderCompilationThreads{EngineCI.NumAsyncShaderCompilationThreads}
     // clang-format on
     {
         // Initialize texture format info
@@ -439,6 +455,17 @@ public:
 
     VALIDATION_FLAGS GetValidationFlags() const { return m_ValidationFlags; }
 
+    /// Returns the thread pool that compiles shaders and initializes pipeline states
+    /// created asynchronously. The pool is created on first use.
+    ThreadPool& GetShaderCompilationThreadPool()
+    {
+        std::call_once(m_ShaderCompilationThreadPoolFlag,
+                       [this]() {
+                           m_pShaderCompilationThreadPool = std::make_unique<ThreadPool>(m_NumAsyncShaderCompilationThreads);
+                       });
+        return *m_pShaderCompilationThreadPool;
+    }
+
     // Convenience function
     const DeviceFeatures& GetFeatures() const
     {
@@ -690,6 +717,10 @@ protected:
     FixedBlockMemoryAllocator m_TLASAllocator;        ///< Allocator for top-level acceleration structure objects
     FixedBlockMemoryAllocator m_SBTAllocator;         ///< Allocator for shader binding table objects
     FixedBlockMemoryAllocator m_PipeResSignAllocator; ///< Allocator for pipeline resource signature objects
+
+    const Uint32                m_NumAsyncShaderCompilationThreads;
+    std::once_flag              m_ShaderCompilationThreadPoolFlag;
+    std::unique_ptr<ThreadPool> m_pShaderCompilationThreadPool;
 };
 
 } // namespace Diligent
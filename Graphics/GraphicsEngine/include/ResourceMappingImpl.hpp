@@ -30,12 +30,11 @@
 /// \file
 /// Declaration of the Diligent::ResourceMappingImpl class
 
-#include <unordered_map>
-
 #include "ResourceMapping.h"
 #include "ObjectBase.hpp"
 #include "HashUtils.hpp"
 #include "STDAllocator.hpp"
+#include "FlatHashMap.hpp"
 #include "RefCntAutoPtr.hpp"
 
 namespace Diligent
@@ -53,7 +52,7 @@ public:
     /// \param RawMemAllocator - raw memory allocator that is used by the m_HashTable member
     ResourceMappingImpl(IReferenceCounters* pRefCounters, IMemoryAllocator& RawMemAllocator) :
         TObjectBase{pRefCounters},
-        m_HashTable{STD_ALLOCATOR_RAW_MEM(HashTableElem, RawMemAllocator, "Allocator for unordered_map<ResMappingHashKey, RefCntAutoPtr<IDeviceObject>>")}
+        m_HashTable{STD_ALLOCATOR_RAW_MEM(HashTableElem, RawMemAllocator, "Allocator for FlatHashMap<ResMappingHashKey, RefCntAutoPtr<IDeviceObject>>")}
     {}
 
     ~ResourceMappingImpl();
@@ -127,11 +126,11 @@ private:
     ThreadingTools::LockFlag m_LockFlag;
 
     using HashTableElem = std::pair<const ResMappingHashKey, RefCntAutoPtr<IDeviceObject>>;
-    std::unordered_map<ResMappingHashKey,
-                       RefCntAutoPtr<IDeviceObject>,
-                       ResMappingHashKey::Hasher,
-                       std::equal_to<ResMappingHashKey>,
-                       STDAllocatorRawMem<HashTableElem>>
+    FlatHashMap<ResMappingHashKey,
+                RefCntAutoPtr<IDeviceObject>,
+                ResMappingHashKey::Hasher,
+                std::equal_to<ResMappingHashKey>,
+                STDAllocatorRawMem<HashTableElem>>
         m_HashTable;
 };
 
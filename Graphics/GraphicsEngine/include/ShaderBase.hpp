@@ -31,6 +31,7 @@
 /// Implementation of the Diligent::ShaderBase template class
 
 #include <vector>
+#include <memory>
 
 #include "Shader.h"
 #include "DeviceObjectBase.hpp"
@@ -38,6 +39,7 @@
 #include "PlatformMisc.hpp"
 #include "EngineMemory.h"
 #include "Align.hpp"
+#include "AsyncInitializer.hpp"
 
 namespace Diligent
 {
@@ -93,6 +95,36 @@ public:
     }
 
     IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_Shader, TDeviceObjectBase)
+
+    /// Implementation of IShader::GetStatus().
+    virtual SHADER_STATUS DILIGENT_CALL_TYPE GetStatus(bool WaitForCompletion) override
+    {
+        if (!m_AsyncInitializer)
+            return SHADER_STATUS_READY;
+
+        switch (m_AsyncInitializer->GetStatus(WaitForCompletion))
+        {
+            case AsyncInitializer::Status::Running: return SHADER_STATUS_COMPILING;
+            case AsyncInitializer::Status::Completed: return SHADER_STATUS_READY;
+            case AsyncInitializer::Status::Failed: return SHADER_STATUS_FAILED;
+            default:
+                UNEXPECTED("Unexpected async initializer status");
+                return SHADER_STATUS_UNINITIALIZED;
+        }
+    }
+
+protected:
+    /// Blocks until asynchronous compilation, if any, is finished.
+    void WaitForCompilation() const
+    {
+        if (m_AsyncInitializer)
+            m_AsyncInitializer->Wait();
+    }
+
+    /// Initializer that compiles the shader created with SHADER_COMPILE_FLAG_ASYNCHRONOUS flag.
+    /// The derived class must reset it in its destructor before any state accessed by the
+    /// compilation task is destroyed.
+    std::unique_ptr<AsyncInitializer> m_AsyncInitializer;
 };
 
 } // namespace Diligent
@@ -31,8 +31,8 @@
 /// Implementation of the Diligent::StateObjectsRegistry template class
 
 #include "DeviceObject.h"
-#include <unordered_map>
 #include "STDAllocator.hpp"
+#include "FlatHashMap.hpp"
 
 namespace Diligent
 {
@@ -51,13 +51,11 @@ namespace Diligent
 /// - Strong pointers will cause circular references and result in memory leaks.
 /// \remarks
 /// Only weak pointers provide thread-safe solution. The object is either atomically destroyed,
-/// so that no other thread can obtain a reference to it through weak pointers. Or it is atomically
-/// locked, so that strong reference is obtained. In this case no other thread can destroy the object,
-/// because there is at least one strong reference now. Note however that removing the object from the
-/// registry in the object's destructor may cause a deadlock at the point where Find() locks the weak pointer:
-/// if other thread has started dtor, the object will be locked by Diligent::RefCountedObject::Release().
-/// If after that this thread locks the registry first, it will be waiting for the object to unlock in
-/// Diligent::RefCntWeakPtr::Lock(), while the dtor thread will be waiting for the registry to unlock.
+/// so that no other thread can obtain a reference to it through weak pointers. Or a strong reference
+/// is atomically obtained, in which case no other thread can destroy the object, because there is at
+/// least one strong reference now. RefCntWeakPtr::Lock() does not block: it only increments the strong
+/// reference counter if it is not zero, and returns null if the object is being destroyed. Expired
+/// entries are removed by Find() and Purge().
 template <typename ResourceDescType>
 class StateObjectsRegistry
 {
@@ -67,7 +65,7 @@ public:
 
     StateObjectsRegistry(IMemoryAllocator& RawAllocator, const Char* RegistryName) :
         m_NumDeletedObjects{0},
-        m_DescToObjHashMap(STD_ALLOCATOR_RAW_MEM(HashMapElem, RawAllocator, "Allocator for unordered_map<ResourceDescType, RefCntWeakPtr<IDeviceObject> >")),
+        m_DescToObjHashMap(STD_ALLOCATOR_RAW_MEM(HashMapElem, RawAllocator, "Allocator for FlatHashMap<ResourceDescType, RefCntWeakPtr<IDeviceObject> >")),
         m_RegistryName{RegistryName}
     {}
 
@@ -205,8 +203,8 @@ private:
     Atomics::AtomicLong m_NumDeletedObjects;
 
     /// Hash map that stores weak pointers to the referenced objects
-    typedef std::pair<const ResourceDescType, RefCntWeakPtr<IDeviceObject>>                                                                                           HashMapElem;
-    std::unordered_map<ResourceDescType, RefCntWeakPtr<IDeviceObject>, std::hash<ResourceDescType>, std::equal_to<ResourceDescType>, STDAllocatorRawMem<HashMapElem>> m_DescToObjHashMap;
+    typedef std::pair<const ResourceDescType, RefCntWeakPtr<IDeviceObject>>                                                                                    HashMapElem;
+    FlatHashMap<ResourceDescType, RefCntWeakPtr<IDeviceObject>, std::hash<ResourceDescType>, std::equal_to<ResourceDescType>, STDAllocatorRawMem<HashMapElem>> m_DescToObjHashMap;
 
     /// Registry name used for debug output
     const String m_RegistryName;
@@ -2442,6 +2442,12 @@ struct EngineCreateInfo
     ///           deferred contexts to let the engine release stale resources.
     Uint32                   NumDeferredContexts    DEFAULT_INITIALIZER(0);
 
+    /// The number of worker threads used to compile shaders and initialize pipeline states
+    /// created with SHADER_COMPILE_FLAG_ASYNCHRONOUS or PSO_CREATE_FLAG_ASYNCHRONOUS flags.
+    /// If zero, the number of threads is selected automatically.
+    /// The threads are only started when the first asynchronous object is created.
+    Uint32                   NumAsyncShaderCompilationThreads DEFAULT_INITIALIZER(0);
+
     /// Requested device features.
 
     /// \remarks    If a feature is requested to be enabled, but is not supported
@@ -2878,6 +2884,15 @@ struct EngineVkCreateInfo DILIGENT_DERIVE(EngineCreateInfo)
     /// features when compiling shaders from HLSL.
     const char* pDxCompilerPath DEFAULT_INITIALIZER(nullptr);
 
+    /// Path to the directory of the persistent shader bytecode cache.
+    /// When not null, SPIR-V compiled from the shader source by glslang or DXC is stored
+    /// in the cache, and shaders whose preprocessed source matches a cache entry are not compiled again.
+    const char* pShaderCacheDirectory DEFAULT_INITIALIZER(nullptr);
+
+    /// The maximum total size of the shader bytecode cache, in bytes.
+    /// When the limit is exceeded, least recently used entries are evicted.
+    Uint32 ShaderCacheMaxSize DEFAULT_INITIALIZER(256 << 20);
+
 #if DILIGENT_CPP_INTERFACE
     EngineVkCreateInfo() noexcept :
         EngineVkCreateInfo{EngineCreateInfo{}}
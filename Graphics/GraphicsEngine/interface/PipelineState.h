@@ -410,10 +410,40 @@ DILIGENT_TYPED_ENUM(PSO_CREATE_FLAGS, Uint32)
     /// that is not found in any of the designated shader stages.
     /// Use this flag to silence these warnings.
     PSO_CREATE_FLAG_IGNORE_MISSING_IMMUTABLE_SAMPLERS = 0x02,
+
+    /// Create the pipeline state asynchronously.
+
+    /// IRenderDevice::CreateGraphicsPipelineState() and IRenderDevice::CreateComputePipelineState()
+    /// return the pipeline state object immediately while the resource layout and the
+    /// pipeline are initialized by the engine worker threads. The shaders used by the
+    /// pipeline may themselves still be compiling (see Diligent::SHADER_COMPILE_FLAG_ASYNCHRONOUS).
+    /// Use IPipelineState::GetStatus() to query the status.
+    ///
+    /// \remarks   Backends that do not support asynchronous creation, as well as ray tracing
+    ///            pipelines, ignore this flag and create the pipeline synchronously.
+    PSO_CREATE_FLAG_ASYNCHRONOUS                      = 0x04,
 };
 DEFINE_FLAG_ENUM_OPERATORS(PSO_CREATE_FLAGS);
 
 
+/// Pipeline state status
+DILIGENT_TYPED_ENUM(PIPELINE_STATE_STATUS, Uint32)
+{
+    /// Initial pipeline state status.
+    PIPELINE_STATE_STATUS_UNINITIALIZED = 0,
+
+    /// The pipeline state is being compiled.
+    PIPELINE_STATE_STATUS_COMPILING,
+
+    /// The pipeline state has been successfully compiled
+    /// and is ready to be used.
+    PIPELINE_STATE_STATUS_READY,
+
+    /// The pipeline state compilation has failed.
+    PIPELINE_STATE_STATUS_FAILED
+};
+
+
 /// Pipeline state creation attributes
 struct PipelineStateCreateInfo
 {
@@ -763,6 +793,18 @@ DILIGENT_BEGIN_INTERFACE(IPipelineState, IDeviceObject)
     /// \return     Pointer to pipeline resource signature interface.
     VIRTUAL IPipelineResourceSignature* METHOD(GetResourceSignature)(THIS_
                                                                      Uint32 Index) CONST PURE;
+
+    /// Returns the pipeline state status, see Diligent::PIPELINE_STATE_STATUS.
+
+    /// \param [in] WaitForCompletion - If true, the method will wait until the pipeline state is compiled.
+    ///                                 This parameter is only relevant if the pipeline state was created
+    ///                                 with the PSO_CREATE_FLAG_ASYNCHRONOUS flag.
+    ///
+    /// \remarks   The pipeline state must not be used to create shader resource bindings, access static
+    ///            variables or resource signatures, and must not be bound to a device context
+    ///            until its status is PIPELINE_STATE_STATUS_READY.
+    VIRTUAL PIPELINE_STATE_STATUS METHOD(GetStatus)(THIS_
+                                                    bool WaitForCompletion DEFAULT_VALUE(false)) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -785,6 +827,7 @@ DILIGENT_END_INTERFACE
 #    define IPipelineState_IsCompatibleWith(This, ...)             CALL_IFACE_METHOD(PipelineState, IsCompatibleWith,             This, __VA_ARGS__)
 #    define IPipelineState_GetResourceSignatureCount(This)         CALL_IFACE_METHOD(PipelineState, GetResourceSignatureCount,    This)
 #    define IPipelineState_GetResourceSignature(This, ...)         CALL_IFACE_METHOD(PipelineState, GetResourceSignature,         This, __VA_ARGS__)
+#    define IPipelineState_GetStatus(This, ...)                    CALL_IFACE_METHOD(PipelineState, GetStatus,                    This, __VA_ARGS__)
 
 // clang-format on
 
@@ -189,10 +189,40 @@ DILIGENT_TYPED_ENUM(SHADER_COMPILE_FLAGS, Uint32)
     /// Enable unbounded resource arrays (e.g. Texture2D g_Texture[]).
     SHADER_COMPILE_FLAG_ENABLE_UNBOUNDED_ARRAYS = 0x01,
 
-    SHADER_COMPILE_FLAG_LAST = SHADER_COMPILE_FLAG_ENABLE_UNBOUNDED_ARRAYS
+    /// Compile the shader asynchronously.
+
+    /// IRenderDevice::CreateShader() returns the shader object immediately while
+    /// the shader is compiled and reflected by the engine worker threads.
+    /// Use IShader::GetStatus() to query the compilation status.
+    ///
+    /// \remarks    ShaderCreateInfo::ppCompilerOutput and ShaderCreateInfo::ppConversionStream
+    ///             are ignored for asynchronously compiled shaders.
+    ///             Backends that do not support asynchronous compilation ignore this flag
+    ///             and compile the shader synchronously.
+    SHADER_COMPILE_FLAG_ASYNCHRONOUS = 0x02,
+
+    SHADER_COMPILE_FLAG_LAST = SHADER_COMPILE_FLAG_ASYNCHRONOUS
 };
 DEFINE_FLAG_ENUM_OPERATORS(SHADER_COMPILE_FLAGS);
 
+
+/// Shader status
+DILIGENT_TYPED_ENUM(SHADER_STATUS, Uint32)
+{
+    /// Initial shader status.
+    SHADER_STATUS_UNINITIALIZED = 0,
+
+    /// The shader is being compiled.
+    SHADER_STATUS_COMPILING,
+
+    /// The shader has been successfully compiled
+    /// and is ready to be used.
+    SHADER_STATUS_READY,
+
+    /// The shader compilation has failed.
+    SHADER_STATUS_FAILED
+};
+
 // clang-format on
 
 
@@ -398,6 +428,20 @@ DILIGENT_BEGIN_INTERFACE(IShader, IDeviceObject)
     VIRTUAL void METHOD(GetResourceDesc)(THIS_
                                          Uint32 Index,
                                          ShaderResourceDesc REF ResourceDesc) CONST PURE;
+
+    /// Returns the shader status, see Diligent::SHADER_STATUS.
+
+    /// \param [in] WaitForCompletion - If true, the method will wait until the shader is compiled.
+    ///                                 This parameter is only relevant if the shader was created
+    ///                                 with the SHADER_COMPILE_FLAG_ASYNCHRONOUS flag.
+    ///
+    /// \remarks   A shader that is still compiling may be used to create pipeline states:
+    ///            pipeline creation waits for the compilation to finish (on a worker thread
+    ///            if the pipeline is created with the PSO_CREATE_FLAG_ASYNCHRONOUS flag) and
+    ///            fails if the shader failed to compile. Methods that access the shader
+    ///            resources also wait for the compilation to finish.
+    VIRTUAL SHADER_STATUS METHOD(GetStatus)(THIS_
+                                            bool WaitForCompletion DEFAULT_VALUE(false)) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -411,6 +455,7 @@ DILIGENT_END_INTERFACE
 
 #    define IShader_GetResourceCount(This)     CALL_IFACE_METHOD(Shader, GetResourceCount, This)
 #    define IShader_GetResourceDesc(This, ...) CALL_IFACE_METHOD(Shader, GetResourceDesc,  This, __VA_ARGS__)
+#    define IShader_GetStatus(This, ...)       CALL_IFACE_METHOD(Shader, GetStatus,        This, __VA_ARGS__)
 
 // clang-format on
 
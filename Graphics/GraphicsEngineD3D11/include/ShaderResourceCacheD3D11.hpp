@@ -104,7 +104,7 @@ public:
             // clang-format on
         }
 
-        __forceinline void Set(RefCntAutoPtr<BufferD3D11Impl> _pBuff, Uint32 _BaseOffset, Uint32 _RangeSize)
+        __forceinline void Set(RefCntBorrowedPtr<BufferD3D11Impl> _pBuff, Uint32 _BaseOffset, Uint32 _RangeSize)
         {
             // Buffer offset in Direct3D11 must be a multiple of 16 float4 constants (16*16 bytes), and so must the range.
             // We, however, can't align the buffer size because UpdateSubresource() in Direct3D11 must be called for the
@@ -114,7 +114,8 @@ public:
             DEV_CHECK_ERR(_BaseOffset + _RangeSize <= (_pBuff ? _pBuff->GetDesc().uiSizeInBytes : 0), "The range is out of buffer bounds");
             DEV_CHECK_ERR((_BaseOffset % CBOffsetAlignment) == 0, "Buffer offset must be a multiple of ", CBOffsetAlignment);
 
-            pBuff = std::move(_pBuff);
+            // Assignment does not touch the reference counters if the same buffer is already bound
+            pBuff = _pBuff.RawPtr();
 
             BaseOffset = _BaseOffset;
             RangeSize  = _RangeSize;
@@ -211,19 +212,19 @@ public:
             // clang-format on
         }
 
-        __forceinline void Set(RefCntAutoPtr<TextureViewD3D11Impl> pTexView)
+        __forceinline void Set(RefCntBorrowedPtr<TextureViewD3D11Impl> pTexView)
         {
             pBuffer        = nullptr;
             pTexture       = pTexView ? pTexView->GetTexture<TextureBaseD3D11>() : nullptr;
-            pView          = std::move(pTexView);
+            pView          = pTexView.RawPtr();
             pd3d11Resource = pTexture ? pTexture->TextureBaseD3D11::GetD3D11Texture() : nullptr;
         }
 
-        __forceinline void Set(RefCntAutoPtr<BufferViewD3D11Impl> pBufView)
+        __forceinline void Set(RefCntBorrowedPtr<BufferViewD3D11Impl> pBufView)
         {
             pTexture       = nullptr;
             pBuffer        = pBufView ? pBufView->GetBuffer<BufferD3D11Impl>() : nullptr;
-            pView          = std::move(pBufView);
+            pView          = pBufView.RawPtr();
             pd3d11Resource = pBuffer ? pBuffer->BufferD3D11Impl::GetD3D11Buffer() : nullptr;
         }
 
@@ -251,7 +252,7 @@ public:
 
     template <D3D11_RESOURCE_RANGE ResRange, typename TSrcResourceType, typename... ExtraArgsType>
     inline void SetResource(const D3D11ResourceBindPoints& BindPoints,
-                            TSrcResourceType               pResource,
+                            TSrcResourceType&&             pResource,
                             const ExtraArgsType&... ExtraArgs);
 
     __forceinline void SetDynamicCBOffset(const D3D11ResourceBindPoints& BindPoints, Uint32 DynamicOffset);
@@ -804,7 +805,7 @@ __forceinline ID3D11UnorderedAccessView* ShaderResourceCacheD3D11::CachedResourc
 template <D3D11_RESOURCE_RANGE ResRange, typename TSrcResourceType, typename... ExtraArgsType>
 inline void ShaderResourceCacheD3D11::SetResource(
     const D3D11ResourceBindPoints& BindPoints,
-    TSrcResourceType               pResource,
+    TSrcResourceType&&             pResource,
     const ExtraArgsType&... ExtraArgs)
 {
     for (auto ActiveStages = BindPoints.GetActiveStages(); ActiveStages != SHADER_TYPE_UNKNOWN;)
@@ -816,7 +817,8 @@ inline void ShaderResourceCacheD3D11::SetResource(
         auto  ResArrays = GetResourceArrays<ResRange>(ShaderInd);
         auto& CachedRes = ResArrays.first[Binding];
         auto& pd3d11Res = ResArrays.second[Binding];
-        // Do not move the resource as we need to set it for multiple stages!
+        // The same resource is set for multiple stages. The setters borrow the resource and
+        // only add a strong reference when a different object is bound.
         CachedRes.Set(pResource, ExtraArgs...);
         pd3d11Res = ResArrays.first[Binding].GetD3D11Resource<ResRange>();
 
@@ -80,7 +80,9 @@ void DeviceContextD3D11Impl::SetPipelineState(IPipelineState* pPipelineState)
     if (PipelineStateD3D11Impl::IsSameObject(m_pPipelineState, pPipelineStateD3D11))
         return;
 
-    TDeviceContextBase::SetPipelineState(pPipelineStateD3D11, 0 /*Dummy*/);
+    if (!TDeviceContextBase::SetPipelineState(pPipelineStateD3D11, 0 /*Dummy*/))
+        return;
+
     const auto& Desc = pPipelineStateD3D11->GetDesc();
     if (Desc.PipelineType == PIPELINE_TYPE_COMPUTE)
     {
@@ -44,6 +44,26 @@ namespace Diligent
 {
 namespace
 {
+
+// Returns a borrowed pointer to the object that is being bound.
+// The object that is already cached at the binding was type-checked when it was bound and is kept
+// alive by the cache, so rebinding it does not query the interface, which would add and release
+// a strong reference. Otherwise, the interface is queried, and pQueried keeps the reference until
+// the object is stored in the cache.
+template <typename ImplType>
+RefCntBorrowedPtr<ImplType> BorrowBoundObject(IDeviceObject*           pObject,
+                                              const IDeviceObject*     pCachedObject,
+                                              const INTERFACE_ID&      IID,
+                                              RefCntAutoPtr<ImplType>& pQueried)
+{
+    if (pObject != nullptr && pObject == pCachedObject)
+        return RefCntBorrowedPtr<ImplType>{ValidatedCast<ImplType>(pObject)};
+
+    // We cannot use ValidatedCast<> here as the resource can be of wrong type
+    pQueried = RefCntAutoPtr<ImplType>{pObject, IID};
+    return pQueried;
+}
+
 template <typename HandlerType>
 void ProcessSignatureResources(const PipelineResourceSignatureD3D11Impl& Signature,
                                const SHADER_RESOURCE_VARIABLE_TYPE*      AllowedVarTypes,
@@ -271,8 +291,8 @@ void ShaderVariableManagerD3D11::ConstBuffBindInfo::BindResource(const BindResou
 
     auto& ResourceCache = m_ParentManager.m_ResourceCache;
 
-    // We cannot use ValidatedCast<> here as the resource can be of wrong type
-    RefCntAutoPtr<BufferD3D11Impl> pBuffD3D11Impl{BindInfo.pObject, IID_BufferD3D11};
+    RefCntAutoPtr<BufferD3D11Impl> pQueriedObj;
+    const auto                     pBuffD3D11Impl = BorrowBoundObject(BindInfo.pObject, ResourceCache.GetResource<D3D11_RESOURCE_RANGE_CBV>(Attr.BindPoints + BindInfo.ArrayIndex).Get(), IID_BufferD3D11, pQueriedObj);
 #ifdef DILIGENT_DEVELOPMENT
     {
         const auto& CachedCB = ResourceCache.GetResource<D3D11_RESOURCE_RANGE_CBV>(Attr.BindPoints + BindInfo.ArrayIndex);
@@ -281,7 +301,7 @@ void ShaderVariableManagerD3D11::ConstBuffBindInfo::BindResource(const BindResou
                                     m_ParentManager.m_pSignature->GetDesc().Name);
     }
 #endif
-    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_CBV>(Attr.BindPoints + BindInfo.ArrayIndex, std::move(pBuffD3D11Impl), BindInfo.BufferBaseOffset, BindInfo.BufferRangeSize);
+    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_CBV>(Attr.BindPoints + BindInfo.ArrayIndex, pBuffD3D11Impl, BindInfo.BufferBaseOffset, BindInfo.BufferRangeSize);
 }
 
 void ShaderVariableManagerD3D11::ConstBuffBindInfo::SetDynamicOffset(Uint32 ArrayIndex, Uint32 Offset)
@@ -308,8 +328,8 @@ void ShaderVariableManagerD3D11::TexSRVBindInfo::BindResource(const BindResource
 
     auto& ResourceCache = m_ParentManager.m_ResourceCache;
 
-    // We cannot use ValidatedCast<> here as the resource can be of wrong type
-    RefCntAutoPtr<TextureViewD3D11Impl> pViewD3D11{BindInfo.pObject, IID_TextureViewD3D11};
+    RefCntAutoPtr<TextureViewD3D11Impl> pQueriedObj;
+    const auto                          pViewD3D11 = BorrowBoundObject(BindInfo.pObject, ResourceCache.GetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex).Get(), IID_TextureViewD3D11, pQueriedObj);
 #ifdef DILIGENT_DEVELOPMENT
     {
         auto& CachedSRV = ResourceCache.GetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex);
@@ -352,7 +372,7 @@ void ShaderVariableManagerD3D11::TexSRVBindInfo::BindResource(const BindResource
             }
         }
     }
-    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex, std::move(pViewD3D11));
+    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex, pViewD3D11);
 }
 
 void ShaderVariableManagerD3D11::SamplerBindInfo::BindResource(const BindResourceInfo& BindInfo)
@@ -366,8 +386,8 @@ void ShaderVariableManagerD3D11::SamplerBindInfo::BindResource(const BindResourc
 
     auto& ResourceCache = m_ParentManager.m_ResourceCache;
 
-    // We cannot use ValidatedCast<> here as the resource can be of wrong type
-    RefCntAutoPtr<SamplerD3D11Impl> pSamplerD3D11{BindInfo.pObject, IID_SamplerD3D11};
+    RefCntAutoPtr<SamplerD3D11Impl> pQueriedObj;
+    const auto                      pSamplerD3D11 = BorrowBoundObject(BindInfo.pObject, ResourceCache.GetResource<D3D11_RESOURCE_RANGE_SAMPLER>(Attr.BindPoints + BindInfo.ArrayIndex).Get(), IID_SamplerD3D11, pQueriedObj);
 #ifdef DILIGENT_DEVELOPMENT
     {
         const auto& CachedSampler = ResourceCache.GetResource<D3D11_RESOURCE_RANGE_SAMPLER>(Attr.BindPoints + BindInfo.ArrayIndex);
@@ -375,7 +395,7 @@ void ShaderVariableManagerD3D11::SamplerBindInfo::BindResource(const BindResourc
     }
 #endif
 
-    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_SAMPLER>(Attr.BindPoints + BindInfo.ArrayIndex, std::move(pSamplerD3D11));
+    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_SAMPLER>(Attr.BindPoints + BindInfo.ArrayIndex, pSamplerD3D11);
 }
 
 void ShaderVariableManagerD3D11::BuffSRVBindInfo::BindResource(const BindResourceInfo& BindInfo)
@@ -388,8 +408,8 @@ void ShaderVariableManagerD3D11::BuffSRVBindInfo::BindResource(const BindResourc
 
     auto& ResourceCache = m_ParentManager.m_ResourceCache;
 
-    // We cannot use ValidatedCast<> here as the resource can be of wrong type
-    RefCntAutoPtr<BufferViewD3D11Impl> pViewD3D11{BindInfo.pObject, IID_BufferViewD3D11};
+    RefCntAutoPtr<BufferViewD3D11Impl> pQueriedObj;
+    const auto                         pViewD3D11 = BorrowBoundObject(BindInfo.pObject, ResourceCache.GetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex).Get(), IID_BufferViewD3D11, pQueriedObj);
 #ifdef DILIGENT_DEVELOPMENT
     {
         const auto& CachedSRV = ResourceCache.GetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex);
@@ -399,7 +419,7 @@ void ShaderVariableManagerD3D11::BuffSRVBindInfo::BindResource(const BindResourc
         ValidateBufferMode(Desc, BindInfo.ArrayIndex, pViewD3D11.RawPtr());
     }
 #endif
-    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex, std::move(pViewD3D11));
+    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_SRV>(Attr.BindPoints + BindInfo.ArrayIndex, pViewD3D11);
 }
 
 
@@ -413,8 +433,8 @@ void ShaderVariableManagerD3D11::TexUAVBindInfo::BindResource(const BindResource
 
     auto& ResourceCache = m_ParentManager.m_ResourceCache;
 
-    // We cannot use ValidatedCast<> here as the resource can be of wrong type
-    RefCntAutoPtr<TextureViewD3D11Impl> pViewD3D11{BindInfo.pObject, IID_TextureViewD3D11};
+    RefCntAutoPtr<TextureViewD3D11Impl> pQueriedObj;
+    const auto                          pViewD3D11 = BorrowBoundObject(BindInfo.pObject, ResourceCache.GetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex).Get(), IID_TextureViewD3D11, pQueriedObj);
 #ifdef DILIGENT_DEVELOPMENT
     {
         const auto& CachedUAV = ResourceCache.GetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex);
@@ -423,7 +443,7 @@ void ShaderVariableManagerD3D11::TexUAVBindInfo::BindResource(const BindResource
                                   m_ParentManager.m_pSignature->GetDesc().Name);
     }
 #endif
-    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex, std::move(pViewD3D11));
+    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex, pViewD3D11);
 }
 
 
@@ -437,8 +457,8 @@ void ShaderVariableManagerD3D11::BuffUAVBindInfo::BindResource(const BindResourc
 
     auto& ResourceCache = m_ParentManager.m_ResourceCache;
 
-    // We cannot use ValidatedCast<> here as the resource can be of wrong type
-    RefCntAutoPtr<BufferViewD3D11Impl> pViewD3D11{BindInfo.pObject, IID_BufferViewD3D11};
+    RefCntAutoPtr<BufferViewD3D11Impl> pQueriedObj;
+    const auto                         pViewD3D11 = BorrowBoundObject(BindInfo.pObject, ResourceCache.GetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex).Get(), IID_BufferViewD3D11, pQueriedObj);
 #ifdef DILIGENT_DEVELOPMENT
     {
         const auto& CachedUAV = ResourceCache.GetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex);
@@ -448,7 +468,7 @@ void ShaderVariableManagerD3D11::BuffUAVBindInfo::BindResource(const BindResourc
         ValidateBufferMode(Desc, BindInfo.ArrayIndex, pViewD3D11.RawPtr());
     }
 #endif
-    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex, std::move(pViewD3D11));
+    ResourceCache.SetResource<D3D11_RESOURCE_RANGE_UAV>(Attr.BindPoints + BindInfo.ArrayIndex, pViewD3D11);
 }
 
 
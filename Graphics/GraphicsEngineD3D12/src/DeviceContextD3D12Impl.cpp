@@ -233,7 +233,8 @@ void DeviceContextD3D12Impl::SetPipelineState(IPipelineState* pPipelineState)
             CommitScissor = m_pPipelineState->GetGraphicsPipelineDesc().RasterizerDesc.ScissorEnable != pPipelineStateD3D12->GetGraphicsPipelineDesc().RasterizerDesc.ScissorEnable;
     }
 
-    TDeviceContextBase::SetPipelineState(pPipelineStateD3D12, 0 /*Dummy*/);
+    if (!TDeviceContextBase::SetPipelineState(pPipelineStateD3D12, 0 /*Dummy*/))
+        return;
 
     auto& CmdCtx        = GetCmdContext();
     auto& RootInfo      = GetRootTableInfo(PSODesc.PipelineType);
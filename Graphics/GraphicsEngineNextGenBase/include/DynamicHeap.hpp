@@ -36,6 +36,7 @@
 #include <atomic>
 #include "VariableSizeAllocationsManager.hpp"
 #include "RingBuffer.hpp"
+#include "ConcurrentRingBuffer.hpp"
 
 namespace Diligent
 {
@@ -94,6 +95,134 @@ private:
     RingBuffer m_RingBuffer;
 };
 
+// Master block manager with the same interface as MasterBlockListBasedManager that allocates
+// master blocks from the ring buffer without locking a mutex, so that contexts recording commands
+// in parallel do not serialize on master block allocation.
+// Released blocks are returned to the ring buffer in any order. The space of a block is reused
+// once all blocks allocated before it have been released, so a block that is held for a long
+// time prevents the space after it from being reused.
+class MasterBlockConcurrentRingBufferBasedManager
+{
+public:
+    using OffsetType = ConcurrentRingBuffer::OffsetType;
+
+    struct MasterBlock
+    {
+        MasterBlock() noexcept {}
+
+        explicit MasterBlock(const ConcurrentRingBuffer::Range& _Range) noexcept :
+            UnalignedOffset{_Range.Offset},
+            Size{_Range.Size},
+            Range{_Range}
+        {}
+
+        bool IsValid() const { return UnalignedOffset != ConcurrentRingBuffer::InvalidOffset; }
+
+        OffsetType                  UnalignedOffset = ConcurrentRingBuffer::InvalidOffset;
+        OffsetType                  Size            = 0;
+        ConcurrentRingBuffer::Range Range;
+    };
+
+    MasterBlockConcurrentRingBufferBasedManager(IMemoryAllocator& Allocator,
+                                                Uint32            Size) :
+        m_RingBuffer{Size, Allocator}
+    {
+#ifdef DILIGENT_DEVELOPMENT
+        m_MasterBlockCounter = 0;
+#endif
+    }
+
+    // clang-format off
+    MasterBlockConcurrentRingBufferBasedManager            (const MasterBlockConcurrentRingBufferBasedManager&)  = delete;
+    MasterBlockConcurrentRingBufferBasedManager            (      MasterBlockConcurrentRingBufferBasedManager&&) = delete;
+    MasterBlockConcurrentRingBufferBasedManager& operator= (const MasterBlockConcurrentRingBufferBasedManager&)  = delete;
+    MasterBlockConcurrentRingBufferBasedManager& operator= (      MasterBlockConcurrentRingBufferBasedManager&&) = delete;
+    // clang-format on
+
+    ~MasterBlockConcurrentRingBufferBasedManager()
+    {
+        DEV_CHECK_ERR(m_MasterBlockCounter == 0, m_MasterBlockCounter, " master block(s) have not been returned to the manager");
+    }
+
+    template <typename RenderDeviceImplType>
+    void ReleaseMasterBlocks(std::vector<MasterBlock>& Blocks, RenderDeviceImplType& Device, Uint64 CmdQueueMask)
+    {
+        struct StaleMasterBlock
+        {
+            MasterBlock                                  Block;
+            MasterBlockConcurrentRingBufferBasedManager* Mgr;
+
+            // clang-format off
+            StaleMasterBlock(const MasterBlock& _Block, MasterBlockConcurrentRingBufferBasedManager* _Mgr)noexcept :
+                Block {_Block},
+                Mgr   {_Mgr  }
+            {
+            }
+
+            StaleMasterBlock            (const StaleMasterBlock&)  = delete;
+            StaleMasterBlock& operator= (const StaleMasterBlock&)  = delete;
+            StaleMasterBlock& operator= (      StaleMasterBlock&&) = delete;
+
+            StaleMasterBlock(StaleMasterBlock&& rhs)noexcept : 
+                Block {rhs.Block},
+                Mgr   {rhs.Mgr  }
+            {
+                rhs.Block = MasterBlock{};
+                rhs.Mgr   = nullptr;
+            }
+            // clang-format on
+
+            ~StaleMasterBlock()
+            {
+                if (Mgr != nullptr)
+                {
+#ifdef DILIGENT_DEVELOPMENT
+                    --Mgr->m_MasterBlockCounter;
+#endif
+                    Mgr->m_RingBuffer.Free(Block.Range);
+                }
+            }
+        };
+        for (auto& Block : Blocks)
+        {
+            DEV_CHECK_ERR(Block.IsValid(), "Attempting to release invalid master block");
+            Device.SafeReleaseDeviceObject(StaleMasterBlock{Block, this}, CmdQueueMask);
+        }
+    }
+
+    // clang-format off
+    OffsetType GetSize()     const { return m_RingBuffer.GetMaxSize(); }
+    OffsetType GetUsedSize() const { return m_RingBuffer.GetUsedSize();}
+    // clang-format on
+
+#ifdef DILIGENT_DEVELOPMENT
+    int32_t GetMasterBlockCounter() const
+    {
+        return m_MasterBlockCounter;
+    }
+#endif
+
+protected:
+    MasterBlock AllocateMasterBlock(OffsetType SizeInBytes, OffsetType Alignment)
+    {
+        MasterBlock NewBlock{m_RingBuffer.AllocateRange(SizeInBytes, Alignment)};
+#ifdef DILIGENT_DEVELOPMENT
+        if (NewBlock.IsValid())
+        {
+            ++m_MasterBlockCounter;
+        }
+#endif
+        return NewBlock;
+    }
+
+private:
+    ConcurrentRingBuffer m_RingBuffer;
+
+#ifdef DILIGENT_DEVELOPMENT
+    std::atomic_int32_t m_MasterBlockCounter;
+#endif
+};
+
 
 class MasterBlockListBasedManager
 {
@@ -36,6 +36,7 @@
 #include "InputLayout.h"
 #include "LockHelper.hpp"
 #include "HashUtils.hpp"
+#include "FlatHashMap.hpp"
 #include "DeviceContextBase.hpp"
 
 namespace Diligent
@@ -120,8 +121,8 @@ private:
     // Clears stale entries from m_PSOToKey and m_BuffToKey when a VAO is removed from m_Cache
     void ClearStaleKeys(const std::vector<VAOHashKey>& StaleKeys);
 
-    ThreadingTools::LockFlag                                                               m_CacheLockFlag;
-    std::unordered_map<VAOHashKey, GLObjectWrappers::GLVertexArrayObj, VAOHashKey::Hasher> m_Cache;
+    ThreadingTools::LockFlag                                                        m_CacheLockFlag;
+    FlatHashMap<VAOHashKey, GLObjectWrappers::GLVertexArrayObj, VAOHashKey::Hasher> m_Cache;
 
     std::unordered_multimap<UniqueIdentifier, VAOHashKey> m_PSOToKey;
     std::unordered_multimap<UniqueIdentifier, VAOHashKey> m_BuffToKey;
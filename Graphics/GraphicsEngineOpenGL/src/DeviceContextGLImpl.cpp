@@ -93,7 +93,8 @@ void DeviceContextGLImpl::SetPipelineState(IPipelineState* pPipelineState)
     if (PipelineStateGLImpl::IsSameObject(m_pPipelineState, pPipelineStateGLImpl))
         return;
 
-    TDeviceContextBase::SetPipelineState(pPipelineStateGLImpl, 0 /*Dummy*/);
+    if (!TDeviceContextBase::SetPipelineState(pPipelineStateGLImpl, 0 /*Dummy*/))
+        return;
 
     const auto& Desc = pPipelineStateGLImpl->GetDesc();
     if (Desc.PipelineType == PIPELINE_TYPE_COMPUTE)
@@ -67,17 +67,18 @@ std::size_t FBOCache::FBOCacheKeyHashFunc::operator()(const FBOCacheKey& Key) co
     if (Key.Hash == 0)
     {
         std::hash<TextureViewDesc> TexViewDescHasher;
-        Key.Hash = 0;
-        HashCombine(Key.Hash, Key.NumRenderTargets);
+        Hasher64                   Hasher;
+        Hasher.Update(Key.NumRenderTargets);
         for (Uint32 rt = 0; rt < Key.NumRenderTargets; ++rt)
         {
-            HashCombine(Key.Hash, Key.RTIds[rt]);
+            Hasher.Update(Key.RTIds[rt]);
             if (Key.RTIds[rt])
-                HashCombine(Key.Hash, TexViewDescHasher(Key.RTVDescs[rt]));
+                Hasher.Update(TexViewDescHasher(Key.RTVDescs[rt]));
         }
-        HashCombine(Key.Hash, Key.DSId);
+        Hasher.Update(Key.DSId);
         if (Key.DSId)
-            HashCombine(Key.Hash, TexViewDescHasher(Key.DSVDesc));
+            Hasher.Update(TexViewDescHasher(Key.DSVDesc));
+        Key.Hash = static_cast<size_t>(Hasher.Digest());
     }
     return Key.Hash;
 }
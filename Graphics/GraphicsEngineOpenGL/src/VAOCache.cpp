@@ -154,7 +154,8 @@ VAOCache::VAOHashKey::VAOHashKey(const VAOAttribs& Attribs) :
     const auto& InputLayout    = Attribs.PSO.GetGraphicsPipelineDesc().InputLayout;
     const auto* LayoutElements = InputLayout.LayoutElements;
 
-    Hash = ComputeHash(PsoUId, IndexBufferUId);
+    Hasher64 Hasher;
+    Hasher.Update(PsoUId, IndexBufferUId);
     for (Uint32 i = 0; i < InputLayout.NumElements; ++i)
     {
         const auto& LayoutElem = LayoutElements[i];
@@ -173,7 +174,7 @@ VAOCache::VAOHashKey::VAOHashKey(const VAOAttribs& Attribs) :
             DstStream.BufferUId = BuffId;
             DstStream.Offset    = SrcStream.Offset;
             UsedSlotsMask |= SlotBit;
-            HashCombine(Hash, DstStream.BufferUId, DstStream.Offset);
+            Hasher.Update(DstStream.BufferUId, DstStream.Offset);
         }
         else
         {
@@ -183,7 +184,8 @@ VAOCache::VAOHashKey::VAOHashKey(const VAOAttribs& Attribs) :
             VERIFY_EXPR(DstStream.Offset == SrcStream.Offset);
         }
     }
-    HashCombine(Hash, UsedSlotsMask);
+    Hasher.Update(UsedSlotsMask);
+    Hash = static_cast<size_t>(Hasher.Digest());
 }
 
 bool VAOCache::VAOHashKey::operator==(const VAOHashKey& Key) const
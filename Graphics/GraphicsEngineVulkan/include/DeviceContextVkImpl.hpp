@@ -58,6 +58,8 @@
 #include "ResourceReleaseQueue.hpp"
 #include "DescriptorPoolManager.hpp"
 #include "HashUtils.hpp"
+#include "ScratchMemoryAllocator.hpp"
+#include "STDAllocator.hpp"
 #include "ManagedVulkanObject.hpp"
 #include "QueryManagerVk.hpp"
 
@@ -378,6 +380,10 @@ public:
 
     size_t GetNumCommandsInCtx() const { return m_State.NumCommands; }
 
+    /// Returns the scratch memory statistics for the last finished frame.
+    /// The number of allocations is the number of heap allocations that were avoided.
+    const ScratchMemoryAllocator::Statistics& GetScratchMemoryStats() const { return m_ScratchAllocator.GetLastFrameStats(); }
+
     __forceinline VulkanUtilities::VulkanCommandBuffer& GetCommandBuffer()
     {
         EnsureVkCmdBuffer();
@@ -557,6 +563,14 @@ private:
 
     FixedBlockMemoryAllocator m_CmdListAllocator;
 
+    /// Scratch memory for temporary data that is released within the frame.
+    /// The allocator is reset by FinishFrame().
+    ScratchMemoryAllocator m_ScratchAllocator;
+
+    template <typename T>
+    using ScratchVector = std::vector<T, STDAllocator<T, ScratchMemoryAllocator>>;
+    using ScratchString = std::basic_string<char, std::char_traits<char>, STDAllocator<char, ScratchMemoryAllocator>>;
+
     // Semaphores are not owned by the command context
     std::vector<RefCntAutoPtr<ManagedSemaphore>>          m_WaitManagedSemaphores;
     std::vector<RefCntAutoPtr<ManagedSemaphore>>          m_SignalManagedSemaphores;
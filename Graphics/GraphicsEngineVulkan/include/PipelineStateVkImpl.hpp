@@ -106,6 +106,15 @@ public:
 #endif
 
 private:
+    template <typename PSOCreateInfoType>
+    void InitPipelineDesc(const PSOCreateInfoType& CreateInfo);
+
+    void InitializePipeline(const GraphicsPipelineStateCreateInfo& CreateInfo);
+    void InitializePipeline(const ComputePipelineStateCreateInfo& CreateInfo);
+
+    template <typename PSOCreateInfoType>
+    void InitializePipelineAsync(const PSOCreateInfoType& CreateInfo);
+
     template <typename PSOCreateInfoType>
     TShaderStages InitInternalObjects(const PSOCreateInfoType&                           CreateInfo,
                                       std::vector<VkPipelineShaderStageCreateInfo>&      vkShaderStages,
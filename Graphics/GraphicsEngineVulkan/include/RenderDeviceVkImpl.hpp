@@ -52,6 +52,7 @@
 #include "RenderPassCache.hpp"
 #include "CommandPoolManager.hpp"
 #include "DXCompiler.hpp"
+#include "ShaderBytecodeCache.hpp"
 
 namespace Diligent
 {
@@ -233,6 +234,9 @@ public:
 
     IDXCompiler* GetDxCompiler() const { return m_pDxCompiler.get(); }
 
+    // Returns null if the cache directory was not specified in EngineVkCreateInfo
+    ShaderBytecodeCache* GetShaderBytecodeCache() const { return m_pShaderBytecodeCache.get(); }
+
     struct Properties
     {
         const Uint32 ShaderGroupHandleSize;
@@ -282,7 +286,9 @@ private:
 
     VulkanDynamicMemoryManager m_DynamicMemoryManager;
 
-    std::unique_ptr<IDXCompiler> m_pDxCompiler;
+    // The cache must be declared before the compiler that references it
+    std::unique_ptr<ShaderBytecodeCache> m_pShaderBytecodeCache;
+    std::unique_ptr<IDXCompiler>         m_pDxCompiler;
 };
 
 } // namespace Diligent
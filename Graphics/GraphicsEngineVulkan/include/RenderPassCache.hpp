@@ -30,12 +30,12 @@
 /// \file
 /// Declaration of Diligent::RenderPassCache class
 
-#include <unordered_map>
 #include <mutex>
 
 #include "GraphicsTypes.h"
 #include "Constants.h"
 #include "HashUtils.hpp"
+#include "FlatHashMap.hpp"
 #include "VulkanUtilities/VulkanObjectWrappers.hpp"
 #include "RefCntAutoPtr.hpp"
 
@@ -114,9 +114,10 @@ public:
         {
             if (Hash == 0)
             {
-                Hash = ComputeHash(NumRenderTargets, SampleCount, DSVFormat);
-                for (Uint32 rt = 0; rt < NumRenderTargets; ++rt)
-                    HashCombine(Hash, RTVFormats[rt]);
+                Hasher64 Hasher;
+                Hasher.Update(NumRenderTargets, SampleCount, DSVFormat);
+                Hasher.UpdateRaw(RTVFormats, sizeof(RTVFormats[0]) * NumRenderTargets);
+                Hash = static_cast<size_t>(Hasher.Digest());
             }
             return Hash;
         }
@@ -140,8 +141,8 @@ private:
 
     RenderDeviceVkImpl& m_DeviceVkImpl;
 
-    std::mutex                                                                                      m_Mutex;
-    std::unordered_map<RenderPassCacheKey, RefCntAutoPtr<RenderPassVkImpl>, RenderPassCacheKeyHash> m_Cache;
+    std::mutex                                                                               m_Mutex;
+    FlatHashMap<RenderPassCacheKey, RefCntAutoPtr<RenderPassVkImpl>, RenderPassCacheKeyHash> m_Cache;
 };
 
 } // namespace Diligent
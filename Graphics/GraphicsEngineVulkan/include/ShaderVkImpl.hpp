@@ -51,7 +51,8 @@ public:
     /// Implementation of IShader::GetResourceCount() in Vulkan backend.
     virtual Uint32 DILIGENT_CALL_TYPE GetResourceCount() const override final
     {
-        return m_pShaderResources->GetTotalResources();
+        WaitForCompilation();
+        return m_pShaderResources ? m_pShaderResources->GetTotalResources() : 0;
     }
 
     /// Implementation of IShader::GetResource() in Vulkan backend.
@@ -60,14 +61,25 @@ public:
     /// Implementation of IShaderVk::GetSPIRV().
     virtual const std::vector<uint32_t>& DILIGENT_CALL_TYPE GetSPIRV() const override final
     {
+        WaitForCompilation();
         return m_SPIRV;
     }
 
-    const std::shared_ptr<const SPIRVShaderResources>& GetShaderResources() const { return m_pShaderResources; }
+    const std::shared_ptr<const SPIRVShaderResources>& GetShaderResources() const
+    {
+        WaitForCompilation();
+        return m_pShaderResources;
+    }
 
-    const char* GetEntryPoint() const { return m_EntryPoint.c_str(); }
+    const char* GetEntryPoint() const
+    {
+        WaitForCompilation();
+        return m_EntryPoint.c_str();
+    }
 
 private:
+    void Initialize(const ShaderCreateInfo& ShaderCI);
+
     void MapHLSLVertexShaderInputs();
 
     std::shared_ptr<const SPIRVShaderResources> m_pShaderResources;
@@ -113,11 +113,20 @@ struct VulkanDynamicAllocation
 //  |_______________________________________________________________________|
 //
 // We cannot use global memory manager for dynamic resources because they
-// need to use the same Vulkan buffer
-class VulkanDynamicMemoryManager : public DynamicHeap::MasterBlockListBasedManager
+// need to use the same Vulkan buffer.
+//
+// When DILIGENT_VK_CONCURRENT_DYNAMIC_HEAP is enabled, master blocks are allocated from
+// a lock-free ring buffer instead of the mutex-protected list-based allocator.
+#if DILIGENT_VK_CONCURRENT_DYNAMIC_HEAP
+using VulkanDynamicMemoryManagerBase = DynamicHeap::MasterBlockConcurrentRingBufferBasedManager;
+#else
+using VulkanDynamicMemoryManagerBase = DynamicHeap::MasterBlockListBasedManager;
+#endif
+
+class VulkanDynamicMemoryManager : public VulkanDynamicMemoryManagerBase
 {
 public:
-    using TBase       = DynamicHeap::MasterBlockListBasedManager;
+    using TBase       = VulkanDynamicMemoryManagerBase;
     using OffsetType  = TBase::OffsetType;
     using MasterBlock = TBase::MasterBlock;
 
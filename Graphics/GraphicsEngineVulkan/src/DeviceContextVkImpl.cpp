@@ -70,6 +70,7 @@ DeviceContextVkImpl::DeviceContextVkImpl(IReferenceCounters*                   p
         Desc
     },
     m_CmdListAllocator { GetRawAllocator(), sizeof(CommandListVkImpl), 64 },
+    m_ScratchAllocator { GetRawAllocator() },
     // Upload heap must always be thread-safe as Finish() may be called from another thread
     m_QueueFamilyCmdPools
     {
@@ -299,7 +300,9 @@ void DeviceContextVkImpl::SetPipelineState(IPipelineState* pPipelineState)
             CommitScissor = !m_pPipelineState->GetGraphicsPipelineDesc().RasterizerDesc.ScissorEnable;
     }
 
-    TDeviceContextBase::SetPipelineState(pPipelineStateVk, 0 /*Dummy*/);
+    if (!TDeviceContextBase::SetPipelineState(pPipelineStateVk, 0 /*Dummy*/))
+        return;
+
     EnsureVkCmdBuffer();
 
     auto vkPipeline = pPipelineStateVk->GetVkPipeline();
@@ -554,7 +557,7 @@ void DeviceContextVkImpl::CommitShaderResources(IShaderResourceBinding* pShaderR
         VkDescriptorSet vkDynamicDescrSet   = VK_NULL_HANDLE;
         const char*     DynamicDescrSetName = "Dynamic Descriptor Set";
 #ifdef DILIGENT_DEVELOPMENT
-        String _DynamicDescrSetName{DynamicDescrSetName};
+        ScratchString _DynamicDescrSetName(DynamicDescrSetName, STD_ALLOCATOR(char, ScratchMemoryAllocator, m_ScratchAllocator, "Dynamic descriptor set name"));
         _DynamicDescrSetName.append(" (");
         _DynamicDescrSetName.append(pSignature->GetDesc().Name);
         _DynamicDescrSetName += ')';
@@ -1211,6 +1214,9 @@ void DeviceContextVkImpl::FinishFrame()
     // be destroyed before the pools are actually returned to the global pool manager.
     m_DynamicDescrSetAllocator.ReleasePools(QueueMask);
 
+    // All temporary allocations have been released by now
+    m_ScratchAllocator.Reset();
+
     EndFrame();
 }
 
@@ -1231,9 +1237,8 @@ void DeviceContextVkImpl::Flush(Uint32               NumCommandLists,
     DEV_CHECK_ERR(m_pActiveRenderPass == nullptr,
                   "Flushing device context inside an active render pass.");
 
-    // TODO: replace with small_vector
-    std::vector<VkCommandBuffer>               vkCmdBuffs;
-    std::vector<RefCntAutoPtr<IDeviceContext>> DeferredCtxs;
+    ScratchVector<VkCommandBuffer>               vkCmdBuffs(STD_ALLOCATOR(VkCommandBuffer, ScratchMemoryAllocator, m_ScratchAllocator, "Command buffers to submit"));
+    ScratchVector<RefCntAutoPtr<IDeviceContext>> DeferredCtxs(STD_ALLOCATOR(RefCntAutoPtr<IDeviceContext>, ScratchMemoryAllocator, m_ScratchAllocator, "Deferred contexts to submit"));
     vkCmdBuffs.reserve(NumCommandLists + 1);
     DeferredCtxs.reserve(NumCommandLists + 1);
 
@@ -3083,9 +3088,9 @@ void DeviceContextVkImpl::BuildBLAS(const BuildBLASAttribs& Attribs)
     TransitionOrVerifyBLASState(*pBLASVk, Attribs.BLASTransitionMode, RESOURCE_STATE_BUILD_AS_WRITE, OpName);
     TransitionOrVerifyBufferState(*pScratchVk, Attribs.ScratchBufferTransitionMode, RESOURCE_STATE_BUILD_AS_WRITE, VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR, OpName);
 
-    VkAccelerationStructureBuildGeometryInfoKHR           vkASBuildInfo = {};
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR> vkRanges;
-    std::vector<VkAccelerationStructureGeometryKHR>       vkGeometries;
+    VkAccelerationStructureBuildGeometryInfoKHR             vkASBuildInfo = {};
+    ScratchVector<VkAccelerationStructureBuildRangeInfoKHR> vkRanges(STD_ALLOCATOR(VkAccelerationStructureBuildRangeInfoKHR, ScratchMemoryAllocator, m_ScratchAllocator, "BLAS build ranges"));
+    ScratchVector<VkAccelerationStructureGeometryKHR>       vkGeometries(STD_ALLOCATOR(VkAccelerationStructureGeometryKHR, ScratchMemoryAllocator, m_ScratchAllocator, "BLAS geometries"));
 
     if (Attribs.pTriangleData != nullptr)
     {
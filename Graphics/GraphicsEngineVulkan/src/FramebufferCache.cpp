@@ -58,9 +58,13 @@ size_t FramebufferCache::FramebufferCacheKey::GetHash() const
 {
     if (Hash == 0)
     {
-        Hash = ComputeHash(Pass, NumRenderTargets, DSV, CommandQueueMask);
-        for (Uint32 rt = 0; rt < NumRenderTargets; ++rt)
-            HashCombine(Hash, RTVs[rt]);
+        Hasher64 Hasher;
+        // Vulkan handles are either pointers or 64-bit integers depending on the platform
+        Hasher.UpdateRaw(Pass);
+        Hasher.UpdateRaw(DSV);
+        Hasher.Update(NumRenderTargets, CommandQueueMask);
+        Hasher.UpdateRaw(RTVs, sizeof(RTVs[0]) * NumRenderTargets);
+        Hash = static_cast<size_t>(Hasher.Digest());
     }
     return Hash;
 }
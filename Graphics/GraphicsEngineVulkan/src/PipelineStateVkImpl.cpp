@@ -534,6 +534,34 @@ void VerifyResourceMerge(const PipelineStateDesc&          PSODesc,
 #undef LOG_RESOURCE_MERGE_ERROR_AND_THROW
 }
 
+// Copies shader pointers to the create info that is used to initialize the pipeline
+// asynchronously, and keeps strong references to the shaders.
+void CopyShaders(const GraphicsPipelineStateCreateInfo& SrcCI,
+                 GraphicsPipelineStateCreateInfo&       DstCI,
+                 std::vector<RefCntAutoPtr<IShader>>&   Shaders)
+{
+    auto CopyShader = [&Shaders](IShader* pSrcShader, IShader*& pDstShader) {
+        pDstShader = pSrcShader;
+        if (pSrcShader != nullptr)
+            Shaders.emplace_back(pSrcShader);
+    };
+    CopyShader(SrcCI.pVS, DstCI.pVS);
+    CopyShader(SrcCI.pPS, DstCI.pPS);
+    CopyShader(SrcCI.pDS, DstCI.pDS);
+    CopyShader(SrcCI.pHS, DstCI.pHS);
+    CopyShader(SrcCI.pGS, DstCI.pGS);
+    CopyShader(SrcCI.pAS, DstCI.pAS);
+    CopyShader(SrcCI.pMS, DstCI.pMS);
+}
+
+void CopyShaders(const ComputePipelineStateCreateInfo& SrcCI,
+                 ComputePipelineStateCreateInfo&       DstCI,
+                 std::vector<RefCntAutoPtr<IShader>>&  Shaders)
+{
+    DstCI.pCS = SrcCI.pCS;
+    Shaders.emplace_back(SrcCI.pCS);
+}
+
 } // namespace
 
 
@@ -824,25 +852,30 @@ void PipelineStateVkImpl::InitPipelineLayout(TShaderStages& ShaderStages)
     }
 }
 
+template <typename PSOCreateInfoType>
+void PipelineStateVkImpl::InitPipelineDesc(const PSOCreateInfoType& CreateInfo)
+{
+    FixedLinearAllocator MemPool{GetRawAllocator()};
+
+    ReserveSpaceForPipelineDesc(CreateInfo, MemPool);
+
+    MemPool.Reserve();
+
+    InitializePipelineDesc(CreateInfo, MemPool);
+}
+
 template <typename PSOCreateInfoType>
 PipelineStateVkImpl::TShaderStages PipelineStateVkImpl::InitInternalObjects(
     const PSOCreateInfoType&                           CreateInfo,
     std::vector<VkPipelineShaderStageCreateInfo>&      vkShaderStages,
     std::vector<VulkanUtilities::ShaderModuleWrapper>& ShaderModules)
 {
+    // Waits for the shaders that are being compiled asynchronously
     TShaderStages ShaderStages;
     ExtractShaders<ShaderVkImpl>(CreateInfo, ShaderStages);
 
-    FixedLinearAllocator MemPool{GetRawAllocator()};
-
-    ReserveSpaceForPipelineDesc(CreateInfo, MemPool);
-
-    MemPool.Reserve();
-
     const auto& LogicalDevice = GetDevice()->GetLogicalDevice();
 
-    InitializePipelineDesc(CreateInfo, MemPool);
-
     InitPipelineLayout(ShaderStages);
 
     // Create shader modules and initialize shader stages
@@ -851,17 +884,59 @@ PipelineStateVkImpl::TShaderStages PipelineStateVkImpl::InitInternalObjects(
     return ShaderStages;
 }
 
+void PipelineStateVkImpl::InitializePipeline(const GraphicsPipelineStateCreateInfo& CreateInfo)
+{
+    std::vector<VkPipelineShaderStageCreateInfo>      vkShaderStages;
+    std::vector<VulkanUtilities::ShaderModuleWrapper> ShaderModules;
+
+    InitInternalObjects(CreateInfo, vkShaderStages, ShaderModules);
+
+    CreateGraphicsPipeline(GetDevice(), vkShaderStages, m_PipelineLayout, m_Desc, GetGraphicsPipelineDesc(), m_Pipeline, GetRenderPassPtr());
+}
+
+void PipelineStateVkImpl::InitializePipeline(const ComputePipelineStateCreateInfo& CreateInfo)
+{
+    std::vector<VkPipelineShaderStageCreateInfo>      vkShaderStages;
+    std::vector<VulkanUtilities::ShaderModuleWrapper> ShaderModules;
+
+    InitInternalObjects(CreateInfo, vkShaderStages, ShaderModules);
+
+    CreateComputePipeline(GetDevice(), vkShaderStages, m_PipelineLayout, m_Desc, m_Pipeline);
+}
+
+template <typename PSOCreateInfoType>
+void PipelineStateVkImpl::InitializePipelineAsync(const PSOCreateInfoType& CreateInfo)
+{
+    // Everything except for the shaders has already been copied by InitPipelineDesc().
+    // The application may release the shaders before the task is executed, so keep
+    // strong references to them.
+    PSOCreateInfoType ShadersCI;
+    ShadersCI.PSODesc.PipelineType = CreateInfo.PSODesc.PipelineType;
+
+    std::vector<RefCntAutoPtr<IShader>> Shaders;
+    CopyShaders(CreateInfo, ShadersCI, Shaders);
+
+    m_AsyncInitializer = std::make_unique<AsyncInitializer>(
+        GetDevice()->GetShaderCompilationThreadPool(),
+        [this, ShadersCI, Shaders]() mutable {
+            // The task object is destroyed after the completion is signalled, so release
+            // the shaders when the body exits, before the pipeline is reported as ready.
+            const auto TaskShaders = std::move(Shaders);
+            InitializePipeline(ShadersCI);
+        });
+}
+
 PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters* pRefCounters, RenderDeviceVkImpl* pDeviceVk, const GraphicsPipelineStateCreateInfo& CreateInfo) :
     TPipelineStateBase{pRefCounters, pDeviceVk, CreateInfo}
 {
     try
     {
-        std::vector<VkPipelineShaderStageCreateInfo>      vkShaderStages;
-        std::vector<VulkanUtilities::ShaderModuleWrapper> ShaderModules;
+        InitPipelineDesc(CreateInfo);
 
-        InitInternalObjects(CreateInfo, vkShaderStages, ShaderModules);
-
-        CreateGraphicsPipeline(pDeviceVk, vkShaderStages, m_PipelineLayout, m_Desc, GetGraphicsPipelineDesc(), m_Pipeline, GetRenderPassPtr());
+        if ((CreateInfo.Flags & PSO_CREATE_FLAG_ASYNCHRONOUS) != 0)
+            InitializePipelineAsync(CreateInfo);
+        else
+            InitializePipeline(CreateInfo);
     }
     catch (...)
     {
@@ -875,12 +950,12 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters* pRefCounters, Rende
 {
     try
     {
-        std::vector<VkPipelineShaderStageCreateInfo>      vkShaderStages;
-        std::vector<VulkanUtilities::ShaderModuleWrapper> ShaderModules;
+        InitPipelineDesc(CreateInfo);
 
-        InitInternalObjects(CreateInfo, vkShaderStages, ShaderModules);
-
-        CreateComputePipeline(pDeviceVk, vkShaderStages, m_PipelineLayout, m_Desc, m_Pipeline);
+        if ((CreateInfo.Flags & PSO_CREATE_FLAG_ASYNCHRONOUS) != 0)
+            InitializePipelineAsync(CreateInfo);
+        else
+            InitializePipeline(CreateInfo);
     }
     catch (...)
     {
@@ -899,6 +974,10 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters* pRefCounters, Rende
         std::vector<VkPipelineShaderStageCreateInfo>      vkShaderStages;
         std::vector<VulkanUtilities::ShaderModuleWrapper> ShaderModules;
 
+        // Ray tracing pipelines are always created synchronously as shader groups
+        // reference the shaders in the create info.
+        InitPipelineDesc(CreateInfo);
+
         const auto ShaderStages = InitInternalObjects(CreateInfo, vkShaderStages, ShaderModules);
 
         const auto vkShaderGroups = BuildRTShaderGroupDescription(CreateInfo, m_pRayTracingPipelineData->NameToGroupIndex, ShaderStages);
@@ -921,6 +1000,8 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters* pRefCounters, Rende
 
 PipelineStateVkImpl::~PipelineStateVkImpl()
 {
+    // Wait for the asynchronous initialization before releasing the objects it creates
+    m_AsyncInitializer.reset();
     Destruct();
 }
 
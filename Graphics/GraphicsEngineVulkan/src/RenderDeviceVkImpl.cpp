@@ -176,6 +176,23 @@ RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*
 
     for (Uint32 fmt = 1; fmt < m_TextureFormatsInfo.size(); ++fmt)
         m_TextureFormatsInfo[fmt].Supported = true; // We will test every format on a specific hardware device
+
+    if (EngineCI.pShaderCacheDirectory != nullptr)
+    {
+        ShaderBytecodeCache::CreateInfo CacheCI;
+        CacheCI.Directory = EngineCI.pShaderCacheDirectory;
+        CacheCI.MaxSize   = EngineCI.ShaderCacheMaxSize;
+        try
+        {
+            m_pShaderBytecodeCache = std::make_unique<ShaderBytecodeCache>(CacheCI);
+            m_pDxCompiler->SetBytecodeCache(m_pShaderBytecodeCache.get());
+        }
+        catch (...)
+        {
+            // The cache is an optimization, so the device is created without it
+            LOG_WARNING_MESSAGE("Failed to initialize shader bytecode cache in '", EngineCI.pShaderCacheDirectory, "'. Shader caching is disabled.");
+        }
+    }
 }
 
 RenderDeviceVkImpl::~RenderDeviceVkImpl()
@@ -37,6 +37,7 @@
 #include "GLSLUtils.hpp"
 #include "DXCompiler.hpp"
 #include "ShaderToolsCommon.hpp"
+#include "ShaderCreateInfoWrapper.hpp"
 
 #if !DILIGENT_NO_GLSLANG
 #    include "GLSLangUtils.hpp"
@@ -57,6 +58,29 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
     }
 // clang-format on
 {
+    if ((ShaderCI.CompileFlags & SHADER_COMPILE_FLAG_ASYNCHRONOUS) != 0)
+    {
+        // The create info and everything it references may be released as soon as
+        // CreateShader() returns, so the task works on a deep copy.
+        auto pShaderCI = std::make_shared<ShaderCreateInfoWrapper>(ShaderCI);
+
+        m_AsyncInitializer = std::make_unique<AsyncInitializer>(
+            pRenderDeviceVk->GetShaderCompilationThreadPool(),
+            [this, pShaderCI]() mutable {
+                // Release the copy as soon as the shader is compiled
+                const auto pTaskShaderCI = std::move(pShaderCI);
+                Initialize(*pTaskShaderCI);
+            });
+    }
+    else
+    {
+        Initialize(ShaderCI);
+    }
+}
+
+void ShaderVkImpl::Initialize(const ShaderCreateInfo& ShaderCI)
+{
+    auto* pRenderDeviceVk = GetDevice();
     if (ShaderCI.Source != nullptr || ShaderCI.FilePath != nullptr)
     {
         DEV_CHECK_ERR(ShaderCI.ByteCode == nullptr, "'ByteCode' must be null when shader is created from source code or a file");
@@ -102,7 +126,7 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
 #else
                 if (ShaderCI.SourceLanguage == SHADER_SOURCE_LANGUAGE_HLSL)
                 {
-                    m_SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, VulkanDefine, ShaderCI.ppCompilerOutput);
+                    m_SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, VulkanDefine, ShaderCI.ppCompilerOutput, pRenderDeviceVk->GetShaderBytecodeCache());
                 }
                 else
                 {
@@ -143,6 +167,7 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
                     Attribs.AssignBindings             = true;
                     Attribs.pShaderSourceStreamFactory = ShaderCI.pShaderSourceStreamFactory;
                     Attribs.ppCompilerOutput           = ShaderCI.ppCompilerOutput;
+                    Attribs.pCache                     = pRenderDeviceVk->GetShaderBytecodeCache();
 
                     if (VkVersion >= VK_API_VERSION_1_2)
                         Attribs.Version = GLSLangUtils::SpirvVersion::Vk120;
@@ -233,6 +258,8 @@ void ShaderVkImpl::MapHLSLVertexShaderInputs()
 
 ShaderVkImpl::~ShaderVkImpl()
 {
+    // Wait for the compilation task that may still be accessing the object
+    m_AsyncInitializer.reset();
 }
 
 void ShaderVkImpl::GetResourceDesc(Uint32 Index, ShaderResourceDesc& ResourceDesc) const
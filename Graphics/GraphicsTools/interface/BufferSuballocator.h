@@ -53,6 +53,9 @@ static const INTERFACE_ID IID_BufferSuballocator =
 struct IBufferSuballocation : public IObject
 {
     /// Returns the start offset of the suballocation.
+
+    /// \remarks   The offset may change when the allocator is defragmented,
+    ///             see IBufferSuballocator::EndDefragmentation().
     virtual Uint32 GetOffset() const = 0;
 
     /// Returns the suballocation size.
@@ -78,6 +81,21 @@ struct IBufferSuballocation : public IObject
 };
 
 
+/// Describes the relocation of a buffer suballocation performed by defragmentation,
+/// see IBufferSuballocator::BeginDefragmentation().
+struct BufferSuballocationMove
+{
+    /// Source offset of the data, in bytes.
+    Uint32 SrcOffset = 0;
+
+    /// Destination offset of the data, in bytes.
+    Uint32 DstOffset = 0;
+
+    /// The number of bytes to copy.
+    Uint32 Size = 0;
+};
+
+
 /// Buffer suballocator.
 struct IBufferSuballocator : public IObject
 {
@@ -108,6 +126,39 @@ struct IBufferSuballocator : public IObject
                           IBufferSuballocation** ppSuballocation) = 0;
 
 
+    /// Performs multiple suballocations from the buffer.
+
+    /// \param[in]  Count            - The number of suballocations.
+    /// \param[in]  pSizes           - Array of Count suballocation sizes.
+    /// \param[in]  pAlignments      - Array of Count required alignments. If this parameter is null,
+    ///                                all suballocations use alignment 1.
+    /// \param[out] ppSuballocations - Array of Count memory locations where pointers to the new
+    ///                                suballocations will be stored.
+    ///
+    /// \remarks    The method is equivalent to calling Allocate() for every suballocation, but
+    ///             the internal lock is only acquired once.
+    ///             The method is thread-safe and can be called from multiple threads simultaneously.
+    virtual void AllocateMultiple(Uint32                 Count,
+                                  const Uint32*          pSizes,
+                                  const Uint32*          pAlignments,
+                                  IBufferSuballocation** ppSuballocations) = 0;
+
+
+    /// Releases multiple suballocations.
+
+    /// \param[in]     Count            - The number of suballocations.
+    /// \param[in,out] ppSuballocations - Array of Count pointers to the suballocations to release.
+    ///                                   Every suballocation is released (i.e. its reference counter
+    ///                                   is decremented) and the pointer is set to null. Null pointers
+    ///                                   are ignored.
+    ///
+    /// \remarks    Space of all suballocations that are destroyed by the call and belong to this
+    ///             allocator is returned to the allocator while the internal lock is acquired once.
+    ///             The method is thread-safe and can be called from multiple threads simultaneously.
+    virtual void ReleaseMultiple(Uint32                 Count,
+                                 IBufferSuballocation** ppSuballocations) = 0;
+
+
     /// Returns the total remaining free size.
 
     /// \note   Due to fragmentation, total free size may be split between
@@ -115,8 +166,42 @@ struct IBufferSuballocator : public IObject
     virtual Uint32 GetFreeSize() = 0;
 
 
+    /// Begins incremental defragmentation of the buffer.
+
+    /// \param[in]  MaxBytesToMove - The maximum total size of the data, in bytes, that
+    ///                              may be moved by this defragmentation pass.
+    /// \param[out] NumMoves       - The number of elements in the returned array.
+    ///
+    /// \return     Pointer to the array of NumMoves moves. The array remains valid until
+    ///             EndDefragmentation() is called.
+    ///
+    /// \remarks    The method computes the relocation plan that moves suballocations from the
+    ///             end of the buffer to the free space closer to its beginning. Destination
+    ///             regions never overlap source regions or each other, so the moves can be
+    ///             performed in any order within the same buffer.
+    ///
+    ///             Suballocation offsets are not modified by this method. An application should
+    ///             copy the data of every move (e.g. with IDeviceContext::CopyBuffer) and call
+    ///             EndDefragmentation() afterwards. The contents of the moved suballocations must
+    ///             not be modified until then.
+    ///
+    ///             Only one defragmentation pass may be in progress at a time.
+    ///             The method is thread-safe and can be called simultaneously with Allocate().
+    virtual const BufferSuballocationMove* BeginDefragmentation(Uint32  MaxBytesToMove,
+                                                                Uint32& NumMoves) = 0;
+
+
+    /// Ends the defragmentation pass started by BeginDefragmentation().
+
+    /// \remarks    The method updates offsets of all relocated suballocations that are still
+    ///             alive, releases their original regions and increments the buffer version.
+    ///             Offsets are updated while the internal lock is held, so no allocation can
+    ///             observe a partially applied plan.
+    virtual void EndDefragmentation() = 0;
+
+
     /// Returns internal buffer version. The version is incremented every time
-    /// the buffer is expanded.
+    /// the buffer is expanded or suballocations are relocated by defragmentation.
     virtual Uint32 GetVersion() const = 0;
 };
 
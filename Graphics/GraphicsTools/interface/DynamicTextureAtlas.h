@@ -54,6 +54,9 @@ static const INTERFACE_ID IID_DynamicTextureAtlas =
 struct ITextureAtlasSuballocation : public IObject
 {
     /// Returns the suballocation origin.
+
+    /// \remarks   The origin and the slice may change when the atlas is defragmented,
+    ///             see IDynamicTextureAtlas::EndDefragmentation().
     virtual uint2 GetOrigin() const = 0;
 
     /// Returns the suballocation slice.
@@ -84,6 +87,26 @@ struct ITextureAtlasSuballocation : public IObject
     virtual IObject* GetUserData() const = 0;
 };
 
+/// Describes the relocation of a texture atlas suballocation performed by defragmentation,
+/// see IDynamicTextureAtlas::BeginDefragmentation().
+struct TextureAtlasSuballocationMove
+{
+    /// Source texture array slice.
+    Uint32 SrcSlice = 0;
+
+    /// Source region origin, in texels.
+    uint2 SrcOrigin;
+
+    /// Destination texture array slice.
+    Uint32 DstSlice = 0;
+
+    /// Destination region origin, in texels.
+    uint2 DstOrigin;
+
+    /// Region size, in texels.
+    uint2 Size;
+};
+
 /// Dynamic texture atlas.
 struct IDynamicTextureAtlas : public IObject
 {
@@ -123,8 +146,40 @@ struct IDynamicTextureAtlas : public IObject
     /// Returns the texture atlas description
     virtual const TextureDesc& GetAtlasDesc() const = 0;
 
+    /// Begins incremental defragmentation of the atlas.
+
+    /// \param[in]  MaxBytesToMove - The maximum total size of the texture data, in bytes, that
+    ///                              may be moved by this defragmentation pass. The size of
+    ///                              a region includes all mip levels.
+    /// \param[out] NumMoves       - The number of elements in the returned array.
+    ///
+    /// \return     Pointer to the array of NumMoves moves. The array remains valid until
+    ///             EndDefragmentation() is called.
+    ///
+    /// \remarks    The method computes the relocation plan that moves suballocations from the
+    ///             last slices of the texture array to the free space in the preceding slices.
+    ///             Destination regions never overlap source regions or each other.
+    ///
+    ///             Suballocation origins and slices are not modified by this method. An application
+    ///             should copy every mip level of each region (e.g. with IDeviceContext::CopyTexture) and
+    ///             call EndDefragmentation() afterwards. The contents of the moved suballocations must not
+    ///             be modified until then.
+    ///
+    ///             Only one defragmentation pass may be in progress at a time.
+    ///             The method is thread-safe and can be called simultaneously with Allocate().
+    virtual const TextureAtlasSuballocationMove* BeginDefragmentation(Uint64  MaxBytesToMove,
+                                                                      Uint32& NumMoves) = 0;
+
+
+    /// Ends the defragmentation pass started by BeginDefragmentation().
+
+    /// \remarks    The method updates origins and slices of all relocated suballocations that are
+    ///             still alive, releases their original regions and increments the texture version.
+    virtual void EndDefragmentation() = 0;
+
+
     /// Returns internal texture array version. The version is incremented every time
-    /// the array is expanded.
+    /// the array is expanded or suballocations are relocated by defragmentation.
     virtual Uint32 GetVersion() const = 0;
 };
 
@@ -34,6 +34,8 @@
 #include "../../GraphicsEngine/interface/Buffer.h"
 #include "../../GraphicsEngine/interface/RenderDevice.h"
 
+#include "../../../Primitives/interface/DefineGlobalFuncHelperMacros.h"
+
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
 void DILIGENT_GLOBAL_FUNCTION(CreateUniformBuffer)(IRenderDevice*                  pDevice,
@@ -61,4 +63,72 @@ void DILIGENT_GLOBAL_FUNCTION(ComputeMipLevel)(Uint32         FineLevelWidth,
                                                void*          pCoarseLevelData,
                                                Uint32         CoarseDataStrideInBytes);
 
+/// Filter type used by ComputeMipChain()
+DILIGENT_TYPED_ENUM(MIP_FILTER_TYPE, Uint8){
+    /// 2x2 box filter. This is the filter used by ComputeMipLevel().
+    MIP_FILTER_TYPE_BOX = 0,
+
+    /// Kaiser-windowed sinc filter (width 3, alpha 4).
+    MIP_FILTER_TYPE_KAISER,
+
+    /// Lanczos filter with 3 lobes.
+    MIP_FILTER_TYPE_LANCZOS};
+
+/// Mip level data for ComputeMipChain()
+struct MipChainLevelData
+{
+    /// Pointer to the level data.
+    void* pData DEFAULT_INITIALIZER(nullptr);
+
+    /// Row stride, in bytes.
+    Uint32 Stride DEFAULT_INITIALIZER(0);
+};
+typedef struct MipChainLevelData MipChainLevelData;
+
+/// ComputeMipChain() attributes
+struct ComputeMipChainAttribs
+{
+    /// Width of the most detailed mip level.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Height of the most detailed mip level.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// Texture format.
+    TEXTURE_FORMAT Format DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// An array of NumMipLevels mip level data elements.
+    /// Element 0 is the source level that is not modified. Levels 1 .. NumMipLevels-1
+    /// are computed, each one from the previous level.
+    MipChainLevelData* pMipLevels DEFAULT_INITIALIZER(nullptr);
+
+    /// The number of elements in pMipLevels array.
+    Uint32 NumMipLevels DEFAULT_INITIALIZER(0);
+
+    /// Filter type.
+
+    /// \remarks   Kaiser and Lanczos filters are only applied to normalized and floating-point
+    ///             formats. Integer formats always use the box filter.
+    MIP_FILTER_TYPE FilterType DEFAULT_INITIALIZER(MIP_FILTER_TYPE_BOX);
+
+    /// The number of threads to use. If zero, the number of hardware threads is used.
+    Uint32 NumThreads DEFAULT_INITIALIZER(0);
+};
+typedef struct ComputeMipChainAttribs ComputeMipChainAttribs;
+
+/// Computes a full mip chain on the CPU.
+
+/// \param [in] Attribs - Mip chain attributes, see Diligent::ComputeMipChainAttribs.
+///
+/// \remarks   The box filter produces the same results as a sequence of ComputeMipLevel() calls,
+///             except for sRGB formats that are averaged in linear space using exact conversion
+///             tables, and whose alpha channel is averaged linearly.
+///             16-bit floating-point formats are filtered in 32-bit precision.
+///
+///             The work is split between NumThreads threads. With the box filter, every thread
+///             processes its band of rows through several levels while the data is in the cache.
+void DILIGENT_GLOBAL_FUNCTION(ComputeMipChain)(const ComputeMipChainAttribs REF Attribs);
+
+#include "../../../Primitives/interface/UndefGlobalFuncHelperMacros.h"
+
 DILIGENT_END_NAMESPACE // namespace Diligent
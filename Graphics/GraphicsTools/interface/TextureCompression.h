@@ -0,0 +1,151 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines CPU block compression routines
+
+#include "../../GraphicsEngine/interface/Texture.h"
+
+#include "../../../Primitives/interface/DefineGlobalFuncHelperMacros.h"
+
+DILIGENT_BEGIN_NAMESPACE(Diligent)
+
+/// Block compression quality, see Diligent::CompressTextureAttribs.
+DILIGENT_TYPED_ENUM(BLOCK_COMPRESSION_QUALITY, Uint8){
+    /// Endpoints are taken from the principal axis of the block colors.
+    /// BC7 blocks only use mode 6.
+    BLOCK_COMPRESSION_QUALITY_FAST = 0,
+
+    /// Endpoints are refined with least squares, BC4 blocks also try the 6-value mode.
+    /// BC7 blocks also try modes 1, 3, 5 and 7 with the best estimated partitions.
+    BLOCK_COMPRESSION_QUALITY_NORMAL,
+
+    /// Additional refinement iterations, BC1 blocks also try the 3-color mode.
+    /// BC7 blocks try all modes, rotations and more partitions.
+    BLOCK_COMPRESSION_QUALITY_HIGH};
+
+/// CompressTexture() attributes
+struct CompressTextureAttribs
+{
+    /// Texture width, in texels.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Texture height, in texels.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// Source data format.
+
+    /// \remarks   Any format that can be converted to TEX_FORMAT_RGBA8_UNORM (or TEX_FORMAT_RGBA8_UNORM_SRGB
+    ///             for sRGB destination formats) by ConvertTextureData() is allowed.
+    TEXTURE_FORMAT SrcFormat DEFAULT_INITIALIZER(TEX_FORMAT_RGBA8_UNORM);
+
+    /// Source data. Only pData and Stride members are used.
+    TextureSubResData Src;
+
+    /// Block-compressed destination format: TEX_FORMAT_BC1_UNORM, TEX_FORMAT_BC2_UNORM,
+    /// TEX_FORMAT_BC3_UNORM, TEX_FORMAT_BC4_UNORM, TEX_FORMAT_BC5_UNORM, TEX_FORMAT_BC7_UNORM
+    /// or the sRGB version of these formats, see Diligent::IsBlockCompressionSupported().
+    /// \remarks   BC6H formats are not supported: the compressor only handles 8-bit data,
+    ///             while BC6H stores HDR half-precision data.
+    TEXTURE_FORMAT DstFormat DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// Pointer to the destination data.
+    void* pDstData DEFAULT_INITIALIZER(nullptr);
+
+    /// Distance between rows of blocks in the destination data, in bytes.
+    Uint32 DstStride DEFAULT_INITIALIZER(0);
+
+    /// Compression quality.
+    BLOCK_COMPRESSION_QUALITY Quality DEFAULT_INITIALIZER(BLOCK_COMPRESSION_QUALITY_NORMAL);
+
+    /// The number of threads to use. If zero, the number of hardware threads is used.
+    Uint32 NumThreads DEFAULT_INITIALIZER(0);
+};
+typedef struct CompressTextureAttribs CompressTextureAttribs;
+
+/// Returns true if CompressTexture() and DecompressTexture() support the block-compressed format.
+Bool DILIGENT_GLOBAL_FUNCTION(IsBlockCompressionSupported)(TEXTURE_FORMAT Format);
+
+/// Compresses texture data on the CPU.
+
+/// \param [in] Attribs - Compression attributes, see Diligent::CompressTextureAttribs.
+///
+/// \remarks   If the format is not supported (see Diligent::IsBlockCompressionSupported()),
+///             an error is logged and the destination data is not modified.
+///             Blocks at the right and bottom edges that are only partially covered by the texture
+///             are padded by replicating the last column and row.
+///             Data for sRGB formats is compressed in sRGB space, so linear source data is
+///             converted to sRGB first.
+void DILIGENT_GLOBAL_FUNCTION(CompressTexture)(const CompressTextureAttribs REF Attribs);
+
+/// DecompressTexture() attributes
+struct DecompressTextureAttribs
+{
+    /// Texture width, in texels.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Texture height, in texels.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// Block-compressed source format, see Diligent::CompressTextureAttribs::DstFormat.
+    TEXTURE_FORMAT SrcFormat DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// Source data. Only pData and Stride members are used.
+    /// Stride is the distance between rows of blocks.
+    TextureSubResData Src;
+
+    /// Destination data format.
+
+    /// \remarks   Any format that TEX_FORMAT_RGBA8_UNORM can be converted to by
+    ///             ConvertTextureData() is allowed.
+    TEXTURE_FORMAT DstFormat DEFAULT_INITIALIZER(TEX_FORMAT_RGBA8_UNORM);
+
+    /// Pointer to the destination data.
+    void* pDstData DEFAULT_INITIALIZER(nullptr);
+
+    /// Destination row stride, in bytes.
+    Uint32 DstStride DEFAULT_INITIALIZER(0);
+
+    /// The number of threads to use. If zero, the number of hardware threads is used.
+    Uint32 NumThreads DEFAULT_INITIALIZER(0);
+};
+typedef struct DecompressTextureAttribs DecompressTextureAttribs;
+
+/// Decompresses block-compressed texture data on the CPU.
+
+/// \param [in] Attribs - Decompression attributes, see Diligent::DecompressTextureAttribs.
+///
+/// \remarks   BC4 data is decoded to (R, 0, 0, 1), BC5 data is decoded to (R, G, 0, 1).
+///             If the format is not supported (see Diligent::IsBlockCompressionSupported()),
+///             an error is logged and the destination data is not modified.
+void DILIGENT_GLOBAL_FUNCTION(DecompressTexture)(const DecompressTextureAttribs REF Attribs);
+
+#include "../../../Primitives/interface/UndefGlobalFuncHelperMacros.h"
+
+DILIGENT_END_NAMESPACE // namespace Diligent
@@ -28,6 +28,10 @@
 #include "BufferSuballocator.h"
 
 #include <mutex>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <algorithm>
 
 #include "DebugUtilities.hpp"
 #include "ObjectBase.hpp"
@@ -35,6 +39,7 @@
 #include "DynamicBuffer.hpp"
 #include "VariableSizeAllocationsManager.hpp"
 #include "Align.hpp"
+#include "PlatformMisc.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
 #include "FixedBlockMemoryAllocator.hpp"
 
@@ -43,25 +48,66 @@ namespace Diligent
 
 class BufferSuballocatorImpl;
 
+namespace
+{
+
+// Suballocation state owned by the allocator. Slots are never deallocated while the
+// allocator is alive, so suballocation objects may reference them for their entire lifetime.
+// This also lets the defragmentation safely access suballocations that are being released
+// by other threads.
+struct SuballocationSlot
+{
+    explicit SuballocationSlot(Uint32 _Index) :
+        Index{_Index}
+    {}
+
+    const Uint32 Index;
+
+    // All members except for Offset are protected by the allocator mutex.
+    VariableSizeAllocationsManager::Allocation Subregion;
+
+    Uint32 Size      = 0;
+    Uint32 Alignment = 0;
+
+    // Incremented every time the slot is released, which allows the defragmentation
+    // to detect suballocations that have been released while a pass is in progress.
+    Uint32 Generation = 0;
+
+    // Aligned offset of the suballocation. It is updated by the defragmentation
+    // and is read by the suballocation object without the lock.
+    std::atomic<Uint32> Offset{0};
+};
+
+// Slots of suballocations destroyed by BufferSuballocatorImpl::ReleaseMultiple().
+// They are collected while the suballocations are being released and are then returned
+// to the allocator under a single lock.
+struct BatchReleaseContext
+{
+    const BufferSuballocatorImpl* const pAllocator;
+
+    std::vector<SuballocationSlot*> Slots;
+};
+
+// Batch release that is currently in progress on this thread, if any
+thread_local BatchReleaseContext* t_pBatchRelease = nullptr;
+
+} // namespace
+
 class BufferSuballocationImpl final : public ObjectBase<IBufferSuballocation>
 {
 public:
     using TBase = ObjectBase<IBufferSuballocation>;
-    BufferSuballocationImpl(IReferenceCounters*                          pRefCounters,
-                            BufferSuballocatorImpl*                      pParentAllocator,
-                            Uint32                                       Offset,
-                            Uint32                                       Size,
-                            VariableSizeAllocationsManager::Allocation&& Subregion) :
+    BufferSuballocationImpl(IReferenceCounters*     pRefCounters,
+                            BufferSuballocatorImpl* pParentAllocator,
+                            SuballocationSlot&      Slot) :
         // clang-format off
         TBase             {pRefCounters},
         m_pParentAllocator{pParentAllocator},
-        m_Subregion       {std::move(Subregion)},
-        m_Offset          {Offset},
-        m_Size            {Size}
+        m_Slot            {Slot}
     // clang-format on
     {
         VERIFY_EXPR(m_pParentAllocator);
-        VERIFY_EXPR(m_Subregion.IsValid());
+        VERIFY_EXPR(m_Slot.Subregion.IsValid());
     }
 
     ~BufferSuballocationImpl();
@@ -82,12 +128,12 @@ public:
 
     virtual Uint32 GetOffset() const override final
     {
-        return m_Offset;
+        return m_Slot.Offset.load();
     }
 
     virtual Uint32 GetSize() const override final
     {
-        return m_Size;
+        return m_Slot.Size;
     }
 
     virtual IBufferSuballocator* GetAllocator() override final;
@@ -105,10 +151,7 @@ public:
 private:
     RefCntAutoPtr<BufferSuballocatorImpl> m_pParentAllocator;
 
-    VariableSizeAllocationsManager::Allocation m_Subregion;
-
-    const Uint32 m_Offset;
-    const Uint32 m_Size;
+    SuballocationSlot& m_Slot;
 
     RefCntAutoPtr<IObject> m_pUserData;
 };
@@ -132,11 +175,19 @@ public:
         {
             DefaultRawMemoryAllocator::GetAllocator(),
             sizeof(BufferSuballocationImpl),
-            CreateInfo.SuballocationObjAllocationGranularity
+            CreateInfo.SuballocationObjAllocationGranularity,
+            true // Suballocations are frequently created and destroyed from multiple threads
         }
     // clang-format on
     {}
 
+    ~BufferSuballocatorImpl()
+    {
+        DEV_CHECK_ERR(!m_DefragmentationInProgress, "Buffer suballocator is destroyed while defragmentation is in progress");
+        for (auto& Move : m_PendingMoves)
+            m_Mgr.Free(std::move(Move.NewSubregion));
+    }
+
     virtual IBuffer* GetBuffer(IRenderDevice* pDevice, IDeviceContext* pContext) override final
     {
         Uint32 Size = 0;
@@ -168,46 +219,220 @@ public:
             return;
         }
 
-        VariableSizeAllocationsManager::Allocation Subregion;
+        SuballocationSlot* pSlot = nullptr;
         {
             std::lock_guard<std::mutex> Lock{m_MgrMtx};
-            Subregion = m_Mgr.Allocate(Size, Alignment);
+            pSlot = &AllocateSlot(Size, Alignment);
+        }
+
+        CreateSuballocation(*pSlot, ppSuballocation);
+    }
+
+    virtual void AllocateMultiple(Uint32                 Count,
+                                  const Uint32*          pSizes,
+                                  const Uint32*          pAlignments,
+                                  IBufferSuballocation** ppSuballocations) override final
+    {
+        if (Count == 0)
+            return;
+
+        if (pSizes == nullptr || ppSuballocations == nullptr)
+        {
+            UNEXPECTED("pSizes and ppSuballocations must not be null");
+            return;
+        }
+
+        for (Uint32 i = 0; i < Count; ++i)
+        {
+            ppSuballocations[i] = nullptr;
 
-            while (!Subregion.IsValid())
+            if (pSizes[i] == 0)
             {
-                auto ExtraSize = m_ExpansionSize != 0 ?
-                    std::max(m_ExpansionSize, AlignUp(Size, Alignment)) :
-                    m_Mgr.GetMaxSize();
+                UNEXPECTED("Size of suballocation ", i, " must not be zero");
+                return;
+            }
 
-                m_Mgr.Extend(ExtraSize);
-                Subregion = m_Mgr.Allocate(Size, Alignment);
+            if (pAlignments != nullptr && !IsPowerOfTwo(pAlignments[i]))
+            {
+                UNEXPECTED("Alignment (", pAlignments[i], ") of suballocation ", i, " is not a power of two");
+                return;
             }
         }
 
-        // clang-format off
-        BufferSuballocationImpl* pSuballocation{
-            NEW_RC_OBJ(m_SuballocationsAllocator, "BufferSuballocationImpl instance", BufferSuballocationImpl)
-            (
-                this, 
-                AlignUp(static_cast<Uint32>(Subregion.UnalignedOffset), Alignment),
-                Size,
-                std::move(Subregion)
-            )
-        };
-        // clang-format on
+        std::vector<SuballocationSlot*> Slots(Count);
+        {
+            std::lock_guard<std::mutex> Lock{m_MgrMtx};
+            for (Uint32 i = 0; i < Count; ++i)
+                Slots[i] = &AllocateSlot(pSizes[i], pAlignments != nullptr ? pAlignments[i] : 1);
+        }
 
-        pSuballocation->QueryInterface(IID_BufferSuballocation, reinterpret_cast<IObject**>(ppSuballocation));
+        for (Uint32 i = 0; i < Count; ++i)
+            CreateSuballocation(*Slots[i], &ppSuballocations[i]);
     }
 
-    void Free(VariableSizeAllocationsManager::Allocation&& Subregion)
+    virtual void ReleaseMultiple(Uint32                 Count,
+                                 IBufferSuballocation** ppSuballocations) override final
     {
+        if (Count == 0)
+            return;
+
+        if (ppSuballocations == nullptr)
+        {
+            UNEXPECTED("ppSuballocations must not be null");
+            return;
+        }
+
+        BatchReleaseContext BatchCtx{this, {}};
+        BatchCtx.Slots.reserve(Count);
+
+        // Releasing a suballocation may in turn release user data that performs
+        // its own batch release, so save the context of the outer one.
+        auto* const pOuterBatchRelease = t_pBatchRelease;
+        t_pBatchRelease                = &BatchCtx;
+
+        for (Uint32 i = 0; i < Count; ++i)
+        {
+            if (ppSuballocations[i] != nullptr)
+            {
+                ppSuballocations[i]->Release();
+                ppSuballocations[i] = nullptr;
+            }
+        }
+
+        t_pBatchRelease = pOuterBatchRelease;
+
+        if (!BatchCtx.Slots.empty())
+        {
+            std::lock_guard<std::mutex> Lock{m_MgrMtx};
+            for (auto* pSlot : BatchCtx.Slots)
+                ReleaseSlot(*pSlot);
+        }
+    }
+
+    void Free(SuballocationSlot& Slot)
+    {
+        if (t_pBatchRelease != nullptr && t_pBatchRelease->pAllocator == this)
+        {
+            // The slot will be released by ReleaseMultiple()
+            t_pBatchRelease->Slots.emplace_back(&Slot);
+            return;
+        }
+
         std::lock_guard<std::mutex> Lock{m_MgrMtx};
-        m_Mgr.Free(std::move(Subregion));
+        ReleaseSlot(Slot);
+    }
+
+    virtual const BufferSuballocationMove* BeginDefragmentation(Uint32  MaxBytesToMove,
+                                                                Uint32& NumMoves) override final
+    {
+        NumMoves = 0;
+
+        std::lock_guard<std::mutex> Lock{m_MgrMtx};
+        if (m_DefragmentationInProgress)
+        {
+            UNEXPECTED("Defragmentation is already in progress. Call EndDefragmentation() to finish the previous pass.");
+            return nullptr;
+        }
+        m_DefragmentationInProgress = true;
+        VERIFY_EXPR(m_Moves.empty() && m_PendingMoves.empty());
+
+        // Move suballocations starting from the end of the buffer
+        std::vector<SuballocationSlot*> LiveSlots;
+        LiveSlots.reserve(m_Slots.size() - m_FreeSlots.size());
+        for (auto& Slot : m_Slots)
+        {
+            if (Slot.Subregion.IsValid())
+                LiveSlots.emplace_back(&Slot);
+        }
+        std::sort(LiveSlots.begin(), LiveSlots.end(),
+                  [](const SuballocationSlot* pSlot0, const SuballocationSlot* pSlot1) {
+                      return pSlot0->Subregion.UnalignedOffset > pSlot1->Subregion.UnalignedOffset;
+                  });
+
+        // Minimum aligned size that failed to fit below the slots processed so far, for every alignment.
+        // Slots are processed in the order of decreasing offsets, so if a slot could not be moved,
+        // no later slot that is at least as large and at least as aligned can be moved either.
+        Uint32 MinFailedSize[32];
+        std::fill(std::begin(MinFailedSize), std::end(MinFailedSize), ~Uint32{0});
+
+        Uint32 BytesToMove = 0;
+        for (auto* pSlot : LiveSlots)
+        {
+            // All slots below the first free block are already tightly packed
+            if (pSlot->Subregion.UnalignedOffset <= m_Mgr.GetFirstFreeOffset())
+                break;
+
+            if (pSlot->Size > MaxBytesToMove - BytesToMove)
+                continue;
+
+            const auto AlignmentBit = PlatformMisc::GetLSB(pSlot->Alignment);
+            const auto AlignedSize  = AlignUp(pSlot->Size, pSlot->Alignment);
+            if (std::any_of(MinFailedSize, MinFailedSize + AlignmentBit + 1, [AlignedSize](Uint32 FailedSize) { return AlignedSize >= FailedSize; }))
+                continue;
+
+            // Note that the source region remains allocated until the end of the pass, so
+            // destination regions never overlap any source region.
+            auto NewSubregion = m_Mgr.AllocateBelow(pSlot->Size, pSlot->Alignment, pSlot->Subregion.UnalignedOffset);
+            if (!NewSubregion.IsValid())
+            {
+                MinFailedSize[AlignmentBit] = std::min(MinFailedSize[AlignmentBit], AlignedSize);
+                continue;
+            }
+
+            BufferSuballocationMove Move;
+            Move.SrcOffset = pSlot->Offset.load();
+            Move.DstOffset = AlignUp(static_cast<Uint32>(NewSubregion.UnalignedOffset), pSlot->Alignment);
+            Move.Size      = pSlot->Size;
+            m_Moves.emplace_back(Move);
+            m_PendingMoves.emplace_back(*pSlot, std::move(NewSubregion));
+
+            BytesToMove += pSlot->Size;
+            if (BytesToMove == MaxBytesToMove)
+                break;
+        }
+
+        NumMoves = static_cast<Uint32>(m_Moves.size());
+        return !m_Moves.empty() ? m_Moves.data() : nullptr;
+    }
+
+    virtual void EndDefragmentation() override final
+    {
+        std::lock_guard<std::mutex> Lock{m_MgrMtx};
+        if (!m_DefragmentationInProgress)
+        {
+            UNEXPECTED("Defragmentation is not in progress. Call BeginDefragmentation() to start a new pass.");
+            return;
+        }
+
+        bool Relocated = false;
+        for (auto& Move : m_PendingMoves)
+        {
+            auto& Slot = Move.Slot;
+            if (Slot.Generation == Move.Generation)
+            {
+                VERIFY_EXPR(Slot.Subregion.IsValid());
+                m_Mgr.Free(std::move(Slot.Subregion));
+                Slot.Subregion = std::move(Move.NewSubregion);
+                Slot.Offset.store(AlignUp(static_cast<Uint32>(Slot.Subregion.UnalignedOffset), Slot.Alignment));
+                Relocated = true;
+            }
+            else
+            {
+                // The suballocation has been released while the pass was in progress
+                m_Mgr.Free(std::move(Move.NewSubregion));
+            }
+        }
+        m_PendingMoves.clear();
+        m_Moves.clear();
+        m_DefragmentationInProgress = false;
+
+        if (Relocated)
+            m_DefragmentationVersion.fetch_add(1);
     }
 
     virtual Uint32 GetVersion() const override final
     {
-        return m_Buffer.GetVersion();
+        return m_Buffer.GetVersion() + m_DefragmentationVersion.load();
     }
 
     virtual Uint32 GetFreeSize() override final
@@ -217,9 +442,87 @@ public:
     }
 
 private:
+    // m_MgrMtx must be locked
+    SuballocationSlot& AllocateSlot(Uint32 Size, Uint32 Alignment)
+    {
+        auto Subregion = m_Mgr.Allocate(Size, Alignment);
+        while (!Subregion.IsValid())
+        {
+            auto ExtraSize = m_ExpansionSize != 0 ?
+                std::max(m_ExpansionSize, AlignUp(Size, Alignment)) :
+                m_Mgr.GetMaxSize();
+
+            m_Mgr.Extend(ExtraSize);
+            Subregion = m_Mgr.Allocate(Size, Alignment);
+        }
+
+        SuballocationSlot* pSlot = nullptr;
+        if (!m_FreeSlots.empty())
+        {
+            pSlot = &m_Slots[m_FreeSlots.back()];
+            m_FreeSlots.pop_back();
+        }
+        else
+        {
+            m_Slots.emplace_back(static_cast<Uint32>(m_Slots.size()));
+            pSlot = &m_Slots.back();
+        }
+        VERIFY_EXPR(!pSlot->Subregion.IsValid());
+
+        pSlot->Offset.store(AlignUp(static_cast<Uint32>(Subregion.UnalignedOffset), Alignment));
+        pSlot->Subregion = std::move(Subregion);
+        pSlot->Size      = Size;
+        pSlot->Alignment = Alignment;
+
+        return *pSlot;
+    }
+
+    // m_MgrMtx must be locked
+    void ReleaseSlot(SuballocationSlot& Slot)
+    {
+        m_Mgr.Free(std::move(Slot.Subregion));
+        ++Slot.Generation;
+        m_FreeSlots.emplace_back(Slot.Index);
+    }
+
+    void CreateSuballocation(SuballocationSlot& Slot, IBufferSuballocation** ppSuballocation)
+    {
+        BufferSuballocationImpl* pSuballocation{
+            NEW_RC_OBJ(m_SuballocationsAllocator, "BufferSuballocationImpl instance", BufferSuballocationImpl)(this, Slot) //
+        };
+        pSuballocation->QueryInterface(IID_BufferSuballocation, reinterpret_cast<IObject**>(ppSuballocation));
+    }
+
     std::mutex                     m_MgrMtx;
     VariableSizeAllocationsManager m_Mgr;
 
+    // Suballocation slots. std::deque never moves existing elements when new ones are added.
+    std::deque<SuballocationSlot> m_Slots;
+    std::vector<Uint32>           m_FreeSlots;
+
+    struct PendingMove
+    {
+        PendingMove(SuballocationSlot& _Slot, VariableSizeAllocationsManager::Allocation&& _NewSubregion) :
+            // clang-format off
+            Slot        {_Slot},
+            Generation  {_Slot.Generation},
+            NewSubregion{std::move(_NewSubregion)}
+        // clang-format on
+        {}
+
+        SuballocationSlot& Slot;
+
+        const Uint32 Generation;
+
+        VariableSizeAllocationsManager::Allocation NewSubregion;
+    };
+    // Defragmentation state, protected by m_MgrMtx
+    bool                                 m_DefragmentationInProgress = false;
+    std::vector<PendingMove>             m_PendingMoves;
+    std::vector<BufferSuballocationMove> m_Moves;
+
+    std::atomic<Uint32> m_DefragmentationVersion{0};
+
     DynamicBuffer m_Buffer;
 
     const Uint32 m_ExpansionSize;
@@ -230,7 +533,7 @@ private:
 
 BufferSuballocationImpl::~BufferSuballocationImpl()
 {
-    m_pParentAllocator->Free(std::move(m_Subregion));
+    m_pParentAllocator->Free(m_Slot);
 }
 
 IBufferSuballocator* BufferSuballocationImpl::GetAllocator()
@@ -30,6 +30,8 @@
 #include <mutex>
 #include <algorithm>
 #include <atomic>
+#include <deque>
+#include <vector>
 
 #include "DynamicAtlasManager.hpp"
 #include "ObjectBase.hpp"
@@ -44,25 +46,75 @@ namespace Diligent
 
 class DynamicTextureAtlasImpl;
 
+namespace
+{
+
+// Suballocation state owned by the atlas. Slots are never deallocated while the atlas
+// is alive, so suballocation objects may reference them for their entire lifetime.
+// This also lets the defragmentation safely access suballocations that are being released
+// by other threads.
+struct AtlasSuballocationSlot
+{
+    explicit AtlasSuballocationSlot(Uint32 _Index) :
+        Index{_Index}
+    {}
+
+    const Uint32 Index;
+
+    // All members except for Location are protected by the atlas slices mutex.
+    DynamicAtlasManager::Region Subregion;
+
+    Uint32 Slice = 0;
+    uint2  Size;
+
+    // Incremented every time the slot is released, which allows the defragmentation
+    // to detect suballocations that have been released while a pass is in progress.
+    Uint32 Generation = 0;
+
+    // Region origin (in granularity units) and slice packed into a single value, see PackLocation().
+    // It is updated by the defragmentation and is read by the suballocation object without the lock.
+    std::atomic<Uint64> Location{0};
+
+    // Location bit layout: 24 bits per origin coordinate and 16 bits for the slice.
+    // The atlas constructor makes sure that all regions fit into these ranges.
+    static constexpr Uint32 MaxOriginCoord = (1u << 24u) - 1u;
+    static constexpr Uint32 MaxSlice       = (1u << 16u) - 1u;
+
+    static Uint64 PackLocation(const DynamicAtlasManager::Region& R, Uint32 Slice)
+    {
+        VERIFY_EXPR(R.x <= MaxOriginCoord && R.y <= MaxOriginCoord && Slice <= MaxSlice);
+        return Uint64{R.x} | (Uint64{R.y} << 24u) | (Uint64{Slice} << 48u);
+    }
+
+    uint2 GetOrigin() const
+    {
+        const auto Loc = Location.load();
+        return uint2{static_cast<Uint32>(Loc & 0xFFFFFFu), static_cast<Uint32>((Loc >> 24u) & 0xFFFFFFu)};
+    }
+
+    Uint32 GetSlice() const
+    {
+        return static_cast<Uint32>(Location.load() >> 48u);
+    }
+};
+
+} // namespace
+
 class TextureAtlasSuballocationImpl final : public ObjectBase<ITextureAtlasSuballocation>
 {
 public:
     using TBase = ObjectBase<ITextureAtlasSuballocation>;
-    TextureAtlasSuballocationImpl(IReferenceCounters*           pRefCounters,
-                                  DynamicTextureAtlasImpl*      pParentAtlas,
-                                  DynamicAtlasManager::Region&& Subregion,
-                                  Uint32                        Slice,
-                                  const uint2&                  Size) noexcept :
+    TextureAtlasSuballocationImpl(IReferenceCounters*      pRefCounters,
+                                  DynamicTextureAtlasImpl* pParentAtlas,
+                                  AtlasSuballocationSlot&  Slot) noexcept :
         // clang-format off
         TBase         {pRefCounters},
         m_pParentAtlas{pParentAtlas},
-        m_Subregion   {std::move(Subregion)},
-        m_Slice       {Slice},
-        m_Size        {Size}
+        m_Slot        {Slot}
     // clang-format on
     {
         VERIFY_EXPR(m_pParentAtlas);
-        VERIFY_EXPR(!m_Subregion.IsEmpty());
+        VERIFY_EXPR(!m_Slot.Subregion.IsEmpty());
     }
 
     ~TextureAtlasSuballocationImpl();
@@ -85,12 +137,12 @@ public:
 
     virtual Uint32 GetSlice() const override final
     {
-        return m_Slice;
+        return m_Slot.GetSlice();
     }
 
     virtual uint2 GetSize() const override final
     {
-        return m_Size;
+        return m_Slot.Size;
     }
 
     virtual float4 GetUVScaleBias() const override final;
@@ -110,10 +162,7 @@ public:
 private:
     RefCntAutoPtr<DynamicTextureAtlasImpl> m_pParentAtlas;
 
-    DynamicAtlasManager::Region m_Subregion;
-
-    const Uint32 m_Slice;
-    const uint2  m_Size;
+    AtlasSuballocationSlot& m_Slot;
 
     RefCntAutoPtr<IObject> m_pUserData;
 };
@@ -166,6 +215,13 @@ public:
         if ((m_Desc.Height % m_Granularity) != 0)
             LOG_ERROR_AND_THROW("Texture height (", m_Desc.Height, ") is not a multiple of granularity (", m_Granularity, ")");
 
+        // Region origins in granularity units and slice indices are packed into AtlasSuballocationSlot::Location
+        if (m_Desc.Width / m_Granularity > AtlasSuballocationSlot::MaxOriginCoord + 1 || m_Desc.Height / m_Granularity > AtlasSuballocationSlot::MaxOriginCoord + 1)
+            LOG_ERROR_AND_THROW("Texture dimensions (", m_Desc.Width, " x ", m_Desc.Height, ") exceed the maximum of ", AtlasSuballocationSlot::MaxOriginCoord + 1, " granularity units");
+
+        if (m_MaxSliceCount > AtlasSuballocationSlot::MaxSlice + 1)
+            LOG_ERROR_AND_THROW("Maximum slice count (", m_MaxSliceCount, ") exceeds the limit of ", AtlasSuballocationSlot::MaxSlice + 1);
+
         m_Desc.Name = m_Name.c_str();
 
         for (Uint32 slice = 0; slice < m_Desc.ArraySize; ++slice)
@@ -185,6 +241,13 @@ public:
         m_Version.store(0);
     }
 
+    ~DynamicTextureAtlasImpl()
+    {
+        DEV_CHECK_ERR(!m_DefragmentationInProgress, "Texture atlas is destroyed while defragmentation is in progress");
+        for (auto& Move : m_PendingMoves)
+            m_Slices[Move.NewSlice]->Free(std::move(Move.NewSubregion));
+    }
+
     IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_DynamicTextureAtlas, TBase)
 
     virtual ITexture* GetTexture(IRenderDevice* pDevice, IDeviceContext* pContext) override final
@@ -291,31 +354,150 @@ public:
             return;
         }
 
-        // clang-format off
+        AtlasSuballocationSlot* pSlot = nullptr;
+        {
+            std::lock_guard<std::mutex> Lock{m_SlicesMtx};
+            if (!m_FreeSlots.empty())
+            {
+                pSlot = &m_SuballocationSlots[m_FreeSlots.back()];
+                m_FreeSlots.pop_back();
+            }
+            else
+            {
+                m_SuballocationSlots.emplace_back(static_cast<Uint32>(m_SuballocationSlots.size()));
+                pSlot = &m_SuballocationSlots.back();
+            }
+            VERIFY_EXPR(pSlot->Subregion.IsEmpty());
+
+            pSlot->Location.store(AtlasSuballocationSlot::PackLocation(Subregion, Slice));
+            pSlot->Subregion = std::move(Subregion);
+            pSlot->Slice     = Slice;
+            pSlot->Size      = uint2{Width, Height};
+        }
+
         TextureAtlasSuballocationImpl* pSuballocation{
-            NEW_RC_OBJ(m_SuballocationsAllocator, "TextureAtlasSuballocationImpl instance", TextureAtlasSuballocationImpl)
-            (
-                this, 
-                std::move(Subregion),
-                Slice,
-                uint2{Width, Height}
-            )
+            NEW_RC_OBJ(m_SuballocationsAllocator, "TextureAtlasSuballocationImpl instance", TextureAtlasSuballocationImpl)(this, *pSlot) //
         };
-        // clang-format on
 
         pSuballocation->QueryInterface(IID_TextureAtlasSuballocation, reinterpret_cast<IObject**>(ppSuballocation));
     }
 
-    virtual void Free(Uint32 Slice, DynamicAtlasManager::Region&& Subregion)
+    void Free(AtlasSuballocationSlot& Slot)
     {
-        SliceManager* pSliceMgr = nullptr;
+        SliceManager*               pSliceMgr = nullptr;
+        DynamicAtlasManager::Region Subregion;
         {
             std::lock_guard<std::mutex> Lock{m_SlicesMtx};
-            pSliceMgr = m_Slices[Slice].get();
+            pSliceMgr      = m_Slices[Slot.Slice].get();
+            Subregion      = std::move(Slot.Subregion);
+            Slot.Subregion = {};
+            ++Slot.Generation;
+            m_FreeSlots.emplace_back(Slot.Index);
         }
         pSliceMgr->Free(std::move(Subregion));
     }
 
+    virtual const TextureAtlasSuballocationMove* BeginDefragmentation(Uint64  MaxBytesToMove,
+                                                                      Uint32& NumMoves) override final
+    {
+        NumMoves = 0;
+
+        std::lock_guard<std::mutex> Lock{m_SlicesMtx};
+        if (m_DefragmentationInProgress)
+        {
+            UNEXPECTED("Defragmentation is already in progress. Call EndDefragmentation() to finish the previous pass.");
+            return nullptr;
+        }
+        m_DefragmentationInProgress = true;
+        VERIFY_EXPR(m_Moves.empty() && m_PendingMoves.empty());
+
+        // Move suballocations starting from the last slice. Larger regions are placed first
+        // as they are harder to fit.
+        std::vector<AtlasSuballocationSlot*> Candidates;
+        for (auto& Slot : m_SuballocationSlots)
+        {
+            if (!Slot.Subregion.IsEmpty() && Slot.Slice > 0)
+                Candidates.emplace_back(&Slot);
+        }
+        std::sort(Candidates.begin(), Candidates.end(),
+                  [](const AtlasSuballocationSlot* pSlot0, const AtlasSuballocationSlot* pSlot1) {
+                      if (pSlot0->Slice != pSlot1->Slice)
+                          return pSlot0->Slice > pSlot1->Slice;
+                      return pSlot0->Subregion.width * pSlot0->Subregion.height > pSlot1->Subregion.width * pSlot1->Subregion.height;
+                  });
+
+        Uint64 BytesToMove = 0;
+        for (auto* pSlot : Candidates)
+        {
+            const auto RegionSize = GetRegionDataSize(pSlot->Size);
+            if (RegionSize > MaxBytesToMove - BytesToMove)
+                continue;
+
+            // Note that the source region remains allocated until the end of the pass, so
+            // destination regions never overlap any source region.
+            for (Uint32 DstSlice = 0; DstSlice < pSlot->Slice; ++DstSlice)
+            {
+                auto NewSubregion = m_Slices[DstSlice]->Allocate(pSlot->Subregion.width, pSlot->Subregion.height);
+                if (NewSubregion.IsEmpty())
+                    continue;
+
+                TextureAtlasSuballocationMove Move;
+                Move.SrcSlice  = pSlot->Slice;
+                Move.SrcOrigin = uint2{pSlot->Subregion.x, pSlot->Subregion.y} * m_Granularity;
+                Move.DstSlice  = DstSlice;
+                Move.DstOrigin = uint2{NewSubregion.x, NewSubregion.y} * m_Granularity;
+                Move.Size      = pSlot->Size;
+                m_Moves.emplace_back(Move);
+                m_PendingMoves.emplace_back(*pSlot, std::move(NewSubregion), DstSlice);
+
+                BytesToMove += RegionSize;
+                break;
+            }
+
+            if (BytesToMove == MaxBytesToMove)
+                break;
+        }
+
+        NumMoves = static_cast<Uint32>(m_Moves.size());
+        return !m_Moves.empty() ? m_Moves.data() : nullptr;
+    }
+
+    virtual void EndDefragmentation() override final
+    {
+        std::lock_guard<std::mutex> Lock{m_SlicesMtx};
+        if (!m_DefragmentationInProgress)
+        {
+            UNEXPECTED("Defragmentation is not in progress. Call BeginDefragmentation() to start a new pass.");
+            return;
+        }
+
+        bool Relocated = false;
+        for (auto& Move : m_PendingMoves)
+        {
+            auto& Slot = Move.Slot;
+            if (Slot.Generation == Move.Generation)
+            {
+                VERIFY_EXPR(!Slot.Subregion.IsEmpty());
+                m_Slices[Slot.Slice]->Free(std::move(Slot.Subregion));
+                Slot.Subregion = std::move(Move.NewSubregion);
+                Slot.Slice     = Move.NewSlice;
+                Slot.Location.store(AtlasSuballocationSlot::PackLocation(Slot.Subregion, Slot.Slice));
+                Relocated = true;
+            }
+            else
+            {
+                // The suballocation has been released while the pass was in progress
+                m_Slices[Move.NewSlice]->Free(std::move(Move.NewSubregion));
+            }
+        }
+        m_PendingMoves.clear();
+        m_Moves.clear();
+        m_DefragmentationInProgress = false;
+
+        if (Relocated)
+            m_Version.fetch_add(1);
+    }
+
     virtual const TextureDesc& GetAtlasDesc() const override final
     {
         return m_Desc;
@@ -332,6 +514,21 @@ public:
     }
 
 private:
+    // Returns the size of the texture data in the region of the given size, including all mip levels
+    Uint64 GetRegionDataSize(const uint2& Size) const
+    {
+        TextureDesc RegionDesc = m_Desc;
+        RegionDesc.Type        = RESOURCE_DIM_TEX_2D;
+        RegionDesc.Width       = Size.x;
+        RegionDesc.Height      = Size.y;
+        RegionDesc.ArraySize   = 1;
+
+        Uint64 DataSize = 0;
+        for (Uint32 mip = 0; mip < std::max(m_Desc.MipLevels, 1u); ++mip)
+            DataSize += GetMipLevelProperties(RegionDesc, mip).MipSize;
+        return DataSize;
+    }
+
     TextureDesc       m_Desc;
     const std::string m_Name;
 
@@ -369,22 +566,46 @@ private:
     };
     std::mutex                                 m_SlicesMtx;
     std::vector<std::unique_ptr<SliceManager>> m_Slices;
+
+    // Suballocation slots, protected by m_SlicesMtx.
+    // std::deque never moves existing elements when new ones are added.
+    std::deque<AtlasSuballocationSlot> m_SuballocationSlots;
+    std::vector<Uint32>                m_FreeSlots;
+
+    struct PendingMove
+    {
+        PendingMove(AtlasSuballocationSlot& _Slot, DynamicAtlasManager::Region&& _NewSubregion, Uint32 _NewSlice) :
+            // clang-format off
+            Slot        {_Slot},
+            Generation  {_Slot.Generation},
+            NewSubregion{std::move(_NewSubregion)},
+            NewSlice    {_NewSlice}
+        // clang-format on
+        {}
+
+        AtlasSuballocationSlot& Slot;
+
+        const Uint32 Generation;
+
+        DynamicAtlasManager::Region NewSubregion;
+
+        const Uint32 NewSlice;
+    };
+    // Defragmentation state, protected by m_SlicesMtx
+    bool                                       m_DefragmentationInProgress = false;
+    std::vector<PendingMove>                   m_PendingMoves;
+    std::vector<TextureAtlasSuballocationMove> m_Moves;
 };
 
 
 TextureAtlasSuballocationImpl::~TextureAtlasSuballocationImpl()
 {
-    m_pParentAtlas->Free(m_Slice, std::move(m_Subregion));
+    m_pParentAtlas->Free(m_Slot);
 }
 
 uint2 TextureAtlasSuballocationImpl::GetOrigin() const
 {
-    const auto Granularity = m_pParentAtlas->GetGranularity();
-    return uint2 //
-        {
-            m_Subregion.x * Granularity,
-            m_Subregion.y * Granularity //
-        };
+    return m_Slot.GetOrigin() * m_pParentAtlas->GetGranularity();
 }
 
 IDynamicTextureAtlas* TextureAtlasSuballocationImpl::GetAtlas()
@@ -26,16 +26,36 @@
  */
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "GraphicsUtilities.h"
 #include "DebugUtilities.hpp"
 #include "GraphicsAccessories.hpp"
 #include "ColorConversion.h"
+#include "ThreadPool.hpp"
 
 #define PI_F 3.1415926f
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DILIGENT_MIP_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define DILIGENT_MIP_SSE2 0
+#endif
+
+#if !DILIGENT_MIP_SSE2 && (defined(__ARM_NEON) || defined(_M_ARM64))
+#    define DILIGENT_MIP_NEON 1
+#    include <arm_neon.h>
+#else
+#    define DILIGENT_MIP_NEON 0
+#endif
+
 namespace Diligent
 {
 
@@ -201,6 +221,233 @@ float LinearAverage<float>(float c0, float c1, float c2, float c3)
     return (c0 + c1 + c2 + c3) * 0.25f;
 }
 
+// Vectorized row kernels compute as many texels of a coarse row as they can and return the
+// number of texels processed. The remaining texels are computed by the scalar code.
+// NumCols is the number of coarse texels whose both fine source columns are inside the row.
+struct NoRowKernel
+{
+    template <typename ChannelType>
+    Uint32 operator()(const ChannelType* pRow0, const ChannelType* pRow1, ChannelType* pDst, Uint32 NumCols, Uint32 NumChannels) const
+    {
+        return 0;
+    }
+};
+
+// 2x2 box filter for 4-channel 8-bit unsigned formats
+struct BoxRowKernelRGBA8
+{
+    Uint32 operator()(const Uint8* pRow0, const Uint8* pRow1, Uint8* pDst, Uint32 NumCols, Uint32 NumChannels) const
+    {
+        if (NumChannels != 4)
+            return 0;
+
+        Uint32 col = 0;
+#if DILIGENT_MIP_SSE2
+        const __m128i Zero = _mm_setzero_si128();
+        for (; col + 4 <= NumCols; col += 4)
+        {
+            // 8 fine texels -> 4 coarse texels
+            const __m128i Row0a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow0 + col * 8));
+            const __m128i Row0b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow0 + col * 8 + 16));
+            const __m128i Row1a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + col * 8));
+            const __m128i Row1b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + col * 8 + 16));
+
+            // Vertical sums of texels 0-1, 2-3, 4-5 and 6-7 in 16-bit channels
+            const __m128i Sum01 = _mm_add_epi16(_mm_unpacklo_epi8(Row0a, Zero), _mm_unpacklo_epi8(Row1a, Zero));
+            const __m128i Sum23 = _mm_add_epi16(_mm_unpackhi_epi8(Row0a, Zero), _mm_unpackhi_epi8(Row1a, Zero));
+            const __m128i Sum45 = _mm_add_epi16(_mm_unpacklo_epi8(Row0b, Zero), _mm_unpacklo_epi8(Row1b, Zero));
+            const __m128i Sum67 = _mm_add_epi16(_mm_unpackhi_epi8(Row0b, Zero), _mm_unpackhi_epi8(Row1b, Zero));
+
+            // Horizontal sums
+            const __m128i Dst01 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(Sum01, Sum23), _mm_unpackhi_epi64(Sum01, Sum23)), 2);
+            const __m128i Dst23 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(Sum45, Sum67), _mm_unpackhi_epi64(Sum45, Sum67)), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + col * 4), _mm_packus_epi16(Dst01, Dst23));
+        }
+#elif DILIGENT_MIP_NEON
+        for (; col + 8 <= NumCols; col += 8)
+        {
+            const uint8x16x4_t Row0 = vld4q_u8(pRow0 + col * 8);
+            const uint8x16x4_t Row1 = vld4q_u8(pRow1 + col * 8);
+
+            uint8x8x4_t Dst;
+            for (int c = 0; c < 4; ++c)
+                Dst.val[c] = vshrn_n_u16(vpadalq_u8(vpaddlq_u8(Row0.val[c]), Row1.val[c]), 2);
+            vst4_u8(pDst + col * 4, Dst);
+        }
+#endif
+        return col;
+    }
+};
+
+// 2x2 box filter for 4-channel 16-bit unsigned formats
+struct BoxRowKernelRGBA16
+{
+    Uint32 operator()(const Uint16* pRow0, const Uint16* pRow1, Uint16* pDst, Uint32 NumCols, Uint32 NumChannels) const
+    {
+        if (NumChannels != 4)
+            return 0;
+
+        Uint32 col = 0;
+#if DILIGENT_MIP_SSE2
+        const __m128i Zero   = _mm_setzero_si128();
+        const __m128i Bias32 = _mm_set1_epi32(0x8000);
+        const __m128i Bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+        for (; col + 2 <= NumCols; col += 2)
+        {
+            // 4 fine texels -> 2 coarse texels
+            const __m128i Row0a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow0 + col * 8));
+            const __m128i Row0b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow0 + col * 8 + 8));
+            const __m128i Row1a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + col * 8));
+            const __m128i Row1b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + col * 8 + 8));
+
+            const __m128i Sum0 = _mm_add_epi32(_mm_unpacklo_epi16(Row0a, Zero), _mm_unpacklo_epi16(Row1a, Zero));
+            const __m128i Sum1 = _mm_add_epi32(_mm_unpackhi_epi16(Row0a, Zero), _mm_unpackhi_epi16(Row1a, Zero));
+            const __m128i Sum2 = _mm_add_epi32(_mm_unpacklo_epi16(Row0b, Zero), _mm_unpacklo_epi16(Row1b, Zero));
+            const __m128i Sum3 = _mm_add_epi32(_mm_unpackhi_epi16(Row0b, Zero), _mm_unpackhi_epi16(Row1b, Zero));
+
+            const __m128i Dst0 = _mm_srli_epi32(_mm_add_epi32(Sum0, Sum1), 2);
+            const __m128i Dst1 = _mm_srli_epi32(_mm_add_epi32(Sum2, Sum3), 2);
+            // SSE2 has no unsigned 32->16 pack, so bias the values into the signed range
+            const __m128i Dst = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(Dst0, Bias32), _mm_sub_epi32(Dst1, Bias32)), Bias16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + col * 4), Dst);
+        }
+#elif DILIGENT_MIP_NEON
+        for (; col + 4 <= NumCols; col += 4)
+        {
+            const uint16x8x4_t Row0 = vld4q_u16(pRow0 + col * 8);
+            const uint16x8x4_t Row1 = vld4q_u16(pRow1 + col * 8);
+
+            uint16x4x4_t Dst;
+            for (int c = 0; c < 4; ++c)
+                Dst.val[c] = vshrn_n_u32(vpadalq_u16(vpaddlq_u16(Row0.val[c]), Row1.val[c]), 2);
+            vst4_u16(pDst + col * 4, Dst);
+        }
+#endif
+        return col;
+    }
+};
+
+// 2x2 box filter for 4-channel 32-bit float formats.
+// The summation order matches LinearAverage<float>.
+struct BoxRowKernelRGBA32F
+{
+    Uint32 operator()(const float* pRow0, const float* pRow1, float* pDst, Uint32 NumCols, Uint32 NumChannels) const
+    {
+        if (NumChannels != 4)
+            return 0;
+
+        Uint32 col = 0;
+#if DILIGENT_MIP_SSE2
+        const __m128 Quarter = _mm_set1_ps(0.25f);
+        for (; col < NumCols; ++col)
+        {
+            const __m128 c00 = _mm_loadu_ps(pRow0 + col * 8);
+            const __m128 c01 = _mm_loadu_ps(pRow0 + col * 8 + 4);
+            const __m128 c10 = _mm_loadu_ps(pRow1 + col * 8);
+            const __m128 c11 = _mm_loadu_ps(pRow1 + col * 8 + 4);
+            _mm_storeu_ps(pDst + col * 4, _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(c00, c01), c10), c11), Quarter));
+        }
+#elif DILIGENT_MIP_NEON
+        for (; col < NumCols; ++col)
+        {
+            const float32x4_t c00 = vld1q_f32(pRow0 + col * 8);
+            const float32x4_t c01 = vld1q_f32(pRow0 + col * 8 + 4);
+            const float32x4_t c10 = vld1q_f32(pRow1 + col * 8);
+            const float32x4_t c11 = vld1q_f32(pRow1 + col * 8 + 4);
+            vst1q_f32(pDst + col * 4, vmulq_n_f32(vaddq_f32(vaddq_f32(vaddq_f32(c00, c01), c10), c11), 0.25f));
+        }
+#endif
+        return col;
+    }
+};
+
+// Exact 8-bit sRGB <-> 16-bit linear conversion tables
+class SRGBConversionTables
+{
+public:
+    static const SRGBConversionTables& Get()
+    {
+        static const SRGBConversionTables Tables;
+        return Tables;
+    }
+
+    Uint32 ToLinear16(Uint8 c) const
+    {
+        return m_ToLinear16[c];
+    }
+
+    float ToLinear(Uint8 c) const
+    {
+        return m_ToLinear[c];
+    }
+
+    // Returns the sRGB value that is closest to the 16-bit linear value
+    Uint8 ToSRGB(Uint32 Linear16) const
+    {
+        VERIFY_EXPR(Linear16 <= 0xFFFF);
+        // The distance between thresholds of adjacent sRGB values is greater than 16,
+        // so a single correction step is sufficient.
+        Uint32 c = m_ToSRGB[Linear16 >> 4];
+        c += Linear16 >= m_Thresholds[c] ? 1 : 0;
+        return static_cast<Uint8>(c);
+    }
+
+private:
+    SRGBConversionTables() noexcept
+    {
+        for (Uint32 c = 0; c < 256; ++c)
+        {
+            m_ToLinear[c]   = SRGBToLinear(static_cast<float>(c) / 255.f);
+            m_ToLinear16[c] = static_cast<Uint16>(m_ToLinear[c] * 65535.f + 0.5f);
+            // Linear values greater than or equal to the threshold are closer to c + 1
+            m_Thresholds[c] = c < 255 ?
+                static_cast<Uint32>(std::ceil(SRGBToLinear((static_cast<float>(c) + 0.5f) / 255.f) * 65535.f)) :
+                0x10000;
+        }
+
+        Uint32 c = 0;
+        for (Uint32 i = 0; i < m_ToSRGB.size(); ++i)
+        {
+            while (c < 255 && (i << 4) >= m_Thresholds[c])
+                ++c;
+            m_ToSRGB[i] = static_cast<Uint8>(c);
+        }
+    }
+
+    std::array<float, 256>  m_ToLinear;
+    std::array<Uint16, 256> m_ToLinear16;
+    std::array<Uint32, 256> m_Thresholds;
+    std::array<Uint8, 4096> m_ToSRGB;
+};
+
+// 2x2 box filter for 8-bit sRGB formats that averages values in linear space using
+// conversion tables. Alpha channel of 4-channel formats is averaged linearly.
+struct BoxRowKernelSRGB8
+{
+    Uint32 operator()(const Uint8* pRow0, const Uint8* pRow1, Uint8* pDst, Uint32 NumCols, Uint32 NumChannels) const
+    {
+        const auto& Tables = SRGBConversionTables::Get();
+
+        const Uint32 NumColorChannels = NumChannels == 4 ? 3 : NumChannels;
+        for (Uint32 col = 0; col < NumCols; ++col)
+        {
+            const auto* pSrc0     = pRow0 + col * 2 * NumChannels;
+            const auto* pSrc1     = pRow1 + col * 2 * NumChannels;
+            auto*       pDstTexel = pDst + col * NumChannels;
+            for (Uint32 c = 0; c < NumColorChannels; ++c)
+            {
+                const Uint32 Sum =
+                    Tables.ToLinear16(pSrc0[c]) + Tables.ToLinear16(pSrc0[NumChannels + c]) +
+                    Tables.ToLinear16(pSrc1[c]) + Tables.ToLinear16(pSrc1[NumChannels + c]);
+                pDstTexel[c] = Tables.ToSRGB((Sum + 2) >> 2);
+            }
+            if (NumColorChannels < NumChannels)
+                pDstTexel[3] = LinearAverage<Uint8>(pSrc0[3], pSrc0[NumChannels + 3], pSrc1[3], pSrc1[NumChannels + 3]);
+        }
+        return NumCols;
+    }
+};
+
 struct ComputeCoarseMipHelper
 {
     const Uint32 FineMipWidth;
@@ -214,27 +461,47 @@ struct ComputeCoarseMipHelper
 
     const Uint32 NumChannels;
 
+    Uint32 GetCoarseMipWidth() const
+    {
+        return std::max(FineMipWidth / Uint32{2}, Uint32{1});
+    }
+
+    Uint32 GetCoarseMipHeight() const
+    {
+        return std::max(FineMipHeight / Uint32{2}, Uint32{1});
+    }
+
+    // Computes coarse mip rows [StartRow, EndRow)
     template <typename ChannelType,
-              typename AverageFuncType>
-    void Run(AverageFuncType ComputeAverage) const
+              typename AverageFuncType,
+              typename RowKernelType = NoRowKernel>
+    void Run(AverageFuncType ComputeAverage,
+             RowKernelType   RowKernel = {},
+             Uint32          StartRow  = 0,
+             Uint32          EndRow    = ~Uint32{0}) const
     {
         VERIFY_EXPR(FineMipWidth > 0 && FineMipHeight > 0);
         VERIFY(FineMipHeight == 1 || FineMipStride >= FineMipWidth * sizeof(ChannelType) * NumChannels, "Fine mip level stride is too small");
 
-        const auto CoarseMipWidth  = std::max(FineMipWidth / Uint32{2}, Uint32{1});
-        const auto CoarseMipHeight = std::max(FineMipHeight / Uint32{2}, Uint32{1});
+        const auto CoarseMipWidth  = GetCoarseMipWidth();
+        const auto CoarseMipHeight = GetCoarseMipHeight();
 
         VERIFY(CoarseMipHeight == 1 || CoarseMipStride >= CoarseMipWidth * sizeof(ChannelType) * NumChannels, "Coarse mip level stride is too small");
 
-        for (Uint32 row = 0; row < CoarseMipHeight; ++row)
+        // The number of coarse texels whose both source columns are inside the fine row
+        const auto NumFullCols = FineMipWidth / 2;
+
+        EndRow = std::min(EndRow, CoarseMipHeight);
+        for (Uint32 row = StartRow; row < EndRow; ++row)
         {
             auto src_row0 = row * 2;
             auto src_row1 = std::min(row * 2 + 1, FineMipHeight - 1);
 
             auto pSrcRow0 = reinterpret_cast<const ChannelType*>(reinterpret_cast<const Uint8*>(pFineMip) + src_row0 * FineMipStride);
             auto pSrcRow1 = reinterpret_cast<const ChannelType*>(reinterpret_cast<const Uint8*>(pFineMip) + src_row1 * FineMipStride);
+            auto pDstRow  = reinterpret_cast<ChannelType*>(reinterpret_cast<Uint8*>(pCoarseMip) + row * CoarseMipStride);
 
-            for (Uint32 col = 0; col < CoarseMipWidth; ++col)
+            for (Uint32 col = RowKernel(pSrcRow0, pSrcRow1, pDstRow, NumFullCols, NumChannels); col < CoarseMipWidth; ++col)
             {
                 auto src_col0 = col * 2;
                 auto src_col1 = std::min(col * 2 + 1, FineMipWidth - 1);
@@ -246,41 +513,29 @@ struct ComputeCoarseMipHelper
                     const auto Chnl10 = pSrcRow1[src_col0 * NumChannels + c];
                     const auto Chnl11 = pSrcRow1[src_col1 * NumChannels + c];
 
-                    auto& DstCol = reinterpret_cast<ChannelType*>(reinterpret_cast<Uint8*>(pCoarseMip) + row * CoarseMipStride)[col * NumChannels + c];
-
-                    DstCol = ComputeAverage(Chnl00, Chnl01, Chnl10, Chnl11);
+                    pDstRow[col * NumChannels + c] = ComputeAverage(Chnl00, Chnl01, Chnl10, Chnl11);
                 }
             }
         }
     }
 };
 
-void ComputeMipLevel(Uint32         FineLevelWidth,
-                     Uint32         FineLevelHeight,
-                     TEXTURE_FORMAT Fmt,
-                     const void*    pFineLevelData,
-                     Uint32         FineDataStrideInBytes,
-                     void*          pCoarseLevelData,
-                     Uint32         CoarseDataStrideInBytes)
+// Computes coarse mip rows [StartRow, EndRow) with the 2x2 box filter.
+// If UseSRGBTables is true, sRGB formats are averaged using exact conversion tables.
+void ComputeBoxMipRows(const ComputeCoarseMipHelper& ComputeMipHelper,
+                       const TextureFormatAttribs&   FmtAttribs,
+                       bool                          UseSRGBTables,
+                       Uint32                        StartRow,
+                       Uint32                        EndRow)
 {
-    const auto& FmtAttribs = GetTextureFormatAttribs(Fmt);
-
-    ComputeCoarseMipHelper ComputeMipHelper //
-        {
-            FineLevelWidth,
-            FineLevelHeight,
-            pFineLevelData,
-            FineDataStrideInBytes,
-            pCoarseLevelData,
-            CoarseDataStrideInBytes,
-            FmtAttribs.NumComponents //
-        };
-
     switch (FmtAttribs.ComponentType)
     {
         case COMPONENT_TYPE_UNORM_SRGB:
             VERIFY(FmtAttribs.ComponentSize == 1, "Only 8-bit sRGB formats are expected");
-            ComputeMipHelper.Run<Uint8>(SRGBAverage<Uint8>);
+            if (UseSRGBTables)
+                ComputeMipHelper.Run<Uint8>(SRGBAverage<Uint8>, BoxRowKernelSRGB8{}, StartRow, EndRow);
+            else
+                ComputeMipHelper.Run<Uint8>(SRGBAverage<Uint8>, NoRowKernel{}, StartRow, EndRow);
             break;
 
         case COMPONENT_TYPE_UNORM:
@@ -288,15 +543,15 @@ void ComputeMipLevel(Uint32         FineLevelWidth,
             switch (FmtAttribs.ComponentSize)
             {
                 case 1:
-                    ComputeMipHelper.Run<Uint8>(LinearAverage<Uint8>);
+                    ComputeMipHelper.Run<Uint8>(LinearAverage<Uint8>, BoxRowKernelRGBA8{}, StartRow, EndRow);
                     break;
 
                 case 2:
-                    ComputeMipHelper.Run<Uint16>(LinearAverage<Uint16>);
+                    ComputeMipHelper.Run<Uint16>(LinearAverage<Uint16>, BoxRowKernelRGBA16{}, StartRow, EndRow);
                     break;
 
                 case 4:
-                    ComputeMipHelper.Run<Uint32>(LinearAverage<Uint32>);
+                    ComputeMipHelper.Run<Uint32>(LinearAverage<Uint32>, NoRowKernel{}, StartRow, EndRow);
                     break;
 
                 default:
@@ -309,15 +564,15 @@ void ComputeMipLevel(Uint32         FineLevelWidth,
             switch (FmtAttribs.ComponentSize)
             {
                 case 1:
-                    ComputeMipHelper.Run<Int8>(LinearAverage<Int8>);
+                    ComputeMipHelper.Run<Int8>(LinearAverage<Int8>, NoRowKernel{}, StartRow, EndRow);
                     break;
 
                 case 2:
-                    ComputeMipHelper.Run<Int16>(LinearAverage<Int16>);
+                    ComputeMipHelper.Run<Int16>(LinearAverage<Int16>, NoRowKernel{}, StartRow, EndRow);
                     break;
 
                 case 4:
-                    ComputeMipHelper.Run<Int32>(LinearAverage<Int32>);
+                    ComputeMipHelper.Run<Int32>(LinearAverage<Int32>, NoRowKernel{}, StartRow, EndRow);
                     break;
 
                 default:
@@ -327,7 +582,7 @@ void ComputeMipLevel(Uint32         FineLevelWidth,
 
         case COMPONENT_TYPE_FLOAT:
             VERIFY(FmtAttribs.ComponentSize == 4, "Only 32-bit float formats are currently supported");
-            ComputeMipHelper.Run<Float32>(LinearAverage<Float32>);
+            ComputeMipHelper.Run<Float32>(LinearAverage<Float32>, BoxRowKernelRGBA32F{}, StartRow, EndRow);
             break;
 
         default:
@@ -335,6 +590,563 @@ void ComputeMipLevel(Uint32         FineLevelWidth,
     }
 }
 
+void ComputeMipLevel(Uint32         FineLevelWidth,
+                     Uint32         FineLevelHeight,
+                     TEXTURE_FORMAT Fmt,
+                     const void*    pFineLevelData,
+                     Uint32         FineDataStrideInBytes,
+                     void*          pCoarseLevelData,
+                     Uint32         CoarseDataStrideInBytes)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Fmt);
+
+    ComputeCoarseMipHelper ComputeMipHelper //
+        {
+            FineLevelWidth,
+            FineLevelHeight,
+            pFineLevelData,
+            FineDataStrideInBytes,
+            pCoarseLevelData,
+            CoarseDataStrideInBytes,
+            FmtAttribs.NumComponents //
+        };
+
+    ComputeBoxMipRows(ComputeMipHelper, FmtAttribs, false, 0, ComputeMipHelper.GetCoarseMipHeight());
+}
+
+
+namespace
+{
+
+// Levels smaller than this are not split between threads
+static constexpr Uint32 MinParallelMipTexels = 64 << 10;
+
+class MipChainBuilder
+{
+public:
+    MipChainBuilder(const ComputeMipChainAttribs& Attribs, Uint32 NumThreads, ThreadPool* pThreadPool) :
+        m_Attribs{Attribs},
+        m_FmtAttribs{GetTextureFormatAttribs(Attribs.Format)},
+        m_NumThreads{NumThreads},
+        m_pThreadPool{pThreadPool}
+    {}
+
+    Uint32 GetLevelWidth(Uint32 Level) const
+    {
+        return std::max(m_Attribs.Width >> Level, Uint32{1});
+    }
+
+    Uint32 GetLevelHeight(Uint32 Level) const
+    {
+        return std::max(m_Attribs.Height >> Level, Uint32{1});
+    }
+
+    ComputeCoarseMipHelper GetMipHelper(Uint32 CoarseLevel) const
+    {
+        const auto& Fine   = m_Attribs.pMipLevels[CoarseLevel - 1];
+        const auto& Coarse = m_Attribs.pMipLevels[CoarseLevel];
+        return ComputeCoarseMipHelper{
+            GetLevelWidth(CoarseLevel - 1),
+            GetLevelHeight(CoarseLevel - 1),
+            Fine.pData,
+            Fine.Stride,
+            Coarse.pData,
+            Coarse.Stride,
+            m_FmtAttribs.NumComponents //
+        };
+    }
+
+    void RunBox() const
+    {
+        const auto NumLevels = m_Attribs.NumMipLevels;
+
+        // Rows of levels 1 .. NumBandLevels are split into bands whose height in level 0 is 2^NumBandLevels.
+        // A 2x2 box filter only reads the two fine rows of every coarse row, so each band can be processed
+        // through all these levels independently while its data is in the cache.
+        Uint32 NumBandLevels = 0;
+        while (NumBandLevels < MaxBandLevels &&
+               NumBandLevels + 1 < NumLevels &&
+               (m_Attribs.Height >> (NumBandLevels + 1)) >= m_NumThreads * 4)
+            ++NumBandLevels;
+
+        if (NumBandLevels > 0)
+        {
+            const auto BandHeight = Uint32{1} << NumBandLevels;
+            const auto NumBands   = (m_Attribs.Height + BandHeight - 1) >> NumBandLevels;
+            ParallelFor(NumBands, [&](Uint32 Band) {
+                for (Uint32 Level = 1; Level <= NumBandLevels; ++Level)
+                {
+                    const auto CoarseHeight = GetLevelHeight(Level);
+                    const auto StartRow     = (Band << NumBandLevels) >> Level;
+                    const auto EndRow       = Band + 1 < NumBands ? std::min(((Band + 1) << NumBandLevels) >> Level, CoarseHeight) : CoarseHeight;
+                    if (StartRow >= EndRow)
+                        break;
+                    ComputeBoxMipRows(GetMipHelper(Level), m_FmtAttribs, true, StartRow, EndRow);
+                }
+            });
+        }
+
+        for (Uint32 Level = NumBandLevels + 1; Level < NumLevels; ++Level)
+        {
+            const auto CoarseHeight = GetLevelHeight(Level);
+            const auto NumChunks    = GetLevelWidth(Level) * CoarseHeight >= MinParallelMipTexels ? std::min(m_NumThreads * 4, CoarseHeight) : 1;
+            ParallelFor(NumChunks, [&](Uint32 Chunk) {
+                ComputeBoxMipRows(GetMipHelper(Level), m_FmtAttribs, true, CoarseHeight * Chunk / NumChunks, CoarseHeight * (Chunk + 1) / NumChunks);
+            });
+        }
+    }
+
+    void RunFiltered() const
+    {
+        for (Uint32 Level = 1; Level < m_Attribs.NumMipLevels; ++Level)
+        {
+            const auto FineWidth    = GetLevelWidth(Level - 1);
+            const auto FineHeight   = GetLevelHeight(Level - 1);
+            const auto CoarseWidth  = GetLevelWidth(Level);
+            const auto CoarseHeight = GetLevelHeight(Level);
+
+            const FilterWeights HorzWeights{FineWidth, CoarseWidth, m_Attribs.FilterType};
+            const FilterWeights VertWeights{FineHeight, CoarseHeight, m_Attribs.FilterType};
+
+            const auto NumBands    = (CoarseHeight + FilterBandHeight - 1) / FilterBandHeight;
+            const auto ProcessBand = [&](Uint32 Band) {
+                const auto StartRow = Band * FilterBandHeight;
+                const auto EndRow   = std::min(StartRow + FilterBandHeight, CoarseHeight);
+                FilterRows(Level, HorzWeights, VertWeights, StartRow, EndRow);
+            };
+            if (CoarseWidth * CoarseHeight >= MinParallelMipTexels)
+            {
+                ParallelFor(NumBands, ProcessBand);
+            }
+            else
+            {
+                for (Uint32 Band = 0; Band < NumBands; ++Band)
+                    ProcessBand(Band);
+            }
+        }
+    }
+
+private:
+    // Runs Handler(i) for i in [0, NumItems) on the thread pool and this thread
+    template <typename HandlerType>
+    void ParallelFor(Uint32 NumItems, const HandlerType& Handler) const
+    {
+        if (m_pThreadPool != nullptr)
+        {
+            Diligent::ParallelFor(*m_pThreadPool, NumItems, Handler);
+        }
+        else
+        {
+            for (Uint32 i = 0; i < NumItems; ++i)
+                Handler(i);
+        }
+    }
+
+    // Separable filter weights for one dimension
+    struct FilterWeights
+    {
+        FilterWeights(Uint32 SrcSize, Uint32 DstSize, MIP_FILTER_TYPE FilterType)
+        {
+            if (FilterType == MIP_FILTER_TYPE_BOX)
+            {
+                // Same as ComputeMipLevel(): every destination texel is the average of two source texels
+                NumTaps = 2;
+                Indices.resize(size_t{DstSize} * NumTaps);
+                Weights.resize(size_t{DstSize} * NumTaps, 0.5f);
+                for (Uint32 dst = 0; dst < DstSize; ++dst)
+                {
+                    Indices[dst * 2 + 0] = std::min(dst * 2 + 0, SrcSize - 1);
+                    Indices[dst * 2 + 1] = std::min(dst * 2 + 1, SrcSize - 1);
+                }
+                return;
+            }
+
+            // Filter radius in destination texels
+            static constexpr float Radius = 3;
+
+            const auto Scale     = static_cast<float>(SrcSize) / static_cast<float>(DstSize);
+            const auto SrcRadius = Radius * Scale;
+
+            NumTaps = static_cast<Uint32>(std::ceil(SrcRadius * 2)) + 1;
+            Indices.resize(size_t{DstSize} * NumTaps);
+            Weights.resize(size_t{DstSize} * NumTaps);
+
+            for (Uint32 dst = 0; dst < DstSize; ++dst)
+            {
+                // Destination texel center in source texel space
+                const auto Center   = (static_cast<float>(dst) + 0.5f) * Scale;
+                const auto FirstSrc = static_cast<int>(std::floor(Center - SrcRadius - 0.5f)) + 1;
+
+                auto* pIndices = &Indices[size_t{dst} * NumTaps];
+                auto* pWeights = &Weights[size_t{dst} * NumTaps];
+
+                float WeightSum = 0;
+                for (Uint32 t = 0; t < NumTaps; ++t)
+                {
+                    const auto Src = FirstSrc + static_cast<int>(t);
+                    const auto x   = (static_cast<float>(Src) + 0.5f - Center) / Scale;
+
+                    pIndices[t] = static_cast<Uint32>(std::min(std::max(Src, 0), static_cast<int>(SrcSize) - 1));
+                    pWeights[t] = EvaluateFilter(FilterType, x, Radius);
+                    WeightSum += pWeights[t];
+                }
+                VERIFY_EXPR(WeightSum > 0);
+                for (Uint32 t = 0; t < NumTaps; ++t)
+                    pWeights[t] /= WeightSum;
+            }
+        }
+
+        Uint32              NumTaps = 0;
+        std::vector<Uint32> Indices;
+        std::vector<float>  Weights;
+    };
+
+    static float Sinc(float x)
+    {
+        x *= PI_F;
+        return std::abs(x) < 1e-5f ? 1.f : std::sin(x) / x;
+    }
+
+    // Zero-order modified Bessel function of the first kind
+    static float BesselI0(float x)
+    {
+        float Sum  = 1;
+        float Term = 1;
+        for (int k = 1; k < 32 && Term > Sum * 1e-8f; ++k)
+        {
+            const auto t = x / (2.f * static_cast<float>(k));
+            Term *= t * t;
+            Sum += Term;
+        }
+        return Sum;
+    }
+
+    static float EvaluateFilter(MIP_FILTER_TYPE FilterType, float x, float Radius)
+    {
+        if (std::abs(x) >= Radius)
+            return 0;
+
+        switch (FilterType)
+        {
+            case MIP_FILTER_TYPE_KAISER:
+            {
+                static constexpr float Alpha = 4;
+
+                const auto r = x / Radius;
+                return Sinc(x) * BesselI0(Alpha * std::sqrt(1.f - r * r)) / BesselI0(Alpha);
+            }
+
+            case MIP_FILTER_TYPE_LANCZOS:
+                return Sinc(x) * Sinc(x / Radius);
+
+            default:
+                UNEXPECTED("Unexpected filter type");
+                return 0;
+        }
+    }
+
+    // Converts a row to linear floating-point values
+    void ReadRow(const void* pSrc, Uint32 NumValues, float* pDst) const
+    {
+        switch (m_FmtAttribs.ComponentType)
+        {
+            case COMPONENT_TYPE_UNORM_SRGB:
+            {
+                const auto& Tables = SRGBConversionTables::Get();
+
+                const auto* pSrc8 = static_cast<const Uint8*>(pSrc);
+                for (Uint32 i = 0; i < NumValues; ++i)
+                    pDst[i] = IsAlpha(i) ? static_cast<float>(pSrc8[i]) / 255.f : Tables.ToLinear(pSrc8[i]);
+                break;
+            }
+
+            case COMPONENT_TYPE_UNORM:
+                if (m_FmtAttribs.ComponentSize == 1)
+                    ReadNormalizedRow(static_cast<const Uint8*>(pSrc), NumValues, pDst);
+                else
+                    ReadNormalizedRow(static_cast<const Uint16*>(pSrc), NumValues, pDst);
+                break;
+
+            case COMPONENT_TYPE_SNORM:
+                if (m_FmtAttribs.ComponentSize == 1)
+                    ReadNormalizedRow(static_cast<const Int8*>(pSrc), NumValues, pDst);
+                else
+                    ReadNormalizedRow(static_cast<const Int16*>(pSrc), NumValues, pDst);
+                break;
+
+            case COMPONENT_TYPE_FLOAT:
+                if (m_FmtAttribs.ComponentSize == 4)
+                    memcpy(pDst, pSrc, sizeof(float) * NumValues);
+                else
+                    ConvertFloatRow(m_FmtAttribs.Format, pSrc, GetFloat32Format(), pDst, NumValues);
+                break;
+
+            default:
+                UNEXPECTED("Unexpected component type");
+        }
+    }
+
+    // Converts linear floating-point values to the texture format
+    void WriteRow(const float* pSrc, Uint32 NumValues, void* pDst) const
+    {
+        switch (m_FmtAttribs.ComponentType)
+        {
+            case COMPONENT_TYPE_UNORM_SRGB:
+            {
+                const auto& Tables = SRGBConversionTables::Get();
+
+                auto* pDst8 = static_cast<Uint8*>(pDst);
+                for (Uint32 i = 0; i < NumValues; ++i)
+                {
+                    const auto Val = std::min(std::max(pSrc[i], 0.f), 1.f);
+                    pDst8[i]       = IsAlpha(i) ?
+                        static_cast<Uint8>(Val * 255.f + 0.5f) :
+                        Tables.ToSRGB(static_cast<Uint32>(Val * 65535.f + 0.5f));
+                }
+                break;
+            }
+
+            case COMPONENT_TYPE_UNORM:
+                if (m_FmtAttribs.ComponentSize == 1)
+                    WriteNormalizedRow(pSrc, NumValues, static_cast<Uint8*>(pDst));
+                else
+                    WriteNormalizedRow(pSrc, NumValues, static_cast<Uint16*>(pDst));
+                break;
+
+            case COMPONENT_TYPE_SNORM:
+                if (m_FmtAttribs.ComponentSize == 1)
+                    WriteNormalizedRow(pSrc, NumValues, static_cast<Int8*>(pDst));
+                else
+                    WriteNormalizedRow(pSrc, NumValues, static_cast<Int16*>(pDst));
+                break;
+
+            case COMPONENT_TYPE_FLOAT:
+                if (m_FmtAttribs.ComponentSize == 4)
+                    memcpy(pDst, pSrc, sizeof(float) * NumValues);
+                else
+                    ConvertFloatRow(GetFloat32Format(), pSrc, m_FmtAttribs.Format, pDst, NumValues);
+                break;
+
+            default:
+                UNEXPECTED("Unexpected component type");
+        }
+    }
+
+    // Returns the 32-bit float format with the same number of components as the texture format
+    TEXTURE_FORMAT GetFloat32Format() const
+    {
+        switch (m_FmtAttribs.NumComponents)
+        {
+            // clang-format off
+            case 1: return TEX_FORMAT_R32_FLOAT;
+            case 2: return TEX_FORMAT_RG32_FLOAT;
+            case 3: return TEX_FORMAT_RGB32_FLOAT;
+            case 4: return TEX_FORMAT_RGBA32_FLOAT;
+            // clang-format on
+            default:
+                UNEXPECTED("Unexpected number of components");
+                return TEX_FORMAT_UNKNOWN;
+        }
+    }
+
+    // Converts a row between 16-bit and 32-bit floating-point formats
+    void ConvertFloatRow(TEXTURE_FORMAT SrcFormat, const void* pSrc, TEXTURE_FORMAT DstFormat, void* pDst, Uint32 NumValues) const
+    {
+        TextureDataConversionAttribs ConvAttribs;
+        ConvAttribs.Width     = NumValues / m_FmtAttribs.NumComponents;
+        ConvAttribs.Height    = 1;
+        ConvAttribs.SrcFormat = SrcFormat;
+        ConvAttribs.pSrcData  = pSrc;
+        ConvAttribs.SrcStride = size_t{NumValues} * GetTextureFormatAttribs(SrcFormat).ComponentSize;
+        ConvAttribs.DstFormat = DstFormat;
+        ConvAttribs.pDstData  = pDst;
+        ConvAttribs.DstStride = size_t{NumValues} * GetTextureFormatAttribs(DstFormat).ComponentSize;
+        ConvertTextureData(ConvAttribs);
+    }
+
+    bool IsAlpha(Uint32 ValueIdx) const
+    {
+        return m_FmtAttribs.NumComponents == 4 && (ValueIdx & 0x03) == 3;
+    }
+
+    template <typename ChannelType>
+    static void ReadNormalizedRow(const ChannelType* pSrc, Uint32 NumValues, float* pDst)
+    {
+        static constexpr float MaxValInv = 1.f / static_cast<float>(std::numeric_limits<ChannelType>::max());
+        for (Uint32 i = 0; i < NumValues; ++i)
+            pDst[i] = std::max(static_cast<float>(pSrc[i]) * MaxValInv, -1.f);
+    }
+
+    template <typename ChannelType>
+    static void WriteNormalizedRow(const float* pSrc, Uint32 NumValues, ChannelType* pDst)
+    {
+        static constexpr float MaxVal = static_cast<float>(std::numeric_limits<ChannelType>::max());
+        static constexpr float MinVal = std::numeric_limits<ChannelType>::is_signed ? -1.f : 0.f;
+        for (Uint32 i = 0; i < NumValues; ++i)
+            pDst[i] = static_cast<ChannelType>(std::floor(std::min(std::max(pSrc[i], MinVal), 1.f) * MaxVal + 0.5f));
+    }
+
+    // Known number of channels lets the compiler vectorize the loop over channels
+    template <Uint32 NumChannels>
+    static void FilterRowHorz(const float* pSrc, const FilterWeights& Weights, Uint32 DstWidth, float* pDst)
+    {
+        for (Uint32 col = 0; col < DstWidth; ++col)
+        {
+            const auto* pIndices = &Weights.Indices[size_t{col} * Weights.NumTaps];
+            const auto* pWeights = &Weights.Weights[size_t{col} * Weights.NumTaps];
+
+            float Sum[NumChannels] = {};
+            for (Uint32 t = 0; t < Weights.NumTaps; ++t)
+            {
+                const auto* pSrcTexel = pSrc + pIndices[t] * NumChannels;
+                for (Uint32 c = 0; c < NumChannels; ++c)
+                    Sum[c] += pSrcTexel[c] * pWeights[t];
+            }
+            for (Uint32 c = 0; c < NumChannels; ++c)
+                pDst[col * NumChannels + c] = Sum[c];
+        }
+    }
+
+    // Computes coarse rows [StartRow, EndRow) of the level using the separable filter
+    void FilterRows(Uint32 Level, const FilterWeights& HorzWeights, const FilterWeights& VertWeights, Uint32 StartRow, Uint32 EndRow) const
+    {
+        const auto& Fine        = m_Attribs.pMipLevels[Level - 1];
+        const auto& Coarse      = m_Attribs.pMipLevels[Level];
+        const auto  NumChannels = Uint32{m_FmtAttribs.NumComponents};
+        const auto  FineWidth   = GetLevelWidth(Level - 1);
+        const auto  CoarseWidth = GetLevelWidth(Level);
+
+        // Range of fine rows required by the band
+        Uint32 FirstFineRow = ~Uint32{0};
+        Uint32 LastFineRow  = 0;
+        for (size_t i = size_t{StartRow} * VertWeights.NumTaps; i < size_t{EndRow} * VertWeights.NumTaps; ++i)
+        {
+            FirstFineRow = std::min(FirstFineRow, VertWeights.Indices[i]);
+            LastFineRow  = std::max(LastFineRow, VertWeights.Indices[i]);
+        }
+
+        const size_t FineRowSize   = size_t{FineWidth} * NumChannels;
+        const size_t CoarseRowSize = size_t{CoarseWidth} * NumChannels;
+
+        std::vector<float> FineRow(FineRowSize);
+        std::vector<float> HorzFiltered((LastFineRow - FirstFineRow + 1) * CoarseRowSize);
+        for (Uint32 FineRowIdx = FirstFineRow; FineRowIdx <= LastFineRow; ++FineRowIdx)
+        {
+            ReadRow(static_cast<const Uint8*>(Fine.pData) + size_t{FineRowIdx} * Fine.Stride, static_cast<Uint32>(FineRowSize), FineRow.data());
+
+            auto* pDst = &HorzFiltered[(FineRowIdx - FirstFineRow) * CoarseRowSize];
+            switch (NumChannels)
+            {
+                case 1:
+                    FilterRowHorz<1>(FineRow.data(), HorzWeights, CoarseWidth, pDst);
+                    break;
+
+                case 2:
+                    FilterRowHorz<2>(FineRow.data(), HorzWeights, CoarseWidth, pDst);
+                    break;
+
+                case 3:
+                    FilterRowHorz<3>(FineRow.data(), HorzWeights, CoarseWidth, pDst);
+                    break;
+
+                case 4:
+                    FilterRowHorz<4>(FineRow.data(), HorzWeights, CoarseWidth, pDst);
+                    break;
+
+                default:
+                    UNEXPECTED("Unexpected number of channels");
+            }
+        }
+
+        std::vector<float> CoarseRow(CoarseRowSize);
+        for (Uint32 row = StartRow; row < EndRow; ++row)
+        {
+            std::fill(CoarseRow.begin(), CoarseRow.end(), 0.f);
+
+            const auto* pIndices = &VertWeights.Indices[size_t{row} * VertWeights.NumTaps];
+            const auto* pWeights = &VertWeights.Weights[size_t{row} * VertWeights.NumTaps];
+            for (Uint32 t = 0; t < VertWeights.NumTaps; ++t)
+            {
+                const auto* pSrc   = &HorzFiltered[(pIndices[t] - FirstFineRow) * CoarseRowSize];
+                const auto  Weight = pWeights[t];
+                for (size_t i = 0; i < CoarseRowSize; ++i)
+                    CoarseRow[i] += pSrc[i] * Weight;
+            }
+
+            WriteRow(CoarseRow.data(), static_cast<Uint32>(CoarseRowSize), static_cast<Uint8*>(Coarse.pData) + size_t{row} * Coarse.Stride);
+        }
+    }
+
+    // The maximum number of levels that are processed in bands by the box filter (64-row bands)
+    static constexpr Uint32 MaxBandLevels = 6;
+
+    // The number of coarse rows processed by one task of the separable filter
+    static constexpr Uint32 FilterBandHeight = 32;
+
+    const ComputeMipChainAttribs& m_Attribs;
+    const TextureFormatAttribs&   m_FmtAttribs;
+    const Uint32                  m_NumThreads;
+    ThreadPool* const             m_pThreadPool;
+};
+
+} // namespace
+
+void ComputeMipChain(const ComputeMipChainAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.Width > 0 && Attribs.Height > 0, "Texture dimensions must not be zero");
+    DEV_CHECK_ERR(Attribs.pMipLevels != nullptr, "pMipLevels must not be null");
+    DEV_CHECK_ERR(Attribs.NumMipLevels <= ComputeMipLevelsCount(Attribs.Width, Attribs.Height),
+                  "The number of mip levels (", Attribs.NumMipLevels, ") exceeds the full mip chain size for ", Attribs.Width, "x", Attribs.Height, " texture");
+#ifdef DILIGENT_DEVELOPMENT
+    for (Uint32 Level = 0; Level < Attribs.NumMipLevels; ++Level)
+        DEV_CHECK_ERR(Attribs.pMipLevels[Level].pData != nullptr, "Data of mip level ", Level, " is null");
+#endif
+
+    if (Attribs.NumMipLevels <= 1)
+        return;
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_UNORM_SRGB:
+        case COMPONENT_TYPE_UNORM:
+        case COMPONENT_TYPE_SNORM:
+        case COMPONENT_TYPE_UINT:
+        case COMPONENT_TYPE_SINT:
+        case COMPONENT_TYPE_FLOAT:
+            break;
+
+        default:
+            UNSUPPORTED("Format ", FmtAttribs.Name, " is not supported by ComputeMipChain");
+            return;
+    }
+
+    const auto NumThreads = Attribs.NumThreads != 0 ?
+        Attribs.NumThreads :
+        std::max(std::thread::hardware_concurrency(), 1u);
+
+    // The worker threads are created once and are used for all levels
+    std::unique_ptr<ThreadPool> pThreadPool;
+    if (NumThreads > 1)
+        pThreadPool = std::make_unique<ThreadPool>(NumThreads - 1);
+
+    MipChainBuilder Builder{Attribs, NumThreads, pThreadPool.get()};
+
+    // Integer formats are always box-filtered. 16-bit float formats are converted to
+    // 32-bit floats and are processed by the separable filter, which also implements
+    // the box filter.
+    if (FmtAttribs.ComponentType == COMPONENT_TYPE_UINT ||
+        FmtAttribs.ComponentType == COMPONENT_TYPE_SINT ||
+        (Attribs.FilterType == MIP_FILTER_TYPE_BOX && !(FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT && FmtAttribs.ComponentSize == 2)))
+    {
+        Builder.RunBox();
+    }
+    else
+    {
+        Builder.RunFiltered();
+    }
+}
+
 } // namespace Diligent
 
 
@@ -374,4 +1186,9 @@ extern "C"
         ComputeMipLevel(FineLevelWidth, FineLevelHeight, Fmt, pFineLevelData,
                         FineDataStrideInBytes, pCoarseLevelData, CoarseDataStrideInBytes);
     }
+
+    void Diligent_ComputeMipChain(const Diligent::ComputeMipChainAttribs& Attribs)
+    {
+        Diligent::ComputeMipChain(Attribs);
+    }
 }
@@ -0,0 +1,1943 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "TextureCompression.h"
+#include "DebugUtilities.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "ThreadPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define TEXTURE_COMPRESSION_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define TEXTURE_COMPRESSION_SSE2 0
+#endif
+
+#if !TEXTURE_COMPRESSION_SSE2 && (defined(__aarch64__) || defined(_M_ARM64))
+#    define TEXTURE_COMPRESSION_NEON 1
+#    include <arm_neon.h>
+#else
+#    define TEXTURE_COMPRESSION_NEON 0
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr Uint32 NumBlockTexels = 16;
+
+// A set of up to 16 texels of a block stored as a structure of arrays.
+// Component values are in [0, 255] range.
+struct TexelSet
+{
+    alignas(16) float Ch[4][NumBlockTexels] = {};
+
+    // Position of every texel in the block
+    Uint8 Pos[NumBlockTexels] = {};
+
+    Uint32 NumTexels = 0;
+
+    void AddTexel(const TexelSet& Block, Uint32 Texel)
+    {
+        VERIFY_EXPR(NumTexels < NumBlockTexels);
+        for (Uint32 c = 0; c < 4; ++c)
+            Ch[c][NumTexels] = Block.Ch[c][Texel];
+        Pos[NumTexels++] = static_cast<Uint8>(Texel);
+    }
+
+    // Pads the arrays to a multiple of 4 texels by replicating the last texel
+    void Pad()
+    {
+        VERIFY_EXPR(NumTexels > 0);
+        for (Uint32 i = NumTexels; i < ((NumTexels + 3) & ~3u); ++i)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                Ch[c][i] = Ch[c][NumTexels - 1];
+        }
+    }
+};
+
+// Palette of up to 16 entries stored as a structure of arrays
+struct Palette
+{
+    alignas(16) float Ch[4][16] = {};
+
+    Uint32 NumEntries = 0;
+};
+
+// Finds the closest palette entry for every texel of the set using channels [FirstCh, FirstCh + NumCh)
+// and returns the total squared error.
+float FindClosestEntries(const TexelSet& Set, Uint32 FirstCh, Uint32 NumCh, const Palette& Pal, Uint8* Indices)
+{
+    VERIFY_EXPR(NumCh >= 1 && FirstCh + NumCh <= 4 && Pal.NumEntries > 0);
+
+    float TotalError = 0;
+#if TEXTURE_COMPRESSION_SSE2
+    for (Uint32 i = 0; i < Set.NumTexels; i += 4)
+    {
+        __m128 Texel[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Texel[c] = _mm_load_ps(&Set.Ch[FirstCh + c][i]);
+
+        __m128  BestError = _mm_set1_ps(FLT_MAX);
+        __m128i BestIndex = _mm_setzero_si128();
+        for (Uint32 e = 0; e < Pal.NumEntries; ++e)
+        {
+            __m128 Diff  = _mm_sub_ps(Texel[0], _mm_set1_ps(Pal.Ch[FirstCh][e]));
+            __m128 Error = _mm_mul_ps(Diff, Diff);
+            for (Uint32 c = 1; c < NumCh; ++c)
+            {
+                Diff  = _mm_sub_ps(Texel[c], _mm_set1_ps(Pal.Ch[FirstCh + c][e]));
+                Error = _mm_add_ps(Error, _mm_mul_ps(Diff, Diff));
+            }
+            const __m128i Closer = _mm_castps_si128(_mm_cmplt_ps(Error, BestError));
+
+            BestError = _mm_min_ps(Error, BestError);
+            BestIndex = _mm_or_si128(_mm_and_si128(Closer, _mm_set1_epi32(static_cast<int>(e))), _mm_andnot_si128(Closer, BestIndex));
+        }
+
+        alignas(16) float Errors[4];
+        alignas(16) Int32 Idx[4];
+        _mm_store_ps(Errors, BestError);
+        _mm_store_si128(reinterpret_cast<__m128i*>(Idx), BestIndex);
+        for (Uint32 k = 0; k < std::min(Set.NumTexels - i, 4u); ++k)
+        {
+            Indices[i + k] = static_cast<Uint8>(Idx[k]);
+            TotalError += Errors[k];
+        }
+    }
+#elif TEXTURE_COMPRESSION_NEON
+    for (Uint32 i = 0; i < Set.NumTexels; i += 4)
+    {
+        float32x4_t Texel[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Texel[c] = vld1q_f32(&Set.Ch[FirstCh + c][i]);
+
+        float32x4_t BestError = vdupq_n_f32(FLT_MAX);
+        uint32x4_t  BestIndex = vdupq_n_u32(0);
+        for (Uint32 e = 0; e < Pal.NumEntries; ++e)
+        {
+            float32x4_t Diff  = vsubq_f32(Texel[0], vdupq_n_f32(Pal.Ch[FirstCh][e]));
+            float32x4_t Error = vmulq_f32(Diff, Diff);
+            for (Uint32 c = 1; c < NumCh; ++c)
+            {
+                Diff  = vsubq_f32(Texel[c], vdupq_n_f32(Pal.Ch[FirstCh + c][e]));
+                Error = vaddq_f32(Error, vmulq_f32(Diff, Diff));
+            }
+            const uint32x4_t Closer = vcltq_f32(Error, BestError);
+
+            BestError = vminq_f32(Error, BestError);
+            BestIndex = vbslq_u32(Closer, vdupq_n_u32(e), BestIndex);
+        }
+
+        float  Errors[4];
+        Uint32 Idx[4];
+        vst1q_f32(Errors, BestError);
+        vst1q_u32(Idx, BestIndex);
+        for (Uint32 k = 0; k < std::min(Set.NumTexels - i, 4u); ++k)
+        {
+            Indices[i + k] = static_cast<Uint8>(Idx[k]);
+            TotalError += Errors[k];
+        }
+    }
+#else
+    for (Uint32 i = 0; i < Set.NumTexels; ++i)
+    {
+        float BestError = FLT_MAX;
+        Uint8 BestIndex = 0;
+        for (Uint32 e = 0; e < Pal.NumEntries; ++e)
+        {
+            float Error = 0;
+            for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+            {
+                const float Diff = Set.Ch[c][i] - Pal.Ch[c][e];
+                Error += Diff * Diff;
+            }
+            if (Error < BestError)
+            {
+                BestError = Error;
+                BestIndex = static_cast<Uint8>(e);
+            }
+        }
+        Indices[i] = BestIndex;
+        TotalError += BestError;
+    }
+#endif
+    return TotalError;
+}
+
+// Computes the endpoints of the segment on the principal axis of the texel set that covers all texels
+void ComputePrincipalAxisEndpoints(const TexelSet& Set, Uint32 FirstCh, Uint32 NumCh, float E0[], float E1[])
+{
+    const Uint32 N = Set.NumTexels;
+
+    float Mean[4] = {};
+    for (Uint32 c = 0; c < NumCh; ++c)
+    {
+        for (Uint32 i = 0; i < N; ++i)
+            Mean[c] += Set.Ch[FirstCh + c][i];
+        Mean[c] /= static_cast<float>(N);
+    }
+
+    float Cov[4][4] = {};
+    for (Uint32 i = 0; i < N; ++i)
+    {
+        float d[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            d[c] = Set.Ch[FirstCh + c][i] - Mean[c];
+        for (Uint32 a = 0; a < NumCh; ++a)
+        {
+            for (Uint32 b = a; b < NumCh; ++b)
+                Cov[a][b] += d[a] * d[b];
+        }
+    }
+
+    // Start the power iteration with the covariance row of the channel with the largest variance
+    Uint32 MaxVarCh = 0;
+    for (Uint32 a = 0; a < NumCh; ++a)
+    {
+        for (Uint32 b = 0; b < a; ++b)
+            Cov[a][b] = Cov[b][a];
+        if (Cov[a][a] > Cov[MaxVarCh][MaxVarCh])
+            MaxVarCh = a;
+    }
+
+    if (Cov[MaxVarCh][MaxVarCh] < 1e-3f)
+    {
+        for (Uint32 c = 0; c < NumCh; ++c)
+            E0[FirstCh + c] = E1[FirstCh + c] = Mean[c];
+        return;
+    }
+
+    float Axis[4];
+    for (Uint32 c = 0; c < NumCh; ++c)
+        Axis[c] = Cov[MaxVarCh][c];
+    for (Uint32 iter = 0; iter < 8; ++iter)
+    {
+        float NewAxis[4] = {};
+        float MaxComp    = 0;
+        for (Uint32 a = 0; a < NumCh; ++a)
+        {
+            for (Uint32 b = 0; b < NumCh; ++b)
+                NewAxis[a] += Cov[a][b] * Axis[b];
+            MaxComp = std::max(MaxComp, std::abs(NewAxis[a]));
+        }
+        if (MaxComp == 0)
+            break;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Axis[c] = NewAxis[c] / MaxComp;
+    }
+
+    float LenSq = 0;
+    for (Uint32 c = 0; c < NumCh; ++c)
+        LenSq += Axis[c] * Axis[c];
+    const float InvLen = 1.f / std::sqrt(LenSq);
+    for (Uint32 c = 0; c < NumCh; ++c)
+        Axis[c] *= InvLen;
+
+    float MinT = FLT_MAX;
+    float MaxT = -FLT_MAX;
+    for (Uint32 i = 0; i < N; ++i)
+    {
+        float t = 0;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            t += (Set.Ch[FirstCh + c][i] - Mean[c]) * Axis[c];
+        MinT = std::min(MinT, t);
+        MaxT = std::max(MaxT, t);
+    }
+
+    for (Uint32 c = 0; c < NumCh; ++c)
+    {
+        E0[FirstCh + c] = std::min(std::max(Mean[c] + MinT * Axis[c], 0.f), 255.f);
+        E1[FirstCh + c] = std::min(std::max(Mean[c] + MaxT * Axis[c], 0.f), 255.f);
+    }
+}
+
+// Computes the endpoints that minimize the squared error for the given interpolation weights.
+// Texels with negative weights are ignored.
+bool ComputeLeastSquaresEndpoints(const TexelSet& Set, Uint32 FirstCh, Uint32 NumCh, const float* Weights, float E0[], float E1[])
+{
+    float a = 0, b = 0, c = 0;
+    float d[4] = {}, e[4] = {};
+    for (Uint32 i = 0; i < Set.NumTexels; ++i)
+    {
+        const float w = Weights[i];
+        if (w < 0)
+            continue;
+        a += (1 - w) * (1 - w);
+        b += (1 - w) * w;
+        c += w * w;
+        for (Uint32 ch = 0; ch < NumCh; ++ch)
+        {
+            d[ch] += (1 - w) * Set.Ch[FirstCh + ch][i];
+            e[ch] += w * Set.Ch[FirstCh + ch][i];
+        }
+    }
+
+    const float Det = a * c - b * b;
+    if (std::abs(Det) < 1e-6f)
+        return false;
+
+    for (Uint32 ch = 0; ch < NumCh; ++ch)
+    {
+        E0[FirstCh + ch] = std::min(std::max((c * d[ch] - b * e[ch]) / Det, 0.f), 255.f);
+        E1[FirstCh + ch] = std::min(std::max((a * e[ch] - b * d[ch]) / Det, 0.f), 255.f);
+    }
+    return true;
+}
+
+inline Uint32 ExpandBits(Uint32 Value, Uint32 Bits)
+{
+    Value <<= 8 - Bits;
+    return Value | (Value >> Bits);
+}
+
+Uint32 GetNumRefineIterations(BLOCK_COMPRESSION_QUALITY Quality)
+{
+    switch (Quality)
+    {
+        case BLOCK_COMPRESSION_QUALITY_FAST: return 0;
+        case BLOCK_COMPRESSION_QUALITY_NORMAL: return 2;
+        default: return 4;
+    }
+}
+
+
+// BC1 color block
+
+inline Uint16 PackRGB565(const int rgb[])
+{
+    return static_cast<Uint16>((rgb[0] << 11) | (rgb[1] << 5) | rgb[2]);
+}
+
+inline void UnpackRGB565(Uint16 Color, int rgb[])
+{
+    rgb[0] = static_cast<int>(ExpandBits((Color >> 11) & 0x1F, 5));
+    rgb[1] = static_cast<int>(ExpandBits((Color >> 5) & 0x3F, 6));
+    rgb[2] = static_cast<int>(ExpandBits(Color & 0x1F, 5));
+}
+
+// Returns the 5- or 6-bit value whose expansion is closest to v
+inline int QuantizeUnorm(float v, Uint32 Bits)
+{
+    const int MaxQ  = (1 << Bits) - 1;
+    const int q     = std::min(std::max(static_cast<int>(v * MaxQ / 255.f + 0.5f), 0), MaxQ);
+    int       BestQ = q;
+    float     BestD = std::abs(static_cast<float>(ExpandBits(q, Bits)) - v);
+    for (int Candidate : {q - 1, q + 1})
+    {
+        if (Candidate < 0 || Candidate > MaxQ)
+            continue;
+        const float d = std::abs(static_cast<float>(ExpandBits(Candidate, Bits)) - v);
+        if (d < BestD)
+        {
+            BestD = d;
+            BestQ = Candidate;
+        }
+    }
+    return BestQ;
+}
+
+inline Uint16 QuantizeRGB565(const float rgb[])
+{
+    const int q[] = {QuantizeUnorm(rgb[0], 5), QuantizeUnorm(rgb[1], 6), QuantizeUnorm(rgb[2], 5)};
+    return PackRGB565(q);
+}
+
+// Builds the palette that the decoder uses for the color block.
+// Returns false for the 3-color mode, where entry 3 is transparent black.
+bool BuildBC1Palette(Uint16 Color0, Uint16 Color1, bool ForceFourColors, int Pal[4][3])
+{
+    UnpackRGB565(Color0, Pal[0]);
+    UnpackRGB565(Color1, Pal[1]);
+    if (Color0 > Color1 || ForceFourColors)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            Pal[2][c] = (2 * Pal[0][c] + Pal[1][c]) / 3;
+            Pal[3][c] = (Pal[0][c] + 2 * Pal[1][c]) / 3;
+        }
+        return true;
+    }
+    else
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            Pal[2][c] = (Pal[0][c] + Pal[1][c]) / 2;
+            Pal[3][c] = 0;
+        }
+        return false;
+    }
+}
+
+// Endpoint pairs that reproduce a single 8-bit value exactly or as close as possible
+// at index 2 of the 4-color palette.
+class BC1SingleColorTables
+{
+public:
+    static const BC1SingleColorTables& Get()
+    {
+        static const BC1SingleColorTables Tables;
+        return Tables;
+    }
+
+    const Uint8* GetEndpoints(Uint32 Channel, Uint32 Value) const
+    {
+        return Channel == 1 ? m_Table6[Value] : m_Table5[Value];
+    }
+
+private:
+    BC1SingleColorTables() noexcept
+    {
+        InitTable(m_Table5, 5);
+        InitTable(m_Table6, 6);
+    }
+
+    static void InitTable(Uint8 Table[256][2], Uint32 Bits)
+    {
+        const int MaxQ = (1 << Bits) - 1;
+        for (int v = 0; v < 256; ++v)
+        {
+            int BestError = INT_MAX;
+            for (int q0 = 0; q0 <= MaxQ; ++q0)
+            {
+                for (int q1 = 0; q1 <= MaxQ; ++q1)
+                {
+                    const int e0 = static_cast<int>(ExpandBits(q0, Bits));
+                    const int e1 = static_cast<int>(ExpandBits(q1, Bits));
+                    // Prefer endpoints that are close to each other
+                    const int Error = std::abs((2 * e0 + e1) / 3 - v) * 100 + std::abs(e0 - e1);
+                    if (Error < BestError)
+                    {
+                        BestError   = Error;
+                        Table[v][0] = static_cast<Uint8>(q0);
+                        Table[v][1] = static_cast<Uint8>(q1);
+                    }
+                }
+            }
+        }
+    }
+
+    Uint8 m_Table5[256][2];
+    Uint8 m_Table6[256][2];
+};
+
+struct BC1ColorEncoding
+{
+    Uint16 Color0 = 0;
+    Uint16 Color1 = 0;
+    Uint8  Indices[NumBlockTexels];
+    float  Error = FLT_MAX;
+};
+
+// Evaluates the endpoints and returns the total error of the opaque texels
+float EvaluateBC1Endpoints(const TexelSet& Set, Uint16 Color0, Uint16 Color1, bool ThreeColors, bool ForceFourColors, BC1ColorEncoding& Enc)
+{
+    // Order the endpoints to select the mode
+    if (ThreeColors ? Color0 > Color1 : Color0 < Color1)
+        std::swap(Color0, Color1);
+
+    int        Pal[4][3];
+    const bool FourColors = BuildBC1Palette(Color0, Color1, ForceFourColors, Pal);
+
+    Palette Pal4;
+    // Entry 3 of the 3-color palette is transparent black, so it can't be used for opaque texels
+    Pal4.NumEntries = FourColors ? 4 : 3;
+    for (Uint32 e = 0; e < Pal4.NumEntries; ++e)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+            Pal4.Ch[c][e] = static_cast<float>(Pal[e][c]);
+    }
+
+    Enc.Color0 = Color0;
+    Enc.Color1 = Color1;
+    Enc.Error  = FindClosestEntries(Set, 0, 3, Pal4, Enc.Indices);
+    return Enc.Error;
+}
+
+void FitBC1Endpoints(const TexelSet& Set, bool ThreeColors, bool ForceFourColors, Uint32 NumIterations, BC1ColorEncoding& Best)
+{
+    BC1ColorEncoding Enc;
+
+    bool IsSolid = true;
+    for (Uint32 i = 1; i < Set.NumTexels && IsSolid; ++i)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+            IsSolid = IsSolid && Set.Ch[c][i] == Set.Ch[c][0];
+    }
+    if (IsSolid && !ThreeColors)
+    {
+        const auto& Tables = BC1SingleColorTables::Get();
+
+        int q0[3], q1[3];
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            const auto* Endpoints = Tables.GetEndpoints(c, static_cast<Uint32>(Set.Ch[c][0]));
+            q0[c]                 = Endpoints[0];
+            q1[c]                 = Endpoints[1];
+        }
+        if (EvaluateBC1Endpoints(Set, PackRGB565(q0), PackRGB565(q1), ThreeColors, ForceFourColors, Enc) < Best.Error)
+            Best = Enc;
+    }
+
+    float E0[3], E1[3];
+    ComputePrincipalAxisEndpoints(Set, 0, 3, E0, E1);
+    if (EvaluateBC1Endpoints(Set, QuantizeRGB565(E0), QuantizeRGB565(E1), ThreeColors, ForceFourColors, Enc) < Best.Error)
+        Best = Enc;
+
+    for (Uint32 iter = 0; iter < NumIterations && Enc.Error > 0; ++iter)
+    {
+        // Weights of palette entries 0..3, ordered by the endpoint mode
+        int  Pal[4][3];
+        bool FourColors = BuildBC1Palette(Enc.Color0, Enc.Color1, ForceFourColors, Pal);
+
+        static constexpr float FourColorWeights[]  = {0, 1, 1.f / 3.f, 2.f / 3.f};
+        static constexpr float ThreeColorWeights[] = {0, 1, 0.5f, -1};
+
+        float Weights[NumBlockTexels];
+        for (Uint32 i = 0; i < Set.NumTexels; ++i)
+            Weights[i] = FourColors ? FourColorWeights[Enc.Indices[i]] : ThreeColorWeights[Enc.Indices[i]];
+        if (!ComputeLeastSquaresEndpoints(Set, 0, 3, Weights, E0, E1))
+            break;
+
+        const auto Color0 = QuantizeRGB565(E0);
+        const auto Color1 = QuantizeRGB565(E1);
+        if ((Color0 == Enc.Color0 && Color1 == Enc.Color1) || (Color0 == Enc.Color1 && Color1 == Enc.Color0))
+            break;
+        if (EvaluateBC1Endpoints(Set, Color0, Color1, ThreeColors, ForceFourColors, Enc) >= Best.Error)
+            break;
+        Best = Enc;
+    }
+}
+
+// Encodes the color part of the BC1, BC2 and BC3 blocks.
+// Texels with alpha less than 128 are encoded as transparent if AllowTransparent is true.
+void EncodeBC1ColorBlock(const TexelSet& Block, bool AllowTransparent, BLOCK_COMPRESSION_QUALITY Quality, Uint8* pDst)
+{
+    TexelSet Opaque;
+    Uint32   TransparentMask = 0;
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+    {
+        if (AllowTransparent && Block.Ch[3][i] < 128)
+            TransparentMask |= 1u << i;
+        else
+            Opaque.AddTexel(Block, i);
+    }
+
+    BC1ColorEncoding Best;
+    if (Opaque.NumTexels == 0)
+    {
+        // All texels are transparent
+        Best.Color0 = Best.Color1 = 0;
+    }
+    else
+    {
+        Opaque.Pad();
+
+        const auto NumIterations = GetNumRefineIterations(Quality);
+        // BC2 and BC3 always use four colors
+        const bool ForceFourColors = !AllowTransparent;
+        if (TransparentMask == 0)
+            FitBC1Endpoints(Opaque, /*ThreeColors = */ false, ForceFourColors, NumIterations, Best);
+        if (TransparentMask != 0 || (Quality == BLOCK_COMPRESSION_QUALITY_HIGH && !ForceFourColors))
+            FitBC1Endpoints(Opaque, /*ThreeColors = */ true, ForceFourColors, NumIterations, Best);
+    }
+
+    Uint32 Indices = 0;
+    Uint32 o       = 0;
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+    {
+        const Uint32 Idx = (TransparentMask & (1u << i)) ? 3 : Best.Indices[o++];
+        Indices |= Idx << (i * 2);
+    }
+
+    pDst[0] = static_cast<Uint8>(Best.Color0 & 0xFF);
+    pDst[1] = static_cast<Uint8>(Best.Color0 >> 8);
+    pDst[2] = static_cast<Uint8>(Best.Color1 & 0xFF);
+    pDst[3] = static_cast<Uint8>(Best.Color1 >> 8);
+    memcpy(pDst + 4, &Indices, sizeof(Indices));
+}
+
+void DecodeBC1ColorBlock(const Uint8* pSrc, bool ForceFourColors, Uint8 Texels[][4])
+{
+    const Uint16 Color0 = static_cast<Uint16>(pSrc[0] | (pSrc[1] << 8));
+    const Uint16 Color1 = static_cast<Uint16>(pSrc[2] | (pSrc[3] << 8));
+
+    int        Pal[4][3];
+    const bool FourColors = BuildBC1Palette(Color0, Color1, ForceFourColors, Pal);
+
+    Uint32 Indices;
+    memcpy(&Indices, pSrc + 4, sizeof(Indices));
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+    {
+        const Uint32 Idx = (Indices >> (i * 2)) & 3;
+        for (Uint32 c = 0; c < 3; ++c)
+            Texels[i][c] = static_cast<Uint8>(Pal[Idx][c]);
+        Texels[i][3] = !FourColors && Idx == 3 ? 0 : 255;
+    }
+}
+
+
+// BC4 block (also used for BC3 alpha and BC5)
+
+void BuildBC4Palette(int a0, int a1, int Pal[8])
+{
+    Pal[0] = a0;
+    Pal[1] = a1;
+    if (a0 > a1)
+    {
+        for (int i = 1; i < 7; ++i)
+            Pal[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+    }
+    else
+    {
+        for (int i = 1; i < 5; ++i)
+            Pal[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+        Pal[6] = 0;
+        Pal[7] = 255;
+    }
+}
+
+struct BC4Encoding
+{
+    int   a0 = 0;
+    int   a1 = 0;
+    Uint8 Indices[NumBlockTexels];
+    float Error = FLT_MAX;
+};
+
+float EvaluateBC4Endpoints(const TexelSet& Block, Uint32 Ch, int a0, int a1, BC4Encoding& Enc)
+{
+    int Pal[8];
+    BuildBC4Palette(a0, a1, Pal);
+
+    Palette Pal8;
+    Pal8.NumEntries = 8;
+    for (Uint32 e = 0; e < 8; ++e)
+        Pal8.Ch[Ch][e] = static_cast<float>(Pal[e]);
+
+    Enc.a0    = a0;
+    Enc.a1    = a1;
+    Enc.Error = FindClosestEntries(Block, Ch, 1, Pal8, Enc.Indices);
+    return Enc.Error;
+}
+
+void EncodeBC4Block(const TexelSet& Block, Uint32 Ch, BLOCK_COMPRESSION_QUALITY Quality, Uint8* pDst)
+{
+    float MinVal = 255, MaxVal = 0;
+    // Range of values excluding 0 and 255 for the 6-value mode
+    float MinVal6 = 255, MaxVal6 = 0;
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+    {
+        const float v = Block.Ch[Ch][i];
+        MinVal        = std::min(MinVal, v);
+        MaxVal        = std::max(MaxVal, v);
+        if (v > 0 && v < 255)
+        {
+            MinVal6 = std::min(MinVal6, v);
+            MaxVal6 = std::max(MaxVal6, v);
+        }
+    }
+
+    BC4Encoding Best, Enc;
+    // 8-value mode requires a0 > a1. If all values are equal, the 6-value mode is used, which is also exact.
+    EvaluateBC4Endpoints(Block, Ch, static_cast<int>(MaxVal), static_cast<int>(MinVal), Best);
+
+    if (Quality != BLOCK_COMPRESSION_QUALITY_FAST && Best.Error > 0)
+    {
+        if (MinVal6 <= MaxVal6 && EvaluateBC4Endpoints(Block, Ch, static_cast<int>(MinVal6), static_cast<int>(MaxVal6), Enc) < Best.Error)
+            Best = Enc;
+
+        // Refine the 8-value mode endpoints with least squares
+        Enc = Best;
+        for (Uint32 iter = 0; iter < GetNumRefineIterations(Quality) && Enc.a0 > Enc.a1; ++iter)
+        {
+            static constexpr float Weights8[] = {0, 1, 1 / 7.f, 2 / 7.f, 3 / 7.f, 4 / 7.f, 5 / 7.f, 6 / 7.f};
+
+            float Weights[NumBlockTexels];
+            for (Uint32 i = 0; i < NumBlockTexels; ++i)
+                Weights[i] = Weights8[Enc.Indices[i]];
+
+            float E0[4], E1[4];
+            if (!ComputeLeastSquaresEndpoints(Block, Ch, 1, Weights, E0, E1))
+                break;
+            const int a0 = static_cast<int>(E0[Ch] + 0.5f);
+            const int a1 = static_cast<int>(E1[Ch] + 0.5f);
+            if (a0 <= a1 || (a0 == Enc.a0 && a1 == Enc.a1))
+                break;
+            if (EvaluateBC4Endpoints(Block, Ch, a0, a1, Enc) >= Best.Error)
+                break;
+            Best = Enc;
+        }
+
+        if (Quality == BLOCK_COMPRESSION_QUALITY_HIGH && Best.Error > 0)
+        {
+            // Search the neighborhood of the best endpoints
+            const auto Center = Best;
+            for (int d0 = -2; d0 <= 2; ++d0)
+            {
+                for (int d1 = -2; d1 <= 2; ++d1)
+                {
+                    const int a0 = Center.a0 + d0;
+                    const int a1 = Center.a1 + d1;
+                    // Keep the mode
+                    if (a0 < 0 || a0 > 255 || a1 < 0 || a1 > 255 || (a0 > a1) != (Center.a0 > Center.a1))
+                        continue;
+                    if (EvaluateBC4Endpoints(Block, Ch, a0, a1, Enc) < Best.Error)
+                        Best = Enc;
+                }
+            }
+        }
+    }
+
+    Uint64 Indices = 0;
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        Indices |= Uint64{Best.Indices[i]} << (i * 3);
+
+    pDst[0] = static_cast<Uint8>(Best.a0);
+    pDst[1] = static_cast<Uint8>(Best.a1);
+    for (Uint32 i = 0; i < 6; ++i)
+        pDst[2 + i] = static_cast<Uint8>(Indices >> (i * 8));
+}
+
+void DecodeBC4Block(const Uint8* pSrc, Uint8 Texels[][4], Uint32 Ch)
+{
+    int Pal[8];
+    BuildBC4Palette(pSrc[0], pSrc[1], Pal);
+
+    Uint64 Indices = 0;
+    for (Uint32 i = 0; i < 6; ++i)
+        Indices |= Uint64{pSrc[2 + i]} << (i * 8);
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        Texels[i][Ch] = static_cast<Uint8>(Pal[(Indices >> (i * 3)) & 7]);
+}
+
+
+// BC2 alpha block
+
+void EncodeBC2AlphaBlock(const TexelSet& Block, Uint8* pDst)
+{
+    Uint64 Alpha = 0;
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        Alpha |= Uint64(static_cast<Uint32>(Block.Ch[3][i] * 15.f / 255.f + 0.5f)) << (i * 4);
+    memcpy(pDst, &Alpha, sizeof(Alpha));
+}
+
+void DecodeBC2AlphaBlock(const Uint8* pSrc, Uint8 Texels[][4])
+{
+    Uint64 Alpha;
+    memcpy(&Alpha, pSrc, sizeof(Alpha));
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        Texels[i][3] = static_cast<Uint8>(((Alpha >> (i * 4)) & 0xF) * 17);
+}
+
+
+// BC7 block
+
+struct BC7ModeInfo
+{
+    Uint8 NumSubsets;
+    Uint8 PartitionBits;
+    Uint8 RotationBits;
+    Uint8 IndexSelectionBits;
+    Uint8 ColorBits;
+    Uint8 AlphaBits;
+    Uint8 EndpointPBits;
+    Uint8 SharedPBits;
+    Uint8 IndexBits;
+    Uint8 Index2Bits;
+};
+
+// clang-format off
+constexpr BC7ModeInfo BC7Modes[] =
+{
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+// Two-subset partitions, one bit per texel
+constexpr Uint16 BC7Partitions2[64] =
+{
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// Three-subset partitions, two bits per texel
+constexpr Uint32 BC7Partitions3[64] =
+{
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+// Anchor texel of the second subset of two-subset partitions
+constexpr Uint8 BC7Anchors2[64] =
+{
+    15, 15, 15, 15, 15, 15, 15, 15,  15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,   2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,   2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2,  15, 15, 15, 15, 15,  2,  2, 15,
+};
+
+// Anchor texels of the second and third subsets of three-subset partitions
+constexpr Uint8 BC7Anchors3[2][64] =
+{
+    {
+         3,  3, 15, 15,  8,  3, 15, 15,   8,  8,  6,  6,  6,  5,  3,  3,
+         3,  3,  8, 15,  3,  3,  6, 10,   5,  8,  8,  6,  8,  5, 15, 15,
+         8, 15,  3,  5,  6, 10,  8, 15,  15,  3, 15,  5, 15, 15, 15, 15,
+         3, 15,  5,  5,  5,  8,  5, 10,   5, 10,  8, 13, 15, 12,  3,  3,
+    },
+    {
+        15,  8,  8,  3, 15, 15,  3,  8,  15, 15, 15, 15, 15, 15, 15,  8,
+        15,  8, 15,  3, 15,  8, 15,  8,   3, 15,  6, 10, 15, 15, 10,  8,
+        15,  3, 15, 10, 10,  8,  9, 10,   6, 15,  8, 15,  3,  6,  6,  8,
+        15,  3, 15, 15, 15, 15, 15, 15,  15, 15, 15, 15,  3, 15, 15,  8,
+    },
+};
+
+constexpr Uint8 BC7Weights2[] = {0, 21, 43, 64};
+constexpr Uint8 BC7Weights3[] = {0, 9, 18, 27, 37, 46, 55, 64};
+constexpr Uint8 BC7Weights4[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+// clang-format on
+
+inline const Uint8* GetBC7Weights(Uint32 IndexBits)
+{
+    return IndexBits == 2 ? BC7Weights2 : (IndexBits == 3 ? BC7Weights3 : BC7Weights4);
+}
+
+inline Uint32 GetBC7Subset(Uint32 NumSubsets, Uint32 Partition, Uint32 Texel)
+{
+    switch (NumSubsets)
+    {
+        case 2: return (BC7Partitions2[Partition] >> Texel) & 1u;
+        case 3: return (BC7Partitions3[Partition] >> (Texel * 2)) & 3u;
+        default: return 0;
+    }
+}
+
+inline Uint32 GetBC7AnchorTexel(Uint32 NumSubsets, Uint32 Partition, Uint32 Subset)
+{
+    if (Subset == 0)
+        return 0;
+    return NumSubsets == 2 ? BC7Anchors2[Partition] : BC7Anchors3[Subset - 1][Partition];
+}
+
+inline int BC7Interpolate(int e0, int e1, int w)
+{
+    return ((64 - w) * e0 + w * e1 + 32) >> 6;
+}
+
+class BC7BitWriter
+{
+public:
+    void Write(Uint32 Value, Uint32 NumBits)
+    {
+        VERIFY_EXPR(m_Pos + NumBits <= 128 && (NumBits == 32 || (Value >> NumBits) == 0));
+        if (m_Pos < 64)
+        {
+            m_Bits[0] |= Uint64{Value} << m_Pos;
+            if (m_Pos + NumBits > 64)
+                m_Bits[1] |= Uint64{Value} >> (64 - m_Pos);
+        }
+        else
+        {
+            m_Bits[1] |= Uint64{Value} << (m_Pos - 64);
+        }
+        m_Pos += NumBits;
+    }
+
+    void Store(Uint8* pDst) const
+    {
+        VERIFY(m_Pos == 128, "BC7 block must contain exactly 128 bits");
+        for (Uint32 i = 0; i < 16; ++i)
+            pDst[i] = static_cast<Uint8>(m_Bits[i / 8] >> ((i % 8) * 8));
+    }
+
+private:
+    Uint64 m_Bits[2] = {};
+    Uint32 m_Pos     = 0;
+};
+
+class BC7BitReader
+{
+public:
+    explicit BC7BitReader(const Uint8* pSrc)
+    {
+        for (Uint32 i = 0; i < 16; ++i)
+            m_Bits[i / 8] |= Uint64{pSrc[i]} << ((i % 8) * 8);
+    }
+
+    Uint32 Read(Uint32 NumBits)
+    {
+        VERIFY_EXPR(NumBits < 32 && m_Pos + NumBits <= 128);
+        Uint64 Value;
+        if (m_Pos >= 64)
+            Value = m_Bits[1] >> (m_Pos - 64);
+        else if (m_Pos + NumBits <= 64)
+            Value = m_Bits[0] >> m_Pos;
+        else
+            Value = (m_Bits[0] >> m_Pos) | (m_Bits[1] << (64 - m_Pos));
+        m_Pos += NumBits;
+        return static_cast<Uint32>(Value & ((Uint64{1} << NumBits) - 1));
+    }
+
+private:
+    Uint64 m_Bits[2] = {};
+    Uint32 m_Pos     = 0;
+};
+
+enum BC7_PBIT_MODE
+{
+    BC7_PBIT_MODE_NONE,
+    BC7_PBIT_MODE_UNIQUE,
+    BC7_PBIT_MODE_SHARED
+};
+
+struct BC7EndpointPair
+{
+    // Quantized values without p-bits
+    int Q[2][4] = {};
+
+    // Unquantized 8-bit values
+    int Unq[2][4] = {};
+
+    int PBits[2] = {};
+};
+
+// Finds the quantized value whose expansion is closest to v. PBit < 0 means no p-bit.
+inline float QuantizeBC7Component(float v, Uint32 Bits, int PBit, int& Q, int& Unq)
+{
+    const Uint32 TotalBits = Bits + (PBit >= 0 ? 1 : 0);
+    const int    MaxQ      = (1 << Bits) - 1;
+    const float  Scaled    = v * static_cast<float>((1 << TotalBits) - 1) / 255.f;
+    const int    q         = PBit >= 0 ? static_cast<int>(std::floor((Scaled - PBit) * 0.5f + 0.5f)) : static_cast<int>(std::floor(Scaled + 0.5f));
+
+    float BestError = FLT_MAX;
+    for (int Candidate = std::max(q - 1, 0); Candidate <= std::min(q + 1, MaxQ); ++Candidate)
+    {
+        const Uint32 Code  = PBit >= 0 ? ((Candidate << 1) | PBit) : Candidate;
+        const int    Value = static_cast<int>(ExpandBits(Code, TotalBits));
+        const float  Error = (Value - v) * (Value - v);
+        if (Error < BestError)
+        {
+            BestError = Error;
+            Q         = Candidate;
+            Unq       = Value;
+        }
+    }
+    return BestError;
+}
+
+// Quantizes the endpoint pair, selecting the p-bits that minimize the endpoint error
+void QuantizeBC7Endpoints(const float E[2][4], Uint32 FirstCh, Uint32 NumCh, const Uint32 ChBits[], BC7_PBIT_MODE PBitMode, BC7EndpointPair& Endpoints)
+{
+    auto QuantizeEndpoint = [&](Uint32 e, int PBit) {
+        float Error = 0;
+        for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+            Error += QuantizeBC7Component(E[e][c], ChBits[c], PBit, Endpoints.Q[e][c], Endpoints.Unq[e][c]);
+        Endpoints.PBits[e] = PBit;
+        return Error;
+    };
+
+    switch (PBitMode)
+    {
+        case BC7_PBIT_MODE_NONE:
+            QuantizeEndpoint(0, -1);
+            QuantizeEndpoint(1, -1);
+            Endpoints.PBits[0] = Endpoints.PBits[1] = 0;
+            break;
+
+        case BC7_PBIT_MODE_UNIQUE:
+            for (Uint32 e = 0; e < 2; ++e)
+            {
+                const float Error0 = QuantizeEndpoint(e, 0);
+                const float Error1 = QuantizeEndpoint(e, 1);
+                if (Error0 <= Error1)
+                    QuantizeEndpoint(e, 0);
+            }
+            break;
+
+        case BC7_PBIT_MODE_SHARED:
+        {
+            const float Error0 = QuantizeEndpoint(0, 0) + QuantizeEndpoint(1, 0);
+            const float Error1 = QuantizeEndpoint(0, 1) + QuantizeEndpoint(1, 1);
+            if (Error0 <= Error1)
+            {
+                QuantizeEndpoint(0, 0);
+                QuantizeEndpoint(1, 0);
+            }
+            break;
+        }
+    }
+}
+
+struct BC7EndpointFit
+{
+    BC7EndpointPair Endpoints;
+    Uint8           Indices[NumBlockTexels] = {};
+    float           Error                   = FLT_MAX;
+};
+
+float EvaluateBC7Endpoints(const TexelSet& Set, Uint32 FirstCh, Uint32 NumCh, const float E[2][4], const Uint32 ChBits[], BC7_PBIT_MODE PBitMode, Uint32 IndexBits, BC7EndpointFit& Fit)
+{
+    QuantizeBC7Endpoints(E, FirstCh, NumCh, ChBits, PBitMode, Fit.Endpoints);
+
+    const auto* Weights = GetBC7Weights(IndexBits);
+
+    Palette Pal;
+    Pal.NumEntries = 1u << IndexBits;
+    for (Uint32 i = 0; i < Pal.NumEntries; ++i)
+    {
+        for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+            Pal.Ch[c][i] = static_cast<float>(BC7Interpolate(Fit.Endpoints.Unq[0][c], Fit.Endpoints.Unq[1][c], Weights[i]));
+    }
+
+    Fit.Error = FindClosestEntries(Set, FirstCh, NumCh, Pal, Fit.Indices);
+    return Fit.Error;
+}
+
+// Fits quantized endpoints and indices to the texel set using channels [FirstCh, FirstCh + NumCh)
+void FitBC7Endpoints(const TexelSet& Set, Uint32 FirstCh, Uint32 NumCh, const Uint32 ChBits[], BC7_PBIT_MODE PBitMode, Uint32 IndexBits, Uint32 NumIterations, BC7EndpointFit& Best)
+{
+    float E[2][4] = {};
+    ComputePrincipalAxisEndpoints(Set, FirstCh, NumCh, E[0], E[1]);
+
+    BC7EndpointFit Fit;
+    Best.Error = FLT_MAX;
+    EvaluateBC7Endpoints(Set, FirstCh, NumCh, E, ChBits, PBitMode, IndexBits, Best);
+
+    const auto* Weights = GetBC7Weights(IndexBits);
+    for (Uint32 iter = 0; iter < NumIterations && Best.Error > 0; ++iter)
+    {
+        float TexelWeights[NumBlockTexels];
+        for (Uint32 i = 0; i < Set.NumTexels; ++i)
+            TexelWeights[i] = static_cast<float>(Weights[Best.Indices[i]]) / 64.f;
+        if (!ComputeLeastSquaresEndpoints(Set, FirstCh, NumCh, TexelWeights, E[0], E[1]))
+            break;
+
+        if (EvaluateBC7Endpoints(Set, FirstCh, NumCh, E, ChBits, PBitMode, IndexBits, Fit) >= Best.Error)
+            break;
+        Best = Fit;
+    }
+}
+
+struct BC7Encoding
+{
+    Uint32 Mode           = 0;
+    Uint32 Partition      = 0;
+    Uint32 Rotation       = 0;
+    Uint32 IndexSelection = 0;
+
+    BC7EndpointPair Endpoints[3];
+
+    // Color indices and, for modes 4 and 5, alpha indices
+    Uint8 Indices[NumBlockTexels]      = {};
+    Uint8 AlphaIndices[NumBlockTexels] = {};
+
+    float Error = FLT_MAX;
+};
+
+inline BC7_PBIT_MODE GetBC7PBitMode(const BC7ModeInfo& Info)
+{
+    return Info.EndpointPBits ? BC7_PBIT_MODE_UNIQUE : (Info.SharedPBits ? BC7_PBIT_MODE_SHARED : BC7_PBIT_MODE_NONE);
+}
+
+// Encodes the block with the mode that uses the same indices for all channels (0, 1, 2, 3, 6, 7)
+float EncodeBC7BlockWithSharedIndices(const TexelSet& Block, Uint32 Mode, Uint32 Partition, Uint32 NumIterations, BC7Encoding& Enc)
+{
+    const auto&  Info     = BC7Modes[Mode];
+    const Uint32 NumCh    = Info.AlphaBits != 0 ? 4 : 3;
+    const Uint32 ChBits[] = {Info.ColorBits, Info.ColorBits, Info.ColorBits, Info.AlphaBits};
+
+    Enc.Mode           = Mode;
+    Enc.Partition      = Partition;
+    Enc.Rotation       = 0;
+    Enc.IndexSelection = 0;
+    Enc.Error          = 0;
+    for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+    {
+        TexelSet Subset;
+        for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        {
+            if (GetBC7Subset(Info.NumSubsets, Partition, i) == s)
+                Subset.AddTexel(Block, i);
+        }
+        Subset.Pad();
+
+        BC7EndpointFit Fit;
+        FitBC7Endpoints(Subset, 0, NumCh, ChBits, GetBC7PBitMode(Info), Info.IndexBits, NumIterations, Fit);
+        Enc.Endpoints[s] = Fit.Endpoints;
+        for (Uint32 i = 0; i < Subset.NumTexels; ++i)
+            Enc.Indices[Subset.Pos[i]] = Fit.Indices[i];
+        Enc.Error += Fit.Error;
+    }
+
+    if (NumCh == 3)
+    {
+        // Alpha is always 255 in modes without alpha
+        for (Uint32 i = 0; i < NumBlockTexels; ++i)
+            Enc.Error += (255.f - Block.Ch[3][i]) * (255.f - Block.Ch[3][i]);
+    }
+    return Enc.Error;
+}
+
+// Encodes the block with mode 4 or 5 that use separate indices for color and alpha
+float EncodeBC7BlockWithSeparateAlpha(const TexelSet& Block, Uint32 Mode, Uint32 Rotation, Uint32 IndexSelection, Uint32 NumIterations, BC7Encoding& Enc)
+{
+    const auto&  Info     = BC7Modes[Mode];
+    const Uint32 ChBits[] = {Info.ColorBits, Info.ColorBits, Info.ColorBits, Info.AlphaBits};
+
+    // Rotation swaps alpha with one of the color channels
+    TexelSet Rotated = Block;
+    if (Rotation != 0)
+        std::swap(Rotated.Ch[3], Rotated.Ch[Rotation - 1]);
+
+    const Uint32 ColorIndexBits = IndexSelection ? Info.Index2Bits : Info.IndexBits;
+    const Uint32 AlphaIndexBits = IndexSelection ? Info.IndexBits : Info.Index2Bits;
+
+    BC7EndpointFit ColorFit, AlphaFit;
+    FitBC7Endpoints(Rotated, 0, 3, ChBits, BC7_PBIT_MODE_NONE, ColorIndexBits, NumIterations, ColorFit);
+    FitBC7Endpoints(Rotated, 3, 1, ChBits, BC7_PBIT_MODE_NONE, AlphaIndexBits, NumIterations, AlphaFit);
+
+    Enc.Mode           = Mode;
+    Enc.Partition      = 0;
+    Enc.Rotation       = Rotation;
+    Enc.IndexSelection = IndexSelection;
+    Enc.Endpoints[0]   = ColorFit.Endpoints;
+    for (Uint32 e = 0; e < 2; ++e)
+    {
+        Enc.Endpoints[0].Q[e][3]   = AlphaFit.Endpoints.Q[e][3];
+        Enc.Endpoints[0].Unq[e][3] = AlphaFit.Endpoints.Unq[e][3];
+    }
+    memcpy(Enc.Indices, ColorFit.Indices, sizeof(Enc.Indices));
+    memcpy(Enc.AlphaIndices, AlphaFit.Indices, sizeof(Enc.AlphaIndices));
+    Enc.Error = ColorFit.Error + AlphaFit.Error;
+    return Enc.Error;
+}
+
+// Swaps the endpoints of subsets whose anchor index has the most significant bit set,
+// since this bit is not stored.
+void FixBC7AnchorIndices(BC7Encoding& Enc)
+{
+    const auto& Info = BC7Modes[Enc.Mode];
+    if (Info.Index2Bits != 0)
+    {
+        const Uint32 ColorIndexBits = Enc.IndexSelection ? Info.Index2Bits : Info.IndexBits;
+        const Uint32 AlphaIndexBits = Enc.IndexSelection ? Info.IndexBits : Info.Index2Bits;
+
+        auto Fix = [&Enc](Uint8* Indices, Uint32 IndexBits, Uint32 FirstCh, Uint32 NumCh) {
+            const Uint32 MaxIndex = (1u << IndexBits) - 1;
+            if (Indices[0] <= MaxIndex / 2)
+                return;
+            for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+            {
+                std::swap(Enc.Endpoints[0].Q[0][c], Enc.Endpoints[0].Q[1][c]);
+                std::swap(Enc.Endpoints[0].Unq[0][c], Enc.Endpoints[0].Unq[1][c]);
+            }
+            for (Uint32 i = 0; i < NumBlockTexels; ++i)
+                Indices[i] = static_cast<Uint8>(MaxIndex - Indices[i]);
+        };
+        Fix(Enc.Indices, ColorIndexBits, 0, 3);
+        Fix(Enc.AlphaIndices, AlphaIndexBits, 3, 1);
+        return;
+    }
+
+    const Uint32 MaxIndex = (1u << Info.IndexBits) - 1;
+    for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+    {
+        if (Enc.Indices[GetBC7AnchorTexel(Info.NumSubsets, Enc.Partition, s)] <= MaxIndex / 2)
+            continue;
+
+        auto& Endpoints = Enc.Endpoints[s];
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            std::swap(Endpoints.Q[0][c], Endpoints.Q[1][c]);
+            std::swap(Endpoints.Unq[0][c], Endpoints.Unq[1][c]);
+        }
+        std::swap(Endpoints.PBits[0], Endpoints.PBits[1]);
+        for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        {
+            if (GetBC7Subset(Info.NumSubsets, Enc.Partition, i) == s)
+                Enc.Indices[i] = static_cast<Uint8>(MaxIndex - Enc.Indices[i]);
+        }
+    }
+}
+
+void WriteBC7Block(BC7Encoding Enc, Uint8* pDst)
+{
+    FixBC7AnchorIndices(Enc);
+
+    const auto& Info = BC7Modes[Enc.Mode];
+
+    BC7BitWriter Writer;
+    Writer.Write(1u << Enc.Mode, Enc.Mode + 1);
+    Writer.Write(Enc.Partition, Info.PartitionBits);
+    Writer.Write(Enc.Rotation, Info.RotationBits);
+    Writer.Write(Enc.IndexSelection, Info.IndexSelectionBits);
+
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+        {
+            for (Uint32 e = 0; e < 2; ++e)
+                Writer.Write(Enc.Endpoints[s].Q[e][c], Info.ColorBits);
+        }
+    }
+    if (Info.AlphaBits != 0)
+    {
+        for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+        {
+            for (Uint32 e = 0; e < 2; ++e)
+                Writer.Write(Enc.Endpoints[s].Q[e][3], Info.AlphaBits);
+        }
+    }
+    for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+    {
+        if (Info.EndpointPBits)
+        {
+            Writer.Write(Enc.Endpoints[s].PBits[0], 1);
+            Writer.Write(Enc.Endpoints[s].PBits[1], 1);
+        }
+        else if (Info.SharedPBits)
+        {
+            Writer.Write(Enc.Endpoints[s].PBits[0], 1);
+        }
+    }
+
+    if (Info.Index2Bits != 0)
+    {
+        // Primary indices use IndexBits, secondary indices use Index2Bits
+        const auto* PrimaryIndices   = Enc.IndexSelection ? Enc.AlphaIndices : Enc.Indices;
+        const auto* SecondaryIndices = Enc.IndexSelection ? Enc.Indices : Enc.AlphaIndices;
+        for (Uint32 i = 0; i < NumBlockTexels; ++i)
+            Writer.Write(PrimaryIndices[i], Info.IndexBits - (i == 0 ? 1 : 0));
+        for (Uint32 i = 0; i < NumBlockTexels; ++i)
+            Writer.Write(SecondaryIndices[i], Info.Index2Bits - (i == 0 ? 1 : 0));
+    }
+    else
+    {
+        for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        {
+            bool IsAnchor = false;
+            for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+                IsAnchor = IsAnchor || GetBC7AnchorTexel(Info.NumSubsets, Enc.Partition, s) == i;
+            Writer.Write(Enc.Indices[i], Info.IndexBits - (IsAnchor ? 1 : 0));
+        }
+    }
+
+    Writer.Store(pDst);
+}
+
+// First and second moments of a set of texels: the texel count, the sums of the
+// components and the sums of the pairwise component products.
+struct TexelMoments
+{
+    static constexpr Uint32 NumValues = 1 + 4 + 10;
+
+    float Values[NumValues] = {};
+
+    static Uint32 GetProductIndex(Uint32 a, Uint32 b)
+    {
+        // Upper triangle of the 4x4 matrix
+        static constexpr Uint8 Indices[4][4] = {
+            {0, 1, 2, 3},
+            {1, 4, 5, 6},
+            {2, 5, 7, 8},
+            {3, 6, 8, 9},
+        };
+        return 5u + Indices[a][b];
+    }
+
+    static TexelMoments FromTexel(const TexelSet& Block, Uint32 Texel)
+    {
+        TexelMoments M;
+        M.Values[0] = 1;
+        for (Uint32 a = 0; a < 4; ++a)
+        {
+            M.Values[1 + a] = Block.Ch[a][Texel];
+            for (Uint32 b = a; b < 4; ++b)
+                M.Values[GetProductIndex(a, b)] = Block.Ch[a][Texel] * Block.Ch[b][Texel];
+        }
+        return M;
+    }
+
+    TexelMoments& operator+=(const TexelMoments& Rhs)
+    {
+        for (Uint32 i = 0; i < NumValues; ++i)
+            Values[i] += Rhs.Values[i];
+        return *this;
+    }
+
+    TexelMoments& operator-=(const TexelMoments& Rhs)
+    {
+        for (Uint32 i = 0; i < NumValues; ++i)
+            Values[i] -= Rhs.Values[i];
+        return *this;
+    }
+
+    // Returns the squared distance of the texels to their principal axis, which
+    // is the error of the line fit before the endpoints are quantized.
+    template <Uint32 NumCh>
+    float GetLineFitError() const
+    {
+        const float Count = Values[0];
+        if (Count < 2)
+            return 0;
+
+        float  Cov[4][4];
+        float  Trace    = 0;
+        Uint32 MaxVarCh = 0;
+        for (Uint32 a = 0; a < NumCh; ++a)
+        {
+            for (Uint32 b = a; b < NumCh; ++b)
+                Cov[a][b] = Cov[b][a] = Values[GetProductIndex(a, b)] - Values[1 + a] * Values[1 + b] / Count;
+            Trace += Cov[a][a];
+            if (Cov[a][a] > Cov[MaxVarCh][MaxVarCh])
+                MaxVarCh = a;
+        }
+        if (Trace <= 0)
+            return 0;
+
+        float Axis[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Axis[c] = Cov[MaxVarCh][c];
+        for (Uint32 iter = 0; iter < 3; ++iter)
+        {
+            float NewAxis[4] = {};
+            for (Uint32 a = 0; a < NumCh; ++a)
+            {
+                for (Uint32 b = 0; b < NumCh; ++b)
+                    NewAxis[a] += Cov[a][b] * Axis[b];
+            }
+            for (Uint32 c = 0; c < NumCh; ++c)
+                Axis[c] = NewAxis[c];
+        }
+
+        // Rayleigh quotient gives the largest eigenvalue, i.e. the variance along the axis
+        float AxisLenSq = 0;
+        float AxisVar   = 0;
+        for (Uint32 a = 0; a < NumCh; ++a)
+        {
+            AxisLenSq += Axis[a] * Axis[a];
+            for (Uint32 b = 0; b < NumCh; ++b)
+                AxisVar += Axis[a] * Cov[a][b] * Axis[b];
+        }
+        return AxisLenSq > 0 ? std::max(Trace - AxisVar / AxisLenSq, 0.f) : Trace;
+    }
+};
+
+// Estimates the error of every partition as the total error of the line fit of each subset
+// and returns the partitions sorted by the estimated error.
+template <Uint32 NumCh>
+void EstimateBC7Partitions(const TexelSet& Block, Uint32 NumSubsets, Uint32 NumPartitions, Uint8* SortedPartitions)
+{
+    TexelMoments TexelM[NumBlockTexels];
+    TexelMoments BlockM;
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+    {
+        TexelM[i] = TexelMoments::FromTexel(Block, i);
+        BlockM += TexelM[i];
+    }
+
+    float Errors[64];
+    for (Uint32 p = 0; p < NumPartitions; ++p)
+    {
+        TexelMoments SubsetM[3];
+        for (Uint32 i = 1; i < NumBlockTexels; ++i)
+        {
+            // Texel 0 always belongs to subset 0
+            if (const Uint32 s = GetBC7Subset(NumSubsets, p, i))
+                SubsetM[s] += TexelM[i];
+        }
+        SubsetM[0] = BlockM;
+        SubsetM[0] -= SubsetM[1];
+        SubsetM[0] -= SubsetM[2];
+
+        Errors[p] = 0;
+        for (Uint32 s = 0; s < NumSubsets; ++s)
+            Errors[p] += SubsetM[s].template GetLineFitError<NumCh>();
+        SortedPartitions[p] = static_cast<Uint8>(p);
+    }
+
+    std::sort(SortedPartitions, SortedPartitions + NumPartitions, [&Errors](Uint8 p0, Uint8 p1) { return Errors[p0] < Errors[p1]; });
+}
+
+void EstimateBC7Partitions(const TexelSet& Block, Uint32 NumSubsets, Uint32 NumPartitions, Uint32 NumCh, Uint8* SortedPartitions)
+{
+    if (NumCh == 3)
+        EstimateBC7Partitions<3>(Block, NumSubsets, NumPartitions, SortedPartitions);
+    else
+        EstimateBC7Partitions<4>(Block, NumSubsets, NumPartitions, SortedPartitions);
+}
+
+void EncodeBC7Block(const TexelSet& Block, BLOCK_COMPRESSION_QUALITY Quality, Uint8* pDst)
+{
+    bool IsOpaque = true;
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+        IsOpaque = IsOpaque && Block.Ch[3][i] == 255.f;
+
+    const auto NumIterations = GetNumRefineIterations(Quality);
+
+    BC7Encoding Best, Enc;
+    EncodeBC7BlockWithSharedIndices(Block, 6, 0, NumIterations, Best);
+
+    auto TryEncoding = [&](float Error) {
+        if (Error < Best.Error)
+            Best = Enc;
+    };
+
+    if (Quality != BLOCK_COMPRESSION_QUALITY_FAST)
+    {
+        const Uint32 NumRotations = Quality == BLOCK_COMPRESSION_QUALITY_HIGH ? 4 : 1;
+        for (Uint32 Rotation = 0; Rotation < NumRotations && Best.Error > 0; ++Rotation)
+        {
+            TryEncoding(EncodeBC7BlockWithSeparateAlpha(Block, 5, Rotation, 0, NumIterations, Enc));
+            if (Quality == BLOCK_COMPRESSION_QUALITY_HIGH)
+            {
+                TryEncoding(EncodeBC7BlockWithSeparateAlpha(Block, 4, Rotation, 0, NumIterations, Enc));
+                TryEncoding(EncodeBC7BlockWithSeparateAlpha(Block, 4, Rotation, 1, NumIterations, Enc));
+            }
+        }
+
+        // Modes 0 - 3 do not encode alpha
+        const Uint32 NumCh = IsOpaque ? 3 : 4;
+
+        Uint8 Partitions[64];
+        if (Best.Error > 0)
+        {
+            EstimateBC7Partitions(Block, 2, 64, NumCh, Partitions);
+
+            const Uint32 NumCandidates = Quality == BLOCK_COMPRESSION_QUALITY_HIGH ? 6 : 2;
+            for (Uint32 i = 0; i < NumCandidates && Best.Error > 0; ++i)
+            {
+                if (IsOpaque)
+                {
+                    TryEncoding(EncodeBC7BlockWithSharedIndices(Block, 1, Partitions[i], NumIterations, Enc));
+                    TryEncoding(EncodeBC7BlockWithSharedIndices(Block, 3, Partitions[i], NumIterations, Enc));
+                }
+                else
+                {
+                    TryEncoding(EncodeBC7BlockWithSharedIndices(Block, 7, Partitions[i], NumIterations, Enc));
+                }
+            }
+        }
+
+        if (Quality == BLOCK_COMPRESSION_QUALITY_HIGH && IsOpaque && Best.Error > 0)
+        {
+            constexpr Uint32 NumCandidates = 4;
+
+            // Mode 0 only uses the first 16 partitions
+            EstimateBC7Partitions(Block, 3, 16, NumCh, Partitions);
+            for (Uint32 i = 0; i < NumCandidates && Best.Error > 0; ++i)
+                TryEncoding(EncodeBC7BlockWithSharedIndices(Block, 0, Partitions[i], NumIterations, Enc));
+
+            EstimateBC7Partitions(Block, 3, 64, NumCh, Partitions);
+            for (Uint32 i = 0; i < NumCandidates && Best.Error > 0; ++i)
+                TryEncoding(EncodeBC7BlockWithSharedIndices(Block, 2, Partitions[i], NumIterations, Enc));
+        }
+    }
+
+    WriteBC7Block(Best, pDst);
+}
+
+void DecodeBC7Block(const Uint8* pSrc, Uint8 Texels[][4])
+{
+    Uint32 Mode = 0;
+    while (Mode < 8 && (pSrc[0] & (1u << Mode)) == 0)
+        ++Mode;
+    if (Mode == 8)
+    {
+        // Reserved mode: the block is decoded as transparent black
+        memset(Texels, 0, NumBlockTexels * 4);
+        return;
+    }
+
+    const auto& Info = BC7Modes[Mode];
+
+    BC7BitReader Reader{pSrc};
+    Reader.Read(Mode + 1);
+    const Uint32 Partition      = Reader.Read(Info.PartitionBits);
+    const Uint32 Rotation       = Reader.Read(Info.RotationBits);
+    const Uint32 IndexSelection = Reader.Read(Info.IndexSelectionBits);
+
+    int Endpoints[3][2][4] = {};
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+        {
+            for (Uint32 e = 0; e < 2; ++e)
+                Endpoints[s][e][c] = static_cast<int>(Reader.Read(Info.ColorBits));
+        }
+    }
+    if (Info.AlphaBits != 0)
+    {
+        for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+        {
+            for (Uint32 e = 0; e < 2; ++e)
+                Endpoints[s][e][3] = static_cast<int>(Reader.Read(Info.AlphaBits));
+        }
+    }
+
+    const Uint32 PBits = Info.EndpointPBits | Info.SharedPBits;
+    for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+    {
+        int PBit[2] = {};
+        if (Info.EndpointPBits)
+        {
+            PBit[0] = static_cast<int>(Reader.Read(1));
+            PBit[1] = static_cast<int>(Reader.Read(1));
+        }
+        else if (Info.SharedPBits)
+        {
+            PBit[0] = PBit[1] = static_cast<int>(Reader.Read(1));
+        }
+
+        for (Uint32 e = 0; e < 2; ++e)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+            {
+                const Uint32 Bits = c < 3 ? Info.ColorBits : Info.AlphaBits;
+                if (Bits == 0)
+                {
+                    Endpoints[s][e][c] = 255;
+                    continue;
+                }
+                const Uint32 Code  = PBits ? ((Endpoints[s][e][c] << 1) | PBit[e]) : Endpoints[s][e][c];
+                Endpoints[s][e][c] = static_cast<int>(ExpandBits(Code, Bits + PBits));
+            }
+        }
+    }
+
+    Uint8 Indices[NumBlockTexels];
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+    {
+        bool IsAnchor = false;
+        for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+            IsAnchor = IsAnchor || GetBC7AnchorTexel(Info.NumSubsets, Partition, s) == i;
+        Indices[i] = static_cast<Uint8>(Reader.Read(Info.IndexBits - (IsAnchor ? 1 : 0)));
+    }
+
+    Uint8 Indices2[NumBlockTexels] = {};
+    if (Info.Index2Bits != 0)
+    {
+        for (Uint32 i = 0; i < NumBlockTexels; ++i)
+            Indices2[i] = static_cast<Uint8>(Reader.Read(Info.Index2Bits - (i == 0 ? 1 : 0)));
+    }
+
+    const auto* ColorWeights = GetBC7Weights(Info.IndexBits);
+    const auto* AlphaWeights = ColorWeights;
+    const auto* ColorIndices = Indices;
+    const auto* AlphaIndices = Indices;
+    if (Info.Index2Bits != 0)
+    {
+        if (IndexSelection == 0)
+        {
+            AlphaWeights = GetBC7Weights(Info.Index2Bits);
+            AlphaIndices = Indices2;
+        }
+        else
+        {
+            ColorWeights = GetBC7Weights(Info.Index2Bits);
+            ColorIndices = Indices2;
+        }
+    }
+
+    for (Uint32 i = 0; i < NumBlockTexels; ++i)
+    {
+        const auto& Endpoint = Endpoints[GetBC7Subset(Info.NumSubsets, Partition, i)];
+        for (Uint32 c = 0; c < 3; ++c)
+            Texels[i][c] = static_cast<Uint8>(BC7Interpolate(Endpoint[0][c], Endpoint[1][c], ColorWeights[ColorIndices[i]]));
+        Texels[i][3] = static_cast<Uint8>(BC7Interpolate(Endpoint[0][3], Endpoint[1][3], AlphaWeights[AlphaIndices[i]]));
+        if (Rotation != 0)
+            std::swap(Texels[i][3], Texels[i][Rotation - 1]);
+    }
+}
+
+
+enum BC_FORMAT_TYPE
+{
+    BC_FORMAT_TYPE_UNKNOWN,
+    BC_FORMAT_TYPE_BC1,
+    BC_FORMAT_TYPE_BC2,
+    BC_FORMAT_TYPE_BC3,
+    BC_FORMAT_TYPE_BC4,
+    BC_FORMAT_TYPE_BC5,
+    BC_FORMAT_TYPE_BC7
+};
+
+BC_FORMAT_TYPE GetBCFormatType(TEXTURE_FORMAT Format)
+{
+    switch (Format)
+    {
+        case TEX_FORMAT_BC1_UNORM:
+        case TEX_FORMAT_BC1_UNORM_SRGB:
+            return BC_FORMAT_TYPE_BC1;
+
+        case TEX_FORMAT_BC2_UNORM:
+        case TEX_FORMAT_BC2_UNORM_SRGB:
+            return BC_FORMAT_TYPE_BC2;
+
+        case TEX_FORMAT_BC3_UNORM:
+        case TEX_FORMAT_BC3_UNORM_SRGB:
+            return BC_FORMAT_TYPE_BC3;
+
+        case TEX_FORMAT_BC4_UNORM:
+            return BC_FORMAT_TYPE_BC4;
+
+        case TEX_FORMAT_BC5_UNORM:
+            return BC_FORMAT_TYPE_BC5;
+
+        case TEX_FORMAT_BC7_UNORM:
+        case TEX_FORMAT_BC7_UNORM_SRGB:
+            return BC_FORMAT_TYPE_BC7;
+
+        default:
+            return BC_FORMAT_TYPE_UNKNOWN;
+    }
+}
+
+// Returns the uncompressed format that the block-compressed format is decoded to
+TEXTURE_FORMAT GetDecodedFormat(TEXTURE_FORMAT Format)
+{
+    switch (Format)
+    {
+        case TEX_FORMAT_BC1_UNORM_SRGB:
+        case TEX_FORMAT_BC2_UNORM_SRGB:
+        case TEX_FORMAT_BC3_UNORM_SRGB:
+        case TEX_FORMAT_BC7_UNORM_SRGB:
+            return TEX_FORMAT_RGBA8_UNORM_SRGB;
+
+        default:
+            return TEX_FORMAT_RGBA8_UNORM;
+    }
+}
+
+void EncodeBlock(BC_FORMAT_TYPE Type, const TexelSet& Block, BLOCK_COMPRESSION_QUALITY Quality, Uint8* pDst)
+{
+    switch (Type)
+    {
+        case BC_FORMAT_TYPE_BC1:
+            EncodeBC1ColorBlock(Block, /*AllowTransparent = */ true, Quality, pDst);
+            break;
+
+        case BC_FORMAT_TYPE_BC2:
+            EncodeBC2AlphaBlock(Block, pDst);
+            EncodeBC1ColorBlock(Block, /*AllowTransparent = */ false, Quality, pDst + 8);
+            break;
+
+        case BC_FORMAT_TYPE_BC3:
+            EncodeBC4Block(Block, 3, Quality, pDst);
+            EncodeBC1ColorBlock(Block, /*AllowTransparent = */ false, Quality, pDst + 8);
+            break;
+
+        case BC_FORMAT_TYPE_BC4:
+            EncodeBC4Block(Block, 0, Quality, pDst);
+            break;
+
+        case BC_FORMAT_TYPE_BC5:
+            EncodeBC4Block(Block, 0, Quality, pDst);
+            EncodeBC4Block(Block, 1, Quality, pDst + 8);
+            break;
+
+        case BC_FORMAT_TYPE_BC7:
+            EncodeBC7Block(Block, Quality, pDst);
+            break;
+
+        default:
+            UNEXPECTED("Unexpected block-compressed format type");
+    }
+}
+
+void DecodeBlock(BC_FORMAT_TYPE Type, const Uint8* pSrc, Uint8 Texels[][4])
+{
+    switch (Type)
+    {
+        case BC_FORMAT_TYPE_BC1:
+            DecodeBC1ColorBlock(pSrc, /*ForceFourColors = */ false, Texels);
+            break;
+
+        case BC_FORMAT_TYPE_BC2:
+            DecodeBC1ColorBlock(pSrc + 8, /*ForceFourColors = */ true, Texels);
+            DecodeBC2AlphaBlock(pSrc, Texels);
+            break;
+
+        case BC_FORMAT_TYPE_BC3:
+            DecodeBC1ColorBlock(pSrc + 8, /*ForceFourColors = */ true, Texels);
+            DecodeBC4Block(pSrc, Texels, 3);
+            break;
+
+        case BC_FORMAT_TYPE_BC4:
+        case BC_FORMAT_TYPE_BC5:
+            for (Uint32 i = 0; i < NumBlockTexels; ++i)
+            {
+                Texels[i][1] = Texels[i][2] = 0;
+                Texels[i][3]                = 255;
+            }
+            DecodeBC4Block(pSrc, Texels, 0);
+            if (Type == BC_FORMAT_TYPE_BC5)
+                DecodeBC4Block(pSrc + 8, Texels, 1);
+            break;
+
+        case BC_FORMAT_TYPE_BC7:
+            DecodeBC7Block(pSrc, Texels);
+            break;
+
+        default:
+            UNEXPECTED("Unexpected block-compressed format type");
+    }
+}
+
+// Splits block rows between threads and runs Worker(StartRow, EndRow) for every range
+template <typename WorkerType>
+void ProcessBlockRows(Uint32 NumBlockRows, Uint32 NumThreads, const WorkerType& Worker)
+{
+    if (NumThreads == 0)
+        NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const Uint32 NumRanges = std::max(std::min(NumThreads, NumBlockRows), 1u);
+
+    ParallelFor(NumRanges, NumRanges, [&](Uint32 Range) {
+        Worker(NumBlockRows * Range / NumRanges, NumBlockRows * (Range + 1) / NumRanges);
+    });
+}
+
+// Logs an error if the format is not supported and returns false
+bool VerifyBCFormat(TEXTURE_FORMAT Format)
+{
+    if (GetBCFormatType(Format) != BC_FORMAT_TYPE_UNKNOWN)
+        return true;
+
+    if (Format == TEX_FORMAT_BC6H_UF16 || Format == TEX_FORMAT_BC6H_SF16 || Format == TEX_FORMAT_BC6H_TYPELESS)
+    {
+        LOG_ERROR_MESSAGE(GetTextureFormatAttribs(Format).Name, " is not supported: BC6H stores HDR half-precision data, "
+                                                                "while CPU block compression only handles 8-bit data");
+    }
+    else
+    {
+        LOG_ERROR_MESSAGE(GetTextureFormatAttribs(Format).Name, " is not a supported block-compressed format");
+    }
+    return false;
+}
+
+} // namespace
+
+Bool IsBlockCompressionSupported(TEXTURE_FORMAT Format)
+{
+    return GetBCFormatType(Format) != BC_FORMAT_TYPE_UNKNOWN;
+}
+
+void CompressTexture(const CompressTextureAttribs& Attribs)
+{
+    if (!VerifyBCFormat(Attribs.DstFormat))
+        return;
+
+    const auto Type = GetBCFormatType(Attribs.DstFormat);
+
+    const auto DecodedFormat = GetDecodedFormat(Attribs.DstFormat);
+    if (!IsTextureFormatConversionSupported(Attribs.SrcFormat, DecodedFormat))
+    {
+        LOG_ERROR_MESSAGE("Source format ", GetTextureFormatAttribs(Attribs.SrcFormat).Name, " can't be converted to ",
+                          GetTextureFormatAttribs(DecodedFormat).Name);
+        return;
+    }
+    if (Attribs.Width == 0 || Attribs.Height == 0)
+        return;
+
+    DEV_CHECK_ERR(Attribs.Src.pData != nullptr, "Source data must not be null");
+    DEV_CHECK_ERR(Attribs.pDstData != nullptr, "Destination data must not be null");
+
+    const Uint32 BlockBytes   = GetTextureFormatAttribs(Attribs.DstFormat).ComponentSize;
+    const Uint32 NumBlocksX   = (Attribs.Width + 3) / 4;
+    const Uint32 NumBlocksY   = (Attribs.Height + 3) / 4;
+    const Uint32 PaddedWidth  = NumBlocksX * 4;
+    const auto   Quality      = Attribs.Quality;
+    const auto*  pSrcData     = static_cast<const Uint8*>(Attribs.Src.pData);
+    auto*        pDstData     = static_cast<Uint8*>(Attribs.pDstData);
+    const size_t MinSrcStride = size_t{Attribs.Width} * GetTextureFormatAttribs(Attribs.SrcFormat).GetElementSize();
+    const size_t SrcRowStride = Attribs.Src.Stride;
+    const size_t DstRowStride = Attribs.DstStride;
+    DEV_CHECK_ERR(SrcRowStride >= MinSrcStride || Attribs.Height == 1, "Source stride is too small");
+    DEV_CHECK_ERR(DstRowStride >= size_t{NumBlocksX} * BlockBytes || NumBlocksY == 1, "Destination stride is too small");
+
+    ProcessBlockRows(NumBlocksY, Attribs.NumThreads, [&](Uint32 StartRow, Uint32 EndRow) {
+        // Four rows of texels converted to 8-bit RGBA
+        std::vector<Uint8> Strip(size_t{PaddedWidth} * 4 * 4);
+
+        TextureDataConversionAttribs ConvAttribs;
+        ConvAttribs.Width     = Attribs.Width;
+        ConvAttribs.Height    = 1;
+        ConvAttribs.SrcFormat = Attribs.SrcFormat;
+        ConvAttribs.SrcStride = MinSrcStride;
+        ConvAttribs.DstFormat = DecodedFormat;
+        ConvAttribs.DstStride = size_t{PaddedWidth} * 4;
+
+        for (Uint32 by = StartRow; by < EndRow; ++by)
+        {
+            for (Uint32 y = 0; y < 4; ++y)
+            {
+                // Replicate the last row
+                const Uint32 SrcRow = std::min(by * 4 + y, Attribs.Height - 1);
+                auto*        pRow   = &Strip[size_t{PaddedWidth} * 4 * y];
+
+                ConvAttribs.pSrcData = pSrcData + SrcRow * SrcRowStride;
+                ConvAttribs.pDstData = pRow;
+                ConvertTextureData(ConvAttribs);
+
+                // Replicate the last column
+                for (Uint32 x = Attribs.Width; x < PaddedWidth; ++x)
+                    memcpy(pRow + x * 4, pRow + (Attribs.Width - 1) * 4, 4);
+            }
+
+            auto* pDstRow = pDstData + by * DstRowStride;
+            for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+            {
+                TexelSet Block;
+                for (Uint32 y = 0; y < 4; ++y)
+                {
+                    const auto* pTexels = &Strip[(size_t{PaddedWidth} * y + bx * 4) * 4];
+                    for (Uint32 x = 0; x < 4; ++x)
+                    {
+                        for (Uint32 c = 0; c < 4; ++c)
+                            Block.Ch[c][y * 4 + x] = pTexels[x * 4 + c];
+                        Block.Pos[y * 4 + x] = static_cast<Uint8>(y * 4 + x);
+                    }
+                }
+                Block.NumTexels = NumBlockTexels;
+                EncodeBlock(Type, Block, Quality, pDstRow + bx * BlockBytes);
+            }
+        }
+    });
+}
+
+void DecompressTexture(const DecompressTextureAttribs& Attribs)
+{
+    if (!VerifyBCFormat(Attribs.SrcFormat))
+        return;
+
+    const auto Type = GetBCFormatType(Attribs.SrcFormat);
+
+    const auto DecodedFormat = GetDecodedFormat(Attribs.SrcFormat);
+    if (!IsTextureFormatConversionSupported(DecodedFormat, Attribs.DstFormat))
+    {
+        LOG_ERROR_MESSAGE(GetTextureFormatAttribs(DecodedFormat).Name, " can't be converted to destination format ",
+                          GetTextureFormatAttribs(Attribs.DstFormat).Name);
+        return;
+    }
+    if (Attribs.Width == 0 || Attribs.Height == 0)
+        return;
+
+    DEV_CHECK_ERR(Attribs.Src.pData != nullptr, "Source data must not be null");
+    DEV_CHECK_ERR(Attribs.pDstData != nullptr, "Destination data must not be null");
+
+    const Uint32 BlockBytes   = GetTextureFormatAttribs(Attribs.SrcFormat).ComponentSize;
+    const Uint32 NumBlocksX   = (Attribs.Width + 3) / 4;
+    const Uint32 NumBlocksY   = (Attribs.Height + 3) / 4;
+    const Uint32 PaddedWidth  = NumBlocksX * 4;
+    const auto*  pSrcData     = static_cast<const Uint8*>(Attribs.Src.pData);
+    auto*        pDstData     = static_cast<Uint8*>(Attribs.pDstData);
+    const size_t SrcRowStride = Attribs.Src.Stride;
+    const size_t DstRowStride = Attribs.DstStride;
+    DEV_CHECK_ERR(SrcRowStride >= size_t{NumBlocksX} * BlockBytes || NumBlocksY == 1, "Source stride is too small");
+    DEV_CHECK_ERR(DstRowStride >= size_t{Attribs.Width} * GetTextureFormatAttribs(Attribs.DstFormat).GetElementSize() || Attribs.Height == 1,
+                  "Destination stride is too small");
+
+    ProcessBlockRows(NumBlocksY, Attribs.NumThreads, [&](Uint32 StartRow, Uint32 EndRow) {
+        std::vector<Uint8> Strip(size_t{PaddedWidth} * 4 * 4);
+
+        TextureDataConversionAttribs ConvAttribs;
+        ConvAttribs.Width     = Attribs.Width;
+        ConvAttribs.SrcFormat = DecodedFormat;
+        ConvAttribs.pSrcData  = Strip.data();
+        ConvAttribs.SrcStride = size_t{PaddedWidth} * 4;
+        ConvAttribs.DstFormat = Attribs.DstFormat;
+        ConvAttribs.DstStride = DstRowStride;
+
+        for (Uint32 by = StartRow; by < EndRow; ++by)
+        {
+            const auto* pSrcRow = pSrcData + by * SrcRowStride;
+            for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+            {
+                Uint8 Texels[NumBlockTexels][4];
+                DecodeBlock(Type, pSrcRow + bx * BlockBytes, Texels);
+                for (Uint32 y = 0; y < 4; ++y)
+                    memcpy(&Strip[(size_t{PaddedWidth} * y + bx * 4) * 4], Texels[y * 4], 16);
+            }
+
+            ConvAttribs.Height   = std::min(Attribs.Height - by * 4, 4u);
+            ConvAttribs.pDstData = pDstData + by * 4 * DstRowStride;
+            ConvertTextureData(ConvAttribs);
+        }
+    });
+}
+
+} // namespace Diligent
+
+extern "C"
+{
+    Diligent::Bool Diligent_IsBlockCompressionSupported(Diligent::TEXTURE_FORMAT Format)
+    {
+        return Diligent::IsBlockCompressionSupported(Format);
+    }
+
+    void Diligent_CompressTexture(const Diligent::CompressTextureAttribs& Attribs)
+    {
+        Diligent::CompressTexture(Attribs);
+    }
+
+    void Diligent_DecompressTexture(const Diligent::DecompressTextureAttribs& Attribs)
+    {
+        Diligent::DecompressTexture(Attribs);
+    }
+}
@@ -27,7 +27,9 @@
 
 #pragma once
 
-#include <list>
+#include <memory>
+#include <cstring>
+#include <ostream>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -38,6 +40,7 @@
 #include "HLSLKeywords.h"
 #include "Shader.h"
 #include "HashUtils.hpp"
+#include "FlatHashMap.hpp"
 #include "HLSLKeywords.h"
 #include "Constants.h"
 
@@ -214,7 +217,7 @@ private:
     // Hash map that maps GLSL object, method and number of arguments
     // passed to the original function, to the GLSL stub function
     // Example: {"sampler2D", "Sample", 2} -> {"Sample_2", "_SWIZZLE"}
-    std::unordered_map<FunctionStubHashKey, GLSLStubInfo, FunctionStubHashKey::Hasher> m_GLSLStubs;
+    FlatHashMap<FunctionStubHashKey, GLSLStubInfo, FunctionStubHashKey::Hasher> m_GLSLStubs;
 
     // clang-format off
     enum class TokenType
@@ -248,11 +251,173 @@ private:
     };
     // clang-format on
 
+    // Token string. A string initially references null-terminated data in the token buffer
+    // of the conversion stream and only allocates its own storage when it is modified.
+    // As a result, copying unmodified tokens never allocates memory.
+    class TokenString
+    {
+    public:
+        TokenString() noexcept {}
+
+        TokenString(const Char* Str) :
+            m_pView{nullptr},
+            m_pStorage{new String{Str}}
+        {}
+
+        TokenString(const TokenString& Str) :
+            m_pView{Str.m_pView},
+            m_ViewLength{Str.m_ViewLength},
+            m_pStorage{Str.m_pStorage ? new String{*Str.m_pStorage} : nullptr}
+        {}
+
+        TokenString(TokenString&& Str) noexcept :
+            m_pView{Str.m_pView},
+            m_ViewLength{Str.m_ViewLength},
+            m_pStorage{std::move(Str.m_pStorage)}
+        {
+            // Leave the source as a valid empty string rather than a null view without storage
+            Str.clear();
+        }
+
+        TokenString& operator=(const TokenString& Str)
+        {
+            if (this != &Str)
+            {
+                m_pView      = Str.m_pView;
+                m_ViewLength = Str.m_ViewLength;
+                m_pStorage.reset(Str.m_pStorage ? new String{*Str.m_pStorage} : nullptr);
+            }
+            return *this;
+        }
+
+        TokenString& operator=(TokenString&& Str) noexcept
+        {
+            if (this != &Str)
+            {
+                m_pView      = Str.m_pView;
+                m_ViewLength = Str.m_ViewLength;
+                m_pStorage   = std::move(Str.m_pStorage);
+                Str.clear();
+            }
+            return *this;
+        }
+
+        // Creates a string that references Length characters starting at pData.
+        // The data must be followed by a null terminator and must outlive the string.
+        static TokenString MakeView(const Char* pData, size_t Length)
+        {
+            VERIFY(pData[Length] == '\0', "Token string data must be null-terminated");
+            TokenString Str;
+            Str.m_pView      = pData;
+            Str.m_ViewLength = Length;
+            return Str;
+        }
+
+        // clang-format off
+        const Char* c_str()  const { return m_pView != nullptr ? m_pView : m_pStorage->c_str(); }
+        size_t      length() const { return m_pView != nullptr ? m_ViewLength : m_pStorage->length(); }
+        bool        empty()  const { return length() == 0; }
+        const Char* begin()  const { return c_str(); }
+        const Char* end()    const { return c_str() + length(); }
+        // clang-format on
+
+        Char operator[](size_t i) const
+        {
+            VERIFY_EXPR(i < length());
+            return c_str()[i];
+        }
+
+        Char back() const
+        {
+            VERIFY_EXPR(!empty());
+            return c_str()[length() - 1];
+        }
+
+        String str() const { return String{c_str(), length()}; }
+
+        TokenString& operator=(const Char* Str)
+        {
+            ResetStorage().assign(Str);
+            return *this;
+        }
+
+        TokenString& operator=(const String& Str)
+        {
+            ResetStorage().assign(Str);
+            return *this;
+        }
+
+        // clang-format off
+        void push_back(Char c)              { GetStorage().push_back(c); }
+        void pop_back()                     { GetStorage().pop_back();   }
+        void append(const Char* Str)        { GetStorage().append(Str);  }
+        void append(const String& Str)      { GetStorage().append(Str);  }
+        void append(const TokenString& Str) { GetStorage().append(Str.c_str(), Str.length()); }
+        // clang-format on
+
+        void clear()
+        {
+            m_pView      = "";
+            m_ViewLength = 0;
+            m_pStorage.reset();
+        }
+
+        bool operator==(const TokenString& Str) const
+        {
+            const auto Len = length();
+            return Len == Str.length() && memcmp(c_str(), Str.c_str(), Len) == 0;
+        }
+        bool operator==(const String& Str) const
+        {
+            return Str.compare(0, String::npos, c_str(), length()) == 0;
+        }
+        bool operator==(const Char* Str) const
+        {
+            return strcmp(c_str(), Str) == 0;
+        }
+        template <typename T>
+        bool operator!=(const T& Str) const
+        {
+            return !(*this == Str);
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const TokenString& Str)
+        {
+            return os.write(Str.c_str(), Str.length());
+        }
+
+    private:
+        String& ResetStorage()
+        {
+            m_pView = nullptr;
+            if (!m_pStorage)
+                m_pStorage.reset(new String);
+            return *m_pStorage;
+        }
+
+        String& GetStorage()
+        {
+            if (m_pView != nullptr)
+            {
+                m_pStorage.reset(new String{m_pView, m_ViewLength});
+                m_pView = nullptr;
+            }
+            return *m_pStorage;
+        }
+
+        // Null-terminated string data, or null if the string owns its storage
+        const Char* m_pView      = "";
+        size_t      m_ViewLength = 0;
+
+        // The string's own storage that is allocated when the string is modified
+        std::unique_ptr<String> m_pStorage;
+    };
+
     struct TokenInfo
     {
-        TokenType Type;
-        String    Literal;
-        String    Delimiter;
+        TokenType   Type;
+        TokenString Literal;
+        TokenString Delimiter;
 
         bool IsBuiltInType() const
         {
@@ -269,14 +434,130 @@ private:
         }
 
         TokenInfo(TokenType   _Type      = TokenType::Undefined,
-                  const Char* _Literal   = "",
-                  const Char* _Delimiter = "") :
+                  TokenString _Literal   = {},
+                  TokenString _Delimiter = {}) :
             Type{_Type},
-            Literal{_Literal},
-            Delimiter{_Delimiter}
+            Literal{std::move(_Literal)},
+            Delimiter{std::move(_Delimiter)}
         {}
     };
-    typedef std::list<TokenInfo> TokenListType;
+
+    // Doubly-linked list of tokens. Nodes are allocated from an arena of fixed-size pages
+    // and are linked by indices rather than pointers. Nodes never move in memory, so, as with
+    // std::list, iterators and references to tokens stay valid when other tokens are inserted
+    // or erased. Unlike std::list iterators, iterators reference the list object itself and
+    // are invalidated when the list is swapped or moved; references to tokens stay valid.
+    // Erased nodes are unlinked, but their memory is only released with the list.
+    // Since links are indices, the whole list is copied page by page without relinking.
+    class TokenList
+    {
+        struct Node
+        {
+            TokenInfo Token;
+            Uint32    Prev = 0;
+            Uint32    Next = 0;
+        };
+
+    public:
+        class iterator
+        {
+        public:
+            iterator() noexcept {}
+
+            // clang-format off
+            TokenInfo& operator* () const { return m_pNode->Token; }
+            TokenInfo* operator->() const { return &m_pNode->Token; }
+
+            bool operator==(const iterator& rhs) const { return m_pNode == rhs.m_pNode; }
+            bool operator!=(const iterator& rhs) const { return m_pNode != rhs.m_pNode; }
+            // clang-format on
+
+            iterator& operator++()
+            {
+                m_Idx   = m_pNode->Next;
+                m_pNode = &m_pList->GetNode(m_Idx);
+                return *this;
+            }
+            iterator& operator--()
+            {
+                m_Idx   = m_pNode->Prev;
+                m_pNode = &m_pList->GetNode(m_Idx);
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                auto Tmp = *this;
+                ++(*this);
+                return Tmp;
+            }
+            iterator operator--(int)
+            {
+                auto Tmp = *this;
+                --(*this);
+                return Tmp;
+            }
+
+        private:
+            friend class TokenList;
+            iterator(TokenList* pList, Uint32 Idx) :
+                m_pList{pList},
+                m_Idx{Idx},
+                m_pNode{&pList->GetNode(Idx)}
+            {}
+
+            TokenList* m_pList = nullptr;
+            Uint32     m_Idx   = 0;
+            Node*      m_pNode = nullptr;
+        };
+
+        TokenList();
+        TokenList(const TokenList& rhs);
+        TokenList(TokenList&& rhs) noexcept;
+        TokenList& operator=(const TokenList& rhs);
+        TokenList& operator=(TokenList&& rhs) noexcept;
+
+        // Node 0 is the sentinel that serves as both the head and the tail of the list
+        iterator begin() { return iterator{this, GetNode(0).Next}; }
+        iterator end() { return iterator{this, 0}; }
+
+        TokenInfo& back()
+        {
+            VERIFY_EXPR(m_Size > 0);
+            return GetNode(GetNode(0).Prev).Token;
+        }
+
+        size_t size() const { return m_Size; }
+
+        iterator insert(const iterator& Pos, TokenInfo Token);
+        void     push_back(TokenInfo Token) { insert(end(), std::move(Token)); }
+
+        iterator erase(const iterator& Pos);
+        iterator erase(const iterator& First, const iterator& Last);
+
+        void swap(TokenList& rhs) noexcept;
+
+        // Returns the iterator that refers to the same token in this list as the iterator
+        // It refers to in the list this list was copied from.
+        iterator GetCopyIterator(const iterator& It) { return iterator{this, It.m_Idx}; }
+
+    private:
+        static constexpr Uint32 PageSizeLog2 = 8;
+        static constexpr Uint32 PageSize     = 1u << PageSizeLog2;
+
+        Node& GetNode(Uint32 Idx)
+        {
+            VERIFY_EXPR(Idx < m_NumNodes);
+            return m_Pages[Idx >> PageSizeLog2][Idx & (PageSize - 1)];
+        }
+
+        std::vector<std::unique_ptr<Node[]>> m_Pages;
+
+        // Total number of nodes allocated in the arena, including the sentinel and erased nodes
+        Uint32 m_NumNodes = 0;
+        // Number of tokens in the list
+        size_t m_Size = 0;
+    };
+    typedef TokenList TokenListType;
 
 
     class ConversionStream : public ObjectBase<IHLSL2GLSLConversionStream>
@@ -320,17 +601,52 @@ private:
                                                 bool        UseInOutLocationQualifiers,
                                                 IDataBlob** ppGLSLSource) override final;
 
+        /// Converts multiple entry points, see IHLSL2GLSLConversionStream::ConvertEntryPoints().
+
+        /// \return Converted GLSL source for every entry point. The string is empty
+        ///         if the entry point failed to convert.
+        std::vector<String> ConvertEntryPoints(const HLSL2GLSLEntryPoint* pEntryPoints,
+                                               Uint32                     NumEntryPoints,
+                                               bool                       IncludeDefintions,
+                                               const char*                SamplerSuffix,
+                                               bool                       UseInOutLocationQualifiers,
+                                               Uint32                     NumThreads);
+
+        virtual void DILIGENT_CALL_TYPE ConvertEntryPoints(const HLSL2GLSLEntryPoint* pEntryPoints,
+                                                           Uint32                     NumEntryPoints,
+                                                           bool                       IncludeDefintions,
+                                                           const char*                SamplerSuffix,
+                                                           bool                       UseInOutLocationQualifiers,
+                                                           Uint32                     NumThreads,
+                                                           IDataBlob**                ppGLSLSources) override final;
+
         IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_HLSL2GLSLConversionStream, TBase)
 
         const String& GetInputFileName() const { return m_InputFileName; }
 
     private:
+        /// Creates a stream that converts a single entry point from the tokens of Stream
+        /// after the entry point-independent code has been processed by ProcessSharedCode().
+        /// Unmodified token strings of the new stream reference the memory of Stream, so
+        /// Stream must outlive it and must not be modified while it exists.
+        ConversionStream(IReferenceCounters* pRefCounters, const ConversionStream& Stream);
+
+        // Processes the code that does not depend on the entry point: constant and structured buffers,
+        // structs, textures, samplers and object methods. Returns the declaration token of each entry
+        // point, or end() if the entry point has not been found.
+        std::vector<TokenListType::iterator> ProcessSharedCode(const HLSL2GLSLEntryPoint* pEntryPoints,
+                                                               Uint32                     NumEntryPoints,
+                                                               const char*                SamplerSuffix);
+
+        // Processes the declaration of the entry point found by ProcessSharedCode() and builds the GLSL source
+        String ConvertEntryPoint(TokenListType::iterator EntryPointToken, const HLSL2GLSLEntryPoint& EntryPoint);
+
         void InsertIncludes(String& GLSLSource, IShaderSourceInputStreamFactory* pSourceStreamFactory);
         void Tokenize(const String& Source);
 
         typedef std::unordered_map<String, bool> SamplerHashType;
 
-        const HLSLObjectInfo* FindHLSLObject(const String& Name);
+        const HLSLObjectInfo* FindHLSLObject(const TokenString& Name);
 
         void ProcessShaderDeclaration(TokenListType::iterator EntryPointToken, SHADER_TYPE ShaderType);
 
@@ -513,6 +829,10 @@ private:
         // Tokenized source code
         TokenListType m_Tokens;
 
+        // Null-terminated literals and delimiters of all tokens produced by the tokenizer.
+        // Token strings reference this buffer until they are modified.
+        std::vector<Char> m_TokenData;
+
         // List of tokens defining structs
         std::unordered_map<HashMapStringKey, TokenListType::iterator, HashMapStringKey::Hasher> m_StructDefinitions;
 
@@ -536,7 +856,7 @@ private:
 
     // HLSL keyword->token info hash map
     // Example: "Texture2D" -> TokenInfo(TokenType::Texture2D, "Texture2D")
-    std::unordered_map<HashMapStringKey, TokenInfo, HashMapStringKey::Hasher> m_HLSLKeywords;
+    FlatHashMap<HashMapStringKey, TokenInfo, HashMapStringKey::Hasher, HashMapStringKey::Equal> m_HLSLKeywords;
 
     // Set of all GLSL image types (image1D, uimage1D, iimage1D, image2D, ... )
     std::unordered_set<HashMapStringKey, HashMapStringKey::Hasher> m_ImageTypes;
@@ -551,7 +871,7 @@ private:
     static constexpr int OutVar          = 1;
     static constexpr int MaxShaderStages = 6; // Maximum supported shader stages: VS, GS, PS, DS, HS, CS
 
-    std::array<std::array<std::unordered_map<HashMapStringKey, String, HashMapStringKey::Hasher>, 2>, MaxShaderStages> m_HLSLSemanticToGLSLVar;
+    std::array<std::array<FlatHashMap<HashMapStringKey, String, HashMapStringKey::Hasher, HashMapStringKey::Equal>, 2>, MaxShaderStages> m_HLSLSemanticToGLSLVar;
 };
 
 } // namespace Diligent
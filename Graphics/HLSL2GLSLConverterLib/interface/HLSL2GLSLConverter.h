@@ -40,6 +40,32 @@ static const INTERFACE_ID IID_HLSL2GLSLConversionStream =
     {0x1fde020a, 0x9c73, 0x4a76, {0x8a, 0xef, 0xc2, 0xc6, 0xc2, 0xcf, 0xe, 0xa5}};
 
 
+// clang-format off
+
+/// Shader entry point description used by IHLSL2GLSLConversionStream::ConvertEntryPoints().
+struct HLSL2GLSLEntryPoint
+{
+    /// Entry point name.
+    const Char* Name       DEFAULT_INITIALIZER(nullptr);
+
+    /// Shader type. See Diligent::SHADER_TYPE.
+    SHADER_TYPE ShaderType DEFAULT_INITIALIZER(SHADER_TYPE_UNKNOWN);
+
+#if DILIGENT_CPP_INTERFACE
+    HLSL2GLSLEntryPoint() noexcept
+    {}
+    HLSL2GLSLEntryPoint(const Char* _Name,
+                        SHADER_TYPE _ShaderType) noexcept :
+        Name      {_Name      },
+        ShaderType{_ShaderType}
+    {}
+#endif
+};
+typedef struct HLSL2GLSLEntryPoint HLSL2GLSLEntryPoint;
+
+// clang-format on
+
+
 #define DILIGENT_INTERFACE_NAME IHLSL2GLSLConversionStream
 #include "../../../Primitives/interface/DefineInterfaceHelperMacros.h"
 
@@ -58,6 +84,31 @@ DILIGENT_BEGIN_INTERFACE(IHLSL2GLSLConversionStream, IObject)
                                  const char* SamplerSuffix,
                                  bool        UseInOutLocationQualifiers,
                                  IDataBlob** ppGLSLSource) PURE;
+
+    /// Converts multiple entry points of the stream's source in one call.
+
+    /// \param [in]  pEntryPoints     - Array of NumEntryPoints entry points to convert.
+    /// \param [in]  NumEntryPoints   - The number of entry points.
+    /// \param [in]  IncludeDefintions, SamplerSuffix, UseInOutLocationQualifiers - Same as in Convert().
+    /// \param [in]  NumThreads       - The number of threads, including the calling thread, that
+    ///                                 process the entry points. If zero, the number of hardware
+    ///                                 threads is used.
+    /// \param [out] ppGLSLSources    - Array of NumEntryPoints pointers where the converted sources
+    ///                                 will be written. If an entry point fails to convert, the
+    ///                                 corresponding pointer is set to null.
+    ///
+    /// \remarks   Declarations that do not depend on the entry point (constant and structured buffers,
+    ///            textures and samplers, structures, object methods) are processed only once and
+    ///            shared by all entry points. The result for every entry point is identical to that
+    ///            of a separate Convert() call.
+    VIRTUAL void METHOD(ConvertEntryPoints)(THIS_
+                                            const HLSL2GLSLEntryPoint* pEntryPoints,
+                                            Uint32                     NumEntryPoints,
+                                            bool                       IncludeDefintions,
+                                            const char*                SamplerSuffix,
+                                            bool                       UseInOutLocationQualifiers,
+                                            Uint32                     NumThreads,
+                                            IDataBlob**                ppGLSLSources) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -67,7 +118,8 @@ DILIGENT_END_INTERFACE
 
 // clang-format off
 
-#    define IHLSL2GLSLConversionStream_Convert(This, ...) CALL_IFACE_METHOD(HLSL2GLSLConversionStream, Convert, This, __VA_ARGS__)
+#    define IHLSL2GLSLConversionStream_Convert(This, ...)            CALL_IFACE_METHOD(HLSL2GLSLConversionStream, Convert,            This, __VA_ARGS__)
+#    define IHLSL2GLSLConversionStream_ConvertEntryPoints(This, ...) CALL_IFACE_METHOD(HLSL2GLSLConversionStream, ConvertEntryPoints, This, __VA_ARGS__)
 
 // clang-format on
 
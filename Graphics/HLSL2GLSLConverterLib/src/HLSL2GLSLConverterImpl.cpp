@@ -363,6 +363,7 @@
 #include "StringDataBlobImpl.hpp"
 #include "StringTools.hpp"
 #include "EngineMemory.h"
+#include "ThreadPool.hpp"
 
 using namespace std;
 
@@ -768,7 +769,8 @@ HLSL2GLSLConverterImpl::HLSL2GLSLConverterImpl()
 #undef DEFINE_VARIABLE
 }
 
-String CompressNewLines(const String& Str)
+template <typename StrType>
+String CompressNewLines(const StrType& Str)
 {
     String Out;
     auto   Char = Str.begin();
@@ -794,7 +796,8 @@ String CompressNewLines(const String& Str)
     return Out;
 }
 
-static Int32 CountNewLines(const String& Str)
+template <typename StrType>
+static Int32 CountNewLines(const StrType& Str)
 {
     Int32 NumNewLines = 0;
     auto  Char        = Str.begin();
@@ -873,7 +876,7 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
     for (; Token != CurrLineStartToken; ++Token)
     {
         Ctx.append(CompressNewLines(Token->Delimiter));
-        Ctx.append(Token->Literal);
+        Ctx.append(Token->Literal.c_str(), Token->Literal.length());
     }
 
     //\n  if ( x != 0 )
@@ -905,7 +908,7 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
             Spaces.append(Token->Literal.length(), ' ');
 
         Ctx.append(CompressNewLines(Token->Delimiter));
-        Ctx.append(Token->Literal);
+        Ctx.append(Token->Literal.c_str(), Token->Literal.length());
         ++Token;
 
         if (Token == m_Tokens.end())
@@ -923,7 +926,7 @@ String HLSL2GLSLConverterImpl::ConversionStream::PrintTokenContext(IteratorType&
     while (Token != m_Tokens.end() && NumLinesBelow <= NumAdjacentLines)
     {
         Ctx.append(CompressNewLines(Token->Delimiter));
-        Ctx.append(Token->Literal);
+        Ctx.append(Token->Literal.c_str(), Token->Literal.length());
         ++Token;
 
         if (Token == m_Tokens.end())
@@ -1075,42 +1078,143 @@ void HLSL2GLSLConverterImpl::ConversionStream::InsertIncludes(String& GLSLSource
 }
 
 
-void ReadNumericConstant(const String& Source, String::const_iterator& Pos, String& Output)
+void SkipNumericConstant(const String& Source, String::const_iterator& Pos)
 {
-#define COPY_SYMBOL()                    \
+#define SKIP_SYMBOL()                    \
     {                                    \
-        Output.push_back(*(Pos++));      \
+        ++Pos;                           \
         if (Pos == Source.end()) return; \
     }
 
     while (Pos != Source.end() && *Pos >= '0' && *Pos <= '9')
-        COPY_SYMBOL()
+        SKIP_SYMBOL()
 
     if (*Pos == '.')
     {
-        COPY_SYMBOL()
-        // Copy all numbers
+        SKIP_SYMBOL()
+        // Skip all numbers
         while (Pos != Source.end() && *Pos >= '0' && *Pos <= '9')
-            COPY_SYMBOL()
+            SKIP_SYMBOL()
     }
 
     // Scientific notation
     // e+1242, E-234
     if (*Pos == 'e' || *Pos == 'E')
     {
-        COPY_SYMBOL()
+        SKIP_SYMBOL()
 
         if (*Pos == '+' || *Pos == '-')
-            COPY_SYMBOL()
+            SKIP_SYMBOL()
 
         // Skip all numbers
         while (Pos != Source.end() && *Pos >= '0' && *Pos <= '9')
-            COPY_SYMBOL()
+            SKIP_SYMBOL()
     }
 
     if (*Pos == 'f' || *Pos == 'F')
-        COPY_SYMBOL()
-#undef COPY_SYMBOL
+        SKIP_SYMBOL()
+#undef SKIP_SYMBOL
+}
+
+
+HLSL2GLSLConverterImpl::TokenList::TokenList() :
+    m_NumNodes{1}
+{
+    // Allocate the first page with the sentinel node
+    m_Pages.emplace_back(new Node[PageSize]);
+}
+
+HLSL2GLSLConverterImpl::TokenList::TokenList(const TokenList& rhs) :
+    m_NumNodes{rhs.m_NumNodes},
+    m_Size{rhs.m_Size}
+{
+    m_Pages.reserve(rhs.m_Pages.size());
+    for (const auto& SrcPage : rhs.m_Pages)
+    {
+        const auto FirstIdx     = static_cast<Uint32>(m_Pages.size()) << PageSizeLog2;
+        const auto NumPageNodes = std::min(m_NumNodes - FirstIdx, Uint32{PageSize});
+        m_Pages.emplace_back(new Node[PageSize]);
+        std::copy(SrcPage.get(), SrcPage.get() + NumPageNodes, m_Pages.back().get());
+    }
+}
+
+HLSL2GLSLConverterImpl::TokenList::TokenList(TokenList&& rhs) noexcept :
+    m_Pages{std::move(rhs.m_Pages)},
+    m_NumNodes{rhs.m_NumNodes},
+    m_Size{rhs.m_Size}
+{
+    rhs.m_NumNodes = 0;
+    rhs.m_Size     = 0;
+}
+
+HLSL2GLSLConverterImpl::TokenList& HLSL2GLSLConverterImpl::TokenList::operator=(const TokenList& rhs)
+{
+    if (this != &rhs)
+    {
+        TokenList Copy{rhs};
+        swap(Copy);
+    }
+    return *this;
+}
+
+HLSL2GLSLConverterImpl::TokenList& HLSL2GLSLConverterImpl::TokenList::operator=(TokenList&& rhs) noexcept
+{
+    swap(rhs);
+    return *this;
+}
+
+void HLSL2GLSLConverterImpl::TokenList::swap(TokenList& rhs) noexcept
+{
+    std::swap(m_Pages, rhs.m_Pages);
+    std::swap(m_NumNodes, rhs.m_NumNodes);
+    std::swap(m_Size, rhs.m_Size);
+}
+
+HLSL2GLSLConverterImpl::TokenList::iterator HLSL2GLSLConverterImpl::TokenList::insert(const iterator& Pos, TokenInfo Token)
+{
+    VERIFY_EXPR(Pos.m_pList == this);
+    if ((m_NumNodes & (PageSize - 1)) == 0)
+        m_Pages.emplace_back(new Node[PageSize]);
+
+    const auto NewIdx = m_NumNodes++;
+    auto&      NewNode{GetNode(NewIdx)};
+    NewNode.Token = std::move(Token);
+
+    // Prev <-> NewNode <-> Pos
+    const auto PrevIdx = Pos.m_pNode->Prev;
+    NewNode.Prev       = PrevIdx;
+    NewNode.Next       = Pos.m_Idx;
+
+    GetNode(PrevIdx).Next = NewIdx;
+    Pos.m_pNode->Prev     = NewIdx;
+    ++m_Size;
+
+    return iterator{this, NewIdx};
+}
+
+HLSL2GLSLConverterImpl::TokenList::iterator HLSL2GLSLConverterImpl::TokenList::erase(const iterator& Pos)
+{
+    VERIFY_EXPR(Pos.m_pList == this);
+    VERIFY(Pos.m_Idx != 0, "Attempting to erase the end of the list");
+    VERIFY_EXPR(m_Size > 0);
+
+    // Prev <-> Pos <-> Next
+    const auto PrevIdx = Pos.m_pNode->Prev;
+    const auto NextIdx = Pos.m_pNode->Next;
+
+    GetNode(PrevIdx).Next = NextIdx;
+    GetNode(NextIdx).Prev = PrevIdx;
+    --m_Size;
+
+    return iterator{this, NextIdx};
+}
+
+HLSL2GLSLConverterImpl::TokenList::iterator HLSL2GLSLConverterImpl::TokenList::erase(const iterator& First, const iterator& Last)
+{
+    auto It = First;
+    while (It != Last)
+        It = erase(It);
+    return It;
 }
 
 
@@ -1131,6 +1235,33 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
     int OpenBraceCount   = 0;
     int OpenStapleCount  = 0;
 
+    // Token literals and delimiters are copied to the token data buffer, each followed by
+    // a null terminator. Every token takes at least one source symbol and adds at most two
+    // terminators, so the buffer never grows and the token strings may reference its data.
+    m_TokenData.clear();
+    m_TokenData.reserve(Source.length() * 3 + 1);
+
+    const auto AddTokenString = [&](String::const_iterator Start, String::const_iterator End) {
+        const auto Length = static_cast<size_t>(End - Start);
+        VERIFY(m_TokenData.size() + Length + 1 <= m_TokenData.capacity(), "Token data buffer must never be reallocated");
+        const auto* pData = m_TokenData.data() + m_TokenData.size();
+        m_TokenData.insert(m_TokenData.end(), Start, End);
+        m_TokenData.push_back('\0');
+        return TokenString::MakeView(pData, Length);
+    };
+
+    // Appends the symbol to the literal of the last token, which is always
+    // the last string in the token data buffer since the new token has no delimiter.
+    const auto AppendToLastToken = [&](TokenType Type, Char Symbol) {
+        auto& LastToken = m_Tokens.back();
+        VERIFY_EXPR(LastToken.Literal.end() + 1 == m_TokenData.data() + m_TokenData.size());
+        VERIFY(m_TokenData.size() + 1 <= m_TokenData.capacity(), "Token data buffer must never be reallocated");
+        m_TokenData.back() = Symbol;
+        m_TokenData.push_back('\0');
+        LastToken.Type    = Type;
+        LastToken.Literal = TokenString::MakeView(LastToken.Literal.c_str(), LastToken.Literal.length() + 1);
+    };
+
     // Push empty node in the beginning of the list to facilitate
     // backwards searching
     m_Tokens.push_back(TokenInfo());
@@ -1147,94 +1278,83 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
         TokenInfo NewToken;
         auto      DelimStart = SrcPos;
         SkipDelimetersAndComments(Source, SrcPos);
-        if (DelimStart != SrcPos)
-        {
-            auto DelimSize = SrcPos - DelimStart;
-            NewToken.Delimiter.reserve(DelimSize);
-            NewToken.Delimiter.append(DelimStart, SrcPos);
-        }
         if (SrcPos == Source.end())
             break;
+        if (DelimStart != SrcPos)
+            NewToken.Delimiter = AddTokenString(DelimStart, SrcPos);
 
+        auto LiteralStart = SrcPos;
         switch (*SrcPos)
         {
             case '#':
             {
-                NewToken.Type       = TokenType::PreprocessorDirective;
-                auto DirectiveStart = SrcPos;
+                NewToken.Type = TokenType::PreprocessorDirective;
                 ++SrcPos;
                 SkipDelimetersAndComments(Source, SrcPos);
                 CHECK_END("Missing preprocessor directive");
                 SkipIdentifier(Source, SrcPos);
-                auto DirectiveSize = SrcPos - DirectiveStart;
-                NewToken.Literal.reserve(DirectiveSize);
-                NewToken.Literal.append(DirectiveStart, SrcPos);
             }
             break;
 
             case ';':
                 NewToken.Type = TokenType::Semicolon;
-                NewToken.Literal.push_back(*(SrcPos++));
+                ++SrcPos;
                 break;
 
             case '=':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "")
+                if (m_Tokens.size() > 0 && NewToken.Delimiter.empty())
                 {
-                    auto& LastToken = m_Tokens.back();
+                    const auto& LastLiteral = m_Tokens.back().Literal;
                     // +=, -=, *=, /=, %=, <<=, >>=, &=, |=, ^=
-                    if (LastToken.Literal == "+" ||
-                        LastToken.Literal == "-" ||
-                        LastToken.Literal == "*" ||
-                        LastToken.Literal == "/" ||
-                        LastToken.Literal == "%" ||
-                        LastToken.Literal == "<<" ||
-                        LastToken.Literal == ">>" ||
-                        LastToken.Literal == "&" ||
-                        LastToken.Literal == "|" ||
-                        LastToken.Literal == "^")
+                    if (LastLiteral == "+" ||
+                        LastLiteral == "-" ||
+                        LastLiteral == "*" ||
+                        LastLiteral == "/" ||
+                        LastLiteral == "%" ||
+                        LastLiteral == "<<" ||
+                        LastLiteral == ">>" ||
+                        LastLiteral == "&" ||
+                        LastLiteral == "|" ||
+                        LastLiteral == "^")
                     {
-                        LastToken.Type = TokenType::Assignment;
-                        LastToken.Literal.push_back(*(SrcPos++));
+                        AppendToLastToken(TokenType::Assignment, *(SrcPos++));
                         continue;
                     }
-                    else if (LastToken.Literal == "<" ||
-                             LastToken.Literal == ">" ||
-                             LastToken.Literal == "=" ||
-                             LastToken.Literal == "!")
+                    else if (LastLiteral == "<" ||
+                             LastLiteral == ">" ||
+                             LastLiteral == "=" ||
+                             LastLiteral == "!")
                     {
-                        LastToken.Type = TokenType::ComparisonOp;
-                        LastToken.Literal.push_back(*(SrcPos++));
+                        AppendToLastToken(TokenType::ComparisonOp, *(SrcPos++));
                         continue;
                     }
                 }
 
                 NewToken.Type = TokenType::Assignment;
-                NewToken.Literal.push_back(*(SrcPos++));
+                ++SrcPos;
                 break;
 
             case '|':
             case '&':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "" &&
+                if (m_Tokens.size() > 0 && NewToken.Delimiter.empty() &&
                     m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
                 {
-                    m_Tokens.back().Type = TokenType::BooleanOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    AppendToLastToken(TokenType::BooleanOp, *(SrcPos++));
                     continue;
                 }
                 else
                 {
                     NewToken.Type = TokenType::BitwiseOp;
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    ++SrcPos;
                 }
                 break;
 
             case '<':
             case '>':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "" &&
+                if (m_Tokens.size() > 0 && NewToken.Delimiter.empty() &&
                     m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
                 {
-                    m_Tokens.back().Type = TokenType::BitwiseOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    AppendToLastToken(TokenType::BitwiseOp, *(SrcPos++));
                     continue;
                 }
                 else
@@ -1243,72 +1363,75 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     // and template arguments like in Texture2D<float> at this
                     // point. This will be clarified when textures are processed.
                     NewToken.Type = TokenType::ComparisonOp;
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    ++SrcPos;
                 }
                 break;
 
             case '+':
             case '-':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "" &&
+                if (m_Tokens.size() > 0 && NewToken.Delimiter.empty() &&
                     m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
                 {
-                    m_Tokens.back().Type = TokenType::IncDecOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    AppendToLastToken(TokenType::IncDecOp, *(SrcPos++));
                     continue;
                 }
                 else
                 {
                     // We do not currently distinguish between math operator a + b,
                     // unary operator -a and numerical constant -1:
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    ++SrcPos;
                 }
                 break;
 
             case '~':
             case '^':
                 NewToken.Type = TokenType::BitwiseOp;
-                NewToken.Literal.push_back(*(SrcPos++));
+                ++SrcPos;
                 break;
 
             case '*':
             case '/':
             case '%':
                 NewToken.Type = TokenType::MathOp;
-                NewToken.Literal.push_back(*(SrcPos++));
+                ++SrcPos;
                 break;
 
             case '!':
                 NewToken.Type = TokenType::BooleanOp;
-                NewToken.Literal.push_back(*(SrcPos++));
+                ++SrcPos;
                 break;
 
             case ',':
                 NewToken.Type = TokenType::Comma;
-                NewToken.Literal.push_back(*(SrcPos++));
+                ++SrcPos;
                 break;
 
             case '"':
+            {
                 //[domain("quad")]
                 //        ^
                 NewToken.Type = TokenType::SrtingConstant;
                 ++SrcPos;
                 //[domain("quad")]
                 //         ^
+                auto StringStart = SrcPos;
                 while (SrcPos != Source.end() && *SrcPos != '"')
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    ++SrcPos;
                 //[domain("quad")]
                 //             ^
+                NewToken.Literal = AddTokenString(StringStart, SrcPos);
                 if (SrcPos != Source.end())
                     ++SrcPos;
                 //[domain("quad")]
                 //              ^
                 break;
+            }
 
-#define BRACKET_CASE(Symbol, TokenType, Action)  \
-    case Symbol:                                 \
-        NewToken.Type = TokenType;               \
-        NewToken.Literal.push_back(*(SrcPos++)); \
-        Action;                                  \
+#define BRACKET_CASE(Symbol, TokenType, Action) \
+    case Symbol:                                \
+        NewToken.Type = TokenType;              \
+        ++SrcPos;                               \
+        Action;                                 \
         break;
 
                 BRACKET_CASE('(', TokenType::OpenBracket, ++OpenBracketCount);
@@ -1323,14 +1446,11 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
 
             default:
             {
-                auto IdentifierStartPos = SrcPos;
                 SkipIdentifier(Source, SrcPos);
-                if (IdentifierStartPos != SrcPos)
+                if (LiteralStart != SrcPos)
                 {
-                    auto IDSize = SrcPos - IdentifierStartPos;
-                    NewToken.Literal.reserve(IDSize);
-                    NewToken.Literal.append(IdentifierStartPos, SrcPos);
-                    auto KeywordIt = m_Converter.m_HLSLKeywords.find(NewToken.Literal.c_str());
+                    NewToken.Literal = AddTokenString(LiteralStart, SrcPos);
+                    auto KeywordIt   = m_Converter.m_HLSLKeywords.find(NewToken.Literal.c_str());
                     if (KeywordIt != m_Converter.m_HLSLKeywords.end())
                     {
                         NewToken.Type = KeywordIt->second.Type;
@@ -1352,21 +1472,25 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     }
                     if (bIsNumericalCostant)
                     {
-                        ReadNumericConstant(Source, SrcPos, NewToken.Literal);
+                        SkipNumericConstant(Source, SrcPos);
                         NewToken.Type = TokenType::NumericConstant;
                     }
                 }
 
                 if (NewToken.Type == TokenType::Undefined)
                 {
-                    NewToken.Literal.push_back(*(SrcPos++));
+                    ++SrcPos;
                 }
                 // Operators
                 // https://msdn.microsoft.com/en-us/library/windows/desktop/bb509631(v=vs.85).aspx
             }
         }
 
-        m_Tokens.push_back(NewToken);
+        // String constants and identifiers have already been added
+        if (NewToken.Type != TokenType::SrtingConstant && NewToken.Literal.empty())
+            NewToken.Literal = AddTokenString(LiteralStart, SrcPos);
+
+        m_Tokens.push_back(std::move(NewToken));
     }
 #undef CHECK_END
 }
@@ -1605,7 +1729,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessStructuredBuffer(TokenList
     //                                 ^
     ++Token;
     String NameRedefine("#define ");
-    NameRedefine += GlobalVarNameToken->Literal + ' ' + GlobalVarNameToken->Literal + "_data\r\n";
+    NameRedefine += GlobalVarNameToken->Literal.str() + ' ' + GlobalVarNameToken->Literal.str() + "_data\r\n";
     m_Tokens.insert(Token, TokenInfo(TokenType::TextBlock, NameRedefine.c_str(), "\r\n"));
     GlobalVarNameToken->Literal.append("_data");
     // buffer g_Data{DataType g_Data_data[]};
@@ -1728,7 +1852,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseSamplers(TokenListType::iter
                 const auto& SamplerName = Token->Literal;
 
                 // Add sampler state into the hash map
-                SamplersHash.insert(std::make_pair(SamplerName, bIsComparison));
+                SamplersHash.insert(std::make_pair(SamplerName.str(), bIsComparison));
 
                 ++Token;
                 // SamplerState LinearClamp ;
@@ -1966,13 +2090,13 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
         {
             // RWTexture2D<float /* format = r32f */ >
             //                                       ^
-            ParseImageFormat(Token->Delimiter, ImgFormat);
+            ParseImageFormat(Token->Delimiter.str(), ImgFormat);
             if (ImgFormat.length() == 0)
             {
                 // RWTexture2D</* format = r32f */ float >
                 //                                 ^
                 //                            TexFmtToken
-                ParseImageFormat(TexFmtToken->Delimiter, ImgFormat);
+                ParseImageFormat(TexFmtToken->Delimiter.str(), ImgFormat);
             }
 
             if (ImgFormat.length() != 0)
@@ -2078,7 +2202,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
         if (!IsRWTexture)
         {
             // Try to find matching sampler
-            auto SamplerName = TextureName + SamplerSuffix;
+            auto SamplerName = TextureName.str() + SamplerSuffix;
             // Search all scopes starting with the innermost
             for (auto ScopeIt = Samplers.rbegin(); ScopeIt != Samplers.rend(); ++ScopeIt)
             {
@@ -2112,7 +2236,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
                 TexDeclToken->Literal.append("IMAGE_WRITEONLY "); // defined as 'writeonly' on GLES and as '' on desktop in GLSLDefinitions.h
         }
         TexDeclToken->Literal.append(CompleteGLSLSampler);
-        Objects.m.insert(std::make_pair(HashMapStringKey(TextureName), HLSLObjectInfo{std::move(CompleteGLSLSampler), NumComponents, ArrayDim}));
+        Objects.m.insert(std::make_pair(HashMapStringKey{TextureName.c_str(), true}, HLSLObjectInfo{std::move(CompleteGLSLSampler), NumComponents, ArrayDim}));
 
         // In global scope, multiple variables can be declared in the same statement
         if (IsGlobalScope)
@@ -2185,7 +2309,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
 
 
 // Finds an HLSL object with the given name in object stack
-const HLSL2GLSLConverterImpl::HLSLObjectInfo* HLSL2GLSLConverterImpl::ConversionStream::FindHLSLObject(const String& Name)
+const HLSL2GLSLConverterImpl::HLSLObjectInfo* HLSL2GLSLConverterImpl::ConversionStream::FindHLSLObject(const TokenString& Name)
 {
     for (auto ScopeIt = m_Objects.rbegin(); ScopeIt != m_Objects.rend(); ++ScopeIt)
     {
@@ -2322,7 +2446,7 @@ bool HLSL2GLSLConverterImpl::ConversionStream::ProcessObjectMethod(TokenListType
     // ^
     // IdentifierToken
 
-    m_Tokens.insert(IdentifierToken, TokenInfo(TokenType::Identifier, StubIt->second.Name.c_str(), IdentifierToken->Delimiter.c_str()));
+    m_Tokens.insert(IdentifierToken, TokenInfo(TokenType::Identifier, StubIt->second.Name.c_str(), IdentifierToken->Delimiter));
     IdentifierToken->Delimiter = " ";
     // FunctionStub TestTextArr[2], TestTextArr_sampler, ...
     //              ^
@@ -2547,7 +2671,7 @@ bool HLSL2GLSLConverterImpl::ConversionStream::ProcessRWTextureStore(TokenListTy
     // ^                                              ^
     // Token                                    SemicolonToken
 
-    m_Tokens.insert(Token, TokenInfo(TokenType::Identifier, "imageStore", Token->Delimiter.c_str()));
+    m_Tokens.insert(Token, TokenInfo(TokenType::Identifier, "imageStore", Token->Delimiter));
     m_Tokens.insert(Token, TokenInfo(TokenType::OpenBracket, "(", ""));
     Token->Delimiter = " ";
     // imageStore( RWTex[Location.xy] = float4(0.0, 0.0, 0.0, 1.0);
@@ -2653,7 +2777,7 @@ bool HLSL2GLSLConverterImpl::ConversionStream::ProcessRWTextureLoad(TokenListTyp
     //           ^           ^
     //  OpenStaplePos     ClosingStaplePos
 
-    m_Tokens.insert(Token, TokenInfo(TokenType::Identifier, "imageLoad", Token->Delimiter.c_str()));
+    m_Tokens.insert(Token, TokenInfo(TokenType::Identifier, "imageLoad", Token->Delimiter));
     m_Tokens.insert(Token, TokenInfo(TokenType::OpenBracket, "(", ""));
     Token->Delimiter = " ";
     // imageLoad( RWTex[Location.xy]
@@ -2854,14 +2978,14 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseShaderParameter(TokenListTyp
     VERIFY_PARSER_STATE(Token, Token->IsBuiltInType() || Token->Type == TokenType::Identifier,
                         "Missing argument type");
     auto TypeToken = Token;
-    ParamInfo.Type = Token->Literal;
+    ParamInfo.Type = Token->Literal.str();
 
     ++Token;
     //          out float4 Color : SV_Target,
     //                     ^
     VERIFY_PARSER_STATE(Token, Token != m_Tokens.end(), "Unexpected EOF while parsing argument list");
     VERIFY_PARSER_STATE(Token, Token->Type == TokenType::Identifier, "Missing argument name after ", ParamInfo.Type);
-    ParamInfo.Name = Token->Literal;
+    ParamInfo.Name = Token->Literal.str();
 
     ++Token;
     VERIFY_PARSER_STATE(Token, Token != m_Tokens.end(), "Unexpected EOF");
@@ -2873,8 +2997,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseShaderParameter(TokenListTyp
         ProcessScope(
             Token, m_Tokens.end(), TokenType::OpenStaple, TokenType::ClosingStaple,
             [&](TokenListType::iterator& tkn, int) {
-                ParamInfo.ArraySize.append(tkn->Delimiter);
-                ParamInfo.ArraySize.append(tkn->Literal);
+                ParamInfo.ArraySize.append(tkn->Delimiter.c_str(), tkn->Delimiter.length());
+                ParamInfo.ArraySize.append(tkn->Literal.c_str(), tkn->Literal.length());
                 ++tkn;
             } //
         );
@@ -2902,7 +3026,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ParseShaderParameter(TokenListTyp
             VERIFY_PARSER_STATE(Token, Token != m_Tokens.end(), "Unexpected end of file while looking for semantic for argument \"", ParamInfo.Name, '\"');
             VERIFY_PARSER_STATE(Token, Token->Type == TokenType::Identifier, "Missing semantic for argument \"", ParamInfo.Name, '\"');
             // Transform to lower case -  semantics are case-insensitive
-            ParamInfo.Semantic = StrToLower(Token->Literal);
+            ParamInfo.Semantic = StrToLower(Token->Literal.str());
 
             ++Token;
             //          out float4 Color : SV_Target,
@@ -2966,8 +3090,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessFunctionParameters(TokenLi
     if (!bIsVoid)
     {
         ShaderParameterInfo RetParam;
-        RetParam.Type             = TypeToken->Literal;
-        RetParam.Name             = FuncNameToken->Literal;
+        RetParam.Type             = TypeToken->Literal.str();
+        RetParam.Name             = FuncNameToken->Literal.str();
         RetParam.storageQualifier = ShaderParameterInfo::StorageQualifier::Ret;
         Params.push_back(RetParam);
     }
@@ -3141,7 +3265,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessFunctionParameters(TokenLi
                     //                                   ^
                     VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Type == TokenType::NumericConstant, "Numeric constant expected");
 
-                    ParamInfo.ArraySize     = TmpToken->Literal;
+                    ParamInfo.ArraySize     = TmpToken->Literal.str();
                     auto NumCtrlPointsToken = TmpToken;
                     ++TmpToken;
                     VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Literal == ">", "Angle bracket expected");
@@ -3191,7 +3315,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessFunctionParameters(TokenLi
             VERIFY_PARSER_STATE(SemanticToken, SemanticToken != m_Tokens.end(), "Unexpected EOF");
             VERIFY_PARSER_STATE(SemanticToken, SemanticToken->Type == TokenType::Identifier, "Exepcted semantic for the return argument ");
             // Transform to lower case -  semantics are case-insensitive
-            RetParam.Semantic = StrToLower(SemanticToken->Literal);
+            RetParam.Semantic = StrToLower(SemanticToken->Literal.str());
             ++SemanticToken;
             // float4 TestPS  ( in VSOutput In ) : SV_Target
             // {
@@ -3874,7 +3998,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessHullShaderConstantFunction
         }
     }
     ReturnHandlerSS << "return;}\n";
-    m_Tokens.insert(TypeToken, TokenInfo(TokenType::TextBlock, ReturnHandlerSS.str().c_str(), TypeToken->Delimiter.c_str()));
+    m_Tokens.insert(TypeToken, TokenInfo(TokenType::TextBlock, ReturnHandlerSS.str().c_str(), TypeToken->Delimiter));
     TypeToken->Delimiter = "\n";
 
     String Prologue = PrologueSS.str();
@@ -3924,8 +4048,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessShaderAttributes(TokenList
         VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Type == TokenType::Identifier, "Identifier expected");
         // [domain("quad")]
         //  ^
-        auto& Attrib = TmpToken->Literal;
-        StrToLowerInPlace(Attrib);
+        auto Attrib = StrToLower(TmpToken->Literal.str());
 
         ++TmpToken;
         VERIFY_PARSER_STATE(TmpToken, TmpToken != m_Tokens.end() && TmpToken->Type == TokenType::OpenBracket, "\'(\' expected");
@@ -3934,8 +4057,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessShaderAttributes(TokenList
             TmpToken, m_Tokens.end(), TokenType::OpenBracket, TokenType::ClosingBracket,
             [&](TokenListType::iterator& tkn, int) //
             {
-                AttribValue.append(tkn->Delimiter);
-                AttribValue.append(tkn->Literal);
+                AttribValue.append(tkn->Delimiter.c_str(), tkn->Delimiter.length());
+                AttribValue.append(tkn->Literal.c_str(), tkn->Literal.length());
                 ++tkn;
             } //
         );
@@ -4241,7 +4364,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessDomainShaderArguments(Toke
     // ^
 
     std::unordered_map<HashMapStringKey, String, HashMapStringKey::Hasher> Attributes;
-    ParseAttributesInComment(TypeToken->Delimiter, Attributes);
+    ParseAttributesInComment(TypeToken->Delimiter.str(), Attributes);
     ProcessShaderAttributes(Token, Attributes);
 
     stringstream GlobalsSS;
@@ -4459,7 +4582,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessReturnStatements(TokenList
     if (IsVoid)
     {
         // Insert return handler before the closing brace
-        m_Tokens.insert(Token, TokenInfo(TokenType::TextBlock, MacroName, Token->Delimiter.c_str()));
+        m_Tokens.insert(Token, TokenInfo(TokenType::TextBlock, MacroName, Token->Delimiter));
         Token->Delimiter = "\n";
         // void main ()
         // {
@@ -4578,7 +4701,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessShaderDeclaration(TokenLis
     // TypeToken
 
     // Insert global variables & return handler before the function
-    m_Tokens.insert(TypeToken, TokenInfo(TokenType::TextBlock, GlobalVariables.c_str(), TypeToken->Delimiter.c_str()));
+    m_Tokens.insert(TypeToken, TokenInfo(TokenType::TextBlock, GlobalVariables.c_str(), TypeToken->Delimiter));
     m_Tokens.insert(TypeToken, TokenInfo(TokenType::TextBlock, ReturnHandlerSS.str().c_str(), "\n"));
     TypeToken->Delimiter = "\n";
     auto BodyStartToken  = ArgsListEndToken;
@@ -4781,7 +4904,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::RemoveSpecialShaderAttributes()
                 // void CS(uint3 ThreadId  : SV_DispatchThreadID)
                 // ^
                 if (Token != m_Tokens.end())
-                    Token->Delimiter = OpenStaple->Delimiter + Token->Delimiter;
+                    Token->Delimiter = OpenStaple->Delimiter.str() + Token->Delimiter.str();
                 m_Tokens.erase(OpenStaple, Token);
             }
             else
@@ -4795,8 +4918,8 @@ String HLSL2GLSLConverterImpl::ConversionStream::BuildGLSLSource()
     String Output;
     for (const auto& Token : m_Tokens)
     {
-        Output.append(Token.Delimiter);
-        Output.append(Token.Literal);
+        Output.append(Token.Delimiter.c_str(), Token.Delimiter.length());
+        Output.append(Token.Literal.c_str(), Token.Literal.length());
     }
     return Output;
 }
@@ -4842,6 +4965,21 @@ HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters*
     Tokenize(Source);
 }
 
+HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters* pRefCounters, const ConversionStream& Stream) :
+    // clang-format off
+    TBase                        {pRefCounters                          },
+    m_Tokens                     {Stream.m_Tokens                       },
+    m_bPreserveTokens            {false                                 },
+    m_bUseInOutLocationQualifiers{Stream.m_bUseInOutLocationQualifiers },
+    m_Converter                  {Stream.m_Converter                    },
+    m_InputFileName              {Stream.m_InputFileName                }
+// clang-format on
+{
+    // The copy of the token list keeps node indices, so struct definitions can be remapped directly
+    for (const auto& StructDef : Stream.m_StructDefinitions)
+        m_StructDefinitions.emplace(StructDef.first.GetStr(), m_Tokens.GetCopyIterator(StructDef.second));
+}
+
 
 String HLSL2GLSLConverterImpl::Convert(ConversionAttribs& Attribs) const
 {
@@ -4919,15 +5057,10 @@ void HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
     }
 }
 
-String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
-                                                         SHADER_TYPE ShaderType,
-                                                         bool        IncludeDefintions,
-                                                         const char* SamplerSuffix,
-                                                         bool        UseInOutLocationQualifiers)
+std::vector<HLSL2GLSLConverterImpl::TokenListType::iterator> HLSL2GLSLConverterImpl::ConversionStream::ProcessSharedCode(const HLSL2GLSLEntryPoint* pEntryPoints,
+                                                                                                                         Uint32                     NumEntryPoints,
+                                                                                                                         const char*                SamplerSuffix)
 {
-    m_bUseInOutLocationQualifiers = UseInOutLocationQualifiers;
-    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType());
-
     Uint32 ShaderStorageBlockBinding = 0;
     Uint32 ImageBinding              = 0;
 
@@ -4978,8 +5111,8 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
         }
     }
 
-    auto ShaderEntryPointToken = m_Tokens.end();
-    // Process textures and search for the shader entry point.
+    std::vector<TokenListType::iterator> EntryPointTokens(NumEntryPoints, m_Tokens.end());
+    // Process textures and search for the shader entry points.
     // GLSL does not allow local variables of sampler type, so the
     // only two scopes where textures can be declared are global scope
     // and a function argument list.
@@ -5024,8 +5157,11 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
                 if ((ReturnTypeToken->IsBuiltInType() || ReturnTypeToken->Type == TokenType::Identifier) &&
                     OpenParenToken->Type == TokenType::OpenBracket)
                 {
-                    if (Token->Literal == EntryPoint)
-                        ShaderEntryPointToken = Token;
+                    for (Uint32 i = 0; i < NumEntryPoints; ++i)
+                    {
+                        if (Token->Literal == pEntryPoints[i].Name)
+                            EntryPointTokens[i] = Token;
+                    }
 
                     Token = OpenParenToken;
                     // float4 Func ( in float2 f2UV,
@@ -5147,15 +5283,36 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
                 ++Token;
         }
     }
-    VERIFY_PARSER_STATE(ShaderEntryPointToken, ShaderEntryPointToken != m_Tokens.end(), "Unable to find shader entry point \"", EntryPoint, '\"');
 
-    ProcessShaderDeclaration(ShaderEntryPointToken, ShaderType);
+    return EntryPointTokens;
+}
+
+String HLSL2GLSLConverterImpl::ConversionStream::ConvertEntryPoint(TokenListType::iterator EntryPointToken, const HLSL2GLSLEntryPoint& EntryPoint)
+{
+    VERIFY_PARSER_STATE(EntryPointToken, EntryPointToken != m_Tokens.end(), "Unable to find shader entry point \"", EntryPoint.Name, '\"');
+
+    ProcessShaderDeclaration(EntryPointToken, EntryPoint.ShaderType);
 
     RemoveSemantics();
 
     RemoveSpecialShaderAttributes();
 
-    auto GLSLSource = BuildGLSLSource();
+    return BuildGLSLSource();
+}
+
+String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
+                                                         SHADER_TYPE ShaderType,
+                                                         bool        IncludeDefintions,
+                                                         const char* SamplerSuffix,
+                                                         bool        UseInOutLocationQualifiers)
+{
+    m_bUseInOutLocationQualifiers = UseInOutLocationQualifiers;
+    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType());
+
+    const HLSL2GLSLEntryPoint EntryPointInfo{EntryPoint, ShaderType};
+
+    auto ShaderEntryPointToken = ProcessSharedCode(&EntryPointInfo, 1, SamplerSuffix)[0];
+    auto GLSLSource            = ConvertEntryPoint(ShaderEntryPointToken, EntryPointInfo);
 
     if (m_bPreserveTokens)
     {
@@ -5170,4 +5327,77 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
     return GLSLSource;
 }
 
+std::vector<String> HLSL2GLSLConverterImpl::ConversionStream::ConvertEntryPoints(const HLSL2GLSLEntryPoint* pEntryPoints,
+                                                                                 Uint32                     NumEntryPoints,
+                                                                                 bool                       IncludeDefintions,
+                                                                                 const char*                SamplerSuffix,
+                                                                                 bool                       UseInOutLocationQualifiers,
+                                                                                 Uint32                     NumThreads)
+{
+    m_bUseInOutLocationQualifiers = UseInOutLocationQualifiers;
+    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType());
+
+    const auto EntryPointTokens = ProcessSharedCode(pEntryPoints, NumEntryPoints, SamplerSuffix);
+
+    std::vector<String> GLSLSources(NumEntryPoints);
+    // Every entry point is converted by a separate stream that starts from a copy of the processed
+    // tokens. The tokens of this stream are only read until all entry points are converted.
+    ParallelFor(NumThreads, NumEntryPoints, [&](Uint32 i) {
+        try
+        {
+            ConversionStream EntryPointStream{nullptr, *this};
+            GLSLSources[i] = EntryPointStream.ConvertEntryPoint(EntryPointStream.m_Tokens.GetCopyIterator(EntryPointTokens[i]), pEntryPoints[i]);
+            if (IncludeDefintions)
+                GLSLSources[i].insert(0, g_GLSLDefinitions);
+        }
+        catch (...)
+        {
+            // A failed entry point must not stop the conversion of the others
+            GLSLSources[i].clear();
+        }
+    });
+
+    if (m_bPreserveTokens)
+    {
+        m_Tokens.swap(TokensCopy);
+        m_StructDefinitions.clear();
+        m_Objects.clear();
+    }
+
+    return GLSLSources;
+}
+
+void HLSL2GLSLConverterImpl::ConversionStream::ConvertEntryPoints(const HLSL2GLSLEntryPoint* pEntryPoints,
+                                                                  Uint32                     NumEntryPoints,
+                                                                  bool                       IncludeDefintions,
+                                                                  const char*                SamplerSuffix,
+                                                                  bool                       UseInOutLocationQualifiers,
+                                                                  Uint32                     NumThreads,
+                                                                  IDataBlob**                ppGLSLSources)
+{
+    DEV_CHECK_ERR(NumEntryPoints == 0 || (pEntryPoints != nullptr && ppGLSLSources != nullptr), "Entry points and output sources must not be null");
+    for (Uint32 i = 0; i < NumEntryPoints; ++i)
+    {
+        DEV_CHECK_ERR(ppGLSLSources[i] == nullptr, "Overwriting reference to an existing object may result in memory leaks");
+        ppGLSLSources[i] = nullptr;
+    }
+
+    try
+    {
+        auto GLSLSources = ConvertEntryPoints(pEntryPoints, NumEntryPoints, IncludeDefintions, SamplerSuffix, UseInOutLocationQualifiers, NumThreads);
+        for (Uint32 i = 0; i < NumEntryPoints; ++i)
+        {
+            if (GLSLSources[i].empty())
+                continue;
+
+            StringDataBlobImpl* pDataBlob = MakeNewRCObj<StringDataBlobImpl>()(std::move(GLSLSources[i]));
+            pDataBlob->QueryInterface(IID_DataBlob, reinterpret_cast<IObject**>(ppGLSLSources + i));
+        }
+    }
+    catch (std::runtime_error&)
+    {
+        // The error has already been logged; all sources remain null
+    }
+}
+
 } // namespace Diligent
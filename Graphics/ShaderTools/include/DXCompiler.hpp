@@ -45,6 +45,8 @@ struct ID3D12ShaderReflection;
 namespace Diligent
 {
 
+class ShaderBytecodeCache;
+
 enum class DXCompilerTarget
 {
     Direct3D12, // compiles to DXIL
@@ -86,6 +88,12 @@ public:
                          std::vector<uint32_t>*  pByteCode,
                          IDataBlob**             ppCompilerOutput) noexcept(false) = 0;
 
+    /// Sets the bytecode cache that is used by Compile(ShaderCI, ...).
+
+    /// The cache key is computed from the preprocessed source, so a cache hit skips
+    /// compilation and validation. The cache must outlive the compiler or be reset to null.
+    virtual void SetBytecodeCache(ShaderBytecodeCache* pCache) = 0;
+
 
     using BindInfo            = ResourceBinding::BindInfo;
     using TResourceBindingMap = ResourceBinding::TMap;
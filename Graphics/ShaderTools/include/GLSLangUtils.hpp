@@ -30,10 +30,13 @@
 #include <vector>
 #include "Shader.h"
 #include "DataBlob.h"
+#include "RefCntAutoPtr.hpp"
 
 namespace Diligent
 {
 
+class ShaderBytecodeCache;
+
 namespace GLSLangUtils
 {
 
@@ -48,6 +51,23 @@ enum class SpirvVersion
 void InitializeGlslang();
 void FinalizeGlslang();
 
+/// Initializes glslang in the constructor and finalizes it in the destructor.
+/// glslang reference-counts process initialization, so scopes may be nested and
+/// combined with explicit InitializeGlslang()/FinalizeGlslang() calls.
+class GlslangScope
+{
+public:
+    GlslangScope() { InitializeGlslang(); }
+    ~GlslangScope() { FinalizeGlslang(); }
+
+    // clang-format off
+    GlslangScope           (const GlslangScope&)  = delete;
+    GlslangScope           (      GlslangScope&&) = delete;
+    GlslangScope& operator=(const GlslangScope&)  = delete;
+    GlslangScope& operator=(      GlslangScope&&) = delete;
+    // clang-format on
+};
+
 struct GLSLtoSPIRVAttribs
 {
     SHADER_TYPE                      ShaderType                 = SHADER_TYPE_UNKNOWN;
@@ -58,13 +78,58 @@ struct GLSLtoSPIRVAttribs
     SpirvVersion                     Version                    = SpirvVersion::Vk100;
     IDataBlob**                      ppCompilerOutput           = nullptr;
     bool                             AssignBindings             = true;
+
+    /// Optional bytecode cache. If the cache contains the SPIR-V for the preprocessed
+    /// shader source, parsing and compilation are skipped, and the compiler log stored
+    /// with the SPIR-V is written to ppCompilerOutput.
+    ShaderBytecodeCache* pCache = nullptr;
 };
 
 std::vector<unsigned int> GLSLtoSPIRV(const GLSLtoSPIRVAttribs& Attribs);
 
 std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
                                       const char*             ExtraDefinitions,
-                                      IDataBlob**             ppCompilerOutput);
+                                      IDataBlob**             ppCompilerOutput,
+                                      ShaderBytecodeCache*    pCache = nullptr);
+
+
+/// Result of a single shader compilation in a batch.
+struct SPIRVCompileResult
+{
+    /// SPIR-V bytecode. Empty if the shader failed to compile.
+    std::vector<unsigned int> SPIRV;
+
+    /// Compiler output, if any.
+    RefCntAutoPtr<IDataBlob> pCompilerOutput;
+};
+
+/// Compiles a batch of GLSL shaders to SPIR-V on multiple threads.
+
+/// \param [in] pAttribs   - Array of NumShaders compile attributes. The ppCompilerOutput members
+///                          are ignored: the compiler output of every shader is returned in the
+///                          corresponding result.
+/// \param [in] NumShaders - The number of shaders in the batch.
+/// \param [in] NumThreads - The number of threads, including the calling thread, that compile
+///                          the shaders. If 0, the number of hardware threads is used.
+///
+/// \return     Compile results in the same order as the attributes.
+///
+/// \remarks    Every shader is entirely compiled by one thread as glslang keeps its memory
+///             pool in thread-local storage. The function keeps glslang initialized while the
+///             batch is being compiled, so InitializeGlslang() does not need to be called first.
+///             Compilation errors leave the SPIR-V of the shader empty. If compiling a shader
+///             throws an exception (e.g. when the source file is not found), the shaders that
+///             have not been started are skipped and the exception is rethrown.
+std::vector<SPIRVCompileResult> GLSLtoSPIRVBatch(const GLSLtoSPIRVAttribs* pAttribs,
+                                                 size_t                    NumShaders,
+                                                 Uint32                    NumThreads = 0);
+
+/// Compiles a batch of HLSL shaders to SPIR-V on multiple threads, see GLSLtoSPIRVBatch().
+std::vector<SPIRVCompileResult> HLSLtoSPIRVBatch(const ShaderCreateInfo* pShaderCIs,
+                                                 size_t                  NumShaders,
+                                                 const char*             ExtraDefinitions,
+                                                 Uint32                  NumThreads = 0,
+                                                 ShaderBytecodeCache*    pCache     = nullptr);
 
 } // namespace GLSLangUtils
 
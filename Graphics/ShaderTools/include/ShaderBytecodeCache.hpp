@@ -0,0 +1,221 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <list>
+#include <unordered_map>
+
+#include "BasicTypes.h"
+#include "DataBlob.h"
+#include "HashUtils.hpp"
+
+namespace Diligent
+{
+
+/// Persistent content-addressed cache of compiled shader bytecode.
+
+/// The cache maps a 128-bit key to the compiled bytecode and the compiler output log.
+/// The key must be computed by the caller from everything that affects the compiler
+/// output: the fully preprocessed source, the entry point, the compiler and its version,
+/// the target and the compile flags. Since the key does not depend on the source file
+/// names or the way the macros were defined, a cache hit lets the caller skip parsing
+/// and compilation entirely.
+///
+/// Every entry is stored in a separate file in the versioned subdirectory of the cache
+/// directory (e.g. ShaderCache/v1/0123...cdef.bin). The list of entries in the least recently
+/// used order is kept in the index file that is read when the cache is created and is written
+/// by Flush() and when the cache is destroyed. When the total size of the entries exceeds the
+/// limit, least recently used entries are evicted.
+///
+/// All methods are thread-safe.
+class ShaderBytecodeCache
+{
+public:
+    /// Version of the cache file format. Entries created by other versions are ignored.
+    static constexpr Uint32 FormatVersion = 1;
+
+    struct Key
+    {
+        Uint64 Hash[2] = {};
+
+        bool operator==(const Key& rhs) const
+        {
+            return Hash[0] == rhs.Hash[0] && Hash[1] == rhs.Hash[1];
+        }
+        bool operator!=(const Key& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        /// Returns the 32-character hexadecimal representation of the key.
+        String ToString() const;
+
+        struct Hasher
+        {
+            size_t operator()(const Key& CacheKey) const
+            {
+                return static_cast<size_t>(CacheKey.Hash[0]);
+            }
+        };
+    };
+
+    /// Computes the cache key from the data that affects the compiler output.
+
+    /// \code
+    ///     ShaderBytecodeCache::KeyBuilder Builder;
+    ///     Builder.Update("glslang", CompilerVersion, ShaderType, PreprocessedSource);
+    ///     auto CacheKey = Builder.GetKey();
+    /// \endcode
+    class KeyBuilder
+    {
+    public:
+        /// Hashes the values the same way as Hasher64::Update() does.
+        template <typename... ArgsType>
+        KeyBuilder& Update(const ArgsType&... Args)
+        {
+            m_Hasher[0].Update(Args...);
+            m_Hasher[1].Update(Args...);
+            return *this;
+        }
+
+        KeyBuilder& UpdateRaw(const void* pData, size_t Size)
+        {
+            m_Hasher[0].UpdateRaw(pData, Size);
+            m_Hasher[1].UpdateRaw(pData, Size);
+            return *this;
+        }
+
+        Key GetKey() const
+        {
+            Key CacheKey;
+            CacheKey.Hash[0] = m_Hasher[0].Digest();
+            CacheKey.Hash[1] = m_Hasher[1].Digest();
+            return CacheKey;
+        }
+
+    private:
+        Hasher64 m_Hasher[2] = {Hasher64{0x9e3779b97f4a7c15ull}, Hasher64{0xc2b2ae3d27d4eb4full}};
+    };
+
+    struct CreateInfo
+    {
+        /// Cache directory. The directory is created if it does not exist.
+        const Char* Directory = nullptr;
+
+        /// The maximum total size of all cache entries, in bytes.
+        size_t MaxSize = size_t{256} << 20;
+    };
+
+    struct Statistics
+    {
+        Uint32 NumHits      = 0;
+        Uint32 NumMisses    = 0;
+        Uint32 NumStores    = 0;
+        Uint32 NumEvictions = 0;
+
+        /// The number of entries currently in the cache.
+        Uint32 NumEntries = 0;
+
+        /// The total size of all entries currently in the cache, in bytes.
+        size_t TotalSize = 0;
+    };
+
+    explicit ShaderBytecodeCache(const CreateInfo& CI);
+    ~ShaderBytecodeCache();
+
+    // clang-format off
+    ShaderBytecodeCache           (const ShaderBytecodeCache&)  = delete;
+    ShaderBytecodeCache           (      ShaderBytecodeCache&&) = delete;
+    ShaderBytecodeCache& operator=(const ShaderBytecodeCache&)  = delete;
+    ShaderBytecodeCache& operator=(      ShaderBytecodeCache&&) = delete;
+    // clang-format on
+
+    /// Looks up the entry in the cache.
+
+    /// \param [in]  CacheKey         - Entry key.
+    /// \param [out] ppBytecode       - Memory location where the pointer to the bytecode will be written.
+    /// \param [out] ppCompilerOutput - Optional memory location where the pointer to the compiler output
+    ///                                 will be written. Nothing is written if the entry has no compiler output.
+    ///
+    /// \return     true if the entry was found, and false otherwise.
+    bool Load(const Key& CacheKey, IDataBlob** ppBytecode, IDataBlob** ppCompilerOutput = nullptr);
+
+    /// Adds the entry to the cache, evicting least recently used entries if the size limit is exceeded.
+
+    /// \param [in] CacheKey           - Entry key.
+    /// \param [in] pBytecode          - Compiled bytecode.
+    /// \param [in] BytecodeSize       - Bytecode size, in bytes.
+    /// \param [in] pCompilerOutput    - Optional compiler output log.
+    /// \param [in] CompilerOutputSize - Compiler output size, in bytes.
+    void Store(const Key&  CacheKey,
+               const void* pBytecode,
+               size_t      BytecodeSize,
+               const void* pCompilerOutput    = nullptr,
+               size_t      CompilerOutputSize = 0);
+
+    /// Writes the index file.
+    void Flush();
+
+    Statistics GetStatistics() const;
+
+    const String& GetDirectory() const { return m_Directory; }
+
+private:
+    String GetEntryPath(const Key& CacheKey) const;
+    String GetIndexPath() const;
+
+    void ReadIndex();
+
+    // All methods below must be called with m_Mtx locked
+    void AddEntry(const Key& CacheKey, size_t Size);
+    void RemoveEntry(const Key& CacheKey);
+    void EvictEntries(size_t RequiredSize);
+
+    // Versioned cache directory, e.g. ShaderCache/v1
+    String       m_Directory;
+    const size_t m_MaxSize;
+
+    mutable std::mutex m_Mtx;
+
+    struct EntryInfo
+    {
+        size_t Size = 0;
+
+        std::list<Key>::iterator LRUIt;
+    };
+    std::unordered_map<Key, EntryInfo, Key::Hasher> m_Entries;
+
+    // Entry keys, most recently used first
+    std::list<Key> m_LRUList;
+
+    bool       m_IndexDirty = false;
+    Statistics m_Stats;
+};
+
+} // namespace Diligent
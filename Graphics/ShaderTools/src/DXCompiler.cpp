@@ -43,6 +43,7 @@
 #include "DataBlobImpl.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "ShaderToolsCommon.hpp"
+#include "ShaderBytecodeCache.hpp"
 
 #if D3D12_SUPPORTED
 #    include <d3d12shader.h>
@@ -68,6 +69,16 @@ constexpr Uint32 VK_API_VERSION_1_1 = (1u << 22) | (1u << 12);
 constexpr Uint32 VK_API_VERSION_1_2 = (1u << 22) | (2u << 12);
 
 
+// Exposes the compiler output stored in the bytecode cache through the interface
+// expected by HandleHLSLCompilerResult().
+struct CompilerOutputView
+{
+    IDataBlob* const pBlob;
+
+    const void* GetBufferPointer() const { return pBlob->GetDataPtr(); }
+    size_t      GetBufferSize() const { return pBlob->GetSize(); }
+};
+
 class DXCompilerImpl final : public DXCompilerBase
 {
 public:
@@ -109,6 +120,11 @@ public:
                          std::vector<uint32_t>*  pByteCode,
                          IDataBlob**             ppCompilerOutput) noexcept(false) override final;
 
+    virtual void SetBytecodeCache(ShaderBytecodeCache* pCache) override final
+    {
+        m_pBytecodeCache.store(pCache);
+    }
+
     virtual void GetD3D12ShaderReflection(IDxcBlob*                pShaderBytecode,
                                           ID3D12ShaderReflection** ppShaderReflection) override final;
 
@@ -157,6 +173,10 @@ private:
         return m_pCreateInstance;
     }
 
+    bool Preprocess(const CompileAttribs& Attribs, std::string& PreprocessedSource);
+
+    bool CreateBlob(const void* pData, size_t Size, IDxcBlob** ppBlob);
+
     bool ValidateAndSign(DxcCreateInstanceProc CreateInstance, IDxcLibrary* library, CComPtr<IDxcBlob>& compiled, IDxcBlob** ppBlobOut) const;
 
     enum RES_TYPE : Uint32
@@ -194,6 +214,8 @@ private:
     // Compiler version
     UINT32 m_MajorVer = 0;
     UINT32 m_MinorVer = 0;
+
+    std::atomic<ShaderBytecodeCache*> m_pBytecodeCache{nullptr};
 };
 
 
@@ -383,6 +405,68 @@ bool DXCompilerImpl::Compile(const CompileAttribs& Attribs)
     return true;
 }
 
+bool DXCompilerImpl::Preprocess(const CompileAttribs& Attribs, std::string& PreprocessedSource)
+{
+    auto CreateInstance = GetCreateInstaceProc();
+    if (CreateInstance == nullptr)
+        return false;
+
+    CComPtr<IDxcLibrary> library;
+    if (FAILED(CreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&library))))
+        return false;
+
+    CComPtr<IDxcCompiler> compiler;
+    if (FAILED(CreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler))))
+        return false;
+
+    CComPtr<IDxcBlobEncoding> sourceBlob;
+    if (FAILED(library->CreateBlobWithEncodingFromPinned(Attribs.Source, UINT32{Attribs.SourceLength}, CP_UTF8, &sourceBlob)))
+        return false;
+
+    DxcIncludeHandlerImpl IncludeHandler{Attribs.pShaderSourceStreamFactory, library};
+
+    CComPtr<IDxcOperationResult> result;
+    HRESULT                      hr = compiler->Preprocess(
+        sourceBlob,
+        L"",
+        Attribs.pArgs, UINT32{Attribs.ArgsCount},
+        Attribs.pDefines, UINT32{Attribs.DefinesCount},
+        Attribs.pShaderSourceStreamFactory ? &IncludeHandler : nullptr,
+        &result);
+
+    HRESULT status = E_FAIL;
+    if (FAILED(hr) || FAILED(result->GetStatus(&status)) || FAILED(status))
+    {
+        // Errors will be reported by the compiler
+        return false;
+    }
+
+    CComPtr<IDxcBlob> preprocessed;
+    if (FAILED(result->GetResult(&preprocessed)))
+        return false;
+
+    PreprocessedSource.assign(static_cast<const char*>(preprocessed->GetBufferPointer()), preprocessed->GetBufferSize());
+    return true;
+}
+
+bool DXCompilerImpl::CreateBlob(const void* pData, size_t Size, IDxcBlob** ppBlob)
+{
+    auto CreateInstance = GetCreateInstaceProc();
+    if (CreateInstance == nullptr)
+        return false;
+
+    CComPtr<IDxcLibrary> library;
+    if (FAILED(CreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&library))))
+        return false;
+
+    CComPtr<IDxcBlobEncoding> blob;
+    if (FAILED(library->CreateBlobWithEncodingOnHeapCopy(pData, static_cast<UINT32>(Size), CP_ACP, &blob)))
+        return false;
+
+    *ppBlob = blob.Detach();
+    return true;
+}
+
 bool DXCompilerImpl::ValidateAndSign(DxcCreateInstanceProc CreateInstance, IDxcLibrary* library, CComPtr<IDxcBlob>& compiled, IDxcBlob** ppBlobOut) const
 {
     HRESULT                hr;
@@ -796,11 +880,60 @@ void DXCompilerImpl::Compile(const ShaderCreateInfo& ShaderCI,
     CA.ppBlobOut                  = &pDXIL;
     CA.ppCompilerOutput           = &pDxcLog;
 
+    auto*                    pCache = m_pBytecodeCache.load();
+    ShaderBytecodeCache::Key CacheKey;
+    if (pCache != nullptr)
+    {
+        std::string PreprocessedSource;
+        if (Preprocess(CA, PreprocessedSource))
+        {
+            ShaderBytecodeCache::KeyBuilder KeyBuilder;
+            KeyBuilder.Update("DXC", m_MajorVer, m_MinorVer, m_Target, m_APIVersion, Profile, ShaderCI.EntryPoint);
+            for (const auto* Arg : DxilArgs)
+            {
+                const auto ArgLen = wcslen(Arg);
+                KeyBuilder.Update(ArgLen).UpdateRaw(Arg, ArgLen * sizeof(wchar_t));
+            }
+            KeyBuilder.Update(PreprocessedSource);
+            CacheKey = KeyBuilder.GetKey();
+
+            RefCntAutoPtr<IDataBlob> pCachedBytecode;
+            RefCntAutoPtr<IDataBlob> pCachedOutput;
+            if (pCache->Load(CacheKey, &pCachedBytecode, &pCachedOutput))
+            {
+                CComPtr<IDxcBlob> pCachedDXIL;
+                if (ppByteCodeBlob == nullptr || CreateBlob(pCachedBytecode->GetDataPtr(), pCachedBytecode->GetSize(), &pCachedDXIL))
+                {
+                    CompilerOutputView OutputView{pCachedOutput};
+                    HandleHLSLCompilerResult(true, pCachedOutput ? &OutputView : nullptr, Source, ShaderCI.Desc.Name, ppCompilerOutput);
+
+                    if (pByteCode != nullptr)
+                        pByteCode->assign(static_cast<const uint32_t*>(pCachedBytecode->GetDataPtr()),
+                                          static_cast<const uint32_t*>(pCachedBytecode->GetDataPtr()) + pCachedBytecode->GetSize() / sizeof(uint32_t));
+
+                    if (ppByteCodeBlob != nullptr)
+                        *ppByteCodeBlob = pCachedDXIL.Detach();
+                    return;
+                }
+            }
+        }
+        else
+        {
+            pCache = nullptr;
+        }
+    }
+
     auto result = Compile(CA);
     HandleHLSLCompilerResult(result, pDxcLog.p, Source, ShaderCI.Desc.Name, ppCompilerOutput);
 
     if (result && pDXIL && pDXIL->GetBufferSize() > 0)
     {
+        if (pCache != nullptr)
+        {
+            pCache->Store(CacheKey, pDXIL->GetBufferPointer(), pDXIL->GetBufferSize(),
+                          pDxcLog ? pDxcLog->GetBufferPointer() : nullptr, pDxcLog ? pDxcLog->GetBufferSize() : 0);
+        }
+
         if (pByteCode != nullptr)
             pByteCode->assign(static_cast<uint32_t*>(pDXIL->GetBufferPointer()),
                               static_cast<uint32_t*>(pDXIL->GetBufferPointer()) + pDXIL->GetBufferSize() / sizeof(uint32_t));
@@ -43,6 +43,8 @@
 #include "RefCntAutoPtr.hpp"
 #include "ShaderToolsCommon.hpp"
 #include "SPIRVTools.hpp"
+#include "ShaderBytecodeCache.hpp"
+#include "ThreadPool.hpp"
 
 #include "spirv-tools/optimizer.hpp"
 
@@ -212,6 +214,24 @@ TBuiltInResource InitResources()
     return Resources;
 }
 
+// Writes the compiler output blob that contains the null-terminated log followed by the shader source
+void CreateCompilerOutput(const char* Log,
+                          size_t      LogLen,
+                          const char* ShaderSource,
+                          size_t      SourceCodeLen,
+                          IDataBlob** ppCompilerOutput)
+{
+    VERIFY_EXPR(ppCompilerOutput != nullptr);
+
+    auto* pOutputDataBlob = MakeNewRCObj<DataBlobImpl>()(SourceCodeLen + 1 + LogLen + 1);
+    char* DataPtr         = reinterpret_cast<char*>(pOutputDataBlob->GetDataPtr());
+    memcpy(DataPtr, Log, LogLen);
+    DataPtr[LogLen] = '\0';
+    memcpy(DataPtr + LogLen + 1, ShaderSource, SourceCodeLen);
+    DataPtr[LogLen + 1 + SourceCodeLen] = '\0';
+    pOutputDataBlob->QueryInterface(IID_DataBlob, reinterpret_cast<IObject**>(ppCompilerOutput));
+}
+
 void LogCompilerError(const char* DebugOutputMessage,
                       const char* InfoLog,
                       const char* InfoDebugLog,
@@ -228,13 +248,7 @@ void LogCompilerError(const char* DebugOutputMessage,
     LOG_ERROR_MESSAGE(DebugOutputMessage, ErrorLog);
 
     if (ppCompilerOutput != nullptr)
-    {
-        auto* pOutputDataBlob = MakeNewRCObj<DataBlobImpl>()(SourceCodeLen + 1 + ErrorLog.length() + 1);
-        char* DataPtr         = reinterpret_cast<char*>(pOutputDataBlob->GetDataPtr());
-        memcpy(DataPtr, ErrorLog.data(), ErrorLog.length() + 1);
-        memcpy(DataPtr + ErrorLog.length() + 1, ShaderSource, SourceCodeLen + 1);
-        pOutputDataBlob->QueryInterface(IID_DataBlob, reinterpret_cast<IObject**>(ppCompilerOutput));
-    }
+        CreateCompilerOutput(ErrorLog.c_str(), ErrorLog.length(), ShaderSource, SourceCodeLen, ppCompilerOutput);
 }
 
 std::vector<unsigned int> CompileShaderInternal(::glslang::TShader&           Shader,
@@ -243,7 +257,8 @@ std::vector<unsigned int> CompileShaderInternal(::glslang::TShader&           Sh
                                                 const char*                   ShaderSource,
                                                 size_t                        SourceCodeLen,
                                                 bool                          AssignBindings,
-                                                IDataBlob**                   ppCompilerOutput)
+                                                IDataBlob**                   ppCompilerOutput,
+                                                std::string&                  InfoLog)
 {
     Shader.setAutoMapBindings(true);
     TBuiltInResource Resources = InitResources();
@@ -269,6 +284,12 @@ std::vector<unsigned int> CompileShaderInternal(::glslang::TShader&           Sh
     if (AssignBindings)
         Program.mapIO();
 
+    // Warnings reported for the successfully compiled shader
+    InfoLog = Shader.getInfoLog();
+    InfoLog.append(Program.getInfoLog());
+    if (!InfoLog.empty() && ppCompilerOutput != nullptr)
+        CreateCompilerOutput(InfoLog.c_str(), InfoLog.length(), ShaderSource, SourceCodeLen, ppCompilerOutput);
+
     std::vector<unsigned int> spirv;
     ::glslang::GlslangToSpv(*Program.getIntermediate(Shader.getStage()), spirv);
 
@@ -334,15 +355,106 @@ private:
     std::unordered_map<IncludeResult*, RefCntAutoPtr<IDataBlob>> m_DataBlobs;
 };
 
+// Runs the preprocessor and computes the cache key from the preprocessed source and
+// everything else that affects the generated SPIR-V. The shader object must not be used
+// for compilation after that.
+bool ComputeCacheKey(::glslang::TShader&              Shader,
+                     EShMessages                      messages,
+                     ::glslang::TShader::Includer&    Includer,
+                     ShaderBytecodeCache::KeyBuilder& KeyBuilder,
+                     ShaderBytecodeCache::Key&        CacheKey)
+{
+    TBuiltInResource Resources = InitResources();
+
+    std::string PreprocessedSource;
+    if (!Shader.preprocess(&Resources, 100, ENoProfile, false, false, messages, &PreprocessedSource, Includer))
+    {
+        // Errors will be reported by the compiler
+        return false;
+    }
+
+    KeyBuilder.Update("glslang", ::glslang::GetGlslVersionString(), spvSoftwareVersionString(),
+                      static_cast<Uint32>(Shader.getStage()), static_cast<Uint32>(messages), PreprocessedSource);
+    CacheKey = KeyBuilder.GetKey();
+    return true;
+}
+
+// Loads the SPIR-V from the cache and returns the compiler log stored with it, so that
+// a cache hit produces the same compiler output as the compilation.
+bool LoadSPIRVFromCache(ShaderBytecodeCache&            Cache,
+                        const ShaderBytecodeCache::Key& CacheKey,
+                        const char*                     ShaderSource,
+                        size_t                          SourceCodeLen,
+                        IDataBlob**                     ppCompilerOutput,
+                        std::vector<unsigned int>&      SPIRV)
+{
+    RefCntAutoPtr<IDataBlob> pBytecode;
+    RefCntAutoPtr<IDataBlob> pInfoLog;
+    if (!Cache.Load(CacheKey, &pBytecode, &pInfoLog))
+        return false;
+
+    const auto* pWords = static_cast<const unsigned int*>(pBytecode->GetDataPtr());
+    SPIRV.assign(pWords, pWords + pBytecode->GetSize() / sizeof(unsigned int));
+
+    if (pInfoLog && ppCompilerOutput != nullptr)
+        CreateCompilerOutput(static_cast<const char*>(pInfoLog->GetDataPtr()), pInfoLog->GetSize(), ShaderSource, SourceCodeLen, ppCompilerOutput);
+
+    return true;
+}
+
+spv_target_env SetSpirvVersion(::glslang::TShader& Shader, EShLanguage ShLang, SpirvVersion Version)
+{
+    switch (Version)
+    {
+        case SpirvVersion::Vk100:
+            // keep default
+            return SPV_ENV_VULKAN_1_0;
+
+        case SpirvVersion::Vk110:
+            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
+            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
+            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_3);
+            return SPV_ENV_VULKAN_1_1;
+
+        case SpirvVersion::Vk110_Spirv14:
+            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
+            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
+            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_4);
+            return SPV_ENV_VULKAN_1_1_SPIRV_1_4;
+
+        case SpirvVersion::Vk120:
+            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 120);
+            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_2);
+            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_5);
+            return SPV_ENV_VULKAN_1_2;
+
+        default:
+            UNEXPECTED("Unknown SPIRV version");
+            return SPV_ENV_VULKAN_1_0;
+    }
+}
+
+// Calls CompileShader(i) for every shader in the batch. Threads take shaders one by one,
+// so that a few expensive shaders do not stall the whole batch.
+template <typename CompileShaderType>
+void CompileBatch(size_t NumShaders, Uint32 NumThreads, const CompileShaderType& CompileShader)
+{
+    if (NumShaders == 0)
+        return;
+
+    GlslangScope Glslang;
+    ParallelFor(NumThreads, static_cast<Uint32>(NumShaders), CompileShader);
+}
+
 } // namespace
 
 std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
                                       const char*             ExtraDefinitions,
-                                      IDataBlob**             ppCompilerOutput)
+                                      IDataBlob**             ppCompilerOutput,
+                                      ShaderBytecodeCache*    pCache)
 {
-    EShLanguage        ShLang = ShaderTypeToShLanguage(ShaderCI.Desc.ShaderType);
-    ::glslang::TShader Shader{ShLang};
-    EShMessages        messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules | EShMsgReadHlsl | EShMsgHlslLegalization);
+    EShLanguage ShLang   = ShaderTypeToShLanguage(ShaderCI.Desc.ShaderType);
+    EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules | EShMsgReadHlsl | EShMsgHlslLegalization);
 
     VERIFY_EXPR(ShaderCI.SourceLanguage == SHADER_SOURCE_LANGUAGE_HLSL);
 
@@ -351,13 +463,6 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
     VERIFY(ShLang != EShLangTaskNV && ShLang != EShLangMeshNV,
            "Mesh shaders are not supported, use DXCompiler to build SPIRV from HLSL");
 
-    Shader.setEnvInput(::glslang::EShSourceHlsl, ShLang, ::glslang::EShClientVulkan, 100);
-    Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_0);
-    Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_0);
-    Shader.setHlslIoMapping(true);
-    Shader.setEntryPoint(ShaderCI.EntryPoint);
-    Shader.setEnvTargetHlslFunctionality1();
-
     RefCntAutoPtr<IDataBlob> pFileData;
     size_t                   SourceCodeLen = 0;
 
@@ -375,16 +480,49 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
         Defines += '\n';
         AppendShaderMacros(Defines, ShaderCI.Macros);
     }
-    Shader.setPreamble(Defines.c_str());
 
     const char* ShaderStrings[]       = {SourceCode};
     const int   ShaderStringLengths[] = {static_cast<int>(SourceCodeLen)};
     const char* Names[]               = {ShaderCI.FilePath != nullptr ? ShaderCI.FilePath : ""};
-    Shader.setStringsWithLengthsAndNames(ShaderStrings, ShaderStringLengths, Names, 1);
+
+    auto InitShader = [&](::glslang::TShader& Shader) {
+        Shader.setEnvInput(::glslang::EShSourceHlsl, ShLang, ::glslang::EShClientVulkan, 100);
+        Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_0);
+        Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_0);
+        Shader.setHlslIoMapping(true);
+        Shader.setEntryPoint(ShaderCI.EntryPoint);
+        Shader.setEnvTargetHlslFunctionality1();
+        Shader.setPreamble(Defines.c_str());
+        Shader.setStringsWithLengthsAndNames(ShaderStrings, ShaderStringLengths, Names, 1);
+    };
 
     IncluderImpl Includer{ShaderCI.pShaderSourceStreamFactory};
 
-    auto SPIRV = CompileShaderInternal(Shader, messages, &Includer, SourceCode, SourceCodeLen, true, ppCompilerOutput);
+    ShaderBytecodeCache::Key CacheKey;
+    if (pCache != nullptr)
+    {
+        ::glslang::TShader PreprocShader{ShLang};
+        InitShader(PreprocShader);
+
+        ShaderBytecodeCache::KeyBuilder KeyBuilder;
+        KeyBuilder.Update("HLSL", ShaderCI.EntryPoint);
+        if (ComputeCacheKey(PreprocShader, messages, Includer, KeyBuilder, CacheKey))
+        {
+            std::vector<unsigned int> SPIRV;
+            if (LoadSPIRVFromCache(*pCache, CacheKey, SourceCode, SourceCodeLen, ppCompilerOutput, SPIRV))
+                return SPIRV;
+        }
+        else
+        {
+            pCache = nullptr;
+        }
+    }
+
+    ::glslang::TShader Shader{ShLang};
+    InitShader(Shader);
+
+    std::string InfoLog;
+    auto        SPIRV = CompileShaderInternal(Shader, messages, &Includer, SourceCode, SourceCodeLen, true, ppCompilerOutput, InfoLog);
     if (SPIRV.empty())
         return SPIRV;
 
@@ -395,68 +533,69 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
     SpirvOptimizer.RegisterLegalizationPasses();
     SpirvOptimizer.RegisterPerformancePasses();
     std::vector<uint32_t> LegalizedSPIRV;
-    if (SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &LegalizedSPIRV))
-    {
-        return LegalizedSPIRV;
-    }
-    else
+    if (!SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &LegalizedSPIRV))
     {
         LOG_ERROR("Failed to legalize SPIR-V shader generated by HLSL front-end. This may result in undefined behavior.");
         return SPIRV;
     }
+
+    if (pCache != nullptr)
+        pCache->Store(CacheKey, LegalizedSPIRV.data(), LegalizedSPIRV.size() * sizeof(LegalizedSPIRV[0]), InfoLog.data(), InfoLog.length());
+
+    return LegalizedSPIRV;
 }
 
 std::vector<unsigned int> GLSLtoSPIRV(const GLSLtoSPIRVAttribs& Attribs)
 {
     VERIFY_EXPR(Attribs.ShaderSource != nullptr && Attribs.SourceCodeLen > 0);
 
-    EShLanguage        ShLang = ShaderTypeToShLanguage(Attribs.ShaderType);
-    ::glslang::TShader Shader(ShLang);
-    spv_target_env     spvTarget = SPV_ENV_VULKAN_1_0;
-
-    switch (Attribs.Version)
-    {
-        case SpirvVersion::Vk100:
-            // keep default
-            break;
-        case SpirvVersion::Vk110:
-            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
-            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
-            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_3);
-            spvTarget = SPV_ENV_VULKAN_1_1;
-            break;
-        case SpirvVersion::Vk110_Spirv14:
-            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
-            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
-            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_4);
-            spvTarget = SPV_ENV_VULKAN_1_1_SPIRV_1_4;
-            break;
-        case SpirvVersion::Vk120:
-            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 120);
-            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_2);
-            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_5);
-            spvTarget = SPV_ENV_VULKAN_1_2;
-            break;
-        default:
-            UNEXPECTED("Unknown SPIRV version");
-    }
-
+    EShLanguage ShLang   = ShaderTypeToShLanguage(Attribs.ShaderType);
     EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
 
     const char* ShaderStrings[] = {Attribs.ShaderSource};
     int         Lengths[]       = {Attribs.SourceCodeLen};
-    Shader.setStringsWithLengths(ShaderStrings, Lengths, 1);
 
     std::string Defines{"#define GLSLANG\n\n"};
     if (Attribs.Macros != nullptr)
-    {
         AppendShaderMacros(Defines, Attribs.Macros);
-        Shader.setPreamble(Defines.c_str());
-    }
+
+    spv_target_env spvTarget = SPV_ENV_VULKAN_1_0;
+
+    auto InitShader = [&](::glslang::TShader& Shader) {
+        spvTarget = SetSpirvVersion(Shader, ShLang, Attribs.Version);
+        Shader.setStringsWithLengths(ShaderStrings, Lengths, 1);
+        if (Attribs.Macros != nullptr)
+            Shader.setPreamble(Defines.c_str());
+    };
 
     IncluderImpl Includer{Attribs.pShaderSourceStreamFactory};
 
-    auto SPIRV = CompileShaderInternal(Shader, messages, &Includer, Attribs.ShaderSource, Attribs.SourceCodeLen, Attribs.AssignBindings, Attribs.ppCompilerOutput);
+    auto*                    pCache = Attribs.pCache;
+    ShaderBytecodeCache::Key CacheKey;
+    if (pCache != nullptr)
+    {
+        ::glslang::TShader PreprocShader{ShLang};
+        InitShader(PreprocShader);
+
+        ShaderBytecodeCache::KeyBuilder KeyBuilder;
+        KeyBuilder.Update("GLSL", static_cast<Uint32>(Attribs.Version), Attribs.AssignBindings);
+        if (ComputeCacheKey(PreprocShader, messages, Includer, KeyBuilder, CacheKey))
+        {
+            std::vector<unsigned int> SPIRV;
+            if (LoadSPIRVFromCache(*pCache, CacheKey, Attribs.ShaderSource, Attribs.SourceCodeLen, Attribs.ppCompilerOutput, SPIRV))
+                return SPIRV;
+        }
+        else
+        {
+            pCache = nullptr;
+        }
+    }
+
+    ::glslang::TShader Shader{ShLang};
+    InitShader(Shader);
+
+    std::string InfoLog;
+    auto        SPIRV = CompileShaderInternal(Shader, messages, &Includer, Attribs.ShaderSource, Attribs.SourceCodeLen, Attribs.AssignBindings, Attribs.ppCompilerOutput, InfoLog);
     if (SPIRV.empty())
         return SPIRV;
 
@@ -464,15 +603,46 @@ std::vector<unsigned int> GLSLtoSPIRV(const GLSLtoSPIRVAttribs& Attribs)
     SpirvOptimizer.SetMessageConsumer(SpvOptimizerMessageConsumer);
     SpirvOptimizer.RegisterPerformancePasses();
     std::vector<uint32_t> OptimizedSPIRV;
-    if (SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &OptimizedSPIRV))
-    {
-        return OptimizedSPIRV;
-    }
-    else
+    if (!SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &OptimizedSPIRV))
     {
         LOG_ERROR("Failed to optimize SPIR-V.");
         return SPIRV;
     }
+
+    if (pCache != nullptr)
+        pCache->Store(CacheKey, OptimizedSPIRV.data(), OptimizedSPIRV.size() * sizeof(OptimizedSPIRV[0]), InfoLog.data(), InfoLog.length());
+
+    return OptimizedSPIRV;
+}
+
+std::vector<SPIRVCompileResult> GLSLtoSPIRVBatch(const GLSLtoSPIRVAttribs* pAttribs,
+                                                 size_t                    NumShaders,
+                                                 Uint32                    NumThreads)
+{
+    DEV_CHECK_ERR(pAttribs != nullptr || NumShaders == 0, "pAttribs must not be null");
+
+    std::vector<SPIRVCompileResult> Results(NumShaders);
+    CompileBatch(NumShaders, NumThreads, [&](Uint32 i) {
+        auto Attribs             = pAttribs[i];
+        Attribs.ppCompilerOutput = Results[i].pCompilerOutput.RawDblPtr();
+        Results[i].SPIRV         = GLSLtoSPIRV(Attribs);
+    });
+    return Results;
+}
+
+std::vector<SPIRVCompileResult> HLSLtoSPIRVBatch(const ShaderCreateInfo* pShaderCIs,
+                                                 size_t                  NumShaders,
+                                                 const char*             ExtraDefinitions,
+                                                 Uint32                  NumThreads,
+                                                 ShaderBytecodeCache*    pCache)
+{
+    DEV_CHECK_ERR(pShaderCIs != nullptr || NumShaders == 0, "pShaderCIs must not be null");
+
+    std::vector<SPIRVCompileResult> Results(NumShaders);
+    CompileBatch(NumShaders, NumThreads, [&](Uint32 i) {
+        Results[i].SPIRV = HLSLtoSPIRV(pShaderCIs[i], ExtraDefinitions, Results[i].pCompilerOutput.RawDblPtr(), pCache);
+    });
+    return Results;
 }
 
 } // namespace GLSLangUtils
@@ -0,0 +1,439 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderBytecodeCache.hpp"
+
+#include <cstdio>
+#include <atomic>
+#include <vector>
+
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "DataBlobImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr Uint32 EntryFileMagic = 0x43425344; // 'DSBC'
+constexpr Uint32 IndexFileMagic = 0x49425344; // 'DSBI'
+
+struct EntryFileHeader
+{
+    Uint32 Magic   = EntryFileMagic;
+    Uint32 Version = ShaderBytecodeCache::FormatVersion;
+
+    ShaderBytecodeCache::Key CacheKey;
+
+    Uint64 BytecodeSize = 0;
+    Uint64 OutputSize   = 0;
+
+    // Hash of the bytecode and the compiler output that is used to detect
+    // truncated or corrupted files.
+    Uint64 Checksum = 0;
+};
+
+struct IndexFileHeader
+{
+    Uint32 Magic      = IndexFileMagic;
+    Uint32 Version    = ShaderBytecodeCache::FormatVersion;
+    Uint64 NumEntries = 0;
+};
+
+struct IndexFileEntry
+{
+    ShaderBytecodeCache::Key CacheKey;
+
+    Uint64 Size = 0;
+};
+
+Uint64 ComputeChecksum(const void* pBytecode, size_t BytecodeSize, const void* pOutput, size_t OutputSize)
+{
+    Hasher64 Hasher;
+    Hasher.UpdateRaw(pBytecode, BytecodeSize);
+    Hasher.UpdateRaw(pOutput, OutputSize);
+    return Hasher.Digest();
+}
+
+// Writes the data to a temporary file and renames it, so that other threads and processes
+// never see a partially written file.
+bool WriteFileAtomic(const String& Path, const void* pHeader, size_t HeaderSize, const void* pData0, size_t Size0, const void* pData1, size_t Size1)
+{
+    static std::atomic<Uint32> TmpFileCounter{0};
+
+    const auto TmpPath = Path + ".tmp" + std::to_string(TmpFileCounter.fetch_add(1));
+    {
+        FileWrapper File{TmpPath.c_str(), EFileAccessMode::Overwrite};
+        if (!File)
+        {
+            LOG_ERROR_MESSAGE("Failed to create shader cache file '", TmpPath, "'");
+            return false;
+        }
+
+        bool Res = File->Write(pHeader, HeaderSize);
+        if (Res && Size0 > 0)
+            Res = File->Write(pData0, Size0);
+        if (Res && Size1 > 0)
+            Res = File->Write(pData1, Size1);
+        if (!Res)
+        {
+            LOG_ERROR_MESSAGE("Failed to write shader cache file '", TmpPath, "'");
+            File.Close();
+            FileSystem::DeleteFile(TmpPath.c_str());
+            return false;
+        }
+    }
+
+    // On Windows, std::rename fails if the destination file exists
+    if (std::rename(TmpPath.c_str(), Path.c_str()) != 0)
+    {
+        FileSystem::DeleteFile(Path.c_str());
+        if (std::rename(TmpPath.c_str(), Path.c_str()) != 0)
+        {
+            LOG_ERROR_MESSAGE("Failed to rename shader cache file '", TmpPath, "' to '", Path, "'");
+            FileSystem::DeleteFile(TmpPath.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Reads and validates the cache entry file. Returns false if the file does not exist,
+// belongs to a different key or is corrupted.
+bool ReadEntryFile(const String&                   Path,
+                   const ShaderBytecodeCache::Key& CacheKey,
+                   RefCntAutoPtr<IDataBlob>&       pBytecode,
+                   RefCntAutoPtr<IDataBlob>&       pOutput,
+                   size_t&                         FileSize)
+{
+    // Opening a file that does not exist logs an error, so check it first
+    if (!FileSystem::FileExists(Path.c_str()))
+        return false;
+
+    FileWrapper File{Path.c_str()};
+    if (!File)
+        return false;
+
+    FileSize = File->GetSize();
+
+    EntryFileHeader Header;
+    if (FileSize < sizeof(Header) || !File->Read(&Header, sizeof(Header)))
+        return false;
+
+    if (Header.Magic != EntryFileMagic ||
+        Header.Version != ShaderBytecodeCache::FormatVersion ||
+        Header.CacheKey != CacheKey ||
+        Header.BytecodeSize == 0 ||
+        sizeof(Header) + Header.BytecodeSize + Header.OutputSize != FileSize)
+        return false;
+
+    pBytecode = MakeNewRCObj<DataBlobImpl>{}(static_cast<size_t>(Header.BytecodeSize));
+    if (!File->Read(pBytecode->GetDataPtr(), pBytecode->GetSize()))
+        return false;
+
+    if (Header.OutputSize != 0)
+    {
+        pOutput = MakeNewRCObj<DataBlobImpl>{}(static_cast<size_t>(Header.OutputSize));
+        if (!File->Read(pOutput->GetDataPtr(), pOutput->GetSize()))
+            return false;
+    }
+
+    const auto Checksum = ComputeChecksum(pBytecode->GetDataPtr(), pBytecode->GetSize(),
+                                          pOutput ? pOutput->GetDataPtr() : nullptr, pOutput ? pOutput->GetSize() : 0);
+    return Checksum == Header.Checksum;
+}
+
+} // namespace
+
+String ShaderBytecodeCache::Key::ToString() const
+{
+    static constexpr char HexDigits[] = "0123456789abcdef";
+
+    String Str(32, '0');
+    for (size_t i = 0; i < 32; ++i)
+    {
+        const auto Val = Hash[i / 16] >> ((15 - i % 16) * 4);
+        Str[i]         = HexDigits[Val & 0xF];
+    }
+    return Str;
+}
+
+ShaderBytecodeCache::ShaderBytecodeCache(const CreateInfo& CI) :
+    m_MaxSize{CI.MaxSize}
+{
+    if (CI.Directory == nullptr || CI.Directory[0] == '\0')
+        LOG_ERROR_AND_THROW("Shader cache directory must not be empty");
+
+    m_Directory = CI.Directory;
+    if (m_Directory.back() != '/' && m_Directory.back() != '\\')
+        m_Directory.push_back(FileSystem::GetSlashSymbol());
+    m_Directory.append("v");
+    m_Directory.append(std::to_string(FormatVersion));
+
+    if (!FileSystem::PathExists(m_Directory.c_str()))
+    {
+        if (!FileSystem::CreateDirectory(m_Directory.c_str()))
+            LOG_ERROR_AND_THROW("Failed to create shader cache directory '", m_Directory, "'");
+    }
+
+    ReadIndex();
+}
+
+ShaderBytecodeCache::~ShaderBytecodeCache()
+{
+    Flush();
+}
+
+String ShaderBytecodeCache::GetEntryPath(const Key& CacheKey) const
+{
+    String Path = m_Directory;
+    Path.push_back(FileSystem::GetSlashSymbol());
+    Path.append(CacheKey.ToString());
+    Path.append(".bin");
+    return Path;
+}
+
+String ShaderBytecodeCache::GetIndexPath() const
+{
+    String Path = m_Directory;
+    Path.push_back(FileSystem::GetSlashSymbol());
+    Path.append("index.bin");
+    return Path;
+}
+
+void ShaderBytecodeCache::ReadIndex()
+{
+    const auto IndexPath = GetIndexPath();
+    if (!FileSystem::FileExists(IndexPath.c_str()))
+        return;
+
+    std::vector<IndexFileEntry> Entries;
+    {
+        FileWrapper File{IndexPath.c_str()};
+        if (!File)
+            return;
+
+        const auto      FileSize = File->GetSize();
+        IndexFileHeader Header;
+        if (FileSize < sizeof(Header) || !File->Read(&Header, sizeof(Header)))
+            return;
+
+        if (Header.Magic != IndexFileMagic ||
+            Header.Version != FormatVersion ||
+            sizeof(Header) + Header.NumEntries * sizeof(IndexFileEntry) != FileSize)
+        {
+            LOG_WARNING_MESSAGE("Shader cache index file '", IndexPath, "' is corrupted and will be ignored");
+            return;
+        }
+
+        Entries.resize(static_cast<size_t>(Header.NumEntries));
+        if (!Entries.empty() && !File->Read(Entries.data(), Entries.size() * sizeof(IndexFileEntry)))
+            return;
+    }
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    // The entries are stored in most recently used first order
+    for (const auto& Entry : Entries)
+    {
+        if (m_Entries.find(Entry.CacheKey) == m_Entries.end())
+        {
+            AddEntry(Entry.CacheKey, static_cast<size_t>(Entry.Size));
+            // AddEntry() puts the entry to the front of the list
+            m_LRUList.splice(m_LRUList.end(), m_LRUList, m_LRUList.begin());
+        }
+    }
+
+    // The size limit may have been reduced since the index was written
+    EvictEntries(0);
+}
+
+void ShaderBytecodeCache::AddEntry(const Key& CacheKey, size_t Size)
+{
+    VERIFY_EXPR(m_Entries.find(CacheKey) == m_Entries.end());
+
+    m_LRUList.push_front(CacheKey);
+
+    auto& Entry = m_Entries[CacheKey];
+    Entry.Size  = Size;
+    Entry.LRUIt = m_LRUList.begin();
+
+    m_Stats.TotalSize += Size;
+    m_Stats.NumEntries += 1;
+    m_IndexDirty = true;
+}
+
+void ShaderBytecodeCache::RemoveEntry(const Key& CacheKey)
+{
+    auto it = m_Entries.find(CacheKey);
+    if (it == m_Entries.end())
+        return;
+
+    VERIFY_EXPR(m_Stats.TotalSize >= it->second.Size && m_Stats.NumEntries > 0);
+    m_Stats.TotalSize -= it->second.Size;
+    m_Stats.NumEntries -= 1;
+
+    m_LRUList.erase(it->second.LRUIt);
+    m_Entries.erase(it);
+    m_IndexDirty = true;
+}
+
+void ShaderBytecodeCache::EvictEntries(size_t RequiredSize)
+{
+    while (!m_LRUList.empty() && m_Stats.TotalSize + RequiredSize > m_MaxSize)
+    {
+        const auto CacheKey = m_LRUList.back();
+        RemoveEntry(CacheKey);
+        FileSystem::DeleteFile(GetEntryPath(CacheKey).c_str());
+        ++m_Stats.NumEvictions;
+    }
+}
+
+bool ShaderBytecodeCache::Load(const Key& CacheKey, IDataBlob** ppBytecode, IDataBlob** ppCompilerOutput)
+{
+    DEV_CHECK_ERR(ppBytecode != nullptr && *ppBytecode == nullptr, "ppBytecode must not be null and must point to a null pointer");
+    DEV_CHECK_ERR(ppCompilerOutput == nullptr || *ppCompilerOutput == nullptr, "ppCompilerOutput must point to a null pointer");
+
+    // Read the file without holding the lock. Note that the file is looked up even if it is not in the
+    // index as it may have been written by another process or by a previous session that did not flush the index.
+    RefCntAutoPtr<IDataBlob> pBytecode;
+    RefCntAutoPtr<IDataBlob> pOutput;
+    size_t                   FileSize = 0;
+
+    const auto Path  = GetEntryPath(CacheKey);
+    const auto Found = ReadEntryFile(Path, CacheKey, pBytecode, pOutput, FileSize);
+
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto it = m_Entries.find(CacheKey);
+        if (Found)
+        {
+            ++m_Stats.NumHits;
+            if (it != m_Entries.end())
+            {
+                if (it->second.LRUIt != m_LRUList.begin())
+                {
+                    m_LRUList.splice(m_LRUList.begin(), m_LRUList, it->second.LRUIt);
+                    m_IndexDirty = true;
+                }
+            }
+            else if (FileSize <= m_MaxSize)
+            {
+                EvictEntries(FileSize);
+                AddEntry(CacheKey, FileSize);
+            }
+        }
+        else
+        {
+            ++m_Stats.NumMisses;
+            if (it != m_Entries.end())
+            {
+                // The file was deleted or is corrupted
+                RemoveEntry(CacheKey);
+                if (FileSystem::FileExists(Path.c_str()))
+                    FileSystem::DeleteFile(Path.c_str());
+            }
+        }
+    }
+
+    if (!Found)
+        return false;
+
+    *ppBytecode = pBytecode.Detach();
+    if (ppCompilerOutput != nullptr && pOutput)
+        *ppCompilerOutput = pOutput.Detach();
+
+    return true;
+}
+
+void ShaderBytecodeCache::Store(const Key&  CacheKey,
+                                const void* pBytecode,
+                                size_t      BytecodeSize,
+                                const void* pCompilerOutput,
+                                size_t      CompilerOutputSize)
+{
+    DEV_CHECK_ERR(pBytecode != nullptr && BytecodeSize > 0, "Bytecode must not be empty");
+    DEV_CHECK_ERR(pCompilerOutput != nullptr || CompilerOutputSize == 0, "CompilerOutputSize must be 0 when pCompilerOutput is null");
+
+    const void*  pOutput    = pCompilerOutput;
+    const size_t OutputSize = pCompilerOutput != nullptr ? CompilerOutputSize : 0;
+
+    EntryFileHeader Header;
+    Header.CacheKey     = CacheKey;
+    Header.BytecodeSize = BytecodeSize;
+    Header.OutputSize   = OutputSize;
+    Header.Checksum     = ComputeChecksum(pBytecode, BytecodeSize, pOutput, OutputSize);
+
+    const size_t FileSize = sizeof(Header) + BytecodeSize + OutputSize;
+    if (FileSize > m_MaxSize)
+        return;
+
+    if (!WriteFileAtomic(GetEntryPath(CacheKey), &Header, sizeof(Header), pBytecode, BytecodeSize, pOutput, OutputSize))
+        return;
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    // The entry may have been stored by another thread
+    RemoveEntry(CacheKey);
+    EvictEntries(FileSize);
+    AddEntry(CacheKey, FileSize);
+    ++m_Stats.NumStores;
+}
+
+void ShaderBytecodeCache::Flush()
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    if (!m_IndexDirty)
+        return;
+
+    std::vector<IndexFileEntry> Entries;
+    Entries.reserve(m_LRUList.size());
+    for (const auto& CacheKey : m_LRUList)
+    {
+        IndexFileEntry Entry;
+        Entry.CacheKey = CacheKey;
+        Entry.Size     = m_Entries[CacheKey].Size;
+        Entries.push_back(Entry);
+    }
+
+    IndexFileHeader Header;
+    Header.NumEntries = Entries.size();
+    if (WriteFileAtomic(GetIndexPath(), &Header, sizeof(Header), Entries.data(), Entries.size() * sizeof(IndexFileEntry), nullptr, 0))
+        m_IndexDirty = false;
+}
+
+ShaderBytecodeCache::Statistics ShaderBytecodeCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_Stats;
+}
+
+} // namespace Diligent
@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <cstdio>
 
 #include "LinuxFileSystem.hpp"
@@ -62,14 +63,33 @@ bool LinuxFileSystem::FileExists(const Diligent::Char* strFilePath)
 
 bool LinuxFileSystem::PathExists(const Diligent::Char* strPath)
 {
-    UNSUPPORTED("Not implemented");
-    return false;
+    struct stat StatBuff;
+    return stat(strPath, &StatBuff) == 0;
 }
 
 bool LinuxFileSystem::CreateDirectory(const Diligent::Char* strPath)
 {
-    UNSUPPORTED("Not implemented");
-    return false;
+    // Test all parent directories
+    std::string            DirectoryPath = strPath;
+    std::string::size_type SlashPos      = std::string::npos;
+    const auto             SlashSym      = LinuxFileSystem::GetSlashSymbol();
+    LinuxFileSystem::CorrectSlashes(DirectoryPath, SlashSym);
+
+    do
+    {
+        SlashPos = DirectoryPath.find(SlashSym, (SlashPos != std::string::npos) ? SlashPos + 1 : 0);
+
+        std::string ParentDir = (SlashPos != std::string::npos) ? DirectoryPath.substr(0, SlashPos) : DirectoryPath;
+        // Skip the root directory of an absolute path
+        if (!ParentDir.empty() && !LinuxFileSystem::PathExists(ParentDir.c_str()))
+        {
+            // If there is no directory, create it
+            if (mkdir(ParentDir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != 0)
+                return false;
+        }
+    } while (SlashPos != std::string::npos);
+
+    return true;
 }
 
 void LinuxFileSystem::ClearDirectory(const Diligent::Char* strPath)
@@ -33,6 +33,7 @@
 
 #include "TestingEnvironment.hpp"
 #include "FastRand.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -149,4 +150,135 @@ TEST(BufferSuballocatorTest, Allocate)
     }
 }
 
+TEST(BufferSuballocatorTest, AllocateMultiple)
+{
+    auto* pEnv     = TestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    TestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    BufferSuballocatorCreateInfo CI;
+    CI.Desc.Name          = "Buffer Suballocator Test";
+    CI.Desc.BindFlags     = BIND_VERTEX_BUFFER;
+    CI.Desc.uiSizeInBytes = 1024;
+
+    RefCntAutoPtr<IBufferSuballocator> pAllocator;
+    CreateBufferSuballocator(pDevice, CI, &pAllocator);
+
+    constexpr Uint32 NumAllocations = 256;
+
+    std::vector<Uint32> Sizes(NumAllocations);
+    std::vector<Uint32> Alignments(NumAllocations);
+
+    FastRandInt rnd{0, 1, 128};
+    for (Uint32 i = 0; i < NumAllocations; ++i)
+    {
+        Sizes[i]      = static_cast<Uint32>(rnd());
+        Alignments[i] = 1u << (i % 5);
+    }
+
+    std::vector<IBufferSuballocation*> pSubAllocations(NumAllocations);
+    pAllocator->AllocateMultiple(NumAllocations, Sizes.data(), Alignments.data(), pSubAllocations.data());
+
+    std::vector<std::pair<Uint32, Uint32>> Ranges;
+    for (Uint32 i = 0; i < NumAllocations; ++i)
+    {
+        auto* pAlloc = pSubAllocations[i];
+        ASSERT_NE(pAlloc, nullptr);
+        EXPECT_EQ(pAlloc->GetSize(), Sizes[i]);
+        EXPECT_EQ(pAlloc->GetOffset() % Alignments[i], 0u);
+        EXPECT_EQ(pAlloc->GetAllocator(), pAllocator.RawPtr());
+        Ranges.emplace_back(pAlloc->GetOffset(), pAlloc->GetOffset() + pAlloc->GetSize());
+    }
+
+    // Suballocations must not overlap
+    std::sort(Ranges.begin(), Ranges.end());
+    for (size_t i = 1; i < Ranges.size(); ++i)
+        EXPECT_LE(Ranges[i - 1].second, Ranges[i].first);
+
+    auto* pBuffer = pAllocator->GetBuffer(pDevice, pContext);
+    ASSERT_NE(pBuffer, nullptr);
+    EXPECT_GE(pBuffer->GetDesc().uiSizeInBytes, Ranges.back().second);
+
+    // Keep one suballocation alive to check that it is not freed by the batch release
+    RefCntAutoPtr<IBufferSuballocation> pKeepAlive{pSubAllocations[NumAllocations / 2]};
+
+    // Null pointers must be ignored
+    pSubAllocations[0]->Release();
+    pSubAllocations[0] = nullptr;
+
+    pAllocator->ReleaseMultiple(NumAllocations, pSubAllocations.data());
+    for (auto* pAlloc : pSubAllocations)
+        EXPECT_EQ(pAlloc, nullptr);
+
+    const auto TotalSize = pBuffer->GetDesc().uiSizeInBytes;
+    EXPECT_LE(pAllocator->GetFreeSize(), TotalSize - pKeepAlive->GetSize());
+
+    pKeepAlive.Release();
+    EXPECT_EQ(pAllocator->GetFreeSize(), TotalSize);
+}
+
+TEST(BufferSuballocatorTest, BurstAllocation)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    TestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    BufferSuballocatorCreateInfo CI;
+    CI.Desc.Name          = "Buffer Suballocator Test";
+    CI.Desc.BindFlags     = BIND_VERTEX_BUFFER;
+    CI.Desc.uiSizeInBytes = 1 << 20;
+    CI.ExpansionSize      = 1 << 20;
+
+    RefCntAutoPtr<IBufferSuballocator> pAllocator;
+    CreateBufferSuballocator(pDevice, CI, &pAllocator);
+
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumAllocations = 4096;
+    constexpr Uint32 NumIterations  = 2;
+#else
+    constexpr Uint32 NumAllocations = 65536;
+    constexpr Uint32 NumIterations  = 8;
+#endif
+
+    std::vector<Uint32> Sizes(NumAllocations);
+    std::vector<Uint32> Alignments(NumAllocations, 16);
+
+    FastRandInt rnd{0, 16, 512};
+    for (auto& Size : Sizes)
+        Size = static_cast<Uint32>(rnd());
+
+    std::vector<IBufferSuballocation*> pSubAllocations(NumAllocations);
+
+    double SingleTime = 0;
+    double BatchTime  = 0;
+    for (Uint32 iter = 0; iter < NumIterations; ++iter)
+    {
+        {
+            Timer T;
+            for (Uint32 i = 0; i < NumAllocations; ++i)
+                pAllocator->Allocate(Sizes[i], Alignments[i], &pSubAllocations[i]);
+            for (auto*& pAlloc : pSubAllocations)
+            {
+                pAlloc->Release();
+                pAlloc = nullptr;
+            }
+            SingleTime += T.GetElapsedTime();
+        }
+
+        {
+            Timer T;
+            pAllocator->AllocateMultiple(NumAllocations, Sizes.data(), Alignments.data(), pSubAllocations.data());
+            pAllocator->ReleaseMultiple(NumAllocations, pSubAllocations.data());
+            BatchTime += T.GetElapsedTime();
+        }
+    }
+
+    LOG_INFO_MESSAGE("Burst allocation of ", NumAllocations, " suballocations x ", NumIterations, " iterations:",
+                     "\n    Allocate/Release:                 ", SingleTime * 1000, " ms",
+                     "\n    AllocateMultiple/ReleaseMultiple: ", BatchTime * 1000, " ms");
+}
+
 } // namespace
@@ -0,0 +1,241 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestingEnvironment.hpp"
+#include "GLSLangUtils.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+struct TestShaderInfo
+{
+    const char* FilePath;
+    const char* EntryPoint;
+    SHADER_TYPE ShaderType;
+};
+
+// clang-format off
+const TestShaderInfo TestShaders[] =
+{
+    {"ShaderResourceArrayTest.vsh",    "main",   SHADER_TYPE_VERTEX},
+    {"ShaderResourceArrayTest.psh",    "main",   SHADER_TYPE_PIXEL},
+    {"ShaderVariableAccessTestDX.vsh", "main",   SHADER_TYPE_VERTEX},
+    {"ShaderVariableAccessTestDX.psh", "main",   SHADER_TYPE_PIXEL},
+    {"SamplerCorrectness.hlsl",        "VSMain", SHADER_TYPE_VERTEX},
+    {"SamplerCorrectness.hlsl",        "PSMain", SHADER_TYPE_PIXEL},
+};
+// clang-format on
+
+// Creates NumPermutations copies of every test shader that differ by the PERMUTATION macro
+class TestShaderBatch
+{
+public:
+    explicit TestShaderBatch(Uint32 NumPermutations)
+    {
+        auto* pEnv = TestingEnvironment::GetInstance();
+        pEnv->GetDevice()->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders", &m_pShaderSourceFactory);
+
+        m_PermutationStrings.reserve(NumPermutations);
+        for (Uint32 i = 0; i < NumPermutations; ++i)
+            m_PermutationStrings.emplace_back(std::to_string(i));
+
+        m_Macros.reserve(NumPermutations * 2);
+        for (Uint32 i = 0; i < NumPermutations; ++i)
+        {
+            m_Macros.emplace_back("PERMUTATION", m_PermutationStrings[i].c_str());
+            m_Macros.emplace_back();
+        }
+
+        for (Uint32 i = 0; i < NumPermutations; ++i)
+        {
+            for (const auto& Shader : TestShaders)
+            {
+                ShaderCreateInfo ShaderCI;
+                ShaderCI.FilePath                   = Shader.FilePath;
+                ShaderCI.EntryPoint                 = Shader.EntryPoint;
+                ShaderCI.Desc.ShaderType            = Shader.ShaderType;
+                ShaderCI.Desc.Name                  = Shader.FilePath;
+                ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+                ShaderCI.pShaderSourceStreamFactory = m_pShaderSourceFactory;
+                ShaderCI.Macros                     = &m_Macros[i * 2];
+                m_ShaderCIs.push_back(ShaderCI);
+            }
+        }
+    }
+
+    const std::vector<ShaderCreateInfo>& GetShaderCIs() const { return m_ShaderCIs; }
+
+private:
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> m_pShaderSourceFactory;
+
+    std::vector<std::string>      m_PermutationStrings;
+    std::vector<ShaderMacro>      m_Macros;
+    std::vector<ShaderCreateInfo> m_ShaderCIs;
+};
+
+TEST(GLSLangUtilsTest, HLSLtoSPIRVBatch)
+{
+    GLSLangUtils::GlslangScope Glslang;
+
+    TestShaderBatch Batch{2};
+
+    const auto& ShaderCIs = Batch.GetShaderCIs();
+    const auto  Results   = GLSLangUtils::HLSLtoSPIRVBatch(ShaderCIs.data(), ShaderCIs.size(), nullptr, 4);
+    ASSERT_EQ(Results.size(), ShaderCIs.size());
+
+    for (size_t i = 0; i < ShaderCIs.size(); ++i)
+    {
+        const auto RefSPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCIs[i], nullptr, nullptr);
+        EXPECT_FALSE(RefSPIRV.empty()) << ShaderCIs[i].FilePath;
+        EXPECT_EQ(Results[i].SPIRV, RefSPIRV) << ShaderCIs[i].FilePath;
+    }
+}
+
+TEST(GLSLangUtilsTest, GLSLtoSPIRVBatch)
+{
+    const char* ValidShader = R"(
+#version 450
+layout(location = 0) out vec4 Color;
+void main()
+{
+    Color = vec4(1.0, 0.0, 0.0, 1.0);
+}
+)";
+
+    const char* BrokenShader = R"(
+#version 450
+layout(location = 0) out vec4 Color;
+void main()
+{
+    Color = UndeclaredVariable;
+}
+)";
+
+    std::vector<GLSLangUtils::GLSLtoSPIRVAttribs> Attribs(8);
+    for (size_t i = 0; i < Attribs.size(); ++i)
+    {
+        const auto* Source       = (i % 4 == 3) ? BrokenShader : ValidShader;
+        Attribs[i].ShaderType    = SHADER_TYPE_PIXEL;
+        Attribs[i].ShaderSource  = Source;
+        Attribs[i].SourceCodeLen = static_cast<int>(strlen(Source));
+    }
+
+    TestingEnvironment::SetErrorAllowance(2, "\n\nNo worries, testing broken shaders...\n\n");
+
+    // Glslang does not need to be initialized by the caller
+    const auto Results = GLSLangUtils::GLSLtoSPIRVBatch(Attribs.data(), Attribs.size(), 3);
+    ASSERT_EQ(Results.size(), Attribs.size());
+    for (size_t i = 0; i < Results.size(); ++i)
+    {
+        if (i % 4 == 3)
+        {
+            EXPECT_TRUE(Results[i].SPIRV.empty());
+            EXPECT_TRUE(Results[i].pCompilerOutput);
+        }
+        else
+        {
+            EXPECT_FALSE(Results[i].SPIRV.empty());
+            EXPECT_EQ(Results[i].SPIRV, Results[0].SPIRV);
+        }
+    }
+}
+
+TEST(GLSLangUtilsTest, BatchException)
+{
+    GLSLangUtils::GlslangScope Glslang;
+
+    TestShaderBatch Batch{2};
+
+    auto ShaderCIs        = Batch.GetShaderCIs();
+    ShaderCIs[3].FilePath = "NonExistentShader.hlsl";
+
+    TestingEnvironment::SetErrorAllowance(2, "\n\nNo worries, testing missing shader file...\n\n");
+
+    // The exception must be propagated to the caller rather than leave the result empty
+    EXPECT_ANY_THROW(GLSLangUtils::HLSLtoSPIRVBatch(ShaderCIs.data(), ShaderCIs.size(), nullptr, 4));
+
+    // Subsequent batches must not be affected by the exception
+    ShaderCIs[3].FilePath = TestShaders[3].FilePath;
+    const auto Results    = GLSLangUtils::HLSLtoSPIRVBatch(ShaderCIs.data(), ShaderCIs.size(), nullptr, 4);
+    for (const auto& Res : Results)
+        EXPECT_FALSE(Res.SPIRV.empty());
+}
+
+TEST(GLSLangUtilsTest, DISABLED_BatchCompileBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumPermutations = 4;
+#else
+    constexpr Uint32 NumPermutations = 32;
+#endif
+
+    GLSLangUtils::GlslangScope Glslang;
+
+    TestShaderBatch Batch{NumPermutations};
+
+    const auto& ShaderCIs = Batch.GetShaderCIs();
+
+    const auto MaxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<Uint32> ThreadCounts;
+    for (Uint32 NumThreads = 1; NumThreads < MaxThreads; NumThreads *= 2)
+        ThreadCounts.push_back(NumThreads);
+    ThreadCounts.push_back(MaxThreads);
+
+    double SingleThreadTime = 0;
+    for (auto NumThreads : ThreadCounts)
+    {
+        Timer T;
+
+        const auto StartTime = T.GetElapsedTime();
+        const auto Results   = GLSLangUtils::HLSLtoSPIRVBatch(ShaderCIs.data(), ShaderCIs.size(), nullptr, NumThreads);
+        const auto Time      = T.GetElapsedTime() - StartTime;
+
+        for (const auto& Res : Results)
+            EXPECT_FALSE(Res.SPIRV.empty());
+
+        if (NumThreads == 1)
+            SingleThreadTime = Time;
+
+        LOG_INFO_MESSAGE("Compiled ", ShaderCIs.size(), " shaders on ", NumThreads, " thread(s) in ", Time * 1000, " ms (",
+                         SingleThreadTime / std::max(Time, 1e-6), "x)");
+    }
+}
+
+} // namespace
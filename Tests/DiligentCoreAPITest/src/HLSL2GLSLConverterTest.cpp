@@ -25,8 +25,16 @@
  *  of the possibility of such damages.
  */
 
+#include <vector>
+#include <array>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+
 #include "TestingEnvironment.hpp"
 #include "HLSL2GLSLConverter.h"
+#include "HLSL2GLSLConverterImpl.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -146,4 +154,215 @@ TEST(HLSL2GLSLConverterTest, GS)
     EXPECT_NE(pGS, nullptr);
 }
 
+TEST(HLSL2GLSLConverterTest, DISABLED_ConversionBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumIterations = 4;
+#else
+    constexpr Uint32 NumIterations = 64;
+#endif
+
+    struct EntryPointInfo
+    {
+        const char* Name;
+        SHADER_TYPE ShaderType;
+    };
+    struct TestShaderInfo
+    {
+        const char*                 FileName;
+        std::vector<EntryPointInfo> EntryPoints;
+    };
+    // clang-format off
+    const TestShaderInfo TestShaders[] =
+    {
+        {"VS_PS.hlsl",        {{"TestVS", SHADER_TYPE_VERTEX}, {"TestPS", SHADER_TYPE_PIXEL}}},
+        {"CS_RWTex1D.hlsl",   {{"TestCS", SHADER_TYPE_COMPUTE}}},
+        {"CS_RWTex2D_1.hlsl", {{"TestCS", SHADER_TYPE_COMPUTE}}},
+        {"CS_RWTex2D_2.hlsl", {{"TestCS", SHADER_TYPE_COMPUTE}}},
+        {"CS_RWBuff.hlsl",    {{"TestCS", SHADER_TYPE_COMPUTE}}},
+        {"GS.hlsl",           {{"main",   SHADER_TYPE_GEOMETRY}}},
+    };
+    // clang-format on
+
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    const auto& Converter = HLSL2GLSLConverterImpl::GetInstance();
+
+    double TotalTokenizationTime = 0;
+    double TotalConversionTime   = 0;
+    size_t TotalSourceSize       = 0;
+    for (const auto& Shader : TestShaders)
+    {
+        // Load the source once so that file IO is not included in the measurements
+        RefCntAutoPtr<IFileStream> pSourceStream;
+        pShaderSourceFactory->CreateInputStream(Shader.FileName, &pSourceStream);
+        ASSERT_NE(pSourceStream, nullptr);
+        std::vector<char> Source(pSourceStream->GetSize());
+        ASSERT_TRUE(pSourceStream->Read(Source.data(), Source.size()));
+
+        double TokenizationTime = 0;
+        double ConversionTime   = 0;
+        for (Uint32 i = 0; i < NumIterations; ++i)
+        {
+            Timer T;
+
+            RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+            Converter.CreateStream(Shader.FileName, pShaderSourceFactory, Source.data(), Source.size(), &pStream);
+            ASSERT_NE(pStream, nullptr);
+
+            const auto TokenizationEndTime = T.GetElapsedTime();
+            TokenizationTime += TokenizationEndTime;
+
+            for (const auto& EntryPoint : Shader.EntryPoints)
+            {
+                RefCntAutoPtr<IDataBlob> pGLSLSource;
+                pStream->Convert(EntryPoint.Name, EntryPoint.ShaderType, true, "_sampler", true, &pGLSLSource);
+                ASSERT_NE(pGLSLSource, nullptr) << Shader.FileName << ": " << EntryPoint.Name;
+            }
+            ConversionTime += T.GetElapsedTime() - TokenizationEndTime;
+        }
+
+        const auto NumConversions = NumIterations * Shader.EntryPoints.size();
+        LOG_INFO_MESSAGE(Shader.FileName, " (", Source.size() / 1024.0, " KB): tokenization: ", TokenizationTime * 1000 / NumIterations,
+                         " ms, conversion: ", ConversionTime * 1000 / NumConversions, " ms per entry point");
+
+        TotalTokenizationTime += TokenizationTime;
+        TotalConversionTime += ConversionTime;
+        TotalSourceSize += Source.size() * NumIterations;
+    }
+
+    LOG_INFO_MESSAGE("HLSL2GLSL converter throughput: tokenization: ", TotalSourceSize / (1024.0 * 1024.0) / TotalTokenizationTime,
+                     " MB/s, tokenization and conversion: ", TotalSourceSize / (1024.0 * 1024.0) / (TotalTokenizationTime + TotalConversionTime), " MB/s");
+}
+
+template <size_t NumEntryPoints>
+std::array<RefCntAutoPtr<IDataBlob>, NumEntryPoints> ConvertEntryPoints(IHLSL2GLSLConversionStream* pStream,
+                                                                        const HLSL2GLSLEntryPoint (&EntryPoints)[NumEntryPoints],
+                                                                        Uint32 NumThreads)
+{
+    std::array<IDataBlob*, NumEntryPoints> ppGLSLSources{};
+    pStream->ConvertEntryPoints(EntryPoints, NumEntryPoints, true, "_sampler", true, NumThreads, ppGLSLSources.data());
+
+    std::array<RefCntAutoPtr<IDataBlob>, NumEntryPoints> pGLSLSources;
+    for (size_t i = 0; i < NumEntryPoints; ++i)
+        pGLSLSources[i].Attach(ppGLSLSources[i]);
+    return pGLSLSources;
+}
+
+TEST(HLSL2GLSLConverterTest, ConvertEntryPoints)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+    HLSL2GLSLConverterImpl::GetInstance().CreateStream("VS_PS.hlsl", pShaderSourceFactory, nullptr, 0, &pStream);
+    ASSERT_NE(pStream, nullptr);
+
+    // clang-format off
+    const HLSL2GLSLEntryPoint EntryPoints[] =
+    {
+        {"TestVS",  SHADER_TYPE_VERTEX},
+        {"Missing", SHADER_TYPE_VERTEX},
+        {"TestPS",  SHADER_TYPE_PIXEL}
+    };
+    // clang-format on
+    constexpr Uint32 NumEntryPoints = _countof(EntryPoints);
+
+    // Convert twice to make sure that the stream's tokens are preserved
+    for (Uint32 NumThreads : {1u, 0u})
+    {
+        TestingEnvironment::SetErrorAllowance(1, "\n\nNo worries, testing missing entry point...\n\n");
+
+        auto pGLSLSources = ConvertEntryPoints(pStream, EntryPoints, NumThreads);
+        for (Uint32 i = 0; i < NumEntryPoints; ++i)
+        {
+            const auto& EntryPoint = EntryPoints[i];
+            if (strcmp(EntryPoint.Name, "Missing") == 0)
+            {
+                EXPECT_EQ(pGLSLSources[i], nullptr);
+                continue;
+            }
+
+            ASSERT_NE(pGLSLSources[i], nullptr) << EntryPoint.Name;
+
+            RefCntAutoPtr<IDataBlob> pRefGLSLSource;
+            pStream->Convert(EntryPoint.Name, EntryPoint.ShaderType, true, "_sampler", true, &pRefGLSLSource);
+            ASSERT_NE(pRefGLSLSource, nullptr) << EntryPoint.Name;
+
+            const String GLSLSource{static_cast<const char*>(pGLSLSources[i]->GetConstDataPtr()), pGLSLSources[i]->GetSize()};
+            const String RefGLSLSource{static_cast<const char*>(pRefGLSLSource->GetConstDataPtr()), pRefGLSLSource->GetSize()};
+            EXPECT_EQ(GLSLSource, RefGLSLSource) << EntryPoint.Name;
+        }
+    }
+}
+
+TEST(HLSL2GLSLConverterTest, DISABLED_ConvertEntryPointsBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumIterations = 4;
+#else
+    constexpr Uint32 NumIterations = 64;
+#endif
+
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+    HLSL2GLSLConverterImpl::GetInstance().CreateStream("VS_PS.hlsl", pShaderSourceFactory, nullptr, 0, &pStream);
+    ASSERT_NE(pStream, nullptr);
+
+    // clang-format off
+    const HLSL2GLSLEntryPoint EntryPoints[] =
+    {
+        {"TestVS", SHADER_TYPE_VERTEX},
+        {"TestPS", SHADER_TYPE_PIXEL}
+    };
+    // clang-format on
+    constexpr Uint32 NumEntryPoints = _countof(EntryPoints);
+
+    double SeparateConversionTime = 0;
+    {
+        Timer T;
+        for (Uint32 i = 0; i < NumIterations; ++i)
+        {
+            for (const auto& EntryPoint : EntryPoints)
+            {
+                RefCntAutoPtr<IDataBlob> pGLSLSource;
+                pStream->Convert(EntryPoint.Name, EntryPoint.ShaderType, true, "_sampler", true, &pGLSLSource);
+                ASSERT_NE(pGLSLSource, nullptr) << EntryPoint.Name;
+            }
+        }
+        SeparateConversionTime = T.GetElapsedTime();
+    }
+    LOG_INFO_MESSAGE("Separate conversion of ", NumEntryPoints, " entry points: ", SeparateConversionTime * 1000 / NumIterations, " ms");
+
+    const Uint32 NumHardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (Uint32 NumThreads = 1; NumThreads <= std::min(NumHardwareThreads, NumEntryPoints); NumThreads *= 2)
+    {
+        Timer T;
+        for (Uint32 i = 0; i < NumIterations; ++i)
+        {
+            auto pGLSLSources = ConvertEntryPoints(pStream, EntryPoints, NumThreads);
+            for (Uint32 ep = 0; ep < NumEntryPoints; ++ep)
+                ASSERT_NE(pGLSLSources[ep], nullptr) << EntryPoints[ep].Name;
+        }
+        const auto ConversionTime = T.GetElapsedTime();
+        LOG_INFO_MESSAGE("Single-pass conversion of ", NumEntryPoints, " entry points on ", NumThreads, (NumThreads == 1 ? " thread: " : " threads: "),
+                         ConversionTime * 1000 / NumIterations, " ms (", SeparateConversionTime / ConversionTime, "x speedup)");
+    }
+}
+
 } // namespace
@@ -26,11 +26,23 @@
  */
 
 #include <array>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <unordered_set>
+#include <mutex>
+#include <string>
+#include <cstddef>
 
 #include "DefaultRawMemoryAllocator.hpp"
 #include "FixedBlockMemoryAllocator.hpp"
 #include "FixedLinearAllocator.hpp"
 #include "DynamicLinearAllocator.hpp"
+#include "ConcurrentLinearAllocator.hpp"
+#include "ScratchMemoryAllocator.hpp"
+#include "STDAllocator.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -124,6 +136,163 @@ TEST(Common_FixedBlockMemoryAllocator, UnalignedSize)
     }
 }
 
+TEST(Common_FixedBlockMemoryAllocator, ThreadCaches)
+{
+    constexpr Uint32 AllocSize             = 24;
+    constexpr Uint32 NumAllocationsPerPage = 16;
+    constexpr size_t NumAllocations        = 1000;
+
+    FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, true);
+
+    // Every allocation is filled with its own value to check that allocations do not overlap
+    std::vector<std::pair<void*, Uint8>> Allocations;
+    for (int iter = 0; iter < 3; ++iter)
+    {
+        for (size_t i = 0; i < NumAllocations; ++i)
+        {
+            auto* Ptr = TestAllocator.Allocate(AllocSize, "Fixed block allocator thread cache test", __FILE__, __LINE__);
+            ASSERT_NE(Ptr, nullptr);
+            EXPECT_EQ(reinterpret_cast<size_t>(Ptr) % sizeof(void*), size_t{0});
+            const auto Value = static_cast<Uint8>((i + iter) & 0xFF);
+            memset(Ptr, Value, AllocSize);
+            Allocations.emplace_back(Ptr, Value);
+        }
+
+        std::unordered_set<void*> UniqueAllocations;
+        for (const auto& Allocation : Allocations)
+        {
+            EXPECT_TRUE(UniqueAllocations.insert(Allocation.first).second);
+            const auto* pData = reinterpret_cast<const Uint8*>(Allocation.first);
+            for (Uint32 b = 0; b < AllocSize; ++b)
+                EXPECT_EQ(pData[b], Allocation.second);
+        }
+
+        // Release every other allocation
+        for (size_t i = 0; i < Allocations.size(); i += 2)
+            TestAllocator.Free(Allocations[i].first);
+        for (size_t i = 0; i < Allocations.size() / 2; ++i)
+            Allocations[i] = Allocations[i * 2 + 1];
+        Allocations.resize(Allocations.size() / 2);
+    }
+
+    for (const auto& Allocation : Allocations)
+        TestAllocator.Free(Allocation.first);
+}
+
+TEST(Common_FixedBlockMemoryAllocator, Alignment)
+{
+    constexpr Uint32 NumAllocationsPerPage = 7;
+    constexpr size_t RequiredAlignment     = std::max(alignof(std::max_align_t), size_t{16});
+
+    for (bool EnableThreadCaches : {false, true})
+    {
+        for (size_t AllocSize : {size_t{1}, size_t{8}, size_t{16}, size_t{24}, size_t{40}, size_t{64}, sizeof(float) * 16})
+        {
+            FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, EnableThreadCaches);
+
+            std::vector<void*> Allocations;
+            for (Uint32 i = 0; i < NumAllocationsPerPage * 3; ++i)
+            {
+                auto* Ptr = TestAllocator.Allocate(AllocSize, "Fixed block allocator alignment test", __FILE__, __LINE__);
+                ASSERT_NE(Ptr, nullptr);
+                EXPECT_EQ(reinterpret_cast<size_t>(Ptr) % RequiredAlignment, size_t{0}) << "Allocation size: " << AllocSize;
+                Allocations.push_back(Ptr);
+            }
+            for (auto* Ptr : Allocations)
+                TestAllocator.Free(Ptr);
+        }
+    }
+}
+
+static void TestMultithreadedAllocDealloc(int NumIterations, bool LogTiming)
+{
+    constexpr Uint32 AllocSize                  = 64;
+    constexpr Uint32 NumAllocationsPerPage      = 128;
+    constexpr size_t NumAllocationsPerIteration = 64;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    for (bool EnableThreadCaches : {false, true})
+    {
+        FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, EnableThreadCaches);
+
+        // Blocks that are allocated by one thread and released by another
+        std::vector<std::vector<void*>> SharedAllocations(NumThreads);
+        std::vector<std::thread>        Threads(NumThreads);
+
+        Timer T;
+        for (size_t t = 0; t < Threads.size(); ++t)
+        {
+            Threads[t] = std::thread(
+                [&](size_t ThreadId) //
+                {
+                    FastRandInt        Rnd{static_cast<unsigned int>(ThreadId), 0, static_cast<int>(NumAllocationsPerIteration - 1)};
+                    std::vector<void*> Allocations(NumAllocationsPerIteration);
+                    for (int i = 0; i < NumIterations; ++i)
+                    {
+                        for (auto& Ptr : Allocations)
+                        {
+                            Ptr                             = TestAllocator.Allocate(AllocSize, "Multithreaded allocation test", __FILE__, __LINE__);
+                            *reinterpret_cast<size_t*>(Ptr) = ThreadId;
+                        }
+
+                        for (size_t j = 0; j < Allocations.size(); ++j)
+                            std::swap(Allocations[j], Allocations[Rnd()]);
+
+                        for (auto* Ptr : Allocations)
+                        {
+                            EXPECT_EQ(*reinterpret_cast<size_t*>(Ptr), ThreadId);
+                            TestAllocator.Free(Ptr);
+                        }
+                    }
+
+                    // Leave some blocks to be released by other threads
+                    for (auto& Ptr : Allocations)
+                        Ptr = TestAllocator.Allocate(AllocSize, "Multithreaded allocation test", __FILE__, __LINE__);
+                    SharedAllocations[ThreadId] = std::move(Allocations);
+                },
+                t);
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        for (size_t t = 0; t < Threads.size(); ++t)
+        {
+            Threads[t] = std::thread(
+                [&](size_t ThreadId) //
+                {
+                    for (auto* Ptr : SharedAllocations[(ThreadId + 1) % SharedAllocations.size()])
+                        TestAllocator.Free(Ptr);
+                },
+                t);
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        if (LogTiming)
+        {
+            LOG_INFO_MESSAGE("FixedBlockMemoryAllocator (thread caches ", (EnableThreadCaches ? "enabled" : "disabled"), "): ",
+                             NumThreads * NumIterations * NumAllocationsPerIteration, " allocations on ", NumThreads,
+                             " threads took ", T.GetElapsedTime() * 1000, " ms");
+        }
+    }
+}
+
+TEST(Common_FixedBlockMemoryAllocator, MultithreadedAllocDealloc)
+{
+    TestMultithreadedAllocDealloc(20, false);
+}
+
+TEST(Common_FixedBlockMemoryAllocator, DISABLED_MultithreadedAllocDeallocBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr int NumIterations = 200;
+#else
+    constexpr int    NumIterations     = 2000;
+#endif
+    TestMultithreadedAllocDealloc(NumIterations, true);
+}
+
 TEST(Common_FixedLinearAllocator, EmptyAllocator)
 {
     FixedLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator()};
@@ -229,4 +398,433 @@ TEST(Common_DynamicLinearAllocator, ObjectConstruction)
     EXPECT_TRUE(reinterpret_cast<size_t>(Allocator.Allocate(200, 64)) % 64 == 0);
 }
 
+TEST(Common_ConcurrentLinearAllocator, Allocate)
+{
+    constexpr size_t          ChunkSize = 1024;
+    ConcurrentLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), ChunkSize};
+
+    EXPECT_EQ(Allocator.Allocate(0, 16), nullptr);
+    EXPECT_EQ(Allocator.CopyString(nullptr), nullptr);
+    EXPECT_EQ(Allocator.GetReservedSize(), size_t{0});
+
+    auto RunAllocations = [&]() {
+        std::vector<std::pair<Uint8*, size_t>> Allocations;
+        for (size_t i = 0; i < 256; ++i)
+        {
+            const size_t Size      = 1 + (i * 37) % 100;
+            const size_t Alignment = size_t{1} << (i % 7);
+            auto*        Ptr       = reinterpret_cast<Uint8*>(Allocator.Allocate(Size, Alignment));
+            EXPECT_EQ(Ptr, AlignUp(Ptr, Alignment));
+            memset(Ptr, static_cast<int>(i & 0xFF), Size);
+            Allocations.emplace_back(Ptr, Size);
+        }
+
+        // Large allocation that does not fit into a chunk
+        auto* pLarge = reinterpret_cast<Uint8*>(Allocator.Allocate(ChunkSize * 3, 64));
+        EXPECT_EQ(pLarge, AlignUp(pLarge, 64));
+        memset(pLarge, 0xFF, ChunkSize * 3);
+
+        for (size_t i = 0; i < Allocations.size(); ++i)
+        {
+            for (size_t b = 0; b < Allocations[i].second; ++b)
+                EXPECT_EQ(Allocations[i].first[b], static_cast<Uint8>(i & 0xFF));
+        }
+
+        const auto* Str = Allocator.CopyString("Test string");
+        EXPECT_STREQ(Str, "Test string");
+        EXPECT_STREQ(Allocator.CopyString("Test string", 4), "Test");
+    };
+
+    RunAllocations();
+    const auto ReservedSize = Allocator.GetReservedSize();
+    EXPECT_GE(ReservedSize, ChunkSize * 3);
+
+    // Reset must keep regular chunks and release the large one
+    Allocator.Reset();
+    const auto ReservedSizeAfterReset = Allocator.GetReservedSize();
+    EXPECT_LT(ReservedSizeAfterReset, ReservedSize);
+    EXPECT_EQ(ReservedSizeAfterReset % ChunkSize, size_t{0});
+
+    // Allocations that fill the kept chunks must not request new memory.
+    // Note that alignment padding depends on chunk addresses, so only whole-chunk
+    // allocations are used here.
+    for (size_t i = 0; i < ReservedSizeAfterReset / ChunkSize; ++i)
+    {
+        auto* Ptr = reinterpret_cast<Uint8*>(Allocator.Allocate(ChunkSize, 1));
+        memset(Ptr, 0xCD, ChunkSize);
+    }
+    EXPECT_EQ(Allocator.GetReservedSize(), ReservedSizeAfterReset);
+
+    Allocator.Reset();
+    RunAllocations();
+
+    Allocator.Release();
+    EXPECT_EQ(Allocator.GetReservedSize(), size_t{0});
+}
+
+TEST(Common_ConcurrentLinearAllocator, ThreadContext)
+{
+    constexpr size_t          ChunkSize = 1024;
+    ConcurrentLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), ChunkSize};
+
+    ConcurrentLinearAllocator::ThreadContext Ctx{Allocator};
+
+    EXPECT_EQ(Ctx.Allocate(0, 16), nullptr);
+    EXPECT_EQ(Ctx.CopyString(nullptr), nullptr);
+
+    auto* pUint8  = Ctx.Allocate<Uint8>(3);
+    auto* pUint64 = Ctx.Construct<Uint64>(Uint64{123});
+    EXPECT_EQ(pUint64, AlignUp(pUint64, alignof(Uint64)));
+    EXPECT_EQ(*pUint64, Uint64{123});
+    EXPECT_EQ(reinterpret_cast<Uint8*>(pUint64) - pUint8, 8);
+
+    auto* pArray = Ctx.ConstructArray<Uint32>(10, 7u);
+    for (size_t i = 0; i < 10; ++i)
+        EXPECT_EQ(pArray[i], 7u);
+
+    const Uint32 SrcArray[] = {1, 2, 3};
+    auto*        pCopy      = Ctx.CopyArray(SrcArray, 3);
+    EXPECT_EQ(pCopy[0], 1u);
+    EXPECT_EQ(pCopy[2], 3u);
+
+    EXPECT_STREQ(Ctx.CopyString(String{"Test string"}), "Test string");
+
+    // Large allocation must not replace the current chunk
+    auto* pLarge = Ctx.Allocate(ChunkSize, 16);
+    EXPECT_NE(pLarge, nullptr);
+    auto* pSmall = Ctx.Allocate<Uint8>();
+    EXPECT_LT(pSmall - pUint8, static_cast<ptrdiff_t>(ChunkSize));
+    EXPECT_GT(pSmall - pUint8, 0);
+
+    // Thread context may be used as the backing store of another allocator
+    FixedLinearAllocator FixedAllocator{Ctx};
+    FixedAllocator.AddSpace<Uint64>(4);
+    FixedAllocator.AddSpaceForString("Name");
+    FixedAllocator.Reserve();
+    auto* pFixedData = FixedAllocator.ConstructArray<Uint64>(4, Uint64{5});
+    EXPECT_EQ(pFixedData[3], Uint64{5});
+    EXPECT_STREQ(FixedAllocator.CopyString("Name"), "Name");
+}
+
+TEST(Common_ConcurrentLinearAllocator, Multithreaded)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr size_t NumAllocations = 2000;
+#else
+    constexpr size_t NumAllocations    = 20000;
+#endif
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    ConcurrentLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), 4096};
+
+    for (int iter = 0; iter < 2; ++iter)
+    {
+        std::vector<std::vector<std::pair<Uint8*, size_t>>> Allocations(NumThreads);
+        std::vector<std::thread>                            Threads(NumThreads);
+        for (size_t t = 0; t < Threads.size(); ++t)
+        {
+            Threads[t] = std::thread(
+                [&](size_t ThreadId) //
+                {
+                    ConcurrentLinearAllocator::ThreadContext Ctx{Allocator};
+
+                    FastRandInt Rnd{static_cast<unsigned int>(ThreadId), 1, 300};
+                    auto&       ThreadAllocations = Allocations[ThreadId];
+                    ThreadAllocations.reserve(NumAllocations);
+                    for (size_t i = 0; i < NumAllocations; ++i)
+                    {
+                        const size_t Size = static_cast<size_t>(Rnd());
+                        // Use both the shared allocator and the thread context
+                        auto* Ptr = reinterpret_cast<Uint8*>((i % 2 == 0) ?
+                                                                 Allocator.Allocate(Size, 8) :
+                                                                 Ctx.Allocate(Size, 8));
+                        memset(Ptr, static_cast<int>(ThreadId & 0xFF), Size);
+                        ThreadAllocations.emplace_back(Ptr, Size);
+                    }
+                },
+                t);
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        // Check that allocations do not overlap
+        std::vector<std::pair<Uint8*, size_t>> AllAllocations;
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            for (const auto& Allocation : Allocations[t])
+            {
+                for (size_t b = 0; b < Allocation.second; ++b)
+                {
+                    if (Allocation.first[b] != static_cast<Uint8>(t & 0xFF))
+                    {
+                        ADD_FAILURE() << "Allocation data has been overwritten";
+                        break;
+                    }
+                }
+                AllAllocations.push_back(Allocation);
+            }
+        }
+        std::sort(AllAllocations.begin(), AllAllocations.end());
+        for (size_t i = 1; i < AllAllocations.size(); ++i)
+        {
+            EXPECT_LE(AllAllocations[i - 1].first + AllAllocations[i - 1].second, AllAllocations[i].first);
+        }
+
+        Allocator.Reset();
+    }
+}
+
+TEST(Common_ConcurrentLinearAllocator, DISABLED_ParallelDescriptionCopyBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr size_t NumDescsPerThread = 200;
+#else
+    constexpr size_t NumDescsPerThread = 20000;
+#endif
+    constexpr size_t NumResources = 16;
+
+    // Emulates pipeline resource signature description
+    struct ResourceDesc
+    {
+        const char* Name;
+        Uint32      ShaderStages;
+        Uint32      ArraySize;
+    };
+
+    std::vector<std::string> ResourceNames(NumResources);
+    for (size_t i = 0; i < NumResources; ++i)
+        ResourceNames[i] = "g_ShaderResource" + std::to_string(i);
+
+    std::vector<ResourceDesc> SrcResources(NumResources);
+    for (size_t i = 0; i < NumResources; ++i)
+        SrcResources[i] = {ResourceNames[i].c_str(), 1u << (i % 6), 1};
+
+    // Copies the description the same way as PipelineResourceSignatureBase does
+    auto CopyDescription = [&](IMemoryAllocator& RawAllocator) {
+        FixedLinearAllocator MemPool{RawAllocator};
+        MemPool.AddSpaceForString("Pipeline resource signature");
+        MemPool.AddSpace<ResourceDesc>(NumResources);
+        for (const auto& Res : SrcResources)
+            MemPool.AddSpaceForString(Res.Name);
+        MemPool.Reserve();
+
+        auto* Name       = MemPool.CopyString("Pipeline resource signature");
+        auto* pResources = MemPool.CopyArray(SrcResources.data(), NumResources);
+        for (size_t i = 0; i < NumResources; ++i)
+            pResources[i].Name = MemPool.CopyString(SrcResources[i].Name);
+        VERIFY_EXPR(Name != nullptr);
+        return MemPool.ReleaseOwnership();
+    };
+
+    // Emulates a single-threaded arena shared between threads
+    class LockedLinearAllocator final : public IMemoryAllocator
+    {
+    public:
+        LockedLinearAllocator() :
+            m_Allocator{DefaultRawMemoryAllocator::GetAllocator(), 64 << 10}
+        {}
+
+        virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            return m_Allocator.Allocate(Size, alignof(std::max_align_t));
+        }
+        virtual void Free(void* Ptr) override final {}
+
+    private:
+        std::mutex             m_Mtx;
+        DynamicLinearAllocator m_Allocator;
+    };
+
+    enum ALLOCATOR_TYPE
+    {
+        ALLOCATOR_TYPE_RAW,
+        ALLOCATOR_TYPE_LOCKED_ARENA,
+        ALLOCATOR_TYPE_CONCURRENT_ARENA
+    };
+
+    auto RunBenchmark = [&](Uint32 NumThreads, ALLOCATOR_TYPE Type) {
+        auto&                     RawAllocator = DefaultRawMemoryAllocator::GetAllocator();
+        LockedLinearAllocator     LockedArena;
+        ConcurrentLinearAllocator ConcurrentArena{RawAllocator};
+
+        std::vector<std::vector<void*>> Descs(NumThreads);
+        std::vector<std::thread>        Threads(NumThreads);
+
+        Timer T;
+        for (size_t t = 0; t < Threads.size(); ++t)
+        {
+            Threads[t] = std::thread(
+                [&](size_t ThreadId) //
+                {
+                    ConcurrentLinearAllocator::ThreadContext Ctx{ConcurrentArena};
+
+                    IMemoryAllocator* pAllocator = nullptr;
+                    switch (Type)
+                    {
+                        case ALLOCATOR_TYPE_RAW: pAllocator = &RawAllocator; break;
+                        case ALLOCATOR_TYPE_LOCKED_ARENA: pAllocator = &LockedArena; break;
+                        case ALLOCATOR_TYPE_CONCURRENT_ARENA: pAllocator = &Ctx; break;
+                    }
+
+                    auto& ThreadDescs = Descs[ThreadId];
+                    ThreadDescs.resize(NumDescsPerThread);
+                    for (auto& pDesc : ThreadDescs)
+                        pDesc = CopyDescription(*pAllocator);
+                },
+                t);
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        // Release all descriptions at once
+        if (Type == ALLOCATOR_TYPE_RAW)
+        {
+            for (auto& ThreadDescs : Descs)
+            {
+                for (auto* pDesc : ThreadDescs)
+                    RawAllocator.Free(pDesc);
+            }
+        }
+        ConcurrentArena.Reset();
+        return T.GetElapsedTime() * 1000;
+    };
+
+    for (Uint32 NumThreads : {1u, 2u, std::max(std::thread::hardware_concurrency(), 4u)})
+    {
+        const auto RawTime        = RunBenchmark(NumThreads, ALLOCATOR_TYPE_RAW);
+        const auto LockedTime     = RunBenchmark(NumThreads, ALLOCATOR_TYPE_LOCKED_ARENA);
+        const auto ConcurrentTime = RunBenchmark(NumThreads, ALLOCATOR_TYPE_CONCURRENT_ARENA);
+        LOG_INFO_MESSAGE("Copying ", NumDescsPerThread * NumThreads, " descriptions on ", NumThreads, " threads: raw allocator: ", RawTime,
+                         " ms, locked arena: ", LockedTime, " ms, concurrent arena: ", ConcurrentTime, " ms");
+    }
+}
+
+TEST(Common_ScratchMemoryAllocator, Allocate)
+{
+    constexpr size_t       PageSize = 1024;
+    ScratchMemoryAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), PageSize};
+
+    EXPECT_EQ(Allocator.Allocate(0, "Empty allocation", __FILE__, __LINE__), nullptr);
+
+    auto* Ptr0 = Allocator.Allocate(10, "Scratch allocation", __FILE__, __LINE__);
+    auto* Ptr1 = Allocator.Allocate(10, "Scratch allocation", __FILE__, __LINE__);
+    EXPECT_EQ(Ptr0, AlignUp(Ptr0, alignof(std::max_align_t)));
+    EXPECT_EQ(Ptr1, AlignUp(Ptr1, alignof(std::max_align_t)));
+    EXPECT_NE(Ptr0, Ptr1);
+
+    // The last allocation is reclaimed immediately
+    Allocator.Free(Ptr1);
+    EXPECT_EQ(Allocator.Allocate(10, "Scratch allocation", __FILE__, __LINE__), Ptr1);
+    Allocator.Free(Ptr1);
+    Allocator.Free(Ptr0);
+
+    EXPECT_EQ(Allocator.GetFrameStats().NumAllocations, 3u);
+    EXPECT_EQ(Allocator.GetFrameStats().NumFrees, 3u);
+    EXPECT_EQ(Allocator.GetReservedSize(), PageSize);
+
+    Allocator.Reset();
+    EXPECT_EQ(Allocator.GetLastFrameStats().NumAllocations, 3u);
+    EXPECT_EQ(Allocator.GetFrameStats().NumAllocations, 0u);
+}
+
+TEST(Common_ScratchMemoryAllocator, NestedFree)
+{
+    constexpr size_t       PageSize = 1024;
+    ScratchMemoryAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), PageSize};
+
+    auto* Ptr0 = Allocator.Allocate(16, "Scratch allocation", __FILE__, __LINE__);
+    auto* Ptr1 = Allocator.Allocate(16, "Scratch allocation", __FILE__, __LINE__);
+    auto* Ptr2 = Allocator.Allocate(16, "Scratch allocation", __FILE__, __LINE__);
+
+    // Released allocations below the top of the stack are not reclaimed yet
+    Allocator.Free(Ptr0);
+    Allocator.Free(Ptr1);
+    auto* Ptr3 = Allocator.Allocate(16, "Scratch allocation", __FILE__, __LINE__);
+    EXPECT_NE(Ptr3, Ptr0);
+    EXPECT_NE(Ptr3, Ptr1);
+
+    // Releasing the top allocation reclaims all released allocations below it
+    Allocator.Free(Ptr3);
+    Allocator.Free(Ptr2);
+    auto* Ptr4 = Allocator.Allocate(16, "Scratch allocation", __FILE__, __LINE__);
+    EXPECT_EQ(Ptr4, Ptr0);
+    Allocator.Free(Ptr4);
+
+    // Two vectors that grow in turns
+    {
+        using ScratchVector = std::vector<Uint32, STDAllocator<Uint32, ScratchMemoryAllocator>>;
+        ScratchVector Vec0(STD_ALLOCATOR(Uint32, ScratchMemoryAllocator, Allocator, "Scratch vector 0"));
+        ScratchVector Vec1(STD_ALLOCATOR(Uint32, ScratchMemoryAllocator, Allocator, "Scratch vector 1"));
+        for (Uint32 i = 0; i < 100; ++i)
+        {
+            Vec0.push_back(i);
+            Vec1.push_back(i);
+        }
+    }
+    // All memory is reclaimed when both vectors are destroyed
+    auto* Ptr5 = Allocator.Allocate(16, "Scratch allocation", __FILE__, __LINE__);
+    EXPECT_EQ(Ptr5, Ptr0);
+    Allocator.Free(Ptr5);
+
+    // Allocations that span several pages
+    auto* Ptr6 = Allocator.Allocate(PageSize / 2, "Scratch allocation", __FILE__, __LINE__);
+    auto* Ptr7 = Allocator.Allocate(PageSize, "Scratch allocation", __FILE__, __LINE__);
+    EXPECT_EQ(Ptr6, Ptr0);
+    Allocator.Free(Ptr6);
+    Allocator.Free(Ptr7);
+    auto* Ptr8 = Allocator.Allocate(16, "Scratch allocation", __FILE__, __LINE__);
+    EXPECT_EQ(Ptr8, Ptr0);
+    Allocator.Free(Ptr8);
+
+    EXPECT_EQ(Allocator.GetFrameStats().NumAllocations, Allocator.GetFrameStats().NumFrees);
+    Allocator.Reset();
+}
+
+TEST(Common_ScratchMemoryAllocator, STDContainers)
+{
+    constexpr size_t       PageSize = 1024;
+    ScratchMemoryAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), PageSize};
+
+    using ScratchString = std::basic_string<char, std::char_traits<char>, STDAllocator<char, ScratchMemoryAllocator>>;
+
+    size_t ReservedSize = 0;
+    for (Uint32 frame = 0; frame < 3; ++frame)
+    {
+        {
+            std::vector<Uint32, STDAllocator<Uint32, ScratchMemoryAllocator>> Vec(STD_ALLOCATOR(Uint32, ScratchMemoryAllocator, Allocator, "Scratch vector"));
+            for (Uint32 i = 0; i < 1000; ++i)
+                Vec.push_back(i);
+            for (Uint32 i = 0; i < 1000; ++i)
+                EXPECT_EQ(Vec[i], i);
+
+            ScratchString Str("Scratch string that does not fit into the small string buffer", STD_ALLOCATOR(char, ScratchMemoryAllocator, Allocator, "Scratch string"));
+            Str.append(" (test)");
+            EXPECT_STREQ(Str.c_str(), "Scratch string that does not fit into the small string buffer (test)");
+        }
+
+        EXPECT_EQ(Allocator.GetFrameStats().NumAllocations, Allocator.GetFrameStats().NumFrees);
+        EXPECT_GT(Allocator.GetFrameStats().NumAllocations, 1u);
+        Allocator.Reset();
+
+        // After the first frame, all pages are merged into one and no new pages are added
+        if (frame == 0)
+            ReservedSize = Allocator.GetReservedSize();
+        else
+        {
+            EXPECT_EQ(Allocator.GetReservedSize(), ReservedSize);
+        }
+    }
+
+    // Memory used by the frame must fit into a single page now
+    {
+        std::vector<Uint32, STDAllocator<Uint32, ScratchMemoryAllocator>> Vec(STD_ALLOCATOR(Uint32, ScratchMemoryAllocator, Allocator, "Scratch vector"));
+        for (Uint32 i = 0; i < 1000; ++i)
+            Vec.push_back(i);
+    }
+    Allocator.Reset();
+    EXPECT_EQ(Allocator.GetReservedSize(), ReservedSize);
+}
+
 } // namespace
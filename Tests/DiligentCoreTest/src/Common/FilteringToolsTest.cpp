@@ -27,6 +27,12 @@
 
 #include "FilteringTools.hpp"
 
+#include <cmath>
+#include <vector>
+
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
 #include "gtest/gtest.h"
 
 using namespace Diligent;
@@ -143,6 +149,19 @@ TEST(Common_AdvancedMath, GetLinearTexFilterSampleInfo)
     TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR>(256.00f, 0, 0, 0.50f);
     TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR>(257.00f, 0, 1, 0.50f);
     TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR>(258.00f, 1, 2, 0.50f);
+
+    // TEXTURE_ADDRESS_MIRROR_ONCE
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE>(0.f, 0, 0, 0.5f);
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE>(1.f, 0, 1, 0.5f);
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE>(-1.f, 1, 0, 0.5f);
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE>(-2.f, 2, 1, 0.5f);
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE>(-200.f, 127, 127, 0.5f);
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE>(128.f, 127, 127, 0.5f);
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_MIRROR_ONCE>(129.f, 127, 127, 0.5f);
+
+    // TEXTURE_ADDRESS_UNKNOWN
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_UNKNOWN>(0.f, -1, 0, 0.5f);
+    TestGetLinearTexFilterSampleInfo<TEXTURE_ADDRESS_UNKNOWN>(128.f, 127, 128, 0.5f);
 }
 
 template <TEXTURE_ADDRESS_MODE AddressMode>
@@ -292,4 +311,192 @@ TEST(Common_FilteringTools, FilterTexture2DBilinear)
     }
 }
 
+// Reference implementation of ResampleImageBilinear that filters every pixel individually
+template <typename ComponentType>
+std::vector<ComponentType> ResampleImageReference(const ResampleImageAttribs& Attribs)
+{
+    // Indices outside of the image refer to the border color
+    auto GetTableAddressMode = [](TEXTURE_ADDRESS_MODE AddressMode) {
+        return AddressMode == TEXTURE_ADDRESS_BORDER ? TEXTURE_ADDRESS_UNKNOWN : AddressMode;
+    };
+
+    std::vector<LinearTexFilterSampleInfo> UInfo(Attribs.DstWidth), VInfo(Attribs.DstHeight);
+    GetLinearTexFilterSampleInfoTable(GetTableAddressMode(Attribs.AddressModeU), Attribs.SrcWidth, Attribs.DstWidth, UInfo.data());
+    GetLinearTexFilterSampleInfoTable(GetTableAddressMode(Attribs.AddressModeV), Attribs.SrcHeight, Attribs.DstHeight, VInfo.data());
+
+    const auto NumComps = Attribs.NumComponents;
+
+    std::vector<ComponentType> Dst(size_t{Attribs.DstWidth} * Attribs.DstHeight * NumComps);
+    for (Uint32 y = 0; y < Attribs.DstHeight; ++y)
+    {
+        for (Uint32 x = 0; x < Attribs.DstWidth; ++x)
+        {
+            for (Uint32 c = 0; c < NumComps; ++c)
+            {
+                auto Fetch = [&](Int32 i, Int32 j) {
+                    if (i < 0 || i >= static_cast<Int32>(Attribs.SrcWidth) || j < 0 || j >= static_cast<Int32>(Attribs.SrcHeight))
+                        return Attribs.BorderColor[c];
+                    const auto* pRow = reinterpret_cast<const ComponentType*>(static_cast<const Uint8*>(Attribs.pSrcData) + j * Attribs.SrcStride);
+                    return static_cast<float>(pRow[i * NumComps + c]);
+                };
+
+                const auto& u = UInfo[x];
+                const auto& v = VInfo[y];
+
+                const auto Val = lerp(lerp(Fetch(u.i0, v.i0), Fetch(u.i1, v.i0), u.w),
+                                      lerp(Fetch(u.i0, v.i1), Fetch(u.i1, v.i1), u.w),
+                                      v.w);
+
+                auto& DstVal = Dst[(size_t{y} * Attribs.DstWidth + x) * NumComps + c];
+                if (std::is_same<ComponentType, float>::value)
+                    DstVal = static_cast<ComponentType>(Val);
+                else
+                    DstVal = static_cast<ComponentType>(clamp(std::lrint(Val), 0l, static_cast<long>(std::numeric_limits<ComponentType>::max())));
+            }
+        }
+    }
+    return Dst;
+}
+
+template <typename ComponentType>
+void TestResampleImage(VALUE_TYPE           ValueType,
+                       Uint32               NumComponents,
+                       Uint32               SrcWidth,
+                       Uint32               SrcHeight,
+                       Uint32               DstWidth,
+                       Uint32               DstHeight,
+                       TEXTURE_ADDRESS_MODE AddressModeU,
+                       TEXTURE_ADDRESS_MODE AddressModeV,
+                       Uint32               NumThreads)
+{
+    FastRandInt Rnd{0, 0, 255};
+
+    // Use padded source rows
+    const size_t               SrcRowSize = size_t{SrcWidth} * NumComponents + 3;
+    std::vector<ComponentType> Src(SrcRowSize * SrcHeight);
+    for (auto& Val : Src)
+        Val = static_cast<ComponentType>(Rnd());
+
+    std::vector<ComponentType> Dst(size_t{DstWidth} * DstHeight * NumComponents);
+
+    ResampleImageAttribs Attribs;
+    Attribs.SrcWidth       = SrcWidth;
+    Attribs.SrcHeight      = SrcHeight;
+    Attribs.pSrcData       = Src.data();
+    Attribs.SrcStride      = SrcRowSize * sizeof(ComponentType);
+    Attribs.DstWidth       = DstWidth;
+    Attribs.DstHeight      = DstHeight;
+    Attribs.pDstData       = Dst.data();
+    Attribs.DstStride      = size_t{DstWidth} * NumComponents * sizeof(ComponentType);
+    Attribs.ComponentType  = ValueType;
+    Attribs.NumComponents  = NumComponents;
+    Attribs.AddressModeU   = AddressModeU;
+    Attribs.AddressModeV   = AddressModeV;
+    Attribs.BorderColor[0] = 10;
+    Attribs.BorderColor[1] = 20;
+    Attribs.BorderColor[2] = 30;
+    Attribs.BorderColor[3] = 40;
+    Attribs.NumThreads     = NumThreads;
+    ResampleImageBilinear(Attribs);
+
+    const auto Ref = ResampleImageReference<ComponentType>(Attribs);
+    for (size_t i = 0; i < Dst.size(); ++i)
+    {
+        // Allow the difference of one for integer values since the rounding of
+        // the two implementations may differ due to floating-point contraction.
+        const auto Tolerance = std::is_same<ComponentType, float>::value ? std::max(std::abs(static_cast<float>(Ref[i])) * 1e-6f, 1e-6f) : 1.f;
+        ASSERT_NEAR(static_cast<float>(Dst[i]), static_cast<float>(Ref[i]), Tolerance)
+            << "Element " << i << ", " << SrcWidth << "x" << SrcHeight << " -> " << DstWidth << "x" << DstHeight;
+    }
+}
+
+TEST(Common_FilteringTools, ResampleImageBilinear)
+{
+    // clang-format off
+    const TEXTURE_ADDRESS_MODE AddressModes[][2] =
+    {
+        {TEXTURE_ADDRESS_CLAMP,       TEXTURE_ADDRESS_CLAMP},
+        {TEXTURE_ADDRESS_WRAP,        TEXTURE_ADDRESS_MIRROR},
+        {TEXTURE_ADDRESS_MIRROR_ONCE, TEXTURE_ADDRESS_WRAP},
+        {TEXTURE_ADDRESS_BORDER,      TEXTURE_ADDRESS_BORDER},
+    };
+    // clang-format on
+    for (const auto& Modes : AddressModes)
+    {
+        for (Uint32 NumComponents = 1; NumComponents <= 4; ++NumComponents)
+        {
+            // Upscale, downscale and anisotropic scale
+            TestResampleImage<float>(VT_FLOAT32, NumComponents, 37, 23, 100, 61, Modes[0], Modes[1], 1);
+            TestResampleImage<float>(VT_FLOAT32, NumComponents, 100, 61, 37, 23, Modes[0], Modes[1], 1);
+            TestResampleImage<Uint8>(VT_UINT8, NumComponents, 64, 64, 17, 130, Modes[0], Modes[1], 1);
+            TestResampleImage<Uint16>(VT_UINT16, NumComponents, 31, 45, 64, 17, Modes[0], Modes[1], 1);
+            // Multiple threads
+            TestResampleImage<Uint8>(VT_UINT8, NumComponents, 50, 70, 91, 133, Modes[0], Modes[1], 3);
+        }
+    }
+}
+
+TEST(Common_FilteringTools, DISABLED_ResampleImageBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 SrcSize = 256;
+    constexpr Uint32 DstSize = 384;
+#else
+    constexpr Uint32 SrcSize = 1024;
+    constexpr Uint32 DstSize = 1536;
+#endif
+
+    FastRandFloat       Rnd{0, 0, 1};
+    std::vector<float4> Src(SrcSize * SrcSize);
+    for (auto& Texel : Src)
+        Texel = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+
+    std::vector<float4> Ref(DstSize * DstSize), Dst(DstSize * DstSize);
+
+    Timer T;
+    for (Uint32 y = 0; y < DstSize; ++y)
+    {
+        for (Uint32 x = 0; x < DstSize; ++x)
+        {
+            const auto u = (static_cast<float>(x) + 0.5f) / static_cast<float>(DstSize);
+            const auto v = (static_cast<float>(y) + 0.5f) / static_cast<float>(DstSize);
+
+            Ref[x + y * DstSize] = FilterTexture2DBilinearClamp<float4, float4>(SrcSize, SrcSize, Src.data(), SrcSize, u, v);
+        }
+    }
+    const auto PerPixelTime = T.GetElapsedTime() * 1000;
+
+    ResampleImageAttribs Attribs;
+    Attribs.SrcWidth      = SrcSize;
+    Attribs.SrcHeight     = SrcSize;
+    Attribs.pSrcData      = Src.data();
+    Attribs.SrcStride     = SrcSize * sizeof(float4);
+    Attribs.DstWidth      = DstSize;
+    Attribs.DstHeight     = DstSize;
+    Attribs.pDstData      = Dst.data();
+    Attribs.DstStride     = DstSize * sizeof(float4);
+    Attribs.ComponentType = VT_FLOAT32;
+    Attribs.NumComponents = 4;
+    Attribs.NumThreads    = 1;
+
+    T.Restart();
+    ResampleImageBilinear(Attribs);
+    const auto ResampleTime = T.GetElapsedTime() * 1000;
+
+    Attribs.NumThreads = 0;
+    T.Restart();
+    ResampleImageBilinear(Attribs);
+    const auto ResampleMTTime = T.GetElapsedTime() * 1000;
+
+    for (size_t i = 0; i < Dst.size(); ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+            ASSERT_NEAR(Dst[i][c], Ref[i][c], 1e-6f);
+    }
+
+    LOG_INFO_MESSAGE("Bilinear resampling of RGBA32F image ", SrcSize, "x", SrcSize, " -> ", DstSize, "x", DstSize,
+                     ": FilterTexture2DBilinear: ", PerPixelTime, " ms, ResampleImageBilinear: ", ResampleTime,
+                     " ms, ResampleImageBilinear (all threads): ", ResampleMTTime, " ms");
+}
+
 } // namespace
@@ -0,0 +1,371 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "FlatHashMap.hpp"
+#include "STDAllocator.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_FlatHashMap, Basic)
+{
+    FlatHashMap<int, std::string> Map;
+    EXPECT_TRUE(Map.empty());
+    EXPECT_EQ(Map.size(), size_t{0});
+    EXPECT_EQ(Map.begin(), Map.end());
+    EXPECT_EQ(Map.find(1), Map.end());
+    EXPECT_EQ(Map.count(1), size_t{0});
+    EXPECT_EQ(Map.erase(1), size_t{0});
+
+    auto Res = Map.emplace(1, "One");
+    EXPECT_TRUE(Res.second);
+    EXPECT_EQ(Res.first->first, 1);
+    EXPECT_EQ(Res.first->second, "One");
+
+    Res = Map.emplace(1, "Uno");
+    EXPECT_FALSE(Res.second);
+    EXPECT_EQ(Res.first->second, "One");
+
+    Res = Map.try_emplace(2, "Two");
+    EXPECT_TRUE(Res.second);
+    Res = Map.insert(std::make_pair(3, "Three"));
+    EXPECT_TRUE(Res.second);
+    Map[4] = "Four";
+    EXPECT_EQ(Map[4], "Four");
+    EXPECT_EQ(Map.size(), size_t{4});
+
+    EXPECT_EQ(Map.count(3), size_t{1});
+    auto It = Map.find(3);
+    ASSERT_NE(It, Map.end());
+    EXPECT_EQ(It->second, "Three");
+
+    size_t NumElements = 0;
+    int    KeySum      = 0;
+    for (const auto& Elem : Map)
+    {
+        KeySum += Elem.first;
+        ++NumElements;
+    }
+    EXPECT_EQ(NumElements, Map.size());
+    EXPECT_EQ(KeySum, 1 + 2 + 3 + 4);
+
+    EXPECT_EQ(Map.erase(2), size_t{1});
+    EXPECT_EQ(Map.erase(2), size_t{0});
+    EXPECT_EQ(Map.find(2), Map.end());
+    EXPECT_EQ(Map.size(), size_t{3});
+
+    It = Map.erase(Map.find(1));
+    EXPECT_EQ(Map.size(), size_t{2});
+    EXPECT_EQ(Map.find(1), Map.end());
+
+    const auto& ConstMap = Map;
+    auto        ConstIt  = ConstMap.find(4);
+    ASSERT_NE(ConstIt, ConstMap.end());
+    EXPECT_EQ(ConstIt->second, "Four");
+
+    const auto Capacity = Map.capacity();
+    Map.clear();
+    EXPECT_TRUE(Map.empty());
+    EXPECT_EQ(Map.capacity(), Capacity);
+    EXPECT_EQ(Map.begin(), Map.end());
+    EXPECT_EQ(Map.find(4), Map.end());
+
+    Map.reserve(1000);
+    const auto ReservedCapacity = Map.capacity();
+    EXPECT_GE(ReservedCapacity, size_t{1000});
+    for (int i = 0; i < 1000; ++i)
+        Map.emplace(i, std::to_string(i));
+    EXPECT_EQ(Map.capacity(), ReservedCapacity);
+
+    FlatHashMap<int, std::string> Map2{std::move(Map)};
+    EXPECT_TRUE(Map.empty());
+    EXPECT_EQ(Map2.size(), size_t{1000});
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto it = Map2.find(i);
+        ASSERT_NE(it, Map2.end());
+        EXPECT_EQ(it->second, std::to_string(i));
+    }
+}
+
+TEST(Common_FlatHashMap, EraseWhileIterating)
+{
+    FlatHashMap<int, int> Map;
+    for (int i = 0; i < 1000; ++i)
+        Map.emplace(i, i);
+
+    // Erasing must not move other elements
+    for (auto It = Map.begin(); It != Map.end();)
+    {
+        if (It->first % 3 == 0)
+            It = Map.erase(It);
+        else
+            ++It;
+    }
+    EXPECT_EQ(Map.size(), size_t{666});
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(Map.count(i), i % 3 == 0 ? size_t{0} : size_t{1});
+}
+
+TEST(Common_FlatHashMap, MoveOnlyKeys)
+{
+    FlatHashMap<HashMapStringKey, std::unique_ptr<int>, HashMapStringKey::Hasher, HashMapStringKey::Equal> Map;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        auto Res = Map.emplace(HashMapStringKey{"Key" + std::to_string(i)}, std::unique_ptr<int>{new int{i}});
+        EXPECT_TRUE(Res.second);
+    }
+    Map.emplace("StaticKey", std::unique_ptr<int>{new int{-1}});
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto Str = "Key" + std::to_string(i);
+
+        // Heterogeneous lookup
+        auto It = Map.find(Str.c_str());
+        ASSERT_NE(It, Map.end());
+        EXPECT_EQ(*It->second, i);
+        EXPECT_STREQ(It->first.GetStr(), Str.c_str());
+        EXPECT_NE(It->first.GetStr(), Str.c_str());
+
+        EXPECT_EQ(Map.find(HashMapStringKey{Str.c_str()}), It);
+    }
+
+    auto It = Map.find("StaticKey");
+    ASSERT_NE(It, Map.end());
+    EXPECT_EQ(*It->second, -1);
+    EXPECT_EQ(Map.count("Key200"), size_t{0});
+}
+
+TEST(Common_FlatHashMap, RawMemAllocator)
+{
+    using ElemType = std::pair<const std::string, int>;
+    FlatHashMap<std::string, int, std::hash<std::string>, std::equal_to<std::string>, STDAllocatorRawMem<ElemType>> Map{
+        STD_ALLOCATOR_RAW_MEM(ElemType, DefaultRawMemoryAllocator::GetAllocator(), "Allocator for FlatHashMap<std::string, int>")};
+
+    for (int i = 0; i < 100; ++i)
+        Map.emplace(std::to_string(i), i);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(Map[std::to_string(i)], i);
+}
+
+TEST(Common_FlatHashMap, Collisions)
+{
+    struct BadHasher
+    {
+        size_t operator()(int Val) const
+        {
+            return static_cast<size_t>(Val & 0x03);
+        }
+    };
+
+    FlatHashMap<int, int, BadHasher> Map;
+    for (int i = 0; i < 100; ++i)
+        Map.emplace(i, i * 2);
+    for (int i = 0; i < 100; i += 2)
+        Map.erase(i);
+    for (int i = 0; i < 100; ++i)
+    {
+        auto It = Map.find(i);
+        if (i % 2 == 0)
+        {
+            EXPECT_EQ(It, Map.end());
+        }
+        else
+        {
+            ASSERT_NE(It, Map.end());
+            EXPECT_EQ(It->second, i * 2);
+        }
+    }
+}
+
+TEST(Common_FlatHashMap, MaxLoadFactor)
+{
+    FlatHashMap<int, int> Map;
+    for (int i = 0; i < 100; ++i)
+        Map.emplace(i, i);
+    EXPECT_LE(Map.size(), Map.capacity() * 7 / 8);
+    const auto DefaultCapacity = Map.capacity();
+
+    Map.max_load_factor(0.5f);
+    EXPECT_EQ(Map.max_load_factor(), 0.5f);
+    EXPECT_LE(Map.size(), Map.capacity() / 2);
+    EXPECT_GT(Map.capacity(), DefaultCapacity);
+    for (int i = 100; i < 1000; ++i)
+        Map.emplace(i, i);
+    EXPECT_LE(Map.size(), Map.capacity() / 2);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(Map[i], i);
+
+    // The table must always have empty slots
+    Map.max_load_factor(1.f);
+    EXPECT_EQ(Map.max_load_factor(), 0.875f);
+    Map.max_load_factor(0.01f);
+    EXPECT_EQ(Map.max_load_factor(), 0.25f);
+    EXPECT_LE(Map.size(), Map.capacity() / 4);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(Map[i], i);
+}
+
+TEST(Common_FlatHashMap, Random)
+{
+    FlatHashMap<int, int>        Map;
+    std::unordered_map<int, int> RefMap;
+
+    FastRandInt Rnd{0, 0, 2047};
+    for (int i = 0; i < 100000; ++i)
+    {
+        const auto Key = Rnd();
+        const auto Op  = Rnd() % 3;
+        if (Op == 0)
+        {
+            EXPECT_EQ(Map.erase(Key), RefMap.erase(Key));
+        }
+        else if (Op == 1)
+        {
+            EXPECT_EQ(Map.emplace(Key, i).second, RefMap.emplace(Key, i).second);
+        }
+        else
+        {
+            auto It    = Map.find(Key);
+            auto RefIt = RefMap.find(Key);
+            ASSERT_EQ(It != Map.end(), RefIt != RefMap.end());
+            if (RefIt != RefMap.end())
+            {
+                EXPECT_EQ(It->second, RefIt->second);
+            }
+        }
+    }
+
+    // Tombstones must not cause unbounded growth
+    EXPECT_LE(Map.capacity(), size_t{8192});
+
+    EXPECT_EQ(Map.size(), RefMap.size());
+    size_t NumElements = 0;
+    for (const auto& Elem : Map)
+    {
+        auto RefIt = RefMap.find(Elem.first);
+        ASSERT_NE(RefIt, RefMap.end());
+        EXPECT_EQ(Elem.second, RefIt->second);
+        ++NumElements;
+    }
+    EXPECT_EQ(NumElements, RefMap.size());
+}
+
+
+template <typename MapType, typename KeyType>
+void RunMapBenchmark(const char* MapName, const std::vector<KeyType>& Keys, const std::vector<KeyType>& MissingKeys, size_t NumIterations)
+{
+    Timer T;
+
+    size_t Checksum  = 0;
+    auto   StartTime = T.GetElapsedTime();
+    for (size_t it = 0; it < NumIterations; ++it)
+    {
+        MapType Map;
+        for (size_t i = 0; i < Keys.size(); ++i)
+            Map.emplace(Keys[i], i);
+        Checksum += Map.size();
+    }
+    const auto InsertTime = T.GetElapsedTime() - StartTime;
+
+    MapType Map;
+    for (size_t i = 0; i < Keys.size(); ++i)
+        Map.emplace(Keys[i], i);
+
+    StartTime = T.GetElapsedTime();
+    for (size_t it = 0; it < NumIterations; ++it)
+    {
+        for (const auto& Key : Keys)
+            Checksum += Map.find(Key)->second;
+    }
+    const auto HitTime = T.GetElapsedTime() - StartTime;
+
+    StartTime = T.GetElapsedTime();
+    for (size_t it = 0; it < NumIterations; ++it)
+    {
+        for (const auto& Key : MissingKeys)
+            Checksum += Map.find(Key) == Map.end() ? 0 : 1;
+    }
+    const auto MissTime = T.GetElapsedTime() - StartTime;
+
+    const auto NumOps = static_cast<double>(NumIterations * Keys.size());
+    LOG_INFO_MESSAGE(MapName, ": insert: ", InsertTime / NumOps * 1e9, " ns, successful lookup: ", HitTime / NumOps * 1e9,
+                     " ns, failed lookup: ", MissTime / NumOps * 1e9, " ns. Checksum: ", Checksum);
+}
+
+TEST(Common_FlatHashMap, DISABLED_Benchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr size_t NumIterations = 10;
+#else
+    constexpr size_t NumIterations = 200;
+#endif
+    constexpr int NumKeys = 10000;
+
+    {
+        std::vector<Uint64> Keys, MissingKeys;
+        for (int i = 0; i < NumKeys; ++i)
+        {
+            // Pointer-like keys
+            Keys.push_back(0x10000000ull + Uint64{static_cast<Uint32>(i)} * 64);
+            MissingKeys.push_back(0x10000000ull + Uint64{static_cast<Uint32>(i)} * 64 + 32);
+        }
+        RunMapBenchmark<std::unordered_map<Uint64, size_t>>("std::unordered_map<Uint64>", Keys, MissingKeys, NumIterations);
+        RunMapBenchmark<FlatHashMap<Uint64, size_t>>("FlatHashMap<Uint64>       ", Keys, MissingKeys, NumIterations);
+    }
+
+    {
+        std::vector<std::string> Names;
+        for (int i = 0; i < NumKeys * 2; ++i)
+            Names.emplace_back("g_ResourceName_" + std::to_string(i));
+
+        std::vector<const char*> Keys, MissingKeys;
+        for (int i = 0; i < NumKeys; ++i)
+        {
+            Keys.push_back(Names[i].c_str());
+            MissingKeys.push_back(Names[NumKeys + i].c_str());
+        }
+        RunMapBenchmark<std::unordered_map<HashMapStringKey, size_t, HashMapStringKey::Hasher>>("std::unordered_map<HashMapStringKey>", Keys, MissingKeys, NumIterations);
+        RunMapBenchmark<FlatHashMap<HashMapStringKey, size_t, HashMapStringKey::Hasher, HashMapStringKey::Equal>>("FlatHashMap<HashMapStringKey>       ", Keys, MissingKeys, NumIterations);
+    }
+}
+
+} // namespace
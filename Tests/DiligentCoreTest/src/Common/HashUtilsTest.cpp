@@ -26,8 +26,13 @@
  */
 
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
 
 #include "HashUtils.hpp"
+#include "RenderDeviceBase.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -116,4 +121,288 @@ TEST(Common_HashUtils, HashMapStringKey)
     }
 }
 
+
+TEST(Common_HashUtils, ComputeHashRaw)
+{
+    const char Data[] = "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog.";
+
+    std::unordered_set<Uint64> Hashes;
+    for (size_t Len = 0; Len < sizeof(Data); ++Len)
+    {
+        const auto Hash = ComputeHashRaw(Data, Len);
+        EXPECT_EQ(Hash, ComputeHashRaw(Data, Len));
+        EXPECT_NE(Hash, ComputeHashRaw(Data, Len, 1));
+        Hashes.insert(Hash);
+    }
+    // All prefixes must produce different hashes
+    EXPECT_EQ(Hashes.size(), sizeof(Data));
+
+    // Flipping any bit must change the hash
+    char Data2[sizeof(Data)];
+    memcpy(Data2, Data, sizeof(Data));
+    const auto RefHash = ComputeHashRaw(Data2, sizeof(Data2));
+    for (size_t i = 0; i < sizeof(Data2) * 8; ++i)
+    {
+        Data2[i / 8] ^= static_cast<char>(1 << (i % 8));
+        EXPECT_NE(ComputeHashRaw(Data2, sizeof(Data2)), RefHash);
+        Data2[i / 8] ^= static_cast<char>(1 << (i % 8));
+    }
+}
+
+TEST(Common_HashUtils, Hasher64)
+{
+    std::vector<Uint8> Data(1024);
+    for (size_t i = 0; i < Data.size(); ++i)
+        Data[i] = static_cast<Uint8>((i * 31 + 7) ^ (i >> 3));
+
+    for (size_t Size : {size_t{0}, size_t{1}, size_t{15}, size_t{16}, size_t{47}, size_t{48}, size_t{49}, size_t{96}, size_t{97}, size_t{500}, Data.size()})
+    {
+        Hasher64 RefHasher;
+        RefHasher.UpdateRaw(Data.data(), Size);
+        const auto RefHash = RefHasher.Digest();
+
+        if (Size <= 48)
+        {
+            EXPECT_EQ(RefHash, ComputeHashRaw(Data.data(), Size));
+        }
+
+        // The hash must not depend on how the data is split into chunks
+        for (size_t ChunkSize : {1, 3, 8, 47, 48, 49, 100})
+        {
+            Hasher64 Hasher;
+            for (size_t Offset = 0; Offset < Size; Offset += ChunkSize)
+                Hasher.UpdateRaw(Data.data() + Offset, std::min(ChunkSize, Size - Offset));
+            EXPECT_EQ(Hasher.Digest(), RefHash) << "Size: " << Size << ", chunk size: " << ChunkSize;
+        }
+    }
+
+    {
+        Hasher64 Hasher1, Hasher2;
+        Hasher1.Update(1, 2.5f, Uint8{3}, "Str");
+        Hasher2.Update(1, 2.5f, Uint8{3}, std::string{"Str"});
+        EXPECT_EQ(Hasher1.Digest(), Hasher2.Digest());
+
+        Hasher2.Update(0);
+        EXPECT_NE(Hasher1.Digest(), Hasher2.Digest());
+
+        // String lengths are hashed, so the concatenations are different
+        Hasher64 Hasher3, Hasher4;
+        Hasher3.Update("ab", "c");
+        Hasher4.Update("a", "bc");
+        EXPECT_NE(Hasher3.Digest(), Hasher4.Digest());
+    }
+
+    {
+        Hasher64 Hasher1, Hasher2;
+        Hasher1.Update(0.f, 0.0);
+        Hasher2.Update(-0.f, -0.0);
+        EXPECT_EQ(Hasher1.Digest(), Hasher2.Digest());
+    }
+}
+
+TEST(Common_HashUtils, HashCombine)
+{
+    EXPECT_EQ(ComputeHash(1, 2, 3), ComputeHash(1, 2, 3));
+    EXPECT_NE(ComputeHash(1, 2, 3), ComputeHash(3, 2, 1));
+    EXPECT_NE(ComputeHash(0), ComputeHash(0, 0));
+    EXPECT_EQ(ComputeHash(0.f, 1.0), ComputeHash(-0.f, 1.0));
+    EXPECT_EQ(ComputeHash(std::string{"abc"}), ComputeHash(std::string{"abc"}));
+
+    EXPECT_EQ(CStringHash<char>{}("Test"), CStringHash<char>{}(std::string{"Test"}.c_str()));
+    EXPECT_NE(CStringHash<char>{}("Test1"), CStringHash<char>{}("Test2"));
+    EXPECT_EQ(CStringHash<wchar_t>{}(L"Test"), CStringHash<wchar_t>{}(std::wstring{L"Test"}.c_str()));
+}
+
+
+// Reference implementations of the previous hash functions
+template <typename T>
+void LegacyHashCombine(std::size_t& Seed, const T& Val)
+{
+    Seed ^= std::hash<T>{}(Val) + 0x9e3779b9 + (Seed << 6) + (Seed >> 2);
+}
+
+size_t LegacyCStringHash(const char* str)
+{
+    size_t Seed = 0;
+    while (size_t Ch = *(str++))
+        Seed = Seed * 65599 + Ch;
+    return Seed;
+}
+
+struct CollisionStats
+{
+    size_t NumDistinctHashes  = 0;
+    size_t NumOccupiedBuckets = 0;
+};
+
+template <typename HashesType>
+CollisionStats ComputeCollisionStats(const HashesType& Hashes, size_t NumBuckets)
+{
+    CollisionStats Stats;
+
+    std::unordered_set<size_t> DistinctHashes{Hashes.begin(), Hashes.end()};
+    Stats.NumDistinctHashes = DistinctHashes.size();
+
+    // Power-of-two bucket count, as in open-addressing hash tables
+    VERIFY_EXPR((NumBuckets & (NumBuckets - 1)) == 0);
+    std::vector<bool> Buckets(NumBuckets);
+    for (auto Hash : Hashes)
+        Buckets[Hash & (NumBuckets - 1)] = true;
+    for (bool b : Buckets)
+        Stats.NumOccupiedBuckets += b ? 1 : 0;
+
+    return Stats;
+}
+
+TEST(Common_HashUtils, DISABLED_CollisionBenchmark)
+{
+    // Enumerate sampler descriptions and hash them with the same function
+    // that is used by the render device sampler cache
+    {
+        std::vector<size_t> LegacyHashes, NewHashes;
+
+        SamplerDesc SamDesc;
+        for (Uint32 MinFilter = FILTER_TYPE_POINT; MinFilter < FILTER_TYPE_NUM_FILTERS; ++MinFilter)
+            for (Uint32 MagFilter = FILTER_TYPE_POINT; MagFilter < FILTER_TYPE_NUM_FILTERS; ++MagFilter)
+                for (Uint32 MipFilter = FILTER_TYPE_POINT; MipFilter < FILTER_TYPE_NUM_FILTERS; ++MipFilter)
+                    for (Uint32 AddressU = TEXTURE_ADDRESS_WRAP; AddressU < TEXTURE_ADDRESS_NUM_MODES; ++AddressU)
+                        for (Uint32 AddressV = TEXTURE_ADDRESS_WRAP; AddressV < TEXTURE_ADDRESS_NUM_MODES; ++AddressV)
+                            for (Uint32 ComparisonFunc = COMPARISON_FUNC_NEVER; ComparisonFunc < COMPARISON_FUNC_NUM_FUNCTIONS; ++ComparisonFunc)
+                                for (Uint32 MaxAnisotropy : {1u, 4u, 16u})
+                                {
+                                    SamDesc.MinFilter      = static_cast<FILTER_TYPE>(MinFilter);
+                                    SamDesc.MagFilter      = static_cast<FILTER_TYPE>(MagFilter);
+                                    SamDesc.MipFilter      = static_cast<FILTER_TYPE>(MipFilter);
+                                    SamDesc.AddressU       = static_cast<TEXTURE_ADDRESS_MODE>(AddressU);
+                                    SamDesc.AddressV       = static_cast<TEXTURE_ADDRESS_MODE>(AddressV);
+                                    SamDesc.ComparisonFunc = static_cast<COMPARISON_FUNCTION>(ComparisonFunc);
+                                    SamDesc.MaxAnisotropy  = MaxAnisotropy;
+
+                                    // Previous std::hash<SamplerDesc> implementation
+                                    size_t LegacyHash = 0;
+                                    LegacyHashCombine(LegacyHash, SamDesc.MinFilter);
+                                    LegacyHashCombine(LegacyHash, SamDesc.MagFilter);
+                                    LegacyHashCombine(LegacyHash, SamDesc.MipFilter);
+                                    LegacyHashCombine(LegacyHash, SamDesc.AddressU);
+                                    LegacyHashCombine(LegacyHash, SamDesc.AddressV);
+                                    LegacyHashCombine(LegacyHash, SamDesc.AddressW);
+                                    LegacyHashCombine(LegacyHash, SamDesc.MipLODBias);
+                                    LegacyHashCombine(LegacyHash, SamDesc.MaxAnisotropy);
+                                    LegacyHashCombine(LegacyHash, SamDesc.ComparisonFunc);
+                                    for (float c : SamDesc.BorderColor)
+                                        LegacyHashCombine(LegacyHash, c);
+                                    LegacyHashCombine(LegacyHash, SamDesc.MinLOD);
+                                    LegacyHashCombine(LegacyHash, SamDesc.MaxLOD);
+                                    LegacyHashes.push_back(LegacyHash);
+
+                                    NewHashes.push_back(std::hash<SamplerDesc>{}(SamDesc));
+                                }
+
+        const size_t NumBuckets  = size_t{1} << 18;
+        const auto   LegacyStats = ComputeCollisionStats(LegacyHashes, NumBuckets);
+        const auto   NewStats    = ComputeCollisionStats(NewHashes, NumBuckets);
+        LOG_INFO_MESSAGE("Sampler descriptions: ", NewHashes.size(), ". Distinct hashes: legacy: ", LegacyStats.NumDistinctHashes, ", new: ", NewStats.NumDistinctHashes,
+                         ". Occupied buckets (of ", NumBuckets, "): legacy: ", LegacyStats.NumOccupiedBuckets, ", new: ", NewStats.NumOccupiedBuckets);
+        EXPECT_EQ(NewStats.NumDistinctHashes, NewHashes.size());
+    }
+
+    // Resource names used by the test shaders, expanded with array indices and
+    // combined texture sampler suffixes the same way resource layouts name them
+    {
+        static const char* ResourceNames[] =
+            {
+                "Arg1", "Arg2", "Arg3", "ConstBuff_1", "ConstBuff_2", "Constants", "RWStructBuff0", "RWStructBuff1", "RWStructBuff2", "Tex1DAS1",
+                "Tex1DS1", "Tex1D_F1", "Tex1D_F_A1", "Tex2DAS1", "Tex2DS1", "Tex2D_F1", "Tex2D_F_A1", "Tex2D_M1", "Tex2D_Test1", "Tex2D_Test2",
+                "Tex2D_Test3", "Tex3D_F1", "Tex3D_F2", "Tex3D_F3", "Tex3D_I", "Tex3D_U", "TexBuff_F", "TexBuff_I", "TexBuff_U", "TexBuffer_F1", "TexCAS1",
+                "TexCS1", "TexCS2", "TexC_F1", "TexC_F_A1", "UniformBuffArr_Dyn", "UniformBuffArr_Mut", "UniformBuffArr_Stat", "UniformBuff_Dyn",
+                "UniformBuff_Mut", "UniformBuff_Stat", "UniformBuff_Stat2", "cbTest1", "cbTest2", "cbTest3", "cbTest4", "cbTest5", "cbTest6",
+                "g_BuffArr_Dyn", "g_BuffArr_Mut", "g_BuffArr_Static", "g_Buff_Dyn", "g_Buff_Mut", "g_Buff_Static", "g_Buffer_Dyn", "g_Buffer_DynArr",
+                "g_Buffer_Mut", "g_Buffer_MutArr", "g_Buffer_Static", "g_Buffer_StaticArr", "g_ConstantBuffers", "g_FormattedBuffers", "g_OutImage",
+                "g_RWBuffArr_Dyn", "g_RWBuffArr_Mut", "g_RWBuffArr_Static", "g_RWBuff_Dyn", "g_RWBuff_Mut", "g_RWBuff_Static", "g_RWFormattedBuffers",
+                "g_RWStructBuffers", "g_RWTex2DArr_Dyn", "g_RWTex2DArr_Mut", "g_RWTex2DArr_Static", "g_RWTex2D_Dyn", "g_RWTex2D_Mut", "g_RWTex2D_Static",
+                "g_RWTextures", "g_SamArr_Dyn", "g_SamArr_Mut", "g_SamArr_Static", "g_Sam_Dyn", "g_Sam_Mut", "g_Sam_Static", "g_Sampler", "g_Samplers",
+                "g_StructuredBuffers", "g_Tex2D", "g_Tex2DArr_Dyn", "g_Tex2DArr_Mut", "g_Tex2DArr_Static", "g_Tex2DClamp", "g_Tex2DMirror", "g_Tex2DWrap",
+                "g_Tex2D_1", "g_Tex2D_2", "g_Tex2D_3", "g_Tex2D_4", "g_Tex2D_Dyn", "g_Tex2D_Mut", "g_Tex2D_Static", "g_Texture", "g_Texture2",
+                "g_Textures", "g_rwBuff_Dyn", "g_rwBuff_Mut", "g_rwBuff_Static", "g_rwtex2D_Dyn", "g_rwtex2D_Mut", "g_rwtex2D_Static",
+                "g_rwtex2D_Static2", "g_tex2D", "g_tex2DTest", "g_tex2DTest2", "g_tex2DUAV", "g_tex2D_Dyn", "g_tex2D_DynArr", "g_tex2D_Mut",
+                "g_tex2D_MutArr", "g_tex2D_Static", "g_tex2D_StaticArr"};
+
+        std::vector<std::string> Names;
+        for (const auto* ResName : ResourceNames)
+        {
+            Names.emplace_back(ResName);
+            Names.emplace_back(std::string{ResName} + "_sampler");
+            for (int i = 0; i < 256; ++i)
+            {
+                Names.emplace_back(std::string{ResName} + "[" + std::to_string(i) + "]");
+                Names.emplace_back(std::string{ResName} + "_sampler[" + std::to_string(i) + "]");
+            }
+        }
+
+        std::vector<size_t> LegacyHashes, NewHashes;
+        for (const auto& Name : Names)
+        {
+            LegacyHashes.push_back(LegacyCStringHash(Name.c_str()));
+            NewHashes.push_back(CStringHash<char>{}(Name.c_str()));
+        }
+
+        const size_t NumBuckets  = size_t{1} << 16;
+        const auto   LegacyStats = ComputeCollisionStats(LegacyHashes, NumBuckets);
+        const auto   NewStats    = ComputeCollisionStats(NewHashes, NumBuckets);
+        LOG_INFO_MESSAGE("Resource names: ", Names.size(), ". Distinct hashes: legacy: ", LegacyStats.NumDistinctHashes, ", new: ", NewStats.NumDistinctHashes,
+                         ". Occupied buckets (of ", NumBuckets, "): legacy: ", LegacyStats.NumOccupiedBuckets, ", new: ", NewStats.NumOccupiedBuckets);
+        EXPECT_EQ(NewStats.NumDistinctHashes, Names.size());
+    }
+}
+
+TEST(Common_HashUtils, DISABLED_ThroughputBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr size_t NumIterations = 1000;
+#else
+    constexpr size_t NumIterations = 100000;
+#endif
+
+    std::vector<std::string> Names;
+    for (int i = 0; i < 1024; ++i)
+        Names.emplace_back("g_ResourceName_" + std::to_string(i * 7919));
+
+    Timer  T;
+    size_t Checksum = 0;
+
+    auto StartTime = T.GetElapsedTime();
+    for (size_t it = 0; it < NumIterations; ++it)
+    {
+        for (const auto& Name : Names)
+            Checksum += LegacyCStringHash(Name.c_str());
+    }
+    const auto LegacyStrTime = T.GetElapsedTime() - StartTime;
+
+    StartTime = T.GetElapsedTime();
+    for (size_t it = 0; it < NumIterations; ++it)
+    {
+        for (const auto& Name : Names)
+            Checksum += CStringHash<char>{}(Name.c_str());
+    }
+    const auto NewStrTime = T.GetElapsedTime() - StartTime;
+
+    std::vector<Uint8> Data(1 << 20);
+    for (size_t i = 0; i < Data.size(); ++i)
+        Data[i] = static_cast<Uint8>(i * 13);
+
+    StartTime = T.GetElapsedTime();
+    for (size_t it = 0; it < NumIterations / 1000 + 1; ++it)
+    {
+        Hasher64 Hasher{it};
+        Hasher.UpdateRaw(Data.data(), Data.size());
+        Checksum += static_cast<size_t>(Hasher.Digest());
+    }
+    const auto StreamTime = T.GetElapsedTime() - StartTime;
+
+    const auto NumStrings = static_cast<double>(NumIterations * Names.size());
+    const auto NumBytes   = static_cast<double>((NumIterations / 1000 + 1) * Data.size());
+    LOG_INFO_MESSAGE("String hash: legacy: ", LegacyStrTime / NumStrings * 1e9, " ns/string, new: ", NewStrTime / NumStrings * 1e9,
+                     " ns/string. Hasher64 throughput: ", NumBytes / StreamTime / (1 << 30), " GB/s. Checksum: ", Checksum);
+}
+
 } // namespace
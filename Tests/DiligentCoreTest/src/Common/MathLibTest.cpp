@@ -26,10 +26,15 @@
  */
 
 #include <climits>
+#include <functional>
 #include <sstream>
+#include <vector>
 
 #include "BasicMath.hpp"
 #include "AdvancedMath.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+#include "PlatformMisc.hpp"
 
 #include "gtest/gtest.h"
 
@@ -1004,6 +1009,179 @@ TEST(Common_BasicMath, MatrixInverse)
     }
 }
 
+static float4x4 MakeRandomMatrix(FastRandFloat& Rnd)
+{
+    float4x4 m;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            m[i][j] = Rnd();
+    }
+    return m;
+}
+
+// float4x4 operations may use SIMD implementation (see DILIGENT_ENABLE_SIMD_MATH),
+// so compare them against straightforward scalar code.
+// The SIMD implementation is tested by the CI configuration that enables DILIGENT_SIMD_MATH.
+#if defined(DILIGENT_ENABLE_SIMD_MATH) && (defined(__SSE2__) || defined(_M_X64) || defined(__ARM_NEON) || defined(_M_ARM64))
+#    if !(DILIGENT_SIMD_MATH_SSE || DILIGENT_SIMD_MATH_NEON)
+#        error SIMD math is enabled, but no SIMD implementation is selected
+#    endif
+#endif
+
+TEST(Common_BasicMath, Float4x4Operations)
+{
+    FastRandFloat Rnd{0, -10, 10};
+    for (int test = 0; test < 256; ++test)
+    {
+        const auto m1 = MakeRandomMatrix(Rnd);
+        const auto m2 = MakeRandomMatrix(Rnd);
+        const auto v  = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+
+        {
+            const auto Prod = m1 * m2;
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    float Ref = 0;
+                    for (int k = 0; k < 4; ++k)
+                        Ref += m1[i][k] * m2[k][j];
+                    EXPECT_NEAR(Prod[i][j], Ref, 1e-4f);
+                }
+            }
+
+            auto m = m1;
+            m *= m2;
+            EXPECT_EQ(m, Prod);
+        }
+
+        {
+            const auto vm = v * m1;
+            const auto mv = m1 * v;
+            for (int i = 0; i < 4; ++i)
+            {
+                float RefVM = 0;
+                float RefMV = 0;
+                for (int k = 0; k < 4; ++k)
+                {
+                    RefVM += v[k] * m1[k][i];
+                    RefMV += m1[i][k] * v[k];
+                }
+                EXPECT_NEAR(vm[i], RefVM, 1e-4f);
+                EXPECT_NEAR(mv[i], RefMV, 1e-4f);
+            }
+
+            const auto v3  = float3{v.x, v.y, v.z};
+            const auto v3m = v3 * m1;
+            const auto Ref = float4{v.x, v.y, v.z, 1} * m1;
+            EXPECT_EQ(v3m, (float3{Ref.x / Ref.w, Ref.y / Ref.w, Ref.z / Ref.w}));
+        }
+
+        {
+            const auto Tr = m1.Transpose();
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                    EXPECT_EQ(Tr[i][j], m1[j][i]);
+            }
+        }
+
+        {
+            const auto Det = m1.Determinant();
+            if (std::abs(Det) < 1.f)
+                continue;
+
+            // Compute the reference inverse in double precision
+            double4x4 md;
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                    md[i][j] = m1[i][j];
+            }
+            const auto RefInv = md.Inverse();
+
+            const auto Inv = m1.Inverse();
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                    EXPECT_NEAR(Inv[i][j], RefInv[i][j], 1e-4 * std::max(1.0, std::abs(RefInv[i][j])));
+            }
+        }
+    }
+}
+
+TEST(Common_BasicMath, DISABLED_Float4x4Benchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr size_t NumMatrices = 1024;
+    constexpr int    NumPasses   = 4;
+#else
+    constexpr size_t NumMatrices = 4096;
+    constexpr int    NumPasses   = 64;
+#endif
+
+    FastRandFloat         Rnd{0, -1, 1};
+    std::vector<float4x4> Matrices(NumMatrices);
+    std::vector<float4>   Vectors(NumMatrices);
+    for (size_t i = 0; i < NumMatrices; ++i)
+    {
+        Matrices[i] = MakeRandomMatrix(Rnd);
+        Vectors[i]  = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+    }
+    std::vector<float4x4> MatrixResults(NumMatrices);
+    std::vector<float4>   VectorResults(NumMatrices);
+
+    // Prevents the compiler from optimizing the computations away
+    float Checksum = 0;
+
+    Timer T;
+    for (int pass = 0; pass < NumPasses; ++pass)
+    {
+        for (size_t i = 0; i < NumMatrices; ++i)
+            MatrixResults[i] = Matrices[i] * Matrices[NumMatrices - 1 - i];
+        Checksum += MatrixResults[pass % NumMatrices][0][0];
+    }
+    const auto MulTime = T.GetElapsedTime() * 1000;
+
+    T.Restart();
+    for (int pass = 0; pass < NumPasses; ++pass)
+    {
+        for (size_t i = 0; i < NumMatrices; ++i)
+            VectorResults[i] = Vectors[i] * Matrices[(i + pass) % NumMatrices];
+        Checksum += VectorResults[pass % NumMatrices].x;
+    }
+    const auto TransformTime = T.GetElapsedTime() * 1000;
+
+    T.Restart();
+    for (int pass = 0; pass < NumPasses; ++pass)
+    {
+        for (size_t i = 0; i < NumMatrices; ++i)
+            MatrixResults[i] = Matrices[i].Transpose();
+        Checksum += MatrixResults[pass % NumMatrices][0][1];
+    }
+    const auto TransposeTime = T.GetElapsedTime() * 1000;
+
+    T.Restart();
+    for (int pass = 0; pass < NumPasses; ++pass)
+    {
+        for (size_t i = 0; i < NumMatrices; ++i)
+            MatrixResults[i] = Matrices[i].Inverse();
+        Checksum += MatrixResults[pass % NumMatrices][0][0];
+    }
+    const auto InverseTime = T.GetElapsedTime() * 1000;
+
+    const size_t NumOps = NumMatrices * NumPasses;
+    LOG_INFO_MESSAGE(
+#ifdef DILIGENT_ENABLE_SIMD_MATH
+        "SIMD ",
+#else
+        "Scalar ",
+#endif
+        "float4x4 operations (", NumOps, " each): multiply: ", MulTime, " ms, vector transform: ", TransformTime,
+        " ms, transpose: ", TransposeTime, " ms, inverse: ", InverseTime, " ms (checksum: ", Checksum, ")");
+}
+
 
 TEST(Common_BasicMath, Hash)
 {
@@ -2194,4 +2372,615 @@ TEST(Common_AdvancedMath, CheckBox2DBox2DOverlap)
     // clang-format on
 }
 
+
+// Bounding boxes in both AoS and SoA layouts
+struct TestBoundBoxes
+{
+    TestBoundBoxes(size_t Count, FastRandFloat& Rnd)
+    {
+        for (auto* pArray : {&MinX, &MinY, &MinZ, &MaxX, &MaxY, &MaxZ})
+            pArray->resize(Count);
+        Boxes.resize(Count);
+        for (size_t i = 0; i < Count; ++i)
+        {
+            const float3 Center{Rnd() * 120 - 60, Rnd() * 120 - 60, Rnd() * 120 - 10};
+            const float3 HalfSize{Rnd() * 4 + 0.01f, Rnd() * 4 + 0.01f, Rnd() * 4 + 0.01f};
+
+            Boxes[i].Min = Center - HalfSize;
+            Boxes[i].Max = Center + HalfSize;
+
+            MinX[i] = Boxes[i].Min.x;
+            MinY[i] = Boxes[i].Min.y;
+            MinZ[i] = Boxes[i].Min.z;
+            MaxX[i] = Boxes[i].Max.x;
+            MaxY[i] = Boxes[i].Max.y;
+            MaxZ[i] = Boxes[i].Max.z;
+        }
+    }
+
+    BoundBoxesSoA GetSoA() const
+    {
+        BoundBoxesSoA SoA;
+        SoA.MinX  = MinX.data();
+        SoA.MinY  = MinY.data();
+        SoA.MinZ  = MinZ.data();
+        SoA.MaxX  = MaxX.data();
+        SoA.MaxY  = MaxY.data();
+        SoA.MaxZ  = MaxZ.data();
+        SoA.Count = Boxes.size();
+        return SoA;
+    }
+
+    std::vector<BoundBox> Boxes;
+    std::vector<float>    MinX, MinY, MinZ, MaxX, MaxY, MaxZ;
+};
+
+std::vector<ViewFrustumExt> MakeTestFrustums(size_t NumFrustums)
+{
+    std::vector<ViewFrustumExt> Frustums(NumFrustums);
+    for (size_t i = 0; i < NumFrustums; ++i)
+    {
+        // Cascade-like frustums with different orientations and depth ranges
+        const auto View = float4x4::RotationY(0.3f * static_cast<float>(i) - 0.5f) * float4x4::RotationX(0.1f * static_cast<float>(i));
+        const auto Proj = float4x4::Projection(PI_F / 3.f, 1.5f, 0.5f + 10.f * static_cast<float>(i), 30.f + 20.f * static_cast<float>(i), false);
+        ExtractViewFrustumPlanesFromMatrix(View * Proj, Frustums[i], false);
+    }
+    return Frustums;
+}
+
+bool IsBitSet(const std::vector<Uint64>& Mask, size_t Idx)
+{
+    return (Mask[Idx / 64] & (Uint64{1} << (Idx % 64))) != 0;
+}
+
+TEST(Common_AdvancedMath, GetBoxesVisibility)
+{
+    FastRandFloat  Rnd{0, 0, 1};
+    TestBoundBoxes TestBoxes{1000, Rnd};
+    const auto     Frustums = MakeTestFrustums(11);
+
+    const auto NumBoxes = TestBoxes.Boxes.size();
+    const auto NumWords = (NumBoxes + 63) / 64;
+
+    const FRUSTUM_PLANE_FLAGS PlaneFlags[] = {FRUSTUM_PLANE_FLAG_FULL_FRUSTUM, FRUSTUM_PLANE_FLAG_OPEN_NEAR, FRUSTUM_PLANE_FLAG_LEFT_PLANE | FRUSTUM_PLANE_FLAG_TOP_PLANE, FRUSTUM_PLANE_FLAG_NONE};
+    for (auto Flags : PlaneFlags)
+    {
+        for (bool UseExt : {false, true})
+        {
+            std::vector<std::vector<Uint64>>  Visible(Frustums.size(), std::vector<Uint64>(NumWords, ~Uint64{0}));
+            std::vector<std::vector<Uint64>>  FullyVisible(Frustums.size(), std::vector<Uint64>(NumWords, ~Uint64{0}));
+            std::vector<FrustumCullingTarget> Targets(Frustums.size());
+            for (size_t f = 0; f < Frustums.size(); ++f)
+            {
+                if (UseExt)
+                    Targets[f].pFrustumExt = &Frustums[f];
+                else
+                    Targets[f].pFrustum = &Frustums[f];
+                Targets[f].PlaneFlags        = Flags;
+                Targets[f].pVisibleMask      = Visible[f].data();
+                Targets[f].pFullyVisibleMask = FullyVisible[f].data();
+            }
+
+            // Process the boxes in two ranges to test partial processing
+            const auto SoA = TestBoxes.GetSoA();
+            GetBoxesVisibility(SoA, Targets.data(), static_cast<Uint32>(Targets.size()), 0, 320);
+            GetBoxesVisibility(SoA, Targets.data(), static_cast<Uint32>(Targets.size()), 320);
+
+            size_t NumVisible      = 0;
+            size_t NumFullyVisible = 0;
+            for (size_t f = 0; f < Frustums.size(); ++f)
+            {
+                for (size_t i = 0; i < NumBoxes; ++i)
+                {
+                    const auto RefVisibility = UseExt ?
+                        GetBoxVisibility(Frustums[f], TestBoxes.Boxes[i], Flags) :
+                        GetBoxVisibility(static_cast<const ViewFrustum&>(Frustums[f]), TestBoxes.Boxes[i], Flags);
+                    EXPECT_EQ(IsBitSet(Visible[f], i), RefVisibility != BoxVisibility::Invisible) << "Frustum " << f << ", box " << i;
+                    EXPECT_EQ(IsBitSet(FullyVisible[f], i), RefVisibility == BoxVisibility::FullyVisible) << "Frustum " << f << ", box " << i;
+                    NumVisible += RefVisibility != BoxVisibility::Invisible ? 1 : 0;
+                    NumFullyVisible += RefVisibility == BoxVisibility::FullyVisible ? 1 : 0;
+                }
+                // Bits after the last box must be cleared
+                EXPECT_EQ(Visible[f].back() >> (NumBoxes % 64), Uint64{0});
+            }
+            if (Flags != FRUSTUM_PLANE_FLAG_NONE)
+            {
+                EXPECT_GT(NumVisible, size_t{0});
+                EXPECT_LT(NumVisible, NumBoxes * Frustums.size());
+                EXPECT_GT(NumFullyVisible, size_t{0});
+            }
+        }
+    }
+}
+
+TEST(Common_AdvancedMath, GetSpheresVisibility)
+{
+    FastRandFloat Rnd{0, 0, 1};
+
+    const size_t       NumSpheres = 777;
+    std::vector<float> CenterX(NumSpheres), CenterY(NumSpheres), CenterZ(NumSpheres), Radius(NumSpheres);
+    for (size_t i = 0; i < NumSpheres; ++i)
+    {
+        CenterX[i] = Rnd() * 120 - 60;
+        CenterY[i] = Rnd() * 120 - 60;
+        CenterZ[i] = Rnd() * 120 - 10;
+        Radius[i]  = Rnd() * 5;
+    }
+
+    BoundSpheresSoA Spheres;
+    Spheres.CenterX = CenterX.data();
+    Spheres.CenterY = CenterY.data();
+    Spheres.CenterZ = CenterZ.data();
+    Spheres.Radius  = Radius.data();
+    Spheres.Count   = NumSpheres;
+
+    const auto Frustums = MakeTestFrustums(3);
+    for (bool UseExt : {false, true})
+    {
+        std::vector<std::vector<Uint64>>  Visible(Frustums.size(), std::vector<Uint64>((NumSpheres + 63) / 64));
+        std::vector<std::vector<Uint64>>  FullyVisible(Frustums.size(), std::vector<Uint64>((NumSpheres + 63) / 64));
+        std::vector<FrustumCullingTarget> Targets(Frustums.size());
+        for (size_t f = 0; f < Frustums.size(); ++f)
+        {
+            if (UseExt)
+                Targets[f].pFrustumExt = &Frustums[f];
+            else
+                Targets[f].pFrustum = &Frustums[f];
+            Targets[f].pVisibleMask      = Visible[f].data();
+            Targets[f].pFullyVisibleMask = FullyVisible[f].data();
+        }
+        GetSpheresVisibilityParallel(
+            Spheres, Targets.data(), static_cast<Uint32>(Targets.size()),
+            [](size_t NumTasks, const std::function<void(size_t)>& Func) {
+                for (size_t i = 0; i < NumTasks; ++i)
+                    Func(i);
+            },
+            100);
+
+        for (size_t f = 0; f < Frustums.size(); ++f)
+        {
+            for (size_t i = 0; i < NumSpheres; ++i)
+            {
+                const float3 Center{CenterX[i], CenterY[i], CenterZ[i]};
+
+                bool IsInvisible = false;
+                bool IsInside    = true;
+                for (Uint32 p = 0; p < ViewFrustum::NUM_PLANES; ++p)
+                {
+                    const auto& Plane = Frustums[f].GetPlane(static_cast<ViewFrustum::PLANE_IDX>(p));
+
+                    // Same normalization as in GetSpheresVisibility()
+                    const auto Len    = length(Plane.Normal);
+                    auto       Normal = Plane.Normal;
+                    Normal /= Len;
+                    const auto Dist = dot(Center, Normal) + Plane.Distance / Len;
+                    IsInvisible     = IsInvisible || Dist < -Radius[i];
+                    IsInside        = IsInside && Dist > Radius[i];
+                }
+                if (UseExt && !IsInvisible && !IsInside)
+                {
+                    // Test the bounding box of the sphere against the frustum corners
+                    BoundBox Box{Center - float3{Radius[i], Radius[i], Radius[i]}, Center + float3{Radius[i], Radius[i], Radius[i]}};
+                    IsInvisible = GetBoxVisibility(Frustums[f], Box) == BoxVisibility::Invisible;
+                }
+
+                EXPECT_EQ(IsBitSet(Visible[f], i), !IsInvisible) << "Frustum " << f << ", sphere " << i;
+                EXPECT_EQ(IsBitSet(FullyVisible[f], i), IsInside && !IsInvisible) << "Frustum " << f << ", sphere " << i;
+            }
+        }
+    }
+}
+
+TEST(Common_AdvancedMath, DISABLED_BatchedCullingBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr size_t NumBoxes = 20000;
+#else
+    constexpr size_t NumBoxes  = 200000;
+#endif
+    constexpr size_t NumCascades = 4;
+
+    FastRandFloat  Rnd{0, 0, 1};
+    TestBoundBoxes TestBoxes{NumBoxes, Rnd};
+    const auto     Frustums = MakeTestFrustums(NumCascades);
+
+    std::vector<std::vector<Uint64>>  Visible(NumCascades, std::vector<Uint64>((NumBoxes + 63) / 64));
+    std::vector<FrustumCullingTarget> Targets(NumCascades);
+    for (size_t f = 0; f < NumCascades; ++f)
+    {
+        Targets[f].pFrustumExt  = &Frustums[f];
+        Targets[f].pVisibleMask = Visible[f].data();
+    }
+
+    Timer  T;
+    size_t NumVisibleScalar = 0;
+    for (size_t f = 0; f < NumCascades; ++f)
+    {
+        for (const auto& Box : TestBoxes.Boxes)
+            NumVisibleScalar += GetBoxVisibility(Frustums[f], Box) != BoxVisibility::Invisible ? 1 : 0;
+    }
+    const auto ScalarTime = T.GetElapsedTime() * 1000;
+
+    T.Restart();
+    GetBoxesVisibility(TestBoxes.GetSoA(), Targets.data(), static_cast<Uint32>(Targets.size()));
+    const auto BatchedTime = T.GetElapsedTime() * 1000;
+
+    size_t NumVisibleBatched = 0;
+    for (const auto& Mask : Visible)
+    {
+        for (auto Word : Mask)
+            NumVisibleBatched += PlatformMisc::CountOneBits(Word);
+    }
+    EXPECT_EQ(NumVisibleScalar, NumVisibleBatched);
+
+    LOG_INFO_MESSAGE("Culling ", NumBoxes, " boxes against ", NumCascades, " frustums: GetBoxVisibility: ", ScalarTime,
+                     " ms, GetBoxesVisibility: ", BatchedTime, " ms");
+}
+
+// Bulk functions perform the same operations as their scalar counterparts, but the
+// compiler may contract multiplications and additions differently in the two versions
+void ExpectNear(const float3& Val, const float3& Ref)
+{
+    EXPECT_NEAR(Val.x, Ref.x, 1e-5f * std::max(1.f, std::abs(Ref.x)));
+    EXPECT_NEAR(Val.y, Ref.y, 1e-5f * std::max(1.f, std::abs(Ref.y)));
+    EXPECT_NEAR(Val.z, Ref.z, 1e-5f * std::max(1.f, std::abs(Ref.z)));
+}
+
+void ExpectNearDistance(float Val, float Ref)
+{
+    if (Ref == +FLT_MAX)
+    {
+        EXPECT_EQ(Val, Ref);
+    }
+    else
+    {
+        EXPECT_NEAR(Val, Ref, 1e-5f * std::max(1.f, std::abs(Ref)));
+    }
+}
+
+TEST(Common_AdvancedMath, TransformPoints)
+{
+    FastRandFloat Rnd{0, -10, 10};
+
+    const auto Matrix = float4x4::Scale(1.5f, 0.5f, 2.f) * float4x4::RotationY(0.7f) * float4x4::RotationX(-0.3f) * float4x4::Translation(10, -20, 30);
+
+    // Positions and normals interleaved as in a vertex buffer
+    struct Vertex
+    {
+        float3 Pos;
+        float3 Normal;
+        float2 UV;
+    };
+    constexpr size_t    NumVerts = 103;
+    std::vector<Vertex> Verts(NumVerts);
+    for (auto& Vert : Verts)
+    {
+        Vert.Pos    = float3{Rnd(), Rnd(), Rnd()};
+        Vert.Normal = float3{Rnd(), Rnd(), Rnd()};
+        Vert.UV     = float2{Rnd(), Rnd()};
+    }
+
+    std::vector<float3> Positions(NumVerts);
+    TransformPoints(Matrix, &Verts[0].Pos, Positions.data(), NumVerts, sizeof(Vertex));
+    for (size_t i = 0; i < NumVerts; ++i)
+    {
+        const auto Ref = float4{Verts[i].Pos, 1} * Matrix;
+        ExpectNear(Positions[i], float3(Ref.x, Ref.y, Ref.z));
+    }
+
+    const auto NormalMatrix = Matrix.Inverse().Transpose();
+    auto       Transformed  = Verts;
+    TransformVectors(NormalMatrix, &Transformed[0].Normal, &Transformed[0].Normal, NumVerts, sizeof(Vertex), sizeof(Vertex));
+    for (size_t i = 0; i < NumVerts; ++i)
+    {
+        const auto Ref = float4{Verts[i].Normal, 0} * NormalMatrix;
+        ExpectNear(Transformed[i].Normal, float3(Ref.x, Ref.y, Ref.z));
+        // Other attributes must not be affected
+        EXPECT_EQ(Transformed[i].Pos, Verts[i].Pos);
+        EXPECT_EQ(Transformed[i].UV, Verts[i].UV);
+    }
+
+    // In-place transform of the tightly packed array
+    TransformPoints(Matrix.Inverse(), Positions.data(), Positions.data(), NumVerts);
+    for (size_t i = 0; i < NumVerts; ++i)
+    {
+        EXPECT_NEAR(Positions[i].x, Verts[i].Pos.x, 1e-4f);
+        EXPECT_NEAR(Positions[i].y, Verts[i].Pos.y, 1e-4f);
+        EXPECT_NEAR(Positions[i].z, Verts[i].Pos.z, 1e-4f);
+    }
+}
+
+TEST(Common_AdvancedMath, ComputeBoundingVolumes)
+{
+    FastRandFloat Rnd{0, -100, 100};
+
+    for (size_t NumPoints : {1, 2, 3, 4, 5, 8, 9, 100, 257})
+    {
+        // Points with the stride of 16 bytes
+        std::vector<float4> Points(NumPoints);
+        for (auto& Point : Points)
+            Point = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+
+        BoundBox RefBox{Points[0], Points[0]};
+        for (const auto& Point : Points)
+        {
+            RefBox.Min = std::min(RefBox.Min, float3{Point});
+            RefBox.Max = std::max(RefBox.Max, float3{Point});
+        }
+
+        const auto* pPoints = reinterpret_cast<const float3*>(Points.data());
+
+        const auto Box = ComputeBoundBox(pPoints, NumPoints, sizeof(float4));
+        EXPECT_EQ(Box.Min, RefBox.Min);
+        EXPECT_EQ(Box.Max, RefBox.Max);
+
+        const auto Sphere = ComputeBoundSphere(pPoints, NumPoints, sizeof(float4));
+        EXPECT_EQ(Sphere.Center, (RefBox.Min + RefBox.Max) * 0.5f);
+        float MaxDist = 0;
+        for (const auto& Point : Points)
+            MaxDist = std::max(MaxDist, length(float3{Point} - Sphere.Center));
+        EXPECT_NEAR(Sphere.Radius, MaxDist, MaxDist * 1e-6f);
+
+        // Boxes made of pairs of consecutive points
+        std::vector<BoundBox> Boxes(NumPoints);
+        BoundBox              RefMerged{float3{+FLT_MAX}, float3{-FLT_MAX}};
+        for (size_t i = 0; i < NumPoints; ++i)
+        {
+            const float3 p0{Points[i]};
+            const float3 p1{Points[(i + 1) % NumPoints]};
+
+            Boxes[i]      = BoundBox{std::min(p0, p1), std::max(p0, p1)};
+            RefMerged.Min = std::min(RefMerged.Min, Boxes[i].Min);
+            RefMerged.Max = std::max(RefMerged.Max, Boxes[i].Max);
+        }
+        const auto Merged = MergeBoundBoxes(Boxes.data(), NumPoints);
+        EXPECT_EQ(Merged.Min, RefMerged.Min);
+        EXPECT_EQ(Merged.Max, RefMerged.Max);
+    }
+}
+
+TEST(Common_AdvancedMath, TransformBoundBoxes)
+{
+    constexpr size_t NumBoxes = 97;
+
+    FastRandFloat  Rnd{0, 0, 1};
+    TestBoundBoxes TestBoxes{NumBoxes, Rnd};
+
+    std::vector<float4x4> Matrices(NumBoxes);
+    for (auto& Matrix : Matrices)
+    {
+        Matrix = float4x4::Scale(Rnd() + 0.5f, Rnd() + 0.5f, Rnd() + 0.5f) *
+            float4x4::RotationZ(Rnd() * 6) * float4x4::RotationX(Rnd() * 6) *
+            float4x4::Translation(Rnd() * 100, Rnd() * 100, Rnd() * 100);
+    }
+
+    std::vector<BoundBox> Boxes(NumBoxes);
+    TransformBoundBoxes(TestBoxes.Boxes.data(), Matrices.data(), Boxes.data(), NumBoxes);
+    for (size_t i = 0; i < NumBoxes; ++i)
+    {
+        const auto RefBox = TestBoxes.Boxes[i].Transform(Matrices[i]);
+        EXPECT_EQ(Boxes[i].Min, RefBox.Min);
+        EXPECT_EQ(Boxes[i].Max, RefBox.Max);
+    }
+
+    // In place
+    TransformBoundBoxes(Boxes.data(), Matrices.data(), Boxes.data(), NumBoxes);
+    for (size_t i = 0; i < NumBoxes; ++i)
+    {
+        const auto RefBox = TestBoxes.Boxes[i].Transform(Matrices[i]).Transform(Matrices[i]);
+        EXPECT_EQ(Boxes[i].Min, RefBox.Min);
+        EXPECT_EQ(Boxes[i].Max, RefBox.Max);
+    }
+}
+
+TEST(Common_AdvancedMath, IntersectRayBoxes)
+{
+    constexpr size_t NumBoxes = 1000;
+
+    FastRandFloat  Rnd{0, 0, 1};
+    TestBoundBoxes TestBoxes{NumBoxes, Rnd};
+
+    const float3 RayOrigin{1, 2, 10};
+    // Include axis-parallel rays
+    for (const auto& RayDir : {float3{0.1f, -0.2f, 1}, float3{0, 0, 1}, float3{-1, 0, 0}, float3{0.3f, 0.05f, 0}})
+    {
+        std::vector<Uint64> HitMask((NumBoxes + 63) / 64, ~Uint64{0});
+        std::vector<float>  EnterDist(NumBoxes), ExitDist(NumBoxes);
+
+        const auto NumHits = IntersectRayBoxes(RayOrigin, RayDir, TestBoxes.GetSoA(), HitMask.data(), EnterDist.data(), ExitDist.data());
+
+        size_t RefNumHits = 0;
+        for (size_t i = 0; i < NumBoxes; ++i)
+        {
+            float      RefEnter = 0, RefExit = 0;
+            const bool RefHit = IntersectRayAABB(RayOrigin, RayDir, TestBoxes.Boxes[i], RefEnter, RefExit);
+            RefNumHits += RefHit ? 1 : 0;
+
+            const bool Hit = (HitMask[i / 64] & (Uint64{1} << (i % 64))) != 0;
+            EXPECT_EQ(Hit, RefHit) << "Box " << i;
+            EXPECT_EQ(EnterDist[i], RefEnter) << "Box " << i;
+            EXPECT_EQ(ExitDist[i], RefExit) << "Box " << i;
+        }
+        EXPECT_EQ(NumHits, RefNumHits);
+        EXPECT_GT(RefNumHits, size_t{0});
+        // Bits after the last box must be cleared
+        EXPECT_EQ(HitMask.back() >> (NumBoxes % 64), Uint64{0});
+    }
+}
+
+TEST(Common_AdvancedMath, IntersectRayTriangles)
+{
+    constexpr size_t NumTriangles = 501;
+
+    FastRandFloat Rnd{0, -10, 10};
+
+    std::vector<float3> Vertices(NumTriangles * 3);
+    for (size_t i = 0; i < NumTriangles; ++i)
+    {
+        const float3 Center{Rnd(), Rnd(), Rnd()};
+        for (size_t v = 0; v < 3; ++v)
+            Vertices[i * 3 + v] = Center + float3{Rnd(), Rnd(), Rnd()} * 0.3f;
+    }
+
+    // Index the same triangles in reverse order
+    std::vector<Uint32> Indices(NumTriangles * 3);
+    for (size_t i = 0; i < NumTriangles; ++i)
+    {
+        for (size_t v = 0; v < 3; ++v)
+            Indices[i * 3 + v] = static_cast<Uint32>((NumTriangles - 1 - i) * 3 + v);
+    }
+
+    for (int ray = 0; ray < 32; ++ray)
+    {
+        const float3 RayOrigin{Rnd(), Rnd(), Rnd()};
+        const float3 RayDir = normalize(float3{Rnd(), Rnd(), Rnd()});
+        for (bool CullBackFace : {false, true})
+        {
+            std::vector<float> Distances(NumTriangles), IndexedDistances(NumTriangles);
+
+            size_t     ClosestHit = 0, IndexedClosestHit = 0;
+            const auto Closest        = IntersectRayTriangles(RayOrigin, RayDir, Vertices.data(), nullptr, NumTriangles, CullBackFace, Distances.data(), &ClosestHit);
+            const auto IndexedClosest = IntersectRayTriangles(RayOrigin, RayDir, Vertices.data(), Indices.data(), NumTriangles, CullBackFace, IndexedDistances.data(), &IndexedClosestHit);
+
+            float  RefClosest    = +FLT_MAX;
+            size_t RefClosestHit = NumTriangles;
+            for (size_t i = 0; i < NumTriangles; ++i)
+            {
+                const auto Dist = IntersectRayTriangle(Vertices[i * 3 + 0], Vertices[i * 3 + 1], Vertices[i * 3 + 2], RayOrigin, RayDir, CullBackFace);
+                ExpectNearDistance(Distances[i], Dist);
+                ExpectNearDistance(IndexedDistances[NumTriangles - 1 - i], Dist);
+                if (Dist >= 0 && Dist < RefClosest)
+                {
+                    RefClosest    = Dist;
+                    RefClosestHit = i;
+                }
+            }
+            ExpectNearDistance(Closest, RefClosest);
+            EXPECT_EQ(ClosestHit, RefClosestHit);
+            ExpectNearDistance(IndexedClosest, RefClosest);
+            if (RefClosestHit < NumTriangles)
+            {
+                EXPECT_EQ(IndexedClosestHit, NumTriangles - 1 - RefClosestHit);
+            }
+            else
+            {
+                EXPECT_EQ(IndexedClosestHit, NumTriangles);
+            }
+        }
+    }
+}
+
+TEST(Common_AdvancedMath, DISABLED_BulkMathBenchmark)
+{
+    // Data sets are small enough to stay in cache, so that the timings
+    // are not dominated by memory bandwidth
+    constexpr size_t Count = 12288;
+#ifdef DILIGENT_DEBUG
+    constexpr int NumPasses = 2;
+#else
+    constexpr int    NumPasses = 32;
+#endif
+
+    FastRandFloat Rnd{0, 0, 1};
+
+    const auto Matrix = float4x4::RotationY(0.7f) * float4x4::Translation(10, -20, 30);
+
+    std::vector<float3> Points(Count), Transformed(Count);
+    for (auto& Point : Points)
+        Point = float3{Rnd(), Rnd(), Rnd()};
+
+    TestBoundBoxes        TestBoxes{Count, Rnd};
+    std::vector<float4x4> Matrices(Count, Matrix);
+    std::vector<BoundBox> Boxes(Count);
+    std::vector<Uint64>   HitMask((Count + 63) / 64);
+
+    const float3 RayOrigin{1, 2, -20};
+    const float3 RayDir{0.1f, -0.2f, 1};
+
+    // Use the points as a triangle soup
+    const size_t NumTriangles = Count / 3;
+
+    // Runs Func NumPasses times and returns the total time in milliseconds
+    auto Measure = [&](const std::function<void()>& Func) {
+        Timer T;
+        for (int pass = 0; pass < NumPasses; ++pass)
+            Func();
+        return T.GetElapsedTime() * 1000;
+    };
+
+    const auto ScalarTransformTime = Measure([&]() {
+        for (size_t i = 0; i < Count; ++i)
+        {
+            const auto p   = float4{Points[i], 1} * Matrix;
+            Transformed[i] = float3{p.x, p.y, p.z};
+        }
+    });
+    const auto TransformTime       = Measure([&]() {
+        TransformPoints(Matrix, Points.data(), Transformed.data(), Count);
+    });
+
+    BoundBox   RefBox;
+    const auto ScalarBoundBoxTime = Measure([&]() {
+        RefBox = BoundBox{Points[0], Points[0]};
+        for (const auto& Point : Points)
+        {
+            RefBox.Min = std::min(RefBox.Min, Point);
+            RefBox.Max = std::max(RefBox.Max, Point);
+        }
+    });
+    BoundBox   Box;
+    const auto BoundBoxTime = Measure([&]() {
+        Box = ComputeBoundBox(Points.data(), Count);
+    });
+    EXPECT_EQ(Box.Min, RefBox.Min);
+    EXPECT_EQ(Box.Max, RefBox.Max);
+
+    const auto ScalarBoxTransformTime = Measure([&]() {
+        for (size_t i = 0; i < Count; ++i)
+            Boxes[i] = TestBoxes.Boxes[i].Transform(Matrices[i]);
+    });
+    const auto BoxTransformTime       = Measure([&]() {
+        TransformBoundBoxes(TestBoxes.Boxes.data(), Matrices.data(), Boxes.data(), Count);
+    });
+
+    size_t     RefNumHits       = 0;
+    const auto ScalarRayBoxTime = Measure([&]() {
+        RefNumHits = 0;
+        for (const auto& TestBox : TestBoxes.Boxes)
+        {
+            float Enter = 0, Exit = 0;
+            RefNumHits += IntersectRayAABB(RayOrigin, RayDir, TestBox, Enter, Exit) ? 1 : 0;
+        }
+    });
+    size_t     NumHits          = 0;
+    const auto RayBoxTime       = Measure([&]() {
+        NumHits = IntersectRayBoxes(RayOrigin, RayDir, TestBoxes.GetSoA(), HitMask.data());
+    });
+    EXPECT_EQ(NumHits, RefNumHits);
+
+    float      RefClosest            = +FLT_MAX;
+    const auto ScalarRayTriangleTime = Measure([&]() {
+        RefClosest = +FLT_MAX;
+        for (size_t i = 0; i < NumTriangles; ++i)
+        {
+            const auto Dist = IntersectRayTriangle(Points[i * 3 + 0], Points[i * 3 + 1], Points[i * 3 + 2], RayOrigin, RayDir);
+            if (Dist >= 0)
+                RefClosest = std::min(RefClosest, Dist);
+        }
+    });
+    float      Closest               = +FLT_MAX;
+    const auto RayTriangleTime       = Measure([&]() {
+        Closest = IntersectRayTriangles(RayOrigin, RayDir, Points.data(), nullptr, NumTriangles);
+    });
+    ExpectNearDistance(Closest, RefClosest);
+
+    LOG_INFO_MESSAGE("Bulk math (", Count, " elements x ", NumPasses, " passes), scalar vs bulk, ms:"
+                                                                      "\n    TransformPoints:       ",
+                     ScalarTransformTime, " vs ", TransformTime,
+                     "\n    ComputeBoundBox:       ", ScalarBoundBoxTime, " vs ", BoundBoxTime,
+                     "\n    TransformBoundBoxes:   ", ScalarBoxTransformTime, " vs ", BoxTransformTime,
+                     "\n    IntersectRayBoxes:     ", ScalarRayBoxTime, " vs ", RayBoxTime,
+                     "\n    IntersectRayTriangles: ", ScalarRayTriangleTime, " vs ", RayTriangleTime);
+}
+
 } // namespace
@@ -35,6 +35,7 @@
 #include "RefCntAutoPtr.hpp"
 #include "RefCountedObjectImpl.hpp"
 #include "ThreadSignal.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -904,4 +905,381 @@ TEST(Common_RefCntAutoPtr, Threading)
     ThreadingTest.RunConcurrencyTest();
 }
 
+
+TEST(Common_RefCntWeakPtr, NumWeakRefs)
+{
+    SmartPtr SP{MakeNewObj<Object>()};
+    auto*    pRefCounters = SP->GetReferenceCounters();
+    EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 1);
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 0);
+
+    // Reference counters must stay alive while there are weak references
+    pRefCounters->AddWeakRef();
+    {
+        WeakPtr WP1{SP};
+        WeakPtr WP2{WP1};
+        EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 3);
+    }
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+
+    SP.Release();
+    EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 0);
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+
+    RefCntAutoPtr<IObject> pObj;
+    pRefCounters->GetObject(&pObj);
+    EXPECT_FALSE(pObj);
+
+    EXPECT_EQ(pRefCounters->ReleaseWeakRef(), 0);
+}
+
+TEST(Common_RefCntWeakPtr, ThrowingConstructor)
+{
+    class ThrowingObject : public RefCountedObject<IObject>
+    {
+    public:
+        ThrowingObject(IReferenceCounters* pRefCounters, RefCntWeakPtr<ThrowingObject>& SelfRef) :
+            RefCountedObject<IObject>{pRefCounters}
+        {
+            // Create weak references to the object itself. One of them outlives the object.
+            RefCntWeakPtr<ThrowingObject> TmpRef{this};
+            SelfRef = TmpRef;
+            throw std::runtime_error{"Test exception"};
+        }
+
+        virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final
+        {
+            *ppInterface = nullptr;
+        }
+    };
+
+    RefCntWeakPtr<ThrowingObject> SelfRef;
+    EXPECT_THROW(MakeNewRCObj<ThrowingObject>{}(SelfRef), std::runtime_error);
+    EXPECT_FALSE(SelfRef.IsValid());
+    EXPECT_FALSE(SelfRef.Lock());
+}
+
+
+class TrackedObject final : public Object
+{
+public:
+    TrackedObject(IReferenceCounters* pRefCounters) :
+        Object{pRefCounters}
+    {
+        ++NumAlive;
+    }
+
+    ~TrackedObject()
+    {
+        m_IsAlive = false;
+        --NumAlive;
+    }
+
+    std::atomic_bool m_IsAlive{true};
+
+    static std::atomic_int NumAlive;
+};
+std::atomic_int TrackedObject::NumAlive{0};
+
+TEST(Common_RefCntWeakPtr, ConcurrentLock)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr int NumRounds = 200;
+#else
+    constexpr int    NumRounds            = 2000;
+#endif
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    for (int round = 0; round < NumRounds; ++round)
+    {
+        RefCntAutoPtr<TrackedObject> pObj{MakeNewObj<TrackedObject>()};
+        RefCntWeakPtr<TrackedObject> pWeakObj{pObj};
+
+        std::atomic_int NumReady{0};
+        std::atomic_int NumFailures{0};
+
+        std::vector<std::thread> Threads(NumThreads);
+        for (auto& t : Threads)
+        {
+            t = std::thread{
+                [&, pWeakObj]() mutable //
+                {
+                    ++NumReady;
+                    // Keep promoting the weak pointer until the object is destroyed
+                    // or the iteration limit is reached
+                    bool IsDestroyed = false;
+                    for (int i = 0; i < 1000 && !IsDestroyed; ++i)
+                    {
+                        auto pStrongObj = pWeakObj.Lock();
+                        if (pStrongObj)
+                        {
+                            if (!pStrongObj->m_IsAlive)
+                                ++NumFailures;
+                            pStrongObj->m_Value++;
+                        }
+                        else
+                        {
+                            IsDestroyed = true;
+                        }
+                    }
+                    // Once the object is destroyed, it can never be revived
+                    if (IsDestroyed && pWeakObj.Lock())
+                        ++NumFailures;
+                } //
+            };
+        }
+
+        while (NumReady < static_cast<int>(NumThreads))
+            std::this_thread::yield();
+        // Release the last external strong reference while other threads are promoting
+        // their weak references, so that the object may be destroyed by any of them.
+        pObj.Release();
+
+        for (auto& t : Threads)
+            t.join();
+
+        EXPECT_EQ(NumFailures, 0);
+        EXPECT_FALSE(pWeakObj.Lock());
+        EXPECT_EQ(TrackedObject::NumAlive, 0);
+    }
+}
+
+TEST(Common_RefCntWeakPtr, AssignSharedCounters)
+{
+    class OwnerObject : public RefCountedObject<IObject>
+    {
+    public:
+        class MemberObject : public RefCountedObject<IObject>
+        {
+        public:
+            MemberObject(IReferenceCounters* pRefCounters) :
+                RefCountedObject<IObject>{pRefCounters}
+            {}
+            virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) {}
+        };
+
+        OwnerObject(IReferenceCounters* pRefCounters) :
+            RefCountedObject<IObject>{pRefCounters}
+        {
+            m_pMember = NEW_RC_OBJ(DefaultRawMemoryAllocator::GetAllocator(), "Member object", MemberObject, this)();
+        }
+        ~OwnerObject()
+        {
+            m_pMember->~MemberObject();
+            DefaultRawMemoryAllocator::GetAllocator().Free(m_pMember);
+        }
+        virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) {}
+
+        MemberObject* m_pMember = nullptr;
+    };
+
+    RefCntAutoPtr<OwnerObject> pOwner{NEW_RC_OBJ(DefaultRawMemoryAllocator::GetAllocator(), "Owner object", OwnerObject)()};
+    auto*                      pRefCounters = pOwner->GetReferenceCounters();
+    ASSERT_EQ(pOwner->m_pMember->GetReferenceCounters(), pRefCounters);
+
+    RefCntWeakPtr<IObject> wpObj{pOwner};
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+
+    // Assigning the same object must not touch the counters
+    wpObj = pOwner.RawPtr();
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+
+    // The member shares the reference counters with the owner, but
+    // the weak pointer must still be updated to reference the member.
+    wpObj = pOwner->m_pMember;
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+    EXPECT_EQ(wpObj.Lock().RawPtr(), pOwner->m_pMember);
+
+    wpObj = nullptr;
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 0);
+    EXPECT_FALSE(wpObj.Lock());
+}
+
+TEST(Common_RefCntWeakPtr, AssignReusedAddress)
+{
+    // Allocator that always returns the same memory block, so that
+    // every new object is created at the same address
+    class ReusingAllocator final : public IMemoryAllocator
+    {
+    public:
+        virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final
+        {
+            VERIFY_EXPR(Size <= sizeof(m_Buffer) && !m_IsAllocated);
+            m_IsAllocated = true;
+            return m_Buffer;
+        }
+        virtual void Free(void* Ptr) override final
+        {
+            VERIFY_EXPR(Ptr == m_Buffer && m_IsAllocated);
+            m_IsAllocated = false;
+        }
+
+    private:
+        alignas(std::max_align_t) Uint8 m_Buffer[sizeof(Object)];
+
+        bool m_IsAllocated = false;
+    };
+    ReusingAllocator Allocator;
+
+    auto* pObj0 = NEW_RC_OBJ(Allocator, "Object 0", Object)();
+
+    WeakPtr wpObj{pObj0};
+    pObj0->AddRef();
+    pObj0->Release();
+    // Note that Lock() would release the expired weak pointer
+    EXPECT_FALSE(wpObj.IsValid());
+
+    SmartPtr pObj1{NEW_RC_OBJ(Allocator, "Object 1", Object)()};
+    ASSERT_EQ(pObj1.RawPtr(), pObj0);
+
+    // The address is the same, but the object is different and
+    // the weak pointer must reference the new reference counters.
+    wpObj        = pObj1.RawPtr();
+    auto pLocked = wpObj.Lock();
+    EXPECT_EQ(pLocked, pObj1);
+    EXPECT_EQ(pObj1->GetReferenceCounters()->GetNumWeakRefs(), 1);
+}
+
+TEST(Common_RefCntBorrowedPtr, ReferenceCounters)
+{
+    RefCntAutoPtr<DerivedObject> pObj{MakeNewObj<DerivedObject>()};
+    auto*                        pRefCounters = pObj->GetReferenceCounters();
+
+    WeakPtr wpObj{pObj};
+    EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 1);
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+
+    {
+        RefCntBorrowedPtr<DerivedObject> bpDerived{pObj};
+        RefCntBorrowedPtr<Object>        bpObj{bpDerived};
+        RefCntBorrowedPtr<Object>        bpObj2 = bpObj;
+        RefCntBorrowedPtr<Object>        bpNull{nullptr};
+
+        EXPECT_EQ(bpDerived.RawPtr(), pObj.RawPtr());
+        EXPECT_EQ(bpObj.RawPtr(), pObj.RawPtr());
+        EXPECT_EQ(bpObj, bpObj2);
+        EXPECT_NE(bpObj, bpNull);
+        EXPECT_TRUE(bpObj);
+        EXPECT_FALSE(bpNull);
+        EXPECT_EQ(bpDerived->m_Value2, 1);
+        EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 1);
+        EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+
+        // Storing the borrowed object takes a strong reference
+        SmartPtr pStored;
+        pStored = bpObj.RawPtr();
+        EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 2);
+
+        // Storing the same object again does not touch the counters
+        pStored = bpObj2.RawPtr();
+        EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 2);
+    }
+    EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 1);
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+
+    // Borrowed pointers do not keep the object alive
+    {
+        RefCntBorrowedPtr<Object> bpObj{pObj};
+        pObj.Release();
+        EXPECT_FALSE(wpObj.Lock());
+    }
+}
+
+TEST(Common_RefCntAutoPtr, DISABLED_PerDrawOverheadBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr int NumDraws = 10000;
+#else
+    constexpr int    NumDraws             = 1000000;
+#endif
+    // Typical number of resources and SRBs bound for every draw call
+    constexpr size_t NumResources = 8;
+    constexpr size_t NumSRBs      = 2;
+
+    std::vector<SmartPtr> Resources(NumResources);
+    for (auto& pRes : Resources)
+        pRes = SmartPtr{MakeNewObj<Object>()};
+
+    std::vector<SmartPtr> BoundResources(NumResources);
+    std::vector<WeakPtr>  BoundSRBs(NumSRBs);
+
+    // The same resources are rebound for every draw, which is the most common case.
+    enum BIND_MODE
+    {
+        // Query the interface into a temporary strong pointer, pass it by value and assign
+        // temporary weak pointers. This does atomic operations even if the object does not change.
+        BIND_MODE_TEMPORARIES,
+
+        // Query the interface into a temporary strong pointer and pass it by reference.
+        BIND_MODE_QUERY,
+
+        // Borrow the object if it is already bound, otherwise query the interface.
+        // This is what the D3D11 shader variables do.
+        BIND_MODE_BORROWED
+    };
+    auto RunBenchmark = [&](BIND_MODE Mode) {
+        auto BindByValue = [](SmartPtr& Dst, SmartPtr Src) {
+            Dst = std::move(Src);
+        };
+        auto BindBorrowed = [](SmartPtr& Dst, RefCntBorrowedPtr<Object> Src) {
+            Dst = Src.RawPtr();
+        };
+
+        Timer T;
+        for (int draw = 0; draw < NumDraws; ++draw)
+        {
+            for (size_t i = 0; i < NumResources; ++i)
+            {
+                IObject* pObject = Resources[i];
+                switch (Mode)
+                {
+                    case BIND_MODE_TEMPORARIES:
+                        BindByValue(BoundResources[i], SmartPtr{pObject, IID_Unknown});
+                        break;
+
+                    case BIND_MODE_QUERY:
+                    {
+                        SmartPtr pQueried{pObject, IID_Unknown};
+                        BindBorrowed(BoundResources[i], pQueried);
+                        break;
+                    }
+
+                    case BIND_MODE_BORROWED:
+                        if (pObject == BoundResources[i].RawPtr())
+                        {
+                            BindBorrowed(BoundResources[i], RefCntBorrowedPtr<Object>{ValidatedCast<Object>(pObject)});
+                        }
+                        else
+                        {
+                            SmartPtr pQueried{pObject, IID_Unknown};
+                            BindBorrowed(BoundResources[i], pQueried);
+                        }
+                        break;
+                }
+            }
+
+            for (size_t i = 0; i < NumSRBs; ++i)
+            {
+                if (Mode == BIND_MODE_TEMPORARIES)
+                    BoundSRBs[i] = WeakPtr{Resources[i].RawPtr()};
+                else
+                    BoundSRBs[i] = Resources[i].RawPtr();
+            }
+        }
+        return T.GetElapsedTime() / NumDraws * 1e9;
+    };
+
+    const auto TemporariesTime = RunBenchmark(BIND_MODE_TEMPORARIES);
+    const auto QueryTime       = RunBenchmark(BIND_MODE_QUERY);
+    const auto BorrowedTime    = RunBenchmark(BIND_MODE_BORROWED);
+    LOG_INFO_MESSAGE("Per-draw binding overhead (", NumResources, " resources, ", NumSRBs, " SRBs): temporaries: ",
+                     TemporariesTime, " ns, query: ", QueryTime, " ns, borrowed: ", BorrowedTime, " ns");
+
+    for (size_t i = 0; i < NumResources; ++i)
+    {
+        EXPECT_EQ(BoundResources[i], Resources[i]);
+        EXPECT_EQ(BoundResources[i]->GetReferenceCounters()->GetNumStrongRefs(), 2);
+    }
+}
+
 } // namespace
@@ -0,0 +1,294 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.hpp"
+#include "AsyncInitializer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Blocks tasks until the test opens it
+class Gate
+{
+public:
+    void Open()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_IsOpen = true;
+        m_CondVar.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+        m_CondVar.wait(Lock, [this] { return m_IsOpen; });
+    }
+
+private:
+    std::mutex              m_Mtx;
+    std::condition_variable m_CondVar;
+    bool                    m_IsOpen = false;
+};
+
+TEST(Common_ThreadPool, ExecuteTasks)
+{
+    for (Uint32 NumThreads : {0u, 1u, 4u})
+    {
+        ThreadPool Pool{NumThreads};
+        EXPECT_GE(Pool.GetNumThreads(), 1u);
+
+        constexpr int    NumTasks = 1000;
+        std::atomic<int> Counter{0};
+        std::vector<int> Results(NumTasks);
+        for (int i = 0; i < NumTasks; ++i)
+        {
+            Pool.EnqueueTask([&, i]() {
+                Results[i] = i * i;
+                ++Counter;
+            });
+        }
+        Pool.WaitForAllTasks();
+
+        EXPECT_EQ(Counter, NumTasks);
+        for (int i = 0; i < NumTasks; ++i)
+            EXPECT_EQ(Results[i], i * i);
+    }
+}
+
+TEST(Common_ThreadPool, DestructorFinishesTasks)
+{
+    std::atomic<int> Counter{0};
+    {
+        ThreadPool Pool{2};
+        for (int i = 0; i < 100; ++i)
+            Pool.EnqueueTask([&Counter]() { ++Counter; });
+    }
+    EXPECT_EQ(Counter, 100);
+}
+
+TEST(Common_ThreadPool, WaitForPreviousTask)
+{
+    // A task that waits for the task enqueued before it must not deadlock
+    // even if there is only one worker thread.
+    ThreadPool Pool{1};
+
+    std::atomic<int> Counter{0};
+
+    AsyncInitializer First{Pool, [&Counter]() {
+                               ++Counter;
+                           }};
+    AsyncInitializer Second{Pool, [&]() {
+                                EXPECT_EQ(First.GetStatus(true), AsyncInitializer::Status::Completed);
+                                ++Counter;
+                            }};
+
+    EXPECT_EQ(Second.GetStatus(true), AsyncInitializer::Status::Completed);
+    EXPECT_EQ(Counter, 2);
+}
+
+TEST(Common_ThreadPool, ParallelFor)
+{
+    constexpr Uint32 NumItems = 1000;
+
+    auto CheckItems = [](const std::vector<std::atomic<int>>& Items) {
+        for (Uint32 i = 0; i < NumItems; ++i)
+            EXPECT_EQ(Items[i], 1) << "Item " << i;
+    };
+
+    for (Uint32 NumThreads : {0u, 1u, 4u})
+    {
+        std::vector<std::atomic<int>> Items(NumItems);
+        ParallelFor(NumThreads, NumItems, [&](Uint32 i) { ++Items[i]; });
+        CheckItems(Items);
+    }
+
+    ThreadPool Pool{3};
+    for (int Loop = 0; Loop < 10; ++Loop)
+    {
+        std::vector<std::atomic<int>> Items(NumItems);
+        ParallelFor(Pool, NumItems, [&](Uint32 i) { ++Items[i]; });
+        CheckItems(Items);
+    }
+
+    ParallelFor(Pool, 0, [](Uint32) { ADD_FAILURE() << "No items must be processed"; });
+}
+
+TEST(Common_ThreadPool, ParallelForException)
+{
+    struct TestException
+    {
+        Uint32 Item;
+    };
+
+    for (Uint32 NumThreads : {1u, 4u})
+    {
+        std::atomic<Uint32> NumProcessed{0};
+        try
+        {
+            ParallelFor(NumThreads, 1000, [&](Uint32 i) {
+                if (i == 10)
+                    throw TestException{i};
+                // Other threads must not be able to process all remaining items
+                // while the exception is being thrown
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                ++NumProcessed;
+            });
+            ADD_FAILURE() << "The exception must be rethrown";
+        }
+        catch (const TestException& Ex)
+        {
+            EXPECT_EQ(Ex.Item, 10u);
+        }
+        // The remaining items are skipped
+        EXPECT_LT(NumProcessed, 999u);
+    }
+
+    // The pool must still be usable
+    ThreadPool       Pool{2};
+    std::atomic<int> Counter{0};
+    EXPECT_THROW(ParallelFor(Pool, 100, [](Uint32) { throw std::bad_alloc{}; }), std::bad_alloc);
+    ParallelFor(Pool, 100, [&](Uint32) { ++Counter; });
+    EXPECT_EQ(Counter, 100);
+}
+
+TEST(Common_ThreadPool, ParallelForNested)
+{
+    // Nested loops on the same pool must not wait for tasks that are queued behind the outer loop tasks
+    ThreadPool       Pool{2};
+    std::atomic<int> Counter{0};
+    ParallelFor(Pool, 8, [&](Uint32) {
+        ParallelFor(Pool, 16, [&](Uint32) {
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+            ++Counter;
+        });
+    });
+    EXPECT_EQ(Counter, 8 * 16);
+
+    std::atomic<int> NumWorkerItems{0};
+    Pool.EnqueueTask([&]() {
+        EXPECT_TRUE(Pool.IsWorkerThread());
+        ParallelFor(Pool, 16, [&](Uint32) {
+            // All items are processed by the calling worker thread
+            if (Pool.IsWorkerThread())
+                ++NumWorkerItems;
+        });
+    });
+    Pool.WaitForAllTasks();
+    EXPECT_EQ(NumWorkerItems, 16);
+    EXPECT_FALSE(Pool.IsWorkerThread());
+}
+
+TEST(Common_ThreadPool, SharedPool)
+{
+    auto& SharedPool = GetSharedThreadPool();
+    EXPECT_EQ(&SharedPool, &GetSharedThreadPool());
+    EXPECT_GE(SharedPool.GetNumThreads(), 1u);
+
+    // Loops that do not provide a pool run on the shared pool and the calling thread
+    const auto       CallerId = std::this_thread::get_id();
+    std::atomic<int> NumItems{0};
+    for (int Loop = 0; Loop < 3; ++Loop)
+    {
+        ParallelFor(4, 100, [&](Uint32) {
+            EXPECT_TRUE(std::this_thread::get_id() == CallerId || SharedPool.IsWorkerThread());
+            ++NumItems;
+        });
+    }
+    EXPECT_EQ(NumItems, 300);
+
+    // Nested loops on the shared pool
+    NumItems = 0;
+    ParallelFor(4, 4, [&](Uint32) {
+        ParallelFor(4, 4, [&](Uint32) { ++NumItems; });
+    });
+    EXPECT_EQ(NumItems, 16);
+}
+
+TEST(Common_AsyncInitializer, Status)
+{
+    ThreadPool Pool{2};
+
+    Gate TaskGate;
+
+    AsyncInitializer Succeeded{Pool, [&TaskGate]() {
+                                   TaskGate.Wait();
+                               }};
+    AsyncInitializer Failed{Pool, [&TaskGate]() {
+                                TaskGate.Wait();
+                                throw std::runtime_error{"Initialization error"};
+                            }};
+
+    EXPECT_EQ(Succeeded.GetStatus(), AsyncInitializer::Status::Running);
+    EXPECT_EQ(Failed.GetStatus(), AsyncInitializer::Status::Running);
+
+    TaskGate.Open();
+
+    EXPECT_EQ(Succeeded.GetStatus(true), AsyncInitializer::Status::Completed);
+    EXPECT_EQ(Failed.GetStatus(true), AsyncInitializer::Status::Failed);
+    // The status must not change after the task is complete
+    EXPECT_EQ(Succeeded.GetStatus(), AsyncInitializer::Status::Completed);
+    EXPECT_EQ(Failed.GetStatus(), AsyncInitializer::Status::Failed);
+}
+
+TEST(Common_AsyncInitializer, DestroyWhileRunning)
+{
+    ThreadPool Pool{4};
+
+    std::atomic<int> NumCompleted{0};
+    for (int i = 0; i < 100; ++i)
+    {
+        std::unique_ptr<int> pData{new int{i}};
+
+        auto pInitializer = std::make_unique<AsyncInitializer>(
+            Pool,
+            [&NumCompleted, pRawData = pData.get(), i]() {
+                EXPECT_EQ(*pRawData, i);
+                ++NumCompleted;
+            });
+
+        // The destructor must wait for the task that accesses the data
+        pInitializer.reset();
+        pData.reset();
+    }
+    EXPECT_EQ(NumCompleted, 100);
+}
+
+} // namespace
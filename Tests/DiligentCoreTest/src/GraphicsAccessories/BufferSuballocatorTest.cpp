@@ -0,0 +1,254 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "BufferSuballocator.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "RefCntAutoPtr.hpp"
+#include "FastRand.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+RefCntAutoPtr<IBufferSuballocator> CreateSuballocator(Uint32 Size, Uint32 ExpansionSize)
+{
+    BufferSuballocatorCreateInfo CI;
+    CI.Desc.Name          = "Buffer suballocator test";
+    CI.Desc.BindFlags     = BIND_VERTEX_BUFFER;
+    CI.Desc.uiSizeInBytes = Size;
+    CI.ExpansionSize      = ExpansionSize;
+
+    // The buffer is not needed to test the suballocation logic and will never be created
+    RefCntAutoPtr<IBufferSuballocator> pAllocator;
+    CreateBufferSuballocator(nullptr, CI, &pAllocator);
+    return pAllocator;
+}
+
+void VerifyNoOverlap(const std::vector<RefCntAutoPtr<IBufferSuballocation>>& Suballocations)
+{
+    std::vector<std::pair<Uint32, Uint32>> Ranges;
+    for (const auto& pSuballoc : Suballocations)
+    {
+        if (pSuballoc)
+            Ranges.emplace_back(pSuballoc->GetOffset(), pSuballoc->GetOffset() + pSuballoc->GetSize());
+    }
+    std::sort(Ranges.begin(), Ranges.end());
+    for (size_t i = 1; i < Ranges.size(); ++i)
+        EXPECT_LE(Ranges[i - 1].second, Ranges[i].first);
+}
+
+TEST(GraphicsTools_BufferSuballocator, Defragment)
+{
+    auto pAllocator = CreateSuballocator(1024, 0);
+    ASSERT_TRUE(pAllocator);
+
+    std::vector<RefCntAutoPtr<IBufferSuballocation>> Suballocations(16);
+    for (auto& pSuballoc : Suballocations)
+    {
+        pAllocator->Allocate(64, 16, &pSuballoc);
+        ASSERT_TRUE(pSuballoc);
+    }
+    EXPECT_EQ(pAllocator->GetFreeSize(), 0u);
+
+    // |  |01|  |03|  |05|  |07|  |09|  |11|  |13|  |15|
+    for (size_t i = 0; i < Suballocations.size(); i += 2)
+        Suballocations[i].Release();
+
+    const auto Version = pAllocator->GetVersion();
+
+    Uint32      NumMoves = 0;
+    const auto* pMoves   = pAllocator->BeginDefragmentation(~0u, NumMoves);
+    ASSERT_EQ(NumMoves, 4u);
+    ASSERT_NE(pMoves, nullptr);
+
+    // Suballocations from the end of the buffer are moved to the free space at the beginning
+    // |13|01|11|03|09|05|  |07|  |  |  |  |  |  |  |  |
+    const Uint32 RefSrcOffsets[] = {15 * 64, 13 * 64, 11 * 64, 9 * 64};
+    const Uint32 RefDstOffsets[] = {0, 2 * 64, 4 * 64, 6 * 64};
+    for (Uint32 i = 0; i < NumMoves; ++i)
+    {
+        EXPECT_EQ(pMoves[i].SrcOffset, RefSrcOffsets[i]);
+        EXPECT_EQ(pMoves[i].DstOffset, RefDstOffsets[i]);
+        EXPECT_EQ(pMoves[i].Size, 64u);
+    }
+
+    // Offsets must not change until the pass ends
+    EXPECT_EQ(Suballocations[15]->GetOffset(), 15u * 64u);
+    EXPECT_EQ(pAllocator->GetVersion(), Version);
+    // Destination regions are reserved
+    EXPECT_EQ(pAllocator->GetFreeSize(), 4u * 64u);
+
+    pAllocator->EndDefragmentation();
+    EXPECT_EQ(pAllocator->GetVersion(), Version + 1);
+    EXPECT_EQ(pAllocator->GetFreeSize(), 8u * 64u);
+    EXPECT_EQ(Suballocations[15]->GetOffset(), 0u);
+    EXPECT_EQ(Suballocations[13]->GetOffset(), 2u * 64u);
+    EXPECT_EQ(Suballocations[11]->GetOffset(), 4u * 64u);
+    EXPECT_EQ(Suballocations[9]->GetOffset(), 6u * 64u);
+    EXPECT_EQ(Suballocations[7]->GetOffset(), 7u * 64u);
+    VerifyNoOverlap(Suballocations);
+
+    // The first half of the buffer is now fully occupied
+    RefCntAutoPtr<IBufferSuballocation> pLarge;
+    pAllocator->Allocate(8 * 64, 16, &pLarge);
+    ASSERT_TRUE(pLarge);
+    EXPECT_EQ(pLarge->GetOffset(), 8u * 64u);
+    pLarge.Release();
+
+    // Nothing to move
+    pMoves = pAllocator->BeginDefragmentation(~0u, NumMoves);
+    EXPECT_EQ(NumMoves, 0u);
+    EXPECT_EQ(pMoves, nullptr);
+    pAllocator->EndDefragmentation();
+    EXPECT_EQ(pAllocator->GetVersion(), Version + 1);
+}
+
+TEST(GraphicsTools_BufferSuballocator, DefragmentBudget)
+{
+    auto pAllocator = CreateSuballocator(1024, 0);
+    ASSERT_TRUE(pAllocator);
+
+    std::vector<RefCntAutoPtr<IBufferSuballocation>> Suballocations(16);
+    for (size_t i = 0; i < Suballocations.size(); ++i)
+        pAllocator->Allocate(i < 8 ? 64 : 32, 1, &Suballocations[i]);
+
+    for (size_t i = 0; i < 8; i += 2)
+        Suballocations[i].Release();
+
+    // Only two 32-byte suballocations fit into the budget
+    Uint32      NumMoves = 0;
+    const auto* pMoves   = pAllocator->BeginDefragmentation(80, NumMoves);
+    ASSERT_EQ(NumMoves, 2u);
+    Uint32 BytesMoved = 0;
+    for (Uint32 i = 0; i < NumMoves; ++i)
+        BytesMoved += pMoves[i].Size;
+    EXPECT_LE(BytesMoved, 80u);
+    pAllocator->EndDefragmentation();
+    VerifyNoOverlap(Suballocations);
+
+    // Large suballocations are skipped, but the small ones still fit
+    pMoves = pAllocator->BeginDefragmentation(48, NumMoves);
+    ASSERT_EQ(NumMoves, 1u);
+    EXPECT_EQ(pMoves[0].Size, 32u);
+    pAllocator->EndDefragmentation();
+    VerifyNoOverlap(Suballocations);
+}
+
+TEST(GraphicsTools_BufferSuballocator, ReleaseDuringDefragmentation)
+{
+    auto pAllocator = CreateSuballocator(1024, 0);
+    ASSERT_TRUE(pAllocator);
+
+    std::vector<RefCntAutoPtr<IBufferSuballocation>> Suballocations(16);
+    for (auto& pSuballoc : Suballocations)
+        pAllocator->Allocate(64, 1, &pSuballoc);
+
+    for (size_t i = 0; i < Suballocations.size(); i += 2)
+        Suballocations[i].Release();
+
+    const auto Version = pAllocator->GetVersion();
+
+    Uint32 NumMoves = 0;
+    pAllocator->BeginDefragmentation(~0u, NumMoves);
+    EXPECT_EQ(NumMoves, 4u);
+
+    // Release all suballocations that are being moved
+    Suballocations[15].Release();
+    Suballocations[13].Release();
+    IBufferSuballocation* pSuballocs[] = {Suballocations[11].Detach(), Suballocations[9].Detach()};
+    pAllocator->ReleaseMultiple(_countof(pSuballocs), pSuballocs);
+
+    // Internal state of one of the released suballocations will be reused
+    pAllocator->Allocate(64, 1, &Suballocations[15]);
+    EXPECT_EQ(Suballocations[15]->GetOffset(), 8u * 64u);
+
+    pAllocator->EndDefragmentation();
+    EXPECT_EQ(pAllocator->GetVersion(), Version);
+    EXPECT_EQ(Suballocations[15]->GetOffset(), 8u * 64u);
+    EXPECT_EQ(pAllocator->GetFreeSize(), 11u * 64u);
+
+    Suballocations.clear();
+    EXPECT_EQ(pAllocator->GetFreeSize(), 1024u);
+}
+
+TEST(GraphicsTools_BufferSuballocator, DefragmentRandom)
+{
+    auto pAllocator = CreateSuballocator(1024, 1024);
+    ASSERT_TRUE(pAllocator);
+
+    FastRandInt Rnd{0, 0, 30000};
+
+    std::vector<RefCntAutoPtr<IBufferSuballocation>> Suballocations(256);
+    for (int Pass = 0; Pass < 32; ++Pass)
+    {
+        for (auto& pSuballoc : Suballocations)
+        {
+            if (Rnd() % 2 == 0)
+                pSuballoc.Release();
+            else if (!pSuballoc)
+                pAllocator->Allocate(1 + Rnd() % 256, 1u << (Rnd() % 6), &pSuballoc);
+        }
+
+        Uint32      NumMoves = 0;
+        const auto* pMoves   = pAllocator->BeginDefragmentation(4096, NumMoves);
+
+        Uint32 BytesMoved = 0;
+        for (Uint32 i = 0; i < NumMoves; ++i)
+        {
+            EXPECT_LT(pMoves[i].DstOffset, pMoves[i].SrcOffset);
+            BytesMoved += pMoves[i].Size;
+            for (Uint32 j = 0; j < NumMoves; ++j)
+            {
+                // Destination regions must not overlap any other region
+                EXPECT_TRUE(pMoves[i].DstOffset + pMoves[i].Size <= pMoves[j].SrcOffset || pMoves[i].DstOffset >= pMoves[j].SrcOffset + pMoves[j].Size);
+                if (i != j)
+                {
+                    EXPECT_TRUE(pMoves[i].DstOffset + pMoves[i].Size <= pMoves[j].DstOffset || pMoves[i].DstOffset >= pMoves[j].DstOffset + pMoves[j].Size);
+                }
+            }
+        }
+        EXPECT_LE(BytesMoved, 4096u);
+
+        // Release some suballocations while the pass is in progress
+        for (auto& pSuballoc : Suballocations)
+        {
+            if (Rnd() % 8 == 0)
+                pSuballoc.Release();
+        }
+
+        pAllocator->EndDefragmentation();
+        VerifyNoOverlap(Suballocations);
+    }
+}
+
+} // namespace
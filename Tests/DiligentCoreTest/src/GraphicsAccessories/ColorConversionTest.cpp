@@ -0,0 +1,455 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ColorConversion.h"
+#include "GraphicsAccessories.hpp"
+#include "BasicMath.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+template <typename DstType, typename SrcType>
+std::vector<DstType> ConvertTexels(TEXTURE_FORMAT SrcFormat, TEXTURE_FORMAT DstFormat, const std::vector<SrcType>& Src, bool UseSIMD = true)
+{
+    const auto SrcTexelSize = GetTextureFormatAttribs(SrcFormat).GetElementSize();
+    const auto DstTexelSize = GetTextureFormatAttribs(DstFormat).GetElementSize();
+    const auto NumTexels    = static_cast<Uint32>(Src.size() * sizeof(SrcType) / SrcTexelSize);
+
+    std::vector<DstType> Dst(NumTexels * DstTexelSize / sizeof(DstType));
+
+    TextureDataConversionAttribs Attribs;
+    Attribs.Width     = NumTexels;
+    Attribs.Height    = 1;
+    Attribs.SrcFormat = SrcFormat;
+    Attribs.pSrcData  = Src.data();
+    Attribs.SrcStride = NumTexels * SrcTexelSize;
+    Attribs.DstFormat = DstFormat;
+    Attribs.pDstData  = Dst.data();
+    Attribs.DstStride = NumTexels * DstTexelSize;
+    Attribs.UseSIMD   = UseSIMD;
+    ConvertTextureData(Attribs);
+
+    return Dst;
+}
+
+float HalfToFloatRef(Uint16 Half)
+{
+    const int   Exp  = (Half >> 10) & 0x1F;
+    const int   Mant = Half & 0x3FF;
+    const float Sign = (Half & 0x8000) ? -1.f : 1.f;
+    if (Exp == 31)
+        return Mant == 0 ? Sign * INFINITY : NAN;
+    else if (Exp == 0)
+        return Sign * std::ldexp(static_cast<float>(Mant), -24);
+    else
+        return Sign * std::ldexp(static_cast<float>(Mant + 1024), Exp - 25);
+}
+
+TEST(GraphicsAccessories_ColorConversion, IsTextureFormatConversionSupported)
+{
+    EXPECT_TRUE(IsTextureFormatConversionSupported(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BGRA8_UNORM_SRGB));
+    EXPECT_TRUE(IsTextureFormatConversionSupported(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA16_FLOAT));
+    EXPECT_TRUE(IsTextureFormatConversionSupported(TEX_FORMAT_R11G11B10_FLOAT, TEX_FORMAT_RGB9E5_SHAREDEXP));
+    EXPECT_TRUE(IsTextureFormatConversionSupported(TEX_FORMAT_RG16_SNORM, TEX_FORMAT_RGB32_FLOAT));
+    EXPECT_TRUE(IsTextureFormatConversionSupported(TEX_FORMAT_A8_UNORM, TEX_FORMAT_RGB10A2_UNORM));
+    EXPECT_TRUE(IsTextureFormatConversionSupported(TEX_FORMAT_RGBA8_UINT, TEX_FORMAT_RGBA8_UINT));
+    EXPECT_TRUE(IsTextureFormatConversionSupported(TEX_FORMAT_D32_FLOAT, TEX_FORMAT_D32_FLOAT));
+
+    EXPECT_FALSE(IsTextureFormatConversionSupported(TEX_FORMAT_RGBA8_UINT, TEX_FORMAT_RGBA8_UNORM));
+    EXPECT_FALSE(IsTextureFormatConversionSupported(TEX_FORMAT_RGBA8_TYPELESS, TEX_FORMAT_RGBA8_UNORM));
+    EXPECT_FALSE(IsTextureFormatConversionSupported(TEX_FORMAT_D32_FLOAT, TEX_FORMAT_R32_FLOAT));
+    EXPECT_FALSE(IsTextureFormatConversionSupported(TEX_FORMAT_BC1_UNORM, TEX_FORMAT_RGBA8_UNORM));
+    EXPECT_FALSE(IsTextureFormatConversionSupported(TEX_FORMAT_BC1_UNORM, TEX_FORMAT_BC1_UNORM));
+    EXPECT_FALSE(IsTextureFormatConversionSupported(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_R1_UNORM));
+}
+
+TEST(GraphicsAccessories_ColorConversion, HalfFloat)
+{
+    std::vector<Uint16> AllHalfs(65536);
+    for (Uint32 i = 0; i < AllHalfs.size(); ++i)
+        AllHalfs[i] = static_cast<Uint16>(i);
+
+    for (bool UseSIMD : {false, true})
+    {
+        const auto Floats = ConvertTexels<float>(TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_RGBA32_FLOAT, AllHalfs, UseSIMD);
+        const auto Halfs  = ConvertTexels<Uint16>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA16_FLOAT, Floats, UseSIMD);
+        for (Uint32 i = 0; i < AllHalfs.size(); ++i)
+        {
+            const auto Ref = HalfToFloatRef(static_cast<Uint16>(i));
+            if (std::isnan(Ref))
+            {
+                // All NaNs are converted to 0x7E00 with the original sign
+                EXPECT_TRUE(std::isnan(Floats[i])) << i;
+                EXPECT_EQ(Halfs[i], (i & 0x8000u) | 0x7E00u) << i;
+            }
+            else
+            {
+                EXPECT_EQ(Floats[i], Ref) << i;
+                EXPECT_EQ(Halfs[i], i) << i;
+            }
+        }
+
+        // Rounding
+        const std::vector<float> Values = {
+            1.f + std::ldexp(1.f, -11), // Tie, round to even
+            1.f + std::ldexp(3.f, -11), // Tie, round to even
+            1.f + std::ldexp(1.f, -12),
+            std::ldexp(1.f, -25), // Denormal tie, round to even
+            std::ldexp(3.f, -25), // Denormal tie, round to even
+            std::ldexp(1.f, -26),
+            65504.f,
+            65519.f,
+            65520.f, // Rounds to infinity
+            -1e10f,
+            -std::ldexp(1.f, -24),
+            std::ldexp(1.f, -14),
+            std::numeric_limits<float>::quiet_NaN(),
+            -std::numeric_limits<float>::quiet_NaN(),
+            std::numeric_limits<float>::signaling_NaN(),
+        };
+        const std::vector<Uint16> RefHalfs = {
+            0x3C00,
+            0x3C02,
+            0x3C00,
+            0x0000,
+            0x0002,
+            0x0000,
+            0x7BFF,
+            0x7BFF,
+            0x7C00,
+            0xFC00,
+            0x8001,
+            0x0400,
+            0x7E00,
+            0xFE00,
+            0x7E00,
+        };
+        const auto Halfs2 = ConvertTexels<Uint16>(TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R16_FLOAT, Values, UseSIMD);
+        for (size_t i = 0; i < Values.size(); ++i)
+            EXPECT_EQ(Halfs2[i], RefHalfs[i]) << Values[i];
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, SRGB)
+{
+    std::vector<Uint8> AllValues(256 * 4);
+    for (Uint32 i = 0; i < AllValues.size(); ++i)
+        AllValues[i] = static_cast<Uint8>(i / 4);
+
+    for (bool UseSIMD : {false, true})
+    {
+        const auto Linear = ConvertTexels<float>(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA32_FLOAT, AllValues, UseSIMD);
+        for (Uint32 i = 0; i < AllValues.size(); ++i)
+        {
+            // Alpha is linear
+            const auto Ref = i % 4 == 3 ? static_cast<float>(AllValues[i]) / 255.f : SRGBToLinear(static_cast<float>(AllValues[i]) / 255.f);
+            EXPECT_NEAR(Linear[i], Ref, 1e-6f) << i;
+        }
+
+        const auto SRGB = ConvertTexels<Uint8>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM_SRGB, Linear, UseSIMD);
+        EXPECT_EQ(SRGB, AllValues);
+
+        FastRandFloat      Rnd{0, -0.1f, 1.1f};
+        std::vector<float> Values(4096);
+        for (auto& Val : Values)
+            Val = Rnd();
+        const auto SRGB2 = ConvertTexels<Uint8>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM_SRGB, Values, UseSIMD);
+        for (size_t i = 0; i < Values.size(); ++i)
+        {
+            if (i % 4 == 3)
+                continue;
+            const double x   = std::max(std::min(static_cast<double>(Values[i]), 1.0), 0.0);
+            const double s   = x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow(x, 1.0 / 2.4) - 0.055;
+            const auto   Ref = static_cast<int>(std::floor(s * 255.0 + 0.5));
+            EXPECT_EQ(SRGB2[i], Ref) << Values[i];
+        }
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, KnownValues)
+{
+    for (bool UseSIMD : {false, true})
+    {
+        // RGBA <-> BGRA
+        EXPECT_EQ(ConvertTexels<Uint8>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BGRA8_UNORM, std::vector<Uint8>{0x11, 0x22, 0x33, 0x44}, UseSIMD),
+                  (std::vector<Uint8>{0x33, 0x22, 0x11, 0x44}));
+        // Unused component is written as 0xFF and is ignored when reading
+        EXPECT_EQ(ConvertTexels<Uint8>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BGRX8_UNORM, std::vector<Uint8>{0x11, 0x22, 0x33, 0x44}, UseSIMD),
+                  (std::vector<Uint8>{0x33, 0x22, 0x11, 0xFF}));
+        EXPECT_EQ(ConvertTexels<Uint8>(TEX_FORMAT_BGRX8_UNORM, TEX_FORMAT_RGBA8_UNORM, std::vector<Uint8>{0x11, 0x22, 0x33, 0x44}, UseSIMD),
+                  (std::vector<Uint8>{0x33, 0x22, 0x11, 0xFF}));
+        // Missing components
+        EXPECT_EQ(ConvertTexels<Uint8>(TEX_FORMAT_R8_UNORM, TEX_FORMAT_RGBA8_UNORM, std::vector<Uint8>{0x80}, UseSIMD),
+                  (std::vector<Uint8>{0x80, 0, 0, 0xFF}));
+        EXPECT_EQ(ConvertTexels<Uint8>(TEX_FORMAT_A8_UNORM, TEX_FORMAT_RGBA8_UNORM, std::vector<Uint8>{0x80}, UseSIMD),
+                  (std::vector<Uint8>{0, 0, 0, 0x80}));
+        EXPECT_EQ(ConvertTexels<Uint8>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_A8_UNORM, std::vector<Uint8>{0x11, 0x22, 0x33, 0x44}, UseSIMD),
+                  (std::vector<Uint8>{0x44}));
+        // Signed normalized values
+        EXPECT_EQ(ConvertTexels<Int8>(TEX_FORMAT_RG32_FLOAT, TEX_FORMAT_RG8_SNORM, std::vector<float>{-2.f, 0.5f}, UseSIMD),
+                  (std::vector<Int8>{-127, 64}));
+        EXPECT_EQ(ConvertTexels<float>(TEX_FORMAT_RG8_SNORM, TEX_FORMAT_RG32_FLOAT, std::vector<Int8>{-128, 127}, UseSIMD),
+                  (std::vector<float>{-1.f, 1.f}));
+        // Clamping
+        EXPECT_EQ(ConvertTexels<Uint16>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA16_UNORM, std::vector<float>{-1.f, 2.f, 0.5f, NAN}, UseSIMD),
+                  (std::vector<Uint16>{0, 65535, 32768, 0}));
+        // Packed formats
+        EXPECT_EQ(ConvertTexels<Uint32>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGB10A2_UNORM, std::vector<float>{1.f, 0.5f, 0.f, 1.f}, UseSIMD),
+                  (std::vector<Uint32>{1023u | (512u << 10) | (3u << 30)}));
+        EXPECT_EQ(ConvertTexels<float>(TEX_FORMAT_RGB10A2_UNORM, TEX_FORMAT_RGBA32_FLOAT, std::vector<Uint32>{1023u | (3u << 30)}, UseSIMD),
+                  (std::vector<float>{1.f, 0.f, 0.f, 1.f}));
+
+        const std::vector<float> RGB = {1.f, 0.5f, 2.f, 0.f, 0.25f, 0.125f, 65024.f, 0.f, 4032.f, 0.f, 0.f, 0.f};
+        EXPECT_EQ(ConvertTexels<float>(TEX_FORMAT_R11G11B10_FLOAT, TEX_FORMAT_RGB32_FLOAT,
+                                       ConvertTexels<Uint32>(TEX_FORMAT_RGB32_FLOAT, TEX_FORMAT_R11G11B10_FLOAT, RGB, UseSIMD), UseSIMD),
+                  RGB);
+        // 4032 shares the exponent with 65024 and is rounded to 32 * 2^7
+        EXPECT_EQ(ConvertTexels<float>(TEX_FORMAT_RGB9E5_SHAREDEXP, TEX_FORMAT_RGB32_FLOAT,
+                                       ConvertTexels<Uint32>(TEX_FORMAT_RGB32_FLOAT, TEX_FORMAT_RGB9E5_SHAREDEXP, RGB, UseSIMD), UseSIMD),
+                  (std::vector<float>{1.f, 0.5f, 2.f, 0.f, 0.25f, 0.125f, 65024.f, 0.f, 4096.f, 0.f, 0.f, 0.f}));
+        // Negative values and values that are too large are clamped
+        EXPECT_EQ(ConvertTexels<float>(TEX_FORMAT_R11G11B10_FLOAT, TEX_FORMAT_RGB32_FLOAT,
+                                       ConvertTexels<Uint32>(TEX_FORMAT_RGB32_FLOAT, TEX_FORMAT_R11G11B10_FLOAT, std::vector<float>{-1.f, 1e6f, 1e6f}, UseSIMD), UseSIMD),
+                  (std::vector<float>{0.f, 65024.f, 64512.f}));
+        EXPECT_EQ(ConvertTexels<float>(TEX_FORMAT_RGB9E5_SHAREDEXP, TEX_FORMAT_RGB32_FLOAT,
+                                       ConvertTexels<Uint32>(TEX_FORMAT_RGB32_FLOAT, TEX_FORMAT_RGB9E5_SHAREDEXP, std::vector<float>{-1.f, 1e6f, 1.f}, UseSIMD), UseSIMD),
+                  (std::vector<float>{0.f, 65408.f, 0.f}));
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, SwizzleAndPremultiply)
+{
+    for (bool UseSIMD : {false, true})
+    {
+        const std::vector<Uint8> Src = {255, 128, 0, 128, 10, 20, 30, 0};
+        std::vector<Uint8>       Dst(Src.size());
+
+        TextureDataConversionAttribs Attribs;
+        Attribs.Width     = 1;
+        Attribs.Height    = 2;
+        Attribs.SrcFormat = TEX_FORMAT_RGBA8_UNORM;
+        Attribs.pSrcData  = Src.data();
+        Attribs.SrcStride = 4;
+        Attribs.DstFormat = TEX_FORMAT_BGRA8_UNORM;
+        Attribs.pDstData  = Dst.data();
+        Attribs.DstStride = 4;
+        Attribs.UseSIMD   = UseSIMD;
+
+        Attribs.PremultiplyAlpha = true;
+        ConvertTextureData(Attribs);
+        EXPECT_EQ(Dst, (std::vector<Uint8>{0, 64, 128, 128, 0, 0, 0, 0}));
+
+        Attribs.PremultiplyAlpha = false;
+        Attribs.Swizzle[0]       = 3;
+        Attribs.Swizzle[1]       = 2;
+        Attribs.Swizzle[2]       = 1;
+        Attribs.Swizzle[3]       = 0;
+        ConvertTextureData(Attribs);
+        EXPECT_EQ(Dst, (std::vector<Uint8>{128, 0, 128, 255, 20, 30, 0, 10}));
+
+        // Alpha is premultiplied after swizzling
+        Attribs.PremultiplyAlpha = true;
+        ConvertTextureData(Attribs);
+        EXPECT_EQ(Dst, (std::vector<Uint8>{128, 0, 128, 255, 1, 1, 0, 10}));
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, SIMDMatchesReference)
+{
+    constexpr TEXTURE_FORMAT Formats[] = {
+        TEX_FORMAT_RGBA32_FLOAT,
+        TEX_FORMAT_RGB32_FLOAT,
+        TEX_FORMAT_RGBA16_FLOAT,
+        TEX_FORMAT_RG16_FLOAT,
+        TEX_FORMAT_RGBA16_UNORM,
+        TEX_FORMAT_RGBA16_SNORM,
+        TEX_FORMAT_RGBA8_UNORM,
+        TEX_FORMAT_RGBA8_UNORM_SRGB,
+        TEX_FORMAT_RGBA8_SNORM,
+        TEX_FORMAT_BGRA8_UNORM,
+        TEX_FORMAT_BGRA8_UNORM_SRGB,
+        TEX_FORMAT_BGRX8_UNORM,
+        TEX_FORMAT_RG8_UNORM,
+        TEX_FORMAT_R8_UNORM,
+        TEX_FORMAT_A8_UNORM,
+        TEX_FORMAT_RGB10A2_UNORM,
+        TEX_FORMAT_R11G11B10_FLOAT,
+        TEX_FORMAT_RGB9E5_SHAREDEXP,
+    };
+
+    // Use the width that is not a multiple of the SIMD width and the chunk size
+    constexpr Uint32 Width  = 75;
+    constexpr Uint32 Height = 3;
+
+    FastRandFloat      Rnd{0, -0.25f, 1.25f};
+    std::vector<float> Texels(Width * Height * 4);
+    for (auto& Val : Texels)
+        Val = Rnd();
+
+    for (auto SrcFmt : Formats)
+    {
+        const auto SrcStride = Width * GetTextureFormatAttribs(SrcFmt).GetElementSize() + 16;
+
+        std::vector<Uint8> SrcData(SrcStride * Height);
+        {
+            TextureDataConversionAttribs Attribs;
+            Attribs.Width     = Width;
+            Attribs.Height    = Height;
+            Attribs.SrcFormat = TEX_FORMAT_RGBA32_FLOAT;
+            Attribs.pSrcData  = Texels.data();
+            Attribs.SrcStride = Width * sizeof(float4);
+            Attribs.DstFormat = SrcFmt;
+            Attribs.pDstData  = SrcData.data();
+            Attribs.DstStride = SrcStride;
+            Attribs.UseSIMD   = false;
+            ConvertTextureData(Attribs);
+        }
+
+        for (auto DstFmt : Formats)
+        {
+            const auto DstStride = Width * GetTextureFormatAttribs(DstFmt).GetElementSize() + 8;
+
+            for (Uint32 Mode = 0; Mode < 3; ++Mode)
+            {
+                std::vector<Uint8> RefData(DstStride * Height), SIMDData(DstStride * Height);
+
+                TextureDataConversionAttribs Attribs;
+                Attribs.Width     = Width;
+                Attribs.Height    = Height;
+                Attribs.SrcFormat = SrcFmt;
+                Attribs.pSrcData  = SrcData.data();
+                Attribs.SrcStride = SrcStride;
+                Attribs.DstFormat = DstFmt;
+                Attribs.DstStride = DstStride;
+                if (Mode == 1)
+                {
+                    Attribs.Swizzle[0] = 2;
+                    Attribs.Swizzle[2] = 0;
+                }
+                else if (Mode == 2)
+                {
+                    Attribs.Swizzle[0]       = 1;
+                    Attribs.Swizzle[1]       = 3;
+                    Attribs.PremultiplyAlpha = true;
+                }
+
+                Attribs.pDstData = RefData.data();
+                Attribs.UseSIMD  = false;
+                ConvertTextureData(Attribs);
+
+                Attribs.pDstData = SIMDData.data();
+                Attribs.UseSIMD  = true;
+                ConvertTextureData(Attribs);
+
+                ASSERT_EQ(RefData, SIMDData) << GetTextureFormatAttribs(SrcFmt).Name << " -> " << GetTextureFormatAttribs(DstFmt).Name << ", mode " << Mode;
+            }
+        }
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, DISABLED_Benchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 Size = 256;
+#else
+    constexpr Uint32 Size = 1024;
+#endif
+
+    struct ConversionInfo
+    {
+        TEXTURE_FORMAT SrcFmt;
+        TEXTURE_FORMAT DstFmt;
+    };
+    constexpr ConversionInfo Conversions[] = {
+        {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BGRA8_UNORM},
+        {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA32_FLOAT},
+        {TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM},
+        {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA16_FLOAT},
+        {TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_BGRA8_UNORM},
+        {TEX_FORMAT_RGBA16_UNORM, TEX_FORMAT_RGBA16_FLOAT},
+        {TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA16_FLOAT},
+        {TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_RGBA8_UNORM_SRGB},
+        {TEX_FORMAT_R11G11B10_FLOAT, TEX_FORMAT_RGBA16_FLOAT},
+    };
+
+    FastRandInt        Rnd{0, 0, 255};
+    std::vector<Uint8> SrcData(size_t{Size} * Size * 16);
+    std::vector<Uint8> DstData(size_t{Size} * Size * 16);
+    for (auto& Val : SrcData)
+        Val = static_cast<Uint8>(Rnd());
+
+    for (const auto& Conversion : Conversions)
+    {
+        const auto SrcTexelSize = GetTextureFormatAttribs(Conversion.SrcFmt).GetElementSize();
+        const auto DstTexelSize = GetTextureFormatAttribs(Conversion.DstFmt).GetElementSize();
+
+        // Make sure the source data contains valid values
+        if (Conversion.SrcFmt != TEX_FORMAT_RGBA8_UNORM && Conversion.SrcFmt != TEX_FORMAT_RGBA8_UNORM_SRGB)
+        {
+            std::vector<Uint8> RGBA8Data{SrcData.begin(), SrcData.begin() + size_t{Size} * Size * 4};
+            ConvertTexels<Uint8>(TEX_FORMAT_RGBA8_UNORM, Conversion.SrcFmt, RGBA8Data).swap(DstData);
+            memcpy(SrcData.data(), DstData.data(), DstData.size());
+            DstData.resize(size_t{Size} * Size * 16);
+        }
+
+        TextureDataConversionAttribs Attribs;
+        Attribs.Width     = Size;
+        Attribs.Height    = Size;
+        Attribs.SrcFormat = Conversion.SrcFmt;
+        Attribs.pSrcData  = SrcData.data();
+        Attribs.SrcStride = Size * SrcTexelSize;
+        Attribs.DstFormat = Conversion.DstFmt;
+        Attribs.pDstData  = DstData.data();
+        Attribs.DstStride = Size * DstTexelSize;
+
+        double Time[2] = {};
+        for (bool UseSIMD : {false, true})
+        {
+            Attribs.UseSIMD = UseSIMD;
+
+            Timer T;
+            ConvertTextureData(Attribs);
+            Time[UseSIMD ? 1 : 0] = T.GetElapsedTime() * 1000;
+        }
+
+        LOG_INFO_MESSAGE(GetTextureFormatAttribs(Conversion.SrcFmt).Name, " -> ", GetTextureFormatAttribs(Conversion.DstFmt).Name, ' ',
+                         Size, 'x', Size, ": scalar: ", Time[0], " ms, SIMD: ", Time[1], " ms");
+    }
+}
+
+} // namespace
@@ -0,0 +1,385 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentRingBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, AllocDealloc)
+{
+    // Need to define local variable to avoid vexing linker errors
+    const auto InvalidOffset = ConcurrentRingBuffer::InvalidOffset;
+    using OffsetType         = ConcurrentRingBuffer::OffsetType;
+
+    ConcurrentRingBuffer RB{1024, DefaultRawMemoryAllocator::GetAllocator()};
+
+    EXPECT_EQ(RB.Allocate(120, 16), OffsetType{0});
+    EXPECT_EQ(RB.Allocate(10, 1), OffsetType{128});
+    EXPECT_EQ(RB.Allocate(32, 32), OffsetType{160});
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{192});
+    RB.FinishCurrentFrame(1);
+
+    EXPECT_EQ(RB.Allocate(832, 1), OffsetType{192});
+    EXPECT_TRUE(RB.IsFull());
+    EXPECT_EQ(RB.Allocate(1, 1), InvalidOffset);
+    RB.FinishCurrentFrame(2);
+    // Zero-size frame must be ignored
+    RB.FinishCurrentFrame(3);
+
+    RB.ReleaseCompletedFrames(0);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{1024});
+
+    RB.ReleaseCompletedFrames(1);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{832});
+
+    // Wrap around
+    EXPECT_EQ(RB.Allocate(100, 4), OffsetType{0});
+    EXPECT_EQ(RB.Allocate(100, 4), InvalidOffset);
+    EXPECT_EQ(RB.Allocate(92, 4), OffsetType{100});
+    EXPECT_TRUE(RB.IsFull());
+    RB.FinishCurrentFrame(4);
+
+    RB.ReleaseCompletedFrames(3);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{192});
+
+    EXPECT_EQ(RB.Allocate(900, 1), InvalidOffset);
+    // The size is aligned too
+    EXPECT_EQ(RB.Allocate(500, 256), OffsetType{256});
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{192 + 64 + 512});
+    RB.FinishCurrentFrame(5);
+
+    RB.ReleaseCompletedFrames(5);
+    EXPECT_TRUE(RB.IsEmpty());
+
+    // The remaining space at the end of the buffer is skipped
+    EXPECT_EQ(RB.Allocate(300, 1), OffsetType{0});
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{256 + 300});
+    RB.FinishCurrentFrame(6);
+
+    EXPECT_EQ(RB.Allocate(2048, 1), InvalidOffset);
+
+    RB.ReleaseCompletedFrames(6);
+    EXPECT_TRUE(RB.IsEmpty());
+}
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, FreeRanges)
+{
+    using OffsetType = ConcurrentRingBuffer::OffsetType;
+
+    ConcurrentRingBuffer RB{1024, DefaultRawMemoryAllocator::GetAllocator()};
+
+    const auto R0 = RB.AllocateRange(100, 16);
+    const auto R1 = RB.AllocateRange(200, 64);
+    const auto R2 = RB.AllocateRange(300, 1);
+    ASSERT_TRUE(R0.IsValid() && R1.IsValid() && R2.IsValid());
+    EXPECT_EQ(R0.Offset, OffsetType{0});
+    EXPECT_EQ(R0.Size, OffsetType{112});
+    EXPECT_EQ(R1.Offset, OffsetType{128});
+    EXPECT_EQ(R2.Offset, OffsetType{384});
+    // The alignment space belongs to the range
+    EXPECT_EQ(R1.VirtualBegin, R0.VirtualEnd);
+    EXPECT_EQ(R2.VirtualBegin, R1.VirtualEnd);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{684});
+
+    // Ranges that are released out of order must not move the tail
+    RB.Free(R1);
+    RB.Free(R2);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{684});
+    EXPECT_FALSE(RB.AllocateRange(400, 1).IsValid());
+
+    RB.Free(R0);
+    EXPECT_TRUE(RB.IsEmpty());
+
+    // Wrap around: the skipped space at the end of the buffer belongs to the range
+    const auto R3 = RB.AllocateRange(300, 1);
+    const auto R4 = RB.AllocateRange(200, 1);
+    ASSERT_TRUE(R3.IsValid() && R4.IsValid());
+    EXPECT_EQ(R3.Offset, OffsetType{684});
+    EXPECT_EQ(R4.Offset, OffsetType{0});
+    EXPECT_EQ(R4.VirtualBegin, R3.VirtualEnd);
+    EXPECT_EQ(R4.VirtualEnd - R4.VirtualBegin, Uint64{40 + 200});
+
+    RB.Free(R4);
+    EXPECT_FALSE(RB.IsEmpty());
+    RB.Free(R3);
+    EXPECT_TRUE(RB.IsEmpty());
+}
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, Multithreaded)
+{
+    const auto InvalidOffset = ConcurrentRingBuffer::InvalidOffset;
+    using OffsetType         = ConcurrentRingBuffer::OffsetType;
+
+    constexpr OffsetType MaxSize    = 1 << 20;
+    constexpr Uint32     NumThreads = 4;
+
+    ConcurrentRingBuffer RB{MaxSize, DefaultRawMemoryAllocator::GetAllocator()};
+
+    struct Allocation
+    {
+        OffsetType Offset;
+        OffsetType Size;
+    };
+
+    for (Uint64 Frame = 1; Frame <= 3; ++Frame)
+    {
+        std::vector<std::vector<Allocation>> ThreadAllocations(NumThreads);
+        std::vector<std::thread>             Threads;
+        for (Uint32 t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&RB, &Allocations = ThreadAllocations[t], t, InvalidOffset]() {
+                for (Uint32 i = 0;; ++i)
+                {
+                    const OffsetType Size      = 16 + (i * 37 + t * 101) % 2000;
+                    const OffsetType Alignment = OffsetType{1} << ((i + t) % 9);
+
+                    const auto Offset = RB.Allocate(Size, Alignment);
+                    if (Offset == InvalidOffset)
+                        break;
+                    EXPECT_EQ(Offset % Alignment, OffsetType{0});
+                    Allocations.push_back({Offset, Size});
+                }
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        std::vector<Allocation> Allocations;
+        for (const auto& ThreadAllocs : ThreadAllocations)
+            Allocations.insert(Allocations.end(), ThreadAllocs.begin(), ThreadAllocs.end());
+        std::sort(Allocations.begin(), Allocations.end(), [](const Allocation& A0, const Allocation& A1) { return A0.Offset < A1.Offset; });
+
+        // Allocations must not overlap
+        for (size_t i = 1; i < Allocations.size(); ++i)
+            ASSERT_LE(Allocations[i - 1].Offset + Allocations[i - 1].Size, Allocations[i].Offset);
+        ASSERT_FALSE(Allocations.empty());
+        EXPECT_LE(Allocations.back().Offset + Allocations.back().Size, MaxSize);
+        // The buffer must be almost full
+        EXPECT_GT(RB.GetUsedSize(), MaxSize - 4096);
+
+        RB.FinishCurrentFrame(Frame);
+        RB.ReleaseCompletedFrames(Frame);
+        EXPECT_TRUE(RB.IsEmpty());
+
+        // Move the head so that the next frame wraps around
+        EXPECT_NE(RB.Allocate(MaxSize / 3, 1), InvalidOffset);
+        RB.FinishCurrentFrame(Frame);
+        RB.ReleaseCompletedFrames(Frame);
+    }
+}
+
+// Threads allocate and free ranges concurrently, so the tail moves while other threads allocate
+TEST(GraphicsAccessories_ConcurrentRingBuffer, MultithreadedAllocFree)
+{
+    using OffsetType = ConcurrentRingBuffer::OffsetType;
+
+    constexpr OffsetType MaxSize                 = 1 << 16;
+    constexpr Uint32     NumThreads              = 4;
+    constexpr Uint32     NumAllocationsPerThread = 5000;
+
+    ConcurrentRingBuffer RB{MaxSize, DefaultRawMemoryAllocator::GetAllocator()};
+    std::vector<Uint8>   Data(MaxSize);
+
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&RB, &Data, t]() {
+            const Uint8 Tag = static_cast<Uint8>(t + 1);
+            for (Uint32 i = 0; i < NumAllocationsPerThread;)
+            {
+                const OffsetType Size      = 16 + (i * 37 + t * 101) % 1000;
+                const OffsetType Alignment = OffsetType{1} << ((i + t) % 9);
+
+                const auto Allocation = RB.AllocateRange(Size, Alignment);
+                if (!Allocation.IsValid())
+                {
+                    // The buffer may be full while other threads hold their ranges
+                    std::this_thread::yield();
+                    continue;
+                }
+                EXPECT_EQ(Allocation.Offset % Alignment, OffsetType{0});
+                EXPECT_LE(Allocation.Offset + Allocation.Size, RB.GetMaxSize());
+
+                // Overlapping allocations would overwrite the tag
+                std::fill_n(Data.begin() + Allocation.Offset, Allocation.Size, Tag);
+                std::this_thread::yield();
+                for (OffsetType j = 0; j < Allocation.Size; ++j)
+                {
+                    if (Data[Allocation.Offset + j] != Tag)
+                    {
+                        ADD_FAILURE() << "Allocation [" << Allocation.Offset << ", " << Allocation.Offset + Allocation.Size
+                                      << ") overlaps another live allocation";
+                        break;
+                    }
+                }
+
+                RB.Free(Allocation);
+                ++i;
+            }
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    EXPECT_TRUE(RB.IsEmpty());
+
+    // Half of the buffer always fits when it is empty, regardless of where the head is
+    const auto Allocation = RB.AllocateRange(MaxSize / 2, 1);
+    ASSERT_TRUE(Allocation.IsValid());
+    RB.Free(Allocation);
+    EXPECT_TRUE(RB.IsEmpty());
+}
+
+class LockingRingBuffer
+{
+public:
+    using OffsetType                                = RingBuffer::OffsetType;
+    static constexpr const OffsetType InvalidOffset = RingBuffer::InvalidOffset;
+
+    LockingRingBuffer(OffsetType MaxSize, IMemoryAllocator& Allocator) :
+        m_RingBuffer{MaxSize, Allocator}
+    {}
+
+    OffsetType Allocate(OffsetType Size, OffsetType Alignment)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        return m_RingBuffer.Allocate(Size, Alignment);
+    }
+
+    void FinishCurrentFrame(Uint64 FenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_RingBuffer.FinishCurrentFrame(FenceValue);
+    }
+
+    void ReleaseCompletedFrames(Uint64 CompletedFenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_RingBuffer.ReleaseCompletedFrames(CompletedFenceValue);
+    }
+
+private:
+    std::mutex m_Mtx;
+    RingBuffer m_RingBuffer;
+};
+
+// Emulates several contexts that record commands in parallel and allocate dynamic memory
+// from the shared ring buffer while the main thread finishes and releases the frames.
+template <typename RingBufferType>
+double RunRecordingBenchmark(Uint32 NumThreads, Uint32 NumFrames, Uint32 NumAllocationsPerFrame)
+{
+    RingBufferType RB{64 << 20, DefaultRawMemoryAllocator::GetAllocator()};
+
+    std::atomic<Uint32> NumThreadsDone{0};
+    std::atomic<Uint32> CurrFrame{0};
+
+    Timer T;
+
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&]() {
+            for (Uint32 Frame = 0; Frame < NumFrames; ++Frame)
+            {
+                for (Uint32 i = 0; i < NumAllocationsPerFrame; ++i)
+                {
+                    const auto Offset = RB.Allocate(256, 16);
+                    VERIFY_EXPR(Offset != RingBufferType::InvalidOffset);
+                    (void)Offset;
+                }
+
+                // Wait until all threads finish recording the frame
+                NumThreadsDone.fetch_add(1);
+                while (CurrFrame.load() == Frame)
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (Uint32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        while (NumThreadsDone.load() < NumThreads)
+            std::this_thread::yield();
+        NumThreadsDone.store(0);
+
+        RB.FinishCurrentFrame(Frame + 1);
+        // Emulate two frames in flight
+        if (Frame >= 2)
+            RB.ReleaseCompletedFrames(Frame - 1);
+
+        CurrFrame.store(Frame + 1);
+    }
+
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    const auto Time = T.GetElapsedTime() * 1000.0;
+
+    RB.ReleaseCompletedFrames(NumFrames);
+
+    return Time;
+}
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, DISABLED_RecordingBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumFrames = 10;
+#else
+    constexpr Uint32 NumFrames = 100;
+#endif
+    constexpr Uint32 NumAllocationsPerFrame = 10000;
+
+    const Uint32 NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    double LockingTime    = 0;
+    double ConcurrentTime = 0;
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        LockingTime    = RunRecordingBenchmark<LockingRingBuffer>(NumThreads, NumFrames, NumAllocationsPerFrame);
+        ConcurrentTime = RunRecordingBenchmark<ConcurrentRingBuffer>(NumThreads, NumFrames, NumAllocationsPerFrame);
+    }
+
+    LOG_INFO_MESSAGE(NumFrames, " frames, ", NumThreads, " recording threads, ", NumAllocationsPerFrame, " allocations per thread per frame:",
+                     "\n    mutex-protected ring buffer: ", LockingTime, " ms",
+                     "\n    concurrent ring buffer:      ", ConcurrentTime, " ms");
+}
+
+} // namespace
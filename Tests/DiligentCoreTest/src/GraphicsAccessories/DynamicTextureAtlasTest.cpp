@@ -0,0 +1,201 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "DynamicTextureAtlas.h"
+
+#include <vector>
+
+#include "RefCntAutoPtr.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+RefCntAutoPtr<IDynamicTextureAtlas> CreateAtlas(Uint32 Size, Uint32 Granularity, Uint32 ArraySize)
+{
+    DynamicTextureAtlasCreateInfo CI;
+    CI.Desc.Name          = "Dynamic texture atlas test";
+    CI.Desc.Type          = RESOURCE_DIM_TEX_2D_ARRAY;
+    CI.Desc.Format        = TEX_FORMAT_RGBA8_UNORM;
+    CI.Desc.BindFlags     = BIND_SHADER_RESOURCE;
+    CI.Desc.Width         = Size;
+    CI.Desc.Height        = Size;
+    CI.Desc.ArraySize     = ArraySize;
+    CI.TextureGranularity = Granularity;
+    CI.ExtraSliceCount    = 1;
+
+    // The texture is not needed to test the suballocation logic and will never be created
+    RefCntAutoPtr<IDynamicTextureAtlas> pAtlas;
+    CreateDynamicTextureAtlas(nullptr, CI, &pAtlas);
+    return pAtlas;
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, Defragment)
+{
+    auto pAtlas = CreateAtlas(256, 64, 1);
+    ASSERT_TRUE(pAtlas);
+
+    // Fill the first slice and allocate four regions in the second one
+    std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> Suballocations(20);
+    for (auto& pSuballoc : Suballocations)
+    {
+        pAtlas->Allocate(64, 64, &pSuballoc);
+        ASSERT_TRUE(pSuballoc);
+    }
+    for (size_t i = 0; i < 16; ++i)
+        EXPECT_EQ(Suballocations[i]->GetSlice(), 0u);
+    for (size_t i = 16; i < 20; ++i)
+        EXPECT_EQ(Suballocations[i]->GetSlice(), 1u);
+
+    std::vector<uint2> FreedOrigins;
+    for (size_t i = 0; i < 16; i += 4)
+    {
+        FreedOrigins.push_back(Suballocations[i]->GetOrigin());
+        Suballocations[i].Release();
+    }
+
+    const auto Version = pAtlas->GetVersion();
+
+    // Each region contains 64x64 RGBA8 texels. Only three of them fit into the budget.
+    Uint32      NumMoves = 0;
+    const auto* pMoves   = pAtlas->BeginDefragmentation(3 * 64 * 64 * 4, NumMoves);
+    ASSERT_EQ(NumMoves, 3u);
+    ASSERT_NE(pMoves, nullptr);
+
+    std::vector<uint2> SrcOrigins;
+    for (Uint32 i = 0; i < NumMoves; ++i)
+    {
+        const auto& Move = pMoves[i];
+        EXPECT_EQ(Move.SrcSlice, 1u);
+        EXPECT_EQ(Move.DstSlice, 0u);
+        EXPECT_EQ(Move.Size, uint2(64, 64));
+        EXPECT_NE(std::find(FreedOrigins.begin(), FreedOrigins.end(), Move.DstOrigin), FreedOrigins.end());
+        for (Uint32 j = 0; j < i; ++j)
+            EXPECT_NE(Move.DstOrigin, pMoves[j].DstOrigin);
+        SrcOrigins.push_back(Move.SrcOrigin);
+    }
+
+    // Suballocations must not change until the pass ends
+    for (size_t i = 16; i < 20; ++i)
+        EXPECT_EQ(Suballocations[i]->GetSlice(), 1u);
+    EXPECT_EQ(pAtlas->GetVersion(), Version);
+
+    const std::vector<TextureAtlasSuballocationMove> Moves{pMoves, pMoves + NumMoves};
+    pAtlas->EndDefragmentation();
+    EXPECT_EQ(pAtlas->GetVersion(), Version + 1);
+
+    Uint32 NumRelocated = 0;
+    for (size_t i = 16; i < 20; ++i)
+    {
+        const auto& pSuballoc = Suballocations[i];
+        for (const auto& Move : Moves)
+        {
+            if (Move.SrcOrigin == pSuballoc->GetOrigin() && pSuballoc->GetSlice() == Move.SrcSlice)
+                ADD_FAILURE() << "Suballocation has not been relocated";
+            if (Move.DstOrigin == pSuballoc->GetOrigin() && pSuballoc->GetSlice() == Move.DstSlice)
+            {
+                ++NumRelocated;
+                const auto UVScaleBias = pSuballoc->GetUVScaleBias();
+                EXPECT_EQ(UVScaleBias.z, static_cast<float>(Move.DstOrigin.x) / 256.f);
+                EXPECT_EQ(UVScaleBias.w, static_cast<float>(Move.DstOrigin.y) / 256.f);
+            }
+        }
+    }
+    EXPECT_EQ(NumRelocated, 3u);
+
+    // The remaining region can now be moved
+    pMoves = pAtlas->BeginDefragmentation(~Uint64{0}, NumMoves);
+    EXPECT_EQ(NumMoves, 1u);
+    pAtlas->EndDefragmentation();
+    for (const auto& pSuballoc : Suballocations)
+    {
+        if (pSuballoc)
+        {
+            EXPECT_EQ(pSuballoc->GetSlice(), 0u);
+        }
+    }
+
+    // The first slice is full, nothing can be moved
+    pMoves = pAtlas->BeginDefragmentation(~Uint64{0}, NumMoves);
+    EXPECT_EQ(NumMoves, 0u);
+    EXPECT_EQ(pMoves, nullptr);
+    pAtlas->EndDefragmentation();
+    EXPECT_EQ(pAtlas->GetVersion(), Version + 2);
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, ReleaseDuringDefragmentation)
+{
+    auto pAtlas = CreateAtlas(256, 64, 1);
+    ASSERT_TRUE(pAtlas);
+
+    std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> Suballocations(20);
+    for (auto& pSuballoc : Suballocations)
+        pAtlas->Allocate(64, 64, &pSuballoc);
+
+    for (size_t i = 0; i < 16; i += 4)
+        Suballocations[i].Release();
+
+    const auto Version = pAtlas->GetVersion();
+
+    Uint32 NumMoves = 0;
+    pAtlas->BeginDefragmentation(~Uint64{0}, NumMoves);
+    EXPECT_EQ(NumMoves, 4u);
+
+    for (size_t i = 16; i < 20; ++i)
+        Suballocations[i].Release();
+
+    // The space reserved for the moves must not be available
+    RefCntAutoPtr<ITextureAtlasSuballocation> pSuballoc;
+    pAtlas->Allocate(64, 64, &pSuballoc);
+    ASSERT_TRUE(pSuballoc);
+    EXPECT_EQ(pSuballoc->GetSlice(), 1u);
+
+    pAtlas->EndDefragmentation();
+    EXPECT_EQ(pAtlas->GetVersion(), Version);
+    EXPECT_EQ(pSuballoc->GetSlice(), 1u);
+
+    // The reserved space must have been released
+    std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> NewSuballocations(4);
+    for (auto& pNewSuballoc : NewSuballocations)
+    {
+        pAtlas->Allocate(64, 64, &pNewSuballoc);
+        ASSERT_TRUE(pNewSuballoc);
+        EXPECT_EQ(pNewSuballoc->GetSlice(), 0u);
+    }
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, LocationRange)
+{
+    // Region origins are stored in 24 bits in granularity units
+    EXPECT_TRUE(CreateAtlas(1u << 25u, 2, 1));
+    EXPECT_FALSE(CreateAtlas(1u << 25u, 1, 1));
+}
+
+} // namespace
@@ -28,9 +28,14 @@
 #include "GraphicsUtilities.h"
 #include "FastRand.hpp"
 #include "ColorConversion.h"
+#include "GraphicsAccessories.hpp"
+#include "Timer.hpp"
 
 #include <vector>
 #include <array>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -501,4 +506,299 @@ TEST(GraphicsTools_CalculateMipLevel, sRGB)
     EXPECT_TRUE(CoarseData == RefCoarseData);
 }
 
+
+// Mip chain with tightly packed levels
+struct TestMipChain
+{
+    TestMipChain(Uint32 Width, Uint32 Height, TEXTURE_FORMAT Fmt, Uint32 NumLevels = 0)
+    {
+        Attribs.Width        = Width;
+        Attribs.Height       = Height;
+        Attribs.Format       = Fmt;
+        Attribs.NumMipLevels = NumLevels != 0 ? NumLevels : ComputeMipLevelsCount(Width, Height);
+
+        const auto& FmtAttribs = GetTextureFormatAttribs(Fmt);
+        const auto  TexelSize  = Uint32{FmtAttribs.NumComponents} * Uint32{FmtAttribs.ComponentSize};
+
+        Data.resize(Attribs.NumMipLevels);
+        Levels.resize(Attribs.NumMipLevels);
+        for (Uint32 Level = 0; Level < Attribs.NumMipLevels; ++Level)
+        {
+            const auto LevelWidth  = std::max(Width >> Level, 1u);
+            const auto LevelHeight = std::max(Height >> Level, 1u);
+            Data[Level].resize(size_t{LevelWidth} * LevelHeight * TexelSize);
+            Levels[Level].pData  = Data[Level].data();
+            Levels[Level].Stride = LevelWidth * TexelSize;
+        }
+        Attribs.pMipLevels = Levels.data();
+
+        FastRandInt rnd{0, 0, 255};
+        if (FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT)
+        {
+            auto* pData = reinterpret_cast<float*>(Data[0].data());
+            for (size_t i = 0; i < Data[0].size() / sizeof(float); ++i)
+                pData[i] = static_cast<float>(rnd()) / 255.f;
+        }
+        else
+        {
+            for (auto& Byte : Data[0])
+                Byte = static_cast<Uint8>(rnd());
+        }
+    }
+
+    // Computes the chain with ComputeMipLevel
+    void ComputeReference()
+    {
+        for (Uint32 Level = 1; Level < Attribs.NumMipLevels; ++Level)
+        {
+            ComputeMipLevel(std::max(Attribs.Width >> (Level - 1), 1u), std::max(Attribs.Height >> (Level - 1), 1u), Attribs.Format,
+                            Levels[Level - 1].pData, Levels[Level - 1].Stride, Levels[Level].pData, Levels[Level].Stride);
+        }
+    }
+
+    ComputeMipChainAttribs          Attribs;
+    std::vector<std::vector<Uint8>> Data;
+    std::vector<MipChainLevelData>  Levels;
+};
+
+TEST(GraphicsTools_ComputeMipChain, Box)
+{
+    const TEXTURE_FORMAT Formats[] = {
+        TEX_FORMAT_R8_UNORM,
+        TEX_FORMAT_RG8_UINT,
+        TEX_FORMAT_RGBA8_UNORM,
+        TEX_FORMAT_RGBA8_SNORM,
+        TEX_FORMAT_RGBA16_UNORM,
+        TEX_FORMAT_RG16_SINT,
+        TEX_FORMAT_RGBA32_FLOAT,
+        TEX_FORMAT_R32_FLOAT,
+    };
+
+    const std::pair<Uint32, Uint32> Sizes[] = {
+        {256, 256},
+        {237, 129},
+        {64, 1},
+        {1, 77},
+        {1024, 3},
+    };
+
+    for (auto Fmt : Formats)
+    {
+        for (const auto& Size : Sizes)
+        {
+            TestMipChain Ref{Size.first, Size.second, Fmt};
+            Ref.ComputeReference();
+
+            for (Uint32 NumThreads : {1u, 4u})
+            {
+                TestMipChain Chain{Size.first, Size.second, Fmt};
+                Chain.Attribs.NumThreads = NumThreads;
+                ComputeMipChain(Chain.Attribs);
+
+                for (Uint32 Level = 1; Level < Ref.Attribs.NumMipLevels; ++Level)
+                {
+                    EXPECT_TRUE(Chain.Data[Level] == Ref.Data[Level])
+                        << GetTextureFormatAttribs(Fmt).Name << ' ' << Size.first << 'x' << Size.second << ", level " << Level << ", " << NumThreads << " threads";
+                }
+            }
+        }
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, sRGB)
+{
+    const Uint32 Width  = 225;
+    const Uint32 Height = 137;
+
+    TestMipChain Chain{Width, Height, TEX_FORMAT_RGBA8_UNORM_SRGB, 2};
+    ComputeMipChain(Chain.Attribs);
+
+    const auto& Fine   = Chain.Data[0];
+    const auto& Coarse = Chain.Data[1];
+    for (Uint32 y = 0; y < Height / 2; ++y)
+    {
+        for (Uint32 x = 0; x < Width / 2; ++x)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+            {
+                auto Fetch = [&](Uint32 col, Uint32 row) {
+                    const auto Val = Fine[(col + row * Width) * 4 + c];
+                    return c < 3 ? SRGBToLinear(static_cast<float>(Val) / 255.f) : static_cast<float>(Val) / 255.f;
+                };
+                auto Average = (Fetch(x * 2, y * 2) + Fetch(x * 2 + 1, y * 2) + Fetch(x * 2, y * 2 + 1) + Fetch(x * 2 + 1, y * 2 + 1)) * 0.25f;
+                if (c < 3)
+                    Average = LinearToSRGB(Average);
+
+                const auto RefVal = Average * 255.f;
+                const auto Val    = static_cast<float>(Coarse[(x + y * (Width / 2)) * 4 + c]);
+                EXPECT_NEAR(Val, RefVal, c < 3 ? 0.51f : 1.f) << x << ' ' << y << ' ' << c;
+            }
+        }
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, Filters)
+{
+    for (auto FilterType : {MIP_FILTER_TYPE_KAISER, MIP_FILTER_TYPE_LANCZOS})
+    {
+        for (auto Fmt : {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RG16_SNORM, TEX_FORMAT_RGBA32_FLOAT})
+        {
+            // Constant images must remain constant
+            {
+                TestMipChain Chain{300, 157, Fmt};
+                for (size_t i = 0; i < Chain.Data[0].size(); i += 4)
+                {
+                    if (Fmt == TEX_FORMAT_RGBA32_FLOAT)
+                    {
+                        const float Val = 0.375f;
+                        memcpy(&Chain.Data[0][i], &Val, sizeof(Val));
+                    }
+                    else
+                    {
+                        memcpy(&Chain.Data[0][i], "\x40\x60\x40\x60", 4);
+                    }
+                }
+                Chain.Attribs.FilterType = FilterType;
+                ComputeMipChain(Chain.Attribs);
+                for (Uint32 Level = 1; Level < Chain.Attribs.NumMipLevels; ++Level)
+                {
+                    const auto& LevelData = Chain.Data[Level];
+                    for (size_t i = 0; i < LevelData.size(); i += 4)
+                    {
+                        bool IsConstant = true;
+                        if (Fmt == TEX_FORMAT_RGBA32_FLOAT)
+                        {
+                            float Val;
+                            memcpy(&Val, &LevelData[i], sizeof(Val));
+                            IsConstant = std::abs(Val - 0.375f) < 1e-5f;
+                        }
+                        else
+                        {
+                            IsConstant = memcmp(&LevelData[i], &Chain.Data[0][0], 4) == 0;
+                        }
+
+                        if (!IsConstant)
+                        {
+                            ADD_FAILURE() << GetTextureFormatAttribs(Fmt).Name << ": level " << Level << " is not constant";
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // Results must not depend on the number of threads
+            TestMipChain Chain0{512, 259, Fmt};
+            TestMipChain Chain1{512, 259, Fmt};
+            Chain0.Attribs.FilterType = FilterType;
+            Chain1.Attribs.FilterType = FilterType;
+            Chain0.Attribs.NumThreads = 1;
+            Chain1.Attribs.NumThreads = 8;
+            ComputeMipChain(Chain0.Attribs);
+            ComputeMipChain(Chain1.Attribs);
+            for (Uint32 Level = 1; Level < Chain0.Attribs.NumMipLevels; ++Level)
+                EXPECT_TRUE(Chain0.Data[Level] == Chain1.Data[Level]) << GetTextureFormatAttribs(Fmt).Name << ", level " << Level;
+        }
+    }
+
+    // The filters must preserve low frequencies
+    {
+        const Uint32 Width = 256;
+        TestMipChain Chain{Width, 1, TEX_FORMAT_R32_FLOAT, 2};
+        auto*        pFine = reinterpret_cast<float*>(Chain.Data[0].data());
+        for (Uint32 x = 0; x < Width; ++x)
+            pFine[x] = 0.5f + 0.25f * std::sin(static_cast<float>(x) * 0.05f);
+        Chain.Attribs.FilterType = MIP_FILTER_TYPE_LANCZOS;
+        ComputeMipChain(Chain.Attribs);
+
+        const auto* pCoarse = reinterpret_cast<const float*>(Chain.Data[1].data());
+        for (Uint32 x = 4; x < Width / 2 - 4; ++x)
+            EXPECT_NEAR(pCoarse[x], 0.5f + 0.25f * std::sin((static_cast<float>(x) * 2.f + 0.5f) * 0.05f), 1e-3f);
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, Float16)
+{
+    // Converts the level data between RGBA16_FLOAT and RGBA32_FLOAT formats
+    auto ConvertLevel = [](const TestMipChain& Src, TestMipChain& Dst, Uint32 Level) {
+        TextureDataConversionAttribs ConvAttribs;
+        ConvAttribs.Width     = std::max(Src.Attribs.Width >> Level, 1u);
+        ConvAttribs.Height    = std::max(Src.Attribs.Height >> Level, 1u);
+        ConvAttribs.SrcFormat = Src.Attribs.Format;
+        ConvAttribs.pSrcData  = Src.Levels[Level].pData;
+        ConvAttribs.SrcStride = Src.Levels[Level].Stride;
+        ConvAttribs.DstFormat = Dst.Attribs.Format;
+        ConvAttribs.pDstData  = Dst.Levels[Level].pData;
+        ConvAttribs.DstStride = Dst.Levels[Level].Stride;
+        ConvertTextureData(ConvAttribs);
+    };
+
+    for (auto FilterType : {MIP_FILTER_TYPE_BOX, MIP_FILTER_TYPE_KAISER, MIP_FILTER_TYPE_LANCZOS})
+    {
+        for (Uint32 NumThreads : {1u, 4u})
+        {
+            // Use 16-bit values as the source for both chains
+            TestMipChain Ref{237, 129, TEX_FORMAT_RGBA32_FLOAT};
+            TestMipChain Chain{237, 129, TEX_FORMAT_RGBA16_FLOAT};
+            ConvertLevel(Ref, Chain, 0);
+            ConvertLevel(Chain, Ref, 0);
+
+            Ref.Attribs.FilterType   = FilterType;
+            Chain.Attribs.FilterType = FilterType;
+            Chain.Attribs.NumThreads = NumThreads;
+            ComputeMipChain(Ref.Attribs);
+            ComputeMipChain(Chain.Attribs);
+
+            for (Uint32 Level = 1; Level < Chain.Attribs.NumMipLevels; ++Level)
+            {
+                TestMipChain Res{237, 129, TEX_FORMAT_RGBA32_FLOAT};
+                ConvertLevel(Chain, Res, Level);
+
+                const auto* pRef = reinterpret_cast<const float*>(Ref.Data[Level].data());
+                const auto* pRes = reinterpret_cast<const float*>(Res.Data[Level].data());
+                for (size_t i = 0; i < Ref.Data[Level].size() / sizeof(float); ++i)
+                {
+                    if (std::abs(pRes[i] - pRef[i]) > 4e-3f)
+                    {
+                        ADD_FAILURE() << "Level " << Level << ", value " << i << ": " << pRes[i] << " vs " << pRef[i] << ", filter " << FilterType << ", " << NumThreads << " threads";
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, DISABLED_Benchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 Size = 512;
+#else
+    constexpr Uint32 Size = 4096;
+#endif
+    for (auto Fmt : {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB})
+    {
+        TestMipChain Chain{Size, Size, Fmt};
+
+        Timer T;
+        Chain.ComputeReference();
+        const auto ScalarTime = T.GetElapsedTime() * 1000;
+
+        auto Measure = [&](MIP_FILTER_TYPE FilterType, Uint32 NumThreads) {
+            Chain.Attribs.FilterType = FilterType;
+            Chain.Attribs.NumThreads = NumThreads;
+            T.Restart();
+            ComputeMipChain(Chain.Attribs);
+            return T.GetElapsedTime() * 1000;
+        };
+
+        const auto BoxTime       = Measure(MIP_FILTER_TYPE_BOX, 1);
+        const auto BoxTimeMT     = Measure(MIP_FILTER_TYPE_BOX, 0);
+        const auto LanczosTime   = Measure(MIP_FILTER_TYPE_LANCZOS, 1);
+        const auto LanczosTimeMT = Measure(MIP_FILTER_TYPE_LANCZOS, 0);
+        LOG_INFO_MESSAGE(GetTextureFormatAttribs(Fmt).Name, ' ', Size, 'x', Size, " mip chain: ComputeMipLevel: ", ScalarTime,
+                         " ms, box: ", BoxTime, " ms, box on ", std::thread::hardware_concurrency(), " threads: ", BoxTimeMT,
+                         " ms, Lanczos: ", LanczosTime, " ms, Lanczos on ", std::thread::hardware_concurrency(), " threads: ", LanczosTimeMT, " ms");
+    }
+}
+
 } // namespace
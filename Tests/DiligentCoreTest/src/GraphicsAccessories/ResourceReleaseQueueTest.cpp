@@ -26,9 +26,16 @@
  */
 
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <algorithm>
 
 #include "ResourceReleaseQueue.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -128,4 +135,259 @@ TEST(GraphicsAccessories_ResourceReleaseQueue, GetFilterTypeLiteralName)
     }
 }
 
+// Resource that counts how many times it has been destroyed
+class TrackedResource
+{
+public:
+    explicit TrackedResource(std::atomic<Uint32>& NumDestroyed) :
+        m_pNumDestroyed{&NumDestroyed}
+    {}
+
+    TrackedResource(TrackedResource&& rhs) noexcept :
+        m_pNumDestroyed{rhs.m_pNumDestroyed}
+    {
+        rhs.m_pNumDestroyed = nullptr;
+    }
+
+    // clang-format off
+    TrackedResource             (const TrackedResource&) = delete;
+    TrackedResource& operator = (const TrackedResource&) = delete;
+    TrackedResource& operator = (TrackedResource&&)      = delete;
+    // clang-format on
+
+    ~TrackedResource()
+    {
+        if (m_pNumDestroyed != nullptr)
+            m_pNumDestroyed->fetch_add(1);
+    }
+
+private:
+    std::atomic<Uint32>* m_pNumDestroyed;
+};
+
+template <typename WrapperType>
+void TestFenceOrdering()
+{
+    std::atomic<Uint32> NumDestroyed{0};
+
+    ResourceReleaseQueue<WrapperType> Queue{DefaultRawMemoryAllocator::GetAllocator()};
+
+    Queue.SafeReleaseResource(TrackedResource{NumDestroyed}, 1);
+    Queue.SafeReleaseResource(TrackedResource{NumDestroyed}, 3);
+    Queue.SafeReleaseResource(TrackedResource{NumDestroyed}, 2);
+    Queue.SafeReleaseResource(TrackedResource{NumDestroyed}, 1);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), 4u);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 0u);
+
+    Queue.DiscardStaleResources(0, 10);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), 4u);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 0u);
+
+    // Resources released with command list number 1 must be discarded even though
+    // a resource with a greater number was released between them
+    Queue.DiscardStaleResources(1, 10);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), 2u);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 2u);
+
+    Queue.DiscardResource(TrackedResource{NumDestroyed}, 10);
+    Queue.DiscardResource(TrackedResource{NumDestroyed}, 11);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 4u);
+
+    Queue.SafeReleaseResource(TrackedResource{NumDestroyed}, 2);
+    Queue.DiscardStaleResources(2, 12);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), 1u);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 6u);
+
+    Queue.Purge(9);
+    EXPECT_EQ(NumDestroyed, 0u);
+
+    Queue.Purge(10);
+    EXPECT_EQ(NumDestroyed, 3u);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 3u);
+
+    Queue.Purge(11);
+    EXPECT_EQ(NumDestroyed, 4u);
+
+    Queue.DiscardStaleResources(3, 13);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), 0u);
+    Queue.Purge(12);
+    EXPECT_EQ(NumDestroyed, 6u);
+    Queue.Purge(13);
+    EXPECT_EQ(NumDestroyed, 7u);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 0u);
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, FenceOrdering)
+{
+    TestFenceOrdering<DynamicStaleResourceWrapper>();
+    TestFenceOrdering<StaticStaleResourceWrapper<TrackedResource>>();
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, SharedResources)
+{
+    std::atomic<Uint32> NumDestroyed{0};
+
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue0{DefaultRawMemoryAllocator::GetAllocator()};
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue1{DefaultRawMemoryAllocator::GetAllocator()};
+
+    auto Wrapper = ResourceReleaseQueue<DynamicStaleResourceWrapper>::CreateWrapper(TrackedResource{NumDestroyed}, 2);
+    Queue0.SafeReleaseResource(Wrapper, 0);
+    Queue1.SafeReleaseResource(std::move(Wrapper), 0);
+
+    Queue0.DiscardStaleResources(0, 1);
+    Queue1.DiscardStaleResources(0, 1);
+
+    Queue0.Purge(1);
+    EXPECT_EQ(NumDestroyed, 0u);
+    Queue1.Purge(1);
+    EXPECT_EQ(NumDestroyed, 1u);
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, MultithreadedRelease)
+{
+    constexpr Uint32 NumThreads            = 4;
+    constexpr Uint32 NumResourcesPerThread = 10000;
+
+    std::atomic<Uint32> NumDestroyed{0};
+    std::atomic<Uint64> NextCmdListNumber{0};
+    std::atomic<Uint32> NumRunningThreads{NumThreads};
+
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue{DefaultRawMemoryAllocator::GetAllocator()};
+
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&]() {
+            for (Uint32 i = 0; i < NumResourcesPerThread; ++i)
+                Queue.SafeReleaseResource(TrackedResource{NumDestroyed}, NextCmdListNumber.load());
+            NumRunningThreads.fetch_sub(1);
+        });
+    }
+
+    // Emulate command list submission on the owning thread while other threads release resources
+    Uint64 FenceValue = 0;
+    while (NumRunningThreads.load() > 0)
+    {
+        const auto SubmittedCmdListNumber = NextCmdListNumber.fetch_add(1);
+        Queue.DiscardStaleResources(SubmittedCmdListNumber, ++FenceValue);
+        if (FenceValue > 2)
+            Queue.Purge(FenceValue - 2);
+        std::this_thread::yield();
+    }
+
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    Queue.DiscardStaleResources(NextCmdListNumber.load(), ++FenceValue);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), 0u);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount() + NumDestroyed.load(), NumThreads * NumResourcesPerThread);
+
+    Queue.Purge(FenceValue);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), 0u);
+    EXPECT_EQ(NumDestroyed, NumThreads * NumResourcesPerThread);
+}
+
+// Reference implementation that guards both queues with mutexes
+class LockingReleaseQueue
+{
+public:
+    void SafeReleaseResource(DynamicStaleResourceWrapper&& Wrapper, Uint64 NextCommandListNumber)
+    {
+        std::lock_guard<std::mutex> Lock{m_StaleObjectsMutex};
+        m_StaleResources.emplace_back(NextCommandListNumber, std::move(Wrapper));
+    }
+
+    void DiscardStaleResources(Uint64 SubmittedCmdBuffNumber, Uint64 FenceValue)
+    {
+        std::lock_guard<std::mutex> StaleObjectsLock{m_StaleObjectsMutex};
+        std::lock_guard<std::mutex> ReleaseQueueLock{m_ReleaseQueueMutex};
+        while (!m_StaleResources.empty() && m_StaleResources.front().first <= SubmittedCmdBuffNumber)
+        {
+            m_ReleaseQueue.emplace_back(FenceValue, std::move(m_StaleResources.front().second));
+            m_StaleResources.pop_front();
+        }
+    }
+
+    void Purge(Uint64 CompletedFenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_ReleaseQueueMutex};
+        while (!m_ReleaseQueue.empty() && m_ReleaseQueue.front().first <= CompletedFenceValue)
+            m_ReleaseQueue.pop_front();
+    }
+
+private:
+    std::mutex                                                 m_StaleObjectsMutex;
+    std::deque<std::pair<Uint64, DynamicStaleResourceWrapper>> m_StaleResources;
+    std::mutex                                                 m_ReleaseQueueMutex;
+    std::deque<std::pair<Uint64, DynamicStaleResourceWrapper>> m_ReleaseQueue;
+};
+
+template <typename QueueType>
+double RunReleaseBenchmark(QueueType& Queue, Uint32 NumThreads, Uint32 NumResourcesPerThread)
+{
+    struct Handle
+    {
+        Uint64 Value = 0;
+    };
+
+    std::atomic<Uint64> NextCmdListNumber{0};
+    std::atomic<Uint32> NumRunningThreads{NumThreads};
+
+    Timer T;
+
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&]() {
+            for (Uint32 i = 0; i < NumResourcesPerThread; ++i)
+            {
+                Queue.SafeReleaseResource(DynamicStaleResourceWrapper::Create(Handle{i}, 1), NextCmdListNumber.load(std::memory_order_relaxed));
+            }
+            NumRunningThreads.fetch_sub(1);
+        });
+    }
+
+    Uint64 FenceValue = 0;
+    while (NumRunningThreads.load() > 0)
+    {
+        Queue.DiscardStaleResources(NextCmdListNumber.fetch_add(1), ++FenceValue);
+        if (FenceValue > 2)
+            Queue.Purge(FenceValue - 2);
+        std::this_thread::yield();
+    }
+
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    Queue.DiscardStaleResources(NextCmdListNumber.load(), ++FenceValue);
+    Queue.Purge(FenceValue);
+
+    return T.GetElapsedTime() * 1000.0;
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, DISABLED_ReleaseBenchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumResourcesPerThread = 20000;
+#else
+    constexpr Uint32 NumResourcesPerThread = 200000;
+#endif
+    const Uint32 NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    double LockingTime = 0;
+    double StagedTime  = 0;
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue{DefaultRawMemoryAllocator::GetAllocator()};
+        StagedTime = RunReleaseBenchmark(Queue, NumThreads, NumResourcesPerThread);
+
+        LockingReleaseQueue RefQueue;
+        LockingTime = RunReleaseBenchmark(RefQueue, NumThreads, NumResourcesPerThread);
+    }
+
+    LOG_INFO_MESSAGE("Release ", NumThreads * NumResourcesPerThread, " resources from ", NumThreads, " threads:",
+                     "\n    locking queue:   ", LockingTime, " ms",
+                     "\n    staged queue:    ", StagedTime, " ms");
+}
+
 } // namespace
@@ -0,0 +1,319 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "TLSFAllocationsManager.hpp"
+#include "VariableSizeAllocationsManager.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+using OffsetType = TLSFAllocationsManager::OffsetType;
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, AllocateFree)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    TLSFAllocationsManager Mgr(128, Allocator);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    auto a1 = Mgr.Allocate(17, 4);
+    EXPECT_EQ(a1.UnalignedOffset, OffsetType{0});
+    EXPECT_EQ(a1.Size, OffsetType{20});
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    auto a2 = Mgr.Allocate(17, 8);
+    EXPECT_EQ(a2.UnalignedOffset, OffsetType{20});
+    EXPECT_EQ(a2.Size, OffsetType{28});
+
+    auto a3 = Mgr.Allocate(8, 1);
+    EXPECT_EQ(a3.UnalignedOffset, OffsetType{48});
+    EXPECT_EQ(a3.Size, OffsetType{8});
+
+    auto a4 = Mgr.Allocate(11, 8);
+    EXPECT_EQ(a4.UnalignedOffset, OffsetType{56});
+    EXPECT_EQ(a4.Size, OffsetType{16});
+
+    auto a5 = Mgr.Allocate(64, 1);
+    EXPECT_FALSE(a5.IsValid());
+
+    a5 = Mgr.Allocate(56, 1);
+    EXPECT_EQ(a5.UnalignedOffset, OffsetType{72});
+    EXPECT_EQ(a5.Size, OffsetType{56});
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{0});
+    EXPECT_TRUE(Mgr.IsFull());
+
+    Mgr.Free(std::move(a2));
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    Mgr.Free(a4.UnalignedOffset, a4.Size);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{2});
+
+    Mgr.Free(std::move(a3));
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    EXPECT_EQ(Mgr.GetFreeSize(), OffsetType{52});
+
+    // The free block [20, 72) must be reused
+    auto a6 = Mgr.Allocate(52, 1);
+    EXPECT_EQ(a6.UnalignedOffset, OffsetType{20});
+    EXPECT_EQ(a6.Size, OffsetType{52});
+    EXPECT_TRUE(Mgr.IsFull());
+
+    Mgr.Free(std::move(a1));
+    Mgr.Free(std::move(a5));
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{2});
+    Mgr.Free(std::move(a6));
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    EXPECT_TRUE(Mgr.IsEmpty());
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, MoveAssign)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    {
+        TLSFAllocationsManager Mgr0(128, Allocator);
+        TLSFAllocationsManager Mgr1(256, Allocator);
+
+        auto a0 = Mgr0.Allocate(32, 1);
+        EXPECT_TRUE(a0.IsValid());
+
+        Mgr1 = std::move(Mgr0);
+        EXPECT_EQ(Mgr1.GetMaxSize(), OffsetType{128});
+        EXPECT_EQ(Mgr1.GetFreeSize(), OffsetType{96});
+
+        auto a1 = Mgr1.Allocate(96, 1);
+        EXPECT_EQ(a1.UnalignedOffset, OffsetType{32});
+        EXPECT_TRUE(Mgr1.IsFull());
+
+        Mgr1.Free(std::move(a0));
+        Mgr1.Free(std::move(a1));
+        EXPECT_TRUE(Mgr1.IsEmpty());
+
+        // Both the moved-from and the moved-to managers are destroyed here
+    }
+
+    {
+        TLSFAllocationsManager Mgr0(64, Allocator);
+        TLSFAllocationsManager Mgr1(64, Allocator);
+        Mgr1 = std::move(Mgr0);
+        // Moved-from manager can be assigned again
+        Mgr0 = std::move(Mgr1);
+        EXPECT_EQ(Mgr0.GetMaxSize(), OffsetType{64});
+        EXPECT_TRUE(Mgr0.IsEmpty());
+    }
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, ReleaseOrder)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    const auto NumAllocs = 6;
+    int        NumPerms  = 0;
+    size_t     ReleaseOrder[NumAllocs];
+    for (size_t a = 0; a < NumAllocs; ++a)
+        ReleaseOrder[a] = a;
+    do
+    {
+        ++NumPerms;
+        TLSFAllocationsManager Mgr(NumAllocs * 4, Allocator);
+
+        TLSFAllocationsManager::Allocation allocs[NumAllocs];
+        for (size_t a = 0; a < NumAllocs; ++a)
+        {
+            allocs[a] = Mgr.Allocate(4, 1);
+            EXPECT_EQ(allocs[a].UnalignedOffset, a * 4);
+            EXPECT_EQ(allocs[a].Size, OffsetType{4});
+        }
+        EXPECT_TRUE(Mgr.IsFull());
+        for (size_t a = 0; a < NumAllocs; ++a)
+        {
+            Mgr.Free(std::move(allocs[ReleaseOrder[a]]));
+        }
+        EXPECT_TRUE(Mgr.IsEmpty());
+        EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    } while (std::next_permutation(std::begin(ReleaseOrder), std::end(ReleaseOrder)));
+    EXPECT_EQ(NumPerms, 720);
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, Extend)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    TLSFAllocationsManager Mgr(0, Allocator);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{0});
+    EXPECT_FALSE(Mgr.Allocate(16, 1).IsValid());
+
+    Mgr.Extend(64);
+    EXPECT_EQ(Mgr.GetMaxSize(), OffsetType{64});
+    auto a1 = Mgr.Allocate(64, 1);
+    EXPECT_EQ(a1.UnalignedOffset, OffsetType{0});
+    EXPECT_TRUE(Mgr.IsFull());
+
+    // Last block is allocated - new block must be added
+    Mgr.Extend(32);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    auto a2 = Mgr.Allocate(16, 1);
+    EXPECT_EQ(a2.UnalignedOffset, OffsetType{64});
+
+    // Last block is free - it must be extended
+    Mgr.Extend(32);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    auto a3 = Mgr.Allocate(48, 1);
+    EXPECT_EQ(a3.UnalignedOffset, OffsetType{80});
+    EXPECT_TRUE(Mgr.IsFull());
+
+    Mgr.Free(std::move(a2));
+    Mgr.Free(std::move(a1));
+    Mgr.Free(std::move(a3));
+    EXPECT_TRUE(Mgr.IsEmpty());
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, RandomAllocations)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    constexpr OffsetType MaxSize = 1 << 16;
+
+    TLSFAllocationsManager Mgr(MaxSize, Allocator, 64);
+
+    FastRandInt RndSize{0, 1, 512};
+    FastRandInt RndAlignLog2{1, 0, 6};
+    FastRandInt RndIdx{2, 0, 30000};
+
+    std::vector<Uint8>                              Occupied(MaxSize);
+    std::vector<TLSFAllocationsManager::Allocation> Allocations;
+    OffsetType                                      UsedSize = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        if (Allocations.empty() || RndIdx() % 3 != 0)
+        {
+            const OffsetType Alignment = OffsetType{1} << RndAlignLog2();
+            const OffsetType Size      = RndSize();
+
+            auto Alloc = Mgr.Allocate(Size, Alignment);
+            if (!Alloc.IsValid())
+                continue;
+
+            const auto AlignedOffset = AlignUp(Alloc.UnalignedOffset, Alignment);
+            EXPECT_GE(Alloc.UnalignedOffset + Alloc.Size, AlignedOffset + Size);
+            EXPECT_LE(Alloc.UnalignedOffset + Alloc.Size, MaxSize);
+            for (auto o = Alloc.UnalignedOffset; o < Alloc.UnalignedOffset + Alloc.Size; ++o)
+            {
+                EXPECT_EQ(Occupied[o], 0) << "Allocations overlap";
+                Occupied[o] = 1;
+            }
+            UsedSize += Alloc.Size;
+            Allocations.push_back(Alloc);
+        }
+        else
+        {
+            auto  Idx   = static_cast<size_t>(RndIdx()) % Allocations.size();
+            auto& Alloc = Allocations[Idx];
+            for (auto o = Alloc.UnalignedOffset; o < Alloc.UnalignedOffset + Alloc.Size; ++o)
+                Occupied[o] = 0;
+            UsedSize -= Alloc.Size;
+            Mgr.Free(std::move(Alloc));
+            Allocations[Idx] = Allocations.back();
+            Allocations.pop_back();
+        }
+
+        EXPECT_EQ(Mgr.GetUsedSize(), UsedSize);
+    }
+
+    for (auto& Alloc : Allocations)
+        Mgr.Free(std::move(Alloc));
+    EXPECT_TRUE(Mgr.IsEmpty());
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+}
+
+template <typename AllocationsManagerType>
+double MeasureAllocationsManagerPerformance(size_t NumAllocations, int NumIterations)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    AllocationsManagerType Mgr(NumAllocations * 1024, Allocator);
+
+    std::vector<typename AllocationsManagerType::Allocation> Allocations(NumAllocations);
+
+    FastRandInt RndSize{0, 16, 1024};
+    FastRand    RndIdx{1};
+
+    for (auto& Alloc : Allocations)
+        Alloc = Mgr.Allocate(RndSize(), 16);
+
+    Timer T;
+    for (int i = 0; i < NumIterations; ++i)
+    {
+        // Release random allocations and immediately reallocate them with a different size
+        for (size_t j = 0; j < NumAllocations / 4; ++j)
+        {
+            auto& Alloc = Allocations[((size_t{RndIdx()} << 15u) | size_t{RndIdx()}) % NumAllocations];
+            Mgr.Free(std::move(Alloc));
+            Alloc = Mgr.Allocate(RndSize(), 16);
+            VERIFY_EXPR(Alloc.IsValid());
+        }
+    }
+    const auto ElapsedTime = T.GetElapsedTime();
+
+    for (auto& Alloc : Allocations)
+        Mgr.Free(std::move(Alloc));
+
+    return ElapsedTime;
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, DISABLED_Performance)
+{
+#ifdef DILIGENT_DEBUG
+    // Every operation verifies all blocks in debug build
+    constexpr size_t NumAllocations = 256;
+    constexpr int    NumIterations  = 10;
+#else
+    constexpr size_t NumAllocations = 100000;
+    constexpr int    NumIterations  = 10;
+#endif
+
+    const auto VSAMTime = MeasureAllocationsManagerPerformance<VariableSizeAllocationsManager>(NumAllocations, NumIterations);
+    const auto TLSFTime = MeasureAllocationsManagerPerformance<TLSFAllocationsManager>(NumAllocations, NumIterations);
+
+    const auto NumOps = NumAllocations / 4 * NumIterations;
+    LOG_INFO_MESSAGE(NumOps, " free/allocate pairs with ", NumAllocations, " live allocations:\n",
+                     "    VariableSizeAllocationsManager: ", VSAMTime * 1000, " ms\n",
+                     "    TLSFAllocationsManager:         ", TLSFTime * 1000, " ms");
+}
+
+} // namespace
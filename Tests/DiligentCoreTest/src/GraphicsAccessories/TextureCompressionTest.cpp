@@ -0,0 +1,474 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "TextureCompression.h"
+#include "GraphicsAccessories.hpp"
+#include "FastRand.hpp"
+#include "Timer.hpp"
+
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Generates an RGBA8 image with smooth gradients, hard edges and noise
+std::vector<Uint8> GenerateTestImage(Uint32 Width, Uint32 Height, bool WithAlpha)
+{
+    std::vector<Uint8> Image(size_t{Width} * Height * 4);
+
+    FastRandInt Rnd{0, -8, 8};
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const float u = static_cast<float>(x) / static_cast<float>(Width);
+            const float v = static_cast<float>(y) / static_cast<float>(Height);
+
+            int Color[4] = {
+                static_cast<int>(255.f * u),
+                static_cast<int>(127.5f + 127.5f * std::sin(v * 12.f + u * 3.f)),
+                ((x / 8 + y / 8) % 2) != 0 ? 200 : 40,
+                WithAlpha ? static_cast<int>(255.f * v) : 255,
+            };
+            for (Uint32 c = 0; c < 3; ++c)
+                Color[c] += Rnd();
+
+            for (Uint32 c = 0; c < 4; ++c)
+                Image[(size_t{y} * Width + x) * 4 + c] = static_cast<Uint8>(std::min(std::max(Color[c], 0), 255));
+        }
+    }
+
+    return Image;
+}
+
+std::vector<Uint8> Compress(const std::vector<Uint8>& Image, Uint32 Width, Uint32 Height, TEXTURE_FORMAT Format, BLOCK_COMPRESSION_QUALITY Quality, Uint32 NumThreads = 0, TEXTURE_FORMAT SrcFormat = TEX_FORMAT_RGBA8_UNORM)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+    const auto  NumBlocksX = (Width + 3) / 4;
+    const auto  NumBlocksY = (Height + 3) / 4;
+
+    std::vector<Uint8> Blocks(size_t{NumBlocksX} * NumBlocksY * FmtAttribs.ComponentSize);
+
+    CompressTextureAttribs Attribs;
+    Attribs.Width      = Width;
+    Attribs.Height     = Height;
+    Attribs.SrcFormat  = SrcFormat;
+    Attribs.Src.pData  = Image.data();
+    Attribs.Src.Stride = Width * 4;
+    Attribs.DstFormat  = Format;
+    Attribs.pDstData   = Blocks.data();
+    Attribs.DstStride  = NumBlocksX * FmtAttribs.ComponentSize;
+    Attribs.Quality    = Quality;
+    Attribs.NumThreads = NumThreads;
+    CompressTexture(Attribs);
+
+    return Blocks;
+}
+
+std::vector<Uint8> Decompress(const std::vector<Uint8>& Blocks, Uint32 Width, Uint32 Height, TEXTURE_FORMAT Format, Uint32 NumThreads = 0, TEXTURE_FORMAT DstFormat = TEX_FORMAT_RGBA8_UNORM)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+    const auto  NumBlocksX = (Width + 3) / 4;
+    const auto  TexelSize  = GetTextureFormatAttribs(DstFormat).GetElementSize();
+
+    std::vector<Uint8> Image(size_t{Width} * Height * TexelSize);
+
+    DecompressTextureAttribs Attribs;
+    Attribs.Width      = Width;
+    Attribs.Height     = Height;
+    Attribs.SrcFormat  = Format;
+    Attribs.Src.pData  = Blocks.data();
+    Attribs.Src.Stride = NumBlocksX * FmtAttribs.ComponentSize;
+    Attribs.DstFormat  = DstFormat;
+    Attribs.pDstData   = Image.data();
+    Attribs.DstStride  = Width * TexelSize;
+    Attribs.NumThreads = NumThreads;
+    DecompressTexture(Attribs);
+
+    return Image;
+}
+
+// Returns the number of channels that the format preserves
+Uint32 GetNumEncodedChannels(TEXTURE_FORMAT Format)
+{
+    switch (Format)
+    {
+        case TEX_FORMAT_BC1_UNORM: return 3;
+        case TEX_FORMAT_BC4_UNORM: return 1;
+        case TEX_FORMAT_BC5_UNORM: return 2;
+        default: return 4;
+    }
+}
+
+double ComputePSNR(const std::vector<Uint8>& Ref, const std::vector<Uint8>& Image, Uint32 NumChannels)
+{
+    double SqError = 0;
+    for (size_t i = 0; i < Ref.size() / 4; ++i)
+    {
+        for (Uint32 c = 0; c < NumChannels; ++c)
+        {
+            const double Diff = static_cast<double>(Ref[i * 4 + c]) - static_cast<double>(Image[i * 4 + c]);
+            SqError += Diff * Diff;
+        }
+    }
+    if (SqError == 0)
+        return 100;
+    const double MSE = SqError / static_cast<double>(Ref.size() / 4 * NumChannels);
+    return 10.0 * std::log10(255.0 * 255.0 / MSE);
+}
+
+constexpr TEXTURE_FORMAT TestFormats[] = {
+    TEX_FORMAT_BC1_UNORM,
+    TEX_FORMAT_BC2_UNORM,
+    TEX_FORMAT_BC3_UNORM,
+    TEX_FORMAT_BC4_UNORM,
+    TEX_FORMAT_BC5_UNORM,
+    TEX_FORMAT_BC7_UNORM,
+};
+
+constexpr BLOCK_COMPRESSION_QUALITY TestQualities[] = {
+    BLOCK_COMPRESSION_QUALITY_FAST,
+    BLOCK_COMPRESSION_QUALITY_NORMAL,
+    BLOCK_COMPRESSION_QUALITY_HIGH,
+};
+
+const char* GetQualityName(BLOCK_COMPRESSION_QUALITY Quality)
+{
+    switch (Quality)
+    {
+        case BLOCK_COMPRESSION_QUALITY_FAST: return "fast";
+        case BLOCK_COMPRESSION_QUALITY_NORMAL: return "normal";
+        case BLOCK_COMPRESSION_QUALITY_HIGH: return "high";
+        default: return "unknown";
+    }
+}
+
+TEST(GraphicsTools_TextureCompression, DecodeKnownBlocks)
+{
+    // BC1 4-color mode: red and blue endpoints, texel i uses index i % 4
+    {
+        const std::vector<Uint8> Block = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xE4, 0xE4, 0xE4};
+        const auto               Image = Decompress(Block, 4, 4, TEX_FORMAT_BC1_UNORM);
+
+        const Uint8 Expected[4][4] = {
+            {255, 0, 0, 255},
+            {0, 0, 255, 255},
+            {170, 0, 85, 255},
+            {85, 0, 170, 255},
+        };
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                EXPECT_EQ(Image[i * 4 + c], Expected[i % 4][c]) << "texel " << i << ", channel " << c;
+        }
+    }
+
+    // BC1 3-color mode: index 3 is transparent black
+    {
+        const std::vector<Uint8> Block = {0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4};
+        const auto               Image = Decompress(Block, 4, 4, TEX_FORMAT_BC1_UNORM);
+
+        const Uint8 Expected[4][4] = {
+            {0, 0, 255, 255},
+            {255, 0, 0, 255},
+            {127, 0, 127, 255},
+            {0, 0, 0, 0},
+        };
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                EXPECT_EQ(Image[i * 4 + c], Expected[i % 4][c]) << "texel " << i << ", channel " << c;
+        }
+    }
+
+    // BC4 8-value mode: texel i uses index i % 8
+    {
+        std::vector<Uint8> Block = {200, 100, 0, 0, 0, 0, 0, 0};
+
+        Uint64 Indices = 0;
+        for (Uint32 i = 0; i < 16; ++i)
+            Indices |= Uint64{i % 8} << (i * 3);
+        for (Uint32 i = 0; i < 6; ++i)
+            Block[2 + i] = static_cast<Uint8>(Indices >> (i * 8));
+
+        const auto Image = Decompress(Block, 4, 4, TEX_FORMAT_BC4_UNORM);
+
+        const Uint8 Expected[8] = {200, 100, 186, 171, 157, 143, 129, 114};
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            EXPECT_EQ(Image[i * 4 + 0], Expected[i % 8]) << "texel " << i;
+            EXPECT_EQ(Image[i * 4 + 1], 0) << "texel " << i;
+            EXPECT_EQ(Image[i * 4 + 2], 0) << "texel " << i;
+            EXPECT_EQ(Image[i * 4 + 3], 255) << "texel " << i;
+        }
+    }
+
+    // BC7 mode 6: endpoints 255 and 0 in all channels, texel i uses index i
+    {
+        std::vector<Uint8> Block(16);
+
+        Uint32 BitPos   = 0;
+        auto   AddValue = [&](Uint32 Value, Uint32 NumBits) {
+            for (Uint32 b = 0; b < NumBits; ++b, ++BitPos)
+            {
+                if ((Value >> b) & 1u)
+                    Block[BitPos / 8] |= static_cast<Uint8>(1u << (BitPos % 8));
+            }
+        };
+        AddValue(1u << 6, 7);
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            AddValue(127, 7);
+            AddValue(0, 7);
+        }
+        AddValue(1, 1);
+        AddValue(0, 1);
+        for (Uint32 i = 0; i < 16; ++i)
+            AddValue(i, i == 0 ? 3 : 4);
+        ASSERT_EQ(BitPos, 128u);
+
+        const auto Image = Decompress(Block, 4, 4, TEX_FORMAT_BC7_UNORM);
+
+        constexpr int Weights[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            const int Expected = ((64 - Weights[i]) * 255 + 32) >> 6;
+            for (Uint32 c = 0; c < 4; ++c)
+                EXPECT_EQ(Image[i * 4 + c], Expected) << "texel " << i << ", channel " << c;
+        }
+    }
+}
+
+TEST(GraphicsTools_TextureCompression, RoundTrip)
+{
+    constexpr Uint32 Size = 64;
+
+    const auto OpaqueImage = GenerateTestImage(Size, Size, false);
+    const auto AlphaImage  = GenerateTestImage(Size, Size, true);
+
+    for (auto Format : TestFormats)
+    {
+        const auto  NumChannels = GetNumEncodedChannels(Format);
+        const auto& Image       = NumChannels == 4 ? AlphaImage : OpaqueImage;
+
+        // Minimum expected PSNR for the fast quality
+        const double MinPSNR = Format == TEX_FORMAT_BC4_UNORM || Format == TEX_FORMAT_BC5_UNORM ? 40 : (Format == TEX_FORMAT_BC7_UNORM ? 35 : 32);
+
+        double PrevPSNR = 0;
+        for (auto Quality : TestQualities)
+        {
+            const auto Blocks  = Compress(Image, Size, Size, Format, Quality);
+            const auto Decoded = Decompress(Blocks, Size, Size, Format);
+            const auto PSNR    = ComputePSNR(Image, Decoded, NumChannels);
+            EXPECT_GT(PSNR, MinPSNR) << GetTextureFormatAttribs(Format).Name << ", " << GetQualityName(Quality);
+            EXPECT_GT(PSNR, PrevPSNR - 0.05) << GetTextureFormatAttribs(Format).Name << ", " << GetQualityName(Quality);
+            PrevPSNR = PSNR;
+        }
+    }
+}
+
+TEST(GraphicsTools_TextureCompression, SolidColor)
+{
+    FastRandInt Rnd{1, 0, 255};
+    for (auto Format : TestFormats)
+    {
+        const auto NumChannels = GetNumEncodedChannels(Format);
+        // BC1 endpoints have 5 and 6 bits, BC7 endpoints share p-bits between channels
+        const int Tolerance = (Format == TEX_FORMAT_BC1_UNORM || Format == TEX_FORMAT_BC2_UNORM || Format == TEX_FORMAT_BC3_UNORM) ? 2 : (Format == TEX_FORMAT_BC7_UNORM ? 1 : 0);
+        for (Uint32 i = 0; i < 64; ++i)
+        {
+            Uint8 Color[4];
+            for (Uint32 c = 0; c < 4; ++c)
+                Color[c] = static_cast<Uint8>(Rnd());
+            if (Format == TEX_FORMAT_BC1_UNORM)
+            {
+                // Texels with alpha below 128 are transparent
+                Color[3] = 255;
+            }
+
+            std::vector<Uint8> Image(4 * 4 * 4);
+            for (size_t t = 0; t < Image.size(); ++t)
+                Image[t] = Color[t % 4];
+
+            const auto Decoded = Decompress(Compress(Image, 4, 4, Format, BLOCK_COMPRESSION_QUALITY_NORMAL), 4, 4, Format);
+            for (Uint32 t = 0; t < 16; ++t)
+            {
+                for (Uint32 c = 0; c < NumChannels; ++c)
+                {
+                    // BC2 stores 4-bit alpha
+                    const int ChannelTolerance = (Format == TEX_FORMAT_BC2_UNORM && c == 3) ? 8 : Tolerance;
+                    EXPECT_NEAR(Decoded[t * 4 + c], Color[c], ChannelTolerance) << GetTextureFormatAttribs(Format).Name << ", channel " << c;
+                }
+            }
+        }
+    }
+}
+
+TEST(GraphicsTools_TextureCompression, BC1Transparency)
+{
+    constexpr Uint32 Size  = 16;
+    auto             Image = GenerateTestImage(Size, Size, false);
+    for (size_t i = 0; i < Image.size() / 4; ++i)
+    {
+        if ((i % 3) == 0)
+            Image[i * 4 + 3] = 0;
+    }
+
+    const auto Decoded = Decompress(Compress(Image, Size, Size, TEX_FORMAT_BC1_UNORM, BLOCK_COMPRESSION_QUALITY_NORMAL), Size, Size, TEX_FORMAT_BC1_UNORM);
+    for (size_t i = 0; i < Image.size() / 4; ++i)
+        EXPECT_EQ(Decoded[i * 4 + 3], (i % 3) == 0 ? 0 : 255) << "texel " << i;
+}
+
+TEST(GraphicsTools_TextureCompression, PartialBlocksAndThreads)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 19;
+
+    const auto OpaqueImage = GenerateTestImage(Width, Height, false);
+    const auto AlphaImage  = GenerateTestImage(Width, Height, true);
+    for (auto Format : TestFormats)
+    {
+        const auto& Image  = GetNumEncodedChannels(Format) == 4 ? AlphaImage : OpaqueImage;
+        const auto  Blocks = Compress(Image, Width, Height, Format, BLOCK_COMPRESSION_QUALITY_NORMAL, 1);
+        for (Uint32 NumThreads : {2u, 3u, 8u})
+        {
+            EXPECT_EQ(Blocks, Compress(Image, Width, Height, Format, BLOCK_COMPRESSION_QUALITY_NORMAL, NumThreads)) << GetTextureFormatAttribs(Format).Name;
+        }
+
+        const auto Decoded = Decompress(Blocks, Width, Height, Format, 1);
+        for (Uint32 NumThreads : {2u, 5u})
+            EXPECT_EQ(Decoded, Decompress(Blocks, Width, Height, Format, NumThreads)) << GetTextureFormatAttribs(Format).Name;
+
+        EXPECT_GT(ComputePSNR(Image, Decoded, GetNumEncodedChannels(Format)), 28) << GetTextureFormatAttribs(Format).Name;
+    }
+}
+
+TEST(GraphicsTools_TextureCompression, FormatConversion)
+{
+    constexpr Uint32 Size = 32;
+
+    const auto Image = GenerateTestImage(Size, Size, true);
+
+    // Compress float data and decompress to float data
+    std::vector<float> FloatImage(Image.size());
+    for (size_t i = 0; i < Image.size(); ++i)
+        FloatImage[i] = static_cast<float>(Image[i]) / 255.f;
+
+    const auto& BC7Attribs = GetTextureFormatAttribs(TEX_FORMAT_BC7_UNORM);
+
+    std::vector<Uint8> Blocks(Size / 4 * Size / 4 * BC7Attribs.ComponentSize);
+    {
+        CompressTextureAttribs Attribs;
+        Attribs.Width      = Size;
+        Attribs.Height     = Size;
+        Attribs.SrcFormat  = TEX_FORMAT_RGBA32_FLOAT;
+        Attribs.Src.pData  = FloatImage.data();
+        Attribs.Src.Stride = Size * 16;
+        Attribs.DstFormat  = TEX_FORMAT_BC7_UNORM;
+        Attribs.pDstData   = Blocks.data();
+        Attribs.DstStride  = Size / 4 * BC7Attribs.ComponentSize;
+        CompressTexture(Attribs);
+    }
+    EXPECT_EQ(Blocks, Compress(Image, Size, Size, TEX_FORMAT_BC7_UNORM, BLOCK_COMPRESSION_QUALITY_NORMAL));
+
+    const auto DecodedRGBA8 = Decompress(Blocks, Size, Size, TEX_FORMAT_BC7_UNORM);
+    const auto DecodedFloat = Decompress(Blocks, Size, Size, TEX_FORMAT_BC7_UNORM, 0, TEX_FORMAT_RGBA32_FLOAT);
+    for (size_t i = 0; i < DecodedRGBA8.size(); ++i)
+    {
+        float Value;
+        memcpy(&Value, &DecodedFloat[i * 4], sizeof(Value));
+        EXPECT_NEAR(Value, static_cast<float>(DecodedRGBA8[i]) / 255.f, 1e-6f);
+    }
+
+    // sRGB data is compressed as is
+    const auto SRGBBlocks = Compress(Image, Size, Size, TEX_FORMAT_BC7_UNORM_SRGB, BLOCK_COMPRESSION_QUALITY_NORMAL, 0, TEX_FORMAT_RGBA8_UNORM_SRGB);
+    EXPECT_EQ(SRGBBlocks, Blocks);
+    EXPECT_EQ(Decompress(SRGBBlocks, Size, Size, TEX_FORMAT_BC7_UNORM_SRGB, 0, TEX_FORMAT_RGBA8_UNORM_SRGB), DecodedRGBA8);
+}
+
+TEST(GraphicsTools_TextureCompression, UnsupportedFormats)
+{
+    for (auto Format : {TEX_FORMAT_BC1_UNORM, TEX_FORMAT_BC2_UNORM_SRGB, TEX_FORMAT_BC3_UNORM, TEX_FORMAT_BC4_UNORM, TEX_FORMAT_BC5_UNORM, TEX_FORMAT_BC7_UNORM_SRGB})
+        EXPECT_TRUE(IsBlockCompressionSupported(Format)) << GetTextureFormatAttribs(Format).Name;
+
+    constexpr Uint32 Size  = 8;
+    const auto       Image = GenerateTestImage(Size, Size, true);
+
+    // BC6H is explicitly unsupported: an error is logged and the destination data is not modified
+    for (auto Format : {TEX_FORMAT_BC6H_UF16, TEX_FORMAT_BC6H_SF16, TEX_FORMAT_RGBA8_UNORM})
+    {
+        EXPECT_FALSE(IsBlockCompressionSupported(Format)) << GetTextureFormatAttribs(Format).Name;
+
+        const auto Blocks = Compress(Image, Size, Size, Format, BLOCK_COMPRESSION_QUALITY_NORMAL);
+        for (auto Byte : Blocks)
+            ASSERT_EQ(Byte, 0) << GetTextureFormatAttribs(Format).Name;
+
+        const std::vector<Uint8> SrcBlocks(Blocks.size(), 0xFF);
+        const auto               Decoded = Decompress(SrcBlocks, Size, Size, Format);
+        for (auto Byte : Decoded)
+            ASSERT_EQ(Byte, 0) << GetTextureFormatAttribs(Format).Name;
+    }
+}
+
+TEST(GraphicsTools_TextureCompression, DISABLED_Benchmark)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 Size = 64;
+#else
+    constexpr Uint32 Size = 256;
+#endif
+
+    const auto OpaqueImage = GenerateTestImage(Size, Size, false);
+    const auto AlphaImage  = GenerateTestImage(Size, Size, true);
+
+    for (auto Format : TestFormats)
+    {
+        const auto  NumChannels = GetNumEncodedChannels(Format);
+        const auto& Image       = NumChannels == 4 ? AlphaImage : OpaqueImage;
+        for (auto Quality : TestQualities)
+        {
+            Timer T;
+
+            const auto   Blocks         = Compress(Image, Size, Size, Format, Quality, 1);
+            const double CompressTime   = T.GetElapsedTime();
+            const auto   Decoded        = Decompress(Blocks, Size, Size, Format, 1);
+            const double DecompressTime = T.GetElapsedTime() - CompressTime;
+
+            LOG_INFO_MESSAGE(GetTextureFormatAttribs(Format).Name, " (", GetQualityName(Quality), ", ", Size, "x", Size,
+                             "): compress ", CompressTime * 1000, " ms, decompress ", DecompressTime * 1000,
+                             " ms, PSNR ", ComputePSNR(Image, Decoded, NumChannels), " dB");
+        }
+    }
+}
+
+} // namespace
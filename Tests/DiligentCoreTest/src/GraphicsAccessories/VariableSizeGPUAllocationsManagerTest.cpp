@@ -203,6 +203,60 @@ TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, FreeOrder)
     }
 }
 
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, AllocateBelow)
+{
+    auto& Allocator  = DefaultRawMemoryAllocator::GetAllocator();
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+
+    VariableSizeAllocationsManager ListMgr(128, Allocator);
+
+    VariableSizeAllocationsManager::Allocation allocs[8];
+    for (size_t a = 0; a < _countof(allocs); ++a)
+        allocs[a] = ListMgr.Allocate(16, 16);
+
+    // |    |1111|    |3333|4444|5555|    |7777|
+    ListMgr.Free(std::move(allocs[0]));
+    ListMgr.Free(std::move(allocs[2]));
+    ListMgr.Free(std::move(allocs[6]));
+
+    // The first free block that fits the allocation must be used
+    auto a0 = ListMgr.AllocateBelow(8, 8, allocs[7].UnalignedOffset);
+    EXPECT_EQ(a0.UnalignedOffset, OffsetType{0});
+    EXPECT_EQ(a0.Size, OffsetType{8});
+
+    // Alignment of the free space at offset 8 is not sufficient
+    auto a1 = ListMgr.AllocateBelow(16, 16, allocs[7].UnalignedOffset);
+    EXPECT_EQ(a1.UnalignedOffset, OffsetType{32});
+    EXPECT_EQ(a1.Size, OffsetType{16});
+
+    // The allocation must end before the end offset
+    auto a2 = ListMgr.AllocateBelow(16, 1, allocs[5].UnalignedOffset);
+    EXPECT_FALSE(a2.IsValid());
+
+    a2 = ListMgr.AllocateBelow(8, 1, allocs[5].UnalignedOffset);
+    EXPECT_EQ(a2.UnalignedOffset, OffsetType{8});
+    EXPECT_EQ(a2.Size, OffsetType{8});
+
+    auto a3 = ListMgr.AllocateBelow(16, 1, allocs[7].UnalignedOffset);
+    EXPECT_EQ(a3.UnalignedOffset, OffsetType{96});
+    EXPECT_EQ(a3.Size, OffsetType{16});
+
+    auto a4 = ListMgr.AllocateBelow(1, 1, 128);
+    EXPECT_FALSE(a4.IsValid());
+    EXPECT_TRUE(ListMgr.IsFull());
+
+    ListMgr.Free(std::move(a0));
+    ListMgr.Free(std::move(a1));
+    ListMgr.Free(std::move(a2));
+    ListMgr.Free(std::move(a3));
+    for (auto& Alloc : allocs)
+    {
+        if (Alloc.IsValid())
+            ListMgr.Free(std::move(Alloc));
+    }
+    EXPECT_TRUE(ListMgr.IsEmpty());
+}
+
 TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, Free)
 {
     auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
@@ -0,0 +1,676 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ShaderBase.hpp"
+#include "PipelineStateBase.hpp"
+#include "ShaderCreateInfoWrapper.hpp"
+#include "ThreadPool.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "RefCountedObjectImpl.hpp"
+
+#if !DILIGENT_NO_GLSLANG
+#    include <map>
+#    include "EngineMemory.h"
+#    include "GLSLangUtils.hpp"
+#    include "SPIRVShaderResources.hpp"
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Blocks compilation until the test opens it
+class CompilationGate
+{
+public:
+    void Open()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_IsOpen = true;
+        m_CondVar.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+        m_CondVar.wait(Lock, [this] { return m_IsOpen; });
+    }
+
+private:
+    std::mutex              m_Mtx;
+    std::condition_variable m_CondVar;
+    bool                    m_IsOpen = false;
+};
+
+// Implements the part of the render device interface that is used by ShaderBase and
+// PipelineStateBase. The device is not reference counted and must outlive all objects.
+class MockRenderDevice final : public IRenderDevice
+{
+public:
+    explicit MockRenderDevice(Uint32 NumCompilationThreads) :
+        m_ThreadPool{NumCompilationThreads}
+    {
+        m_DeviceInfo.Features = DeviceFeatures{DEVICE_FEATURE_STATE_ENABLED};
+    }
+
+    // clang-format off
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final { *ppInterface = nullptr; }
+
+    virtual ReferenceCounterValueType DILIGENT_CALL_TYPE AddRef() override final { return 1; }
+    virtual ReferenceCounterValueType DILIGENT_CALL_TYPE Release() override final { return 1; }
+
+    virtual IReferenceCounters* DILIGENT_CALL_TYPE GetReferenceCounters() const override final { return nullptr; }
+
+    virtual void DILIGENT_CALL_TYPE CreateBuffer(const BufferDesc&, const BufferData*, IBuffer**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateShader(const ShaderCreateInfo&, IShader**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateTexture(const TextureDesc&, const TextureData*, ITexture**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateSampler(const SamplerDesc&, ISampler**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateResourceMapping(const ResourceMappingDesc&, IResourceMapping**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateGraphicsPipelineState(const GraphicsPipelineStateCreateInfo&, IPipelineState**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateComputePipelineState(const ComputePipelineStateCreateInfo&, IPipelineState**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateRayTracingPipelineState(const RayTracingPipelineStateCreateInfo&, IPipelineState**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateTilePipelineState(const TilePipelineStateCreateInfo&, IPipelineState**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateFence(const FenceDesc&, IFence**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateQuery(const QueryDesc&, IQuery**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateRenderPass(const RenderPassDesc&, IRenderPass**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateFramebuffer(const FramebufferDesc&, IFramebuffer**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateBLAS(const BottomLevelASDesc&, IBottomLevelAS**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateTLAS(const TopLevelASDesc&, ITopLevelAS**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreateSBT(const ShaderBindingTableDesc&, IShaderBindingTable**) override final { UNSUPPORTED("Not implemented"); }
+    virtual void DILIGENT_CALL_TYPE CreatePipelineResourceSignature(const PipelineResourceSignatureDesc&, IPipelineResourceSignature**) override final { UNSUPPORTED("Not implemented"); }
+
+    virtual const RenderDeviceInfo&     DILIGENT_CALL_TYPE GetDeviceInfo() const override final { return m_DeviceInfo; }
+    virtual const GraphicsAdapterInfo&  DILIGENT_CALL_TYPE GetAdapterInfo() const override final { return m_AdapterInfo; }
+    virtual const TextureFormatInfo&    DILIGENT_CALL_TYPE GetTextureFormatInfo(TEXTURE_FORMAT) override final { UNSUPPORTED("Not implemented"); return m_TexFmtInfo; }
+    virtual const TextureFormatInfoExt& DILIGENT_CALL_TYPE GetTextureFormatInfoExt(TEXTURE_FORMAT) override final { UNSUPPORTED("Not implemented"); return m_TexFmtInfo; }
+
+    virtual void            DILIGENT_CALL_TYPE ReleaseStaleResources(bool) override final {}
+    virtual void            DILIGENT_CALL_TYPE IdleGPU() override final {}
+    virtual IEngineFactory* DILIGENT_CALL_TYPE GetEngineFactory() const override final { return nullptr; }
+    // clang-format on
+
+    const DeviceFeatures& GetFeatures() const { return m_DeviceInfo.Features; }
+
+    Uint64 GetCommandQueueMask() const { return 1; }
+    Uint32 GetCommandQueueCount() const { return 1; }
+
+    ThreadPool& GetShaderCompilationThreadPool() { return m_ThreadPool; }
+
+    CompilationGate* pGate = nullptr;
+
+private:
+    RenderDeviceInfo     m_DeviceInfo;
+    GraphicsAdapterInfo  m_AdapterInfo;
+    TextureFormatInfoExt m_TexFmtInfo;
+    ThreadPool           m_ThreadPool;
+};
+
+class MockPipelineStateImpl;
+
+// Pipelines in this test only use the implicit signature that is never created,
+// so the signature type is only needed to instantiate PipelineStateBase.
+class MockPipelineResourceSignature : public IPipelineResourceSignature
+{
+public:
+    static bool SignaturesCompatible(const MockPipelineResourceSignature* pSign0, const MockPipelineResourceSignature* pSign1)
+    {
+        return pSign0 == pSign1;
+    }
+};
+
+struct MockEngineImplTraits
+{
+    using ShaderInterface                   = IShader;
+    using PipelineStateInterface            = IPipelineState;
+    using RenderDeviceImplType              = MockRenderDevice;
+    using PipelineStateImplType             = MockPipelineStateImpl;
+    using PipelineResourceSignatureImplType = MockPipelineResourceSignature;
+};
+
+// Emulates the CPU-only stages of the shader creation: the source is "compiled" by
+// prepending macro definitions, and every Texture2D declaration is "reflected" as a resource.
+class MockShaderImpl final : public ShaderBase<MockEngineImplTraits>
+{
+public:
+    using TShaderBase = ShaderBase<MockEngineImplTraits>;
+
+    MockShaderImpl(IReferenceCounters* pRefCounters, MockRenderDevice* pDevice, const ShaderCreateInfo& ShaderCI) :
+        TShaderBase{pRefCounters, pDevice, ShaderCI.Desc, true}
+    {
+        if ((ShaderCI.CompileFlags & SHADER_COMPILE_FLAG_ASYNCHRONOUS) != 0)
+        {
+            auto pShaderCI = std::make_shared<ShaderCreateInfoWrapper>(ShaderCI);
+
+            m_AsyncInitializer = std::make_unique<AsyncInitializer>(
+                pDevice->GetShaderCompilationThreadPool(),
+                [this, pShaderCI]() mutable {
+                    const auto pTaskShaderCI = std::move(pShaderCI);
+                    Initialize(*pTaskShaderCI);
+                });
+        }
+        else
+        {
+            Initialize(ShaderCI);
+        }
+    }
+
+    ~MockShaderImpl()
+    {
+        m_AsyncInitializer.reset();
+    }
+
+    virtual Uint32 DILIGENT_CALL_TYPE GetResourceCount() const override final
+    {
+        WaitForCompilation();
+        return static_cast<Uint32>(m_Resources.size());
+    }
+
+    virtual void DILIGENT_CALL_TYPE GetResourceDesc(Uint32 Index, ShaderResourceDesc& ResourceDesc) const override final
+    {
+        WaitForCompilation();
+        ResourceDesc = ShaderResourceDesc{m_Resources[Index].c_str(), SHADER_RESOURCE_TYPE_TEXTURE_SRV, 1};
+    }
+
+    const std::string& GetCompiledSource() const
+    {
+        WaitForCompilation();
+        return m_CompiledSource;
+    }
+
+private:
+    void Initialize(const ShaderCreateInfo& ShaderCI)
+    {
+        if (auto* pGate = GetDevice()->pGate)
+            pGate->Wait();
+
+        if (ShaderCI.Source == nullptr)
+            LOG_ERROR_AND_THROW("Shader source must not be null");
+
+        std::string Source{ShaderCI.Source};
+        if (Source.find("#error") != std::string::npos)
+            LOG_ERROR_AND_THROW("Failed to compile shader '", ShaderCI.Desc.Name, "'");
+
+        std::stringstream ss;
+        for (const auto* pMacro = ShaderCI.Macros; pMacro != nullptr && pMacro->Name != nullptr; ++pMacro)
+            ss << "#define " << pMacro->Name << ' ' << pMacro->Definition << '\n';
+        ss << Source;
+        m_CompiledSource = ss.str();
+
+        std::string Line;
+        while (std::getline(ss, Line))
+        {
+            static constexpr char Texture2D[] = "Texture2D ";
+            if (Line.compare(0, sizeof(Texture2D) - 1, Texture2D) == 0)
+                m_Resources.emplace_back(Line.substr(sizeof(Texture2D) - 1));
+        }
+    }
+
+    std::string              m_CompiledSource;
+    std::vector<std::string> m_Resources;
+};
+
+RefCntAutoPtr<MockShaderImpl> CreateMockShader(MockRenderDevice& Device, const ShaderCreateInfo& ShaderCI)
+{
+    return RefCntAutoPtr<MockShaderImpl>{MakeNewRCObj<MockShaderImpl>()(&Device, ShaderCI)};
+}
+
+// Emulates a compute pipeline whose initialization only consumes the compiled shader source.
+class MockPipelineStateImpl final : public PipelineStateBase<MockEngineImplTraits>
+{
+public:
+    using TPipelineStateBase = PipelineStateBase<MockEngineImplTraits>;
+
+    MockPipelineStateImpl(IReferenceCounters* pRefCounters, MockRenderDevice* pDevice, const ComputePipelineStateCreateInfo& CreateInfo) :
+        TPipelineStateBase{pRefCounters, pDevice, CreateInfo}
+    {
+        try
+        {
+            if ((CreateInfo.Flags & PSO_CREATE_FLAG_ASYNCHRONOUS) != 0)
+            {
+                RefCntAutoPtr<IShader> pCS{CreateInfo.pCS};
+
+                m_AsyncInitializer = std::make_unique<AsyncInitializer>(
+                    pDevice->GetShaderCompilationThreadPool(),
+                    [this, pCS]() mutable {
+                        auto pTaskCS = std::move(pCS);
+                        Initialize(pTaskCS);
+                    });
+            }
+            else
+            {
+                Initialize(CreateInfo.pCS);
+            }
+        }
+        catch (...)
+        {
+            Destruct();
+            throw;
+        }
+    }
+
+    ~MockPipelineStateImpl()
+    {
+        m_AsyncInitializer.reset();
+        Destruct();
+    }
+
+    const std::string& GetCompiledSource() const
+    {
+        return m_CompiledSource;
+    }
+
+private:
+    void Initialize(IShader* pCS)
+    {
+        ComputePipelineStateCreateInfo CreateInfo;
+        CreateInfo.PSODesc.PipelineType = PIPELINE_TYPE_COMPUTE;
+        CreateInfo.pCS                  = pCS;
+
+        std::vector<MockShaderImpl*> ShaderStages;
+        ExtractShaders<MockShaderImpl>(CreateInfo, ShaderStages);
+        m_CompiledSource = ShaderStages[0]->GetCompiledSource();
+    }
+
+    std::string m_CompiledSource;
+};
+
+RefCntAutoPtr<MockPipelineStateImpl> CreateMockPSO(MockRenderDevice& Device, const ComputePipelineStateCreateInfo& PSOCreateInfo)
+{
+    return RefCntAutoPtr<MockPipelineStateImpl>{MakeNewRCObj<MockPipelineStateImpl>()(&Device, PSOCreateInfo)};
+}
+
+TEST(GraphicsEngine_AsyncShaderCompilation, Synchronous)
+{
+    MockRenderDevice Device{1};
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name       = "Sync shader";
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+    ShaderCI.Source          = "Texture2D g_Tex\n";
+
+    auto pShader = CreateMockShader(Device, ShaderCI);
+    ASSERT_TRUE(pShader);
+    EXPECT_EQ(pShader->GetStatus(false), SHADER_STATUS_READY);
+    EXPECT_EQ(pShader->GetResourceCount(), 1u);
+}
+
+TEST(GraphicsEngine_AsyncShaderCompilation, Asynchronous)
+{
+    MockRenderDevice Device{2};
+    CompilationGate  Gate;
+    Device.pGate = &Gate;
+
+    RefCntAutoPtr<MockShaderImpl> pShader;
+    {
+        // All data referenced by the create info is released before the shader is compiled
+        std::string Name{"Async shader"};
+        std::string Source{"Texture2D g_Tex0\nTexture2D g_Tex1\n"};
+        std::string MacroName{"MACRO"};
+        std::string MacroDef{"1"};
+
+        ShaderMacro Macros[] = {{MacroName.c_str(), MacroDef.c_str()}, {}};
+
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.Desc.Name       = Name.c_str();
+        ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+        ShaderCI.Source          = Source.c_str();
+        ShaderCI.Macros          = Macros;
+        ShaderCI.CompileFlags    = SHADER_COMPILE_FLAG_ASYNCHRONOUS;
+
+        pShader = CreateMockShader(Device, ShaderCI);
+        ASSERT_TRUE(pShader);
+        EXPECT_EQ(pShader->GetStatus(false), SHADER_STATUS_COMPILING);
+
+        Name.assign(Name.size(), '?');
+        Source.assign(Source.size(), '?');
+        MacroName.assign(MacroName.size(), '?');
+        MacroDef.assign(MacroDef.size(), '?');
+    }
+    EXPECT_EQ(pShader->GetStatus(false), SHADER_STATUS_COMPILING);
+    EXPECT_STREQ(pShader->GetDesc().Name, "Async shader");
+
+    Gate.Open();
+
+    EXPECT_EQ(pShader->GetStatus(true), SHADER_STATUS_READY);
+    EXPECT_EQ(pShader->GetCompiledSource(), "#define MACRO 1\nTexture2D g_Tex0\nTexture2D g_Tex1\n");
+    ASSERT_EQ(pShader->GetResourceCount(), 2u);
+
+    ShaderResourceDesc ResDesc;
+    pShader->GetResourceDesc(1, ResDesc);
+    EXPECT_STREQ(ResDesc.Name, "g_Tex1");
+}
+
+TEST(GraphicsEngine_AsyncShaderCompilation, Failure)
+{
+    MockRenderDevice Device{1};
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name       = "Broken shader";
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+    ShaderCI.Source          = "#error Broken shader\n";
+    ShaderCI.CompileFlags    = SHADER_COMPILE_FLAG_ASYNCHRONOUS;
+
+    // Synchronous compilation of the same shader throws from the constructor,
+    // asynchronous compilation reports the error through the status.
+    auto pShader = CreateMockShader(Device, ShaderCI);
+    ASSERT_TRUE(pShader);
+    EXPECT_EQ(pShader->GetStatus(true), SHADER_STATUS_FAILED);
+    EXPECT_EQ(pShader->GetResourceCount(), 0u);
+}
+
+TEST(GraphicsEngine_AsyncShaderCompilation, ManyShaders)
+{
+    MockRenderDevice Device{4};
+
+    constexpr Uint32 NumShaders = 256;
+
+    std::vector<RefCntAutoPtr<MockShaderImpl>> Shaders;
+    for (Uint32 i = 0; i < NumShaders; ++i)
+    {
+        const auto Source = std::string{"Texture2D g_Tex"} + std::to_string(i) + '\n';
+
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+        ShaderCI.Source          = Source.c_str();
+        ShaderCI.CompileFlags    = SHADER_COMPILE_FLAG_ASYNCHRONOUS;
+
+        auto pShader = CreateMockShader(Device, ShaderCI);
+        ASSERT_TRUE(pShader);
+        // Release every other shader while it may still be compiling
+        if (i % 2 == 0)
+            Shaders.emplace_back(std::move(pShader));
+    }
+
+    for (Uint32 i = 0; i < Shaders.size(); ++i)
+    {
+        auto& pShader = Shaders[i];
+        EXPECT_EQ(pShader->GetStatus(true), SHADER_STATUS_READY);
+        ASSERT_EQ(pShader->GetResourceCount(), 1u);
+
+        ShaderResourceDesc ResDesc;
+        pShader->GetResourceDesc(0, ResDesc);
+        EXPECT_EQ(std::string{ResDesc.Name}, std::string{"g_Tex"} + std::to_string(i * 2));
+    }
+}
+
+TEST(GraphicsEngine_AsyncShaderCompilation, AsyncPipeline)
+{
+    MockRenderDevice Device{2};
+    CompilationGate  Gate;
+    Device.pGate = &Gate;
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name       = "Async CS";
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_COMPUTE;
+    ShaderCI.Source          = "Texture2D g_Tex\n";
+    ShaderCI.CompileFlags    = SHADER_COMPILE_FLAG_ASYNCHRONOUS;
+
+    auto pCS = CreateMockShader(Device, ShaderCI);
+    ASSERT_TRUE(pCS);
+
+    ComputePipelineStateCreateInfo PSOCreateInfo;
+    PSOCreateInfo.PSODesc.Name         = "Async PSO";
+    PSOCreateInfo.PSODesc.PipelineType = PIPELINE_TYPE_COMPUTE;
+    PSOCreateInfo.pCS                  = pCS;
+    PSOCreateInfo.Flags                = PSO_CREATE_FLAG_ASYNCHRONOUS;
+
+    auto pPSO = CreateMockPSO(Device, PSOCreateInfo);
+    ASSERT_TRUE(pPSO);
+    // The pipeline waits for the shader that is blocked by the gate
+    EXPECT_EQ(pPSO->GetStatus(false), PIPELINE_STATE_STATUS_COMPILING);
+
+    Gate.Open();
+
+    EXPECT_EQ(pPSO->GetStatus(true), PIPELINE_STATE_STATUS_READY);
+    EXPECT_EQ(pPSO->GetCompiledSource(), "Texture2D g_Tex\n");
+    EXPECT_EQ(pPSO->GetActiveShaderStages(), SHADER_TYPE_COMPUTE);
+    // The task must release the shader before the pipeline is reported as ready
+    EXPECT_EQ(pCS->GetReferenceCounters()->GetNumStrongRefs(), 1);
+}
+
+TEST(GraphicsEngine_AsyncShaderCompilation, PipelineWithFailedShader)
+{
+    MockRenderDevice Device{1};
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name       = "Broken CS";
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_COMPUTE;
+    ShaderCI.Source          = "#error Broken shader\n";
+    ShaderCI.CompileFlags    = SHADER_COMPILE_FLAG_ASYNCHRONOUS;
+
+    auto pCS = CreateMockShader(Device, ShaderCI);
+    ASSERT_TRUE(pCS);
+
+    ComputePipelineStateCreateInfo PSOCreateInfo;
+    PSOCreateInfo.PSODesc.Name         = "PSO with broken shader";
+    PSOCreateInfo.PSODesc.PipelineType = PIPELINE_TYPE_COMPUTE;
+    PSOCreateInfo.pCS                  = pCS;
+    PSOCreateInfo.Flags                = PSO_CREATE_FLAG_ASYNCHRONOUS;
+
+    auto pPSO = CreateMockPSO(Device, PSOCreateInfo);
+    ASSERT_TRUE(pPSO);
+    EXPECT_EQ(pPSO->GetStatus(true), PIPELINE_STATE_STATUS_FAILED);
+    EXPECT_EQ(pCS->GetReferenceCounters()->GetNumStrongRefs(), 1);
+
+    // Synchronous pipeline creation waits for the shader and throws
+    PSOCreateInfo.Flags = PSO_CREATE_FLAG_NONE;
+    EXPECT_ANY_THROW(CreateMockPSO(Device, PSOCreateInfo));
+}
+
+#if !DILIGENT_NO_GLSLANG
+
+// Runs the same compilation and reflection stages as the Vulkan shader: HLSL is compiled
+// to SPIR-V by glslang, and the resources are loaded from the SPIR-V by SPIRVShaderResources.
+class MockSPIRVShaderImpl final : public ShaderBase<MockEngineImplTraits>
+{
+public:
+    using TShaderBase = ShaderBase<MockEngineImplTraits>;
+
+    MockSPIRVShaderImpl(IReferenceCounters* pRefCounters, MockRenderDevice* pDevice, const ShaderCreateInfo& ShaderCI) :
+        TShaderBase{pRefCounters, pDevice, ShaderCI.Desc, true}
+    {
+        if ((ShaderCI.CompileFlags & SHADER_COMPILE_FLAG_ASYNCHRONOUS) != 0)
+        {
+            auto pShaderCI = std::make_shared<ShaderCreateInfoWrapper>(ShaderCI);
+
+            m_AsyncInitializer = std::make_unique<AsyncInitializer>(
+                pDevice->GetShaderCompilationThreadPool(),
+                [this, pShaderCI]() mutable {
+                    const auto pTaskShaderCI = std::move(pShaderCI);
+                    Initialize(*pTaskShaderCI);
+                });
+        }
+        else
+        {
+            Initialize(ShaderCI);
+        }
+    }
+
+    ~MockSPIRVShaderImpl()
+    {
+        m_AsyncInitializer.reset();
+    }
+
+    virtual Uint32 DILIGENT_CALL_TYPE GetResourceCount() const override final
+    {
+        WaitForCompilation();
+        return m_pShaderResources ? m_pShaderResources->GetTotalResources() : 0;
+    }
+
+    virtual void DILIGENT_CALL_TYPE GetResourceDesc(Uint32 Index, ShaderResourceDesc& ResourceDesc) const override final
+    {
+        const auto ResCount = GetResourceCount();
+        DEV_CHECK_ERR(Index < ResCount, "Resource index (", Index, ") is out of range");
+        if (Index < ResCount)
+            ResourceDesc = m_pShaderResources->GetResource(Index).GetResourceDesc();
+    }
+
+    const std::vector<uint32_t>& GetSPIRV() const
+    {
+        WaitForCompilation();
+        return m_SPIRV;
+    }
+
+private:
+    void Initialize(const ShaderCreateInfo& ShaderCI)
+    {
+        if (auto* pGate = GetDevice()->pGate)
+            pGate->Wait();
+
+        m_SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, "#define VULKAN 1\n", nullptr);
+        if (m_SPIRV.empty())
+            LOG_ERROR_AND_THROW("Failed to compile shader '", ShaderCI.Desc.Name, "'");
+
+        auto& Allocator = GetRawAllocator();
+        auto* pRawMem   = ALLOCATE(Allocator, "Allocator for ShaderResources", SPIRVShaderResources, 1);
+        auto* pResources =
+            new (pRawMem) SPIRVShaderResources{Allocator, m_SPIRV, m_Desc, nullptr, false, m_EntryPoint};
+        m_pShaderResources.reset(pResources, STDDeleterRawMem<SPIRVShaderResources>(Allocator));
+    }
+
+    std::vector<uint32_t>                       m_SPIRV;
+    std::shared_ptr<const SPIRVShaderResources> m_pShaderResources;
+    std::string                                 m_EntryPoint;
+};
+
+RefCntAutoPtr<MockSPIRVShaderImpl> CreateMockSPIRVShader(MockRenderDevice& Device, const ShaderCreateInfo& ShaderCI)
+{
+    return RefCntAutoPtr<MockSPIRVShaderImpl>{MakeNewRCObj<MockSPIRVShaderImpl>()(&Device, ShaderCI)};
+}
+
+const char* const HLSLComputeShader = R"(
+cbuffer Constants
+{
+    float4 g_Scale;
+};
+
+Texture2D<float4>   g_Input;
+SamplerState        g_Input_sampler;
+RWTexture2D<float4> g_Output;
+
+[numthreads(8, 8, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    float2 UV = float2(DTid.xy) / 256.0;
+    g_Output[DTid.xy] = g_Input.SampleLevel(g_Input_sampler, UV, 0.0) * g_Scale * SCALE;
+}
+)";
+
+TEST(GraphicsEngine_AsyncShaderCompilation, HLSLtoSPIRV)
+{
+    GLSLangUtils::GlslangScope Glslang;
+
+    MockRenderDevice Device{2};
+    CompilationGate  Gate;
+    Device.pGate = &Gate;
+
+    ShaderMacro Macros[] = {{"SCALE", "2.0"}, {}};
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name       = "Async HLSL CS";
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_COMPUTE;
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.Source          = HLSLComputeShader;
+    ShaderCI.Macros          = Macros;
+    ShaderCI.CompileFlags    = SHADER_COMPILE_FLAG_ASYNCHRONOUS;
+
+    auto pShader = CreateMockSPIRVShader(Device, ShaderCI);
+    ASSERT_TRUE(pShader);
+    EXPECT_EQ(pShader->GetStatus(false), SHADER_STATUS_COMPILING);
+
+    Gate.Open();
+
+    ASSERT_EQ(pShader->GetStatus(true), SHADER_STATUS_READY);
+    EXPECT_FALSE(pShader->GetSPIRV().empty());
+
+    std::map<std::string, SHADER_RESOURCE_TYPE> Resources;
+    for (Uint32 i = 0; i < pShader->GetResourceCount(); ++i)
+    {
+        ShaderResourceDesc ResDesc;
+        pShader->GetResourceDesc(i, ResDesc);
+        Resources.emplace(ResDesc.Name, ResDesc.Type);
+    }
+
+    const std::map<std::string, SHADER_RESOURCE_TYPE> ExpectedResources = {
+        {"Constants", SHADER_RESOURCE_TYPE_CONSTANT_BUFFER},
+        {"g_Input", SHADER_RESOURCE_TYPE_TEXTURE_SRV},
+        {"g_Input_sampler", SHADER_RESOURCE_TYPE_SAMPLER},
+        {"g_Output", SHADER_RESOURCE_TYPE_TEXTURE_UAV},
+    };
+    EXPECT_EQ(Resources, ExpectedResources);
+
+    // Shaders that are compiled concurrently produce the same SPIR-V
+    constexpr Uint32 NumShaders = 8;
+
+    ShaderCI.Desc.Name = "Async HLSL CS copy";
+    std::vector<RefCntAutoPtr<MockSPIRVShaderImpl>> Shaders;
+    for (Uint32 i = 0; i < NumShaders; ++i)
+    {
+        Shaders.emplace_back(CreateMockSPIRVShader(Device, ShaderCI));
+        ASSERT_TRUE(Shaders.back());
+    }
+    for (auto& pCopy : Shaders)
+    {
+        ASSERT_EQ(pCopy->GetStatus(true), SHADER_STATUS_READY);
+        EXPECT_EQ(pCopy->GetSPIRV(), pShader->GetSPIRV());
+    }
+}
+
+TEST(GraphicsEngine_AsyncShaderCompilation, HLSLtoSPIRVFailure)
+{
+    GLSLangUtils::GlslangScope Glslang;
+
+    MockRenderDevice Device{1};
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name       = "Broken async HLSL CS";
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_COMPUTE;
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+    // SCALE macro is not defined
+    ShaderCI.Source       = HLSLComputeShader;
+    ShaderCI.CompileFlags = SHADER_COMPILE_FLAG_ASYNCHRONOUS;
+
+    auto pShader = CreateMockSPIRVShader(Device, ShaderCI);
+    ASSERT_TRUE(pShader);
+    EXPECT_EQ(pShader->GetStatus(true), SHADER_STATUS_FAILED);
+    EXPECT_EQ(pShader->GetResourceCount(), 0u);
+}
+
+#endif
+
+} // namespace
@@ -0,0 +1,443 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "ShaderBytecodeCache.hpp"
+#include "FileWrapper.hpp"
+#include "RefCntAutoPtr.hpp"
+
+#if !DILIGENT_NO_GLSLANG
+#    include "GLSLangUtils.hpp"
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Removes all entries from the cache directory
+void ClearCache(const char* Directory)
+{
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    CI.MaxSize   = 0;
+    ShaderBytecodeCache Cache{CI};
+    EXPECT_EQ(Cache.GetStatistics().NumEntries, 0u);
+}
+
+ShaderBytecodeCache::Key MakeKey(Uint32 Id)
+{
+    ShaderBytecodeCache::KeyBuilder Builder;
+    Builder.Update("ShaderBytecodeCacheTest", Id);
+    return Builder.GetKey();
+}
+
+std::vector<Uint32> MakeBytecode(Uint32 Id, size_t NumWords)
+{
+    std::vector<Uint32> Bytecode(NumWords);
+    for (size_t i = 0; i < NumWords; ++i)
+        Bytecode[i] = Id * 1000 + static_cast<Uint32>(i);
+    return Bytecode;
+}
+
+bool LoadAndCompare(ShaderBytecodeCache& Cache, Uint32 Id, const std::vector<Uint32>& RefBytecode)
+{
+    RefCntAutoPtr<IDataBlob> pBytecode;
+    if (!Cache.Load(MakeKey(Id), &pBytecode))
+        return false;
+
+    EXPECT_EQ(pBytecode->GetSize(), RefBytecode.size() * sizeof(Uint32));
+    EXPECT_EQ(memcmp(pBytecode->GetDataPtr(), RefBytecode.data(), RefBytecode.size() * sizeof(Uint32)), 0);
+    return true;
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, KeyBuilder)
+{
+    auto GetKey = [](const char* Str0, const char* Str1) {
+        ShaderBytecodeCache::KeyBuilder Builder;
+        Builder.Update(Str0, Str1);
+        return Builder.GetKey();
+    };
+
+    EXPECT_EQ(GetKey("abc", "def"), GetKey("abc", "def"));
+    EXPECT_NE(GetKey("abc", "def"), GetKey("abcd", "ef"));
+    EXPECT_NE(GetKey("abc", "def"), GetKey("abc", "deg"));
+
+    const auto Str = GetKey("abc", "def").ToString();
+    EXPECT_EQ(Str.length(), size_t{32});
+    EXPECT_EQ(Str.find_first_not_of("0123456789abcdef"), String::npos);
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, StoreLoad)
+{
+    const char* Directory = "ShaderBytecodeCacheTest_StoreLoad";
+    ClearCache(Directory);
+
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    ShaderBytecodeCache Cache{CI};
+
+    const auto Bytecode0 = MakeBytecode(0, 256);
+    const auto Bytecode1 = MakeBytecode(1, 100);
+
+    EXPECT_FALSE(LoadAndCompare(Cache, 0, Bytecode0));
+
+    Cache.Store(MakeKey(0), Bytecode0.data(), Bytecode0.size() * sizeof(Uint32));
+    const char Log[] = "warning: unused variable";
+    Cache.Store(MakeKey(1), Bytecode1.data(), Bytecode1.size() * sizeof(Uint32), Log, sizeof(Log));
+
+    EXPECT_TRUE(LoadAndCompare(Cache, 0, Bytecode0));
+    EXPECT_TRUE(LoadAndCompare(Cache, 1, Bytecode1));
+    EXPECT_FALSE(LoadAndCompare(Cache, 2, Bytecode1));
+
+    {
+        RefCntAutoPtr<IDataBlob> pBytecode;
+        RefCntAutoPtr<IDataBlob> pOutput;
+        EXPECT_TRUE(Cache.Load(MakeKey(0), &pBytecode, &pOutput));
+        EXPECT_FALSE(pOutput);
+    }
+    {
+        RefCntAutoPtr<IDataBlob> pBytecode;
+        RefCntAutoPtr<IDataBlob> pOutput;
+        EXPECT_TRUE(Cache.Load(MakeKey(1), &pBytecode, &pOutput));
+        ASSERT_TRUE(pOutput);
+        EXPECT_EQ(pOutput->GetSize(), sizeof(Log));
+        EXPECT_STREQ(static_cast<const char*>(pOutput->GetDataPtr()), Log);
+    }
+
+    const auto Stats = Cache.GetStatistics();
+    EXPECT_EQ(Stats.NumHits, 4u);
+    EXPECT_EQ(Stats.NumMisses, 2u);
+    EXPECT_EQ(Stats.NumStores, 2u);
+    EXPECT_EQ(Stats.NumEvictions, 0u);
+    EXPECT_EQ(Stats.NumEntries, 2u);
+    EXPECT_GT(Stats.TotalSize, (Bytecode0.size() + Bytecode1.size()) * sizeof(Uint32) + sizeof(Log));
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, Persistence)
+{
+    const char* Directory = "ShaderBytecodeCacheTest_Persistence";
+    ClearCache(Directory);
+
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+
+    const auto Bytecode0 = MakeBytecode(0, 64);
+    const auto Bytecode1 = MakeBytecode(1, 64);
+
+    size_t TotalSize = 0;
+    {
+        ShaderBytecodeCache Cache{CI};
+        Cache.Store(MakeKey(0), Bytecode0.data(), Bytecode0.size() * sizeof(Uint32));
+        Cache.Store(MakeKey(1), Bytecode1.data(), Bytecode1.size() * sizeof(Uint32));
+        TotalSize = Cache.GetStatistics().TotalSize;
+    }
+
+    {
+        ShaderBytecodeCache Cache{CI};
+
+        auto Stats = Cache.GetStatistics();
+        EXPECT_EQ(Stats.NumEntries, 2u);
+        EXPECT_EQ(Stats.TotalSize, TotalSize);
+
+        EXPECT_TRUE(LoadAndCompare(Cache, 0, Bytecode0));
+        EXPECT_TRUE(LoadAndCompare(Cache, 1, Bytecode1));
+
+        Stats = Cache.GetStatistics();
+        EXPECT_EQ(Stats.NumHits, 2u);
+        EXPECT_EQ(Stats.NumMisses, 0u);
+    }
+
+    // Entries that are not in the index, e.g. written by another process, are found as well
+    {
+        ShaderBytecodeCache Cache{CI};
+        Cache.Store(MakeKey(2), Bytecode0.data(), Bytecode0.size() * sizeof(Uint32));
+
+        ShaderBytecodeCache Cache2{CI};
+        EXPECT_EQ(Cache2.GetStatistics().NumEntries, 2u);
+        EXPECT_TRUE(LoadAndCompare(Cache2, 2, Bytecode0));
+        EXPECT_EQ(Cache2.GetStatistics().NumEntries, 3u);
+    }
+
+    ClearCache(Directory);
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, LRUEviction)
+{
+    const char* Directory = "ShaderBytecodeCacheTest_LRUEviction";
+    ClearCache(Directory);
+
+    size_t EntrySize = 0;
+    {
+        ShaderBytecodeCache::CreateInfo CI;
+        CI.Directory = Directory;
+        ShaderBytecodeCache Cache{CI};
+
+        const auto Bytecode = MakeBytecode(100, 256);
+        Cache.Store(MakeKey(100), Bytecode.data(), Bytecode.size() * sizeof(Uint32));
+        EntrySize = Cache.GetStatistics().TotalSize;
+    }
+    ClearCache(Directory);
+
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    CI.MaxSize   = EntrySize * 3;
+    ShaderBytecodeCache Cache{CI};
+
+    std::vector<std::vector<Uint32>> Bytecodes;
+    for (Uint32 i = 0; i < 5; ++i)
+        Bytecodes.emplace_back(MakeBytecode(i, 256));
+
+    for (Uint32 i = 0; i < 3; ++i)
+        Cache.Store(MakeKey(i), Bytecodes[i].data(), Bytecodes[i].size() * sizeof(Uint32));
+    EXPECT_EQ(Cache.GetStatistics().NumEntries, 3u);
+    EXPECT_EQ(Cache.GetStatistics().TotalSize, EntrySize * 3);
+
+    // Entry 0 becomes the most recently used one
+    EXPECT_TRUE(LoadAndCompare(Cache, 0, Bytecodes[0]));
+
+    // Evicts entry 1
+    Cache.Store(MakeKey(3), Bytecodes[3].data(), Bytecodes[3].size() * sizeof(Uint32));
+    EXPECT_EQ(Cache.GetStatistics().NumEvictions, 1u);
+    EXPECT_FALSE(LoadAndCompare(Cache, 1, Bytecodes[1]));
+    EXPECT_TRUE(LoadAndCompare(Cache, 0, Bytecodes[0]));
+    EXPECT_TRUE(LoadAndCompare(Cache, 2, Bytecodes[2]));
+    EXPECT_TRUE(LoadAndCompare(Cache, 3, Bytecodes[3]));
+
+    // Evicts entry 0
+    Cache.Store(MakeKey(4), Bytecodes[4].data(), Bytecodes[4].size() * sizeof(Uint32));
+    EXPECT_EQ(Cache.GetStatistics().NumEvictions, 2u);
+    EXPECT_FALSE(LoadAndCompare(Cache, 0, Bytecodes[0]));
+    EXPECT_TRUE(LoadAndCompare(Cache, 4, Bytecodes[4]));
+
+    const auto Stats = Cache.GetStatistics();
+    EXPECT_EQ(Stats.NumEntries, 3u);
+    EXPECT_EQ(Stats.TotalSize, EntrySize * 3);
+
+    // Entries that exceed the size limit are not stored
+    const auto LargeBytecode = MakeBytecode(5, 256 * 4);
+    Cache.Store(MakeKey(5), LargeBytecode.data(), LargeBytecode.size() * sizeof(Uint32));
+    EXPECT_FALSE(LoadAndCompare(Cache, 5, LargeBytecode));
+    EXPECT_EQ(Cache.GetStatistics().NumEntries, 3u);
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, CorruptedEntry)
+{
+    const char* Directory = "ShaderBytecodeCacheTest_CorruptedEntry";
+    ClearCache(Directory);
+
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    ShaderBytecodeCache Cache{CI};
+
+    const auto Bytecode = MakeBytecode(0, 64);
+    Cache.Store(MakeKey(0), Bytecode.data(), Bytecode.size() * sizeof(Uint32));
+
+    // Corrupt the last bytecode word
+    {
+        const auto Path = Cache.GetDirectory() + FileSystem::GetSlashSymbol() + MakeKey(0).ToString() + ".bin";
+
+        std::vector<Uint8> Data;
+        {
+            FileWrapper File{Path.c_str()};
+            ASSERT_TRUE(File != nullptr);
+            Data.resize(File->GetSize());
+            ASSERT_TRUE(File->Read(Data.data(), Data.size()));
+        }
+
+        Data.back() ^= 0xFF;
+
+        FileWrapper File{Path.c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File != nullptr);
+        File->Write(Data.data(), Data.size());
+    }
+
+    EXPECT_FALSE(LoadAndCompare(Cache, 0, Bytecode));
+    EXPECT_EQ(Cache.GetStatistics().NumEntries, 0u);
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, Multithreaded)
+{
+    const char* Directory = "ShaderBytecodeCacheTest_Multithreaded";
+    ClearCache(Directory);
+
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    ShaderBytecodeCache Cache{CI};
+
+    constexpr Uint32 NumThreads         = 4;
+    constexpr Uint32 NumKeysPerThread   = 64;
+    constexpr Uint32 NumSharedKeys      = 16;
+    constexpr size_t NumBytecodeWords   = 128;
+    const auto       SharedKeyIdOffset  = NumThreads * NumKeysPerThread;
+    const auto       ExpectedNumEntries = NumThreads * NumKeysPerThread + NumSharedKeys;
+
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&, t]() {
+            for (Uint32 i = 0; i < NumKeysPerThread; ++i)
+            {
+                const auto Id       = t * NumKeysPerThread + i;
+                const auto Bytecode = MakeBytecode(Id, NumBytecodeWords);
+                Cache.Store(MakeKey(Id), Bytecode.data(), Bytecode.size() * sizeof(Uint32));
+
+                // All threads store and load the same shared keys
+                const auto SharedId       = SharedKeyIdOffset + i % NumSharedKeys;
+                const auto SharedBytecode = MakeBytecode(SharedId, NumBytecodeWords);
+                if (!LoadAndCompare(Cache, SharedId, SharedBytecode))
+                    Cache.Store(MakeKey(SharedId), SharedBytecode.data(), SharedBytecode.size() * sizeof(Uint32));
+            }
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    for (Uint32 Id = 0; Id < ExpectedNumEntries; ++Id)
+        EXPECT_TRUE(LoadAndCompare(Cache, Id, MakeBytecode(Id, NumBytecodeWords)));
+
+    const auto Stats = Cache.GetStatistics();
+    EXPECT_EQ(Stats.NumEntries, ExpectedNumEntries);
+    EXPECT_EQ(Stats.NumEvictions, 0u);
+}
+
+#if !DILIGENT_NO_GLSLANG
+
+TEST(ShaderTools_ShaderBytecodeCache, GLSLtoSPIRV)
+{
+    const char* Directory = "ShaderBytecodeCacheTest_GLSLtoSPIRV";
+    ClearCache(Directory);
+
+    GLSLangUtils::GlslangScope Glslang;
+
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    ShaderBytecodeCache Cache{CI};
+
+    auto Compile = [&](const char* Source, const char* ColorR) {
+        ShaderMacro Macros[] = {{"COLOR_R", ColorR}, {}};
+
+        GLSLangUtils::GLSLtoSPIRVAttribs Attribs;
+        Attribs.ShaderType    = SHADER_TYPE_PIXEL;
+        Attribs.ShaderSource  = Source;
+        Attribs.SourceCodeLen = static_cast<int>(strlen(Source));
+        Attribs.Macros        = Macros;
+        Attribs.pCache        = &Cache;
+        return GLSLangUtils::GLSLtoSPIRV(Attribs);
+    };
+
+    const char* Source = R"(
+#version 450
+layout(location = 0) out vec4 Color;
+void main()
+{
+    Color = vec4(COLOR_R, 0.0, 0.0, 1.0);
+}
+)";
+
+    // Same shader with different comments and formatting
+    const char* Source2 = R"(
+#version 450
+// Output color
+layout(location = 0) out vec4 Color;
+void main() { Color = vec4(COLOR_R, 0.0, 0.0, 1.0); /* red */ }
+)";
+
+    const auto SPIRV = Compile(Source, "1.0");
+    ASSERT_FALSE(SPIRV.empty());
+    EXPECT_EQ(Cache.GetStatistics().NumMisses, 1u);
+    EXPECT_EQ(Cache.GetStatistics().NumStores, 1u);
+
+    EXPECT_EQ(Compile(Source, "1.0"), SPIRV);
+    EXPECT_EQ(Cache.GetStatistics().NumHits, 1u);
+
+    EXPECT_EQ(Compile(Source2, "1.0"), SPIRV);
+    EXPECT_EQ(Cache.GetStatistics().NumHits, 2u);
+
+    const auto SPIRV2 = Compile(Source, "0.5");
+    EXPECT_FALSE(SPIRV2.empty());
+    EXPECT_NE(SPIRV2, SPIRV);
+    EXPECT_EQ(Cache.GetStatistics().NumMisses, 2u);
+    EXPECT_EQ(Cache.GetStatistics().NumStores, 2u);
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, GLSLtoSPIRVCompilerOutput)
+{
+    const char* Directory = "ShaderBytecodeCacheTest_GLSLtoSPIRVCompilerOutput";
+    ClearCache(Directory);
+
+    GLSLangUtils::GlslangScope Glslang;
+
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    ShaderBytecodeCache Cache{CI};
+
+    // Unknown extension produces a warning, but the shader compiles
+    const char* Source = R"(
+#version 450
+#extension GL_DILIGENT_unknown_extension : enable
+layout(location = 0) out vec4 Color;
+void main()
+{
+    Color = vec4(1.0, 0.0, 0.0, 1.0);
+}
+)";
+
+    auto Compile = [&](IDataBlob** ppCompilerOutput) {
+        GLSLangUtils::GLSLtoSPIRVAttribs Attribs;
+        Attribs.ShaderType       = SHADER_TYPE_PIXEL;
+        Attribs.ShaderSource     = Source;
+        Attribs.SourceCodeLen    = static_cast<int>(strlen(Source));
+        Attribs.ppCompilerOutput = ppCompilerOutput;
+        Attribs.pCache           = &Cache;
+        return GLSLangUtils::GLSLtoSPIRV(Attribs);
+    };
+
+    RefCntAutoPtr<IDataBlob> pOutput;
+    const auto               SPIRV = Compile(pOutput.RawDblPtr());
+    ASSERT_FALSE(SPIRV.empty());
+    ASSERT_NE(pOutput, nullptr);
+    const std::string Log = static_cast<const char*>(pOutput->GetDataPtr());
+    EXPECT_NE(Log.find("GL_DILIGENT_unknown_extension"), std::string::npos);
+
+    // The log must be returned on a cache hit
+    RefCntAutoPtr<IDataBlob> pCachedOutput;
+    EXPECT_EQ(Compile(pCachedOutput.RawDblPtr()), SPIRV);
+    EXPECT_EQ(Cache.GetStatistics().NumHits, 1u);
+    ASSERT_NE(pCachedOutput, nullptr);
+    ASSERT_EQ(pCachedOutput->GetSize(), pOutput->GetSize());
+    EXPECT_EQ(memcmp(pCachedOutput->GetDataPtr(), pOutput->GetDataPtr(), pOutput->GetSize()), 0);
+}
+
+#endif
+
+} // namespace